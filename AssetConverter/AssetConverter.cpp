@@ -0,0 +1,368 @@
+#include "AssetConverter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "BlockMesh.h"
+#include "BlockModel.h"
+#include "BlockModelImporter.h"
+#include "MeshFileParser.h"
+#include "MeshUtil.h"
+
+#include "BinaryFile.h"
+#include "FileSystem.h"
+#include "FileUtil.h"
+#include "StringUtil.h"
+
+using namespace Engine1;
+
+namespace
+{
+    // Files in own formats are not converted.
+    bool isSourceFile( const std::string& path )
+    {
+        const std::string extension = StringUtil::toLowercase( FileUtil::getFileExtensionFromPath( path ) );
+
+        return extension == "obj" || extension == "dae" || extension == "fbx";
+    }
+
+    // Same naming as when importing in the editor - index is added for all meshes but the first one.
+    std::experimental::filesystem::path getOutputPath( const std::experimental::filesystem::path& pathWithoutExtension, const int index, const std::string& extension )
+    {
+        std::experimental::filesystem::path outputPath = pathWithoutExtension;
+        outputPath += ( index != 0 ? "_" + std::to_string( index ) : "" ) + "." + extension;
+
+        return outputPath;
+    }
+
+    // Returns the path of the file relative to the directory, which contains it (directly or in sub-directories).
+    std::experimental::filesystem::path getRelativePath( const std::experimental::filesystem::path& filePath, const std::experimental::filesystem::path& directoryPath )
+    {
+        auto filePathIt = filePath.begin();
+
+        for ( const auto& directoryPathPart : directoryPath )
+        {
+            // Trailing separator is represented as an empty or "." element.
+            if ( directoryPathPart.empty() || directoryPathPart == "." )
+                continue;
+
+            if ( filePathIt == filePath.end() || *filePathIt != directoryPathPart )
+                throw std::exception( ( "AssetConverter::getRelativePath - \"" + filePath.string() + "\" is not in \"" + directoryPath.string() + "\"." ).c_str() );
+
+            ++filePathIt;
+        }
+
+        std::experimental::filesystem::path relativePath;
+        for ( ; filePathIt != filePath.end(); ++filePathIt )
+            relativePath /= *filePathIt;
+
+        return relativePath;
+    }
+}
+
+AssetConverter::Options::Options() :
+    writeModels( false ),
+    buildBvh( false ),
+    optimize( false ),
+    compress( false ),
+    force( false ),
+    invertZCoordinate( false ),
+    invertVertexWindingOrder( false ),
+    flipUVs( false ),
+    threadCount( 0 )
+{}
+
+AssetConverter::Options AssetConverter::parseArguments( const int argc, const char* const argv[] )
+{
+    Options options;
+
+    for ( int argIdx = 1; argIdx < argc; ++argIdx )
+    {
+        const std::string arg = argv[ argIdx ];
+
+        if ( arg == "--output" || arg == "--threads" )
+        {
+            if ( argIdx + 1 >= argc )
+                throw std::exception( ( "AssetConverter::parseArguments - missing value for " + arg + "." ).c_str() );
+
+            const std::string value = argv[ ++argIdx ];
+
+            if ( arg == "--output" )
+            {
+                options.outputDirectory = value;
+            }
+            else
+            {
+                try {
+                    options.threadCount = std::stoi( value );
+                } catch ( ... ) {
+                    throw std::exception( ( "AssetConverter::parseArguments - invalid thread count \"" + value + "\"." ).c_str() );
+                }
+            }
+        }
+        else if ( arg == "--models" )         options.writeModels              = true;
+        else if ( arg == "--bvh" )            options.buildBvh                 = true;
+        else if ( arg == "--optimize" )       options.optimize                 = true;
+        else if ( arg == "--compress" )       options.compress                 = true;
+        else if ( arg == "--force" )          options.force                    = true;
+        else if ( arg == "--invert-z" )       options.invertZCoordinate        = true;
+        else if ( arg == "--invert-winding" ) options.invertVertexWindingOrder = true;
+        else if ( arg == "--flip-uvs" )       options.flipUVs                  = true;
+        else if ( arg.compare( 0, 2, "--" ) == 0 )
+            throw std::exception( ( "AssetConverter::parseArguments - unknown option \"" + arg + "\"." ).c_str() );
+        else
+            options.inputDirectories.push_back( arg );
+    }
+
+    if ( options.inputDirectories.empty() )
+        throw std::exception( "AssetConverter::parseArguments - no input directories given." );
+
+    return options;
+}
+
+std::string AssetConverter::getUsage()
+{
+    return
+        "Usage: AssetConverter [options] <input directory>...\n"
+        "Converts OBJ, DAE and FBX files found in the directories (recursively) to .blockmesh/.blockmodel files.\n"
+        "\n"
+        "Options:\n"
+        "  --output <directory>  Write outputs to the directory (keeping the input directory structure).\n"
+        "                        By default outputs are written next to the source files.\n"
+        "  --models              Write .blockmodel files (with materials) in addition to .blockmesh files.\n"
+        "  --bvh                 Build BVH trees.\n"
+        "  --optimize            Optimize meshes for rasterization (vertex cache, overdraw, vertex fetch).\n"
+        "  --compress            Write compressed .blockmesh files.\n"
+        "  --force               Convert even if the outputs are up to date.\n"
+        "  --threads <count>     Number of worker threads (default: number of cores).\n"
+        "  --invert-z            Invert Z coordinate when importing.\n"
+        "  --invert-winding      Invert vertex winding order when importing.\n"
+        "  --flip-uvs            Flip UVs vertically when importing.\n";
+}
+
+AssetConverter::AssetConverter( const Options& options ) :
+    m_options( options )
+{}
+
+AssetConverter::~AssetConverter()
+{}
+
+int AssetConverter::run()
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const std::vector< Job > jobs = findJobs();
+
+    int threadCount = m_options.threadCount > 0 ? m_options.threadCount : (int)std::thread::hardware_concurrency();
+    threadCount = std::max( 1, std::min( threadCount, (int)jobs.size() ) );
+
+    log( "Found " + std::to_string( jobs.size() ) + " files to convert. Using " + std::to_string( threadCount ) + " threads." );
+
+    std::atomic< int > nextJobIdx( 0 );
+    std::atomic< int > convertedCount( 0 );
+    std::atomic< int > skippedCount( 0 );
+    std::atomic< int > failedCount( 0 );
+
+    const auto work = [ & ]() {
+        for ( int jobIdx = nextJobIdx++; jobIdx < (int)jobs.size(); jobIdx = nextJobIdx++ )
+        {
+            const Job& job = jobs[ jobIdx ];
+
+            try
+            {
+                if ( !m_options.force && isUpToDate( job ) )
+                {
+                    ++skippedCount;
+                    continue;
+                }
+
+                convert( job );
+
+                ++convertedCount;
+                log( "Converted \"" + job.sourcePath.string() + "\"." );
+            }
+            catch ( std::exception& ex )
+            {
+                ++failedCount;
+                logError( "Failed to convert \"" + job.sourcePath.string() + "\": " + ex.what() );
+            }
+            catch ( ... )
+            {
+                ++failedCount;
+                logError( "Failed to convert \"" + job.sourcePath.string() + "\": unknown error." );
+            }
+        }
+    };
+
+    std::vector< std::thread > threads;
+    for ( int threadIdx = 0; threadIdx < threadCount; ++threadIdx )
+        threads.push_back( std::thread( work ) );
+
+    for ( auto& thread : threads )
+        thread.join();
+
+    const double duration = std::chrono::duration< double >( std::chrono::steady_clock::now() - startTime ).count();
+
+    log( "Converted " + std::to_string( convertedCount ) + ", up to date " + std::to_string( skippedCount ) 
+         + ", failed " + std::to_string( failedCount ) + " in " + std::to_string( duration ) + " s." );
+
+    return failedCount;
+}
+
+std::vector< AssetConverter::Job > AssetConverter::findJobs() const
+{
+    std::vector< Job > jobs;
+
+    for ( const std::string& inputDirectory : m_options.inputDirectories )
+    {
+        if ( !FileSystem::exists( inputDirectory ) )
+            throw std::exception( ( "AssetConverter::findJobs - input directory \"" + inputDirectory + "\" doesn't exist." ).c_str() );
+
+        for ( const std::string& path : FileSystem::getAllFilesFromDirectory( inputDirectory ) )
+        {
+            if ( !isSourceFile( path ) )
+                continue;
+
+            Job job;
+            job.sourcePath = path;
+
+            if ( m_options.outputDirectory.empty() )
+                job.outputPathWithoutExtension = job.sourcePath;
+            else // Keep path relative to the input directory.
+                job.outputPathWithoutExtension = std::experimental::filesystem::path( m_options.outputDirectory ) / getRelativePath( job.sourcePath, inputDirectory );
+
+            job.outputPathWithoutExtension.replace_extension();
+
+            jobs.push_back( job );
+        }
+    }
+
+    // Biggest files first - so a big file doesn't end up being converted alone at the end.
+    std::vector< std::pair< long long, size_t > > jobSizes;
+    for ( size_t jobIdx = 0; jobIdx < jobs.size(); ++jobIdx )
+        jobSizes.push_back( std::make_pair( FileSystem::getFileSize( jobs[ jobIdx ].sourcePath.string() ), jobIdx ) );
+
+    std::sort( jobSizes.begin(), jobSizes.end(), []( const std::pair< long long, size_t >& size1, const std::pair< long long, size_t >& size2 ) {
+        return size1.first > size2.first;
+    } );
+
+    std::vector< Job > sortedJobs;
+    sortedJobs.reserve( jobs.size() );
+    for ( const auto& jobSize : jobSizes )
+        sortedJobs.push_back( jobs[ jobSize.second ] );
+
+    return sortedJobs;
+}
+
+bool AssetConverter::isUpToDate( const Job& job ) const
+{
+    const long long sourceWriteTime = FileSystem::getLastWriteTime( job.sourcePath.string() );
+
+    // Outputs with index 0 are written last - if they exist, all outputs of the file were written.
+    // Outputs with higher indices are found until the first missing one, as the number of meshes is not known without importing the file.
+    for ( int index = 0; ; ++index )
+    {
+        const std::string meshPath = getOutputPath( job.outputPathWithoutExtension, index, "blockmesh" ).string();
+
+        if ( !FileSystem::exists( meshPath ) )
+            return index > 0;
+
+        if ( FileSystem::getLastWriteTime( meshPath ) < sourceWriteTime )
+            return false;
+
+        if ( m_options.writeModels )
+        {
+            const std::string modelPath = getOutputPath( job.outputPathWithoutExtension, index, "blockmodel" ).string();
+
+            if ( !FileSystem::exists( modelPath ) || FileSystem::getLastWriteTime( modelPath ) < sourceWriteTime )
+                return false;
+        }
+    }
+}
+
+void AssetConverter::convert( const Job& job ) const
+{
+    const std::experimental::filesystem::path outputDirectory = job.outputPathWithoutExtension.parent_path();
+    if ( !outputDirectory.empty() )
+        FileSystem::createDirectories( outputDirectory.string() );
+
+    // Both modes import meshes the same way (native OBJ parser, welding of vertices) - models only add materials.
+    // Note: Each worker thread converts one file at a time, so each import uses its own Assimp importer.
+    std::vector< std::shared_ptr< BlockModel > > models;
+    std::vector< std::shared_ptr< BlockMesh > >  meshes;
+
+    if ( m_options.writeModels )
+    {
+        models = BlockModelImporter::import( job.sourcePath.string(), m_options.invertZCoordinate, m_options.invertVertexWindingOrder, m_options.flipUVs );
+
+        for ( const std::shared_ptr< BlockModel >& model : models )
+            meshes.push_back( model->getMesh() );
+    }
+    else
+    {
+        const BlockMeshFileInfo::Format format = BlockMeshFileInfo::fromExtension( FileUtil::getFileExtensionFromPath( job.sourcePath.string() ) );
+
+        const std::shared_ptr< std::vector< char > > data = BinaryFile::load( job.sourcePath.string() );
+
+        std::vector< char >::const_iterator dataIt    = data->cbegin();
+        std::vector< char >::const_iterator dataEndIt = data->cend();
+
+        meshes = MeshFileParser::parseBlockMeshFile( format, dataIt, dataEndIt, m_options.invertZCoordinate, m_options.invertVertexWindingOrder, m_options.flipUVs );
+    }
+
+    // Outputs left from an earlier conversion of the file with more meshes are removed - they would be taken as outputs of this conversion.
+    for ( int index = std::max( 1, (int)meshes.size() ); ; ++index )
+    {
+        const std::experimental::filesystem::path meshPath  = getOutputPath( job.outputPathWithoutExtension, index, "blockmesh" );
+        const std::experimental::filesystem::path modelPath = getOutputPath( job.outputPathWithoutExtension, index, "blockmodel" );
+
+        if ( !std::experimental::filesystem::exists( meshPath ) )
+            break;
+
+        std::experimental::filesystem::remove( meshPath );
+        std::experimental::filesystem::remove( modelPath );
+    }
+
+    // Outputs with index 0 are written last - see isUpToDate.
+    for ( int meshIdx = (int)meshes.size() - 1; meshIdx >= 0; --meshIdx )
+    {
+        BlockMesh& mesh = *meshes[ meshIdx ];
+
+        mesh.recalculateBoundingBox();
+
+        if ( m_options.buildBvh && !mesh.getTriangles().empty() )
+            mesh.buildBvhTree();
+
+        if ( m_options.optimize )
+            MeshUtil::optimizeForRasterization( mesh );
+
+        const std::string meshPath = getOutputPath( job.outputPathWithoutExtension, meshIdx, "blockmesh" ).string();
+
+        mesh.saveToFile( meshPath, BlockMeshFileInfo::Format::BLOCKMESH, m_options.compress );
+
+        if ( m_options.writeModels )
+        {
+            mesh.getFileInfo().setPath( meshPath );
+            mesh.getFileInfo().setFormat( BlockMeshFileInfo::Format::BLOCKMESH );
+            mesh.getFileInfo().setIndexInFile( 0 );
+
+            models[ meshIdx ]->saveToFile( getOutputPath( job.outputPathWithoutExtension, meshIdx, "blockmodel" ).string() );
+        }
+    }
+}
+
+void AssetConverter::log( const std::string& message )
+{
+    std::lock_guard< std::mutex > lock( m_logMutex );
+
+    std::cout << message << std::endl;
+}
+
+void AssetConverter::logError( const std::string& message )
+{
+    std::lock_guard< std::mutex > lock( m_logMutex );
+
+    std::cerr << message << std::endl;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <experimental/filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Converts meshes and models from external formats (OBJ, DAE, FBX) to the engine's own formats (.blockmesh, .blockmodel).
+// Files are converted in parallel - each worker thread imports one file at a time (with its own Assimp importer).
+// Doesn't create a graphics device - only CPU-side processing is done.
+class AssetConverter
+{
+    public:
+
+    struct Options
+    {
+        Options();
+
+        std::vector< std::string > inputDirectories;
+        std::string                outputDirectory; // If empty, outputs are written next to the source files.
+
+        bool writeModels;  // Write .blockmodel files (with materials) in addition to .blockmesh files.
+        bool buildBvh;
+        bool optimize;     // Optimize triangle and vertex order for rasterization.
+        bool compress;     // Write compressed .blockmesh files.
+        bool force;        // Convert even if outputs are up to date.
+
+        bool invertZCoordinate;
+        bool invertVertexWindingOrder;
+        bool flipUVs;
+
+        int threadCount; // 0 - number of cores.
+    };
+
+    // Throws if the arguments are invalid.
+    static Options parseArguments( const int argc, const char* const argv[] );
+    static std::string getUsage();
+
+    AssetConverter( const Options& options );
+    ~AssetConverter();
+
+    // Returns the number of files which failed to convert.
+    int run();
+
+    private:
+
+    struct Job
+    {
+        std::experimental::filesystem::path sourcePath;
+        std::experimental::filesystem::path outputPathWithoutExtension;
+    };
+
+    std::vector< Job > findJobs() const;
+
+    bool isUpToDate( const Job& job ) const;
+    void convert( const Job& job ) const;
+
+    void log( const std::string& message );
+    void logError( const std::string& message );
+
+    Options m_options;
+
+    std::mutex m_logMutex;
+
+    // Copying is not allowed.
+    AssetConverter( const AssetConverter& ) = delete;
+    AssetConverter& operator=( const AssetConverter& ) = delete;
+};
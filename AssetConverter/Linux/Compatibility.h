@@ -0,0 +1,45 @@
+#pragma once
+
+// Included in every translation unit of the Linux build (see CMakeLists.txt).
+// Makes the engine sources, written for MSVC, compile with GCC and Clang.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <locale>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// MSVC's std::exception has a constructor taking the message - the engine throws std::exception( "Class::method - message." ).
+// Only calls are replaced, so std::exception can still be caught.
+#define exception( message ) runtime_error( message )
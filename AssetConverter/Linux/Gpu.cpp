@@ -0,0 +1,13 @@
+#include "BlockModel.h"
+
+#include <exception>
+
+// Replaces the engine sources creating GPU resources (ex: BlockModelGpu.cpp), which are not built on Linux.
+// Only virtual functions are defined here - they are referenced by the virtual tables of the classes used by the converter.
+
+using namespace Engine1;
+
+void BlockModel::loadCpuToGpu( ID3D11Device3& /*device*/, ID3D11DeviceContext3& /*deviceContext*/, bool /*reload*/ )
+{
+    throw std::exception( "BlockModel::loadCpuToGpu - GPU is not available in AssetConverter on Linux." );
+}
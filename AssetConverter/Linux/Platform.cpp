@@ -0,0 +1,219 @@
+#include <windows.h>
+
+#include <cstdio>
+#include <cwchar>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Implementation of the Windows API subset declared in windows.h using POSIX.
+
+namespace
+{
+    std::string narrow( const wchar_t* wideString )
+    {
+        std::string narrowString( WideCharToMultiByte( CP_UTF8, 0, wideString, -1, nullptr, 0, nullptr, nullptr ), '\0' );
+        WideCharToMultiByte( CP_UTF8, 0, wideString, -1, &narrowString[ 0 ], (int)narrowString.size(), nullptr, nullptr );
+        narrowString.pop_back(); // Remove the terminating null character.
+
+        return narrowString;
+    }
+
+    // Both file and file mapping handles point to a file descriptor.
+    struct FileObject
+    {
+        int descriptor;
+    };
+
+    // Mapped views and their sizes - needed by munmap.
+    std::mutex                                 s_viewsMutex;
+    std::unordered_map< const void*, size_t >  s_viewSizes;
+}
+
+int MultiByteToWideChar( UINT /*codePage*/, DWORD /*flags*/, const char* multiByteString, int multiByteCount, wchar_t* wideString, int wideCount )
+{
+    const unsigned char* source    = reinterpret_cast< const unsigned char* >( multiByteString );
+    const unsigned char* sourceEnd = multiByteCount < 0 ? nullptr : source + multiByteCount;
+
+    int count = 0;
+    while ( sourceEnd ? source < sourceEnd : true )
+    {
+        uint32_t codePoint = *source++;
+        int      trailingBytes = 0;
+
+        if ( codePoint >= 0xF0 )      { codePoint &= 0x07; trailingBytes = 3; }
+        else if ( codePoint >= 0xE0 ) { codePoint &= 0x0F; trailingBytes = 2; }
+        else if ( codePoint >= 0xC0 ) { codePoint &= 0x1F; trailingBytes = 1; }
+
+        for ( ; trailingBytes > 0 && ( sourceEnd ? source < sourceEnd : *source != 0 ); --trailingBytes )
+            codePoint = ( codePoint << 6 ) | ( *source++ & 0x3F );
+
+        if ( wideCount > 0 ) {
+            if ( count >= wideCount )
+                return 0;
+
+            wideString[ count ] = (wchar_t)codePoint;
+        }
+
+        ++count;
+
+        if ( !sourceEnd && codePoint == 0 )
+            break;
+    }
+
+    return count;
+}
+
+int WideCharToMultiByte( UINT /*codePage*/, DWORD /*flags*/, const wchar_t* wideString, int wideCount, char* multiByteString, int multiByteCount, const char* /*defaultChar*/, BOOL* usedDefaultChar )
+{
+    if ( usedDefaultChar )
+        *usedDefaultChar = FALSE;
+
+    const wchar_t* source    = wideString;
+    const wchar_t* sourceEnd = wideCount < 0 ? nullptr : source + wideCount;
+
+    int count = 0;
+    while ( sourceEnd ? source < sourceEnd : true )
+    {
+        const uint32_t codePoint = (uint32_t)*source++;
+
+        char encoded[ 4 ];
+        int  encodedSize;
+
+        if ( codePoint < 0x80 ) {
+            encoded[ 0 ] = (char)codePoint;
+            encodedSize  = 1;
+        } else if ( codePoint < 0x800 ) {
+            encoded[ 0 ] = (char)( 0xC0 | ( codePoint >> 6 ) );
+            encoded[ 1 ] = (char)( 0x80 | ( codePoint & 0x3F ) );
+            encodedSize  = 2;
+        } else if ( codePoint < 0x10000 ) {
+            encoded[ 0 ] = (char)( 0xE0 | ( codePoint >> 12 ) );
+            encoded[ 1 ] = (char)( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+            encoded[ 2 ] = (char)( 0x80 | ( codePoint & 0x3F ) );
+            encodedSize  = 3;
+        } else {
+            encoded[ 0 ] = (char)( 0xF0 | ( codePoint >> 18 ) );
+            encoded[ 1 ] = (char)( 0x80 | ( ( codePoint >> 12 ) & 0x3F ) );
+            encoded[ 2 ] = (char)( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+            encoded[ 3 ] = (char)( 0x80 | ( codePoint & 0x3F ) );
+            encodedSize  = 4;
+        }
+
+        if ( multiByteCount > 0 ) {
+            if ( count + encodedSize > multiByteCount )
+                return 0;
+
+            std::memcpy( multiByteString + count, encoded, encodedSize );
+        }
+
+        count += encodedSize;
+
+        if ( !sourceEnd && codePoint == 0 )
+            break;
+    }
+
+    return count;
+}
+
+void OutputDebugStringW( const wchar_t* outputString )
+{
+    std::fputs( narrow( outputString ).c_str(), stderr );
+}
+
+HANDLE CreateFileW( const wchar_t* fileName, DWORD /*desiredAccess*/, DWORD /*shareMode*/, void* /*securityAttributes*/, DWORD /*creationDisposition*/, DWORD /*flagsAndAttributes*/, HANDLE /*templateFile*/ )
+{
+    const int descriptor = open( narrow( fileName ).c_str(), O_RDONLY );
+    if ( descriptor < 0 )
+        return INVALID_HANDLE_VALUE;
+
+    return new FileObject{ descriptor };
+}
+
+BOOL GetFileSizeEx( HANDLE file, LARGE_INTEGER* fileSize )
+{
+    struct stat fileStatus;
+    if ( fstat( static_cast< FileObject* >( file )->descriptor, &fileStatus ) != 0 )
+        return FALSE;
+
+    fileSize->QuadPart = (long long)fileStatus.st_size;
+
+    return TRUE;
+}
+
+HANDLE CreateFileMappingW( HANDLE file, void* /*securityAttributes*/, DWORD /*protect*/, DWORD /*maximumSizeHigh*/, DWORD /*maximumSizeLow*/, const wchar_t* /*name*/ )
+{
+    const int descriptor = dup( static_cast< FileObject* >( file )->descriptor );
+    if ( descriptor < 0 )
+        return nullptr;
+
+    return new FileObject{ descriptor };
+}
+
+void* MapViewOfFile( HANDLE fileMapping, DWORD /*desiredAccess*/, DWORD /*fileOffsetHigh*/, DWORD /*fileOffsetLow*/, size_t /*numberOfBytesToMap*/ )
+{
+    // Whole file is always mapped.
+    LARGE_INTEGER fileSize;
+    if ( !GetFileSizeEx( fileMapping, &fileSize ) || fileSize.QuadPart == 0 )
+        return nullptr;
+
+    void* view = mmap( nullptr, (size_t)fileSize.QuadPart, PROT_READ, MAP_PRIVATE, static_cast< FileObject* >( fileMapping )->descriptor, 0 );
+    if ( view == MAP_FAILED )
+        return nullptr;
+
+    std::lock_guard< std::mutex > lock( s_viewsMutex );
+    s_viewSizes[ view ] = (size_t)fileSize.QuadPart;
+
+    return view;
+}
+
+BOOL UnmapViewOfFile( const void* baseAddress )
+{
+    size_t size;
+    {
+        std::lock_guard< std::mutex > lock( s_viewsMutex );
+
+        const auto viewIt = s_viewSizes.find( baseAddress );
+        if ( viewIt == s_viewSizes.end() )
+            return FALSE;
+
+        size = viewIt->second;
+        s_viewSizes.erase( viewIt );
+    }
+
+    return munmap( const_cast< void* >( baseAddress ), size ) == 0;
+}
+
+BOOL CloseHandle( HANDLE object )
+{
+    if ( !object || object == INVALID_HANDLE_VALUE )
+        return FALSE;
+
+    FileObject* fileObject = static_cast< FileObject* >( object );
+
+    const bool closed = close( fileObject->descriptor ) == 0;
+    delete fileObject;
+
+    return closed;
+}
+
+BOOL MoveFileExW( const wchar_t* existingFileName, const wchar_t* newFileName, DWORD /*flags*/ )
+{
+    // rename replaces the existing file atomically - as with MOVEFILE_REPLACE_EXISTING.
+    return std::rename( narrow( existingFileName ).c_str(), narrow( newFileName ).c_str() ) == 0;
+}
+
+BOOL DeleteFileW( const wchar_t* fileName )
+{
+    return unlink( narrow( fileName ).c_str() ) == 0;
+}
+
+DWORD GetCurrentProcessId()
+{
+    return (DWORD)getpid();
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+// Declarations of the Direct3D 11 types used by the engine sources built into AssetConverter.
+// Engine headers declare GPU resources (ex: ComPtr members, Texture2D templates), so they need the types.
+// Sources creating GPU resources are not built into the converter - the interfaces have no implementation (see Linux/Gpu.cpp).
+
+#include <cstdint>
+
+#include "windows.h"
+
+typedef long  HRESULT;
+typedef float FLOAT;
+typedef uint8_t UINT8;
+
+enum DXGI_FORMAT
+{
+    DXGI_FORMAT_UNKNOWN               = 0,
+    DXGI_FORMAT_R32G32B32A32_TYPELESS = 1,
+    DXGI_FORMAT_R32G32B32A32_FLOAT    = 2,
+    DXGI_FORMAT_R32G32B32A32_UINT     = 3,
+    DXGI_FORMAT_R32G32B32A32_SINT     = 4,
+    DXGI_FORMAT_R32G32B32_TYPELESS    = 5,
+    DXGI_FORMAT_R32G32B32_FLOAT       = 6,
+    DXGI_FORMAT_R32G32B32_UINT        = 7,
+    DXGI_FORMAT_R32G32B32_SINT        = 8,
+    DXGI_FORMAT_R16G16B16A16_TYPELESS = 9,
+    DXGI_FORMAT_R16G16B16A16_FLOAT    = 10,
+    DXGI_FORMAT_R16G16B16A16_UNORM    = 11,
+    DXGI_FORMAT_R16G16B16A16_UINT     = 12,
+    DXGI_FORMAT_R16G16B16A16_SNORM    = 13,
+    DXGI_FORMAT_R16G16B16A16_SINT     = 14,
+    DXGI_FORMAT_R32G32_TYPELESS       = 15,
+    DXGI_FORMAT_R32G32_FLOAT          = 16,
+    DXGI_FORMAT_R32G32_UINT           = 17,
+    DXGI_FORMAT_R32G32_SINT           = 18,
+    DXGI_FORMAT_R10G10B10A2_UNORM     = 24,
+    DXGI_FORMAT_R11G11B10_FLOAT       = 26,
+    DXGI_FORMAT_R8G8B8A8_TYPELESS     = 27,
+    DXGI_FORMAT_R8G8B8A8_UNORM        = 28,
+    DXGI_FORMAT_R8G8B8A8_UNORM_SRGB   = 29,
+    DXGI_FORMAT_R8G8B8A8_UINT         = 30,
+    DXGI_FORMAT_R8G8B8A8_SNORM        = 31,
+    DXGI_FORMAT_R8G8B8A8_SINT         = 32,
+    DXGI_FORMAT_R16G16_TYPELESS       = 33,
+    DXGI_FORMAT_R16G16_FLOAT          = 34,
+    DXGI_FORMAT_R16G16_UNORM          = 35,
+    DXGI_FORMAT_R16G16_UINT           = 36,
+    DXGI_FORMAT_R16G16_SNORM          = 37,
+    DXGI_FORMAT_R16G16_SINT           = 38,
+    DXGI_FORMAT_R32_TYPELESS          = 39,
+    DXGI_FORMAT_D32_FLOAT             = 40,
+    DXGI_FORMAT_R32_FLOAT             = 41,
+    DXGI_FORMAT_R32_UINT              = 42,
+    DXGI_FORMAT_R32_SINT              = 43,
+    DXGI_FORMAT_R24G8_TYPELESS        = 44,
+    DXGI_FORMAT_D24_UNORM_S8_UINT     = 45,
+    DXGI_FORMAT_R24_UNORM_X8_TYPELESS = 46,
+    DXGI_FORMAT_X24_TYPELESS_G8_UINT  = 47,
+    DXGI_FORMAT_R8G8_TYPELESS         = 48,
+    DXGI_FORMAT_R8G8_UNORM            = 49,
+    DXGI_FORMAT_R8G8_UINT             = 50,
+    DXGI_FORMAT_R8G8_SNORM            = 51,
+    DXGI_FORMAT_R8G8_SINT             = 52,
+    DXGI_FORMAT_R16_TYPELESS          = 53,
+    DXGI_FORMAT_R16_FLOAT             = 54,
+    DXGI_FORMAT_D16_UNORM             = 55,
+    DXGI_FORMAT_R16_UNORM             = 56,
+    DXGI_FORMAT_R16_UINT              = 57,
+    DXGI_FORMAT_R16_SNORM             = 58,
+    DXGI_FORMAT_R16_SINT              = 59,
+    DXGI_FORMAT_R8_TYPELESS           = 60,
+    DXGI_FORMAT_R8_UNORM              = 61,
+    DXGI_FORMAT_R8_UINT               = 62,
+    DXGI_FORMAT_R8_SNORM              = 63,
+    DXGI_FORMAT_R8_SINT               = 64,
+    DXGI_FORMAT_A8_UNORM              = 65,
+    DXGI_FORMAT_B8G8R8A8_UNORM        = 87,
+};
+
+struct DXGI_SAMPLE_DESC
+{
+    UINT Count;
+    UINT Quality;
+};
+
+enum D3D11_USAGE
+{
+    D3D11_USAGE_DEFAULT   = 0,
+    D3D11_USAGE_IMMUTABLE = 1,
+    D3D11_USAGE_DYNAMIC   = 2,
+    D3D11_USAGE_STAGING   = 3
+};
+
+enum D3D11_BIND_FLAG
+{
+    D3D11_BIND_VERTEX_BUFFER    = 0x1,
+    D3D11_BIND_INDEX_BUFFER     = 0x2,
+    D3D11_BIND_CONSTANT_BUFFER  = 0x4,
+    D3D11_BIND_SHADER_RESOURCE  = 0x8,
+    D3D11_BIND_STREAM_OUTPUT    = 0x10,
+    D3D11_BIND_RENDER_TARGET    = 0x20,
+    D3D11_BIND_DEPTH_STENCIL    = 0x40,
+    D3D11_BIND_UNORDERED_ACCESS = 0x80
+};
+
+enum D3D11_CPU_ACCESS_FLAG
+{
+    D3D11_CPU_ACCESS_WRITE = 0x10000,
+    D3D11_CPU_ACCESS_READ  = 0x20000
+};
+
+enum D3D11_RESOURCE_MISC_FLAG
+{
+    D3D11_RESOURCE_MISC_GENERATE_MIPS = 0x1
+};
+
+enum D3D11_MAP
+{
+    D3D11_MAP_READ               = 1,
+    D3D11_MAP_WRITE              = 2,
+    D3D11_MAP_READ_WRITE         = 3,
+    D3D11_MAP_WRITE_DISCARD      = 4,
+    D3D11_MAP_WRITE_NO_OVERWRITE = 5
+};
+
+enum D3D11_CLEAR_FLAG
+{
+    D3D11_CLEAR_DEPTH   = 0x1,
+    D3D11_CLEAR_STENCIL = 0x2
+};
+
+enum D3D11_SRV_DIMENSION
+{
+    D3D11_SRV_DIMENSION_UNKNOWN   = 0,
+    D3D11_SRV_DIMENSION_TEXTURE2D = 4
+};
+
+enum D3D11_RTV_DIMENSION
+{
+    D3D11_RTV_DIMENSION_UNKNOWN   = 0,
+    D3D11_RTV_DIMENSION_TEXTURE2D = 4
+};
+
+enum D3D11_DSV_DIMENSION
+{
+    D3D11_DSV_DIMENSION_UNKNOWN   = 0,
+    D3D11_DSV_DIMENSION_TEXTURE2D = 3
+};
+
+enum D3D11_UAV_DIMENSION
+{
+    D3D11_UAV_DIMENSION_UNKNOWN   = 0,
+    D3D11_UAV_DIMENSION_TEXTURE2D = 4
+};
+
+struct D3D11_TEXTURE2D_DESC
+{
+    UINT             Width;
+    UINT             Height;
+    UINT             MipLevels;
+    UINT             ArraySize;
+    DXGI_FORMAT      Format;
+    DXGI_SAMPLE_DESC SampleDesc;
+    D3D11_USAGE      Usage;
+    UINT             BindFlags;
+    UINT             CPUAccessFlags;
+    UINT             MiscFlags;
+};
+
+struct D3D11_SUBRESOURCE_DATA
+{
+    const void* pSysMem;
+    UINT        SysMemPitch;
+    UINT        SysMemSlicePitch;
+};
+
+struct D3D11_MAPPED_SUBRESOURCE
+{
+    void* pData;
+    UINT  RowPitch;
+    UINT  DepthPitch;
+};
+
+struct D3D11_TEX2D_SRV
+{
+    UINT MostDetailedMip;
+    UINT MipLevels;
+};
+
+struct D3D11_TEX2D_RTV
+{
+    UINT MipSlice;
+};
+
+struct D3D11_TEX2D_DSV
+{
+    UINT MipSlice;
+};
+
+struct D3D11_TEX2D_UAV
+{
+    UINT MipSlice;
+};
+
+struct D3D11_SHADER_RESOURCE_VIEW_DESC
+{
+    DXGI_FORMAT         Format;
+    D3D11_SRV_DIMENSION ViewDimension;
+    union
+    {
+        D3D11_TEX2D_SRV Texture2D;
+    };
+};
+
+struct D3D11_RENDER_TARGET_VIEW_DESC
+{
+    DXGI_FORMAT         Format;
+    D3D11_RTV_DIMENSION ViewDimension;
+    union
+    {
+        D3D11_TEX2D_RTV Texture2D;
+    };
+};
+
+struct D3D11_DEPTH_STENCIL_VIEW_DESC
+{
+    DXGI_FORMAT         Format;
+    D3D11_DSV_DIMENSION ViewDimension;
+    UINT                Flags;
+    union
+    {
+        D3D11_TEX2D_DSV Texture2D;
+    };
+};
+
+struct D3D11_UNORDERED_ACCESS_VIEW_DESC
+{
+    DXGI_FORMAT         Format;
+    D3D11_UAV_DIMENSION ViewDimension;
+    union
+    {
+        D3D11_TEX2D_UAV Texture2D;
+    };
+};
+
+struct IUnknown
+{
+    virtual unsigned long AddRef()  = 0;
+    virtual unsigned long Release() = 0;
+};
+
+struct ID3D11DeviceChild : public IUnknown {};
+
+struct ID3D11Resource : public ID3D11DeviceChild {};
+struct ID3D11Buffer : public ID3D11Resource {};
+struct ID3D11Texture2D : public ID3D11Resource {};
+
+struct ID3D11View : public ID3D11DeviceChild {};
+struct ID3D11ShaderResourceView : public ID3D11View {};
+struct ID3D11RenderTargetView : public ID3D11View {};
+struct ID3D11DepthStencilView : public ID3D11View {};
+struct ID3D11UnorderedAccessView : public ID3D11View {};
+
+struct ID3D11Device3 : public IUnknown
+{
+    virtual HRESULT CreateTexture2D( const D3D11_TEXTURE2D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture2D** texture ) = 0;
+    virtual HRESULT CreateShaderResourceView( ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView** view ) = 0;
+    virtual HRESULT CreateRenderTargetView( ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc, ID3D11RenderTargetView** view ) = 0;
+    virtual HRESULT CreateDepthStencilView( ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc, ID3D11DepthStencilView** view ) = 0;
+    virtual HRESULT CreateUnorderedAccessView( ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc, ID3D11UnorderedAccessView** view ) = 0;
+};
+
+struct ID3D11DeviceContext3 : public ID3D11DeviceChild
+{
+    virtual HRESULT Map( ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource ) = 0;
+    virtual void    Unmap( ID3D11Resource* resource, UINT subresource ) = 0;
+    virtual void    GenerateMips( ID3D11ShaderResourceView* view ) = 0;
+    virtual void    ClearRenderTargetView( ID3D11RenderTargetView* view, const FLOAT color[ 4 ] ) = 0;
+    virtual void    ClearDepthStencilView( ID3D11DepthStencilView* view, UINT clearFlags, FLOAT depth, UINT8 stencil ) = 0;
+    virtual void    ClearUnorderedAccessViewUint( ID3D11UnorderedAccessView* view, const UINT values[ 4 ] ) = 0;
+    virtual void    ClearUnorderedAccessViewFloat( ID3D11UnorderedAccessView* view, const FLOAT values[ 4 ] ) = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+// Subset of the Windows API used by the engine sources built into AssetConverter. Implemented in Platform.cpp.
+
+#include <cstdint>
+#include <cstring>
+
+typedef int32_t  BOOL;  // Same as in FreeImage.h for non-Windows platforms.
+typedef uint32_t DWORD;
+typedef uint32_t UINT;
+typedef void*    HANDLE;
+
+union LARGE_INTEGER
+{
+    struct
+    {
+        DWORD   LowPart;
+        int32_t HighPart;
+    };
+    long long QuadPart;
+};
+
+#define TRUE  1
+#define FALSE 0
+
+#define INVALID_HANDLE_VALUE ( (HANDLE)(intptr_t)-1 )
+
+#define GENERIC_READ              0x80000000
+#define FILE_SHARE_READ           0x1
+#define OPEN_EXISTING             3
+#define FILE_ATTRIBUTE_NORMAL     0x80
+#define FILE_FLAG_RANDOM_ACCESS   0x10000000
+#define PAGE_READONLY             0x2
+#define FILE_MAP_READ             0x4
+#define MOVEFILE_REPLACE_EXISTING 0x1
+
+#define CP_UTF8 65001
+
+#define ZeroMemory( destination, length ) std::memset( ( destination ), 0, ( length ) )
+
+// Conversions between UTF-8 and wide strings. Other code pages are not supported.
+int MultiByteToWideChar( UINT codePage, DWORD flags, const char* multiByteString, int multiByteCount, wchar_t* wideString, int wideCount );
+int WideCharToMultiByte( UINT codePage, DWORD flags, const wchar_t* wideString, int wideCount, char* multiByteString, int multiByteCount, const char* defaultChar, BOOL* usedDefaultChar );
+
+// Writes to stderr.
+void OutputDebugStringW( const wchar_t* outputString );
+
+// Read-only files and read-only mappings of whole files are supported.
+HANDLE CreateFileW( const wchar_t* fileName, DWORD desiredAccess, DWORD shareMode, void* securityAttributes, DWORD creationDisposition, DWORD flagsAndAttributes, HANDLE templateFile );
+BOOL   GetFileSizeEx( HANDLE file, LARGE_INTEGER* fileSize );
+HANDLE CreateFileMappingW( HANDLE file, void* securityAttributes, DWORD protect, DWORD maximumSizeHigh, DWORD maximumSizeLow, const wchar_t* name );
+void*  MapViewOfFile( HANDLE fileMapping, DWORD desiredAccess, DWORD fileOffsetHigh, DWORD fileOffsetLow, size_t numberOfBytesToMap );
+BOOL   UnmapViewOfFile( const void* baseAddress );
+BOOL   CloseHandle( HANDLE object );
+
+BOOL  MoveFileExW( const wchar_t* existingFileName, const wchar_t* newFileName, DWORD flags );
+BOOL  DeleteFileW( const wchar_t* fileName );
+DWORD GetCurrentProcessId();
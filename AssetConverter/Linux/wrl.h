@@ -0,0 +1,77 @@
+#pragma once
+
+// Microsoft::WRL::ComPtr for the Linux build - the same reference counting as the original, without QueryInterface.
+
+#include <cstddef>
+#include <utility>
+
+namespace Microsoft
+{
+    namespace WRL
+    {
+        template< typename T >
+        class ComPtr
+        {
+            public:
+
+            ComPtr() : m_ptr( nullptr ) {}
+            ComPtr( std::nullptr_t ) : m_ptr( nullptr ) {}
+            ComPtr( T* ptr ) : m_ptr( ptr ) { addRef(); }
+            ComPtr( const ComPtr& other ) : m_ptr( other.m_ptr ) { addRef(); }
+            ComPtr( ComPtr&& other ) : m_ptr( other.m_ptr ) { other.m_ptr = nullptr; }
+
+            template< typename U >
+            ComPtr( const ComPtr< U >& other ) : m_ptr( other.Get() ) { addRef(); }
+
+            ~ComPtr() { release(); }
+
+            ComPtr& operator=( ComPtr other )
+            {
+                std::swap( m_ptr, other.m_ptr );
+                return *this;
+            }
+
+            ComPtr& operator=( std::nullptr_t )
+            {
+                Reset();
+                return *this;
+            }
+
+            T*  Get() const            { return m_ptr; }
+            T** GetAddressOf()         { return &m_ptr; }
+            T** ReleaseAndGetAddressOf() { release(); return &m_ptr; }
+            T*  operator->() const     { return m_ptr; }
+            explicit operator bool() const { return m_ptr != nullptr; }
+
+            bool operator==( std::nullptr_t ) const { return m_ptr == nullptr; }
+            bool operator!=( std::nullptr_t ) const { return m_ptr != nullptr; }
+
+            unsigned long Reset()
+            {
+                return release();
+            }
+
+            private:
+
+            void addRef()
+            {
+                if ( m_ptr )
+                    m_ptr->AddRef();
+            }
+
+            unsigned long release()
+            {
+                unsigned long refCount = 0;
+
+                if ( m_ptr ) {
+                    refCount = m_ptr->Release();
+                    m_ptr    = nullptr;
+                }
+
+                return refCount;
+            }
+
+            T* m_ptr;
+        };
+    }
+}
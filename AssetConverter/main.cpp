@@ -0,0 +1,20 @@
+#include <iostream>
+
+#include "AssetConverter.h"
+
+int main( int argc, char* argv[] )
+{
+    try 
+    {
+        const AssetConverter::Options options = AssetConverter::parseArguments( argc, argv );
+
+        AssetConverter converter( options );
+
+        return converter.run() == 0 ? 0 : 1;
+    } 
+    catch ( std::exception& e ) 
+    {
+        std::cerr << e.what() << std::endl << std::endl << AssetConverter::getUsage();
+        return 2;
+    }
+}
@@ -34,6 +34,8 @@
 #include "BVHTreeBuffer.h"
 
 #include "AssetPathManager.h"
+#include "FileSystem.h"
+#include "DerivedDataCache.h"
 
 // Only for debugging.
 #include "BlurShadowsComputeShader.h"
@@ -88,6 +90,18 @@ void Application::initialize( HINSTANCE applicationInstance ) {
 
 	m_rendererCore.initialize( *deviceContext.Get() );
     m_assetManager.initialize( parallelThreadCount, parallelThreadCount, device );
+
+    DerivedDataCache::setDirectory( settings().paths.derivedDataCache );
+    DerivedDataCache::setEnabled( settings().debug.useDerivedDataCache );
+
+    m_assetManager.getLoadStats().setEnabled( settings().debug.recordAssetLoadStats );
+
+    // Read assets from the packed archive, if available.
+    if ( FileSystem::exists( settings().paths.assetsArchive ) )
+        m_assetManager.mountArchive( settings().paths.assetsArchive );
+    else if ( settings().debug.hotReloadAssets )
+        m_assetManager.enableHotReload( settings().paths.assets );
+
     m_profiler.initialize( device, deviceContext );
     m_renderTargetManager.initialize( device );
 
@@ -280,6 +294,9 @@ void Application::run()
                 run = false;
 		}
 
+        // Replace assets, which were modified on disk, with their reloaded versions.
+        m_assetManager.swapReloadedAssets();
+
         if ( !physicsStepFinished )
             physicsStepFinished = PhysicsLibrary::getScene().fetchResults( false );
 
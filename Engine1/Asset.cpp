@@ -1,9 +1,20 @@
 #include "Asset.h"
 
 #include <assert.h>
+#include <mutex>
+#include <unordered_map>
+
+#include "StringUtil.h"
 
 using namespace Engine1;
 
+namespace
+{
+    // Index of each path, which was ever used in an asset id. Entries are never removed, so ids stay valid forever.
+    std::mutex                                      internedPathsMutex;
+    std::unordered_map< std::string, unsigned int > internedPaths;
+}
+
 std::string Asset::toString( const Type type )
 {
     switch ( type ) {
@@ -26,4 +37,23 @@ std::string Asset::toString( const Type type )
     assert( false );
 
     return "";
-}
\ No newline at end of file
+}
+
+Asset::Id Asset::createId( const Type type, const std::string& path, const int indexInFile )
+{
+    // Id layout: 8 bits - type, 24 bits - index in file, 32 bits - interned path index (starting from 1).
+    if ( indexInFile < 0 || indexInFile > 0xFFFFFF )
+        throw std::exception( "Asset::createId - index in file is out of range." );
+
+    const std::string lowercasePath = StringUtil::toLowercase( path );
+
+    unsigned int pathIndex = 0;
+    {
+        std::lock_guard< std::mutex > lock( internedPathsMutex );
+
+        const auto result = internedPaths.insert( std::make_pair( lowercasePath, (unsigned int)internedPaths.size() + 1 ) );
+        pathIndex = result.first->second;
+    }
+
+    return ( (Id)(unsigned char)type << 56 ) | ( (Id)indexInFile << 32 ) | (Id)pathIndex;
+}
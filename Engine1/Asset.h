@@ -25,7 +25,12 @@ namespace Engine1
             StagingTexture2D = 7,
         };
 
+        // Compact identifier of an asset - unique for each combination of type, path (case-insensitive) and index in file.
+        // Paths are interned, so ids can be compared and hashed without touching any strings. Zero is never a valid id.
+        typedef unsigned long long Id;
+
         static std::string toString( const Type type );
+        static Id          createId( const Type type, const std::string& path, const int indexInFile );
 
         virtual Type                                        getType() const = 0;
         virtual const FileInfo&                             getFileInfo() const = 0;
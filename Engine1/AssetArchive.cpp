@@ -0,0 +1,326 @@
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <cstring>
+
+#include "FileSystem.h"
+#include "BinaryFile.h"
+#include "CompressionUtil.h"
+#include "StringUtil.h"
+
+#include <windows.h>
+
+using namespace Engine1;
+
+const char         AssetArchive::s_magic[ 4 ] = { 'E', '1', 'P', 'K' };
+const unsigned int AssetArchive::s_version    = 1;
+
+namespace
+{
+    unsigned long long alignOffset( const unsigned long long offset, const unsigned long long alignment )
+    {
+        return ( offset + alignment - 1 ) / alignment * alignment;
+    }
+}
+
+std::string AssetArchive::normalizePath( const std::string& path )
+{
+    std::string normalizedPath;
+    normalizedPath.reserve( path.size() );
+
+    for ( const char character : StringUtil::toLowercase( path ) )
+    {
+        const char separator = ( character == '/' ) ? '\\' : character;
+
+        // Collapse repeated separators.
+        if ( separator == '\\' && !normalizedPath.empty() && normalizedPath.back() == '\\' )
+            continue;
+
+        normalizedPath.push_back( separator );
+    }
+
+    // Remove leading ".\".
+    while ( normalizedPath.size() >= 2 && normalizedPath[ 0 ] == '.' && normalizedPath[ 1 ] == '\\' )
+        normalizedPath.erase( 0, 2 );
+
+    return normalizedPath;
+}
+
+unsigned long long AssetArchive::hashPath( const std::string& normalizedPath )
+{
+    // FNV-1a.
+    unsigned long long hash = 14695981039346656037ull;
+    for ( const char character : normalizedPath ) {
+        hash ^= (unsigned char)character;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+void AssetArchive::pack( const std::string& directoryPath, const std::string& archivePath, const bool compress )
+{
+    // Only store compressed data if it's at least that much smaller than the original.
+    const float maxCompressionRatio = 0.9f;
+
+    std::vector< std::string > filePaths = FileSystem::getAllFilesFromDirectory( directoryPath );
+
+    // Skip the archive itself, in case it's placed inside the packed directory.
+    const std::string normalizedArchivePath = normalizePath( archivePath );
+    filePaths.erase( std::remove_if( filePaths.begin(), filePaths.end(), [&normalizedArchivePath]( const std::string& path ) {
+        return normalizePath( path ) == normalizedArchivePath;
+    } ), filePaths.end() );
+
+    if ( filePaths.empty() )
+        throw std::exception( "AssetArchive::pack - no files found in the given directory." );
+
+    std::vector< Entry > entries;
+    entries.resize( filePaths.size() );
+
+    std::vector< char > pathTable;
+
+    for ( size_t i = 0; i < filePaths.size(); ++i )
+    {
+        const std::string normalizedPath = normalizePath( filePaths[ i ] );
+
+        if ( normalizedPath.size() > USHRT_MAX || filePaths[ i ].size() > USHRT_MAX )
+            throw std::exception( "AssetArchive::pack - file path is too long." );
+
+        Entry& entry = entries[ i ];
+        std::memset( &entry, 0, sizeof( Entry ) );
+
+        entry.pathHash   = hashPath( normalizedPath );
+        entry.pathOffset = (unsigned int)pathTable.size();
+        entry.pathLength = (unsigned short)normalizedPath.size();
+        pathTable.insert( pathTable.end(), normalizedPath.begin(), normalizedPath.end() );
+
+        entry.originalPathOffset = (unsigned int)pathTable.size();
+        entry.originalPathLength = (unsigned short)filePaths[ i ].size();
+        pathTable.insert( pathTable.end(), filePaths[ i ].begin(), filePaths[ i ].end() );
+    }
+
+    Header header;
+    std::memset( &header, 0, sizeof( Header ) );
+    std::memcpy( header.magic, s_magic, sizeof( s_magic ) );
+    header.version         = s_version;
+    header.entryCount      = entries.size();
+    header.indexOffset     = sizeof( Header );
+    header.pathTableOffset = header.indexOffset + entries.size() * sizeof( Entry );
+    header.pathTableSize   = pathTable.size();
+
+    std::ofstream file;
+    file.open( archivePath.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc );
+
+    if ( !file.is_open() )
+        throw std::exception( "AssetArchive::pack - failed to open the archive file for writing." );
+
+    try
+    {
+        const std::vector< char > padding( dataAlignment, 0 );
+
+        // Header, index and path table are written at the end - when entry offsets are known.
+        unsigned long long offset = alignOffset( header.pathTableOffset + header.pathTableSize, dataAlignment );
+        file.seekp( offset, std::ios::beg );
+
+        // Write entries one by one to avoid keeping all of them in memory.
+        for ( size_t i = 0; i < filePaths.size(); ++i )
+        {
+            Entry& entry = entries[ i ];
+
+            const std::shared_ptr< std::vector< char > > fileData = BinaryFile::load( filePaths[ i ] );
+
+            entry.dataOffset  = offset;
+            entry.size        = fileData->size();
+            entry.storedSize  = fileData->size();
+            entry.compression = Compression::None;
+
+            std::vector< char > compressedData;
+            if ( compress && !fileData->empty() )
+            {
+                compressedData = CompressionUtil::compress( fileData->data(), fileData->size() );
+
+                if ( (float)compressedData.size() <= (float)fileData->size() * maxCompressionRatio ) {
+                    entry.storedSize  = compressedData.size();
+                    entry.compression = Compression::LZ;
+                }
+            }
+
+            const std::vector< char >& storedData = entry.compression == Compression::LZ ? compressedData : *fileData;
+
+            file.write( storedData.data(), storedData.size() );
+
+            const unsigned long long alignedOffset = alignOffset( offset + entry.storedSize, dataAlignment );
+            file.write( padding.data(), alignedOffset - ( offset + entry.storedSize ) );
+            offset = alignedOffset;
+        }
+
+        // Sort entries by hash to allow binary search when reading.
+        std::sort( entries.begin(), entries.end(), []( const Entry& entry1, const Entry& entry2 ) {
+            return entry1.pathHash < entry2.pathHash;
+        } );
+
+        file.seekp( 0, std::ios::beg );
+        file.write( reinterpret_cast< const char* >( &header ), sizeof( Header ) );
+        file.write( reinterpret_cast< const char* >( entries.data() ), entries.size() * sizeof( Entry ) );
+        file.write( pathTable.data(), pathTable.size() );
+
+        if ( !file.good() )
+            throw std::exception( "AssetArchive::pack - failed to write the archive file." );
+
+        file.close();
+    }
+    catch ( ... )
+    {
+        // In case of errors - close the file.
+        file.close();
+
+        throw;
+    }
+
+    OutputDebugStringW( StringUtil::widen(
+        "AssetArchive::pack - packed " + std::to_string( entries.size() ) + " files from \""
+        + directoryPath + "\" into \"" + archivePath + "\"\n"
+    ).c_str() );
+}
+
+AssetArchive::AssetArchive( const std::string& path ) :
+    m_path( path ),
+    m_fileHandle( INVALID_HANDLE_VALUE ),
+    m_fileMappingHandle( nullptr ),
+    m_data( nullptr ),
+    m_dataSize( 0 ),
+    m_header( nullptr ),
+    m_entries( nullptr ),
+    m_pathTable( nullptr )
+{
+    m_fileHandle = CreateFileW( StringUtil::widen( path ).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr );
+    if ( m_fileHandle == INVALID_HANDLE_VALUE )
+        throw std::exception( ( "AssetArchive::AssetArchive - failed to open file \"" + path + "\"." ).c_str() );
+
+    LARGE_INTEGER fileSize;
+    if ( !GetFileSizeEx( m_fileHandle, &fileSize ) || fileSize.QuadPart < (long long)sizeof( Header ) ) {
+        CloseHandle( m_fileHandle );
+        throw std::exception( "AssetArchive::AssetArchive - archive file is too small." );
+    }
+
+    m_dataSize = (unsigned long long)fileSize.QuadPart;
+
+    m_fileMappingHandle = CreateFileMappingW( m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if ( !m_fileMappingHandle ) {
+        CloseHandle( m_fileHandle );
+        throw std::exception( "AssetArchive::AssetArchive - failed to create file mapping." );
+    }
+
+    m_data = static_cast< const char* >( MapViewOfFile( m_fileMappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+    if ( !m_data ) {
+        CloseHandle( m_fileMappingHandle );
+        CloseHandle( m_fileHandle );
+        throw std::exception( "AssetArchive::AssetArchive - failed to map file to memory." );
+    }
+
+    m_header = reinterpret_cast< const Header* >( m_data );
+
+    const bool headerValid =
+        std::memcmp( m_header->magic, s_magic, sizeof( s_magic ) ) == 0
+        && m_header->version == s_version
+        && m_header->indexOffset + m_header->entryCount * sizeof( Entry ) <= m_dataSize
+        && m_header->pathTableOffset + m_header->pathTableSize <= m_dataSize;
+
+    if ( !headerValid ) {
+        UnmapViewOfFile( m_data );
+        CloseHandle( m_fileMappingHandle );
+        CloseHandle( m_fileHandle );
+        throw std::exception( ( "AssetArchive::AssetArchive - file \"" + path + "\" is not a valid archive or has unsupported version." ).c_str() );
+    }
+
+    m_entries   = reinterpret_cast< const Entry* >( m_data + m_header->indexOffset );
+    m_pathTable = m_data + m_header->pathTableOffset;
+}
+
+AssetArchive::~AssetArchive()
+{
+    UnmapViewOfFile( m_data );
+    CloseHandle( m_fileMappingHandle );
+    CloseHandle( m_fileHandle );
+}
+
+const std::string& AssetArchive::getPath() const
+{
+    return m_path;
+}
+
+bool AssetArchive::contains( const std::string& path ) const
+{
+    return findEntry( path ) != nullptr;
+}
+
+unsigned long long AssetArchive::getSize( const std::string& path ) const
+{
+    const Entry* entry = findEntry( path );
+    if ( !entry )
+        throw std::exception( ( "AssetArchive::getSize - file \"" + path + "\" not found in the archive." ).c_str() );
+
+    return entry->size;
+}
+
+std::shared_ptr< std::vector<char> > AssetArchive::read( const std::string& path, const bool appendZero ) const
+{
+    const Entry* entry = findEntry( path );
+    if ( !entry )
+        throw std::exception( ( "AssetArchive::read - file \"" + path + "\" not found in the archive." ).c_str() );
+
+    if ( entry->dataOffset + entry->storedSize > m_dataSize )
+        throw std::exception( "AssetArchive::read - entry data is out of archive bounds." );
+
+    const char* storedData = m_data + entry->dataOffset;
+
+    auto fileData = std::make_shared< std::vector< char > >();
+    fileData->resize( (size_t)entry->size + ( appendZero ? 1 : 0 ) );
+
+    if ( entry->compression == Compression::None )
+        std::memcpy( fileData->data(), storedData, (size_t)entry->size );
+    else if ( entry->compression == Compression::LZ )
+        CompressionUtil::decompress( storedData, (size_t)entry->storedSize, fileData->data(), (size_t)entry->size );
+    else
+        throw std::exception( "AssetArchive::read - unsupported compression type." );
+
+    if ( appendZero )
+        fileData->back() = 0;
+
+    return fileData;
+}
+
+std::vector< std::string > AssetArchive::getAllPaths() const
+{
+    std::vector< std::string > paths;
+    paths.reserve( (size_t)m_header->entryCount );
+
+    for ( unsigned long long i = 0; i < m_header->entryCount; ++i )
+        paths.push_back( std::string( m_pathTable + m_entries[ i ].originalPathOffset, m_entries[ i ].originalPathLength ) );
+
+    return paths;
+}
+
+const AssetArchive::Entry* AssetArchive::findEntry( const std::string& path ) const
+{
+    const std::string        normalizedPath = normalizePath( path );
+    const unsigned long long pathHash       = hashPath( normalizedPath );
+
+    const Entry* entriesEnd = m_entries + m_header->entryCount;
+
+    const Entry* entry = std::lower_bound( m_entries, entriesEnd, pathHash, []( const Entry& entry, const unsigned long long hash ) {
+        return entry.pathHash < hash;
+    } );
+
+    // Compare paths to handle hash collisions.
+    for ( ; entry != entriesEnd && entry->pathHash == pathHash; ++entry )
+    {
+        if ( entry->pathLength == normalizedPath.size()
+             && std::memcmp( m_pathTable + entry->pathOffset, normalizedPath.data(), normalizedPath.size() ) == 0 )
+            return entry;
+    }
+
+    return nullptr;
+}
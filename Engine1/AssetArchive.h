@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace Engine1
+{
+    // Read-only archive packing many asset files into a single file.
+    // Archive is memory-mapped, so reading an entry doesn't require any file opening or seeking.
+    //
+    // File layout:
+    // - Header (64 bytes) - magic, version, entry count, offsets of the index and path table.
+    // - Index - entries sorted by path hash, which allows binary search.
+    // - Path table - lowercase, normalized paths of all entries (to resolve hash collisions).
+    // - Entry data - each entry starts at an offset aligned to 'dataAlignment' bytes,
+    //   so it can be used directly from mapped memory. Entries can be compressed.
+    //
+    // Note: Index is per-file, not per-asset, because one file can contain many assets (ex: meshes in one OBJ file).
+    class AssetArchive
+    {
+        public:
+
+        static const size_t dataAlignment = 64;
+
+        // Packs all files from the given directory (recursively) into a single archive.
+        // Entries are only stored compressed if compression saves a meaningful amount of space.
+        static void pack( const std::string& directoryPath, const std::string& archivePath, const bool compress = true );
+
+        static std::string normalizePath( const std::string& path );
+        static unsigned long long hashPath( const std::string& normalizedPath );
+
+        AssetArchive( const std::string& path );
+        ~AssetArchive();
+
+        const std::string& getPath() const;
+
+        bool contains( const std::string& path ) const;
+
+        // Returns the uncompressed size of the entry.
+        unsigned long long getSize( const std::string& path ) const;
+
+        // Returns entry data (decompressed if needed). Zero is appended to the data, if requested (for textual files).
+        std::shared_ptr< std::vector<char> > read( const std::string& path, const bool appendZero = false ) const;
+
+        // Returns original paths of all the entries.
+        std::vector< std::string > getAllPaths() const;
+
+        private:
+
+        enum class Compression : unsigned int
+        {
+            None = 0,
+            LZ   = 1
+        };
+
+        #pragma pack( push, 1 )
+        struct Header
+        {
+            char               magic[ 4 ];
+            unsigned int       version;
+            unsigned long long entryCount;
+            unsigned long long indexOffset;
+            unsigned long long pathTableOffset;
+            unsigned long long pathTableSize;
+            char               reserved[ 24 ];
+        };
+
+        struct Entry
+        {
+            unsigned long long pathHash;
+            unsigned long long dataOffset;
+            unsigned long long storedSize;
+            unsigned long long size;
+            unsigned int       pathOffset;         // Offset of the normalized path in the path table.
+            unsigned int       originalPathOffset; // Offset of the original path in the path table.
+            unsigned short     pathLength;
+            unsigned short     originalPathLength;
+            Compression        compression;
+        };
+        #pragma pack( pop )
+
+        static const char         s_magic[ 4 ];
+        static const unsigned int s_version;
+
+        const Entry* findEntry( const std::string& path ) const;
+
+        std::string m_path;
+
+        void* m_fileHandle;
+        void* m_fileMappingHandle;
+
+        const char*        m_data;
+        unsigned long long m_dataSize;
+
+        const Header* m_header;
+        const Entry*  m_entries;
+        const char*   m_pathTable;
+
+        // Copying archives is not allowed.
+        AssetArchive( const AssetArchive& ) = delete;
+        AssetArchive& operator=( const AssetArchive& ) = delete;
+    };
+}
@@ -0,0 +1,613 @@
+#include "AssetLoadStats.h"
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+#include "FileInfo.h"
+#include "TextFile.h"
+
+using namespace Engine1;
+
+namespace
+{
+    double getDuration( const double startTime, const double endTime )
+    {
+        return ( startTime >= 0.0 && endTime >= startTime ) ? endTime - startTime : 0.0;
+    }
+
+    // Quotes the field and doubles quotes inside it, so separators and quotes in paths don't break the columns.
+    std::string quoteCsv( const std::string& text )
+    {
+        std::string quotedText( "\"" );
+        quotedText.reserve( text.size() + 2 );
+
+        for ( const char character : text )
+        {
+            if ( character == '"' )
+                quotedText.push_back( '"' );
+
+            quotedText.push_back( character );
+        }
+
+        quotedText.push_back( '"' );
+
+        return quotedText;
+    }
+
+    std::string escapeJson( const std::string& text )
+    {
+        std::string escapedText;
+        escapedText.reserve( text.size() );
+
+        for ( const char character : text )
+        {
+            if ( character == '\\' || character == '"' )
+                escapedText.push_back( '\\' );
+
+            escapedText.push_back( character );
+        }
+
+        return escapedText;
+    }
+
+    void saveText( const std::string& path, const std::string& text )
+    {
+        std::vector< char > data( text.begin(), text.end() );
+
+        TextFile::save( path, data );
+    }
+
+    // Writes a "complete" event, which spans from startTime to endTime on the given thread.
+    void writeTraceEvent( std::stringstream& ss, bool& firstEvent, const std::string& name, const std::string& category,
+                          const int threadIndex, const double startTime, const double endTime, const std::string& args = "" )
+    {
+        if ( startTime < 0.0 || endTime < startTime )
+            return;
+
+        ss << ( firstEvent ? "" : ",\n" )
+           << "{\"name\":\"" << escapeJson( name ) << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadIndex
+           << ",\"ts\":" << startTime * 1000.0 << ",\"dur\":" << ( endTime - startTime ) * 1000.0;
+
+        if ( !args.empty() )
+            ss << ",\"args\":{" << args << "}";
+
+        ss << "}";
+
+        firstEvent = false;
+    }
+}
+
+double AssetLoadStats::AssetRecord::getQueuedDuration() const
+{
+    return getDuration( queuedTime, readStartTime );
+}
+
+double AssetLoadStats::AssetRecord::getReadDuration() const
+{
+    return getDuration( readStartTime, readEndTime );
+}
+
+double AssetLoadStats::AssetRecord::getParseDuration() const
+{
+    // Note: Textures are uploaded to GPU while being parsed - upload time is reported separately.
+    const bool uploadedWhileParsing = gpuUploadStartTime >= parseStartTime && gpuUploadEndTime >= 0.0 && gpuUploadEndTime <= parseEndTime;
+
+    const double duration = getDuration( parseStartTime, parseEndTime ) - getSubAssetsWaitDuration() 
+        - ( uploadedWhileParsing ? getGpuUploadDuration() : 0.0 );
+
+    return std::max( 0.0, duration );
+}
+
+double AssetLoadStats::AssetRecord::getSubAssetsWaitDuration() const
+{
+    return getDuration( subAssetsWaitStartTime, subAssetsWaitEndTime );
+}
+
+double AssetLoadStats::AssetRecord::getGpuUploadDuration() const
+{
+    return getDuration( gpuUploadStartTime, gpuUploadEndTime );
+}
+
+const size_t AssetLoadStats::s_maxSampleCount = 64 * 1024;
+const size_t AssetLoadStats::s_maxRecordCount = 64 * 1024;
+
+AssetLoadStats::AssetLoadStats() :
+    m_enabled( false ),
+    m_droppedRecord(),
+    m_droppedRecordCount( 0 ),
+    m_nextSampleIndex( 0 ),
+    m_currentState()
+{
+    reset();
+}
+
+AssetLoadStats::~AssetLoadStats()
+{}
+
+void AssetLoadStats::reset()
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    m_startTime = std::chrono::steady_clock::now();
+
+    m_records.clear();
+    m_records.shrink_to_fit();
+    m_recordIndices.clear();
+    m_droppedRecordCount = 0;
+    m_samples.clear();
+    m_nextSampleIndex = 0;
+
+    // Note: Thread indices and the current state of the pipeline are kept - they are still valid after reset.
+}
+
+void AssetLoadStats::setEnabled( const bool enabled )
+{
+    m_enabled = enabled;
+}
+
+bool AssetLoadStats::isEnabled() const
+{
+    return m_enabled;
+}
+
+double AssetLoadStats::getTime() const
+{
+    return std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - m_startTime ).count();
+}
+
+std::vector< AssetLoadStats::AssetRecord > AssetLoadStats::getRecords() const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    return m_records;
+}
+
+AssetLoadStats::AssetRecord AssetLoadStats::getRecord( Asset::Type type, const std::string& path, const int indexInFile ) const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    const auto it = m_recordIndices.find( Asset::createId( type, path, indexInFile ) );
+    if ( it == m_recordIndices.end() || it->second >= m_records.size() )
+        throw std::exception( ( "AssetLoadStats::getRecord - no record for \"" + path + "\"." ).c_str() );
+
+    return m_records[ it->second ];
+}
+
+std::vector< AssetLoadStats::Sample > AssetLoadStats::getSamples() const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    return getSamplesSortedByTime();
+}
+
+size_t AssetLoadStats::getDroppedRecordCount() const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    return m_droppedRecordCount;
+}
+
+std::vector< AssetLoadStats::Sample > AssetLoadStats::getSamplesSortedByTime() const
+{
+    std::vector< Sample > samples;
+    samples.reserve( m_samples.size() );
+
+    // Once the buffer is full, the oldest sample is the one to be overwritten next.
+    samples.insert( samples.end(), m_samples.begin() + m_nextSampleIndex, m_samples.end() );
+    samples.insert( samples.end(), m_samples.begin(), m_samples.begin() + m_nextSampleIndex );
+
+    return samples;
+}
+
+float AssetLoadStats::getReadingThreadsUtilization( const int threadCount ) const
+{
+    return getUtilization( ThreadRole::Reading, threadCount );
+}
+
+float AssetLoadStats::getBasicParsingThreadsUtilization( const int threadCount ) const
+{
+    return getUtilization( ThreadRole::BasicParsing, threadCount );
+}
+
+float AssetLoadStats::getComplexParsingThreadsUtilization( const int threadCount ) const
+{
+    return getUtilization( ThreadRole::ComplexParsing, threadCount );
+}
+
+float AssetLoadStats::getUtilization( const ThreadRole role, const int threadCount ) const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if ( m_samples.size() < 2 || threadCount <= 0 )
+        return 0.0f;
+
+    const std::vector< Sample > samples = getSamplesSortedByTime();
+
+    const double totalTime = samples.back().time - samples.front().time;
+    if ( totalTime <= 0.0 )
+        return 0.0f;
+
+    double busyTime = 0.0;
+    for ( const auto& record : m_records )
+    {
+        if ( role == ThreadRole::Reading && record.readingThreadIndex >= 0 )
+            busyTime += record.getReadDuration();
+        else if ( record.parsingThreadIndex >= 0 && m_threadRoles[ record.parsingThreadIndex ] == role )
+            busyTime += record.getParseDuration(); // Note: Waiting for sub-assets is not counted as work.
+    }
+
+    return (float)std::min( 1.0, busyTime / ( totalTime * threadCount ) );
+}
+
+void AssetLoadStats::saveToChromeTrace( const std::string& path ) const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision( 3 );
+
+    ss << "{\"traceEvents\":[\n";
+
+    bool firstEvent = true;
+
+    // Name threads.
+    for ( int threadIndex = 0; threadIndex < (int)m_threadRoles.size(); ++threadIndex )
+    {
+        const ThreadRole role = m_threadRoles[ threadIndex ];
+        const std::string threadName =
+            role == ThreadRole::Reading        ? "Reading" :
+            role == ThreadRole::BasicParsing   ? "Parsing basic assets" :
+            role == ThreadRole::ComplexParsing ? "Parsing complex assets" : "Other";
+
+        ss << ( firstEvent ? "" : ",\n" )
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadIndex
+           << ",\"args\":{\"name\":\"" << threadName << " #" << threadIndex << "\"}}";
+
+        firstEvent = false;
+    }
+
+    for ( const auto& record : m_records )
+    {
+        const std::string name = "(" + Asset::toString( record.type ) + ") " + record.path + " [" + std::to_string( record.indexInFile ) + "]";
+
+        std::stringstream args;
+        args << std::fixed << std::setprecision( 3 )
+             << "\"queued ms\":" << record.getQueuedDuration() << ",\"bytes\":" << record.bytesRead << ",\"succeeded\":" << ( record.succeeded ? "true" : "false" );
+
+        writeTraceEvent( ss, firstEvent, "Read " + name, "read", record.readingThreadIndex, record.readStartTime, record.readEndTime, args.str() );
+        writeTraceEvent( ss, firstEvent, "Parse " + name, "parse", record.parsingThreadIndex, record.parseStartTime, record.parseEndTime, args.str() );
+        writeTraceEvent( ss, firstEvent, "Wait for sub-assets", "wait", record.parsingThreadIndex, record.subAssetsWaitStartTime, record.subAssetsWaitEndTime );
+        writeTraceEvent( ss, firstEvent, "GPU upload " + name, "gpu", record.gpuUploadThreadIndex, record.gpuUploadStartTime, record.gpuUploadEndTime );
+    }
+
+    // Queue depths and busy threads as counters.
+    for ( const auto& sample : getSamplesSortedByTime() )
+    {
+        ss << ( firstEvent ? "" : ",\n" )
+           << "{\"name\":\"Queues\",\"ph\":\"C\",\"pid\":1,\"ts\":" << sample.time * 1000.0
+           << ",\"args\":{\"to read\":" << sample.assetsToRead << ",\"basic to parse\":" << sample.basicAssetsToParse << ",\"complex to parse\":" << sample.complexAssetsToParse << "}},\n"
+           << "{\"name\":\"Busy threads\",\"ph\":\"C\",\"pid\":1,\"ts\":" << sample.time * 1000.0
+           << ",\"args\":{\"reading\":" << sample.busyReadingThreads << ",\"basic parsing\":" << sample.busyBasicParsingThreads << ",\"complex parsing\":" << sample.busyComplexParsingThreads << "}}";
+
+        firstEvent = false;
+    }
+
+    ss << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    saveText( path, ss.str() );
+}
+
+void AssetLoadStats::saveToCsv( const std::string& path ) const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision( 3 );
+
+    ss << "\"Type\";\"Path\";\"Index in file\";\"Succeeded\";\"Queued at\";\"Queued ms\";\"Read ms\";\"Bytes read\";\"Parse ms\";\"Sub-assets wait ms\";\"GPU upload ms\"\n";
+
+    for ( const auto& record : m_records )
+    {
+        ss << quoteCsv( Asset::toString( record.type ) ) << ";" << quoteCsv( record.path ) << ";" << record.indexInFile << ";"
+           << ( record.succeeded ? 1 : 0 ) << ";" << record.queuedTime << ";" << record.getQueuedDuration() << ";"
+           << record.getReadDuration() << ";" << record.bytesRead << ";" << record.getParseDuration() << ";"
+           << record.getSubAssetsWaitDuration() << ";" << record.getGpuUploadDuration() << "\n";
+    }
+
+    saveText( path, ss.str() );
+}
+
+void AssetLoadStats::saveSamplesToCsv( const std::string& path ) const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision( 3 );
+
+    ss << "\"Time ms\";\"To read\";\"Basic to parse\";\"Complex to parse\";\"Busy reading threads\";\"Busy basic parsing threads\";\"Busy complex parsing threads\"\n";
+
+    for ( const auto& sample : getSamplesSortedByTime() )
+    {
+        ss << sample.time << ";" << sample.assetsToRead << ";" << sample.basicAssetsToParse << ";" << sample.complexAssetsToParse << ";"
+           << sample.busyReadingThreads << ";" << sample.busyBasicParsingThreads << ";" << sample.busyComplexParsingThreads << "\n";
+    }
+
+    saveText( path, ss.str() );
+}
+
+void AssetLoadStats::registerCurrentThread( const ThreadRole role )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    const int threadIndex = getCurrentThreadIndex();
+    m_threadRoles[ threadIndex ] = role;
+}
+
+void AssetLoadStats::onQueued( const FileInfo& fileInfo )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    const double time = getTime();
+
+    // Note: Always start a new record - asset may be loaded again after being unloaded.
+    m_recordIndices.erase( fileInfo.getAssetId() );
+
+    getOrCreateRecord( fileInfo ).queuedTime = time;
+
+    ++m_currentState.assetsToRead;
+    addSample( time );
+}
+
+void AssetLoadStats::onReadStarted( const FileInfo& fileInfo )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    const double time = getTime();
+
+    AssetRecord& record = getOrCreateRecord( fileInfo );
+    record.readStartTime      = time;
+    record.readingThreadIndex = getCurrentThreadIndex();
+
+    m_currentState.assetsToRead = std::max( 0, m_currentState.assetsToRead - 1 );
+    ++m_currentState.busyReadingThreads;
+    addSample( time );
+}
+
+void AssetLoadStats::onReadFinished( const FileInfo& fileInfo, const unsigned long long bytesRead, const bool succeeded )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    const double time = getTime();
+
+    AssetRecord& record = getOrCreateRecord( fileInfo );
+    record.readEndTime = time;
+    record.bytesRead   = bytesRead;
+
+    if ( !succeeded ) {
+        record.finished  = true;
+        record.succeeded = false;
+    }
+
+    m_currentState.busyReadingThreads = std::max( 0, m_currentState.busyReadingThreads - 1 );
+
+    if ( succeeded ) {
+        if ( fileInfo.canHaveSubAssets() )
+            ++m_currentState.complexAssetsToParse;
+        else
+            ++m_currentState.basicAssetsToParse;
+    }
+
+    addSample( time );
+}
+
+void AssetLoadStats::onParseStarted( const FileInfo& fileInfo )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    const double time = getTime();
+
+    const int threadIndex = getCurrentThreadIndex();
+
+    AssetRecord& record = getOrCreateRecord( fileInfo );
+    record.parseStartTime     = time;
+    record.parsingThreadIndex = threadIndex;
+
+    // Note: Assets loaded synchronously (on other threads) don't go through the queues.
+    const ThreadRole role = m_threadRoles[ threadIndex ];
+    if ( role == ThreadRole::BasicParsing ) {
+        m_currentState.basicAssetsToParse = std::max( 0, m_currentState.basicAssetsToParse - 1 );
+        ++m_currentState.busyBasicParsingThreads;
+    } else if ( role == ThreadRole::ComplexParsing ) {
+        m_currentState.complexAssetsToParse = std::max( 0, m_currentState.complexAssetsToParse - 1 );
+        ++m_currentState.busyComplexParsingThreads;
+    }
+
+    addSample( time );
+}
+
+void AssetLoadStats::onSubAssetsWaitStarted( const FileInfo& fileInfo )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    getOrCreateRecord( fileInfo ).subAssetsWaitStartTime = getTime();
+}
+
+void AssetLoadStats::onSubAssetsWaitFinished( const FileInfo& fileInfo )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    getOrCreateRecord( fileInfo ).subAssetsWaitEndTime = getTime();
+}
+
+void AssetLoadStats::onParseFinished( const FileInfo& fileInfo, const bool succeeded )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    const double time = getTime();
+
+    AssetRecord& record = getOrCreateRecord( fileInfo );
+    record.parseEndTime = time;
+    record.finished     = true;
+    record.succeeded    = succeeded;
+
+    const ThreadRole role = m_threadRoles[ getCurrentThreadIndex() ];
+    if ( role == ThreadRole::BasicParsing )
+        m_currentState.busyBasicParsingThreads = std::max( 0, m_currentState.busyBasicParsingThreads - 1 );
+    else if ( role == ThreadRole::ComplexParsing )
+        m_currentState.busyComplexParsingThreads = std::max( 0, m_currentState.busyComplexParsingThreads - 1 );
+
+    addSample( time );
+}
+
+void AssetLoadStats::onGpuUploadStarted( const FileInfo& fileInfo )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    AssetRecord& record = getOrCreateRecord( fileInfo );
+    record.gpuUploadStartTime   = getTime();
+    record.gpuUploadThreadIndex = getCurrentThreadIndex();
+}
+
+void AssetLoadStats::onGpuUploadFinished( const FileInfo& fileInfo )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    getOrCreateRecord( fileInfo ).gpuUploadEndTime = getTime();
+}
+
+void AssetLoadStats::onDropped( const FileInfo& fileInfo, const bool wasRead )
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    const double time = getTime();
+
+    AssetRecord& record = getOrCreateRecord( fileInfo );
+    record.finished  = true;
+    record.succeeded = false;
+
+    if ( !wasRead )
+        m_currentState.assetsToRead = std::max( 0, m_currentState.assetsToRead - 1 );
+    else if ( fileInfo.canHaveSubAssets() )
+        m_currentState.complexAssetsToParse = std::max( 0, m_currentState.complexAssetsToParse - 1 );
+    else
+        m_currentState.basicAssetsToParse = std::max( 0, m_currentState.basicAssetsToParse - 1 );
+
+    addSample( time );
+}
+
+void AssetLoadStats::onQueuesCleared()
+{
+    if ( !m_enabled )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    m_currentState.assetsToRead         = 0;
+    m_currentState.basicAssetsToParse   = 0;
+    m_currentState.complexAssetsToParse = 0;
+
+    addSample( getTime() );
+}
+
+AssetLoadStats::AssetRecord& AssetLoadStats::getOrCreateRecord( const FileInfo& fileInfo )
+{
+    const Asset::Id key = fileInfo.getAssetId();
+
+    const auto it = m_recordIndices.find( key );
+    if ( it != m_recordIndices.end() )
+        return it->second < m_records.size() ? m_records[ it->second ] : m_droppedRecord;
+
+    // Note: Events of assets which don't fit are still accepted, but they are written to a scratch record and never saved.
+    // Such assets are marked with an out-of-range index, so they are counted only once.
+    if ( m_records.size() >= s_maxRecordCount ) {
+        m_recordIndices.insert( std::make_pair( key, s_maxRecordCount ) );
+        ++m_droppedRecordCount;
+        return m_droppedRecord;
+    }
+
+    AssetRecord record;
+    record.type                   = fileInfo.getAssetType();
+    record.path                   = fileInfo.getPath();
+    record.indexInFile            = fileInfo.getIndexInFile();
+    record.finished               = false;
+    record.succeeded              = false;
+    record.queuedTime             = -1.0;
+    record.readStartTime          = -1.0;
+    record.readEndTime            = -1.0;
+    record.parseStartTime         = -1.0;
+    record.parseEndTime           = -1.0;
+    record.subAssetsWaitStartTime = -1.0;
+    record.subAssetsWaitEndTime   = -1.0;
+    record.gpuUploadStartTime     = -1.0;
+    record.gpuUploadEndTime       = -1.0;
+    record.bytesRead              = 0;
+    record.readingThreadIndex     = -1;
+    record.parsingThreadIndex     = -1;
+    record.gpuUploadThreadIndex   = -1;
+
+    m_recordIndices.insert( std::make_pair( key, m_records.size() ) );
+    m_records.push_back( record );
+
+    return m_records.back();
+}
+
+int AssetLoadStats::getCurrentThreadIndex()
+{
+    const std::thread::id threadId = std::this_thread::get_id();
+
+    const auto it = m_threadIndices.find( threadId );
+    if ( it != m_threadIndices.end() )
+        return it->second;
+
+    const int threadIndex = (int)m_threadRoles.size();
+    m_threadIndices.insert( std::make_pair( threadId, threadIndex ) );
+    m_threadRoles.push_back( ThreadRole::Other );
+
+    return threadIndex;
+}
+
+void AssetLoadStats::addSample( const double time )
+{
+    m_currentState.time = time;
+
+    if ( m_samples.size() < s_maxSampleCount )
+    {
+        m_samples.push_back( m_currentState );
+    }
+    else
+    {
+        m_samples[ m_nextSampleIndex ] = m_currentState;
+        m_nextSampleIndex = ( m_nextSampleIndex + 1 ) % s_maxSampleCount;
+    }
+}
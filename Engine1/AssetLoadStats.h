@@ -0,0 +1,166 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "Asset.h"
+
+namespace Engine1
+{
+    class FileInfo;
+
+    // Collects timings of every stage of asset loading (queuing, reading from disk, parsing, waiting for sub-assets, uploading to GPU)
+    // together with queue depths and the number of busy worker threads over time.
+    // Allows to find out whether I/O, parsing or dependencies between assets are the bottleneck.
+    // Disabled by default - events are then ignored without locking.
+    // Number of kept records is limited (see s_maxRecordCount) - should be reset before loading a scene.
+    class AssetLoadStats
+    {
+        public:
+
+        // All times are in milliseconds, measured from the last reset. Negative time means that the stage didn't happen (yet).
+        struct AssetRecord
+        {
+            Asset::Type type;
+            std::string path;
+            int         indexInFile;
+
+            bool finished;
+            bool succeeded;
+
+            double queuedTime;
+            double readStartTime;
+            double readEndTime;
+            double parseStartTime;
+            double parseEndTime;
+            double subAssetsWaitStartTime;
+            double subAssetsWaitEndTime;
+            double gpuUploadStartTime;
+            double gpuUploadEndTime;
+
+            unsigned long long bytesRead;
+
+            int readingThreadIndex;
+            int parsingThreadIndex;
+            int gpuUploadThreadIndex;
+
+            double getQueuedDuration() const;
+            double getReadDuration() const;
+            double getParseDuration() const; // Excluding time spent waiting for sub-assets and uploading to GPU.
+            double getSubAssetsWaitDuration() const;
+            double getGpuUploadDuration() const;
+        };
+
+        // Snapshot of the loading pipeline state - taken whenever the state changes.
+        struct Sample
+        {
+            double time;
+
+            int assetsToRead;
+            int basicAssetsToParse;
+            int complexAssetsToParse;
+
+            int busyReadingThreads;
+            int busyBasicParsingThreads;
+            int busyComplexParsingThreads;
+        };
+
+        enum class ThreadRole : char
+        {
+            Other = 0,
+            Reading,
+            BasicParsing,
+            ComplexParsing
+        };
+
+        AssetLoadStats();
+        ~AssetLoadStats();
+
+        void reset();
+
+        void setEnabled( const bool enabled );
+        bool isEnabled() const;
+
+        // Milliseconds from the last reset.
+        double getTime() const;
+
+        std::vector< AssetRecord > getRecords() const;
+        AssetRecord                getRecord( Asset::Type type, const std::string& path, const int indexInFile = 0 ) const;
+        // Only the latest samples are kept (see s_maxSampleCount). Sorted by time.
+        std::vector< Sample >      getSamples() const;
+        // Number of assets which weren't recorded since the last reset, because there were already s_maxRecordCount records.
+        size_t                     getDroppedRecordCount() const;
+
+        // Fraction of time (0 - 1) the worker threads spent working between the first and the last recorded event.
+        float getReadingThreadsUtilization( const int threadCount ) const;
+        float getBasicParsingThreadsUtilization( const int threadCount ) const;
+        float getComplexParsingThreadsUtilization( const int threadCount ) const;
+
+        // Timeline, which can be viewed in Chrome (chrome://tracing) or Perfetto.
+        void saveToChromeTrace( const std::string& path ) const;
+        // One row per asset.
+        void saveToCsv( const std::string& path ) const;
+        // One row per sample.
+        void saveSamplesToCsv( const std::string& path ) const;
+
+        // Should be called by each worker thread before it starts recording events. Other threads are treated as 'Other'.
+        void registerCurrentThread( const ThreadRole role );
+
+        void onQueued( const FileInfo& fileInfo );
+        void onReadStarted( const FileInfo& fileInfo );
+        void onReadFinished( const FileInfo& fileInfo, const unsigned long long bytesRead, const bool succeeded );
+        void onParseStarted( const FileInfo& fileInfo );
+        void onSubAssetsWaitStarted( const FileInfo& fileInfo );
+        void onSubAssetsWaitFinished( const FileInfo& fileInfo );
+        void onParseFinished( const FileInfo& fileInfo, const bool succeeded );
+        void onGpuUploadStarted( const FileInfo& fileInfo );
+        void onGpuUploadFinished( const FileInfo& fileInfo );
+
+        // Called when a cancelled (or unloaded) asset is dropped from a queue without being read or parsed.
+        void onDropped( const FileInfo& fileInfo, const bool wasRead );
+
+        // Called when all assets waiting for reading or parsing are dropped.
+        void onQueuesCleared();
+
+        private:
+
+        // Note: Have to be called with the mutex locked.
+        AssetRecord& getOrCreateRecord( const FileInfo& fileInfo );
+        int          getCurrentThreadIndex();
+        void         addSample( const double time );
+        float        getUtilization( const ThreadRole role, const int threadCount ) const;
+
+        // Note: Has to be called with the mutex locked.
+        std::vector< Sample > getSamplesSortedByTime() const;
+
+        static const size_t s_maxSampleCount;
+        static const size_t s_maxRecordCount;
+
+        mutable std::mutex m_mutex;
+
+        std::atomic< bool > m_enabled;
+
+        std::chrono::steady_clock::time_point m_startTime;
+
+        std::vector< AssetRecord >                m_records;
+        std::unordered_map< Asset::Id, size_t >   m_recordIndices; // Latest record for each asset.
+        AssetRecord                               m_droppedRecord; // Receives events of assets which didn't fit in m_records.
+        size_t                                    m_droppedRecordCount;
+
+        std::vector< Sample > m_samples; // Ring buffer - the oldest sample is overwritten when full.
+        size_t                m_nextSampleIndex;
+        Sample                m_currentState;
+
+        std::unordered_map< std::thread::id, int > m_threadIndices;
+        std::vector< ThreadRole >                  m_threadRoles;
+
+        // Copying is not allowed.
+        AssetLoadStats( const AssetLoadStats& ) = delete;
+        AssetLoadStats& operator=( const AssetLoadStats& ) = delete;
+    };
+}
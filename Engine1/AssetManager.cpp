@@ -1,5 +1,6 @@
 #include "AssetManager.h"
 
+#include <algorithm>
 #include <climits>
 #include <thread>
 #include <d3d11_3.h>
@@ -11,9 +12,12 @@
 #include "SkeletonAnimation.h"
 
 #include "StringUtil.h"
+#include "ParallelUtil.h"
 
 #include "TextFile.h"
 #include "BinaryFile.h"
+#include "AssetArchive.h"
+#include "FileSystem.h"
 
 #include "SkeletonAnimationFileInfo.h"
 
@@ -21,11 +25,20 @@ using namespace Engine1;
 
 using Microsoft::WRL::ComPtr;
 
-AssetManager::AssetManager() 
+const long long AssetManager::s_parseFromFileMinSize = 256ll * 1024ll * 1024ll;
+const size_t    AssetManager::s_loadedIdTableMinCapacity = 64;
+
+AssetManager::AssetManager() :
+    m_hotReloadEnabled( false ),
+    m_executeReloadingThread( false ),
+    m_generation( 0 ),
+    m_inFlightCount( 0 )
 {}
 
 AssetManager::~AssetManager() 
 {
+    disableHotReload();
+
 	m_executeThreads = false;
 	m_assetsToReadFromDiskNotEmpty.notify_all();
 	m_basicAssetsToParseNotEmpty.notify_all();
@@ -63,17 +76,31 @@ void AssetManager::initialize( int parsingBasicAssetsThreadCount, int parsingCom
     }
 }
 
+void AssetManager::mountArchive( const std::string& path )
+{
+    auto archive = std::make_shared< const AssetArchive >( path );
+
+    std::lock_guard<std::mutex> archiveLock( m_archiveMutex );
+    m_archive = archive;
+}
+
+void AssetManager::unmountArchive()
+{
+    std::lock_guard<std::mutex> archiveLock( m_archiveMutex );
+    m_archive = nullptr;
+}
+
 void AssetManager::load( const FileInfo& fileInfo )
 {
-    std::string id = getId( fileInfo.getAssetType(), fileInfo.getPath(), fileInfo.getIndexInFile() );
+    const Asset::Id id = fileInfo.getAssetId();
 
-	{ // Check if asset was loaded already or is in the course of loading.
-		std::lock_guard<std::mutex> assetsLock( m_assetsMutex );
-		if ( m_assets.count( id ) != 0 ) 
-			throw std::exception( "AssetManager::load - Asset is already loaded or in the course of loading." );
-		
-		m_assets.insert( id );
-	}
+    bool         created    = false;
+    unsigned int generation = 0;
+    const std::shared_ptr< AssetEntry > entry = getOrCreateEntry( id, created, generation );
+
+    // Check if asset was loaded already or is in the course of loading.
+	if ( !created ) 
+		throw std::exception( "AssetManager::load - Asset is already loaded or in the course of loading." );
 
 	try 
     {
@@ -83,9 +110,21 @@ void AssetManager::load( const FileInfo& fileInfo )
             + std::to_string( fileInfo.getIndexInFile() ) + "]\n" 
         ).c_str( ) );
 
-		std::shared_ptr<Asset> asset = createFromFile( fileInfo );
+        m_loadStats.onParseStarted( fileInfo );
+
+        std::shared_ptr< const AssetArchive > archive;
+        {
+            std::lock_guard<std::mutex> archiveLock( m_archiveMutex );
+            archive = m_archive;
+        }
+
+		std::shared_ptr<Asset> asset = ( archive && archive->contains( fileInfo.getPath() ) )
+            ? createFromMemory( fileInfo, *readFile( fileInfo ) )
+            : createFromFile( fileInfo );
 
         { // Load sub-assets or wait for the sub-assets to be loaded and swap empty sub-assets with loaded sub-assets.
+            m_loadStats.onSubAssetsWaitStarted( fileInfo );
+
             std::vector<std::shared_ptr<Asset>> subAssets = asset->getSubAssets( );
             for ( std::shared_ptr<Asset>& subAsset : subAssets ) {
                 if ( !subAsset->getFileInfo().getPath().empty() ) {
@@ -94,12 +133,13 @@ void AssetManager::load( const FileInfo& fileInfo )
                     asset->swapSubAsset( subAsset, newSubAsset );
                 }
             }
+
+            m_loadStats.onSubAssetsWaitFinished( fileInfo );
         }
 
-		{
-			std::lock_guard<std::mutex> loadedAssetsLock( m_loadedAssetsMutex );
-			m_loadedAssets.insert( std::make_pair( id, asset ) );
-		}
+        m_loadStats.onParseFinished( fileInfo, true );
+
+        finishLoading( id, entry, asset );
 
 		OutputDebugStringW( StringUtil::widen( 
             "AssetManager::load - read and parsed \"" 
@@ -110,9 +150,10 @@ void AssetManager::load( const FileInfo& fileInfo )
 	} 
     catch ( std::exception& ex ) 
     {
+        m_loadStats.onParseFinished( fileInfo, false );
+
 		// If asset failed to load - remove it from assets.
-		std::lock_guard<std::mutex> assetsLock( m_assetsMutex );
-		m_assets.erase( id );
+        finishLoading( id, entry, nullptr );
 
 		OutputDebugStringW( StringUtil::widen( 
             "AssetManager::load - failed to read or parse \"" 
@@ -126,17 +167,86 @@ void AssetManager::load( const FileInfo& fileInfo )
 	}
 }
 
-void AssetManager::loadAsync( const FileInfo& fileInfo, const bool highestPriority )
+AssetManager::AssetFuture AssetManager::loadAsync( const FileInfo& fileInfo, const bool highestPriority )
 {
-    std::string id = getId( fileInfo.getAssetType(), fileInfo.getPath(), fileInfo.getIndexInFile() );
+    // Check if this asset was loaded already or is in the course of loading.
+    bool         created    = false;
+    unsigned int generation = 0;
+    std::shared_ptr< AssetEntry > entry = getOrCreateEntry( fileInfo.getAssetId(), created, generation );
 
-	{ // Check if this asset was loaded already or is in the course of loading.
-		std::lock_guard<std::mutex> assetsLock( m_assetsMutex );
-		if ( m_assets.count( id ) != 0 ) 
-			return; // Asset is already loading or loaded.
+    if ( !created ) { // Asset is already loading or loaded.
+        if ( highestPriority && !entry->finished )
+            prioritizeRequest( fileInfo, entry );
 
-		m_assets.insert( id );
-	}
+        return entry->future;
+    }
+
+    queueRequest( LoadRequest( fileInfo.clone(), entry, generation ), highestPriority );
+
+    return entry->future;
+}
+
+AssetManager::AssetFuture AssetManager::loadAsync( const FileInfo& fileInfo, const bool highestPriority, const unsigned int generation )
+{
+    bool         created           = false;
+    unsigned int currentGeneration = 0;
+    std::shared_ptr< AssetEntry > entry = getOrCreateEntry( fileInfo.getAssetId(), created, currentGeneration, &generation );
+
+    if ( !entry ) // All assets were unloaded in the meantime.
+    {
+        std::promise< std::shared_ptr<Asset> > promise;
+        promise.set_value( nullptr );
+
+        return promise.get_future().share();
+    }
+
+    if ( !created ) { // Asset is already loading or loaded.
+        if ( highestPriority && !entry->finished )
+            prioritizeRequest( fileInfo, entry );
+
+        return entry->future;
+    }
+
+    queueRequest( LoadRequest( fileInfo.clone(), entry, generation ), highestPriority );
+
+    return entry->future;
+}
+
+void AssetManager::prioritizeRequest( const FileInfo& fileInfo, const std::shared_ptr< AssetEntry >& entry )
+{
+    const auto moveToFront = [ &entry ]( std::list< LoadRequest >& requests ) {
+        const auto it = std::find_if( requests.begin(), requests.end(), [ &entry ]( const LoadRequest& request ) { return request.entry == entry; } );
+
+        if ( it == requests.end() )
+            return false;
+
+        requests.splice( requests.begin(), requests, it );
+        return true;
+    };
+
+    {
+        std::lock_guard<std::mutex> assetsToReadFromDiskLock( m_assetsToReadFromDiskMutex );
+
+        if ( moveToFront( fileInfo.canHaveSubAssets() ? m_complexAssetsToReadFromDisk : m_basicAssetsToReadFromDisk ) )
+            return;
+    }
+
+    // Note: The request may be read at the moment and added to the parsing queue afterwards - then it's parsed in order.
+    if ( fileInfo.canHaveSubAssets() ) 
+    {
+        std::lock_guard<std::mutex> complexAssetsToParseLock( m_complexAssetsToParseMutex );
+        moveToFront( m_complexAssetsToParse );
+    } 
+    else 
+    {
+        std::lock_guard<std::mutex> basicAssetsToParseLock( m_basicAssetsToParseMutex );
+        moveToFront( m_basicAssetsToParse );
+    }
+}
+
+void AssetManager::queueRequest( const LoadRequest& request, const bool highestPriority )
+{
+    const FileInfo& fileInfo = *request.fileInfo;
 
 	{ // Add the asset to the list of assets to load from disk - lock mutex.
 		std::unique_lock<std::mutex> assetsToLoadFromDiskLock( m_assetsToReadFromDiskMutex );
@@ -144,100 +254,137 @@ void AssetManager::loadAsync( const FileInfo& fileInfo, const bool highestPriori
         if ( fileInfo.canHaveSubAssets() ) 
         {
             if ( highestPriority )
-                m_complexAssetsToReadFromDisk.insert( m_complexAssetsToReadFromDisk.begin(), fileInfo.clone() );
+                m_complexAssetsToReadFromDisk.push_front( request );
             else
-                m_complexAssetsToReadFromDisk.push_back( fileInfo.clone() );
+                m_complexAssetsToReadFromDisk.push_back( request );
         } 
         else 
         {
             if ( highestPriority )
-                m_basicAssetsToReadFromDisk.insert( m_basicAssetsToReadFromDisk.begin(), fileInfo.clone() );
+                m_basicAssetsToReadFromDisk.push_front( request );
             else
-		        m_basicAssetsToReadFromDisk.push_back( fileInfo.clone() );
+		        m_basicAssetsToReadFromDisk.push_back( request );
         }
 	}
 
+    m_loadStats.onQueued( fileInfo );
+
 	// Resume thread which loads assets from disk.
 	m_assetsToReadFromDiskNotEmpty.notify_one();
 }
 
 bool AssetManager::isLoaded( Asset::Type type, std::string path, const int indexInFile )
 {
-    std::string id = getId( type, path, indexInFile );
-
-	//TODO: should I lock loadedAssets before searching through it?
-    return (m_loadedAssets.find( id ) != m_loadedAssets.end( ));
+    return isLoaded( Asset::createId( type, path, indexInFile ) );
 }
 
 bool AssetManager::isLoadedOrLoading( Asset::Type type, std::string path, const int indexInFile )
 {
-    std::string id = getId( type, path, indexInFile );
-
-	std::lock_guard<std::mutex> assetsLock( m_assetsMutex );
-    return (m_assets.count( id ) != 0);
+    return isLoadedOrLoading( Asset::createId( type, path, indexInFile ) );
 }
 
 std::shared_ptr<Asset> AssetManager::get( Asset::Type type, std::string path, const int indexInFile )
 {
-    std::string id = getId( type, path, indexInFile );
+    return get( Asset::createId( type, path, indexInFile ) );
+}
+
+bool AssetManager::isLoaded( const Asset::Id assetId )
+{
+    // Note: Doesn't lock the shard - only reads the latest table of loaded ids.
+    const LoadedIdTable* loadedIds = getShard( assetId ).loadedIds.load();
 
-	std::lock_guard<std::mutex> loadedAssetsLock( m_loadedAssetsMutex );
+    unsigned int generation = 0;
 
-    std::unordered_map< std::string, std::shared_ptr<Asset> >::iterator it = m_loadedAssets.find( id );
+    return loadedIds->find( assetId, generation ) && generation == m_generation;
+}
+
+bool AssetManager::isLoadedOrLoading( const Asset::Id assetId )
+{
+    AssetShard& shard = getShard( assetId );
+
+    std::lock_guard<std::mutex> lock( shard.mutex );
+
+    return shard.entries.count( assetId ) != 0;
+}
 
-	if ( it == m_loadedAssets.end() )
+std::shared_ptr<Asset> AssetManager::get( const Asset::Id assetId )
+{
+    AssetShard& shard = getShard( assetId );
+
+    std::lock_guard<std::mutex> lock( shard.mutex );
+
+    const auto it = shard.entries.find( assetId );
+
+	if ( it == shard.entries.end() || !it->second->loaded )
 		return nullptr;
 
-	return it->second;
+	return it->second->asset;
 }
 
 std::shared_ptr<Asset> AssetManager::getOrLoad( const FileInfo& fileInfo )
 {
     const float timeout = 660.0f;
 
-    if ( !isLoadedOrLoading( fileInfo.getAssetType(), fileInfo.getPath(), fileInfo.getIndexInFile() ) )
+    if ( !isLoadedOrLoading( fileInfo.getAssetId() ) )
         load( fileInfo );
 
-    return getWhenLoaded( fileInfo.getAssetType(), fileInfo.getPath( ), fileInfo.getIndexInFile( ), timeout );
+    return getWhenLoaded( fileInfo.getAssetId(), timeout );
 }
 
 std::shared_ptr<Asset> AssetManager::getWhenLoaded( Asset::Type type, std::string path, const int indexInFile, const float timeout )
 {
-    std::string id = getId( type, path, indexInFile );
+    return getWhenLoaded( Asset::createId( type, path, indexInFile ), timeout );
+}
 
-	std::unordered_map< std::string, std::shared_ptr<Asset> >::iterator it;
+std::shared_ptr<Asset> AssetManager::getWhenLoaded( const Asset::Id assetId, const float timeout )
+{
+    std::shared_ptr< AssetEntry > entry = findEntry( assetId );
 
-	const std::chrono::steady_clock::time_point timoutTime = std::chrono::steady_clock::now( ) + std::chrono::microseconds( (long long)( timeout / 0.000001f ) );
+    // Check if that asset failed to load (because it's not loading).
+    if ( !entry )
+        return nullptr; //#TODO: Should it throw exception?
 
-	std::unique_lock<std::mutex> loadedAssetsLock( m_loadedAssetsMutex );
+    // Wait until the asset finishes loading or timeout. Only threads waiting for this asset are woken up.
+    const std::chrono::microseconds timeoutDuration( (long long)( timeout / 0.000001f ) );
 
-	for (;;) {
-		// Check if the asset is loaded.
-        it = m_loadedAssets.find( id );
-		if ( it != m_loadedAssets.end() )
-			return it->second;
-
-        { // Check if that asset failed to load (because it's not loading).
-            std::lock_guard<std::mutex> assetsLock( m_assetsMutex );
-            if ( m_assets.count( id ) == 0 )
-                return nullptr; //#TODO: Should it throw exception?
-        }
+    if ( entry->future.wait_for( timeoutDuration ) != std::future_status::ready )
+        return nullptr;
 
-		// Wait until some asset finish loading or timeout.
-        // #TODO: Could use wait_for instead. No need to check current time.
-		std::_Cv_status status = m_assetLoadedOrError.wait_until( loadedAssetsLock, timoutTime );
+    // Note: Returns the latest version of the asset, which may have been hot-reloaded in the meantime.
+    return get( assetId );
+}
 
-		// Exit method on timeout.
-		if ( status == std::cv_status::timeout )
-			return nullptr;
-	}
+bool AssetManager::cancel( const Asset::Id assetId )
+{
+    std::shared_ptr< AssetEntry > entry = nullptr;
+
+    {
+        AssetShard& shard = getShard( assetId );
+
+        std::lock_guard<std::mutex> lock( shard.mutex );
+
+        // Note: Loaded asset may not be finished yet (see finishLoading).
+        const auto it = shard.entries.find( assetId );
+        if ( it == shard.entries.end() || it->second->finished || it->second->loaded )
+            return false;
+
+        // Note: Request stays in the queue - it's dropped when a worker thread takes it.
+        entry = it->second;
+        entry->cancelled = true;
+        shard.entries.erase( it );
+    }
+
+    entry->finish( nullptr );
+
+    return true;
 }
 
 void AssetManager::unloadAll()
 {
     {
-        std::lock_guard<std::mutex> lock( m_loadedAssetsMutex );
-	    m_loadedAssets.clear();
+        std::lock_guard<std::mutex> lock( m_assetsToReadFromDiskMutex );
+        m_basicAssetsToReadFromDisk.clear();
+        m_complexAssetsToReadFromDisk.clear();
     }
 
     {
@@ -250,19 +397,161 @@ void AssetManager::unloadAll()
 	    m_basicAssetsToParse.clear();
     }
 
+    m_loadStats.onQueuesCleared();
+
+    std::vector< std::unordered_map< Asset::Id, std::shared_ptr< AssetEntry > > > entries( s_assetShardCount );
+
+    { // Requests taken from the queues from now on are stale. Generation is changed together with removing all the entries,
+      // so an entry created in the meantime is either removed or belongs to the new generation (see getOrCreateEntry).
+        std::vector< std::unique_lock<std::mutex> > shardLocks;
+        shardLocks.reserve( s_assetShardCount );
+
+        for ( AssetShard& shard : m_assetShards )
+            shardLocks.emplace_back( shard.mutex );
+
+        ++m_generation;
+
+        for ( int i = 0; i < s_assetShardCount; ++i )
+            entries[ i ].swap( m_assetShards[ i ].entries );
+    }
+
+    // Release threads waiting for assets, which won't finish loading now (including parsing threads waiting for sub-assets).
+    for ( auto& shardEntries : entries ) 
+    {
+        for ( auto& entry : shardEntries )
+            entry.second->finish( nullptr );
+    }
+
+    { // Wait for the assets being read or parsed - their results are discarded.
+        std::unique_lock<std::mutex> lock( m_inFlightMutex );
+        m_inFlightFinished.wait( lock, [ this ]() { return m_inFlightCount == 0; } );
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_dependenciesMutex );
+        m_assetIdsByPath.clear();
+        m_parentAssetIds.clear();
+    }
+
     {
-        std::lock_guard<std::mutex> lock( m_assetsMutex );
-	    m_assets.clear();
+        std::lock_guard<std::mutex> lock( m_reloadedAssetsMutex );
+        m_reloadedAssets.clear();
+    }
+}
+
+void AssetManager::enableHotReload( const std::string& directory )
+{
+    disableHotReload();
+
+    m_fileWatcher.start( directory );
+
+    m_executeReloadingThread = true;
+    m_reloadingThread = std::thread( &AssetManager::reloadChangedAssets, this );
+
+    m_hotReloadEnabled = true;
+}
+
+void AssetManager::disableHotReload()
+{
+    if ( !m_reloadingThread.joinable() )
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock( m_reloadingMutex );
+        m_executeReloadingThread = false;
+    }
+
+    m_hotReloadEnabled = false;
+
+    m_reloadingThreadStop.notify_all();
+    m_reloadingThread.join();
+
+    m_fileWatcher.stop();
+
+    std::lock_guard<std::mutex> lock( m_dependenciesMutex );
+    m_assetIdsByPath.clear();
+    m_parentAssetIds.clear();
+}
+
+void AssetManager::ignoreFileChange( const std::string& path )
+{
+    if ( m_hotReloadEnabled )
+        m_fileWatcher.ignoreCurrentChange( path );
+}
+
+int AssetManager::swapReloadedAssets()
+{
+    std::vector< std::pair< Asset::Id, std::shared_ptr<Asset> > > reloadedAssets;
+
+    {
+        std::lock_guard<std::mutex> lock( m_reloadedAssetsMutex );
+        reloadedAssets.swap( m_reloadedAssets );
+    }
+
+    int swappedAssetCount = 0;
+
+    for ( const auto& reloadedAsset : reloadedAssets ) 
+    {
+        const Asset::Id               id       = reloadedAsset.first;
+        const std::shared_ptr<Asset>& newAsset = reloadedAsset.second;
+        std::shared_ptr<Asset>        oldAsset = nullptr;
+
+        { // Replace the asset in the list of loaded assets.
+            AssetShard& shard = getShard( id );
+
+            std::lock_guard<std::mutex> lock( shard.mutex );
+
+            const auto it = shard.entries.find( id );
+            if ( it == shard.entries.end() || !it->second->loaded )
+                continue; // Asset was unloaded in the meantime.
+
+            oldAsset = it->second->asset;
+            it->second->asset = newAsset;
+        }
+
+        std::vector< Asset::Id > parentIds;
+        {
+            std::lock_guard<std::mutex> lock( m_dependenciesMutex );
+
+            const auto it = m_parentAssetIds.find( id );
+            if ( it != m_parentAssetIds.end() )
+                parentIds = it->second;
+        }
+
+        // Replace the asset in all assets using it.
+        for ( const Asset::Id parentId : parentIds ) 
+        {
+            std::shared_ptr<Asset> parent = get( parentId );
+            if ( !parent )
+                continue;
+
+            try 
+            {
+                parent->swapSubAsset( oldAsset, newAsset );
+            } 
+            catch ( std::exception& ex ) 
+            {
+                // Parent doesn't use that asset anymore (ex: it was replaced by the user).
+                OutputDebugStringW( StringUtil::widen( 
+                    "AssetManager::swapReloadedAssets - failed to swap \"" 
+                    + newAsset->getFileInfo().getPath() + "\" in \"" 
+                    + parent->getFileInfo().getPath() + "\".\nException: " 
+                    + ex.what() + ".\n"
+                ).c_str() );
+            }
+        }
+
+        ++swappedAssetCount;
     }
+
+    return swappedAssetCount;
 }
 
 void AssetManager::readAssetsFromDisk() {
-	std::shared_ptr< const FileInfo > fileInfo = nullptr;
-	std::shared_ptr< std::vector<char> > fileData = nullptr;
+    m_loadStats.registerCurrentThread( AssetLoadStats::ThreadRole::Reading );
 
 	for (;;) {
-		fileInfo = nullptr;
-		fileData = nullptr;
+		LoadRequest request;
 
 		{ // Check if there is any asset to load and if so, get it - hold lock.
 			std::unique_lock<std::mutex> assetsToReadFromDiskLock( m_assetsToReadFromDiskMutex );
@@ -278,30 +567,45 @@ void AssetManager::readAssetsFromDisk() {
             // to avoid locking parsing threads which wait for the sub-assets to be loaded.
             if ( !m_basicAssetsToReadFromDisk.empty() ) {
 			    // Get first asset from the list
-			    fileInfo = m_basicAssetsToReadFromDisk.front( );
+			    request = m_basicAssetsToReadFromDisk.front( );
 			    // Remove asset from the list.
 			    m_basicAssetsToReadFromDisk.pop_front();
             } else {
                 // Get first asset from the list
-			    fileInfo = m_complexAssetsToReadFromDisk.front( );
+			    request = m_complexAssetsToReadFromDisk.front( );
 			    // Remove asset from the list.
 			    m_complexAssetsToReadFromDisk.pop_front();
             }
+
+            beginInFlight();
 		}
 
+        const std::shared_ptr< const FileInfo >& fileInfo = request.fileInfo;
+
+        // Drop cancelled or unloaded assets without reading them.
+        if ( isStale( request ) ) {
+            m_loadStats.onDropped( *fileInfo, false );
+            finishLoading( fileInfo->getAssetId(), request.entry, nullptr );
+            endInFlight();
+            continue;
+        }
+
 		OutputDebugStringW( StringUtil::widen( 
             "AssetManager::readAssetsFromDisk - reading \"" 
             + fileInfo->getPath( ) + "\" [" 
             + std::to_string( fileInfo->getIndexInFile() ) + "]\n"  
         ).c_str( ) );
 
+        m_loadStats.onReadStarted( *fileInfo );
+
 		// Load file from disk.
 		try 
         {
-			if ( fileInfo->getFileType() == FileInfo::FileType::Textual )
-				fileData = TextFile::load( fileInfo->getPath() );
-			else if ( fileInfo->getFileType() == FileInfo::FileType::Binary )
-				fileData = BinaryFile::load( fileInfo->getPath() );
+            // Note: File data is left empty for files parsed directly from the file.
+            if ( !shouldParseFromFile( *fileInfo ) )
+			    request.fileData = readFile( *fileInfo );
+
+            m_loadStats.onReadFinished( *fileInfo, request.fileData ? request.fileData->size() : 0, true );
 
 			OutputDebugStringW( StringUtil::widen( 
                 "AssetManager::readAssetsFromDisk - read \"" 
@@ -312,11 +616,10 @@ void AssetManager::readAssetsFromDisk() {
 		} 
         catch ( std::exception& ex ) 
         {
-            std::string id = getId( fileInfo->getAssetType( ), fileInfo->getPath( ), fileInfo->getIndexInFile( ) );
+            m_loadStats.onReadFinished( *fileInfo, 0, false );
 
-			// If asset failed to load - remove it from assets.
-			std::lock_guard<std::mutex> assetsLock( m_assetsMutex );
-			m_assets.erase( id );
+			// If asset failed to load - remove it from assets and notify threads waiting for it.
+            finishLoading( fileInfo->getAssetId(), request.entry, nullptr );
 
 			OutputDebugStringW( StringUtil::widen( 
                 "AssetManager::readAssetsFromDisk - failed to read \"" 
@@ -325,10 +628,8 @@ void AssetManager::readAssetsFromDisk() {
                 + ex.what() + ".\n"
             ).c_str( ) );
 
-            // Notify 'getWhenLoaded' method that an asset failed to load.
-            m_assetLoadedOrError.notify_all();
-
 			//TODO: handle this error - do some callback for ex.
+            endInFlight();
             continue;
 		}
 
@@ -338,7 +639,7 @@ void AssetManager::readAssetsFromDisk() {
             if ( fileInfo->canHaveSubAssets() ) 
             {
                 std::lock_guard<std::mutex> complexAssetsToParseLock( m_complexAssetsToParseMutex );
-                m_complexAssetsToParse.push_back( AssetToParse( fileInfo, fileData ) );
+                m_complexAssetsToParse.push_back( request );
 
                 // Resume one of threads which parses complex assets.
                 m_complexAssetsToParseNotEmpty.notify_one();
@@ -346,19 +647,26 @@ void AssetManager::readAssetsFromDisk() {
             else 
             {
                 std::lock_guard<std::mutex> basicAssetsToParseLock( m_basicAssetsToParseMutex );
-			    m_basicAssetsToParse.push_back( AssetToParse( fileInfo, fileData ) );
+			    m_basicAssetsToParse.push_back( request );
 
                 // Resume one of threads which parses basic assets.
                 m_basicAssetsToParseNotEmpty.notify_one();
             }
 		}
+
+        endInFlight();
 	}
 }
 
 void AssetManager::parseBasicAssets() 
 {
+    m_loadStats.registerCurrentThread( AssetLoadStats::ThreadRole::BasicParsing );
+
+    // Parsing threads occupy all cores, so parsers don't spawn their own threads (ex: when calculating animations).
+    ParallelUtil::WorkerThreadScope workerThreadScope;
+
 	for (;;) {
-		AssetToParse assetToParse;
+		LoadRequest assetToParse;
 
 		{ // Check if there is any asset to load and if so, get it - hold lock.
 			std::unique_lock<std::mutex> basicAssetsToParseLock( m_basicAssetsToParseMutex );
@@ -374,8 +682,18 @@ void AssetManager::parseBasicAssets()
 
             // Remove basic asset from the list.
 			m_basicAssetsToParse.pop_front();
+
+            beginInFlight();
 		}
 
+        // Drop cancelled or unloaded assets without parsing them.
+        if ( isStale( assetToParse ) ) {
+            m_loadStats.onDropped( *assetToParse.fileInfo, true );
+            finishLoading( assetToParse.fileInfo->getAssetId(), assetToParse.entry, nullptr );
+            endInFlight();
+            continue;
+        }
+
 		OutputDebugStringW( StringUtil::widen( 
             "AssetManager::parseBasicAssets - parsing \"" 
             + assetToParse.fileInfo->getPath( ) + "\" [" 
@@ -384,10 +702,14 @@ void AssetManager::parseBasicAssets()
 
 		std::shared_ptr<Asset> asset = nullptr;
 
+        m_loadStats.onParseStarted( *assetToParse.fileInfo );
+
 		// Parse basic asset.
 		try 
         {
-			asset = createFromMemory( *assetToParse.fileInfo, *assetToParse.fileData );
+			asset = assetToParse.fileData 
+                ? createFromMemory( *assetToParse.fileInfo, *assetToParse.fileData )
+                : createFromFile( *assetToParse.fileInfo );
 
 			OutputDebugStringW( StringUtil::widen( 
                 "AssetManager::parseBasicAssets - parsed \"" 
@@ -397,9 +719,10 @@ void AssetManager::parseBasicAssets()
 		} 
         catch ( std::exception& ex ) 
         {
-			// Asset failed to load - remove it from assets.
-			std::lock_guard<std::mutex> assetsLock( m_assetsMutex );
-			m_assets.erase( assetToParse.fileInfo->getPath() );
+            m_loadStats.onParseFinished( *assetToParse.fileInfo, false );
+
+			// Asset failed to load - remove it from assets and notify threads waiting for it.
+            finishLoading( assetToParse.fileInfo->getAssetId(), assetToParse.entry, nullptr );
 
 			OutputDebugStringW( StringUtil::widen( 
                 "AssetManager::parseBasicAssets - failed to parse \"" 
@@ -408,30 +731,28 @@ void AssetManager::parseBasicAssets()
                 + ex.what() + ".\n"
             ).c_str( ) );
 
-            // Notify 'getWhenLoaded' method that an asset failed to load.
-            m_assetLoadedOrError.notify_all();
-
 			//TODO: handle this error - do some callback for ex.
+            endInFlight();
             continue;
 		}
 
-		{ // Add asset to a list of assets - hold lock.
-			std::lock_guard<std::mutex> loadedAssetsLock( m_loadedAssetsMutex );
-			// Add asset to a list of assets.
+        m_loadStats.onParseFinished( *assetToParse.fileInfo, true );
 
-            std::string id = getId( assetToParse.fileInfo->getAssetType( ), assetToParse.fileInfo->getPath( ), assetToParse.fileInfo->getIndexInFile() );
-			m_loadedAssets.insert( std::make_pair( id, asset ) );
-		}
+		// Add asset to a list of assets and notify threads waiting for it.
+        finishLoading( assetToParse.fileInfo->getAssetId(), assetToParse.entry, asset );
 
-		// Notify 'getWhenLoaded' method that an asset has just been loaded.
-		m_assetLoadedOrError.notify_all();
+        endInFlight();
 	}
 }
 
 void AssetManager::parseComplexAssets()
 {
+    m_loadStats.registerCurrentThread( AssetLoadStats::ThreadRole::ComplexParsing );
+
+    ParallelUtil::WorkerThreadScope workerThreadScope;
+
     for ( ;;) {
-        AssetToParse assetToParse;
+        LoadRequest assetToParse;
 
         { // Check if there is any asset to load and if so, get it - hold lock.
             std::unique_lock<std::mutex> complexAssetsToParseLock( m_complexAssetsToParseMutex );
@@ -447,6 +768,16 @@ void AssetManager::parseComplexAssets()
 
             // Remove complex asset from the list.
             m_complexAssetsToParse.pop_front();
+
+            beginInFlight();
+        }
+
+        // Drop cancelled or unloaded assets without parsing them.
+        if ( isStale( assetToParse ) ) {
+            m_loadStats.onDropped( *assetToParse.fileInfo, true );
+            finishLoading( assetToParse.fileInfo->getAssetId(), assetToParse.entry, nullptr );
+            endInFlight();
+            continue;
         }
 
         OutputDebugStringW( StringUtil::widen( 
@@ -457,27 +788,40 @@ void AssetManager::parseComplexAssets()
 
         std::shared_ptr<Asset> asset = nullptr;
 
+        m_loadStats.onParseStarted( *assetToParse.fileInfo );
+
         // Parse complex asset and its sub-assets (basic assets).
         try 
         {
             asset = createFromMemory( *assetToParse.fileInfo, *assetToParse.fileData );
 
+            // Don't start loading sub-assets of an asset, which was cancelled or unloaded while being parsed.
+            if ( isStale( assetToParse ) )
+                throw std::exception( "AssetManager::parseComplexAssets - asset was cancelled or unloaded." );
+
             { // Load sub-assets if needed.
                 std::vector<std::shared_ptr<Asset>> subAssets = asset->getSubAssets();
-                for ( std::shared_ptr<Asset>& subAsset : subAssets ) {
-                    if ( !subAsset->getFileInfo().getPath().empty() )
-                        loadAsync( subAsset->getFileInfo(), true ); // Note: Load sub-assets with the highest priority.
+                std::vector< AssetFuture >          subAssetFutures( subAssets.size() );
+                for ( size_t i = 0; i < subAssets.size(); ++i ) {
+                    if ( !subAssets[ i ]->getFileInfo().getPath().empty() )
+                        subAssetFutures[ i ] = loadAsync( subAssets[ i ]->getFileInfo(), true, assetToParse.generation ); // Note: Load sub-assets with the highest priority.
                 }
 
                 // Wait for the sub-assets to be loaded and swap empty sub-assets with loaded sub-assets.
-                const float subAssetLoadTimeout = 660.0f;
-                for ( std::shared_ptr<Asset>& subAsset : subAssets ) {
-                    if ( !subAsset->getFileInfo().getPath().empty() ) {
-                        std::shared_ptr<Asset> newSubAsset = getWhenLoaded( subAsset->getFileInfo().getAssetType(), subAsset->getFileInfo().getPath(), subAsset->getFileInfo().getIndexInFile(), subAssetLoadTimeout );
+                m_loadStats.onSubAssetsWaitStarted( *assetToParse.fileInfo );
+
+                const std::chrono::steady_clock::time_point subAssetLoadTimeoutTime = std::chrono::steady_clock::now() + std::chrono::seconds( 660 );
+                for ( size_t i = 0; i < subAssets.size(); ++i ) {
+                    if ( subAssetFutures[ i ].valid() ) {
+                        std::shared_ptr<Asset> newSubAsset = nullptr;
+                        if ( subAssetFutures[ i ].wait_until( subAssetLoadTimeoutTime ) == std::future_status::ready )
+                            newSubAsset = subAssetFutures[ i ].get();
 
-                        asset->swapSubAsset( subAsset, newSubAsset );
+                        asset->swapSubAsset( subAssets[ i ], newSubAsset );
                     }
                 }
+
+                m_loadStats.onSubAssetsWaitFinished( *assetToParse.fileInfo );
             }
 
             OutputDebugStringW( StringUtil::widen( 
@@ -488,9 +832,10 @@ void AssetManager::parseComplexAssets()
         } 
         catch ( std::exception& ex ) 
         {
-            // Asset failed to load - remove it from assets.
-            std::lock_guard<std::mutex> assetsLock( m_assetsMutex );
-            m_assets.erase( assetToParse.fileInfo->getPath() );
+            m_loadStats.onParseFinished( *assetToParse.fileInfo, false );
+
+            // Asset failed to load - remove it from assets and notify threads waiting for it.
+            finishLoading( assetToParse.fileInfo->getAssetId(), assetToParse.entry, nullptr );
 
             OutputDebugStringW( StringUtil::widen( 
                 "AssetManager::parseComplexAssets - failed to parse \"" 
@@ -499,24 +844,63 @@ void AssetManager::parseComplexAssets()
                 + ex.what() + ".\n"
             ).c_str() );
 
-            // Notify 'getWhenLoaded' method that an asset failed to load.
-            m_assetLoadedOrError.notify_all();
-
             //TODO: handle this error - do some callback for ex.
+            endInFlight();
             continue;
         }
 
-        { // Add asset to a list of assets - hold lock.
-            std::lock_guard<std::mutex> loadedAssetsLock( m_loadedAssetsMutex );
-            // Add asset to a list of assets.
+        m_loadStats.onParseFinished( *assetToParse.fileInfo, true );
 
-            std::string id = getId( assetToParse.fileInfo->getAssetType(), assetToParse.fileInfo->getPath(), assetToParse.fileInfo->getIndexInFile() );
-            m_loadedAssets.insert( std::make_pair( id, asset ) );
-        }
+        // Add asset to a list of assets and notify threads waiting for it.
+        finishLoading( assetToParse.fileInfo->getAssetId(), assetToParse.entry, asset );
+
+        endInFlight();
+    }
+}
+
+AssetLoadStats& AssetManager::getLoadStats()
+{
+    return m_loadStats;
+}
+
+const AssetLoadStats& AssetManager::getLoadStats() const
+{
+    return m_loadStats;
+}
 
-        // Notify 'getWhenLoaded' method that an asset has just been loaded.
-        m_assetLoadedOrError.notify_all();
+std::shared_ptr< std::vector<char> > AssetManager::readFile( const FileInfo& fileInfo )
+{
+    std::shared_ptr< const AssetArchive > archive;
+    {
+        std::lock_guard<std::mutex> archiveLock( m_archiveMutex );
+        archive = m_archive;
     }
+
+    const bool isTextual = fileInfo.getFileType() == FileInfo::FileType::Textual;
+
+    // Note: Textual files are zero-terminated, same as when loaded through TextFile.
+    if ( archive && archive->contains( fileInfo.getPath() ) )
+        return archive->read( fileInfo.getPath(), isTextual );
+
+    if ( isTextual )
+        return TextFile::load( fileInfo.getPath() );
+    else
+        return BinaryFile::load( fileInfo.getPath() );
+}
+
+bool AssetManager::shouldParseFromFile( const FileInfo& fileInfo )
+{
+    if ( fileInfo.getAssetType() != Asset::Type::BlockMesh 
+         || static_cast<const BlockMeshFileInfo&>( fileInfo ).getFormat() != BlockMeshFileInfo::Format::BLOCKMESH )
+        return false;
+
+    {
+        std::lock_guard<std::mutex> archiveLock( m_archiveMutex );
+        if ( m_archive && m_archive->contains( fileInfo.getPath() ) )
+            return false;
+    }
+
+    return FileSystem::getFileSize( fileInfo.getPath() ) >= s_parseFromFileMinSize;
 }
 
 std::shared_ptr<Asset> AssetManager::createFromFile( const FileInfo& fileInfo )
@@ -537,12 +921,12 @@ std::shared_ptr<Asset> AssetManager::createFromFile( const FileInfo& fileInfo )
 
 			std::shared_ptr<const SkeletonMesh> referenceMesh;
 			{ // Get or load the reference mesh.
-                const bool meshLoadedOrLoading = isLoadedOrLoading( animFileInfo.getMeshFileInfo( ).getAssetType(), animFileInfo.getMeshFileInfo( ).getPath( ), animFileInfo.getMeshFileInfo( ).getIndexInFile( ) );
+                const bool meshLoadedOrLoading = isLoadedOrLoading( animFileInfo.getMeshFileInfo().getAssetId() );
 				if ( !meshLoadedOrLoading )
 					loadAsync( animFileInfo.getMeshFileInfo() );
 
 				const float loadTimeout = 60.0f;
-                std::shared_ptr<const Asset> mesh = getWhenLoaded( animFileInfo.getMeshFileInfo( ).getAssetType(), animFileInfo.getMeshFileInfo( ).getPath( ), animFileInfo.getMeshFileInfo( ).getIndexInFile( ), loadTimeout );
+                std::shared_ptr<const Asset> mesh = getWhenLoaded( animFileInfo.getMeshFileInfo().getAssetId(), loadTimeout );
 				referenceMesh = mesh->getType() == Asset::Type::SkeletonMesh ? std::static_pointer_cast<const SkeletonMesh>( mesh ) : nullptr;
 			}
 
@@ -556,15 +940,21 @@ std::shared_ptr<Asset> AssetManager::createFromFile( const FileInfo& fileInfo )
             const Texture2DFileInfo& textureFileInfo = static_cast<const Texture2DFileInfo&>( fileInfo );
             if ( textureFileInfo.getPixelType() == Texture2DFileInfo::PixelType::UCHAR4 )
             {
-			    return std::make_shared< ImmutableTexture2D< uchar4 > >
-                    ( *m_device.Get(), textureFileInfo, true, true, true, 
+			    auto texture = std::make_shared< ImmutableTexture2D< uchar4 > >
+                    ( *m_device.Get(), textureFileInfo, true, false, true, 
 						DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM );
+                loadTextureToGpu( *texture, textureFileInfo );
+
+                return texture;
             }
             else if ( textureFileInfo.getPixelType() == Texture2DFileInfo::PixelType::UCHAR )
             {
-                return std::make_shared< ImmutableTexture2D< unsigned char > >
-                    ( *m_device.Get(), textureFileInfo, true, true, true, 
+                auto texture = std::make_shared< ImmutableTexture2D< unsigned char > >
+                    ( *m_device.Get(), textureFileInfo, true, false, true, 
 						DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
+                loadTextureToGpu( *texture, textureFileInfo );
+
+                return texture;
             }
         }
 		default:
@@ -614,12 +1004,12 @@ std::shared_ptr<Asset> AssetManager::createFromMemory( const FileInfo& fileInfo,
 
 			std::shared_ptr<const SkeletonMesh> referenceMesh;
 			{ // Get or load the reference mesh.
-                const bool meshLoadedOrLoading = isLoadedOrLoading( animFileInfo.getMeshFileInfo( ).getAssetType( ), animFileInfo.getMeshFileInfo( ).getPath( ), animFileInfo.getMeshFileInfo( ).getIndexInFile( ) );
+                const bool meshLoadedOrLoading = isLoadedOrLoading( animFileInfo.getMeshFileInfo().getAssetId() );
 				if ( !meshLoadedOrLoading )
 					loadAsync( animFileInfo.getMeshFileInfo() );
 
 				const float loadTimeout = 60.0f;
-                std::shared_ptr<const Asset> mesh = getWhenLoaded( animFileInfo.getMeshFileInfo( ).getAssetType( ), animFileInfo.getMeshFileInfo( ).getPath( ), animFileInfo.getMeshFileInfo( ).getIndexInFile( ), loadTimeout );
+                std::shared_ptr<const Asset> mesh = getWhenLoaded( animFileInfo.getMeshFileInfo().getAssetId(), loadTimeout );
 				referenceMesh = mesh->getType() == Asset::Type::SkeletonMesh ? std::static_pointer_cast<const SkeletonMesh>( mesh ) : nullptr;
 			}
 
@@ -639,18 +1029,20 @@ std::shared_ptr<Asset> AssetManager::createFromMemory( const FileInfo& fileInfo,
             if ( texFileInfo.getPixelType() == Texture2DFileInfo::PixelType::UCHAR4 )
             {
                 auto texture = std::make_shared< ImmutableTexture2D< uchar4 > >
-                    ( *m_device.Get(), fileData.cbegin(), fileData.cend(), texFileInfo.getFormat( ), true, true, true, 
+                    ( *m_device.Get(), fileData.cbegin(), fileData.cend(), texFileInfo.getFormat( ), true, false, true, 
 						DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM );
                 texture->setFileInfo( texFileInfo );
+                loadTextureToGpu( *texture, texFileInfo );
 
                 return texture;
             }
             else if ( texFileInfo.getPixelType() == Texture2DFileInfo::PixelType::UCHAR )
             {
                 auto texture = std::make_shared< ImmutableTexture2D< unsigned char > >
-                    ( *m_device.Get(), fileData.cbegin(), fileData.cend(), texFileInfo.getFormat( ), true, true, true, 
+                    ( *m_device.Get(), fileData.cbegin(), fileData.cend(), texFileInfo.getFormat( ), true, false, true, 
 						DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
                 texture->setFileInfo( texFileInfo );
+                loadTextureToGpu( *texture, texFileInfo );
 
                 return texture;
             }
@@ -660,7 +1052,309 @@ std::shared_ptr<Asset> AssetManager::createFromMemory( const FileInfo& fileInfo,
 	}
 }
 
-std::string AssetManager::getId( Asset::Type type, const std::string path, const int indexInFile )
+template< typename PixelType >
+void AssetManager::loadTextureToGpu( Texture2D< PixelType >& texture, const FileInfo& fileInfo )
+{
+    m_loadStats.onGpuUploadStarted( fileInfo );
+
+    texture.loadCpuToGpu( *m_device.Get() );
+
+    m_loadStats.onGpuUploadFinished( fileInfo );
+}
+
+AssetManager::LoadedIdTable::LoadedIdTable( const size_t capacity ) :
+    ids( new std::atomic< Asset::Id >[ capacity ]() ),
+    generations( new std::atomic< unsigned int >[ capacity ]() ),
+    capacity( capacity ),
+    usedCount( 0 )
+{}
+
+size_t AssetManager::LoadedIdTable::getSlotIndex( const Asset::Id id ) const
+{
+    // Note: Ids in a shard share the low bits used to select the shard, so all bits are mixed.
+    return (size_t)( ( ( id ^ ( id >> 32 ) ) * 0x9E3779B97F4A7C15ull ) >> 32 ) & ( capacity - 1 );
+}
+
+bool AssetManager::LoadedIdTable::find( const Asset::Id id, unsigned int& generation ) const
+{
+    for ( size_t slotIndex = getSlotIndex( id ); ; slotIndex = ( slotIndex + 1 ) & ( capacity - 1 ) )
+    {
+        const Asset::Id slotId = ids[ slotIndex ].load();
+
+        if ( slotId == 0 )
+            return false;
+
+        if ( slotId == id ) {
+            generation = generations[ slotIndex ].load();
+            return true;
+        }
+    }
+}
+
+bool AssetManager::LoadedIdTable::insert( const Asset::Id id, const unsigned int generation )
+{
+    size_t slotIndex = getSlotIndex( id );
+    while ( true )
+    {
+        const Asset::Id slotId = ids[ slotIndex ].load();
+
+        if ( slotId == id ) {
+            generations[ slotIndex ] = generation;
+            return true;
+        }
+
+        if ( slotId == 0 )
+            break;
+
+        slotIndex = ( slotIndex + 1 ) & ( capacity - 1 );
+    }
+
+    // Keep at least half of the slots empty, so probing stays short and always ends at an empty slot.
+    if ( ( usedCount + 1 ) * 2 > capacity )
+        return false;
+
+    // Note: Generation is stored before the id, so a thread which finds the id also sees its generation.
+    generations[ slotIndex ] = generation;
+    ids[ slotIndex ]         = id;
+
+    ++usedCount;
+
+    return true;
+}
+
+AssetManager::AssetShard::AssetShard()
+{
+    loadedIdTables.push_back( std::make_unique< LoadedIdTable >( s_loadedIdTableMinCapacity ) );
+    loadedIds = loadedIdTables.back().get();
+}
+
+void AssetManager::AssetShard::markLoaded( const Asset::Id id, const unsigned int generation )
+{
+    LoadedIdTable& table = *loadedIdTables.back();
+
+    if ( table.insert( id, generation ) )
+        return;
+
+    // Table is full - copy it to a larger one. The old table stays valid for the threads reading it at the moment.
+    auto largerTable = std::make_unique< LoadedIdTable >( table.capacity * 2 );
+
+    for ( size_t slotIndex = 0; slotIndex < table.capacity; ++slotIndex )
+    {
+        const Asset::Id slotId = table.ids[ slotIndex ];
+        if ( slotId != 0 )
+            largerTable->insert( slotId, table.generations[ slotIndex ] );
+    }
+
+    largerTable->insert( id, generation );
+
+    loadedIdTables.push_back( std::move( largerTable ) );
+    loadedIds = loadedIdTables.back().get();
+}
+
+AssetManager::AssetShard& AssetManager::getShard( const Asset::Id id )
+{
+    // Note: Low bits of the id hold the interned path index, so consecutive paths go to different shards.
+    return m_assetShards[ ( id ^ ( id >> 32 ) ) % s_assetShardCount ];
+}
+
+std::shared_ptr< AssetManager::AssetEntry > AssetManager::findEntry( const Asset::Id id )
+{
+    AssetShard& shard = getShard( id );
+
+    std::lock_guard<std::mutex> lock( shard.mutex );
+
+    const auto it = shard.entries.find( id );
+
+    return it != shard.entries.end() ? it->second : nullptr;
+}
+
+std::shared_ptr< AssetManager::AssetEntry > AssetManager::getOrCreateEntry( const Asset::Id id, bool& created, unsigned int& generation, const unsigned int* requiredGeneration )
 {
-    return "(" + Asset::toString(type) + ") " + StringUtil::toLowercase( path ) + " [" + std::to_string( indexInFile ) + "]";
+    AssetShard& shard = getShard( id );
+
+    std::lock_guard<std::mutex> lock( shard.mutex );
+
+    generation = m_generation;
+
+    if ( requiredGeneration && *requiredGeneration != generation ) {
+        created = false;
+        return nullptr;
+    }
+
+    std::shared_ptr< AssetEntry >& entry = shard.entries[ id ];
+
+    created = ( entry == nullptr );
+    if ( created )
+        entry = std::make_shared< AssetEntry >();
+
+    return entry;
+}
+
+bool AssetManager::isStale( const LoadRequest& request ) const
+{
+    return request.entry->cancelled || request.generation != m_generation;
+}
+
+void AssetManager::beginInFlight()
+{
+    std::lock_guard<std::mutex> lock( m_inFlightMutex );
+    ++m_inFlightCount;
+}
+
+void AssetManager::endInFlight()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_inFlightMutex );
+        --m_inFlightCount;
+    }
+
+    m_inFlightFinished.notify_all();
+}
+
+void AssetManager::finishLoading( const Asset::Id id, const std::shared_ptr< AssetEntry >& entry, const std::shared_ptr<Asset>& asset )
+{
+    {
+        AssetShard& shard = getShard( id );
+
+        std::lock_guard<std::mutex> lock( shard.mutex );
+
+        // Asset was cancelled or unloaded while it was loading (and possibly queued for loading again since then).
+        const auto it = shard.entries.find( id );
+        if ( it == shard.entries.end() || it->second != entry )
+            return;
+
+        if ( asset ) {
+            entry->asset  = asset;
+            entry->loaded = true;
+
+            // Note: Entry is in the shard, so it belongs to the current generation (see unloadAll).
+            shard.markLoaded( id, m_generation );
+        } else {
+            shard.entries.erase( it );
+        }
+    }
+
+    if ( asset )
+        registerLoadedAsset( id, *asset );
+
+    // Note: Waiting threads are woken up outside of the lock.
+    entry->finish( asset );
+}
+
+void AssetManager::registerLoadedAsset( const Asset::Id id, const Asset& asset )
+{
+    if ( !m_hotReloadEnabled )
+        return;
+
+    // Only files of assets which can be reloaded are watched (see reloadAsset).
+    if ( !asset.getFileInfo().canHaveSubAssets() && !asset.getFileInfo().getPath().empty() )
+        m_fileWatcher.addFile( asset.getFileInfo().getPath() );
+
+    const std::string path = AssetArchive::normalizePath( asset.getFileInfo().getPath() );
+
+    const std::vector< std::shared_ptr< const Asset > > subAssets = asset.getSubAssets();
+
+    std::lock_guard<std::mutex> lock( m_dependenciesMutex );
+
+    m_assetIdsByPath[ path ].push_back( id );
+
+    for ( const auto& subAsset : subAssets ) 
+    {
+        if ( subAsset && !subAsset->getFileInfo().getPath().empty() )
+            m_parentAssetIds[ subAsset->getFileInfo().getAssetId() ].push_back( id );
+    }
+}
+
+void AssetManager::reloadChangedAssets()
+{
+    const std::chrono::milliseconds checkInterval( 100 );
+
+    for ( ;; ) 
+    {
+        { // Wait for some time or until the thread is stopped.
+            std::unique_lock<std::mutex> lock( m_reloadingMutex );
+
+            if ( m_reloadingThreadStop.wait_for( lock, checkInterval, [ this ]() { return !m_executeReloadingThread; } ) )
+                return;
+        }
+
+        // Note: The cost depends only on the number of changed files - unchanged assets are not touched.
+        for ( const std::string& path : m_fileWatcher.getChangedFiles() ) 
+        {
+            std::vector< Asset::Id > ids;
+            {
+                std::lock_guard<std::mutex> lock( m_dependenciesMutex );
+
+                const auto it = m_assetIdsByPath.find( AssetArchive::normalizePath( path ) );
+                if ( it != m_assetIdsByPath.end() )
+                    ids = it->second;
+            }
+
+            for ( const Asset::Id id : ids )
+                reloadAsset( id );
+        }
+    }
+}
+
+void AssetManager::reloadAsset( const Asset::Id id )
+{
+    const std::shared_ptr<Asset> oldAsset = get( id );
+    if ( !oldAsset )
+        return;
+
+    const std::shared_ptr<FileInfo> fileInfo = oldAsset->getFileInfo().clone();
+
+    // #TODO: Reloading assets with sub-assets (models) would require swapping them in actors.
+    if ( fileInfo->canHaveSubAssets() )
+    {
+        OutputDebugStringW( StringUtil::widen( "AssetManager::reloadAsset - reloading \"" + fileInfo->getPath() + "\" is not supported - skipped.\n" ).c_str() );
+        return;
+    }
+
+    try 
+    {
+        // Note: Always read from disk - files from the mounted archive can't change.
+        std::shared_ptr<Asset> newAsset = createFromFile( *fileInfo );
+
+        // Load to GPU if the old version was there.
+        if ( fileInfo->getAssetType() == Asset::Type::BlockMesh ) 
+        {
+            const auto oldMesh = std::static_pointer_cast<BlockMesh>( oldAsset );
+            const auto newMesh = std::static_pointer_cast<BlockMesh>( newAsset );
+
+            if ( oldMesh->isInGpuMemory() )
+                newMesh->loadCpuToGpu( *m_device.Get() );
+
+            if ( oldMesh->getBvhTree() ) 
+            {
+                if ( !newMesh->getBvhTree() )
+                    newMesh->buildBvhTree();
+
+                if ( oldMesh->isInGpuMemory() )
+                    newMesh->loadBvhTreeToGpu( *m_device.Get() );
+            }
+        } 
+        else if ( fileInfo->getAssetType() == Asset::Type::SkeletonMesh ) 
+        {
+            if ( std::static_pointer_cast<SkeletonMesh>( oldAsset )->isInGpuMemory() )
+                std::static_pointer_cast<SkeletonMesh>( newAsset )->loadCpuToGpu( *m_device.Get() );
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( m_reloadedAssetsMutex );
+            m_reloadedAssets.push_back( std::make_pair( id, newAsset ) );
+        }
+
+        OutputDebugStringW( StringUtil::widen( "AssetManager::reloadAsset - reloaded \"" + fileInfo->getPath() + "\" [" + std::to_string( fileInfo->getIndexInFile() ) + "]\n" ).c_str() );
+    } 
+    catch ( std::exception& ex ) 
+    {
+        // Keep the old version of the asset.
+        OutputDebugStringW( StringUtil::widen( 
+            "AssetManager::reloadAsset - failed to reload \"" 
+            + fileInfo->getPath() + "\" [" 
+            + std::to_string( fileInfo->getIndexInFile() ) + "]\nException: " 
+            + ex.what() + ".\n"
+        ).c_str() );
+    }
 }
\ No newline at end of file
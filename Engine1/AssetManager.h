@@ -3,23 +3,33 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
-#include <unordered_set>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
+#include <future>
+#include <atomic>
 #include <wrl.h>
 
 #include "Asset.h"
 #include "FileInfo.h"
+#include "AssetLoadStats.h"
+#include "FileWatcher.h"
 
 struct ID3D11Device3;
 
 namespace Engine1
 {
+    class AssetArchive;
+    template< typename > class Texture2D;
+
     class AssetManager
     {
 
         public:
+
+        // Becomes ready when the asset finishes loading. Holds the loaded asset or nullptr if the asset failed to load.
+        typedef std::shared_future< std::shared_ptr<Asset> > AssetFuture;
+
         AssetManager();
         ~AssetManager();
 
@@ -28,77 +38,246 @@ namespace Engine1
         // Thus we need other threads to parse basic assets at all times.
         void initialize( int parsingBasicAssetsThreadCount, int parsingComplexAssetsThreadCount, Microsoft::WRL::ComPtr< ID3D11Device3 > device );
 
+        // Files found in the mounted archive are read from it instead of from separate files on disk.
+        void mountArchive( const std::string& path );
+        void unmountArchive();
+
         void                   load( const FileInfo& fileInfo );
-        void                   loadAsync( const FileInfo& fileInfo, const bool highestPriority = false );
+        // highestPriority - the asset is put at the front of the queue. If it's queued already, its request is moved to the front.
+        AssetFuture            loadAsync( const FileInfo& fileInfo, const bool highestPriority = false );
         bool                   isLoaded( Asset::Type type, std::string path, const int indexInFile = 0 );
         bool                   isLoadedOrLoading( Asset::Type type, std::string path, const int indexInFile = 0 );
         std::shared_ptr<Asset> get( Asset::Type type, std::string path, const int indexInFile = 0 );
         std::shared_ptr<Asset> getOrLoad( const FileInfo& fileInfo );
         std::shared_ptr<Asset> getWhenLoaded( Asset::Type type, std::string path, const int indexInFile = 0, const float timeout = 10.0f );
 
+        // Faster versions - don't touch any strings. Asset id can be taken from FileInfo::getAssetId().
+        bool                   isLoaded( const Asset::Id assetId );
+        bool                   isLoadedOrLoading( const Asset::Id assetId );
+        std::shared_ptr<Asset> get( const Asset::Id assetId );
+        std::shared_ptr<Asset> getWhenLoaded( const Asset::Id assetId, const float timeout = 10.0f );
+
+        // Stops loading the asset if it's still waiting in a queue or being read/parsed. Threads waiting for it get nullptr.
+        // Work which hasn't started yet is dropped without reading the file. Loaded assets are not affected.
+        // Returns false if the asset is not loading.
+        bool cancel( const Asset::Id assetId );
+
+        // Drops all queued assets and waits for the assets being read or parsed at the moment - their results are discarded.
         void unloadAll();
 
+        // Watches the directory and re-parses loaded assets whose files have changed on a background thread.
+        // Only assets without sub-assets (meshes, textures) and loaded after hot-reload was enabled are reloaded.
+        void enableHotReload( const std::string& directory );
+        void disableHotReload();
+
+        // Should be called after the application itself saved the file, so the asset isn't reloaded needlessly. Can be called from any thread.
+        void ignoreFileChange( const std::string& path );
+
+        // Swaps reloaded assets into the assets using them (through Asset::swapSubAsset). Unchanged assets are not touched.
+        // Has to be called from the rendering thread (ex: once per frame), as it modifies assets used for rendering.
+        // Returns the number of swapped assets.
+        int swapReloadedAssets();
+
+        // Timings of all loaded assets and the state of the loading pipeline over time.
+        AssetLoadStats&       getLoadStats();
+        const AssetLoadStats& getLoadStats() const;
+
         private:
 
         Microsoft::WRL::ComPtr< ID3D11Device3 > m_device;
 
+        AssetLoadStats m_loadStats;
+
         bool m_executeThreads;
 
         void readAssetsFromDisk();
         void parseBasicAssets();
         void parseComplexAssets();
 
+        // Reads the file from the mounted archive (if it contains the file) or from disk.
+        std::shared_ptr< std::vector<char> > readFile( const FileInfo& fileInfo );
+
+        // Large files in own formats are parsed while being read on a parsing thread instead of being loaded to memory first.
+        bool shouldParseFromFile( const FileInfo& fileInfo );
+
+        static const long long s_parseFromFileMinSize;
+
         std::shared_ptr<Asset> createFromFile( const FileInfo& fileInfo );
         std::shared_ptr<Asset> createFromMemory( const FileInfo& fileInfo, const std::vector<char>& fileData );
 
-        std::string getId( Asset::Type type, const std::string path, const int indexInFile );
+        // Textures are decoded first and then created on GPU, so upload time is recorded separately from parsing.
+        template< typename PixelType >
+        void loadTextureToGpu( Texture2D< PixelType >& texture, const FileInfo& fileInfo );
+
+        // State of an asset, which is in the course of loading or was loaded already.
+        struct AssetEntry
+        {
+            std::promise< std::shared_ptr<Asset> > promise;
+            AssetFuture                            future;
+            std::atomic< bool >                    finished;
+            std::atomic< bool >                    loaded;    // Set together with the asset (see finishLoading) - before the future becomes ready.
+            std::atomic< bool >                    cancelled; // Checked by the worker threads before reading and parsing.
+            std::shared_ptr<Asset>                 asset;     // Latest version of the asset - may differ from the future after hot-reload. Guarded by the shard lock.
+
+            AssetEntry() :
+                future( promise.get_future().share() ),
+                finished( false ),
+                loaded( false ),
+                cancelled( false )
+            {}
+
+            // Wakes up only the threads waiting for this asset. Only the first call has any effect.
+            // Note: Doesn't touch 'asset' and 'loaded' - they are set with the shard lock held (see finishLoading).
+            void finish( const std::shared_ptr<Asset>& asset )
+            {
+                if ( finished.exchange( true ) )
+                    return;
+
+                promise.set_value( asset );
+            }
+        };
+
+        std::shared_ptr< AssetEntry > findEntry( const Asset::Id id );
+
+        // Also returns the current generation - read under the shard lock after the entry exists. unloadAll changes the generation
+        // while holding all the shard locks, so the entry belongs to that generation. If 'requiredGeneration' is given
+        // and differs from the current one, no entry is created and nullptr is returned.
+        std::shared_ptr< AssetEntry > getOrCreateEntry( const Asset::Id id, bool& created, unsigned int& generation, const unsigned int* requiredGeneration = nullptr );
+
+        // Publishes the loaded asset to the threads waiting for it. Failed assets (nullptr) are removed, so they can be loaded again later.
+        // Does nothing if the entry was cancelled or unloaded in the meantime (even if the asset is being loaded again).
+        void finishLoading( const Asset::Id id, const std::shared_ptr< AssetEntry >& entry, const std::shared_ptr<Asset>& asset );
+
+        std::mutex                            m_archiveMutex;
+        std::shared_ptr< const AssetArchive > m_archive;
 
         std::thread              m_readingFromDiskThread;
         std::vector<std::thread> m_parsingBasicAssetsThreads;
         std::vector<std::thread> m_parsingComplexAssetsThreads;
 
-        // List of all assets which are in the course of loading or were loaded already.
-        std::mutex                      m_assetsMutex;
-        std::unordered_set<std::string> m_assets;
+        // Ids of loaded assets together with the generation in which they were loaded. Allows isLoaded to run without locking.
+        // Open addressing with linear probing. Slots are never removed - unloadAll invalidates them by changing the generation.
+        // Only written with the shard lock held. When half full, it's replaced with a copy twice as large - replaced tables
+        // are kept until the shard is destroyed, as other threads may still be reading them.
+        struct LoadedIdTable
+        {
+            LoadedIdTable( const size_t capacity );
 
-        std::mutex                                     m_assetsToReadFromDiskMutex;
-        std::condition_variable                        m_assetsToReadFromDiskNotEmpty;
-        std::list< std::shared_ptr< const FileInfo > > m_basicAssetsToReadFromDisk;
-        std::list< std::shared_ptr< const FileInfo > > m_complexAssetsToReadFromDisk;
+            // Returns false if the id was never loaded.
+            bool find( const Asset::Id id, unsigned int& generation ) const;
+            // Returns false if the id is new and there is no free slot left for it.
+            bool insert( const Asset::Id id, const unsigned int generation );
+
+            size_t getSlotIndex( const Asset::Id id ) const;
+
+            std::unique_ptr< std::atomic< Asset::Id >[] >    ids;         // 0 - empty slot (asset ids are never 0).
+            std::unique_ptr< std::atomic< unsigned int >[] > generations;
+            const size_t                                     capacity;    // Power of two.
+            size_t                                           usedCount;
+        };
 
-        struct AssetToParse
+        // All assets which are in the course of loading or were loaded already.
+        // Split into shards, each with its own lock, so threads accessing different assets rarely block each other.
+        struct AssetShard
         {
-            std::shared_ptr< const FileInfo > fileInfo;
-            std::shared_ptr< std::vector<char> > fileData;
+            AssetShard();
 
-            AssetToParse() :
+            std::mutex                                                    mutex;
+            std::unordered_map< Asset::Id, std::shared_ptr< AssetEntry > > entries;
+
+            std::atomic< const LoadedIdTable* >            loadedIds;       // Latest table.
+            std::vector< std::unique_ptr< LoadedIdTable > > loadedIdTables; // All tables, including the replaced ones.
+
+            // Note: Has to be called with the shard lock held.
+            void markLoaded( const Asset::Id id, const unsigned int generation );
+        };
+
+        static const size_t s_loadedIdTableMinCapacity;
+
+        static const int s_assetShardCount = 64;
+
+        AssetShard& getShard( const Asset::Id id );
+
+        AssetShard m_assetShards[ s_assetShardCount ];
+
+        // Remembers which file each loaded asset came from and which assets use it as a sub-asset. Used for hot-reload.
+        void registerLoadedAsset( const Asset::Id id, const Asset& asset );
+
+        void reloadChangedAssets();
+        void reloadAsset( const Asset::Id id );
+
+        std::mutex                                                     m_dependenciesMutex;
+        std::unordered_map< std::string, std::vector< Asset::Id > >    m_assetIdsByPath;  // Key - normalized path.
+        std::unordered_map< Asset::Id, std::vector< Asset::Id > >      m_parentAssetIds;  // Key - sub-asset id.
+
+        FileWatcher             m_fileWatcher;
+        std::atomic< bool >     m_hotReloadEnabled;
+        std::thread             m_reloadingThread;
+        bool                    m_executeReloadingThread;
+        std::mutex              m_reloadingMutex;
+        std::condition_variable m_reloadingThreadStop;
+
+        std::mutex                                                    m_reloadedAssetsMutex;
+        std::vector< std::pair< Asset::Id, std::shared_ptr<Asset> > > m_reloadedAssets;
+
+        // Asset waiting to be read or parsed. Request is stale if its entry was cancelled or all assets were unloaded since it was queued.
+        struct LoadRequest
+        {
+            std::shared_ptr< const FileInfo >    fileInfo;
+            std::shared_ptr< AssetEntry >        entry;
+            unsigned int                         generation;
+            std::shared_ptr< std::vector<char> > fileData; // Empty until the file is read.
+
+            LoadRequest() :
                 fileInfo( nullptr ),
+                entry( nullptr ),
+                generation( 0 ),
                 fileData( nullptr )
             {}
 
-            AssetToParse( std::shared_ptr< const FileInfo > fileInfo, std::shared_ptr< std::vector<char> > fileData ) :
+            LoadRequest( std::shared_ptr< const FileInfo > fileInfo, std::shared_ptr< AssetEntry > entry, const unsigned int generation ) :
                 fileInfo( fileInfo ),
-                fileData( fileData )
-            {}
-
-            AssetToParse( const AssetToParse& other ) :
-                fileInfo( other.fileInfo ),
-                fileData( other.fileData )
+                entry( entry ),
+                generation( generation ),
+                fileData( nullptr )
             {}
         };
 
+        bool isStale( const LoadRequest& request ) const;
+
+        // Loads sub-assets as part of the generation of their parent's request. If all assets were unloaded since then,
+        // nothing is queued (so the sub-asset doesn't leak into the next scene) and the returned future holds nullptr.
+        AssetFuture loadAsync( const FileInfo& fileInfo, const bool highestPriority, const unsigned int generation );
+
+        void queueRequest( const LoadRequest& request, const bool highestPriority );
+
+        // Moves the asset's request to the front of its queue if it's still waiting to be read or parsed.
+        // Used when an asset already queued with a lower priority is requested with the highest priority (ex: as a sub-asset).
+        void prioritizeRequest( const FileInfo& fileInfo, const std::shared_ptr< AssetEntry >& entry );
+
+        // Incremented by unloadAll - results of requests from older generations are discarded.
+        std::atomic< unsigned int > m_generation;
+
+        // Number of requests taken from the queues, which are being read or parsed.
+        // Incremented while still holding the queue lock, so unloadAll can't miss a request which was just taken from a queue.
+        std::mutex              m_inFlightMutex;
+        std::condition_variable m_inFlightFinished;
+        int                     m_inFlightCount;
+
+        void beginInFlight();
+        void endInFlight();
+
+        std::mutex                m_assetsToReadFromDiskMutex;
+        std::condition_variable   m_assetsToReadFromDiskNotEmpty;
+        std::list< LoadRequest >  m_basicAssetsToReadFromDisk;
+        std::list< LoadRequest >  m_complexAssetsToReadFromDisk;
+
         std::mutex               m_basicAssetsToParseMutex;
         std::mutex               m_complexAssetsToParseMutex;
         std::condition_variable  m_basicAssetsToParseNotEmpty;
         std::condition_variable  m_complexAssetsToParseNotEmpty;
-        std::list< AssetToParse > m_basicAssetsToParse;
-        std::list< AssetToParse > m_complexAssetsToParse;
-
-        std::mutex                                                m_loadedAssetsMutex;
-        std::unordered_map< std::string, std::shared_ptr<Asset> > m_loadedAssets;
-
-        // Used to notify 'getWhenLoaded' method that a new asset has just finished loading.
-        std::condition_variable m_assetLoadedOrError;
+        std::list< LoadRequest > m_basicAssetsToParse;
+        std::list< LoadRequest > m_complexAssetsToParse;
     };
 }
 
@@ -1,18 +1,37 @@
 #include "AssetPathManager.h"
 
+#include "AssetArchive.h"
+#include "FileSystem.h"
+#include "Settings.h"
+
 using namespace Engine1;
 
-PathManager AssetPathManager::s_assetPathManager;
-bool AssetPathManager::s_initialized = initialize();
+const std::string AssetPathManager::s_cachePath = "Assets.pathcache";
+
+std::once_flag    AssetPathManager::s_initializeFlag;
+std::future<void> AssetPathManager::s_initializeFuture;
+PathManager       AssetPathManager::s_assetPathManager;
+
+void AssetPathManager::initializeAsync()
+{
+    // Note: Errors are not reported here - get() scans again on the calling thread and throws.
+    s_initializeFuture = std::async( std::launch::async, []() { std::call_once( s_initializeFlag, &AssetPathManager::initialize ); } );
+}
 
-bool AssetPathManager::initialize()
+void AssetPathManager::initialize()
 {
-    s_assetPathManager.scanDirectory( "Assets" );
+    const Settings::Paths& paths = Settings::get().paths;
 
-    return true;
+    // Use the archive index if the assets are packed - avoids walking the whole directory.
+    if ( !paths.assetsArchive.empty() && FileSystem::exists( paths.assetsArchive ) )
+        s_assetPathManager.scanArchive( AssetArchive( paths.assetsArchive ) );
+    else
+        s_assetPathManager.scanDirectory( paths.assets, s_cachePath );
 }
 
 PathManager& AssetPathManager::get()
 {
+    std::call_once( s_initializeFlag, &AssetPathManager::initialize );
+
     return s_assetPathManager;
 }
\ No newline at end of file
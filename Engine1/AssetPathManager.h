@@ -1,5 +1,8 @@
 #pragma once
 
+#include <mutex>
+#include <future>
+
 #include "PathManager.h"
 
 namespace Engine1
@@ -8,13 +11,20 @@ namespace Engine1
     {
         public:
 
+        // Starts scanning the assets on a background thread, so it doesn't block other initialization.
+        static void initializeAsync();
+
+        // Waits for the scan started by initializeAsync or scans the assets on the calling thread on first use.
         static PathManager& get();
 
         private:
 
-        static bool initialize();
+        static void initialize();
+
+        static const std::string s_cachePath;
 
-        static bool        s_initialized;
-        static PathManager s_assetPathManager;
+        static std::once_flag     s_initializeFlag;
+        static std::future<void>  s_initializeFuture;
+        static PathManager        s_assetPathManager;
     };
-}
\ No newline at end of file
+}
@@ -1,11 +1,15 @@
 #include "BVHTree.h"
 
 #include "BlockMesh.h"
+#include "ParallelUtil.h"
 
 #include <algorithm>
+#include <future>
 
 using namespace Engine1;
 
+const size_t BVHTree::s_parallelBuildMinTriangleCount = 16 * 1024;
+
 BVHTree::BVHTree( const BlockMesh& mesh )
 {
     m_rootNode = build( mesh );
@@ -100,6 +104,20 @@ std::unique_ptr< BVHNode > BVHTree::recursiveBuild( std::vector< TriangleBoundin
     unsigned int bestSplitLeftTriangleCount  = 0;
     unsigned int bestSplitRightTriangleCount = 0;
 
+    struct SplitCandidate
+    {
+        int          axis;
+        float        pos;
+        float        cost;
+        unsigned int leftTriangleCount;
+        unsigned int rightTriangleCount;
+    };
+
+    std::vector< SplitCandidate > splitCandidates;
+
+    // Large nodes near the root are processed using many threads. Deeper nodes are processed in parallel with each other instead.
+    const bool buildInParallel = triangles.size() >= s_parallelBuildMinTriangleCount && depth < 16 && ( 1 << depth ) < ParallelUtil::getThreadCount();
+
     // Try to split along axises X, Y, Z and check which gives minimal cost.
 	for (int axis = 0; axis < 3; axis++) {  
 
@@ -118,59 +136,80 @@ std::unique_ptr< BVHNode > BVHTree::recursiveBuild( std::vector< TriangleBoundin
 		const float minPosStep = 0.01f; // Note: Min step is 1 cm.
 		const float splitPosStep = std::max( minPosStep, (splitPosStop - splitPosStart) / (1024.0f / (depth + 1.0f)) );
 
-		// Try to split on different positions and check which gives minimal cost.
-		for ( float testSplitPos = splitPosStart + splitPosStep; testSplitPos < splitPosStop - splitPosStep; testSplitPos += splitPosStep ) {
-
-			// Create left and right bounding box
-			float3 leftMin(  FLT_MAX,  FLT_MAX,  FLT_MAX );
-			float3 leftMax( -FLT_MAX, -FLT_MAX, -FLT_MAX );
-
-			float3 rightMin(  FLT_MAX,  FLT_MAX,  FLT_MAX );
-			float3 rightMax( -FLT_MAX, -FLT_MAX, -FLT_MAX );
-
-			unsigned int leftTriangleCount = 0, rightTriangleCount = 0;
-
-			// Count triangles in the left and right bounding boxes and calculate their extents.
-            // Needed to calculate SAH cost after split.
-			for ( TriangleBoundingBox& triangle : triangles ) {
-
-				// Triangle bounding box center position along split axis.
-				const float triangleCenterPos = triangle.boundingBox.getCenter().getData()[ axis ];
+		// Collect split positions to be tested.
+		for ( float testSplitPos = splitPosStart + splitPosStep; testSplitPos < splitPosStop - splitPosStep; testSplitPos += splitPosStep )
+            splitCandidates.push_back( { axis, testSplitPos, FLT_MAX, 0, 0 } );
+	}
 
-				if ( triangleCenterPos < testSplitPos ) {
-					leftMin = min( leftMin, triangle.boundingBox.getMin() );
-					leftMax = max( leftMax, triangle.boundingBox.getMax() );
-					++leftTriangleCount;
-				} else {
-					rightMin = min( rightMin, triangle.boundingBox.getMin() );
-					rightMax = max( rightMax, triangle.boundingBox.getMax() );
-					++rightTriangleCount;
-				}
+    // Try to split on different positions and calculate their costs. 
+    const auto evaluateSplitCandidate = [ &triangles ]( SplitCandidate& candidate ) 
+    {
+		// Create left and right bounding box
+		float3 leftMin(  FLT_MAX,  FLT_MAX,  FLT_MAX );
+		float3 leftMax( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+
+		float3 rightMin(  FLT_MAX,  FLT_MAX,  FLT_MAX );
+		float3 rightMax( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+
+		unsigned int leftTriangleCount = 0, rightTriangleCount = 0;
+
+		// Count triangles in the left and right bounding boxes and calculate their extents.
+        // Needed to calculate SAH cost after split.
+		for ( TriangleBoundingBox& triangle : triangles ) {
+
+			// Triangle bounding box center position along split axis.
+			const float triangleCenterPos = triangle.boundingBox.getCenter().getData()[ candidate.axis ];
+
+			if ( triangleCenterPos < candidate.pos ) {
+				leftMin = min( leftMin, triangle.boundingBox.getMin() );
+				leftMax = max( leftMax, triangle.boundingBox.getMax() );
+				++leftTriangleCount;
+			} else {
+				rightMin = min( rightMin, triangle.boundingBox.getMin() );
+				rightMax = max( rightMax, triangle.boundingBox.getMax() );
+				++rightTriangleCount;
 			}
+		}
 
-			// Now use the Surface Area Heuristic to see if this split has a better "cost".
+		// Now use the Surface Area Heuristic to see if this split has a better "cost".
 
-			// First, check if split is reasonable - bins with 0 or 1 triangles make no sense.
-			if ( leftTriangleCount <= 1 || rightTriangleCount <= 1 ) 
-                continue;
+		// First, check if split is reasonable - bins with 0 or 1 triangles make no sense.
+		if ( leftTriangleCount <= 1 || rightTriangleCount <= 1 ) 
+            return;
 
-			// Split is reasonable - calculate SAH cost.
-			const float3 leftSides  = leftMax - leftMin;
-			const float3 rightSides = rightMax - rightMin;
+		// Split is reasonable - calculate SAH cost.
+		const float3 leftSides  = leftMax - leftMin;
+		const float3 rightSides = rightMax - rightMin;
 
-			const float surfaceLeft  = leftSides.x*leftSides.y   + leftSides.y*leftSides.z   + leftSides.z*leftSides.x;
-			const float surfaceRight = rightSides.x*rightSides.y + rightSides.y*rightSides.z + rightSides.z*rightSides.x;
+		const float surfaceLeft  = leftSides.x*leftSides.y   + leftSides.y*leftSides.z   + leftSides.z*leftSides.x;
+		const float surfaceRight = rightSides.x*rightSides.y + rightSides.y*rightSides.z + rightSides.z*rightSides.x;
 
-			const float newCost = surfaceLeft*leftTriangleCount + surfaceRight*rightTriangleCount;
+		candidate.cost               = surfaceLeft*leftTriangleCount + surfaceRight*rightTriangleCount;
+        candidate.leftTriangleCount  = leftTriangleCount;
+        candidate.rightTriangleCount = rightTriangleCount;
+    };
 
-			// Keep track of cheapest split found so far.
-			if ( newCost < minCost ) {
-				minCost                     = newCost;
-				bestSplitPos                = testSplitPos;
-				bestSplitAxis               = axis;
-                bestSplitLeftTriangleCount  = leftTriangleCount;
-                bestSplitRightTriangleCount = rightTriangleCount;
-			}
+    // Each candidate goes through all the triangles, so for large nodes candidates are tested in parallel.
+    if ( buildInParallel ) 
+    {
+        ParallelUtil::parallelFor( (int)splitCandidates.size(), [ & ]( const int candidateIdx ) {
+            evaluateSplitCandidate( splitCandidates[ candidateIdx ] );
+        } );
+    } 
+    else 
+    {
+        for ( SplitCandidate& candidate : splitCandidates )
+            evaluateSplitCandidate( candidate );
+    }
+
+	// Keep track of cheapest split found so far (in the order of testing, so the result doesn't depend on threading).
+    for ( const SplitCandidate& candidate : splitCandidates ) {
+		if ( candidate.cost < minCost ) {
+			minCost                     = candidate.cost;
+			bestSplitPos                = candidate.pos;
+			bestSplitAxis               = candidate.axis;
+            bestSplitLeftTriangleCount  = candidate.leftTriangleCount;
+            bestSplitRightTriangleCount = candidate.rightTriangleCount;
 		}
 	}
 
@@ -217,13 +256,21 @@ std::unique_ptr< BVHNode > BVHTree::recursiveBuild( std::vector< TriangleBoundin
     // Create inner node.
 	std::unique_ptr< BVHInnerNode > innerNode = std::make_unique< BVHInnerNode >();
 
-	// Recursively build the left child.
-	innerNode->m_leftChild = recursiveBuild( leftTriangles, depth + 1);
-	innerNode->m_leftChild->m_min = leftMin;
-	innerNode->m_leftChild->m_max = leftMax;
+	// Recursively build the left child - on another thread for large nodes.
+    std::future< std::unique_ptr< BVHNode > > leftChildFuture;
+    if ( buildInParallel )
+        leftChildFuture = std::async( std::launch::async, [ this, &leftTriangles, depth ]() { return recursiveBuild( leftTriangles, depth + 1 ); } );
+    else
+        innerNode->m_leftChild = recursiveBuild( leftTriangles, depth + 1);
 
 	// Recursively build the right child.
 	innerNode->m_rightChild = recursiveBuild( rightTriangles, depth + 1);
+
+    if ( leftChildFuture.valid() )
+        innerNode->m_leftChild = leftChildFuture.get();
+
+	innerNode->m_leftChild->m_min = leftMin;
+	innerNode->m_leftChild->m_max = leftMax;
 	innerNode->m_rightChild->m_min = rightMin;
 	innerNode->m_rightChild->m_max = rightMax;
 
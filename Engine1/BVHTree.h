@@ -28,6 +28,9 @@ namespace Engine1
 
         private:
 
+        // Nodes (close to the root) with at least that many triangles test split candidates in parallel and build their children on separate threads.
+        static const size_t s_parallelBuildMinTriangleCount;
+
         std::unique_ptr< BVHNode > m_rootNode;
 
         std::unique_ptr< BVHNode > build( const BlockMesh& mesh );
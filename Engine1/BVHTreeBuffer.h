@@ -14,6 +14,7 @@ namespace Engine1
     class BVHTreeBuffer
     {
         friend class BVHTreeBufferParser;
+        friend class MeshFileParser;
 
         public:
 
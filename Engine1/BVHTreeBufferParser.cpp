@@ -1,6 +1,8 @@
 #include "BVHTreeBufferParser.h"
 
 #include "BVHTreeBuffer.h"
+#include "BinaryFileReader.h"
+#include "BinaryFileWriter.h"
 
 using namespace Engine1;
 
@@ -12,91 +14,55 @@ BVHTreeBufferParser::~BVHTreeBufferParser()
 
 std::shared_ptr< BVHTreeBuffer > BVHTreeBufferParser::parseBVHTreeFile( std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt )
 {
-    std::shared_ptr< BVHTreeBuffer > bvhTree = std::make_shared< BVHTreeBuffer >();
-
-    const int dataSize = (int)( dataEndIt - dataIt ) / sizeof( char );
-
-    std::vector<char>::const_iterator dataCurrIt = dataIt;
-
-    // Read nodes count.
-    int nodesCount = 0;
-    std::memcpy( &nodesCount, &( *dataCurrIt ), sizeof( int ) );
-    dataCurrIt += sizeof( int );
+    BinaryFileReader reader( dataIt, dataEndIt );
 
-    // Read nodes.
-    bvhTree->m_bvhNodes.resize( nodesCount );
-    const int nodesDataSize = nodesCount * sizeof( BVHTreeBuffer::Node );
-    std::memcpy( bvhTree->m_bvhNodes.data(), &( *dataCurrIt ), nodesDataSize );
-    dataCurrIt += nodesDataSize;
+    return parseBVHTreeFile( reader );
+}
 
-    // Read nodes' extents.
-    bvhTree->m_bvhNodesExtents.resize( nodesCount );
-    const int nodesExtentsDataSize = nodesCount * sizeof( BVHTreeBuffer::NodeExtents );
-    std::memcpy( bvhTree->m_bvhNodesExtents.data(), &( *dataCurrIt ), nodesExtentsDataSize );
-    dataCurrIt += nodesExtentsDataSize;
+std::shared_ptr< BVHTreeBuffer > BVHTreeBufferParser::parseBVHTreeFile( BinaryFileReader& reader )
+{
+    std::shared_ptr< BVHTreeBuffer > bvhTree = std::make_shared< BVHTreeBuffer >();
 
-    // Read triangle count.
-    int triangleCount = 0;
-    std::memcpy( &triangleCount, &( *dataCurrIt ), sizeof( int ) );
-    dataCurrIt += sizeof( int );
+    // Read nodes and their extents.
+    const int nodesCount = reader.read< int >();
+    reader.readArray( bvhTree->m_bvhNodes, nodesCount );
+    reader.readArray( bvhTree->m_bvhNodesExtents, nodesCount );
 
     // Read triangles.
-    bvhTree->m_triangles.resize( triangleCount );
-    if ( triangleCount > 0 )
-    {
-        const int trianglesDataSize = triangleCount * sizeof( unsigned int );
-        std::memcpy( bvhTree->m_triangles.data(), &( *dataCurrIt ), trianglesDataSize );
-        dataCurrIt += trianglesDataSize;
-    }
+    const int triangleCount = reader.read< int >();
+    reader.readArray( bvhTree->m_triangles, triangleCount );
 
     return bvhTree;
 }
 
 void BVHTreeBufferParser::writeBVHTreeFile( std::vector< char >& data, const BVHTreeBuffer& bvhTree )
 {
-    const int totalSize = getSizeOfBVHTreeFile( bvhTree );
-
-    const int prevDataSize = (int)data.size();
-    data.resize( prevDataSize + totalSize );
-
-    std::vector< char >::iterator dataIt = data.begin() + prevDataSize;
-
-    // Write nodes count.
-    const int nodesCount = (int)bvhTree.getNodes().size();
-    std::memcpy( &( *dataIt ), &nodesCount, sizeof( int ) );
-    dataIt += sizeof( int );
-
-    // Write nodes.
-    const int nodesDataSize = (int)bvhTree.getNodes().size() * sizeof( BVHTreeBuffer::Node );
-    std::memcpy( &( *dataIt ), bvhTree.getNodes().data(), nodesDataSize );
-    dataIt += nodesDataSize;
-
-    // Write nodes' extents.
-    const int nodesExtentsDataSize = (int)bvhTree.getNodesExtents().size() * sizeof( BVHTreeBuffer::NodeExtents );
-    std::memcpy( &( *dataIt ), bvhTree.getNodesExtents().data(), nodesExtentsDataSize );
-    dataIt += nodesExtentsDataSize;
-
-    // Write triangle count.
-    const int trianglesCount = (int)bvhTree.getTriangles().size();
-    std::memcpy( &( *dataIt ), &trianglesCount, sizeof( int ) );
-    dataIt += sizeof( int );
-
-    // Write triangles.
-    if ( !bvhTree.getTriangles().empty() )
-    {
-        const int trianglesDataSize = (int)bvhTree.getTriangles().size() * sizeof( unsigned int );
-        std::memcpy( &( *dataIt ), bvhTree.getTriangles().data(), trianglesDataSize );
-        dataIt += trianglesDataSize;
-    }
+    BinaryFileWriter writer( data );
+
+    writeBVHTreeFile( writer, bvhTree );
+}
+
+void BVHTreeBufferParser::writeBVHTreeFile( BinaryFileWriter& writer, const BVHTreeBuffer& bvhTree )
+{
+    writer.reserve( getSizeOfBVHTreeFile( bvhTree ) );
+
+    // Write nodes count, nodes and their extents.
+    writer.write( (int)bvhTree.getNodes().size() );
+    writer.writeArray( bvhTree.getNodes() );
+    writer.writeArray( bvhTree.getNodesExtents() );
+
+    // Write triangle count and triangles.
+    writer.write( (int)bvhTree.getTriangles().size() );
+    writer.writeArray( bvhTree.getTriangles() );
 }
 
-int BVHTreeBufferParser::getSizeOfBVHTreeFile( const BVHTreeBuffer& bvhTree )
+size_t BVHTreeBufferParser::getSizeOfBVHTreeFile( const BVHTreeBuffer& bvhTree )
 {
-    const int nodesDataSize        = (int)bvhTree.getNodes().size() * sizeof( BVHTreeBuffer::Node );
-    const int nodesExtentsDataSize = (int)bvhTree.getNodesExtents().size() * sizeof( BVHTreeBuffer::NodeExtents );
-    const int trianglesDataSize    = (int)bvhTree.getTriangles().size() * sizeof( unsigned int );
+    const size_t nodesDataSize        = bvhTree.getNodes().size() * sizeof( BVHTreeBuffer::Node );
+    const size_t nodesExtentsDataSize = bvhTree.getNodesExtents().size() * sizeof( BVHTreeBuffer::NodeExtents );
+    const size_t trianglesDataSize    = bvhTree.getTriangles().size() * sizeof( unsigned int );
 
-    int totalSize = 0;
+    size_t totalSize = 0;
     totalSize += 2 * sizeof( int ); // Nodes count, triangles count.
     totalSize += nodesDataSize;
     totalSize += nodesExtentsDataSize;
@@ -6,14 +6,18 @@
 namespace Engine1
 {
     class BVHTreeBuffer;
+    class BinaryFileReader;
+    class BinaryFileWriter;
 
     class BVHTreeBufferParser
     {
         public:
         static std::shared_ptr< BVHTreeBuffer > parseBVHTreeFile( std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt );
+        static std::shared_ptr< BVHTreeBuffer > parseBVHTreeFile( BinaryFileReader& reader );
 
-        static void writeBVHTreeFile( std::vector< char >& data, const BVHTreeBuffer& bvhTree );
-        static int  getSizeOfBVHTreeFile( const BVHTreeBuffer& bvhTree );
+        static void   writeBVHTreeFile( std::vector< char >& data, const BVHTreeBuffer& bvhTree );
+        static void   writeBVHTreeFile( BinaryFileWriter& writer, const BVHTreeBuffer& bvhTree );
+        static size_t getSizeOfBVHTreeFile( const BVHTreeBuffer& bvhTree );
 
         private:
 
@@ -1,6 +1,7 @@
 #include "BinaryFile.h"
 
 #include <fstream>
+#include <algorithm>
 
 #include "FileSystem.h"
 
@@ -22,19 +23,19 @@ std::shared_ptr< std::vector<char> > BinaryFile::load( const std::string& path )
 	if ( !file.is_open() )	
         throw std::exception( "BinaryFile::load - Failed to open file." );
 
-	try {
-		// Check file size.
-		//std::streamoff fileSize = 0;
-		//file.seekg( 0, std::ios::end ); // Move cursor to the end of the file.
-		//fileSize = file.tellg(); // Save cursor position.
+    if ( (unsigned long long)fileSize > (unsigned long long)fileData->max_size() )
+        throw std::exception( "BinaryFile::load - File is too large to be loaded to memory." );
 
-		// Allocate memory for the file (+ zero at the end).
-		fileData->reserve( (size_t)fileSize );
+	try {
+		// Allocate memory for the file.
 		fileData->resize( (size_t)fileSize );
 
-		// Read the file.
+		// Read the file - in chunks, as a single read can't exceed the stream size type on some platforms.
 		file.seekg( 0, std::ios::beg );  // Move cursor to the beginning of the file.
-		file.read( fileData->data(), fileSize );
+
+        const long long maxChunkSize = 1024ll * 1024ll * 1024ll;
+        for ( long long offset = 0; offset < fileSize; offset += maxChunkSize )
+		    file.read( fileData->data() + offset, (std::streamsize)std::min( maxChunkSize, fileSize - offset ) );
 
 		// Close the file.
 		file.close();
@@ -102,6 +103,16 @@ int BinaryFile::readInt( std::vector<char>::const_iterator& dataIt )
 	return value;
 }
 
+long long BinaryFile::readLongLong( std::vector<char>::const_iterator& dataIt )
+{
+	long long value = 0;
+	std::memcpy( &value, &( *dataIt ), sizeof( long long ) );
+
+	dataIt += sizeof( long long ) / sizeof( char );
+
+	return value;
+}
+
 bool BinaryFile::readBool( std::vector<char>::const_iterator& dataIt )
 {
 	bool value = 0;
@@ -180,6 +191,17 @@ void BinaryFile::writeInt( std::vector<char>& file, const int value )
 	std::memcpy( &file[ size ], &value, sizeof( int ) );
 }
 
+void BinaryFile::writeLongLong( std::vector<char>& file, const long long value )
+{
+	const size_t size = file.size();
+
+	const size_t sizeIncrease = sizeof( long long ) / sizeof( char );
+
+	file.resize( size + sizeIncrease );
+
+	std::memcpy( &file[ size ], &value, sizeof( long long ) );
+}
+
 void BinaryFile::writeBool( std::vector<char>& file, const bool value )
 {
 	const size_t size = file.size();
@@ -18,6 +18,7 @@ namespace Engine1
         static std::string readText( std::vector<char>::const_iterator& dataIt, const int size );
         static char        readChar( std::vector<char>::const_iterator& dataIt );
         static int         readInt( std::vector<char>::const_iterator& dataIt );
+        static long long   readLongLong( std::vector<char>::const_iterator& dataIt );
         static bool        readBool( std::vector<char>::const_iterator& dataIt );
         static float       readFloat( std::vector<char>::const_iterator& dataIt );
         static float3      readFloat3( std::vector<char>::const_iterator& dataIt );
@@ -27,6 +28,7 @@ namespace Engine1
         static void writeText( std::vector<char>& data, const std::string& text );
         static void writeChar( std::vector<char>& data, const char value );
         static void writeInt( std::vector<char>& data, const int value );
+        static void writeLongLong( std::vector<char>& data, const long long value );
         static void writeBool( std::vector<char>& data, const bool value );
         static void writeFloat( std::vector<char>& data, const float value );
         static void writeFloat3( std::vector<char>& data, const float3& value );
@@ -0,0 +1,140 @@
+#include "BinaryFileReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "FileSystem.h"
+
+using namespace Engine1;
+
+BinaryFileReader::BinaryFileReader( const std::string& path ) :
+    m_isFile( true ),
+    m_memoryData( nullptr ),
+    m_bufferPosition( 0 ),
+    m_bufferDataSize( 0 ),
+    m_size( (unsigned long long)FileSystem::getFileSize( path ) ),
+    m_position( 0 ),
+    m_filePosition( 0 )
+{
+    m_file.open( path.c_str(), std::ifstream::in | std::ifstream::binary );
+
+    if ( !m_file.is_open() )
+        throw std::exception( "BinaryFileReader::BinaryFileReader - Failed to open file." );
+
+    m_buffer.resize( (size_t)std::min( (unsigned long long)s_bufferSize, m_size ) );
+}
+
+BinaryFileReader::BinaryFileReader( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt ) :
+    m_isFile( false ),
+    m_memoryData( dataIt != dataEndIt ? &( *dataIt ) : nullptr ),
+    m_bufferPosition( 0 ),
+    m_bufferDataSize( 0 ),
+    m_size( (unsigned long long)( dataEndIt - dataIt ) ),
+    m_position( 0 ),
+    m_filePosition( 0 )
+{}
+
+BinaryFileReader::~BinaryFileReader()
+{}
+
+void BinaryFileReader::read( void* destination, const unsigned long long size )
+{
+    if ( size > getRemainingSize() )
+        throw std::exception( "BinaryFileReader::read - unexpected end of data." );
+
+    if ( !m_isFile )
+    {
+        std::memcpy( destination, m_memoryData + m_position, (size_t)size );
+        m_position += size;
+        return;
+    }
+
+    char*              destinationIt = static_cast< char* >( destination );
+    unsigned long long remainingSize = size;
+
+    // Take what's left in the buffer.
+    const size_t sizeFromBuffer = (size_t)std::min( remainingSize, (unsigned long long)( m_bufferDataSize - m_bufferPosition ) );
+    std::memcpy( destinationIt, m_buffer.data() + m_bufferPosition, sizeFromBuffer );
+    m_bufferPosition += sizeFromBuffer;
+    destinationIt    += sizeFromBuffer;
+    remainingSize    -= sizeFromBuffer;
+
+    // Large reads go directly to the destination - in chunks, as a single read can't exceed the stream size type on some platforms.
+    const unsigned long long maxChunkSize = 1024ull * 1024ull * 1024ull;
+    while ( remainingSize >= m_buffer.size() && remainingSize > 0 )
+    {
+        const unsigned long long chunkSize = std::min( remainingSize, maxChunkSize );
+
+        m_file.read( destinationIt, (std::streamsize)chunkSize );
+        if ( !m_file )
+            throw std::exception( "BinaryFileReader::read - Failed to read file." );
+
+        destinationIt  += chunkSize;
+        remainingSize  -= chunkSize;
+        m_filePosition += chunkSize;
+    }
+
+    // Small reads go through the buffer.
+    if ( remainingSize > 0 )
+    {
+        fillBuffer();
+
+        std::memcpy( destinationIt, m_buffer.data(), (size_t)remainingSize );
+        m_bufferPosition = (size_t)remainingSize;
+    }
+
+    m_position += size;
+}
+
+void BinaryFileReader::skip( const unsigned long long size )
+{
+    if ( size > getRemainingSize() )
+        throw std::exception( "BinaryFileReader::skip - unexpected end of data." );
+
+    m_position += size;
+
+    if ( !m_isFile )
+        return;
+
+    const unsigned long long sizeInBuffer = m_bufferDataSize - m_bufferPosition;
+    if ( size <= sizeInBuffer )
+    {
+        m_bufferPosition += (size_t)size;
+    }
+    else
+    {
+        m_file.seekg( (std::streamoff)( size - sizeInBuffer ), std::ios::cur );
+        m_filePosition  += size - sizeInBuffer;
+        m_bufferPosition = 0;
+        m_bufferDataSize = 0;
+    }
+}
+
+unsigned long long BinaryFileReader::getSize() const
+{
+    return m_size;
+}
+
+unsigned long long BinaryFileReader::getPosition() const
+{
+    return m_position;
+}
+
+unsigned long long BinaryFileReader::getRemainingSize() const
+{
+    return m_size - m_position;
+}
+
+void BinaryFileReader::fillBuffer()
+{
+    const size_t readSize = (size_t)std::min( (unsigned long long)m_buffer.size(), m_size - m_filePosition );
+
+    m_file.read( m_buffer.data(), (std::streamsize)readSize );
+    if ( !m_file )
+        throw std::exception( "BinaryFileReader::fillBuffer - Failed to read file." );
+
+    m_filePosition += readSize;
+
+    m_bufferPosition = 0;
+    m_bufferDataSize = readSize;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace Engine1
+{
+    // Reads binary data sequentially - either from a file or from memory.
+    // File is read in chunks through a fixed-size buffer and large reads go directly to the destination,
+    // so the memory used by the reader doesn't depend on the file size (no staging copy of the whole file).
+    class BinaryFileReader
+    {
+        public:
+
+        static const size_t s_bufferSize = 1024 * 1024;
+
+        BinaryFileReader( const std::string& path );
+        BinaryFileReader( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt );
+        ~BinaryFileReader();
+
+        // Throws if there is less data left than requested.
+        void read( void* destination, const unsigned long long size );
+        void skip( const unsigned long long size );
+
+        template< typename T >
+        T read()
+        {
+            T value;
+            read( &value, sizeof( T ) );
+
+            return value;
+        }
+
+        // Replaces the content of the vector with the given number of elements.
+        template< typename T >
+        void readArray( std::vector< T >& values, const int count )
+        {
+            if ( count < 0 )
+                throw std::exception( "BinaryFileReader::readArray - negative element count." );
+
+            values.resize( count );
+
+            if ( count > 0 )
+                read( values.data(), (unsigned long long)count * sizeof( T ) );
+        }
+
+        unsigned long long getSize() const;
+        unsigned long long getPosition() const;
+        unsigned long long getRemainingSize() const;
+
+        private:
+
+        void fillBuffer();
+
+        std::ifstream      m_file;
+        bool               m_isFile;
+        const char*        m_memoryData;
+
+        std::vector< char > m_buffer;
+        size_t              m_bufferPosition;
+        size_t              m_bufferDataSize;
+
+        unsigned long long m_size;
+        unsigned long long m_position;     // Position of the next byte returned by read.
+        unsigned long long m_filePosition; // Position in the file - after the buffered data.
+
+        // Copying is not allowed.
+        BinaryFileReader( const BinaryFileReader& ) = delete;
+        BinaryFileReader& operator=( const BinaryFileReader& ) = delete;
+    };
+}
@@ -0,0 +1,143 @@
+#include "BinaryFileWriter.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Engine1;
+
+BinaryFileWriter::BinaryFileWriter( const std::string& path ) :
+    m_isFile( true ),
+    m_memoryData( nullptr ),
+    m_bufferDataSize( 0 ),
+    m_position( 0 )
+{
+    m_file.open( path.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc );
+
+    if ( !m_file.is_open() )
+        throw std::exception( "BinaryFileWriter::BinaryFileWriter - Failed to open file." );
+
+    m_buffer.resize( s_bufferSize );
+}
+
+BinaryFileWriter::BinaryFileWriter( std::vector<char>& data ) :
+    m_isFile( false ),
+    m_memoryData( &data ),
+    m_bufferDataSize( 0 ),
+    m_position( 0 )
+{}
+
+BinaryFileWriter::~BinaryFileWriter()
+{
+    if ( m_file.is_open() )
+        m_file.close();
+}
+
+void BinaryFileWriter::write( const void* source, const unsigned long long size )
+{
+    if ( size == 0 )
+        return;
+
+    const char* sourceIt = static_cast< const char* >( source );
+
+    if ( !m_isFile )
+    {
+        m_memoryData->insert( m_memoryData->end(), sourceIt, sourceIt + size );
+        m_position += size;
+        return;
+    }
+
+    unsigned long long remainingSize = size;
+
+    // Fill what's left in the buffer.
+    const size_t sizeToBuffer = (size_t)std::min( remainingSize, (unsigned long long)( m_buffer.size() - m_bufferDataSize ) );
+    std::memcpy( m_buffer.data() + m_bufferDataSize, sourceIt, sizeToBuffer );
+    m_bufferDataSize += sizeToBuffer;
+    sourceIt         += sizeToBuffer;
+    remainingSize    -= sizeToBuffer;
+
+    if ( m_bufferDataSize == m_buffer.size() )
+        flushBuffer();
+
+    // Large writes go directly from the source - in multiples of the buffer size (to keep file writes aligned)
+    // and in chunks, as a single write can't exceed the stream size type on some platforms.
+    const unsigned long long maxChunkSize = 1024ull * 1024ull * 1024ull;
+    while ( remainingSize >= m_buffer.size() )
+    {
+        const unsigned long long chunkSize = std::min( remainingSize / m_buffer.size() * m_buffer.size(), maxChunkSize );
+
+        m_file.write( sourceIt, (std::streamsize)chunkSize );
+        if ( !m_file )
+            throw std::exception( "BinaryFileWriter::write - Failed to write file." );
+
+        sourceIt      += chunkSize;
+        remainingSize -= chunkSize;
+    }
+
+    // The rest goes to the buffer (which is empty if anything is left).
+    if ( remainingSize > 0 )
+    {
+        std::memcpy( m_buffer.data(), sourceIt, (size_t)remainingSize );
+        m_bufferDataSize = (size_t)remainingSize;
+    }
+
+    m_position += size;
+}
+
+void BinaryFileWriter::writeZeros( const unsigned long long size )
+{
+    if ( !m_isFile )
+    {
+        m_memoryData->insert( m_memoryData->end(), (size_t)size, 0 );
+        m_position += size;
+        return;
+    }
+
+    unsigned long long remainingSize = size;
+    while ( remainingSize > 0 )
+    {
+        const size_t sizeToBuffer = (size_t)std::min( remainingSize, (unsigned long long)( m_buffer.size() - m_bufferDataSize ) );
+        std::memset( m_buffer.data() + m_bufferDataSize, 0, sizeToBuffer );
+        m_bufferDataSize += sizeToBuffer;
+        remainingSize    -= sizeToBuffer;
+
+        if ( m_bufferDataSize == m_buffer.size() )
+            flushBuffer();
+    }
+
+    m_position += size;
+}
+
+void BinaryFileWriter::reserve( const unsigned long long size )
+{
+    if ( !m_isFile )
+        m_memoryData->reserve( m_memoryData->size() + (size_t)size );
+}
+
+void BinaryFileWriter::close()
+{
+    if ( !m_isFile )
+        return;
+
+    flushBuffer();
+
+    m_file.close();
+    if ( !m_file )
+        throw std::exception( "BinaryFileWriter::close - Failed to write file." );
+}
+
+unsigned long long BinaryFileWriter::getPosition() const
+{
+    return m_position;
+}
+
+void BinaryFileWriter::flushBuffer()
+{
+    if ( m_bufferDataSize == 0 )
+        return;
+
+    m_file.write( m_buffer.data(), (std::streamsize)m_bufferDataSize );
+    if ( !m_file )
+        throw std::exception( "BinaryFileWriter::flushBuffer - Failed to write file." );
+
+    m_bufferDataSize = 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace Engine1
+{
+    // Writes binary data sequentially - either to a file or to memory.
+    // File is written in chunks through a fixed-size buffer and large writes go directly from the source (in multiples of the buffer size),
+    // so the whole file never has to be assembled in memory and the file is written in large aligned chunks.
+    class BinaryFileWriter
+    {
+        public:
+
+        static const size_t s_bufferSize = 1024 * 1024;
+
+        // Creates or overwrites the file.
+        BinaryFileWriter( const std::string& path );
+        // Appends to the vector.
+        BinaryFileWriter( std::vector<char>& data );
+        // Note: Buffered data is discarded if close wasn't called (ex: because of an exception).
+        ~BinaryFileWriter();
+
+        void write( const void* source, const unsigned long long size );
+        void writeZeros( const unsigned long long size );
+
+        template< typename T >
+        void write( const T& value )
+        {
+            write( &value, sizeof( T ) );
+        }
+
+        template< typename T >
+        void writeArray( const std::vector< T >& values )
+        {
+            if ( !values.empty() )
+                write( values.data(), (unsigned long long)values.size() * sizeof( T ) );
+        }
+
+        // Hint about the total size to be written - avoids reallocations when writing to memory.
+        void reserve( const unsigned long long size );
+
+        // Writes the buffered data to the file and closes it. Throws if any write failed.
+        void close();
+
+        // Number of bytes written so far.
+        unsigned long long getPosition() const;
+
+        private:
+
+        void flushBuffer();
+
+        std::ofstream        m_file;
+        bool                 m_isFile;
+        std::vector< char >* m_memoryData;
+
+        std::vector< char > m_buffer;
+        size_t              m_bufferDataSize;
+
+        unsigned long long m_position;
+
+        // Copying is not allowed.
+        BinaryFileWriter( const BinaryFileWriter& ) = delete;
+        BinaryFileWriter& operator=( const BinaryFileWriter& ) = delete;
+    };
+}
@@ -7,17 +7,21 @@
 #include <d3d11_3.h>
 
 #include "MeshFileParser.h"
+#include "MeshUtil.h"
+#include "DerivedDataCache.h"
 #include "BlockMeshFileInfoParser.h"
 
 #include "StringUtil.h"
-#include "DX11Util.h"
 #include "MathUtil.h"
 
 #include "TextFile.h"
 #include "BinaryFile.h"
+#include "BinaryFileReader.h"
+#include "BinaryFileWriter.h"
 
 #include "BVHTree.h"
 #include "BVHTreeBuffer.h"
+#include "MeshletBuffer.h"
 
 using namespace Engine1;
 
@@ -30,13 +34,27 @@ std::shared_ptr<BlockMesh> BlockMesh::createFromFile( const BlockMeshFileInfo& f
 
 std::shared_ptr<BlockMesh> BlockMesh::createFromFile( const std::string& path, const BlockMeshFileInfo::Format format, const int indexInFile, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
 {
-    std::shared_ptr< std::vector<char> > fileData;
-    if ( BlockMeshFileInfo::Format::OBJ == format || BlockMeshFileInfo::Format::DAE == format ) 
-	    fileData = TextFile::load( path );
-    else if ( BlockMeshFileInfo::Format::FBX == format || BlockMeshFileInfo::Format::BLOCKMESH == format )
-        fileData = BinaryFile::load( path );
+    std::shared_ptr<BlockMesh> mesh;
 
-    std::shared_ptr<BlockMesh> mesh = createFromMemory( fileData->cbegin( ), fileData->cend( ), format, indexInFile, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+    if ( BlockMeshFileInfo::Format::BLOCKMESH == format )
+    {
+        if ( indexInFile != 0 )
+            throw std::exception( "BlockMesh::createFromFile - no mesh at given index in file." );
+
+        // Parse while reading - avoids loading the whole (possibly huge) file to memory first.
+        BinaryFileReader reader( path );
+        mesh = MeshFileParser::parseBlockMeshFile( reader );
+    }
+    else
+    {
+        std::shared_ptr< std::vector<char> > fileData;
+        if ( BlockMeshFileInfo::Format::OBJ == format || BlockMeshFileInfo::Format::DAE == format ) 
+	        fileData = TextFile::load( path );
+        else if ( BlockMeshFileInfo::Format::FBX == format )
+            fileData = BinaryFile::load( path );
+
+        mesh = createFromMemory( fileData->cbegin( ), fileData->cend( ), format, indexInFile, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+    }
 
 	// Save path in the loaded mesh.
 	mesh->getFileInfo().setPath( path );
@@ -89,13 +107,21 @@ std::shared_ptr<BlockMesh> BlockMesh::createFromMemory( std::vector<char>::const
 
 std::vector< std::shared_ptr<BlockMesh> > BlockMesh::createFromMemory( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt, const BlockMeshFileInfo::Format format, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
 {
+    // Imported formats are processed only once and then read from the cache (if enabled).
+    if ( format != BlockMeshFileInfo::Format::BLOCKMESH )
+        return DerivedDataCache::getOrImportBlockMeshes( dataIt, dataEndIt, format, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+
     return MeshFileParser::parseBlockMeshFile( format, dataIt, dataEndIt, invertZCoordinate, invertVertexWindingOrder, flipUVs );
 }
 
-BlockMesh::BlockMesh()
+BlockMesh::BlockMesh() :
+    m_vertexLayout( VertexLayout::Separate ),
+    m_interleavedVertexFormat( { 0, -1, -1, -1, -1 } )
 {}
 
-BlockMesh::BlockMesh( const int vertexCount, const bool hasNormalsTangents, const int texcoordsSetCount, const int triangleCount )
+BlockMesh::BlockMesh( const int vertexCount, const bool hasNormalsTangents, const int texcoordsSetCount, const int triangleCount ) :
+    m_vertexLayout( VertexLayout::Separate ),
+    m_interleavedVertexFormat( { 0, -1, -1, -1, -1 } )
 {
     m_vertices.resize( vertexCount );
     
@@ -115,11 +141,21 @@ BlockMesh::BlockMesh( const int vertexCount, const bool hasNormalsTangents, cons
 BlockMesh::~BlockMesh()
 {}
 
-void BlockMesh::saveToFile( const std::string& path, const BlockMeshFileInfo::Format format )
+void BlockMesh::saveToFile( const std::string& path, const BlockMeshFileInfo::Format format, const bool compress )
 {
+    // Own format is streamed directly to the file - without creating a copy of the whole mesh in memory.
+    if ( format == BlockMeshFileInfo::Format::BLOCKMESH )
+    {
+        BinaryFileWriter writer( path );
+        MeshFileParser::writeBlockMeshFile( writer, *this, compress );
+        writer.close();
+
+        return;
+    }
+
     std::vector< char > data;
 
-    MeshFileParser::writeBlockMeshFile( data, format, *this );
+    MeshFileParser::writeBlockMeshFile( data, format, *this, compress );
 
     BlockMeshFileInfo::FileType fileType = BlockMeshFileInfo::getFileTypeFromFormat( format );
     if ( fileType == BlockMeshFileInfo::FileType::Binary )
@@ -163,220 +199,6 @@ BlockMeshFileInfo& BlockMesh::getFileInfo( )
 	return m_fileInfo;
 }
 
-void BlockMesh::loadCpuToGpu( ID3D11Device3& device, bool reload )
-{
-	if ( !isInCpuMemory() ) 
-        throw std::exception( "BlockMesh::loadCpuToGpu - Mesh not loaded in CPU memory." );
-
-	if ( m_vertices.size() > 0 && ( !m_vertexBuffer || reload ) ) {
-		D3D11_BUFFER_DESC vertexBufferDesc;
-		vertexBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
-		vertexBufferDesc.ByteWidth           = sizeof(float3)* (unsigned int)m_vertices.size();
-		vertexBufferDesc.BindFlags           = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
-		vertexBufferDesc.CPUAccessFlags      = 0;
-		vertexBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
-		vertexBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA vertexDataPtr;
-		vertexDataPtr.pSysMem          = m_vertices.data();
-		vertexDataPtr.SysMemPitch      = 0;
-		vertexDataPtr.SysMemSlicePitch = 0;
-
-		HRESULT result = device.CreateBuffer( &vertexBufferDesc, &vertexDataPtr, m_vertexBuffer.ReleaseAndGetAddressOf() );
-		if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - Buffer creation for mesh vertices failed" );
-
-        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
-        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
-        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
-        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
-        resourceDesc.BufferEx.FirstElement = 0;
-        resourceDesc.BufferEx.NumElements  = (unsigned int)m_vertices.size() * 3;
-
-        result = device.CreateShaderResourceView( m_vertexBuffer.Get(), &resourceDesc, m_vertexBufferResource.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - creating vertex buffer shader resource on GPU failed." );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "BlockMesh::vertexBuffer" );
-		DX11Util::setResourceName( *m_vertexBuffer.Get(), resourceName );
-#endif
-	}
-
-	if ( m_normals.size() > 0 && ( !m_normalBuffer || reload ) ) {
-		D3D11_BUFFER_DESC normalBufferDesc;
-		normalBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
-		normalBufferDesc.ByteWidth           = sizeof(float3) * (unsigned int)m_normals.size();
-		normalBufferDesc.BindFlags           = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
-		normalBufferDesc.CPUAccessFlags      = 0;
-		normalBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
-		normalBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA normalDataPtr;
-		normalDataPtr.pSysMem = m_normals.data();
-		normalDataPtr.SysMemPitch = 0;
-		normalDataPtr.SysMemSlicePitch = 0;
-
-		HRESULT result = device.CreateBuffer( &normalBufferDesc, &normalDataPtr, m_normalBuffer.ReleaseAndGetAddressOf() );
-		if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - Buffer creation for mesh normals failed" );
-
-        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
-        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
-        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
-        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
-        resourceDesc.BufferEx.FirstElement = 0;
-        resourceDesc.BufferEx.NumElements  = (unsigned int)m_normals.size() * 3;
-
-        result = device.CreateShaderResourceView( m_normalBuffer.Get(), &resourceDesc, m_normalBufferResource.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - creating normal buffer shader resource on GPU failed." );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "BlockMesh::normalBuffer" );
-		DX11Util::setResourceName( *m_normalBuffer.Get(), resourceName );
-#endif
-	}
-
-    if ( m_tangents.size() > 0 && ( !m_tangentBuffer || reload ) ) {
-		D3D11_BUFFER_DESC tangentBufferDesc;
-		tangentBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
-		tangentBufferDesc.ByteWidth           = sizeof(float3) * (unsigned int)m_tangents.size();
-		tangentBufferDesc.BindFlags           = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
-		tangentBufferDesc.CPUAccessFlags      = 0;
-		tangentBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
-		tangentBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA tangentDataPtr;
-		tangentDataPtr.pSysMem = m_tangents.data();
-		tangentDataPtr.SysMemPitch = 0;
-		tangentDataPtr.SysMemSlicePitch = 0;
-
-		HRESULT result = device.CreateBuffer( &tangentBufferDesc, &tangentDataPtr, m_tangentBuffer.ReleaseAndGetAddressOf() );
-		if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - Buffer creation for mesh tangents failed" );
-
-        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
-        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
-        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
-        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
-        resourceDesc.BufferEx.FirstElement = 0;
-        resourceDesc.BufferEx.NumElements  = (unsigned int)m_tangents.size() * 3;
-
-        result = device.CreateShaderResourceView( m_tangentBuffer.Get(), &resourceDesc, m_tangentBufferResource.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - creating tangent buffer shader resource on GPU failed." );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "BlockMesh::tangentBuffer" );
-		DX11Util::setResourceName( *m_tangentBuffer.Get(), resourceName );
-#endif
-	}
-
-
-    // If reloading - destroy old texcoord set buffers/views on GPU.
-    if ( reload )
-    {
-        m_texcoordBuffers.clear();
-        m_texcoordBufferResources.clear();
-    }
-
-	std::list< std::vector<float2> >::iterator texcoordsIt, texcoordsEnd = m_texcoords.end();
-    int texcoordsIndex = -1;
-
-	for ( texcoordsIt = m_texcoords.begin(); texcoordsIt != texcoordsEnd; ++texcoordsIt ) {
-        ++texcoordsIndex;
-
-        if ( texcoordsIndex < (int)m_texcoordBuffers.size() )
-            continue; // Skip texcoords which are already loaded.
-
-		if ( texcoordsIt->empty() ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - One of mesh's texcoord sets is empty" );
-
-		D3D11_BUFFER_DESC texcoordBufferDesc;
-		texcoordBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
-		texcoordBufferDesc.ByteWidth           = sizeof(float2) * (unsigned int)texcoordsIt->size();
-		texcoordBufferDesc.BindFlags           = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
-		texcoordBufferDesc.CPUAccessFlags      = 0;
-		texcoordBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
-		texcoordBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA texcoordDataPtr;
-		texcoordDataPtr.pSysMem = texcoordsIt->data();
-		texcoordDataPtr.SysMemPitch = 0;
-		texcoordDataPtr.SysMemSlicePitch = 0;
-
-		ComPtr<ID3D11Buffer> buffer;
-
-		HRESULT result = device.CreateBuffer( &texcoordBufferDesc, &texcoordDataPtr, buffer.GetAddressOf() );
-		if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - Buffer creation for mesh texcoords failed" );
-
-        m_texcoordBuffers.push_back( buffer );
-
-        ComPtr<ID3D11ShaderResourceView> bufferResource;
-
-        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
-        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
-        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
-        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
-        resourceDesc.BufferEx.FirstElement = 0;
-        resourceDesc.BufferEx.NumElements  = (unsigned int)texcoordsIt->size() * 2;
-
-        result = device.CreateShaderResourceView( buffer.Get(), &resourceDesc, bufferResource.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - creating texcoord buffer shader resource on GPU failed." );
-
-        m_texcoordBufferResources.push_back( bufferResource );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "BlockMesh::texcoordBuffer[" ) + std::to_string( m_texcoordBuffers.size() - 1 ) + std::string( "]" );
-		DX11Util::setResourceName( *buffer.Get(), resourceName );
-#endif
-	}
-
-    if ( m_triangles.empty() ) 
-        throw std::exception( "BlockMesh::loadToGpu - Mesh has no triangles" );
-
-    if ( !m_triangleBuffer || reload ) {
-        D3D11_BUFFER_DESC triangleBufferDesc;
-        triangleBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
-        triangleBufferDesc.ByteWidth           = sizeof(uint3) * (unsigned int)m_triangles.size();
-        triangleBufferDesc.BindFlags           = D3D11_BIND_INDEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
-        triangleBufferDesc.CPUAccessFlags      = 0;
-        triangleBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
-        triangleBufferDesc.StructureByteStride = 0;
-
-        D3D11_SUBRESOURCE_DATA triangleDataPtr;
-        triangleDataPtr.pSysMem = m_triangles.data();
-        triangleDataPtr.SysMemPitch = 0;
-        triangleDataPtr.SysMemSlicePitch = 0;
-
-        HRESULT result = device.CreateBuffer( &triangleBufferDesc, &triangleDataPtr, m_triangleBuffer.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadToGpu - Buffer creation for mesh triangles failed" );
-
-        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
-        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
-        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
-        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
-        resourceDesc.BufferEx.FirstElement = 0;
-        resourceDesc.BufferEx.NumElements  = (unsigned int)m_triangles.size() * 3;
-
-        result = device.CreateShaderResourceView( m_triangleBuffer.Get(), &resourceDesc, m_triangleBufferResource.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) 
-            throw std::exception( "BlockMesh::loadCpuToGpu - creating triangle buffer shader resource on GPU failed." );
-
-#if defined(_DEBUG) 
-        std::string resourceName = std::string( "BlockMesh::triangleBuffer" );
-        DX11Util::setResourceName( *m_triangleBuffer.Get(), resourceName );
-#endif
-	}
-
-    if ( getBvhTree() )
-        loadBvhTreeToGpu( device, reload );
-}
-
 void BlockMesh::loadGpuToCpu()
 {
 	throw std::exception( "BlockMesh::loadGpuToCpu - unimplemented method." );
@@ -417,6 +239,8 @@ void BlockMesh::unloadFromGpu()
 
 	m_triangleBuffer.Reset();
     m_triangleBufferResource.Reset();
+
+    m_interleavedVertexBuffer.Reset();
 }
 
 bool BlockMesh::isInCpuMemory() const
@@ -426,7 +250,17 @@ bool BlockMesh::isInCpuMemory() const
 
 bool BlockMesh::isInGpuMemory() const
 {
-	return m_vertexBuffer && m_vertexBufferResource && m_triangleBuffer && m_triangleBufferResource;
+	return m_vertexBufferResource && m_triangleBuffer && m_triangleBufferResource;
+}
+
+void BlockMesh::setVertexLayout( const VertexLayout layout )
+{
+    m_vertexLayout = layout;
+}
+
+BlockMesh::VertexLayout BlockMesh::getVertexLayout() const
+{
+    return m_vertexLayout;
 }
 
 const std::vector<float3>& BlockMesh::getVertices() const
@@ -483,11 +317,7 @@ const std::vector<float2>& BlockMesh::getTexcoords( int setIndex ) const
 	if ( !isInCpuMemory() ) throw std::exception( "BlockMesh::getTexcoords - Mesh not loaded in CPU memory." );
 	if ( setIndex >= (int)m_texcoords.size() ) throw std::exception( "BlockMesh::getTexcoords: Trying to access texcoords at non-existing index." );
 
-    //#TODO: use std::advance() ?
-	std::list< std::vector<float2> >::const_iterator it = m_texcoords.begin();
-	for ( int i = 0; i < setIndex; ++i ) it++;
-
-	return *it;
+	return m_texcoords[ setIndex ];
 }
 
 std::vector<float2>& BlockMesh::getTexcoords( int setIndex )
@@ -495,10 +325,7 @@ std::vector<float2>& BlockMesh::getTexcoords( int setIndex )
 	if ( !isInCpuMemory() ) throw std::exception( "BlockMesh::getTexcoords - Mesh not loaded in CPU memory." );
 	if ( setIndex >= (int)m_texcoords.size() ) throw std::exception( "BlockMesh::getTexcoords: Trying to access texcoords at non-existing index." );
 
-	std::list< std::vector<float2> >::iterator it = m_texcoords.begin();
-	for ( int i = 0; i < setIndex; ++i ) it++;
-
-	return *it;
+	return m_texcoords[ setIndex ];
 }
 
 const std::vector<uint3>& BlockMesh::getTriangles() const
@@ -556,6 +383,18 @@ ID3D11Buffer* BlockMesh::getTriangleBuffer() const
 	return m_triangleBuffer.Get();
 }
 
+ID3D11Buffer* BlockMesh::getInterleavedVertexBuffer() const
+{
+	if ( !isInGpuMemory() ) throw std::exception( "BlockMesh::getInterleavedVertexBuffer - Mesh not loaded in GPU memory." );
+
+	return m_interleavedVertexBuffer.Get();
+}
+
+const BlockMesh::InterleavedVertexFormat& BlockMesh::getInterleavedVertexFormat() const
+{
+    return m_interleavedVertexFormat;
+}
+
 ID3D11ShaderResourceView* BlockMesh::getVertexBufferResource() const
 {
     if ( !isInGpuMemory() ) throw std::exception( "BlockMesh::getVertexBufferResource - Mesh not loaded in GPU memory." );
@@ -597,6 +436,34 @@ ID3D11ShaderResourceView* BlockMesh::getTriangleBufferResource() const
     return m_triangleBufferResource.Get();
 }
 
+uint4 BlockMesh::getBufferResourceStrides() const
+{
+    const auto getStride = [ this ]( const int interleavedOffset, const unsigned int size ) {
+        return interleavedOffset >= 0 ? m_interleavedVertexFormat.stride : size;
+    };
+
+    return uint4(
+        getStride( m_interleavedVertexFormat.positionOffset, sizeof( float3 ) ),
+        getStride( m_interleavedVertexFormat.normalOffset, sizeof( float3 ) ),
+        getStride( m_interleavedVertexFormat.tangentOffset, sizeof( float3 ) ),
+        getStride( m_interleavedVertexFormat.texcoordOffset, sizeof( float2 ) )
+    );
+}
+
+uint4 BlockMesh::getBufferResourceOffsets() const
+{
+    const auto getOffset = []( const int interleavedOffset ) {
+        return interleavedOffset >= 0 ? (unsigned int)interleavedOffset : 0u;
+    };
+
+    return uint4(
+        getOffset( m_interleavedVertexFormat.positionOffset ),
+        getOffset( m_interleavedVertexFormat.normalOffset ),
+        getOffset( m_interleavedVertexFormat.tangentOffset ),
+        getOffset( m_interleavedVertexFormat.texcoordOffset )
+    );
+}
+
 void BlockMesh::recalculateBoundingBox()
 {
     m_boundingBox = MathUtil::calculateBoundingBox( m_vertices );
@@ -618,107 +485,6 @@ void BlockMesh::buildBvhTree()
     m_bvhTree->clearTriangles();
 }
 
-void BlockMesh::loadBvhTreeToGpu( ID3D11Device3& device, const bool reload )
-{
-    if ( !m_bvhTreeBufferNodesGpu || reload ) 
-    {
-        D3D11_BUFFER_DESC desc;
-        desc.Usage               = D3D11_USAGE_DEFAULT;
-        desc.ByteWidth           = sizeof( BVHTreeBuffer::Node ) * (unsigned int)m_bvhTree->getNodes().size();
-        desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
-        desc.CPUAccessFlags      = 0;
-        desc.MiscFlags           = 0;
-        desc.StructureByteStride = 0;
-
-        D3D11_SUBRESOURCE_DATA dataPtr;
-        dataPtr.pSysMem          = m_bvhTree->getNodes().data();
-        dataPtr.SysMemPitch      = 0;
-        dataPtr.SysMemSlicePitch = 0;
-
-        HRESULT result = device.CreateBuffer( &desc, &dataPtr, m_bvhTreeBufferNodesGpu.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) throw std::exception( "BlockMesh::loadBvhTreeToGpu - Buffer creation for BVH nodes failed." );
-
-        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
-        resourceDesc.Format              = DXGI_FORMAT_R32G32_UINT;
-        resourceDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
-        resourceDesc.Buffer.FirstElement = 0;
-        resourceDesc.Buffer.NumElements  = (unsigned int)m_bvhTree->getNodes().size();
-
-        result = device.CreateShaderResourceView( m_bvhTreeBufferNodesGpu.Get(), &resourceDesc, m_bvhTreeBufferNodesGpuSRV.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) throw std::exception( "BlockMesh::loadCpuToGpu - creating BVH nodes shader resource view on GPU failed." );
-
-#if defined(_DEBUG) 
-        std::string resourceName = std::string( "BlockMesh::bvhNodes" );
-        DX11Util::setResourceName( *m_bvhTreeBufferNodesGpu.Get(), resourceName );
-#endif
-	}
-
-    if ( !m_bvhTreeBufferNodesExtentsGpu || reload ) {
-        D3D11_BUFFER_DESC desc;
-        desc.Usage               = D3D11_USAGE_DEFAULT;
-        desc.ByteWidth           = sizeof( BVHTreeBuffer::NodeExtents ) * (unsigned int)m_bvhTree->getNodesExtents().size();
-        desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
-        desc.CPUAccessFlags      = 0;
-        desc.MiscFlags           = 0;
-        desc.StructureByteStride = 0;
-
-        D3D11_SUBRESOURCE_DATA dataPtr;
-        dataPtr.pSysMem          = m_bvhTree->getNodesExtents().data();
-        dataPtr.SysMemPitch      = 0;
-        dataPtr.SysMemSlicePitch = 0;
-
-        HRESULT result = device.CreateBuffer( &desc, &dataPtr, m_bvhTreeBufferNodesExtentsGpu.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) throw std::exception( "BlockMesh::loadBvhTreeToGpu - Buffer creation for BVH nodes extents failed." );
-
-        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
-        resourceDesc.Format              = DXGI_FORMAT_R32G32B32_FLOAT;
-        resourceDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
-        resourceDesc.Buffer.FirstElement = 0;
-        resourceDesc.Buffer.NumElements  = (unsigned int)m_bvhTree->getNodesExtents().size() * 2; // Multiplied by 2, because SRV accesses 
-                                                                                                      // each float3 separately instead of pair <float3, float3> (min, max).
-
-        result = device.CreateShaderResourceView( m_bvhTreeBufferNodesExtentsGpu.Get(), &resourceDesc, m_bvhTreeBufferNodesExtentsGpuSRV.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) throw std::exception( "BlockMesh::loadCpuToGpu - creating BVH nodes extents shader resource view on GPU failed." );
-
-#if defined(_DEBUG) 
-        std::string resourceName = std::string( "BlockMesh::bvhNodesExtents" );
-        DX11Util::setResourceName( *m_bvhTreeBufferNodesExtentsGpu.Get(), resourceName );
-#endif
-	}
-
-    if ( ( !m_bvhTreeBufferTrianglesGpu || reload ) && !m_bvhTree->getTriangles().empty() ) {
-        D3D11_BUFFER_DESC desc;
-        desc.Usage               = D3D11_USAGE_DEFAULT;
-        desc.ByteWidth           = sizeof( unsigned int ) * (unsigned int)m_bvhTree->getTriangles().size();
-        desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
-        desc.CPUAccessFlags      = 0;
-        desc.MiscFlags           = 0;
-        desc.StructureByteStride = 0;
-
-        D3D11_SUBRESOURCE_DATA dataPtr;
-        dataPtr.pSysMem          = m_bvhTree->getTriangles().data();
-        dataPtr.SysMemPitch      = 0;
-        dataPtr.SysMemSlicePitch = 0;
-
-        HRESULT result = device.CreateBuffer( &desc, &dataPtr, m_bvhTreeBufferTrianglesGpu.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) throw std::exception( "BlockMesh::loadBvhTreeToGpu - Buffer creation for BVH triangles failed." );
-
-        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
-        resourceDesc.Format              = DXGI_FORMAT_R32_UINT;
-        resourceDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
-        resourceDesc.Buffer.FirstElement = 0;
-        resourceDesc.Buffer.NumElements  = (unsigned int)m_bvhTree->getTriangles().size();
-
-        result = device.CreateShaderResourceView( m_bvhTreeBufferTrianglesGpu.Get(), &resourceDesc, m_bvhTreeBufferTrianglesGpuSRV.ReleaseAndGetAddressOf() );
-        if ( result < 0 ) throw std::exception( "BlockMesh::loadCpuToGpu - creating BVH triangles shader resource view on GPU failed." );
-
-#if defined(_DEBUG) 
-        std::string resourceName = std::string( "BlockMesh::bvhTriangles" );
-        DX11Util::setResourceName( *m_bvhTreeBufferTrianglesGpu.Get(), resourceName );
-#endif
-	}
-}
-
 void BlockMesh::unloadBvhTreeFromGpu()
 {
     m_bvhTreeBufferNodesGpu.Reset();
@@ -736,6 +502,21 @@ void BlockMesh::setBvhTree( std::shared_ptr< BVHTreeBuffer > bvhTree )
     m_bvhTree = bvhTree;
 }
 
+void BlockMesh::buildMeshlets( const int maxVertexCount, const int maxTriangleCount )
+{
+    m_meshlets = std::make_shared< MeshletBuffer >( *this, maxVertexCount, maxTriangleCount );
+}
+
+std::shared_ptr< const MeshletBuffer > BlockMesh::getMeshlets() const
+{
+    return m_meshlets;
+}
+
+void BlockMesh::setMeshlets( std::shared_ptr< MeshletBuffer > meshlets )
+{
+    m_meshlets = meshlets;
+}
+
 void BlockMesh::reorganizeTrianglesToMatchBvhTree()
 {
     if ( !m_bvhTree )
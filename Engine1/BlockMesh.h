@@ -9,6 +9,7 @@
 #include "float2.h"
 #include "float3.h"
 #include "uint3.h"
+#include "uint4.h"
 
 #include "Asset.h"
 #include "BlockMeshFileInfo.h"
@@ -22,15 +23,37 @@ namespace Engine1
 {
     class BVHTree;
     class BVHTreeBuffer;
+    class MeshletBuffer;
     class MeshUtil;
 
     class BlockMesh : public Asset
     {
         friend class MeshFileParser;
         friend class MeshUtil;
+        friend class ObjFileParser;
 
         public:
 
+        // Layout of the vertex buffers used for rasterization. Saved with the mesh in own format (can be changed in the editor).
+        // Ray tracing reads positions, normals, tangents and the first texcoord set through raw views - of the separate buffers
+        // or of the interleaved buffer (with its stride and attribute offsets), so interleaved attributes are not duplicated in separate buffers.
+        enum class VertexLayout : char
+        {
+            Separate = 0, // Each attribute in its own buffer.
+            Interleaved,  // Position, normal, tangent and the first texcoord set in a single buffer.
+            Hybrid        // Positions in their own buffer (enough for depth-only passes), other attributes interleaved.
+        };
+
+        // Byte offsets of attributes in the interleaved vertex buffer. Negative offset means that the attribute is not present.
+        struct InterleavedVertexFormat
+        {
+            unsigned int stride;
+            int          positionOffset;
+            int          normalOffset;
+            int          tangentOffset;
+            int          texcoordOffset;
+        };
+
         static std::shared_ptr<BlockMesh>                createFromFile( const BlockMeshFileInfo& fileInfo );
         static std::shared_ptr<BlockMesh>                createFromFile( const std::string& path, const BlockMeshFileInfo::Format format, const int indexInFile, const bool invertZCoordinate = false, const bool invertVertexWindingOrder = false, const bool flipUVs = false );
         static std::vector< std::shared_ptr<BlockMesh> > createFromFile( const std::string& path, const BlockMeshFileInfo::Format format, const bool invertZCoordinate = false, const bool invertVertexWindingOrder = false, const bool flipUVs = false );
@@ -41,7 +64,7 @@ namespace Engine1
         BlockMesh( const int vertexCount, const bool hasNormalsTangents, const int texcoordsSetCount, const int triangleCount );
         ~BlockMesh();
 
-        void saveToFile( const std::string& path, const BlockMeshFileInfo::Format format );
+        void saveToFile( const std::string& path, const BlockMeshFileInfo::Format format, const bool compress = false );
 
         Asset::Type                                 getType() const;
         std::vector< std::shared_ptr<const Asset> > getSubAssets() const;
@@ -59,6 +82,10 @@ namespace Engine1
         bool isInCpuMemory() const;
         bool isInGpuMemory() const;
 
+        // Takes effect on the next load to GPU (or reload).
+        void         setVertexLayout( const VertexLayout layout );
+        VertexLayout getVertexLayout() const;
+
         const std::vector<float3>& getVertices() const;
         std::vector<float3>& getVertices();
         const std::vector<float3>& getNormals() const;
@@ -72,18 +99,28 @@ namespace Engine1
         const std::vector<uint3>& getTriangles() const;
         std::vector<uint3>& getTriangles();
 
+        // Return nullptr for attributes stored in the interleaved buffer.
         ID3D11Buffer* getVertexBuffer() const;
         ID3D11Buffer* getNormalBuffer() const;
         ID3D11Buffer* getTangentBuffer() const;
         std::list< ID3D11Buffer* > getTexcoordBuffers() const;
         ID3D11Buffer* getTriangleBuffer() const;
 
+        // Returns nullptr for the separate vertex layout.
+        ID3D11Buffer*                  getInterleavedVertexBuffer() const;
+        const InterleavedVertexFormat& getInterleavedVertexFormat() const;
+
+        // Attributes stored in the interleaved buffer share a view of the whole buffer.
         ID3D11ShaderResourceView* getVertexBufferResource() const;
         ID3D11ShaderResourceView* getNormalBufferResource() const;
         ID3D11ShaderResourceView* getTangentBufferResource() const;
         std::list< ID3D11ShaderResourceView* > getTexcoordBufferResources() const;
         ID3D11ShaderResourceView* getTriangleBufferResource() const;
 
+        // Strides and offsets (in bytes) of positions, normals, tangents and the first texcoord set in their buffer resources.
+        uint4 getBufferResourceStrides() const;
+        uint4 getBufferResourceOffsets() const;
+
         void recalculateBoundingBox();
         // Returns <min, max> of the bounding box.
         BoundingBox getBoundingBox() const;
@@ -94,6 +131,11 @@ namespace Engine1
         std::shared_ptr< const BVHTreeBuffer > getBvhTree() const;
         void                                   setBvhTree( std::shared_ptr< BVHTreeBuffer > bvhTree );
 
+        // Splits the mesh into clusters of triangles for culling parts of the mesh separately. See MeshletBuffer.
+        void                                   buildMeshlets( const int maxVertexCount = 64, const int maxTriangleCount = 124 );
+        std::shared_ptr< const MeshletBuffer > getMeshlets() const;
+        void                                   setMeshlets( std::shared_ptr< MeshletBuffer > meshlets );
+
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> getBvhTreeBufferNodesShaderResourceView()        const;
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> getBvhTreeBufferNodesExtentsShaderResourceView() const;
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> getBvhTreeBufferTrianglesShaderResourceView()    const;
@@ -111,14 +153,18 @@ namespace Engine1
         std::vector<float3> m_vertices;
         std::vector<float3> m_normals;
         std::vector<float3> m_tangents;
-        std::list< std::vector<float2> > m_texcoords;
+        std::vector< std::vector<float2> > m_texcoords;
         std::vector<uint3> m_triangles;
 
+        VertexLayout            m_vertexLayout;
+        InterleavedVertexFormat m_interleavedVertexFormat;
+
         Microsoft::WRL::ComPtr<ID3D11Buffer> m_vertexBuffer;
         Microsoft::WRL::ComPtr<ID3D11Buffer> m_normalBuffer;
         Microsoft::WRL::ComPtr<ID3D11Buffer> m_tangentBuffer;
         std::list< Microsoft::WRL::ComPtr<ID3D11Buffer> > m_texcoordBuffers;
         Microsoft::WRL::ComPtr<ID3D11Buffer> m_triangleBuffer;
+        Microsoft::WRL::ComPtr<ID3D11Buffer> m_interleavedVertexBuffer;
 
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_vertexBufferResource;
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_normalBufferResource;
@@ -136,6 +182,8 @@ namespace Engine1
         Microsoft::WRL::ComPtr<ID3D11Buffer>             m_bvhTreeBufferTrianglesGpu;
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_bvhTreeBufferTrianglesGpuSRV;
 
+        std::shared_ptr< MeshletBuffer > m_meshlets;
+
         // Copying meshes in not allowed.
         BlockMesh( const BlockMesh& ) = delete;
         BlockMesh& operator=(const BlockMesh&) = delete;
@@ -1,6 +1,7 @@
 #include "BlockMeshFileInfo.h"
 
 #include "BlockMeshFileInfoParser.h"
+#include "StringUtil.h"
 
 #include <memory>
 #include <assert.h>
@@ -38,6 +39,18 @@ std::string BlockMeshFileInfo::formatToString( const Format format )
     return "";
 }
 
+BlockMeshFileInfo::Format BlockMeshFileInfo::fromExtension( const std::string& extension )
+{
+    const std::string extensionLowercase = StringUtil::toLowercase( extension );
+
+    if ( extensionLowercase == "obj" )            return Format::OBJ;
+    else if ( extensionLowercase == "dae" )       return Format::DAE;
+    else if ( extensionLowercase == "fbx" )       return Format::FBX;
+    else if ( extensionLowercase == "blockmesh" ) return Format::BLOCKMESH;
+
+    throw std::exception( "BlockMeshFileInfo::fromExtension - unrecognized extension." );
+}
+
 BlockMeshFileInfo::BlockMeshFileInfo() : 
 	m_path( "" ),
 	m_format( Format::OBJ ),
@@ -72,6 +85,7 @@ void BlockMeshFileInfo::saveToMemory( std::vector<char>& data ) const
 void BlockMeshFileInfo::setPath( std::string path ) 
 {
 	this->m_path = path;
+	invalidateAssetId();
 }
 
 void BlockMeshFileInfo::setFormat( Format format )
@@ -82,6 +96,7 @@ void BlockMeshFileInfo::setFormat( Format format )
 void BlockMeshFileInfo::setIndexInFile( int indexInFile )
 {
 	this->m_indexInFile = indexInFile;
+	invalidateAssetId();
 }
 
 void BlockMeshFileInfo::setInvertZCoordinate( bool invertZCoordinate )
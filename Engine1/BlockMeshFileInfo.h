@@ -24,6 +24,7 @@ namespace Engine1
 
         static FileType    getFileTypeFromFormat( const Format format );
         static std::string formatToString( const Format format );
+        static Format      fromExtension( const std::string& extension );
 
         BlockMeshFileInfo();
         BlockMeshFileInfo( std::string path, Format format, int indexInFile = 0, bool invertZCoordinate = false, bool invertVertexWindingOrder = false, bool flipUVs = false );
@@ -0,0 +1,397 @@
+#include "BlockMesh.h"
+
+#include <d3d11_3.h>
+
+#include "MeshUtil.h"
+#include "DX11Util.h"
+
+#include "BVHTreeBuffer.h"
+
+using namespace Engine1;
+
+void BlockMesh::loadCpuToGpu( ID3D11Device3& device, bool reload )
+{
+	if ( !isInCpuMemory() ) 
+        throw std::exception( "BlockMesh::loadCpuToGpu - Mesh not loaded in CPU memory." );
+
+    const InterleavedVertexFormat interleavedVertexFormat = m_vertexLayout != VertexLayout::Separate
+        ? MeshUtil::getInterleavedVertexFormat( *this, m_vertexLayout == VertexLayout::Interleaved )
+        : InterleavedVertexFormat{ 0, -1, -1, -1, -1 };
+
+    // Attributes stored in the interleaved buffer don't have own buffers, so buffers of a different layout can't be reused.
+    if ( interleavedVertexFormat.stride != m_interleavedVertexFormat.stride
+        || interleavedVertexFormat.positionOffset != m_interleavedVertexFormat.positionOffset
+        || interleavedVertexFormat.normalOffset != m_interleavedVertexFormat.normalOffset
+        || interleavedVertexFormat.tangentOffset != m_interleavedVertexFormat.tangentOffset
+        || interleavedVertexFormat.texcoordOffset != m_interleavedVertexFormat.texcoordOffset )
+    {
+        unloadFromGpu();
+        m_interleavedVertexFormat = interleavedVertexFormat;
+    }
+
+	if ( m_vertices.size() > 0 && m_interleavedVertexFormat.positionOffset < 0 && ( !m_vertexBuffer || reload ) ) {
+		D3D11_BUFFER_DESC vertexBufferDesc;
+		vertexBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+		vertexBufferDesc.ByteWidth           = sizeof(float3)* (unsigned int)m_vertices.size();
+		vertexBufferDesc.BindFlags           = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
+		vertexBufferDesc.CPUAccessFlags      = 0;
+		vertexBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+		vertexBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA vertexDataPtr;
+		vertexDataPtr.pSysMem          = m_vertices.data();
+		vertexDataPtr.SysMemPitch      = 0;
+		vertexDataPtr.SysMemSlicePitch = 0;
+
+		HRESULT result = device.CreateBuffer( &vertexBufferDesc, &vertexDataPtr, m_vertexBuffer.ReleaseAndGetAddressOf() );
+		if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - Buffer creation for mesh vertices failed" );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
+        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
+        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
+        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
+        resourceDesc.BufferEx.FirstElement = 0;
+        resourceDesc.BufferEx.NumElements  = (unsigned int)m_vertices.size() * 3;
+
+        result = device.CreateShaderResourceView( m_vertexBuffer.Get(), &resourceDesc, m_vertexBufferResource.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - creating vertex buffer shader resource on GPU failed." );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "BlockMesh::vertexBuffer" );
+		DX11Util::setResourceName( *m_vertexBuffer.Get(), resourceName );
+#endif
+	}
+
+	if ( m_normals.size() > 0 && m_interleavedVertexFormat.normalOffset < 0 && ( !m_normalBuffer || reload ) ) {
+		D3D11_BUFFER_DESC normalBufferDesc;
+		normalBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+		normalBufferDesc.ByteWidth           = sizeof(float3) * (unsigned int)m_normals.size();
+		normalBufferDesc.BindFlags           = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
+		normalBufferDesc.CPUAccessFlags      = 0;
+		normalBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+		normalBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA normalDataPtr;
+		normalDataPtr.pSysMem = m_normals.data();
+		normalDataPtr.SysMemPitch = 0;
+		normalDataPtr.SysMemSlicePitch = 0;
+
+		HRESULT result = device.CreateBuffer( &normalBufferDesc, &normalDataPtr, m_normalBuffer.ReleaseAndGetAddressOf() );
+		if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - Buffer creation for mesh normals failed" );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
+        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
+        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
+        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
+        resourceDesc.BufferEx.FirstElement = 0;
+        resourceDesc.BufferEx.NumElements  = (unsigned int)m_normals.size() * 3;
+
+        result = device.CreateShaderResourceView( m_normalBuffer.Get(), &resourceDesc, m_normalBufferResource.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - creating normal buffer shader resource on GPU failed." );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "BlockMesh::normalBuffer" );
+		DX11Util::setResourceName( *m_normalBuffer.Get(), resourceName );
+#endif
+	}
+
+    if ( m_tangents.size() > 0 && m_interleavedVertexFormat.tangentOffset < 0 && ( !m_tangentBuffer || reload ) ) {
+		D3D11_BUFFER_DESC tangentBufferDesc;
+		tangentBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+		tangentBufferDesc.ByteWidth           = sizeof(float3) * (unsigned int)m_tangents.size();
+		tangentBufferDesc.BindFlags           = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
+		tangentBufferDesc.CPUAccessFlags      = 0;
+		tangentBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+		tangentBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA tangentDataPtr;
+		tangentDataPtr.pSysMem = m_tangents.data();
+		tangentDataPtr.SysMemPitch = 0;
+		tangentDataPtr.SysMemSlicePitch = 0;
+
+		HRESULT result = device.CreateBuffer( &tangentBufferDesc, &tangentDataPtr, m_tangentBuffer.ReleaseAndGetAddressOf() );
+		if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - Buffer creation for mesh tangents failed" );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
+        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
+        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
+        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
+        resourceDesc.BufferEx.FirstElement = 0;
+        resourceDesc.BufferEx.NumElements  = (unsigned int)m_tangents.size() * 3;
+
+        result = device.CreateShaderResourceView( m_tangentBuffer.Get(), &resourceDesc, m_tangentBufferResource.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - creating tangent buffer shader resource on GPU failed." );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "BlockMesh::tangentBuffer" );
+		DX11Util::setResourceName( *m_tangentBuffer.Get(), resourceName );
+#endif
+	}
+
+
+    // If reloading - destroy old texcoord set buffers/views on GPU.
+    if ( reload )
+    {
+        m_texcoordBuffers.clear();
+        m_texcoordBufferResources.clear();
+    }
+
+	std::vector< std::vector<float2> >::iterator texcoordsIt, texcoordsEnd = m_texcoords.end();
+    int texcoordsIndex = -1;
+
+	for ( texcoordsIt = m_texcoords.begin(); texcoordsIt != texcoordsEnd; ++texcoordsIt ) {
+        ++texcoordsIndex;
+
+        if ( texcoordsIndex < (int)m_texcoordBuffers.size() )
+            continue; // Skip texcoords which are already loaded.
+
+        // Only the first set is read by ray tracing. Other sets are used only by the separate layout.
+        if ( ( texcoordsIndex > 0 && m_vertexLayout != VertexLayout::Separate ) || m_interleavedVertexFormat.texcoordOffset >= 0 )
+            break;
+
+		if ( texcoordsIt->empty() ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - One of mesh's texcoord sets is empty" );
+
+		D3D11_BUFFER_DESC texcoordBufferDesc;
+		texcoordBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+		texcoordBufferDesc.ByteWidth           = sizeof(float2) * (unsigned int)texcoordsIt->size();
+		texcoordBufferDesc.BindFlags           = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
+		texcoordBufferDesc.CPUAccessFlags      = 0;
+		texcoordBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+		texcoordBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA texcoordDataPtr;
+		texcoordDataPtr.pSysMem = texcoordsIt->data();
+		texcoordDataPtr.SysMemPitch = 0;
+		texcoordDataPtr.SysMemSlicePitch = 0;
+
+		ComPtr<ID3D11Buffer> buffer;
+
+		HRESULT result = device.CreateBuffer( &texcoordBufferDesc, &texcoordDataPtr, buffer.GetAddressOf() );
+		if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - Buffer creation for mesh texcoords failed" );
+
+        m_texcoordBuffers.push_back( buffer );
+
+        ComPtr<ID3D11ShaderResourceView> bufferResource;
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
+        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
+        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
+        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
+        resourceDesc.BufferEx.FirstElement = 0;
+        resourceDesc.BufferEx.NumElements  = (unsigned int)texcoordsIt->size() * 2;
+
+        result = device.CreateShaderResourceView( buffer.Get(), &resourceDesc, bufferResource.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - creating texcoord buffer shader resource on GPU failed." );
+
+        m_texcoordBufferResources.push_back( bufferResource );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "BlockMesh::texcoordBuffer[" ) + std::to_string( m_texcoordBuffers.size() - 1 ) + std::string( "]" );
+		DX11Util::setResourceName( *buffer.Get(), resourceName );
+#endif
+	}
+
+    if ( m_triangles.empty() ) 
+        throw std::exception( "BlockMesh::loadToGpu - Mesh has no triangles" );
+
+    if ( !m_triangleBuffer || reload ) {
+        D3D11_BUFFER_DESC triangleBufferDesc;
+        triangleBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+        triangleBufferDesc.ByteWidth           = sizeof(uint3) * (unsigned int)m_triangles.size();
+        triangleBufferDesc.BindFlags           = D3D11_BIND_INDEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
+        triangleBufferDesc.CPUAccessFlags      = 0;
+        triangleBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+        triangleBufferDesc.StructureByteStride = 0;
+
+        D3D11_SUBRESOURCE_DATA triangleDataPtr;
+        triangleDataPtr.pSysMem = m_triangles.data();
+        triangleDataPtr.SysMemPitch = 0;
+        triangleDataPtr.SysMemSlicePitch = 0;
+
+        HRESULT result = device.CreateBuffer( &triangleBufferDesc, &triangleDataPtr, m_triangleBuffer.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadToGpu - Buffer creation for mesh triangles failed" );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
+        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
+        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
+        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
+        resourceDesc.BufferEx.FirstElement = 0;
+        resourceDesc.BufferEx.NumElements  = (unsigned int)m_triangles.size() * 3;
+
+        result = device.CreateShaderResourceView( m_triangleBuffer.Get(), &resourceDesc, m_triangleBufferResource.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - creating triangle buffer shader resource on GPU failed." );
+
+#if defined(_DEBUG) 
+        std::string resourceName = std::string( "BlockMesh::triangleBuffer" );
+        DX11Util::setResourceName( *m_triangleBuffer.Get(), resourceName );
+#endif
+	}
+
+    if ( m_vertexLayout != VertexLayout::Separate && ( !m_interleavedVertexBuffer || reload ) ) {
+        const std::vector< char > interleavedVertices = MeshUtil::interleaveVertices( *this, m_interleavedVertexFormat );
+
+        D3D11_BUFFER_DESC interleavedBufferDesc;
+        interleavedBufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+        interleavedBufferDesc.ByteWidth           = (unsigned int)interleavedVertices.size();
+        interleavedBufferDesc.BindFlags           = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE;
+        interleavedBufferDesc.CPUAccessFlags      = 0;
+        interleavedBufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+        interleavedBufferDesc.StructureByteStride = 0;
+
+        D3D11_SUBRESOURCE_DATA interleavedDataPtr;
+        interleavedDataPtr.pSysMem          = interleavedVertices.data();
+        interleavedDataPtr.SysMemPitch      = 0;
+        interleavedDataPtr.SysMemSlicePitch = 0;
+
+        HRESULT result = device.CreateBuffer( &interleavedBufferDesc, &interleavedDataPtr, m_interleavedVertexBuffer.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - Buffer creation for interleaved mesh vertices failed" );
+
+        // Ray tracing reads interleaved attributes through a raw view of the whole buffer (with their offsets and the interleaved stride),
+        // because offsets of raw views have to be aligned to 16 bytes.
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
+        resourceDesc.Format                = DXGI_FORMAT_R32_TYPELESS;
+        resourceDesc.ViewDimension         = D3D11_SRV_DIMENSION_BUFFEREX;
+        resourceDesc.BufferEx.Flags        = D3D11_BUFFEREX_SRV_FLAG_RAW;
+        resourceDesc.BufferEx.FirstElement = 0;
+        resourceDesc.BufferEx.NumElements  = interleavedBufferDesc.ByteWidth / 4;
+
+        ComPtr<ID3D11ShaderResourceView> bufferResource;
+
+        result = device.CreateShaderResourceView( m_interleavedVertexBuffer.Get(), &resourceDesc, bufferResource.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) 
+            throw std::exception( "BlockMesh::loadCpuToGpu - creating interleaved vertex buffer shader resource on GPU failed." );
+
+        if ( m_interleavedVertexFormat.positionOffset >= 0 )
+            m_vertexBufferResource = bufferResource;
+
+        if ( m_interleavedVertexFormat.normalOffset >= 0 )
+            m_normalBufferResource = bufferResource;
+
+        if ( m_interleavedVertexFormat.tangentOffset >= 0 )
+            m_tangentBufferResource = bufferResource;
+
+        if ( m_interleavedVertexFormat.texcoordOffset >= 0 )
+            m_texcoordBufferResources.push_back( bufferResource );
+
+#if defined(_DEBUG) 
+        std::string resourceName = std::string( "BlockMesh::interleavedVertexBuffer" );
+        DX11Util::setResourceName( *m_interleavedVertexBuffer.Get(), resourceName );
+#endif
+    }
+
+    if ( getBvhTree() )
+        loadBvhTreeToGpu( device, reload );
+}
+
+void BlockMesh::loadBvhTreeToGpu( ID3D11Device3& device, const bool reload )
+{
+    if ( !m_bvhTreeBufferNodesGpu || reload ) 
+    {
+        D3D11_BUFFER_DESC desc;
+        desc.Usage               = D3D11_USAGE_DEFAULT;
+        desc.ByteWidth           = sizeof( BVHTreeBuffer::Node ) * (unsigned int)m_bvhTree->getNodes().size();
+        desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+        desc.CPUAccessFlags      = 0;
+        desc.MiscFlags           = 0;
+        desc.StructureByteStride = 0;
+
+        D3D11_SUBRESOURCE_DATA dataPtr;
+        dataPtr.pSysMem          = m_bvhTree->getNodes().data();
+        dataPtr.SysMemPitch      = 0;
+        dataPtr.SysMemSlicePitch = 0;
+
+        HRESULT result = device.CreateBuffer( &desc, &dataPtr, m_bvhTreeBufferNodesGpu.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) throw std::exception( "BlockMesh::loadBvhTreeToGpu - Buffer creation for BVH nodes failed." );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
+        resourceDesc.Format              = DXGI_FORMAT_R32G32_UINT;
+        resourceDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
+        resourceDesc.Buffer.FirstElement = 0;
+        resourceDesc.Buffer.NumElements  = (unsigned int)m_bvhTree->getNodes().size();
+
+        result = device.CreateShaderResourceView( m_bvhTreeBufferNodesGpu.Get(), &resourceDesc, m_bvhTreeBufferNodesGpuSRV.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) throw std::exception( "BlockMesh::loadCpuToGpu - creating BVH nodes shader resource view on GPU failed." );
+
+#if defined(_DEBUG) 
+        std::string resourceName = std::string( "BlockMesh::bvhNodes" );
+        DX11Util::setResourceName( *m_bvhTreeBufferNodesGpu.Get(), resourceName );
+#endif
+	}
+
+    if ( !m_bvhTreeBufferNodesExtentsGpu || reload ) {
+        D3D11_BUFFER_DESC desc;
+        desc.Usage               = D3D11_USAGE_DEFAULT;
+        desc.ByteWidth           = sizeof( BVHTreeBuffer::NodeExtents ) * (unsigned int)m_bvhTree->getNodesExtents().size();
+        desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+        desc.CPUAccessFlags      = 0;
+        desc.MiscFlags           = 0;
+        desc.StructureByteStride = 0;
+
+        D3D11_SUBRESOURCE_DATA dataPtr;
+        dataPtr.pSysMem          = m_bvhTree->getNodesExtents().data();
+        dataPtr.SysMemPitch      = 0;
+        dataPtr.SysMemSlicePitch = 0;
+
+        HRESULT result = device.CreateBuffer( &desc, &dataPtr, m_bvhTreeBufferNodesExtentsGpu.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) throw std::exception( "BlockMesh::loadBvhTreeToGpu - Buffer creation for BVH nodes extents failed." );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
+        resourceDesc.Format              = DXGI_FORMAT_R32G32B32_FLOAT;
+        resourceDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
+        resourceDesc.Buffer.FirstElement = 0;
+        resourceDesc.Buffer.NumElements  = (unsigned int)m_bvhTree->getNodesExtents().size() * 2; // Multiplied by 2, because SRV accesses 
+                                                                                                      // each float3 separately instead of pair <float3, float3> (min, max).
+
+        result = device.CreateShaderResourceView( m_bvhTreeBufferNodesExtentsGpu.Get(), &resourceDesc, m_bvhTreeBufferNodesExtentsGpuSRV.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) throw std::exception( "BlockMesh::loadCpuToGpu - creating BVH nodes extents shader resource view on GPU failed." );
+
+#if defined(_DEBUG) 
+        std::string resourceName = std::string( "BlockMesh::bvhNodesExtents" );
+        DX11Util::setResourceName( *m_bvhTreeBufferNodesExtentsGpu.Get(), resourceName );
+#endif
+	}
+
+    if ( ( !m_bvhTreeBufferTrianglesGpu || reload ) && !m_bvhTree->getTriangles().empty() ) {
+        D3D11_BUFFER_DESC desc;
+        desc.Usage               = D3D11_USAGE_DEFAULT;
+        desc.ByteWidth           = sizeof( unsigned int ) * (unsigned int)m_bvhTree->getTriangles().size();
+        desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+        desc.CPUAccessFlags      = 0;
+        desc.MiscFlags           = 0;
+        desc.StructureByteStride = 0;
+
+        D3D11_SUBRESOURCE_DATA dataPtr;
+        dataPtr.pSysMem          = m_bvhTree->getTriangles().data();
+        dataPtr.SysMemPitch      = 0;
+        dataPtr.SysMemSlicePitch = 0;
+
+        HRESULT result = device.CreateBuffer( &desc, &dataPtr, m_bvhTreeBufferTrianglesGpu.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) throw std::exception( "BlockMesh::loadBvhTreeToGpu - Buffer creation for BVH triangles failed." );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceDesc;
+        resourceDesc.Format              = DXGI_FORMAT_R32_UINT;
+        resourceDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
+        resourceDesc.Buffer.FirstElement = 0;
+        resourceDesc.Buffer.NumElements  = (unsigned int)m_bvhTree->getTriangles().size();
+
+        result = device.CreateShaderResourceView( m_bvhTreeBufferTrianglesGpu.Get(), &resourceDesc, m_bvhTreeBufferTrianglesGpuSRV.ReleaseAndGetAddressOf() );
+        if ( result < 0 ) throw std::exception( "BlockMesh::loadCpuToGpu - creating BVH triangles shader resource view on GPU failed." );
+
+#if defined(_DEBUG) 
+        std::string resourceName = std::string( "BlockMesh::bvhTriangles" );
+        DX11Util::setResourceName( *m_bvhTreeBufferTrianglesGpu.Get(), resourceName );
+#endif
+	}
+}
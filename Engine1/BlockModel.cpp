@@ -8,37 +8,6 @@
 
 using namespace Engine1;
 
-std::shared_ptr<BlockModel> BlockModel::createFromFile( const BlockModelFileInfo& fileInfo, const bool loadRecurrently, ID3D11Device3& device )
-{
-	return createFromFile( fileInfo.getPath(), fileInfo.getFormat(), loadRecurrently, device );
-}
-
-std::shared_ptr<BlockModel> BlockModel::createFromFile( const std::string& path, const BlockModelFileInfo::Format format, const bool loadRecurrently, ID3D11Device3& device )
-{
-    std::shared_ptr<BlockModel> model;
-
-	std::shared_ptr< std::vector<char> > fileData = BinaryFile::load( path );
-	    
-    model = createFromMemory( fileData->cbegin(), fileData->cend(), format, loadRecurrently, device );
-
-    model->getFileInfo( ).setPath( path );
-    model->getFileInfo( ).setFormat( format );
-
-    return model;
-}
-
-std::shared_ptr<BlockModel> BlockModel::createFromMemory( 
-    std::vector<char>::const_iterator dataIt, 
-    std::vector<char>::const_iterator dataEndIt, 
-    const BlockModelFileInfo::Format format, 
-    const bool loadRecurrently, ID3D11Device3& device )
-{
-	if ( BlockModelFileInfo::Format::BLOCKMODEL == format )
-		return BlockModelParser::parseBinary( dataIt, loadRecurrently, device );
-
-	throw std::exception( "BlockModel::createFromMemory() - incorrect 'format' argument." );
-}
-
 BlockModel::BlockModel( ) 
 : m_mesh( nullptr ) 
 {}
@@ -241,40 +210,6 @@ void BlockModel::saveToMemory( std::vector<char>& data ) const
     BlockModelParser::writeBinary( data, *this );
 }
 
-void BlockModel::loadCpuToGpu( ID3D11Device3& device, ID3D11DeviceContext3& deviceContext, bool reload )
-{
-	if ( m_mesh )
-		m_mesh->loadCpuToGpu( device, reload );
-
-    for ( const ModelTexture2D< unsigned char >& texture : m_alphaTextures )
-		if ( texture.getTexture() && texture.getTexture()->isInCpuMemory() )
-            texture.getTexture()->loadCpuToGpu( device, deviceContext, reload );
-
-    for ( const ModelTexture2D< uchar4 >& texture : m_emissiveTextures )
-		if ( texture.getTexture() && texture.getTexture()->isInCpuMemory() ) 
-            texture.getTexture()->loadCpuToGpu( device, deviceContext, reload );
-
-	for ( const ModelTexture2D< uchar4 >& texture : m_albedoTextures )
-		if ( texture.getTexture() && texture.getTexture()->isInCpuMemory() ) 
-            texture.getTexture()->loadCpuToGpu( device, deviceContext, reload );
-
-	for ( const ModelTexture2D< unsigned char >& texture : m_metalnessTextures )
-		if ( texture.getTexture() && texture.getTexture()->isInCpuMemory() ) 
-            texture.getTexture()->loadCpuToGpu( device, deviceContext, reload );
-
-	for ( const ModelTexture2D< unsigned char >& texture : m_roughnessTextures )
-		if ( texture.getTexture() && texture.getTexture()->isInCpuMemory() ) 
-            texture.getTexture()->loadCpuToGpu( device, deviceContext, reload );
-
-	for ( const ModelTexture2D< uchar4 >& texture : m_normalTextures )
-		if ( texture.getTexture() && texture.getTexture()->isInCpuMemory() ) 
-            texture.getTexture()->loadCpuToGpu( device, deviceContext, reload );
-
-	for ( const ModelTexture2D< unsigned char >& texture : m_refractiveIndexTextures )
-		if ( texture.getTexture() && texture.getTexture()->isInCpuMemory() ) 
-            texture.getTexture()->loadCpuToGpu( device, deviceContext, reload );
-}
-
 void BlockModel::loadGpuToCpu()
 {
     throw std::exception( "BlockMesh::loadGpuToCpu - unimplemented method." );
@@ -44,6 +44,7 @@ void BlockModelFileInfo::saveToMemory( std::vector<char>& data ) const
 void BlockModelFileInfo::setPath( std::string path )
 {
 	this->m_path = path;
+	invalidateAssetId();
 }
 
 void BlockModelFileInfo::setFormat( Format format )
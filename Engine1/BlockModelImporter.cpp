@@ -5,6 +5,7 @@
 #include "BlockMesh.h"
 #include "BlockModel.h"
 #include "BinaryFile.h"
+#include "MeshFileParser.h"
 #include "FileUtil.h"
 #include "StringUtil.h"
 
@@ -25,152 +26,142 @@ std::vector< std::shared_ptr< BlockModel > > BlockModelImporter::import(
     const bool invertVertexWindingOrder,
     const bool flipUVs )
 {
-    std::vector< std::shared_ptr< BlockModel > > models;
+    const BlockMeshFileInfo::Format format = BlockMeshFileInfo::fromExtension( FileUtil::getFileExtensionFromPath( filePath ) );
 
     Assimp::Importer importer;
 
-    unsigned int flags = aiProcess_Triangulate | aiProcess_CalcTangentSpace;
+    const aiScene*                              aiscene = nullptr;
+    std::vector< std::shared_ptr< BlockMesh > > meshes;
+
+    if ( format == BlockMeshFileInfo::Format::OBJ )
+    {
+        // Meshes are parsed by the native OBJ parser - the same way as when importing meshes alone.
+        // Assimp reads only the materials (without any post-processing). Both split the file into meshes the same way.
+        const std::shared_ptr< std::vector< char > > fileData = BinaryFile::load( filePath );
+
+        std::vector< char >::const_iterator dataIt    = fileData->cbegin();
+        std::vector< char >::const_iterator dataEndIt = fileData->cend();
 
-    if ( invertZCoordinate )        flags |= aiProcess_MakeLeftHanded;
-    if ( invertVertexWindingOrder ) flags |= aiProcess_FlipWindingOrder;
-    if ( flipUVs )                  flags |= aiProcess_FlipUVs;
+        meshes  = MeshFileParser::parseBlockMeshFile( format, dataIt, dataEndIt, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+        aiscene = importer.ReadFile( filePath.c_str(), 0 );
+    }
+    else
+    {
+        unsigned int flags = aiProcess_Triangulate | aiProcess_CalcTangentSpace;
 
-    const aiScene* aiscene = importer.ReadFile( filePath.c_str(), flags );
+        if ( invertZCoordinate )        flags |= aiProcess_MakeLeftHanded;
+        if ( invertVertexWindingOrder ) flags |= aiProcess_FlipWindingOrder;
+        if ( flipUVs )                  flags |= aiProcess_FlipUVs;
+
+        aiscene = importer.ReadFile( filePath.c_str(), flags );
+    }
 
     if ( !aiscene ) 
-        throw std::exception( ("BlockModelParser::parseObjFile - parsing failed - " + std::string( importer.GetErrorString() )).c_str() );
+        throw std::exception( ("BlockModelImporter::import - parsing failed - " + std::string( importer.GetErrorString() )).c_str() );
+
+    if ( format != BlockMeshFileInfo::Format::OBJ )
+        meshes = MeshFileParser::createBlockMeshes( *aiscene );
 
-    models.reserve( aiscene->mNumMeshes );
+    if ( meshes.size() != aiscene->mNumMeshes )
+        throw std::exception( "BlockModelImporter::import - number of parsed meshes differs from the number of meshes read by Assimp." );
+
+    std::vector< std::shared_ptr< BlockModel > > models;
+    models.reserve( meshes.size() );
 
     auto defaultWhiteTexture = createDefaultWhiteTexture();
 
     for ( unsigned int meshIndex = 0; meshIndex < aiscene->mNumMeshes; ++meshIndex ) 
     {
-        aiMesh& aimesh = *aiscene->mMeshes[ meshIndex ];
-
         models.push_back( std::make_shared< BlockModel >() );
         auto& model = *models.back();
 
-        const int texcoordSetCount = 1;
-
-        model.setMesh( std::make_shared< BlockMesh >( 
-            aimesh.mNumVertices, 
-            aimesh.HasNormals() && aimesh.HasTangentsAndBitangents(), 
-            texcoordSetCount, 
-            aimesh.mNumFaces ) 
-        );
+        model.setMesh( meshes[ meshIndex ] );
 
-        auto mesh = model.getMesh();
+        addMaterial( model, *aiscene->mMaterials[ aiscene->mMeshes[ meshIndex ]->mMaterialIndex ], defaultWhiteTexture );
+    }
 
-        auto& meshVertices = mesh->getVertices();
-        for ( unsigned int i = 0; i < aimesh.mNumVertices; ++i ) 
-            meshVertices[ i ] = ( *(float3*)&aimesh.mVertices[ i ] );
+    return models;
+}
 
-        if ( aimesh.HasNormals() && aimesh.HasTangentsAndBitangents() ) 
+void BlockModelImporter::addMaterial( BlockModel& model, const aiMaterial& aimaterial, const std::shared_ptr< Texture2D< uchar4 > >& defaultWhiteTexture )
+{
+    // Read all textures from the material.
+    const int textureTypeCount = 11; // Hard coded in Assimp.
+    for ( int aiTextureType = 0; aiTextureType < textureTypeCount; ++aiTextureType )
+    {
+        try
         {
-            auto& meshNormals = mesh->getNormals();
-            for ( unsigned int i = 0; i < aimesh.mNumVertices; ++i ) 
-                meshNormals[ i ] = ( *(float3*)&aimesh.mNormals[ i ] );
-
-            auto& meshTangents = mesh->getTangents();
-            for ( unsigned int i = 0; i < aimesh.mNumVertices; ++i ) 
-                meshTangents[ i ] = ( *(float3*)&aimesh.mTangents[ i ] );
-        }
+            aiString path;
+            if ( aimaterial.Get( _AI_MATKEY_TEXTURE_BASE, aiTextureType, 0, path ) == aiReturn_SUCCESS )
+            {
+                auto fileName      = FileUtil::getFileNameFromPath( path.C_Str() );
+                auto fileExtension = FileUtil::getFileExtensionFromPath( fileName );
+                auto fileFormat    = Texture2DFileInfo::fromExtension( fileExtension );
+
+                // Try to deduce texture type based on the file name's suffix (_A, _N etc).
+                Model::TextureType textureType = Model::textureFileNameToType( fileName );
+
+                // #TODO: Should be replaced by some utility method.
+                Texture2DFileInfo::PixelType pixelType = Texture2DFileInfo::PixelType::UCHAR;
+                if ( textureType == Model::TextureType::Emissive
+                    || textureType == Model::TextureType::Albedo
+                    || textureType == Model::TextureType::Normal )
+                {
+                    pixelType = Texture2DFileInfo::PixelType::UCHAR4;
+                }
 
-        if ( aimesh.HasTextureCoords( 0 ) ) 
-        {
-            auto& meshTexcoords = mesh->getTexcoords( 0 );
-            for ( unsigned int i = 0; i < aimesh.mNumVertices; ++i )
-                meshTexcoords[ i ] = ( float2( aimesh.mTextureCoords[ 0 ][ i ].x, aimesh.mTextureCoords[ 0 ][ i ].y ) );
-        }
+                Texture2DFileInfo fileInfo;
+                fileInfo.setPath( fileName );
+                fileInfo.setFormat( fileFormat );
+                fileInfo.setPixelType( pixelType );
 
-        auto& meshTriangles = mesh->getTriangles();
-        for ( unsigned int i = 0; i < aimesh.mNumFaces; ++i ) {
-            meshTriangles[ i ] = ( *reinterpret_cast<uint3*>(aimesh.mFaces[ i ].mIndices) );
-        }
+                // Remove existing textures of the same type - only one is allowed during import.
+                model.removeAllTextures( textureType );
 
-        aiMaterial& aimaterial = *aiscene->mMaterials[ aimesh.mMaterialIndex ];
+                if ( pixelType == Texture2DFileInfo::PixelType::UCHAR )
+                {
+                    auto emptyTexture = std::make_shared< ImmutableTexture2D< unsigned char > >();
+                    emptyTexture->setFileInfo( fileInfo );
 
-        // Read all textures from the material.
-        const int textureTypeCount = 11; // Hard coded in Assimp.
-        for ( int aiTextureType = 0; aiTextureType < textureTypeCount; ++aiTextureType )
-        {
-            try
-            {
-                aiString path;
-                if ( aimaterial.Get( _AI_MATKEY_TEXTURE_BASE, aiTextureType, 0, path ) == aiReturn_SUCCESS )
+                    model.addTexture( textureType, emptyTexture );
+                }
+                else
                 {
-                    auto fileName      = FileUtil::getFileNameFromPath( path.C_Str() );
-                    auto fileExtension = FileUtil::getFileExtensionFromPath( fileName );
-                    auto fileFormat    = Texture2DFileInfo::fromExtension( fileExtension );
-
-                    // Try to deduce texture type based on the file name's suffix (_A, _N etc).
-                    Model::TextureType textureType = Model::textureFileNameToType( fileName );
-
-                    // #TODO: Should be replaced by some utility method.
-                    Texture2DFileInfo::PixelType pixelType = Texture2DFileInfo::PixelType::UCHAR;
-                    if ( textureType == Model::TextureType::Emissive
-                        || textureType == Model::TextureType::Albedo
-                        || textureType == Model::TextureType::Normal )
-                    {
-                        pixelType = Texture2DFileInfo::PixelType::UCHAR4;
-                    }
-
-                    Texture2DFileInfo fileInfo;
-                    fileInfo.setPath( fileName );
-                    fileInfo.setFormat( fileFormat );
-                    fileInfo.setPixelType( pixelType );
-
-                    // Remove existing textures of the same type - only one is allowed during import.
-                    model.removeAllTextures( textureType );
-
-                    if ( pixelType == Texture2DFileInfo::PixelType::UCHAR )
-                    {
-                        auto emptyTexture = std::make_shared< ImmutableTexture2D< unsigned char > >();
-                        emptyTexture->setFileInfo( fileInfo );
-
-                        model.addTexture( textureType, emptyTexture );
-                    }
-                    else
-                    {
-                        auto emptyTexture = std::make_shared< ImmutableTexture2D< uchar4 > >();
-                        emptyTexture->setFileInfo( fileInfo );
-
-                        model.addTexture( textureType, emptyTexture );
-                    }
+                    auto emptyTexture = std::make_shared< ImmutableTexture2D< uchar4 > >();
+                    emptyTexture->setFileInfo( fileInfo );
+
+                    model.addTexture( textureType, emptyTexture );
                 }
             }
-            catch ( std::exception& e )
-            {
-                OutputDebugStringW( StringUtil::widen( 
-                    std::string( "BlockModelImporter::import - error while parsing material textures: \"" ) 
-                    + e.what() + "\"\n"  
-                ).c_str( ) );
-            }
         }
+        catch ( std::exception& e )
+        {
+            OutputDebugStringW( StringUtil::widen( 
+                std::string( "BlockModelImporter::addMaterial - error while parsing material textures: \"" ) 
+                + e.what() + "\"\n"  
+            ).c_str( ) );
+        }
+    }
 
-        // Read albedo color multipliers.
-        aiColor3D albedoMul;
-        if ( aimaterial.Get(AI_MATKEY_COLOR_DIFFUSE, albedoMul) == aiReturn_SUCCESS )
+    // Read albedo color multipliers.
+    aiColor3D albedoMul;
+    if ( aimaterial.Get(AI_MATKEY_COLOR_DIFFUSE, albedoMul) == aiReturn_SUCCESS )
+    {
+        // Add an empty model texture if none exists.
+        if ( model.getAlbedoTextures().empty() )
         {
-            // Add an empty model texture if none exists.
-            if ( model.getAlbedoTextures().empty() )
-            {
-                model.addTexture( Model::TextureType::Albedo, defaultWhiteTexture );
-            }
+            model.addTexture( Model::TextureType::Albedo, defaultWhiteTexture );
+        }
 
-            auto& albedoModelTexture = model.getAlbedoTextures().front();
+        auto& albedoModelTexture = model.getAlbedoTextures().front();
 
-            albedoModelTexture.setColorMultiplier( float4(
-                albedoMul.r,
-                albedoMul.g,
-                albedoMul.b,
-                1.0f
-            ) );
-        }
+        albedoModelTexture.setColorMultiplier( float4(
+            albedoMul.r,
+            albedoMul.g,
+            albedoMul.b,
+            1.0f
+        ) );
     }
-
-    return models;
 }
 
 std::shared_ptr< Texture2D< uchar4 > >
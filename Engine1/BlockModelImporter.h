@@ -7,6 +7,7 @@
 #include "Texture2DTypes.h"
 
 struct ID3D11Device3;
+struct aiMaterial;
 
 namespace Engine1
 {
@@ -17,7 +18,7 @@ namespace Engine1
         public:
 
         // Note: This method loads mesh and materials from the file, but doesn't load textures.
-        // Should be used only to convert to internal file format.
+        // Should be used only to convert to internal file format. Meshes are parsed the same way as by MeshFileParser.
         static std::vector< std::shared_ptr< BlockModel > > import( 
             std::string filePath, 
             const bool invertZCoordinate, 
@@ -27,6 +28,8 @@ namespace Engine1
 
         private:
 
+        static void addMaterial( BlockModel& model, const aiMaterial& aimaterial, const std::shared_ptr< Texture2D< uchar4 > >& defaultWhiteTexture );
+
         static std::shared_ptr< Texture2D< uchar4 > > createDefaultWhiteTexture();
     };
 }
@@ -0,0 +1,177 @@
+#include "CompressionUtil.h"
+
+#include <cstring>
+#include <exception>
+
+using namespace Engine1;
+
+namespace
+{
+    const size_t minMatchLength = 4;
+    const size_t maxMatchOffset = 65535;
+    const int    hashTableBits  = 16;
+
+    unsigned int readUint32( const char* data )
+    {
+        unsigned int value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return value;
+    }
+
+    unsigned int hashSequence( const unsigned int sequence )
+    {
+        return ( sequence * 2654435761u ) >> ( 32 - hashTableBits );
+    }
+
+    void writeLength( std::vector< char >& output, size_t length )
+    {
+        while ( length >= 255 ) {
+            output.push_back( (char)255 );
+            length -= 255;
+        }
+
+        output.push_back( (char)length );
+    }
+
+    size_t readLength( const unsigned char*& inputIt, const unsigned char* inputEnd )
+    {
+        size_t length = 0;
+        unsigned char value = 255;
+        while ( value == 255 ) {
+            if ( inputIt >= inputEnd )
+                throw std::exception( "CompressionUtil::decompress - corrupted data (length out of bounds)." );
+
+            value = *inputIt++;
+            length += value;
+        }
+
+        return length;
+    }
+
+    // Writes a sequence of literals, optionally followed by a match.
+    // Each sequence starts with a token - literal count in the high nibble and (match length - minMatchLength) in the low nibble.
+    void writeSequence( std::vector< char >& output, const char* literals, const size_t literalCount, const size_t matchOffset, const size_t matchLength )
+    {
+        const size_t matchLengthCode = matchLength > 0 ? matchLength - minMatchLength : 0;
+
+        const unsigned char token = (unsigned char)( ( ( literalCount < 15 ? literalCount : 15 ) << 4 ) | ( matchLengthCode < 15 ? matchLengthCode : 15 ) );
+        output.push_back( (char)token );
+
+        if ( literalCount >= 15 )
+            writeLength( output, literalCount - 15 );
+
+        output.insert( output.end(), literals, literals + literalCount );
+
+        // Last sequence in the stream has no match.
+        if ( matchLength == 0 )
+            return;
+
+        output.push_back( (char)( matchOffset & 0xFF ) );
+        output.push_back( (char)( ( matchOffset >> 8 ) & 0xFF ) );
+
+        if ( matchLengthCode >= 15 )
+            writeLength( output, matchLengthCode - 15 );
+    }
+}
+
+std::vector< char > CompressionUtil::compress( const char* data, const size_t size )
+{
+    std::vector< char > output;
+    output.reserve( size / 2 + 16 );
+
+    // Last position at which each hashed 4-byte sequence was seen.
+    std::vector< long long > hashTable( (size_t)1 << hashTableBits, -1 );
+
+    size_t position = 0;
+    size_t anchor   = 0; // Start of not yet written literals.
+
+    while ( position + minMatchLength <= size )
+    {
+        const unsigned int sequence = readUint32( data + position );
+        const unsigned int hash     = hashSequence( sequence );
+
+        const long long candidate = hashTable[ hash ];
+        hashTable[ hash ] = (long long)position;
+
+        if ( candidate >= 0
+             && position - (size_t)candidate <= maxMatchOffset
+             && readUint32( data + candidate ) == sequence )
+        {
+            size_t matchLength = minMatchLength;
+            while ( position + matchLength < size && data[ candidate + matchLength ] == data[ position + matchLength ] )
+                ++matchLength;
+
+            writeSequence( output, data + anchor, position - anchor, position - (size_t)candidate, matchLength );
+
+            position += matchLength;
+            anchor    = position;
+        }
+        else
+        {
+            ++position;
+        }
+    }
+
+    // Write remaining literals (may be an empty sequence).
+    writeSequence( output, data + anchor, size - anchor, 0, 0 );
+
+    return output;
+}
+
+void CompressionUtil::decompress( const char* compressedData, const size_t compressedSize, char* decompressedData, const size_t decompressedSize )
+{
+    const unsigned char* inputIt  = reinterpret_cast< const unsigned char* >( compressedData );
+    const unsigned char* inputEnd = inputIt + compressedSize;
+
+    char*       outputIt  = decompressedData;
+    char* const outputEnd = decompressedData + decompressedSize;
+
+    while ( inputIt < inputEnd )
+    {
+        const unsigned char token = *inputIt++;
+
+        // Copy literals.
+        size_t literalCount = token >> 4;
+        if ( literalCount == 15 )
+            literalCount += readLength( inputIt, inputEnd );
+
+        if ( literalCount > (size_t)( inputEnd - inputIt ) || literalCount > (size_t)( outputEnd - outputIt ) )
+            throw std::exception( "CompressionUtil::decompress - corrupted data (literals out of bounds)." );
+
+        std::memcpy( outputIt, inputIt, literalCount );
+        inputIt  += literalCount;
+        outputIt += literalCount;
+
+        // Last sequence has no match.
+        if ( inputIt == inputEnd )
+            break;
+
+        if ( inputEnd - inputIt < 2 )
+            throw std::exception( "CompressionUtil::decompress - corrupted data (match offset out of bounds)." );
+
+        const size_t matchOffset = (size_t)inputIt[ 0 ] | ( (size_t)inputIt[ 1 ] << 8 );
+        inputIt += 2;
+
+        size_t matchLength = token & 0x0F;
+        if ( matchLength == 15 )
+            matchLength += readLength( inputIt, inputEnd );
+
+        matchLength += minMatchLength;
+
+        if ( matchOffset == 0 || matchOffset > (size_t)( outputIt - decompressedData ) || matchLength > (size_t)( outputEnd - outputIt ) )
+            throw std::exception( "CompressionUtil::decompress - corrupted data (match out of bounds)." );
+
+        // Copy match. Note: Source and destination can overlap - copy byte by byte in that case.
+        const char* matchIt = outputIt - matchOffset;
+        if ( matchOffset >= matchLength ) {
+            std::memcpy( outputIt, matchIt, matchLength );
+            outputIt += matchLength;
+        } else {
+            for ( size_t i = 0; i < matchLength; ++i )
+                *outputIt++ = *matchIt++;
+        }
+    }
+
+    if ( outputIt != outputEnd )
+        throw std::exception( "CompressionUtil::decompress - decompressed size doesn't match the expected size." );
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+namespace Engine1
+{
+    // Simple and fast LZ77-style byte compression (block format similar to LZ4).
+    // Meant for asset data, where decompression speed matters much more than compression ratio.
+    class CompressionUtil
+    {
+        public:
+
+        static std::vector< char > compress( const char* data, const size_t size );
+
+        // Throws if the compressed data is corrupted or doesn't decompress exactly to 'decompressedSize' bytes.
+        static void decompress( const char* compressedData, const size_t compressedSize, char* decompressedData, const size_t decompressedSize );
+
+        private:
+
+        CompressionUtil() {};
+        ~CompressionUtil() {};
+    };
+}
+
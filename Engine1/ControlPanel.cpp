@@ -11,6 +11,7 @@
 #include "Settings.h"
 #include "Scene.h"
 #include "FileUtil.h"
+#include "StringUtil.h"
 
 using namespace Engine1;
 
@@ -71,6 +72,7 @@ void ControlPanel::initialize( Microsoft::WRL::ComPtr< ID3D11Device3 >& device,
     TwAddButton( m_meshUtilsBar, "Flip Tangents", ControlPanel::onFlipTangents, this, "" );
     TwAddButton( m_meshUtilsBar, "Flip Normals", ControlPanel::onFlipNormals, this, "" );
     TwAddButton( m_meshUtilsBar, "Invert vertex winding order", ControlPanel::onInvertVertexWindingOrder, this, "" );
+    TwAddButton( m_meshUtilsBar, "Switch vertex layout", ControlPanel::onSwitchVertexLayout, this, "" );
 
     m_lightBar = TwNewBar("Light");
     TwDefine(" Light iconified=true ");
@@ -154,6 +156,8 @@ void ControlPanel::initialize( Microsoft::WRL::ComPtr< ID3D11Device3 >& device,
     TwAddButton( m_profilingBar, "Next - reflection", ControlPanel::onDisplayNextStageProfilingReflection, nullptr, "" );
     TwAddButton( m_profilingBar, "Next - transmission", ControlPanel::onDisplayNextStageProfilingTransmission, nullptr, "" );
     TwAddButton( m_profilingBar, "Back", ControlPanel::onDisplayPrevStageProfiling, nullptr, "" );
+    TwAddVarCB( m_profilingBar, "Record asset loading", TW_TYPE_BOOL8, ControlPanel::onSetRecordAssetLoadStats, ControlPanel::onGetRecordAssetLoadStats, this, "" );
+    TwAddButton( m_profilingBar, "Export asset loading", ControlPanel::onExportAssetLoadStats, this, "" );
 
     m_assaoBar = TwNewBar("ASSAO");
     TwDefine(" ASSAO iconified=true ");
@@ -398,6 +402,14 @@ void TW_CALL ControlPanel::onInvertVertexWindingOrder( void* controlPanel )
     ( (ControlPanel*)controlPanel )->m_sceneManager.invertVertexWindingOrderAndResaveMesh();
 }
 
+void TW_CALL ControlPanel::onSwitchVertexLayout( void* controlPanel )
+{
+    if ( !controlPanel )
+        return;
+
+    ( (ControlPanel*)controlPanel )->m_sceneManager.switchVertexLayoutAndResaveMesh();
+}
+
 void TW_CALL ControlPanel::onDisplayNextStageProfilingReflection( void* clientData )
 {
     clientData; // Unused.
@@ -428,6 +440,38 @@ void TW_CALL ControlPanel::onDisplayPrevStageProfiling( void* clientData )
     Settings::modify().onChanged();
 }
 
+void TW_CALL ControlPanel::onSetRecordAssetLoadStats( const void* value, void* controlPanel )
+{
+    auto& panel = *static_cast<ControlPanel*>( controlPanel );
+
+    Settings::s_settings.debug.recordAssetLoadStats = *(bool*)value;
+
+    panel.m_assetManager.getLoadStats().setEnabled( settings().debug.recordAssetLoadStats );
+}
+
+void TW_CALL ControlPanel::onGetRecordAssetLoadStats( void* value, void* /*controlPanel*/ )
+{
+    *(bool*)value = settings().debug.recordAssetLoadStats;
+}
+
+void TW_CALL ControlPanel::onExportAssetLoadStats( void* controlPanel )
+{
+    auto& panel = *static_cast<ControlPanel*>( controlPanel );
+
+    const AssetLoadStats& loadStats = panel.m_assetManager.getLoadStats();
+    const std::string     path      = settings().paths.assetLoadStats;
+
+    try {
+        loadStats.saveToChromeTrace( path + "Trace.json" );
+        loadStats.saveToCsv( path + ".csv" );
+        loadStats.saveSamplesToCsv( path + "Samples.csv" );
+
+        OutputDebugStringW( StringUtil::widen( "\nControlPanel::onExportAssetLoadStats - saved to " + path + "*.\n" ).c_str() );
+    } catch ( const std::exception& ex ) {
+        OutputDebugStringW( StringUtil::widen( "\nControlPanel::onExportAssetLoadStats - " + std::string( ex.what() ) + "\n" ).c_str() );
+    }
+}
+
 void TW_CALL ControlPanel::onAddTestCase( void* controlPanel )
 {
     auto& panel = *static_cast<ControlPanel*>( controlPanel );
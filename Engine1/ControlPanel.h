@@ -59,11 +59,16 @@ namespace Engine1
         static void TW_CALL onFlipTangents( void* controlPanel );
         static void TW_CALL onFlipNormals( void* controlPanel );
         static void TW_CALL onInvertVertexWindingOrder( void* controlPanel );
+        static void TW_CALL onSwitchVertexLayout( void* controlPanel );
 
         static void TW_CALL onDisplayNextStageProfilingReflection( void* clientData );
         static void TW_CALL onDisplayNextStageProfilingTransmission( void* clientData );
         static void TW_CALL onDisplayPrevStageProfiling( void* clientData );
 
+        static void TW_CALL onSetRecordAssetLoadStats( const void* value, void* controlPanel );
+        static void TW_CALL onGetRecordAssetLoadStats( void* value, void* controlPanel );
+        static void TW_CALL onExportAssetLoadStats( void* controlPanel );
+
         static void TW_CALL onAddTestCase( void* controlPanel );
         static void TW_CALL onSwitchToTestAssets( void* controlPanel );
         static void TW_CALL onGenerateReference( void* controlPanel );
@@ -531,7 +531,41 @@ void DX11RendererCore::draw( const BlockMesh& mesh )
 	if ( !m_deviceContext ) throw std::exception( "Direct3DRendererCore::draw - renderer not initialized." );
 	if ( !mesh.isInGpuMemory() ) throw std::exception( "Direct3DRenderer::drawBlockMesh - mesh hasn't been loaded to GPU yet" );
 
-	{ // set mesh buffers
+	if ( mesh.getInterleavedVertexBuffer() ) { // set interleaved mesh buffers - the same buffer is bound to many slots with different offsets
+		const BlockMesh::InterleavedVertexFormat& format = mesh.getInterleavedVertexFormat();
+		ID3D11Buffer* interleavedBuffer = mesh.getInterleavedVertexBuffer();
+
+		unsigned int  bufferCount = 0;
+		unsigned int  strides[ 4 ];
+		unsigned int  offsets[ 4 ];
+		ID3D11Buffer* buffers[ 4 ];
+
+		const auto addBuffer = [ & ]( ID3D11Buffer* buffer, const unsigned int stride, const unsigned int offset ) {
+			buffers[ bufferCount ] = buffer;
+			strides[ bufferCount ] = stride;
+			offsets[ bufferCount ] = offset;
+			++bufferCount;
+		};
+
+		if ( format.positionOffset >= 0 )
+			addBuffer( interleavedBuffer, format.stride, format.positionOffset );
+		else
+			addBuffer( mesh.getVertexBuffer(), sizeof( float3 ), 0 );
+
+		// Same combinations of attributes as for separate buffers.
+		if ( format.normalOffset >= 0 ) {
+			addBuffer( interleavedBuffer, format.stride, format.normalOffset );
+
+			if ( format.tangentOffset >= 0 && format.texcoordOffset >= 0 ) {
+				addBuffer( interleavedBuffer, format.stride, format.tangentOffset );
+				addBuffer( interleavedBuffer, format.stride, format.texcoordOffset );
+			}
+		}
+
+		m_deviceContext->IASetVertexBuffers( 0, bufferCount, buffers, strides, offsets );
+		m_deviceContext->IASetIndexBuffer( mesh.getTriangleBuffer(), DXGI_FORMAT_R32_UINT, 0 );
+		m_deviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+	} else { // set mesh buffers
 		if ( mesh.getVertexBuffer() && mesh.getNormalBuffer() && mesh.getTangentBuffer() && mesh.getTexcoordBuffers().size() > 0 && mesh.getTexcoordBuffers().front() ) {
 			const unsigned int bufferCount = 4;
 			unsigned int strides[ bufferCount ] = { sizeof( float3 ), sizeof( float3 ), sizeof( float3 ), sizeof( float2 ) };
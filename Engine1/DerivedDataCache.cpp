@@ -0,0 +1,242 @@
+#include "DerivedDataCache.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "BlockMesh.h"
+#include "MeshFileParser.h"
+#include "MeshUtil.h"
+#include "BVHTreeBuffer.h"
+
+#include "BinaryFile.h"
+#include "FileSystem.h"
+#include "HashUtil.h"
+#include "StringUtil.h"
+
+#include <windows.h>
+
+using namespace Engine1;
+
+const char DerivedDataCache::s_magic[ 4 ] = { 'E', '1', 'D', 'C' };
+const int  DerivedDataCache::s_version    = 2; // 2 - 64-bit mesh sizes.
+
+std::string DerivedDataCache::s_directory = "DerivedDataCache";
+bool        DerivedDataCache::s_enabled   = false;
+
+void DerivedDataCache::setDirectory( const std::string& directory )
+{
+    s_directory = directory;
+}
+
+const std::string& DerivedDataCache::getDirectory()
+{
+    return s_directory;
+}
+
+void DerivedDataCache::setEnabled( const bool enabled )
+{
+    s_enabled = enabled;
+}
+
+bool DerivedDataCache::isEnabled()
+{
+    return s_enabled;
+}
+
+std::vector< std::shared_ptr< BlockMesh > > DerivedDataCache::getOrImportBlockMeshes( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt,
+                                                                                      const BlockMeshFileInfo::Format format, const bool invertZCoordinate,
+                                                                                      const bool invertVertexWindingOrder, const bool flipUVs )
+{
+    if ( !s_enabled )
+        return importBlockMeshes( dataIt, dataEndIt, format, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+
+    Header key;
+    std::memset( &key, 0, sizeof( Header ) );
+    key.sourceHash     = HashUtil::hash64( dataIt != dataEndIt ? &( *dataIt ) : nullptr, dataEndIt - dataIt );
+    key.format         = (int)format;
+    key.importFlags    = ( invertZCoordinate ? 1 : 0 ) | ( invertVertexWindingOrder ? 2 : 0 ) | ( flipUVs ? 4 : 0 );
+    key.builderVersion = blockMeshBuilderVersion;
+
+    std::vector< std::shared_ptr< BlockMesh > > meshes;
+
+    // Note: Files without any meshes are cached too - they would be imported again every time otherwise.
+    if ( loadBlockMeshes( key, meshes ) )
+        return meshes;
+
+    meshes = importBlockMeshes( dataIt, dataEndIt, format, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+
+    try
+    {
+        saveBlockMeshes( key, meshes );
+    }
+    catch ( std::exception& ex )
+    {
+        // Failing to save to cache is not critical - the meshes were imported correctly.
+        OutputDebugStringW( StringUtil::widen(
+            "DerivedDataCache::getOrImportBlockMeshes - failed to save cache entry.\nException: "
+            + std::string( ex.what() ) + ".\n"
+        ).c_str() );
+    }
+
+    return meshes;
+}
+
+std::vector< std::shared_ptr< BlockMesh > > DerivedDataCache::importBlockMeshes( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt,
+                                                                                 const BlockMeshFileInfo::Format format, const bool invertZCoordinate,
+                                                                                 const bool invertVertexWindingOrder, const bool flipUVs )
+{
+    std::vector< std::shared_ptr< BlockMesh > > meshes 
+        = MeshFileParser::parseBlockMeshFile( format, dataIt, dataEndIt, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+
+    for ( auto& mesh : meshes )
+    {
+        if ( mesh->getTriangles().empty() )
+            continue;
+
+        mesh->buildBvhTree();
+
+        const MeshUtil::VertexCacheStats statsBefore = MeshUtil::calculateVertexCacheStats( *mesh );
+
+        MeshUtil::optimizeForRasterization( *mesh );
+
+        const MeshUtil::VertexCacheStats statsAfter = MeshUtil::calculateVertexCacheStats( *mesh );
+
+        OutputDebugStringW( StringUtil::widen(
+            "DerivedDataCache::importBlockMeshes - optimized mesh for rasterization. ACMR: " + std::to_string( statsBefore.acmr ) + " -> " + std::to_string( statsAfter.acmr )
+            + ", ATVR: " + std::to_string( statsBefore.atvr ) + " -> " + std::to_string( statsAfter.atvr ) + ".\n"
+        ).c_str() );
+
+        // Built after vertices are reordered - meshlet vertices are then close to each other in memory.
+        mesh->buildMeshlets();
+    }
+
+    return meshes;
+}
+
+std::string DerivedDataCache::getEntryPath( const Header& key )
+{
+    unsigned long long entryHash = key.sourceHash;
+    entryHash = HashUtil::combine( entryHash, (unsigned long long)key.format );
+    entryHash = HashUtil::combine( entryHash, (unsigned long long)key.importFlags );
+    entryHash = HashUtil::combine( entryHash, (unsigned long long)key.builderVersion );
+
+    return s_directory + "\\" + HashUtil::toHexString( entryHash ) + ".blockmeshcache";
+}
+
+bool DerivedDataCache::loadBlockMeshes( const Header& key, std::vector< std::shared_ptr< BlockMesh > >& meshes )
+{
+    meshes.clear();
+
+    const std::string path = getEntryPath( key );
+
+    if ( !FileSystem::exists( path ) )
+        return false;
+
+    try
+    {
+        const std::shared_ptr< std::vector< char > > data = BinaryFile::load( path );
+
+        if ( data->size() < sizeof( Header ) )
+            throw std::exception( "DerivedDataCache::loadBlockMeshes - entry is too small." );
+
+        Header header;
+        std::memcpy( &header, data->data(), sizeof( Header ) );
+
+        const bool keyMatches =
+            std::memcmp( header.magic, s_magic, sizeof( s_magic ) ) == 0
+            && header.version        == s_version
+            && header.sourceHash     == key.sourceHash
+            && header.format         == key.format
+            && header.importFlags    == key.importFlags
+            && header.builderVersion == key.builderVersion
+            && header.payloadSize    == data->size() - sizeof( Header );
+
+        if ( !keyMatches )
+            throw std::exception( "DerivedDataCache::loadBlockMeshes - entry doesn't match the key." );
+
+        if ( HashUtil::hash64( data->data() + sizeof( Header ), (size_t)header.payloadSize ) != header.payloadHash )
+            throw std::exception( "DerivedDataCache::loadBlockMeshes - entry is corrupted." );
+
+        std::vector< char >::const_iterator dataIt    = data->cbegin() + sizeof( Header );
+        std::vector< char >::const_iterator dataEndIt = data->cend();
+
+        for ( int meshIndex = 0; meshIndex < header.meshCount; ++meshIndex )
+        {
+            if ( dataEndIt - dataIt < (long long)sizeof( long long ) )
+                throw std::exception( "DerivedDataCache::loadBlockMeshes - unexpected end of entry." );
+
+            const long long meshDataSize = BinaryFile::readLongLong( dataIt );
+
+            if ( meshDataSize < 0 || meshDataSize > dataEndIt - dataIt )
+                throw std::exception( "DerivedDataCache::loadBlockMeshes - invalid mesh size." );
+
+            std::vector< char >::const_iterator meshDataEndIt = dataIt + (size_t)meshDataSize;
+
+            std::vector< std::shared_ptr< BlockMesh > > parsedMeshes
+                = MeshFileParser::parseBlockMeshFile( BlockMeshFileInfo::Format::BLOCKMESH, dataIt, meshDataEndIt, false, false, false );
+
+            meshes.push_back( parsedMeshes.front() );
+
+            dataIt = meshDataEndIt;
+        }
+
+        if ( dataIt != dataEndIt )
+            throw std::exception( "DerivedDataCache::loadBlockMeshes - unexpected data at the end of entry." );
+
+        OutputDebugStringW( StringUtil::widen( "DerivedDataCache::loadBlockMeshes - cache hit \"" + path + "\"\n" ).c_str() );
+
+        return true;
+    }
+    catch ( std::exception& ex )
+    {
+        meshes.clear();
+
+        OutputDebugStringW( StringUtil::widen(
+            "DerivedDataCache::loadBlockMeshes - failed to read \"" + path + "\" - treated as a cache miss.\nException: "
+            + std::string( ex.what() ) + ".\n"
+        ).c_str() );
+
+        return false;
+    }
+}
+
+void DerivedDataCache::saveBlockMeshes( const Header& key, const std::vector< std::shared_ptr< BlockMesh > >& meshes )
+{
+    static std::atomic< unsigned int > tempFileCounter( 0 );
+
+    std::vector< char > data;
+    data.resize( sizeof( Header ) );
+
+    std::vector< char > meshData;
+    for ( const auto& mesh : meshes )
+    {
+        meshData.clear();
+        MeshFileParser::writeBlockMeshFile( meshData, BlockMeshFileInfo::Format::BLOCKMESH, *mesh );
+
+        BinaryFile::writeLongLong( data, (long long)meshData.size() );
+        data.insert( data.end(), meshData.begin(), meshData.end() );
+    }
+
+    Header header = key;
+    std::memcpy( header.magic, s_magic, sizeof( s_magic ) );
+    header.version     = s_version;
+    header.meshCount   = (int)meshes.size();
+    header.payloadSize = data.size() - sizeof( Header );
+    header.payloadHash = HashUtil::hash64( data.data() + sizeof( Header ), (size_t)header.payloadSize );
+    std::memcpy( data.data(), &header, sizeof( Header ) );
+
+    FileSystem::createDirectories( s_directory );
+
+    // Write to a temporary file, unique for the process and thread, then atomically rename it.
+    const std::string path     = getEntryPath( key );
+    const std::string tempPath = path + "." + std::to_string( GetCurrentProcessId() )
+        + "_" + std::to_string( std::hash< std::thread::id >()( std::this_thread::get_id() ) )
+        + "_" + std::to_string( tempFileCounter++ ) + ".tmp";
+
+    BinaryFile::save( tempPath, data );
+
+    // Note: Fails if another process has just written (or is reading) the same entry - that's fine, the content is the same.
+    if ( !MoveFileExW( StringUtil::widen( tempPath ).c_str(), StringUtil::widen( path ).c_str(), MOVEFILE_REPLACE_EXISTING ) )
+        DeleteFileW( StringUtil::widen( tempPath ).c_str() );
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "BlockMeshFileInfo.h"
+
+namespace Engine1
+{
+    class BlockMesh;
+
+    // Stores results of expensive asset processing (ex: importing a mesh with Assimp and building its BVH tree) on disk.
+    // Entries are keyed by the hash of the source file content, import flags and builder version,
+    // so changes to any of them automatically result in a cache miss.
+    //
+    // Cache can be shared between many processes - entries are written to a temporary file
+    // and atomically renamed, so a reader can never see a partially written entry.
+    // Entries are also validated with a hash when read - invalid entries are treated as a cache miss.
+    class DerivedDataCache
+    {
+        public:
+
+        // Increment when the mesh import or processing changes (ex: new BVH builder) to invalidate all cached meshes.
+        static const int blockMeshBuilderVersion = 5; // 2 - triangle and vertex order optimized for rasterization, 3 - native OBJ parser, 4 - meshlets, 5 - vertex welding.
+
+        static void               setDirectory( const std::string& directory );
+        static const std::string& getDirectory();
+
+        // Disabled by default, so tools and tests don't write cache entries into the current directory.
+        static void setEnabled( const bool enabled );
+        static bool isEnabled();
+
+        // Returns meshes from the cache if available. Otherwise imports them, builds their BVH trees and meshlets and stores them in the cache.
+        // Meshes are processed the same way when the cache is disabled - cached meshes are always identical to imported ones.
+        static std::vector< std::shared_ptr< BlockMesh > > getOrImportBlockMeshes( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt,
+                                                                                  const BlockMeshFileInfo::Format format, const bool invertZCoordinate,
+                                                                                  const bool invertVertexWindingOrder, const bool flipUVs );
+
+        private:
+
+        #pragma pack( push, 1 )
+        struct Header
+        {
+            char               magic[ 4 ];
+            int                version;
+            unsigned long long sourceHash;
+            int                format;
+            int                importFlags;
+            int                builderVersion;
+            int                meshCount;
+            unsigned long long payloadSize;
+            unsigned long long payloadHash;
+        };
+        #pragma pack( pop )
+
+        static std::string getEntryPath( const Header& key );
+
+        // Parses meshes and builds their BVH trees, optimizes them for rasterization and builds meshlets.
+        static std::vector< std::shared_ptr< BlockMesh > > importBlockMeshes( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt,
+                                                                             const BlockMeshFileInfo::Format format, const bool invertZCoordinate,
+                                                                             const bool invertVertexWindingOrder, const bool flipUVs );
+
+        // Returns false on a cache miss (missing or invalid entry).
+        static bool loadBlockMeshes( const Header& key, std::vector< std::shared_ptr< BlockMesh > >& meshes );
+        static void saveBlockMeshes( const Header& key, const std::vector< std::shared_ptr< BlockMesh > >& meshes );
+
+        static const char s_magic[ 4 ];
+        static const int  s_version;
+
+        static std::string s_directory;
+        static bool        s_enabled;
+
+        DerivedDataCache() {};
+        ~DerivedDataCache() {};
+    };
+}
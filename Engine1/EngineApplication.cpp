@@ -773,6 +773,10 @@ bool EngineApplication::onFrame( const double frameTimeMs, const bool lockCursor
     m_sceneManager.getActorAnimator().update( (float)frameTimeS * settings().animation.actorsPlaybackSpeed );
     m_sceneManager.getModelAnimator().update( (float)frameTimeS * settings().animation.actorsPlaybackSpeed );
 
+    // Report files which failed to save in the background.
+    for ( const auto& failedSave : m_sceneManager.takeFailedSaves() )
+        setWindowTitle( "Failed to save \"" + failedSave.path + "\": " + failedSave.error );
+
     // Set renderer exposure from settings.
     m_renderer.setExposure( settings().rendering.postProcess.exposure );
 
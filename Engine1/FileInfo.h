@@ -2,6 +2,7 @@
 
 #include <string>
 #include <memory>
+#include <atomic>
 
 #include "Asset.h"
 
@@ -27,6 +28,45 @@ namespace Engine1
         virtual bool canHaveSubAssets() const = 0; 
 
         virtual void saveToMemory( std::vector<char>& data ) const = 0;
+
+        // Computed on first use and cached - cheap to call in hot paths.
+        Asset::Id getAssetId() const
+        {
+            Asset::Id assetId = m_assetId.load( std::memory_order_relaxed );
+
+            if ( assetId == 0 ) {
+                assetId = Asset::createId( getAssetType(), getPath(), getIndexInFile() );
+                m_assetId.store( assetId, std::memory_order_relaxed );
+            }
+
+            return assetId;
+        }
+
+        protected:
+
+        FileInfo() :
+            m_assetId( 0 )
+        {}
+
+        FileInfo( const FileInfo& other ) :
+            m_assetId( other.m_assetId.load( std::memory_order_relaxed ) )
+        {}
+
+        FileInfo& operator=( const FileInfo& other )
+        {
+            m_assetId.store( other.m_assetId.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+            return *this;
+        }
+
+        // Has to be called whenever the path or index in file changes.
+        void invalidateAssetId()
+        {
+            m_assetId.store( 0, std::memory_order_relaxed );
+        }
+
+        private:
+
+        mutable std::atomic< Asset::Id > m_assetId;
     };
 }
 
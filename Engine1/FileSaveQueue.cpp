@@ -0,0 +1,157 @@
+#include "FileSaveQueue.h"
+
+#include "BinaryFile.h"
+#include "StringUtil.h"
+
+#include <windows.h>
+
+using namespace Engine1;
+
+FileSaveQueue::FileSaveQueue() :
+    m_isSaving( false ),
+    m_savingSource( nullptr ),
+    m_stop( false )
+{
+    m_thread = std::thread( &FileSaveQueue::run, this );
+}
+
+FileSaveQueue::~FileSaveQueue()
+{
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        m_stop = true;
+    }
+
+    m_tasksChanged.notify_all();
+
+    if ( m_thread.joinable() )
+        m_thread.join();
+}
+
+void FileSaveQueue::enqueue( const std::string& path, const std::function< void( const std::string& ) >& save, const void* source )
+{
+    if ( path.empty() )
+        throw std::exception( "FileSaveQueue::enqueue - empty path." );
+
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+
+        Task task = { path, save, source };
+        m_tasks.push_back( task );
+    }
+
+    m_tasksChanged.notify_all();
+}
+
+void FileSaveQueue::enqueue( const std::string& path, std::vector< char >&& data )
+{
+    // Note: Shared pointer, because std::function has to be copyable.
+    auto sharedData = std::make_shared< std::vector< char > >( std::move( data ) );
+
+    enqueue( path, [ sharedData ]( const std::string& tempPath ) { BinaryFile::save( tempPath, *sharedData ); } );
+}
+
+void FileSaveQueue::waitUntilIdle()
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+
+    m_tasksChanged.wait( lock, [ this ]() { return m_tasks.empty() && !m_isSaving; } );
+}
+
+void FileSaveQueue::waitUntilSaved( const void* source )
+{
+    if ( !source )
+        return;
+
+    std::unique_lock< std::mutex > lock( m_mutex );
+
+    m_tasksChanged.wait( lock, [ this, source ]() {
+        if ( m_isSaving && m_savingSource == source )
+            return false;
+
+        for ( const Task& task : m_tasks )
+        {
+            if ( task.source == source )
+                return false;
+        }
+
+        return true;
+    } );
+}
+
+std::vector< FileSaveQueue::FailedSave > FileSaveQueue::takeFailedSaves()
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    std::vector< FailedSave > failedSaves;
+    failedSaves.swap( m_failedSaves );
+
+    return failedSaves;
+}
+
+void FileSaveQueue::setOnSaved( const std::function< void( const std::string& ) >& onSaved )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    m_onSaved = onSaved;
+}
+
+void FileSaveQueue::run()
+{
+    while ( true )
+    {
+        Task                                         task;
+        std::function< void( const std::string& ) > onSaved;
+        {
+            std::unique_lock< std::mutex > lock( m_mutex );
+
+            // Queued tasks are finished even if stop was requested.
+            m_tasksChanged.wait( lock, [ this ]() { return !m_tasks.empty() || m_stop; } );
+
+            if ( m_tasks.empty() )
+                return;
+
+            task = std::move( m_tasks.front() );
+            m_tasks.pop_front();
+            m_isSaving     = true;
+            m_savingSource = task.source;
+            onSaved        = m_onSaved;
+        }
+
+        const std::string tempPath = task.path + ".tmp";
+
+        bool        succeeded = true;
+        std::string error;
+
+        try
+        {
+            task.save( tempPath );
+
+            if ( !MoveFileExW( StringUtil::widen( tempPath ).c_str(), StringUtil::widen( task.path ).c_str(), MOVEFILE_REPLACE_EXISTING ) )
+                throw std::exception( "FileSaveQueue::run - failed to replace the file." );
+
+            if ( onSaved )
+                onSaved( task.path );
+        }
+        catch ( std::exception& e )
+        {
+            DeleteFileW( StringUtil::widen( tempPath ).c_str() );
+
+            succeeded = false;
+            error     = e.what();
+
+            OutputDebugStringW( StringUtil::widen( "FileSaveQueue::run - failed to save \"" + task.path + "\": " + error + "\n" ).c_str() );
+        }
+
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_isSaving     = false;
+            m_savingSource = nullptr;
+
+            if ( !succeeded )
+                m_failedSaves.push_back( { task.path, error } );
+        }
+
+        m_tasksChanged.notify_all();
+    }
+}
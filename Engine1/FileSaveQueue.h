@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace Engine1
+{
+    // Saves files on a background thread, so saving (ex: scene or models in the editor) doesn't stall rendering.
+    // Files are saved in the order they were queued, so the last save of a given file always wins.
+    // Each file is written to a temporary file first and then renamed - a partially written file never replaces the previous one.
+    //
+    // Save functions are called on the background thread - data they access can't be modified until it's saved.
+    // Small data which can change in the meantime (ex: a scene) should be serialized and passed as a copy.
+    // Large data (ex: a mesh) should be passed as the source of the save instead - its edits have to wait for the save (see waitUntilSaved).
+    // Failed saves are collected, so the editor can report them (see takeFailedSaves).
+    class FileSaveQueue
+    {
+        public:
+
+        struct FailedSave
+        {
+            std::string path;
+            std::string error;
+        };
+
+        FileSaveQueue();
+        // Finishes all queued saves.
+        ~FileSaveQueue();
+
+        // Save function receives the path it should write to (a temporary file).
+        // Source - object read by the save function (optional), so its edits can wait until it's saved.
+        void enqueue( const std::string& path, const std::function< void( const std::string& ) >& save, const void* source = nullptr );
+        void enqueue( const std::string& path, std::vector< char >&& data );
+
+        // Blocks until all queued saves are finished.
+        void waitUntilIdle();
+
+        // Blocks until all queued saves reading the given source are finished. Returns immediately if there are none.
+        void waitUntilSaved( const void* source );
+
+        // Returns saves which failed since the last call. Meant to be polled by the editor (ex: once per frame).
+        std::vector< FailedSave > takeFailedSaves();
+
+        // Called on the background thread right after a file is replaced with its new version.
+        // Can be used to ignore changes made by the application itself (ex: by hot-reload).
+        void setOnSaved( const std::function< void( const std::string& ) >& onSaved );
+
+        private:
+
+        struct Task
+        {
+            std::string                                  path;
+            std::function< void( const std::string& ) > save;
+            const void*                                  source;
+        };
+
+        void run();
+
+        std::thread             m_thread;
+        std::mutex              m_mutex;
+        std::condition_variable m_tasksChanged;
+        std::deque< Task >      m_tasks;
+        bool                    m_isSaving;
+        const void*             m_savingSource;
+        bool                    m_stop;
+
+        std::vector< FailedSave >                    m_failedSaves;
+        std::function< void( const std::string& ) > m_onSaved;
+
+        // Copying is not allowed.
+        FileSaveQueue( const FileSaveQueue& ) = delete;
+        FileSaveQueue& operator=( const FileSaveQueue& ) = delete;
+    };
+}
@@ -6,11 +6,24 @@
 
 using namespace Engine1;
 
+bool FileSystem::exists( const std::string& path )
+{
+    return std::experimental::filesystem::exists( path );
+}
+
 long long FileSystem::getFileSize( const std::string& path )
 {
-    const int fileSize = (int)std::experimental::filesystem::file_size( path );
+    return (long long)std::experimental::filesystem::file_size( path );
+}
 
-    return fileSize;
+long long FileSystem::getLastWriteTime( const std::string& path )
+{
+    return (long long)std::experimental::filesystem::last_write_time( path ).time_since_epoch().count();
+}
+
+void FileSystem::createDirectories( const std::string& path )
+{
+    std::experimental::filesystem::create_directories( path );
 }
 
 std::vector< std::string > FileSystem::getAllFilesFromDirectory( std::string directoryPath )
@@ -35,3 +48,22 @@ std::vector< std::string > FileSystem::getAllFilesFromDirectory( std::string dir
 
     return std::move( searchResults );
 }
+
+void FileSystem::getDirectoryContent( const std::string& directoryPath, std::vector< std::string >& fileNames, std::vector< std::string >& subdirectoryNames )
+{
+    if ( directoryPath.empty() )
+        throw std::exception( "FileSystem::getDirectoryContent - received an empty path as argument." );
+
+    fileNames.clear();
+    subdirectoryNames.clear();
+
+    std::experimental::filesystem::directory_iterator fileIt( directoryPath );
+
+    for ( const auto& file : fileIt )
+    {
+        if ( std::experimental::filesystem::is_directory( file.status() ) )
+            subdirectoryNames.push_back( file.path().filename().string() );
+        else
+            fileNames.push_back( file.path().filename().string() );
+    }
+}
@@ -9,9 +9,19 @@ namespace Engine1
     {
         public:
 
+        static bool      exists( const std::string& path );
         static long long getFileSize( const std::string& path );
 
+        // Can only be compared with other values returned by this method.
+        static long long getLastWriteTime( const std::string& path );
+
+        // Creates the directory and all its missing parent directories.
+        static void createDirectories( const std::string& path );
+
         static std::vector< std::string > getAllFilesFromDirectory( std::string directoryPath );
+
+        // Returns names (not paths) of the files and sub-directories directly in the given directory - doesn't go into sub-directories.
+        static void getDirectoryContent( const std::string& directoryPath, std::vector< std::string >& fileNames, std::vector< std::string >& subdirectoryNames );
     };
 };
 
@@ -0,0 +1,294 @@
+#include "FileWatcher.h"
+
+#include <cstring>
+
+#include "FileSystem.h"
+#include "StringUtil.h"
+#include "AssetArchive.h"
+
+#include <windows.h>
+
+using namespace Engine1;
+
+FileWatcher::FileWatcher() :
+    m_polling( false ),
+    m_pollingInterval( 1.0f ),
+    m_executeThread( false ),
+    m_stopEvent( nullptr )
+{}
+
+FileWatcher::~FileWatcher()
+{
+    stop();
+}
+
+void FileWatcher::start( const std::string& directory, const bool forcePolling, const float pollingInterval )
+{
+    if ( directory.empty() )
+        throw std::exception( "FileWatcher::start - empty directory path passed." );
+
+    stop();
+
+    m_directory       = directory;
+    m_polling         = forcePolling;
+    m_pollingInterval = pollingInterval;
+
+    m_stopEvent = CreateEventW( nullptr, TRUE, FALSE, nullptr );
+    if ( !m_stopEvent )
+        throw std::exception( "FileWatcher::start - failed to create an event." );
+
+    m_executeThread = true;
+    m_thread = std::thread( &FileWatcher::run, this );
+}
+
+void FileWatcher::stop()
+{
+    if ( !m_thread.joinable() )
+        return;
+
+    m_executeThread = false;
+    SetEvent( m_stopEvent );
+
+    m_thread.join();
+
+    CloseHandle( m_stopEvent );
+    m_stopEvent = nullptr;
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_files.clear();
+    m_changes.clear();
+}
+
+bool FileWatcher::isWatching() const
+{
+    return m_thread.joinable();
+}
+
+bool FileWatcher::isPolling() const
+{
+    return m_polling;
+}
+
+void FileWatcher::addFile( const std::string& path )
+{
+    const long long lastWriteTime = getLastWriteTime( path );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    WatchedFile file = { path, lastWriteTime };
+    m_files.insert( std::make_pair( AssetArchive::normalizePath( path ), file ) );
+}
+
+void FileWatcher::ignoreCurrentChange( const std::string& path )
+{
+    const long long lastWriteTime = getLastWriteTime( path );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    const auto it = m_files.find( AssetArchive::normalizePath( path ) );
+    if ( it != m_files.end() )
+        it->second.lastWriteTime = lastWriteTime;
+}
+
+std::vector< std::string > FileWatcher::getChangedFiles( const float settleTime )
+{
+    const auto settledTime = std::chrono::steady_clock::now() - std::chrono::microseconds( (long long)( settleTime * 1000000.0f ) );
+
+    std::vector< std::string > settledPaths;
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+
+        for ( auto it = m_changes.begin(); it != m_changes.end(); )
+        {
+            if ( it->second <= settledTime ) {
+                settledPaths.push_back( it->first );
+                it = m_changes.erase( it );
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    std::vector< std::string > changedFiles;
+
+    for ( const std::string& normalizedPath : settledPaths )
+    {
+        std::string path;
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+
+            const auto it = m_files.find( normalizedPath );
+            if ( it == m_files.end() )
+                continue;
+
+            path = it->second.path;
+        }
+
+        // Note: Modification time is read outside of the lock, but compared and updated under it - the change may be ignored concurrently.
+        const long long lastWriteTime = getLastWriteTime( path );
+        if ( lastWriteTime < 0 )
+            continue;
+
+        std::lock_guard< std::mutex > lock( m_mutex );
+
+        // Skip files saved by the application itself and notifications not caused by a content change.
+        const auto it = m_files.find( normalizedPath );
+        if ( it == m_files.end() || it->second.lastWriteTime == lastWriteTime )
+            continue;
+
+        it->second.lastWriteTime = lastWriteTime;
+        changedFiles.push_back( path );
+    }
+
+    return changedFiles;
+}
+
+void FileWatcher::run()
+{
+    if ( !m_polling )
+        watchWithNotifications();
+
+    if ( m_polling )
+        watchWithPolling();
+}
+
+void FileWatcher::watchWithNotifications()
+{
+    HANDLE directoryHandle = CreateFileW( 
+        StringUtil::widen( m_directory ).c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr 
+    );
+
+    if ( directoryHandle == INVALID_HANDLE_VALUE ) 
+    {
+        OutputDebugStringW( StringUtil::widen( "FileWatcher::watchWithNotifications - failed to open \"" + m_directory + "\" - falling back to polling.\n" ).c_str() );
+
+        m_polling = true;
+        return;
+    }
+
+    OVERLAPPED overlapped;
+    std::memset( &overlapped, 0, sizeof( overlapped ) );
+    overlapped.hEvent = CreateEventW( nullptr, TRUE, FALSE, nullptr );
+
+    // Note: Buffer has to be DWORD-aligned.
+    std::vector< DWORD > buffer( 16 * 1024 );
+
+    const DWORD notifyFilter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_FILE_NAME;
+
+    while ( m_executeThread ) 
+    {
+        ResetEvent( overlapped.hEvent );
+
+        const BOOL readStarted = ReadDirectoryChangesW( 
+            directoryHandle, buffer.data(), (DWORD)( buffer.size() * sizeof( DWORD ) ), TRUE, notifyFilter, nullptr, &overlapped, nullptr 
+        );
+
+        // Notifications are not supported (ex: by some network drives).
+        if ( !readStarted ) 
+        {
+            OutputDebugStringW( StringUtil::widen( "FileWatcher::watchWithNotifications - notifications are not supported for \"" + m_directory + "\" - falling back to polling.\n" ).c_str() );
+
+            m_polling = true;
+            break;
+        }
+
+        HANDLE waitHandles[] = { overlapped.hEvent, (HANDLE)m_stopEvent };
+        
+        if ( WaitForMultipleObjects( 2, waitHandles, FALSE, INFINITE ) != WAIT_OBJECT_0 ) 
+        {
+            // Stop requested - cancel the pending read and wait for it to finish, as it writes to the buffer.
+            DWORD bytesReturned = 0;
+            CancelIo( directoryHandle );
+            GetOverlappedResult( directoryHandle, &overlapped, &bytesReturned, TRUE );
+            break;
+        }
+
+        DWORD bytesReturned = 0;
+        if ( !GetOverlappedResult( directoryHandle, &overlapped, &bytesReturned, FALSE ) )
+            continue;
+
+        if ( bytesReturned == 0 ) 
+        {
+            // Buffer overflow - too many changes at once and their list was lost. Find them by comparing modification times.
+            pollWatchedFiles();
+            continue;
+        }
+
+        const char* entryPtr = reinterpret_cast< const char* >( buffer.data() );
+        for ( ;; ) 
+        {
+            const FILE_NOTIFY_INFORMATION& entry = *reinterpret_cast< const FILE_NOTIFY_INFORMATION* >( entryPtr );
+
+            // Note: Files which are not watched (including directories and temporary files) are skipped in onFileChanged.
+            if ( entry.Action == FILE_ACTION_MODIFIED || entry.Action == FILE_ACTION_ADDED || entry.Action == FILE_ACTION_RENAMED_NEW_NAME ) 
+                onFileChanged( m_directory + "\\" + StringUtil::narrow( std::wstring( entry.FileName, entry.FileNameLength / sizeof( WCHAR ) ) ) );
+
+            if ( entry.NextEntryOffset == 0 )
+                break;
+
+            entryPtr += entry.NextEntryOffset;
+        }
+    }
+
+    CloseHandle( overlapped.hEvent );
+    CloseHandle( directoryHandle );
+}
+
+void FileWatcher::watchWithPolling()
+{
+    const DWORD pollingIntervalMs = (DWORD)( m_pollingInterval * 1000.0f );
+
+    while ( m_executeThread ) 
+    {
+        if ( WaitForSingleObject( (HANDLE)m_stopEvent, pollingIntervalMs ) == WAIT_OBJECT_0 )
+            break;
+
+        pollWatchedFiles();
+    }
+}
+
+void FileWatcher::pollWatchedFiles()
+{
+    // Note: Only the watched files are checked - the directory is not walked.
+    std::vector< WatchedFile > files;
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+
+        files.reserve( m_files.size() );
+        for ( const auto& file : m_files )
+            files.push_back( file.second );
+    }
+
+    for ( const WatchedFile& file : files ) 
+    {
+        const long long lastWriteTime = getLastWriteTime( file.path );
+
+        if ( lastWriteTime >= 0 && lastWriteTime != file.lastWriteTime )
+            onFileChanged( file.path );
+    }
+}
+
+void FileWatcher::onFileChanged( const std::string& path )
+{
+    const std::string normalizedPath = AssetArchive::normalizePath( path );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if ( m_files.find( normalizedPath ) == m_files.end() )
+        return;
+
+    m_changes[ normalizedPath ] = std::chrono::steady_clock::now();
+}
+
+long long FileWatcher::getLastWriteTime( const std::string& path )
+{
+    try 
+    {
+        return FileSystem::getLastWriteTime( path );
+    } 
+    catch ( ... ) 
+    {
+        return -1; // File was removed in the meantime.
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+namespace Engine1
+{
+    // Watches files (added with addFile) inside a directory for modifications on a background thread.
+    // Uses directory change notifications when available. Otherwise (or when forced) polls modification times of the watched files.
+    // A change is reported only if the file modification time differs from the last known one, so changes made by the application itself
+    // can be ignored (see ignoreCurrentChange). Other files in the directory (ex: temporary files) are ignored.
+    class FileWatcher
+    {
+        public:
+
+        FileWatcher();
+        ~FileWatcher();
+
+        void start( const std::string& directory, const bool forcePolling = false, const float pollingInterval = 1.0f );
+        // Stops watching and forgets all the watched files.
+        void stop();
+
+        bool isWatching() const;
+        bool isPolling() const;
+
+        // Path should be inside the watched directory. Can be called from any thread.
+        void addFile( const std::string& path );
+
+        // Remembers the current modification time of the file - to be called after the application saved the file itself.
+        void ignoreCurrentChange( const std::string& path );
+
+        // Returns paths of files, which were modified but haven't changed for at least 'settleTime' (in seconds).
+        // Editors often write a file in many steps - this avoids reading a partially written file.
+        // Each change is returned only once.
+        std::vector< std::string > getChangedFiles( const float settleTime = 0.2f );
+
+        private:
+
+        struct WatchedFile
+        {
+            std::string path;
+            long long   lastWriteTime;
+        };
+
+        void run();
+        void watchWithNotifications();
+        void watchWithPolling();
+
+        // Compares modification times of the watched files with the last known ones.
+        void pollWatchedFiles();
+
+        void onFileChanged( const std::string& path );
+
+        // Returns -1 if the file doesn't exist (ex: it's being replaced at the moment).
+        static long long getLastWriteTime( const std::string& path );
+
+        std::string       m_directory;
+        std::atomic<bool> m_polling;
+        float             m_pollingInterval;
+
+        std::thread       m_thread;
+        std::atomic<bool> m_executeThread;
+        void*             m_stopEvent;
+
+        std::mutex                                                                 m_mutex;
+        std::unordered_map< std::string, WatchedFile >                             m_files;   // Key - normalized path.
+        std::unordered_map< std::string, std::chrono::steady_clock::time_point > m_changes; // Time of the last change of each file. Key - normalized path.
+
+        // Copying is not allowed.
+        FileWatcher( const FileWatcher& ) = delete;
+        FileWatcher& operator=( const FileWatcher& ) = delete;
+    };
+}
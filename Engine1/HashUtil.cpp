@@ -0,0 +1,75 @@
+#include "HashUtil.h"
+
+#include <cstring>
+
+using namespace Engine1;
+
+namespace
+{
+    const unsigned long long prime1 = 0x9E3779B185EBCA87ull;
+    const unsigned long long prime2 = 0xC2B2AE3D27D4EB4Full;
+
+    // Final mixing step (from MurmurHash3) - makes every input bit affect every output bit.
+    unsigned long long finalize( unsigned long long hash )
+    {
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+
+        return hash;
+    }
+}
+
+unsigned long long HashUtil::hash64( const void* data, const size_t size, const unsigned long long seed )
+{
+    const char* bytes = static_cast< const char* >( data );
+
+    unsigned long long hash = seed ^ ( (unsigned long long)size * prime1 );
+
+    // Process 8 bytes at a time.
+    const size_t wordCount = size / sizeof( unsigned long long );
+    for ( size_t i = 0; i < wordCount; ++i )
+    {
+        unsigned long long word;
+        std::memcpy( &word, bytes + i * sizeof( unsigned long long ), sizeof( unsigned long long ) );
+
+        word *= prime2;
+        word  = ( word << 31 ) | ( word >> 33 );
+        word *= prime1;
+
+        hash ^= word;
+        hash  = ( ( hash << 27 ) | ( hash >> 37 ) ) * prime1 + prime2;
+    }
+
+    // Process remaining bytes.
+    for ( size_t i = wordCount * sizeof( unsigned long long ); i < size; ++i )
+    {
+        hash ^= (unsigned char)bytes[ i ] * prime2;
+        hash  = ( ( hash << 11 ) | ( hash >> 53 ) ) * prime1;
+    }
+
+    return finalize( hash );
+}
+
+unsigned long long HashUtil::hash64( const std::string& text, const unsigned long long seed )
+{
+    return hash64( text.data(), text.size(), seed );
+}
+
+unsigned long long HashUtil::combine( const unsigned long long hash, const unsigned long long value )
+{
+    return finalize( hash ^ ( value + prime1 + ( hash << 6 ) + ( hash >> 2 ) ) );
+}
+
+std::string HashUtil::toHexString( const unsigned long long hash )
+{
+    const char digits[] = "0123456789abcdef";
+
+    std::string text( 16, '0' );
+    for ( int i = 0; i < 16; ++i )
+        text[ 15 - i ] = digits[ ( hash >> ( i * 4 ) ) & 0xF ];
+
+    return text;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+
+namespace Engine1
+{
+    namespace HashUtil
+    {
+        // Fast, non-cryptographic 64-bit hash of a memory block.
+        // Pass the hash of previous data as 'seed' to hash data in parts.
+        unsigned long long hash64( const void* data, const size_t size, const unsigned long long seed = 0 );
+        unsigned long long hash64( const std::string& text, const unsigned long long seed = 0 );
+
+        // Mixes the value into the hash.
+        unsigned long long combine( const unsigned long long hash, const unsigned long long value );
+
+        std::string toHexString( const unsigned long long hash );
+    };
+}
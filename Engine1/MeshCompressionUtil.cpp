@@ -0,0 +1,330 @@
+#include "MeshCompressionUtil.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "CompressionUtil.h"
+
+using namespace Engine1;
+
+namespace
+{
+    float signNotZero( const float value )
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    void checkSize( const size_t size, const size_t expectedSize, const char* message )
+    {
+        if ( size < expectedSize )
+            throw std::exception( message );
+    }
+}
+
+void MeshCompressionUtil::encodePositions( std::vector< char >& data, const std::vector< float3 >& positions, const float3& boundingBoxMin, const float3& boundingBoxMax )
+{
+    const float3 extent = boundingBoxMax - boundingBoxMin;
+    const float3 scale(
+        extent.x > 0.0f ? 65535.0f / extent.x : 0.0f,
+        extent.y > 0.0f ? 65535.0f / extent.y : 0.0f,
+        extent.z > 0.0f ? 65535.0f / extent.z : 0.0f
+    );
+
+    const size_t prevDataSize = data.size();
+    data.resize( prevDataSize + positions.size() * 3 * sizeof( unsigned short ) );
+
+    unsigned short* encoded = reinterpret_cast< unsigned short* >( data.data() + prevDataSize );
+
+    for ( const float3& position : positions )
+    {
+        *encoded++ = (unsigned short)std::min( 65535.0f, std::max( 0.0f, ( position.x - boundingBoxMin.x ) * scale.x + 0.5f ) );
+        *encoded++ = (unsigned short)std::min( 65535.0f, std::max( 0.0f, ( position.y - boundingBoxMin.y ) * scale.y + 0.5f ) );
+        *encoded++ = (unsigned short)std::min( 65535.0f, std::max( 0.0f, ( position.z - boundingBoxMin.z ) * scale.z + 0.5f ) );
+    }
+}
+
+void MeshCompressionUtil::decodePositions( const char* data, const size_t size, std::vector< float3 >& positions, const int count, const float3& boundingBoxMin, const float3& boundingBoxMax )
+{
+    checkSize( size, (size_t)count * 3 * sizeof( unsigned short ), "MeshCompressionUtil::decodePositions - not enough data." );
+
+    const float3 scale = ( boundingBoxMax - boundingBoxMin ) / 65535.0f;
+
+    positions.resize( count );
+
+    const unsigned short* encoded = reinterpret_cast< const unsigned short* >( data );
+
+    for ( float3& position : positions )
+    {
+        position.x = boundingBoxMin.x + (float)encoded[ 0 ] * scale.x;
+        position.y = boundingBoxMin.y + (float)encoded[ 1 ] * scale.y;
+        position.z = boundingBoxMin.z + (float)encoded[ 2 ] * scale.z;
+
+        encoded += 3;
+    }
+}
+
+void MeshCompressionUtil::encodeUnitVectors( std::vector< char >& data, const std::vector< float3 >& vectors )
+{
+    const size_t prevDataSize = data.size();
+    data.resize( prevDataSize + vectors.size() * 2 * sizeof( short ) );
+
+    short* encoded = reinterpret_cast< short* >( data.data() + prevDataSize );
+
+    for ( const float3& vector : vectors )
+    {
+        // Project onto the octahedron and unfold its lower half.
+        const float length = std::abs( vector.x ) + std::abs( vector.y ) + std::abs( vector.z );
+
+        float x = length > 0.0f ? vector.x / length : 0.0f;
+        float y = length > 0.0f ? vector.y / length : 0.0f;
+
+        if ( vector.z < 0.0f )
+        {
+            const float foldedX = ( 1.0f - std::abs( y ) ) * signNotZero( x );
+            const float foldedY = ( 1.0f - std::abs( x ) ) * signNotZero( y );
+
+            x = foldedX;
+            y = foldedY;
+        }
+
+        *encoded++ = (short)std::round( std::min( 1.0f, std::max( -1.0f, x ) ) * 32767.0f );
+        *encoded++ = (short)std::round( std::min( 1.0f, std::max( -1.0f, y ) ) * 32767.0f );
+    }
+}
+
+void MeshCompressionUtil::decodeUnitVectors( const char* data, const size_t size, std::vector< float3 >& vectors, const int count )
+{
+    checkSize( size, (size_t)count * 2 * sizeof( short ), "MeshCompressionUtil::decodeUnitVectors - not enough data." );
+
+    vectors.resize( count );
+
+    const short* encoded = reinterpret_cast< const short* >( data );
+
+    for ( float3& vector : vectors )
+    {
+        float x = (float)encoded[ 0 ] / 32767.0f;
+        float y = (float)encoded[ 1 ] / 32767.0f;
+
+        const float z = 1.0f - std::abs( x ) - std::abs( y );
+
+        if ( z < 0.0f )
+        {
+            const float unfoldedX = ( 1.0f - std::abs( y ) ) * signNotZero( x );
+            const float unfoldedY = ( 1.0f - std::abs( x ) ) * signNotZero( y );
+
+            x = unfoldedX;
+            y = unfoldedY;
+        }
+
+        const float lengthInv = 1.0f / std::sqrt( x * x + y * y + z * z );
+
+        vector.x = x * lengthInv;
+        vector.y = y * lengthInv;
+        vector.z = z * lengthInv;
+
+        encoded += 2;
+    }
+}
+
+void MeshCompressionUtil::encodeTexcoords( std::vector< char >& data, const std::vector< float2 >& texcoords )
+{
+    const size_t prevDataSize = data.size();
+    data.resize( prevDataSize + texcoords.size() * 2 * sizeof( unsigned short ) );
+
+    unsigned short* encoded = reinterpret_cast< unsigned short* >( data.data() + prevDataSize );
+
+    for ( const float2& texcoord : texcoords )
+    {
+        *encoded++ = floatToHalf( texcoord.x );
+        *encoded++ = floatToHalf( texcoord.y );
+    }
+}
+
+void MeshCompressionUtil::decodeTexcoords( const char* data, const size_t size, std::vector< float2 >& texcoords, const int count )
+{
+    checkSize( size, (size_t)count * 2 * sizeof( unsigned short ), "MeshCompressionUtil::decodeTexcoords - not enough data." );
+
+    texcoords.resize( count );
+
+    const unsigned short* encoded = reinterpret_cast< const unsigned short* >( data );
+
+    for ( float2& texcoord : texcoords )
+    {
+        texcoord.x = halfToFloat( encoded[ 0 ] );
+        texcoord.y = halfToFloat( encoded[ 1 ] );
+
+        encoded += 2;
+    }
+}
+
+void MeshCompressionUtil::encodeTriangles( std::vector< char >& data, const std::vector< uint3 >& triangles )
+{
+    // Delta from the previous index, zig-zag encoded (small negative deltas become small numbers), as a variable-length integer.
+    std::vector< char > encoded;
+    encoded.reserve( triangles.size() * 3 * 2 );
+
+    unsigned int prevIndex = 0;
+
+    const auto encodeIndex = [ &encoded, &prevIndex ]( const unsigned int index ) {
+        const int          delta     = (int)( index - prevIndex );
+        unsigned int       value     = ( (unsigned int)delta << 1 ) ^ (unsigned int)( delta >> 31 );
+
+        while ( value >= 0x80 )
+        {
+            encoded.push_back( (char)( ( value & 0x7F ) | 0x80 ) );
+            value >>= 7;
+        }
+
+        encoded.push_back( (char)value );
+
+        prevIndex = index;
+    };
+
+    for ( const uint3& triangle : triangles )
+    {
+        encodeIndex( triangle.x );
+        encodeIndex( triangle.y );
+        encodeIndex( triangle.z );
+    }
+
+    const std::vector< char > compressed = CompressionUtil::compress( encoded.data(), encoded.size() );
+
+    // Size of the delta-encoded data followed by the compressed data.
+    const unsigned long long encodedSize = encoded.size();
+
+    const size_t prevDataSize = data.size();
+    data.resize( prevDataSize + sizeof( encodedSize ) + compressed.size() );
+
+    std::memcpy( data.data() + prevDataSize, &encodedSize, sizeof( encodedSize ) );
+
+    if ( !compressed.empty() )
+        std::memcpy( data.data() + prevDataSize + sizeof( encodedSize ), compressed.data(), compressed.size() );
+}
+
+void MeshCompressionUtil::decodeTriangles( const char* data, const size_t size, std::vector< uint3 >& triangles, const int count )
+{
+    checkSize( size, sizeof( unsigned long long ), "MeshCompressionUtil::decodeTriangles - not enough data." );
+
+    unsigned long long encodedSize = 0;
+    std::memcpy( &encodedSize, data, sizeof( encodedSize ) );
+
+    // Each index takes 1 - 5 bytes.
+    if ( encodedSize < (unsigned long long)count * 3 || encodedSize > (unsigned long long)count * 3 * 5 )
+        throw std::exception( "MeshCompressionUtil::decodeTriangles - data is corrupted." );
+
+    std::vector< char > encoded( (size_t)encodedSize );
+    CompressionUtil::decompress( data + sizeof( encodedSize ), size - sizeof( encodedSize ), encoded.data(), encoded.size() );
+
+    triangles.resize( count );
+
+    const unsigned char*       encodedIt    = reinterpret_cast< const unsigned char* >( encoded.data() );
+    const unsigned char* const encodedEndIt = encodedIt + encoded.size();
+
+    unsigned int prevIndex = 0;
+
+    const auto decodeIndex = [ & ]() {
+        unsigned int value = 0;
+        int          shift = 0;
+
+        for ( ;; )
+        {
+            if ( encodedIt == encodedEndIt || shift > 28 )
+                throw std::exception( "MeshCompressionUtil::decodeTriangles - data is corrupted." );
+
+            const unsigned char byte = *encodedIt++;
+            value |= (unsigned int)( byte & 0x7F ) << shift;
+
+            if ( ( byte & 0x80 ) == 0 )
+                break;
+
+            shift += 7;
+        }
+
+        const int delta = (int)( value >> 1 ) ^ -(int)( value & 1 );
+        prevIndex += (unsigned int)delta;
+
+        return prevIndex;
+    };
+
+    for ( uint3& triangle : triangles )
+    {
+        triangle.x = decodeIndex();
+        triangle.y = decodeIndex();
+        triangle.z = decodeIndex();
+    }
+}
+
+unsigned short MeshCompressionUtil::floatToHalf( const float value )
+{
+    unsigned int bits = 0;
+    std::memcpy( &bits, &value, sizeof( float ) );
+
+    const unsigned int sign     = ( bits >> 16 ) & 0x8000;
+    const int          exponent = (int)( ( bits >> 23 ) & 0xFF ) - 127 + 15;
+    unsigned int       mantissa = bits & 0x7FFFFF;
+
+    // NaN.
+    if ( ( bits & 0x7FFFFFFF ) > 0x7F800000 )
+        return (unsigned short)( sign | 0x7E00 );
+
+    // Infinity or too large to represent.
+    if ( exponent >= 31 )
+        return (unsigned short)( sign | 0x7C00 );
+
+    // Denormalized half or too small to represent.
+    if ( exponent <= 0 )
+    {
+        if ( exponent < -10 )
+            return (unsigned short)sign;
+
+        mantissa |= 0x800000;
+
+        const int    shift = 14 - exponent;
+        unsigned int half  = mantissa >> shift;
+
+        // Round to nearest.
+        if ( ( mantissa >> ( shift - 1 ) ) & 1 )
+            ++half;
+
+        return (unsigned short)( sign | half );
+    }
+
+    unsigned int half = sign | ( (unsigned int)exponent << 10 ) | ( mantissa >> 13 );
+
+    // Round to nearest - carry into the exponent is correct (results in the next power of two or infinity).
+    if ( mantissa & 0x1000 )
+        ++half;
+
+    return (unsigned short)half;
+}
+
+float MeshCompressionUtil::halfToFloat( const unsigned short value )
+{
+    const unsigned int sign     = ( (unsigned int)value & 0x8000 ) << 16;
+    const unsigned int exponent = ( value >> 10 ) & 0x1F;
+    const unsigned int mantissa = value & 0x3FF;
+
+    unsigned int bits = 0;
+
+    if ( exponent == 0 )
+    {
+        // Zero or denormalized half.
+        const float result = (float)mantissa * 5.9604645e-8f; // 2^-24.
+
+        return sign ? -result : result;
+    }
+    else if ( exponent == 31 )
+    {
+        bits = sign | 0x7F800000 | ( mantissa << 13 );
+    }
+    else
+    {
+        bits = sign | ( ( exponent - 15 + 127 ) << 23 ) | ( mantissa << 13 );
+    }
+
+    float result = 0.0f;
+    std::memcpy( &result, &bits, sizeof( float ) );
+
+    return result;
+}
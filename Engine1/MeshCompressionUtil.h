@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "float2.h"
+#include "float3.h"
+#include "uint3.h"
+
+namespace Engine1
+{
+    // Compact encodings of mesh vertex and index streams. Used by the own mesh file format.
+    // Positions, normals, tangents and texcoords are lossy (quantized). Triangles are lossless.
+    class MeshCompressionUtil
+    {
+        public:
+
+        // Each coordinate quantized to 16 bits relative to the bounding box.
+        static void encodePositions( std::vector< char >& data, const std::vector< float3 >& positions, const float3& boundingBoxMin, const float3& boundingBoxMax );
+        static void decodePositions( const char* data, const size_t size, std::vector< float3 >& positions, const int count, const float3& boundingBoxMin, const float3& boundingBoxMax );
+
+        // Unit vectors - octahedral encoding, 16 bits per component (32 bits per vector).
+        static void encodeUnitVectors( std::vector< char >& data, const std::vector< float3 >& vectors );
+        static void decodeUnitVectors( const char* data, const size_t size, std::vector< float3 >& vectors, const int count );
+
+        // Half-precision floats.
+        static void encodeTexcoords( std::vector< char >& data, const std::vector< float2 >& texcoords );
+        static void decodeTexcoords( const char* data, const size_t size, std::vector< float2 >& texcoords, const int count );
+
+        // Indices are delta-encoded (relative to the previous index) as variable-length integers, then compressed.
+        static void encodeTriangles( std::vector< char >& data, const std::vector< uint3 >& triangles );
+        static void decodeTriangles( const char* data, const size_t size, std::vector< uint3 >& triangles, const int count );
+
+        private:
+
+        static unsigned short floatToHalf( const float value );
+        static float          halfToFloat( const unsigned short value );
+
+        MeshCompressionUtil() {};
+        ~MeshCompressionUtil() {};
+    };
+}
@@ -1,11 +1,23 @@
 #include "MeshFileParser.h"
 
 #include <algorithm>
+#include <climits>
+#include <functional>
+#include <list>
 
 #include "BlockMesh.h"
 #include "SkeletonMesh.h"
 
 #include "BVHTreeBufferParser.h"
+#include "BinaryFileReader.h"
+#include "BinaryFileWriter.h"
+#include "BVHTreeBuffer.h"
+#include "MeshletBuffer.h"
+#include "MeshCompressionUtil.h"
+#include "MeshUtil.h"
+#include "MathUtil.h"
+#include "ObjFileParser.h"
+#include "StringUtil.h"
 
 #include "Assimp/Importer.hpp"
 #include "Assimp/Exporter.hpp"
@@ -14,8 +26,16 @@
 
 #include "float44.h"
 
+#include <windows.h>
+
 using namespace Engine1;
 
+const size_t MeshFileParser::s_fileSectionAlignment     = 64;
+const int    MeshFileParser::s_blockMeshFileMagic        = 'E' | ( '1' << 8 ) | ( 'B' << 16 ) | ( 'M' << 24 );
+const int    MeshFileParser::s_blockMeshFileVersion      = 2;
+const int    MeshFileParser::s_skeletonMeshFileMagic     = 'E' | ( '1' << 8 ) | ( 'S' << 16 ) | ( 'M' << 24 );
+const int    MeshFileParser::s_skeletonMeshFileVersion   = 1;
+
 std::vector< std::shared_ptr<BlockMesh> > MeshFileParser::parseBlockMeshFile( BlockMeshFileInfo::Format format, std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
 {
     if ( format == BlockMeshFileInfo::Format::BLOCKMESH )
@@ -26,20 +46,33 @@ std::vector< std::shared_ptr<BlockMesh> > MeshFileParser::parseBlockMeshFile( Bl
 
         return meshes;
     }
+    else if ( format == BlockMeshFileInfo::Format::OBJ )
+        return ObjFileParser::parseBlockMeshFile( dataIt, dataEndIt, invertZCoordinate, invertVertexWindingOrder, flipUVs );
     else
         return parseBlockMeshFileAssimp( format, dataIt, dataEndIt, invertZCoordinate, invertVertexWindingOrder, flipUVs );
 }
 
-std::vector< std::shared_ptr<SkeletonMesh> > MeshFileParser::parseSkeletonMeshFile( std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
+std::shared_ptr<BlockMesh> MeshFileParser::parseBlockMeshFile( BinaryFileReader& reader )
 {
-    // #TODO: Should also handle own format parsing.
-    return parseSkeletonMeshFileAssimp( dataIt, dataEndIt, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+    return parseBlockMeshFileOwnFormat( reader );
 }
 
-std::vector< std::shared_ptr<BlockMesh> > MeshFileParser::parseBlockMeshFileAssimp( BlockMeshFileInfo::Format format, std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
+std::vector< std::shared_ptr<SkeletonMesh> > MeshFileParser::parseSkeletonMeshFile( SkeletonMeshFileInfo::Format format, std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
 {
-    std::vector< std::shared_ptr<BlockMesh> > meshes;
+    if ( format == SkeletonMeshFileInfo::Format::SKELETONMESH )
+    {
+        BinaryFileReader reader( dataIt, dataEndIt );
+
+        std::vector< std::shared_ptr<SkeletonMesh> > meshes = { parseSkeletonMeshFileOwnFormat( reader ) };
+
+        return meshes;
+    }
+    else
+        return parseSkeletonMeshFileAssimp( dataIt, dataEndIt, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+}
 
+std::vector< std::shared_ptr<BlockMesh> > MeshFileParser::parseBlockMeshFileAssimp( BlockMeshFileInfo::Format format, std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
+{
     Assimp::Importer importer;
 
     unsigned int flags = aiProcess_Triangulate | aiProcess_CalcTangentSpace;
@@ -56,11 +89,20 @@ std::vector< std::shared_ptr<BlockMesh> > MeshFileParser::parseBlockMeshFileAssi
 
     if ( !aiscene ) throw std::exception( ( "MeshFileParser::parseBlockMeshFile - parsing failed - " + std::string( importer.GetErrorString() ) ).c_str() );
 
-    for ( unsigned int meshIndex = 0; meshIndex < aiscene->mNumMeshes; ++meshIndex ) {
+    return createBlockMeshes( *aiscene );
+}
+
+std::vector< std::shared_ptr<BlockMesh> > MeshFileParser::createBlockMeshes( const aiScene& aiscene )
+{
+    std::vector< std::shared_ptr<BlockMesh> > meshes;
+
+    MeshUtil::VertexWeldStats weldStats = { 0, 0, 0, 0.0f }; // Summed for all meshes in the file.
+
+    for ( unsigned int meshIndex = 0; meshIndex < aiscene.mNumMeshes; ++meshIndex ) {
         meshes.push_back( std::make_shared<BlockMesh>() );
         BlockMesh& mesh = *meshes.back();
 
-        aiMesh& aimesh = *aiscene->mMeshes[ meshIndex ];
+        const aiMesh& aimesh = *aiscene.mMeshes[ meshIndex ];
 
         mesh.m_vertices.reserve( aimesh.mNumVertices );
         for ( unsigned int i = 0; i < aimesh.mNumVertices; ++i ) mesh.m_vertices.push_back( *(float3*)&aimesh.mVertices[ i ] );
@@ -88,6 +130,26 @@ std::vector< std::shared_ptr<BlockMesh> > MeshFileParser::parseBlockMeshFileAssi
         for ( unsigned int i = 0; i < aimesh.mNumFaces; ++i ) {
             mesh.m_triangles.push_back( *reinterpret_cast<uint3*>( aimesh.mFaces[ i ].mIndices ) );
         }
+
+        // Identical vertices are not joined by Assimp (aiProcess_JoinIdenticalVertices isn't used) - weld them here, in parallel and with epsilons.
+        const MeshUtil::VertexWeldStats meshWeldStats = MeshUtil::weldVertices( mesh );
+
+        weldStats.vertexCountBefore    += meshWeldStats.vertexCountBefore;
+        weldStats.vertexCountAfter     += meshWeldStats.vertexCountAfter;
+        weldStats.removedTriangleCount += meshWeldStats.removedTriangleCount;
+    }
+
+    // Note: Logged once per file - files can contain thousands of meshes.
+    if ( weldStats.vertexCountBefore > 0 )
+    {
+        weldStats.reductionRatio = 1.0f - (float)weldStats.vertexCountAfter / (float)weldStats.vertexCountBefore;
+
+        OutputDebugStringW( StringUtil::widen(
+            "MeshFileParser::createBlockMeshes - welded vertices in " + std::to_string( meshes.size() ) + " meshes: " 
+            + std::to_string( weldStats.vertexCountBefore ) + " -> " + std::to_string( weldStats.vertexCountAfter )
+            + " (" + std::to_string( (int)( weldStats.reductionRatio * 100.0f ) ) + "% less)"
+            + ", removed degenerate triangles: " + std::to_string( weldStats.removedTriangleCount ) + ".\n"
+        ).c_str() );
     }
 
     for ( std::shared_ptr<BlockMesh>& mesh : meshes )
@@ -98,93 +160,175 @@ std::vector< std::shared_ptr<BlockMesh> > MeshFileParser::parseBlockMeshFileAssi
 
 std::shared_ptr<BlockMesh> MeshFileParser::parseBlockMeshFileOwnFormat( std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt )
 {
-    std::shared_ptr< BlockMesh > mesh = std::make_shared< BlockMesh >();
+    BinaryFileReader reader( dataIt, dataEndIt );
 
-    const int dataSize = (int)( dataEndIt - dataIt ) / sizeof( char );
+    return parseBlockMeshFileOwnFormat( reader );
+}
+
+std::shared_ptr<BlockMesh> MeshFileParser::parseBlockMeshFileOwnFormat( BinaryFileReader& reader )
+{
+    // Version 1 files have no header - they start with the vertex count.
+    const int firstValue = reader.read< int >();
 
-    std::vector<char>::const_iterator dataCurrIt = dataIt;
+    if ( firstValue == s_blockMeshFileMagic )
+        return parseBlockMeshFileOwnFormatV2( reader );
+    else
+        return parseBlockMeshFileOwnFormatV1( reader, firstValue );
+}
 
-    // Read vertex count.
-    int vertexCount = 0; 
-    std::memcpy( &vertexCount, &(*dataCurrIt), sizeof( int ) );
-    dataCurrIt += sizeof( int );
+std::shared_ptr<BlockMesh> MeshFileParser::parseBlockMeshFileOwnFormatV1( BinaryFileReader& reader, const int vertexCount )
+{
+    std::shared_ptr< BlockMesh > mesh = std::make_shared< BlockMesh >();
 
     // Read vertices.
-    mesh->m_vertices.resize( vertexCount );
-    const int verticesDataSize = vertexCount * sizeof( float3 );
-    std::memcpy( mesh->m_vertices.data(), &(*dataCurrIt), verticesDataSize );
-    dataCurrIt += verticesDataSize;
-
-    // Read normals count.
-    int normalsCount = 0; 
-    std::memcpy( &normalsCount, &( *dataCurrIt ), sizeof( int ) );
-    dataCurrIt += sizeof( int );
+    reader.readArray( mesh->m_vertices, vertexCount );
 
     // Read normals.
-    mesh->m_normals.resize( normalsCount );
-    const int normalsDataSize = normalsCount * sizeof( float3 );
-    std::memcpy( mesh->m_normals.data(), &( *dataCurrIt ), normalsDataSize );
-    dataCurrIt += normalsDataSize;
-
-    // Read tangents count.
-    int tangentsCount = 0;
-    std::memcpy( &tangentsCount, &( *dataCurrIt ), sizeof( int ) );
-    dataCurrIt += sizeof( int );
+    const int normalsCount = reader.read< int >();
+    reader.readArray( mesh->m_normals, normalsCount );
 
     // Read tangents.
-    mesh->m_tangents.resize( tangentsCount );
-    const int tangentsDataSize = tangentsCount * sizeof( float3 );
-    std::memcpy( mesh->m_tangents.data(), &( *dataCurrIt ), tangentsDataSize );
-    dataCurrIt += tangentsDataSize;
+    const int tangentsCount = reader.read< int >();
+    reader.readArray( mesh->m_tangents, tangentsCount );
 
     // Read texcoords set count.
-    int texcoordsSetCount = 0;
-    std::memcpy( &texcoordsSetCount, &( *dataCurrIt ), sizeof( int ) );
-    dataCurrIt += sizeof( int );
+    const int texcoordsSetCount = reader.read< int >();
 
     // Read texcoords (all sets).
     mesh->m_texcoords.resize( texcoordsSetCount );
     for ( auto& texcoords : mesh->m_texcoords )
     {
-        // Read texcoords count.
-        int texcoordsCount = 0;
-        std::memcpy( &texcoordsCount, &( *dataCurrIt ), sizeof( int ) );
-        dataCurrIt += sizeof( int );
-
-        // Read tangents.
-        texcoords.resize( texcoordsCount );
-        const int texcoordsDataSize = texcoordsCount * sizeof( float2 );
-        std::memcpy( texcoords.data(), &( *dataCurrIt ), texcoordsDataSize );
-        dataCurrIt += texcoordsDataSize;
+        const int texcoordsCount = reader.read< int >();
+        reader.readArray( texcoords, texcoordsCount );
     }
 
-    // Read triangle count.
-    int triangleCount = 0;
-    std::memcpy( &triangleCount, &( *dataCurrIt ), sizeof( int ) );
-    dataCurrIt += sizeof( int );
-
     // Read triangles.
-    mesh->m_triangles.resize( triangleCount );
-    const int trianglesDataSize = triangleCount * sizeof( uint3 );
-    std::memcpy( mesh->m_triangles.data(), &( *dataCurrIt ), trianglesDataSize );
-    dataCurrIt += trianglesDataSize;
+    const int triangleCount = reader.read< int >();
+    reader.readArray( mesh->m_triangles, triangleCount );
 
     // Read bounding box.
-    float3 bbMin, bbMax;
-    std::memcpy( &bbMin, &( *dataCurrIt ), sizeof( float3 ) );
-    dataCurrIt += sizeof( float3 );
-    std::memcpy( &bbMax, &( *dataCurrIt ), sizeof( float3 ) );
-    dataCurrIt += sizeof( float3 );
+    const float3 bbMin = reader.read< float3 >();
+    const float3 bbMax = reader.read< float3 >();
     mesh->m_boundingBox.set( bbMin, bbMax );
 
     // Read if mesh has BVH tree.
-    bool hasBVHTree = false;
-    std::memcpy( &hasBVHTree, &( *dataCurrIt ), sizeof( bool ) );
-    dataCurrIt += sizeof( bool );
+    const bool hasBVHTree = reader.read< bool >();
 
     // Read BVH tree.
     if ( hasBVHTree )
-        mesh->setBvhTree( BVHTreeBufferParser::parseBVHTreeFile( dataCurrIt, dataEndIt ) );
+        mesh->setBvhTree( BVHTreeBufferParser::parseBVHTreeFile( reader ) );
+
+    return mesh;
+}
+
+std::shared_ptr<BlockMesh> MeshFileParser::parseBlockMeshFileOwnFormatV2( BinaryFileReader& reader )
+{
+    // Note: Magic was read already.
+    const int version = reader.read< int >();
+    if ( version != s_blockMeshFileVersion )
+        throw std::exception( "MeshFileParser::parseBlockMeshFileOwnFormatV2 - unsupported file version." );
+
+    const int    sectionCount = reader.read< int >();
+    const float3 bbMin        = reader.read< float3 >();
+    const float3 bbMax        = reader.read< float3 >();
+
+    const std::vector< FileSection > sections = readFileSectionTable( reader, sectionCount );
+
+    std::shared_ptr< BlockMesh >     mesh     = std::make_shared< BlockMesh >();
+    std::shared_ptr< BVHTreeBuffer > bvhTree  = nullptr;
+    std::shared_ptr< MeshletBuffer > meshlets = nullptr;
+
+    mesh->m_boundingBox.set( bbMin, bbMax );
+
+    // Compressed sections are read whole and then decoded.
+    std::vector< char > sectionData;
+
+    for ( const FileSection& section : sections )
+    {
+        skipToFileSection( reader, section );
+
+        const auto readSection = [ &reader, &section, &sectionData ]() {
+            if ( section.size > reader.getRemainingSize() )
+                throw std::exception( "MeshFileParser::parseBlockMeshFileOwnFormatV2 - section exceeds the file size." );
+
+            sectionData.resize( (size_t)section.size );
+            reader.read( sectionData.data(), sectionData.size() );
+        };
+
+        switch ( (BlockMeshFileSectionType)section.type )
+        {
+            case BlockMeshFileSectionType::Vertices:  reader.readArray( mesh->m_vertices, section.elementCount ); break;
+            case BlockMeshFileSectionType::Normals:   reader.readArray( mesh->m_normals, section.elementCount ); break;
+            case BlockMeshFileSectionType::Tangents:  reader.readArray( mesh->m_tangents, section.elementCount ); break;
+            case BlockMeshFileSectionType::Triangles: reader.readArray( mesh->m_triangles, section.elementCount ); break;
+            case BlockMeshFileSectionType::Texcoords:
+                mesh->m_texcoords.push_back( std::vector< float2 >() );
+                reader.readArray( mesh->m_texcoords.back(), section.elementCount );
+                break;
+            case BlockMeshFileSectionType::BvhNodes:
+                if ( !bvhTree ) bvhTree = std::make_shared< BVHTreeBuffer >();
+                reader.readArray( bvhTree->m_bvhNodes, section.elementCount );
+                break;
+            case BlockMeshFileSectionType::BvhNodesExtents:
+                if ( !bvhTree ) bvhTree = std::make_shared< BVHTreeBuffer >();
+                reader.readArray( bvhTree->m_bvhNodesExtents, section.elementCount );
+                break;
+            case BlockMeshFileSectionType::BvhTriangles:
+                if ( !bvhTree ) bvhTree = std::make_shared< BVHTreeBuffer >();
+                reader.readArray( bvhTree->m_triangles, section.elementCount );
+                break;
+            case BlockMeshFileSectionType::Meshlets:
+                if ( !meshlets ) meshlets = std::make_shared< MeshletBuffer >();
+                reader.readArray( meshlets->m_meshlets, section.elementCount );
+                break;
+            case BlockMeshFileSectionType::MeshletVertices:
+                if ( !meshlets ) meshlets = std::make_shared< MeshletBuffer >();
+                reader.readArray( meshlets->m_vertices, section.elementCount );
+                break;
+            case BlockMeshFileSectionType::MeshletTriangles:
+                if ( !meshlets ) meshlets = std::make_shared< MeshletBuffer >();
+                reader.readArray( meshlets->m_triangles, section.elementCount * 3 );
+                break;
+            case BlockMeshFileSectionType::VerticesQuantized:
+                readSection();
+                MeshCompressionUtil::decodePositions( sectionData.data(), sectionData.size(), mesh->m_vertices, section.elementCount, bbMin, bbMax );
+                break;
+            case BlockMeshFileSectionType::NormalsOctahedral:
+                readSection();
+                MeshCompressionUtil::decodeUnitVectors( sectionData.data(), sectionData.size(), mesh->m_normals, section.elementCount );
+                break;
+            case BlockMeshFileSectionType::TangentsOctahedral:
+                readSection();
+                MeshCompressionUtil::decodeUnitVectors( sectionData.data(), sectionData.size(), mesh->m_tangents, section.elementCount );
+                break;
+            case BlockMeshFileSectionType::TexcoordsHalf:
+                readSection();
+                mesh->m_texcoords.push_back( std::vector< float2 >() );
+                MeshCompressionUtil::decodeTexcoords( sectionData.data(), sectionData.size(), mesh->m_texcoords.back(), section.elementCount );
+                break;
+            case BlockMeshFileSectionType::TrianglesCompressed:
+                readSection();
+                MeshCompressionUtil::decodeTriangles( sectionData.data(), sectionData.size(), mesh->m_triangles, section.elementCount );
+                break;
+            case BlockMeshFileSectionType::VertexLayout:
+            {
+                const BlockMesh::VertexLayout vertexLayout = reader.read< BlockMesh::VertexLayout >();
+
+                // Layouts unknown to this version fall back to separate buffers.
+                if ( vertexLayout == BlockMesh::VertexLayout::Interleaved || vertexLayout == BlockMesh::VertexLayout::Hybrid )
+                    mesh->m_vertexLayout = vertexLayout;
+                break;
+            }
+            default:
+                break; // Unknown sections (from newer versions) are ignored.
+        }
+    }
+
+    if ( bvhTree )
+        mesh->setBvhTree( bvhTree );
+
+    if ( meshlets )
+        mesh->setMeshlets( meshlets );
 
     return mesh;
 }
@@ -304,20 +448,98 @@ std::vector< std::shared_ptr<SkeletonMesh> > MeshFileParser::parseSkeletonMeshFi
     return meshes;
 }
 
-std::shared_ptr<SkeletonMesh> MeshFileParser::parseSkeletonMeshFileOwnFormat( std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt )
+std::shared_ptr<SkeletonMesh> MeshFileParser::parseSkeletonMeshFileOwnFormat( BinaryFileReader& reader )
 {
-    dataIt;
-    dataEndIt;
+    SkeletonMeshFileHeader header = reader.read< SkeletonMeshFileHeader >();
+
+    if ( header.magic != s_skeletonMeshFileMagic )
+        throw std::exception( "MeshFileParser::parseSkeletonMeshFileOwnFormat - not a skeleton mesh file." );
+
+    if ( header.version != s_skeletonMeshFileVersion )
+        throw std::exception( "MeshFileParser::parseSkeletonMeshFileOwnFormat - unsupported file version." );
+
+    const BonesPerVertexCount::Type bonesPerVertexCount = (BonesPerVertexCount::Type)header.bonesPerVertexCount;
+
+    if ( bonesPerVertexCount != BonesPerVertexCount::Type::ZERO && bonesPerVertexCount != BonesPerVertexCount::Type::ONE
+         && bonesPerVertexCount != BonesPerVertexCount::Type::TWO && bonesPerVertexCount != BonesPerVertexCount::Type::FOUR )
+        throw std::exception( "MeshFileParser::parseSkeletonMeshFileOwnFormat - invalid bones per vertex count." );
+
+    const std::vector< FileSection > sections = readFileSectionTable( reader, header.sectionCount );
 
-    throw std::exception( "MeshFileParser::parseSkeletonMeshFileOwnFormat - not yet implemented." );
+    std::shared_ptr< SkeletonMesh > mesh = std::make_shared< SkeletonMesh >();
+
+    mesh->bonesPerVertexCount = bonesPerVertexCount;
+    mesh->m_boundingBox.set( header.boundingBoxMin, header.boundingBoxMax );
+
+    // Bones are resolved after all sections are read, as names are stored in a separate section.
+    std::vector< SkeletonMeshFileBone > bones;
+    std::vector< char >                 boneNames;
+
+    for ( const FileSection& section : sections )
+    {
+        skipToFileSection( reader, section );
+
+        switch ( (SkeletonMeshFileSectionType)section.type )
+        {
+            case SkeletonMeshFileSectionType::Vertices:      reader.readArray( mesh->m_vertices, section.elementCount ); break;
+            case SkeletonMeshFileSectionType::Normals:       reader.readArray( mesh->m_normals, section.elementCount ); break;
+            case SkeletonMeshFileSectionType::Tangents:      reader.readArray( mesh->m_tangents, section.elementCount ); break;
+            case SkeletonMeshFileSectionType::Triangles:     reader.readArray( mesh->m_triangles, section.elementCount ); break;
+            case SkeletonMeshFileSectionType::VertexBones:   reader.readArray( mesh->m_vertexBones, section.elementCount ); break;
+            case SkeletonMeshFileSectionType::VertexWeights: reader.readArray( mesh->m_vertexWeights, section.elementCount ); break;
+            case SkeletonMeshFileSectionType::Bones:         reader.readArray( bones, section.elementCount ); break;
+            case SkeletonMeshFileSectionType::BoneNames:     reader.readArray( boneNames, section.elementCount ); break;
+            case SkeletonMeshFileSectionType::Texcoords:
+                mesh->m_texcoords.push_back( std::vector< float2 >() );
+                reader.readArray( mesh->m_texcoords.back(), section.elementCount );
+                break;
+            default:
+                break; // Unknown sections (from newer versions) are ignored.
+        }
+    }
+
+    if ( mesh->m_vertexBones.size() != mesh->m_vertices.size() * (size_t)bonesPerVertexCount
+         || mesh->m_vertexWeights.size() != mesh->m_vertexBones.size() )
+        throw std::exception( "MeshFileParser::parseSkeletonMeshFileOwnFormat - vertex bones or weights count doesn't match the vertex count." );
+
+    if ( bones.size() > 255 )
+        throw std::exception( "MeshFileParser::parseSkeletonMeshFileOwnFormat - too many bones." );
+
+    mesh->m_bones.reserve( bones.size() );
+    for ( const SkeletonMeshFileBone& bone : bones )
+    {
+        if ( bone.nameOffset < 0 || bone.nameLength < 0 || (size_t)bone.nameOffset + (size_t)bone.nameLength > boneNames.size() )
+            throw std::exception( "MeshFileParser::parseSkeletonMeshFileOwnFormat - bone name is out of bounds." );
+
+        const std::string name( boneNames.data() + bone.nameOffset, (size_t)bone.nameLength );
+
+        mesh->m_bones.push_back( SkeletonMesh::Bone( name, bone.parentBoneIndex, bone.bindPose, bone.bindPoseInv ) );
+    }
+
+    mesh->updateBoneHierarchy();
+
+    return mesh;
 }
 
-void MeshFileParser::writeBlockMeshFile( std::vector< char >& data, const BlockMeshFileInfo::Format format, const BlockMesh& mesh )
+void MeshFileParser::writeBlockMeshFile( std::vector< char >& data, const BlockMeshFileInfo::Format format, const BlockMesh& mesh, const bool compress )
 {
     if ( format == BlockMeshFileInfo::Format::BLOCKMESH )
-        writeBlockMeshFileOwnFormat( data, mesh );
+    {
+        data.clear();
+
+        BinaryFileWriter writer( data );
+        writeBlockMeshFileOwnFormat( writer, mesh, compress );
+        writer.close();
+    }
     else
+    {
         writeBlockMeshFileAssimp( data, format, mesh );
+    }
+}
+
+void MeshFileParser::writeBlockMeshFile( BinaryFileWriter& writer, const BlockMesh& mesh, const bool compress )
+{
+    writeBlockMeshFileOwnFormat( writer, mesh, compress );
 }
 
 void MeshFileParser::writeBlockMeshFileAssimp( std::vector< char >& data, const BlockMeshFileInfo::Format format, const BlockMesh& mesh )
@@ -404,105 +626,271 @@ void MeshFileParser::writeBlockMeshFileAssimp( std::vector< char >& data, const
     }
 }
 
-void MeshFileParser::writeBlockMeshFileOwnFormat( std::vector< char >& data, const BlockMesh& mesh )
+void MeshFileParser::writeBlockMeshFileOwnFormat( BinaryFileWriter& writer, const BlockMesh& mesh, const bool compress )
 {
-    const int verticesDataSize  = (int)mesh.getVertices().size() * sizeof( float3 );
-    const int normalsDataSize   = (int)mesh.getNormals().size() * sizeof( float3 );
-    const int tangentsDataSize  = (int)mesh.getTangents().size() * sizeof( float3 );
-    const int trianglesDataSize = (int)mesh.getTriangles().size() * sizeof( uint3 );
+    std::vector< FileSectionData > sectionsData;
+
+    // Encoded (compressed) sections have to be kept alive until they are written. List doesn't move its elements.
+    std::list< std::vector< char > > encodedSectionsData;
 
-    int totalSize = 0;
-    totalSize += 3 * sizeof( int ); // Vertices, normals, tangents counts.
-    totalSize += verticesDataSize;  // Vertices.
-    totalSize += normalsDataSize;   // Normals.
-    totalSize += tangentsDataSize;  // Tangents.
+    const auto addSection = [ &sectionsData ]( const BlockMeshFileSectionType type, const size_t elementCount, const size_t elementSize, const void* data ) {
+        FileSectionData sectionData = { (int)type, elementCount, elementCount * elementSize, data };
+        sectionsData.push_back( sectionData );
+    };
 
-    totalSize += ( 1 + mesh.getTexcoordsCount() ) * sizeof( int ); // Texcoord set count, and texcoord count in each set.
-    for ( int texcordSetIdx = 0; texcordSetIdx < mesh.getTexcoordsCount(); ++texcordSetIdx )
-        totalSize += (int)mesh.getTexcoords( texcordSetIdx ).size() * sizeof( float2 ); // Texcoords.
+    const auto addEncodedSection = [ &sectionsData, &encodedSectionsData ]( const BlockMeshFileSectionType type, const size_t elementCount,
+                                                                             const std::function< void( std::vector< char >& ) >& encode ) {
+        encodedSectionsData.emplace_back();
+        encode( encodedSectionsData.back() );
 
-    totalSize += sizeof( int );     // Triangle count.
-    totalSize += trianglesDataSize; // Triangles.
+        FileSectionData sectionData = { (int)type, elementCount, encodedSectionsData.back().size(), encodedSectionsData.back().data() };
+        sectionsData.push_back( sectionData );
+    };
 
-    totalSize += 2 * sizeof( float3 ); // Bounding box.
-    totalSize += sizeof( bool );       // Has BVH tree flag.
+    // Positions are quantized relative to the bounding box stored in the header. It's recalculated from the vertices,
+    // as the mesh bounding box may be stale (ex: after vertices were modified) and vertices outside of it would be clamped.
+    const BoundingBox boundingBox = compress ? MathUtil::calculateBoundingBox( mesh.getVertices() ) : mesh.getBoundingBox();
+    const float3      bbMin       = boundingBox.getMin();
+    const float3      bbMax       = boundingBox.getMax();
 
-    const int bvhTreeSize = mesh.getBvhTree() ? BVHTreeBufferParser::getSizeOfBVHTreeFile( *mesh.getBvhTree() ) : 0;
+    if ( compress )
+    {
+        addEncodedSection( BlockMeshFileSectionType::VerticesQuantized, mesh.getVertices().size(), 
+            [ &mesh, &bbMin, &bbMax ]( std::vector< char >& encoded ) { MeshCompressionUtil::encodePositions( encoded, mesh.getVertices(), bbMin, bbMax ); } );
 
-    data.reserve( totalSize + bvhTreeSize );
-    data.resize( totalSize );
+        if ( !mesh.getNormals().empty() )
+            addEncodedSection( BlockMeshFileSectionType::NormalsOctahedral, mesh.getNormals().size(), 
+                [ &mesh ]( std::vector< char >& encoded ) { MeshCompressionUtil::encodeUnitVectors( encoded, mesh.getNormals() ); } );
 
-    std::vector< char >::iterator dataIt = data.begin();
+        if ( !mesh.getTangents().empty() )
+            addEncodedSection( BlockMeshFileSectionType::TangentsOctahedral, mesh.getTangents().size(), 
+                [ &mesh ]( std::vector< char >& encoded ) { MeshCompressionUtil::encodeUnitVectors( encoded, mesh.getTangents() ); } );
 
-    // Write vertex count.
-    const int vertexCount = (int)mesh.getVertices().size();
-    std::memcpy( &(*dataIt), &vertexCount, sizeof( int ) );
-    dataIt += sizeof( int );
+        for ( int texcoordSetIdx = 0; texcoordSetIdx < mesh.getTexcoordsCount(); ++texcoordSetIdx )
+            addEncodedSection( BlockMeshFileSectionType::TexcoordsHalf, mesh.getTexcoords( texcoordSetIdx ).size(), 
+                [ &mesh, texcoordSetIdx ]( std::vector< char >& encoded ) { MeshCompressionUtil::encodeTexcoords( encoded, mesh.getTexcoords( texcoordSetIdx ) ); } );
 
-    // Write vertices.
-    std::memcpy( &(*dataIt), mesh.getVertices().data(), verticesDataSize );
-    dataIt += verticesDataSize;
+        addEncodedSection( BlockMeshFileSectionType::TrianglesCompressed, mesh.getTriangles().size(), 
+            [ &mesh ]( std::vector< char >& encoded ) { MeshCompressionUtil::encodeTriangles( encoded, mesh.getTriangles() ); } );
+    }
+    else
+    {
+        addSection( BlockMeshFileSectionType::Vertices, mesh.getVertices().size(), sizeof( float3 ), mesh.getVertices().data() );
 
-    // Write normals count.
-    const int normalCount = (int)mesh.getNormals().size();
-    std::memcpy( &(*dataIt), &normalCount, sizeof( int ) );
-    dataIt += sizeof( int );
+        if ( !mesh.getNormals().empty() )
+            addSection( BlockMeshFileSectionType::Normals, mesh.getNormals().size(), sizeof( float3 ), mesh.getNormals().data() );
 
-    // Write normals.
-    std::memcpy( &( *dataIt ), mesh.getNormals().data(), normalsDataSize );
-    dataIt += normalsDataSize;
+        if ( !mesh.getTangents().empty() )
+            addSection( BlockMeshFileSectionType::Tangents, mesh.getTangents().size(), sizeof( float3 ), mesh.getTangents().data() );
 
-    // Write tangents count.
-    const int tangentsCount = (int)mesh.getTangents().size();
-    std::memcpy( &( *dataIt ), &tangentsCount, sizeof( int ) );
-    dataIt += sizeof( int );
+        for ( int texcoordSetIdx = 0; texcoordSetIdx < mesh.getTexcoordsCount(); ++texcoordSetIdx )
+            addSection( BlockMeshFileSectionType::Texcoords, mesh.getTexcoords( texcoordSetIdx ).size(), sizeof( float2 ), mesh.getTexcoords( texcoordSetIdx ).data() );
 
-    // Write tangents.
-    std::memcpy( &( *dataIt ), mesh.getTangents().data(), tangentsDataSize );
-    dataIt += tangentsDataSize;
+        addSection( BlockMeshFileSectionType::Triangles, mesh.getTriangles().size(), sizeof( uint3 ), mesh.getTriangles().data() );
+    }
 
-    // Write texcoord set count.
-    const int texcoordsSetCount = (int)mesh.getTexcoordsCount();
-    std::memcpy( &( *dataIt ), &texcoordsSetCount, sizeof( int ) );
-    dataIt += sizeof( int );
+    // Note: BVH and meshlets are stored uncompressed - they are much smaller than the mesh and BVH is used directly by the renderer.
 
-    for ( int texcordSetIdx = 0; texcordSetIdx < mesh.getTexcoordsCount(); ++texcordSetIdx )
+    if ( mesh.getBvhTree() )
     {
-        // Write texcoords count.
-        const int texcoordsCount = (int)mesh.getTexcoords( texcordSetIdx ).size();
-        std::memcpy( &( *dataIt ), &texcoordsCount, sizeof( int ) );
-        dataIt += sizeof( int );
-
-        // Write texcoords.
-        const int texcoordsDataSize = (int)mesh.getTexcoords( texcordSetIdx ).size() * sizeof( float2 );
-        std::memcpy( &( *dataIt ), mesh.getTexcoords( texcordSetIdx ).data(), texcoordsDataSize );
-        dataIt += texcoordsDataSize;
+        const BVHTreeBuffer& bvhTree = *mesh.getBvhTree();
+
+        addSection( BlockMeshFileSectionType::BvhNodes, bvhTree.getNodes().size(), sizeof( BVHTreeBuffer::Node ), bvhTree.getNodes().data() );
+
+        if ( compress )
+        {
+            // Decoded vertices may move by up to half of the quantization step - extents are padded by a whole step, so they still contain their triangles.
+            const float3 quantizationStep = ( bbMax - bbMin ) / 65535.0f;
+
+            addEncodedSection( BlockMeshFileSectionType::BvhNodesExtents, bvhTree.getNodesExtents().size(), 
+                [ &bvhTree, &quantizationStep ]( std::vector< char >& encoded ) { 
+                    std::vector< BVHTreeBuffer::NodeExtents > paddedExtents = bvhTree.getNodesExtents();
+                    for ( BVHTreeBuffer::NodeExtents& extents : paddedExtents )
+                    {
+                        extents.min -= quantizationStep;
+                        extents.max += quantizationStep;
+                    }
+
+                    encoded.resize( paddedExtents.size() * sizeof( BVHTreeBuffer::NodeExtents ) );
+                    std::memcpy( encoded.data(), paddedExtents.data(), encoded.size() );
+                } 
+            );
+        }
+        else
+        {
+            addSection( BlockMeshFileSectionType::BvhNodesExtents, bvhTree.getNodesExtents().size(), sizeof( BVHTreeBuffer::NodeExtents ), bvhTree.getNodesExtents().data() );
+        }
+
+        addSection( BlockMeshFileSectionType::BvhTriangles, bvhTree.getTriangles().size(), sizeof( unsigned int ), bvhTree.getTriangles().data() );
     }
 
-    // Write triangles count.
-    const int trianglesCount = (int)mesh.getTriangles().size();
-    std::memcpy( &( *dataIt ), &trianglesCount, sizeof( int ) );
-    dataIt += sizeof( int );
-
-    // Write triangles.
-    std::memcpy( &( *dataIt ), mesh.getTriangles().data(), trianglesDataSize );
-    dataIt += trianglesDataSize;
-
-    // Write bounding box.
-    const BoundingBox bbBox = mesh.getBoundingBox();
-    const float3 bbMin( bbBox.getMin() );
-    const float3 bbMax( bbBox.getMax() );
-    std::memcpy( &( *dataIt ), &bbMin, sizeof( bbMin ) );
-    dataIt += sizeof( bbMin );
-    std::memcpy( &( *dataIt ), &bbMax, sizeof( bbMax ) );
-    dataIt += sizeof( bbMax );
-
-    // Write if it has BVH tree.
-    const bool hasBvhTree = mesh.getBvhTree() != nullptr;
-    std::memcpy( &( *dataIt ), &hasBvhTree, sizeof( bool ) );
-    dataIt += sizeof( bool );
-
-    // Write BVH tree.
-    if ( mesh.getBvhTree() )
-        BVHTreeBufferParser::writeBVHTreeFile( data, *mesh.getBvhTree() );
+    if ( mesh.getMeshlets() )
+    {
+        const MeshletBuffer& meshlets = *mesh.getMeshlets();
+
+        addSection( BlockMeshFileSectionType::Meshlets, meshlets.getMeshlets().size(), sizeof( MeshletBuffer::Meshlet ), meshlets.getMeshlets().data() );
+        addSection( BlockMeshFileSectionType::MeshletVertices, meshlets.getVertices().size(), sizeof( unsigned int ), meshlets.getVertices().data() );
+        addSection( BlockMeshFileSectionType::MeshletTriangles, meshlets.getTriangles().size() / 3, 3 * sizeof( unsigned char ), meshlets.getTriangles().data() );
+    }
+
+    if ( mesh.m_vertexLayout != BlockMesh::VertexLayout::Separate )
+        addSection( BlockMeshFileSectionType::VertexLayout, 1, sizeof( BlockMesh::VertexLayout ), &mesh.m_vertexLayout );
+
+    BlockMeshFileHeader header;
+    header.magic          = s_blockMeshFileMagic;
+    header.version        = s_blockMeshFileVersion;
+    header.sectionCount   = (int)sectionsData.size();
+    header.boundingBoxMin = bbMin;
+    header.boundingBoxMax = bbMax;
+
+    writeFileSections( writer, &header, sizeof( BlockMeshFileHeader ), sectionsData );
+}
+
+void MeshFileParser::writeSkeletonMeshFile( std::vector< char >& data, const SkeletonMeshFileInfo::Format format, const SkeletonMesh& mesh )
+{
+    if ( format != SkeletonMeshFileInfo::Format::SKELETONMESH )
+        throw std::exception( "MeshFileParser::writeSkeletonMeshFile - only own format is supported." );
+
+    data.clear();
+
+    BinaryFileWriter writer( data );
+    writeSkeletonMeshFileOwnFormat( writer, mesh );
+    writer.close();
+}
+
+void MeshFileParser::writeSkeletonMeshFile( BinaryFileWriter& writer, const SkeletonMesh& mesh )
+{
+    writeSkeletonMeshFileOwnFormat( writer, mesh );
+}
+
+void MeshFileParser::writeSkeletonMeshFileOwnFormat( BinaryFileWriter& writer, const SkeletonMesh& mesh )
+{
+    // Bone names are gathered in a single section - bones refer to them by offset.
+    std::vector< SkeletonMeshFileBone > bones;
+    std::vector< char >                 boneNames;
+
+    bones.reserve( mesh.m_bones.size() );
+    for ( const SkeletonMesh::Bone& bone : mesh.m_bones )
+    {
+        const std::string name = bone.getName();
+
+        SkeletonMeshFileBone fileBone;
+        std::memset( &fileBone, 0, sizeof( SkeletonMeshFileBone ) );
+        fileBone.nameOffset      = (int)boneNames.size();
+        fileBone.nameLength      = (int)name.size();
+        fileBone.parentBoneIndex = bone.getParentBoneIndex();
+        fileBone.bindPose        = bone.getBindPose();
+        fileBone.bindPoseInv     = bone.getBindPoseInv();
+
+        bones.push_back( fileBone );
+        boneNames.insert( boneNames.end(), name.begin(), name.end() );
+    }
+
+    std::vector< FileSectionData > sectionsData;
+
+    const auto addSection = [ &sectionsData ]( const SkeletonMeshFileSectionType type, const size_t elementCount, const size_t elementSize, const void* data ) {
+        FileSectionData sectionData = { (int)type, elementCount, elementCount * elementSize, data };
+        sectionsData.push_back( sectionData );
+    };
+
+    addSection( SkeletonMeshFileSectionType::Vertices, mesh.m_vertices.size(), sizeof( float3 ), mesh.m_vertices.data() );
+
+    if ( !mesh.m_normals.empty() )
+        addSection( SkeletonMeshFileSectionType::Normals, mesh.m_normals.size(), sizeof( float3 ), mesh.m_normals.data() );
+
+    if ( !mesh.m_tangents.empty() )
+        addSection( SkeletonMeshFileSectionType::Tangents, mesh.m_tangents.size(), sizeof( float3 ), mesh.m_tangents.data() );
+
+    for ( const std::vector< float2 >& texcoords : mesh.m_texcoords )
+        addSection( SkeletonMeshFileSectionType::Texcoords, texcoords.size(), sizeof( float2 ), texcoords.data() );
+
+    addSection( SkeletonMeshFileSectionType::Triangles, mesh.m_triangles.size(), sizeof( uint3 ), mesh.m_triangles.data() );
+
+    if ( !mesh.m_vertexBones.empty() )
+    {
+        addSection( SkeletonMeshFileSectionType::VertexBones, mesh.m_vertexBones.size(), sizeof( unsigned char ), mesh.m_vertexBones.data() );
+        addSection( SkeletonMeshFileSectionType::VertexWeights, mesh.m_vertexWeights.size(), sizeof( float ), mesh.m_vertexWeights.data() );
+    }
+
+    if ( !bones.empty() )
+    {
+        addSection( SkeletonMeshFileSectionType::Bones, bones.size(), sizeof( SkeletonMeshFileBone ), bones.data() );
+        addSection( SkeletonMeshFileSectionType::BoneNames, boneNames.size(), sizeof( char ), boneNames.data() );
+    }
+
+    SkeletonMeshFileHeader header;
+    std::memset( &header, 0, sizeof( SkeletonMeshFileHeader ) );
+    header.magic               = s_skeletonMeshFileMagic;
+    header.version             = s_skeletonMeshFileVersion;
+    header.sectionCount        = (int)sectionsData.size();
+    header.bonesPerVertexCount = (unsigned char)mesh.bonesPerVertexCount;
+    header.boundingBoxMin      = mesh.m_boundingBox.getMin();
+    header.boundingBoxMax      = mesh.m_boundingBox.getMax();
+
+    writeFileSections( writer, &header, sizeof( SkeletonMeshFileHeader ), sectionsData );
+}
+
+void MeshFileParser::writeFileSections( BinaryFileWriter& writer, const void* header, const size_t headerSize, const std::vector< FileSectionData >& sectionsData )
+{
+    const auto align = []( const size_t offset ) {
+        return ( offset + s_fileSectionAlignment - 1 ) / s_fileSectionAlignment * s_fileSectionAlignment;
+    };
+
+    // Calculate the layout - each section starts at an aligned offset.
+    std::vector< FileSection > sections;
+    sections.reserve( sectionsData.size() );
+
+    size_t totalSize = headerSize + sectionsData.size() * sizeof( FileSection );
+    for ( const FileSectionData& sectionData : sectionsData )
+    {
+        if ( sectionData.elementCount > INT_MAX )
+            throw std::exception( "MeshFileParser::writeFileSections - too many elements in the mesh." );
+
+        FileSection section;
+        section.type         = sectionData.type;
+        section.elementCount = (int)sectionData.elementCount;
+        section.offset       = align( totalSize );
+        section.size         = sectionData.size;
+
+        sections.push_back( section );
+
+        totalSize = (size_t)( section.offset + section.size );
+    }
+
+    // Offsets are relative to the position at which the mesh data starts.
+    const unsigned long long startPosition = writer.getPosition();
+
+    writer.reserve( totalSize );
+
+    // Write header and section table.
+    writer.write( header, headerSize );
+    writer.writeArray( sections );
+
+    // Write sections - directly from the source data. Note: Padding between sections is zeroed.
+    for ( size_t i = 0; i < sections.size(); ++i )
+    {
+        writer.writeZeros( startPosition + sections[ i ].offset - writer.getPosition() );
+        writer.write( sectionsData[ i ].data, sections[ i ].size );
+    }
+}
+
+std::vector< MeshFileParser::FileSection > MeshFileParser::readFileSectionTable( BinaryFileReader& reader, const int sectionCount )
+{
+    std::vector< FileSection > sections;
+    reader.readArray( sections, sectionCount );
+
+    // Sections can only be read in order, as the reader can't go back.
+    std::stable_sort( sections.begin(), sections.end(), 
+        []( const FileSection& section1, const FileSection& section2 ) { return section1.offset < section2.offset; } 
+    );
+
+    return sections;
+}
+
+void MeshFileParser::skipToFileSection( BinaryFileReader& reader, const FileSection& section )
+{
+    if ( section.offset < reader.getPosition() )
+        throw std::exception( "MeshFileParser::skipToFileSection - sections overlap." );
+
+    reader.skip( section.offset - reader.getPosition() );
 }
@@ -4,19 +4,39 @@
 #include <memory>
 
 #include "BlockMeshFileInfo.h"
+#include "SkeletonMeshFileInfo.h"
+#include "float3.h"
+#include "float43.h"
+
+struct aiScene;
 
 namespace Engine1
 {
     class BlockMesh;
     class SkeletonMesh;
+    class BinaryFileReader;
+    class BinaryFileWriter;
 
     class MeshFileParser
     {
         public:
         static std::vector< std::shared_ptr<BlockMesh> >    parseBlockMeshFile( BlockMeshFileInfo::Format format, std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs );
-        static std::vector< std::shared_ptr<SkeletonMesh> > parseSkeletonMeshFile( std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs );
+        // Own format only. Data is consumed incrementally, so a file can be parsed without loading it to memory first.
+        static std::shared_ptr<BlockMesh>                   parseBlockMeshFile( BinaryFileReader& reader );
+        static std::vector< std::shared_ptr<SkeletonMesh> > parseSkeletonMeshFile( SkeletonMeshFileInfo::Format format, std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs );
+
+        // Compression applies only to the own format - vertex attributes are quantized (lossy), triangles are compressed losslessly.
+        static void writeBlockMeshFile( std::vector< char >& data, const BlockMeshFileInfo::Format format, const BlockMesh& mesh, const bool compress = false );
+        // Own format only. Sections are written directly from the mesh, so a file can be saved without creating its copy in memory.
+        // Writer has to be closed by the caller.
+        static void writeBlockMeshFile( BinaryFileWriter& writer, const BlockMesh& mesh, const bool compress = false );
+        // Only the own format is supported.
+        static void writeSkeletonMeshFile( std::vector< char >& data, const SkeletonMeshFileInfo::Format format, const SkeletonMesh& mesh );
+        static void writeSkeletonMeshFile( BinaryFileWriter& writer, const SkeletonMesh& mesh );
 
-        static void writeBlockMeshFile( std::vector< char >& data, const BlockMeshFileInfo::Format format, const BlockMesh& mesh );
+        // Converts meshes of a scene imported by Assimp (with triangulation) - in the order of the scene's meshes. Identical vertices are welded.
+        // Used by importers, which need the rest of the scene (ex: materials).
+        static std::vector< std::shared_ptr<BlockMesh> > createBlockMeshes( const aiScene& aiscene );
 
         private:
 
@@ -25,12 +45,126 @@ namespace Engine1
 
         static std::vector< std::shared_ptr<BlockMesh> > parseBlockMeshFileAssimp( BlockMeshFileInfo::Format format, std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs );
         static std::shared_ptr<BlockMesh>                parseBlockMeshFileOwnFormat( std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt );
+        static std::shared_ptr<BlockMesh>                parseBlockMeshFileOwnFormat( BinaryFileReader& reader );
+        static std::shared_ptr<BlockMesh>                parseBlockMeshFileOwnFormatV1( BinaryFileReader& reader, const int vertexCount );
+        static std::shared_ptr<BlockMesh>                parseBlockMeshFileOwnFormatV2( BinaryFileReader& reader );
 
         static std::vector< std::shared_ptr<SkeletonMesh> > parseSkeletonMeshFileAssimp( std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs );
-        static std::shared_ptr<SkeletonMesh>                parseSkeletonMeshFileOwnFormat( std::vector<char>::const_iterator& dataIt, std::vector<char>::const_iterator& dataEndIt );
+        static std::shared_ptr<SkeletonMesh>                parseSkeletonMeshFileOwnFormat( BinaryFileReader& reader );
 
         static void writeBlockMeshFileAssimp( std::vector< char >& data, const BlockMeshFileInfo::Format format, const BlockMesh& mesh );
-        static void writeBlockMeshFileOwnFormat( std::vector< char >& data, const BlockMesh& mesh );
+        static void writeBlockMeshFileOwnFormat( BinaryFileWriter& writer, const BlockMesh& mesh, const bool compress );
+        static void writeSkeletonMeshFileOwnFormat( BinaryFileWriter& writer, const SkeletonMesh& mesh );
+
+        // Own formats consist of a header, section table and sections with the mesh data.
+        // Each section starts at an offset (from the beginning of the mesh data) aligned to s_fileSectionAlignment,
+        // so sections can be used directly from mapped memory or uploaded to GPU as they are.
+        #pragma pack( push, 1 )
+        struct FileSection
+        {
+            int                type;
+            int                elementCount;
+            unsigned long long offset;
+            unsigned long long size; // In bytes.
+        };
+        #pragma pack( pop )
+
+        struct FileSectionData
+        {
+            int         type;
+            size_t      elementCount;
+            size_t      size; // In bytes.
+            const void* data;
+        };
+
+        // Writes the header (with section count already set) followed by the section table and sections.
+        static void writeFileSections( BinaryFileWriter& writer, const void* header, const size_t headerSize, const std::vector< FileSectionData >& sectionsData );
+        // Returns sections sorted by offset - in the order they can be read.
+        static std::vector< FileSection > readFileSectionTable( BinaryFileReader& reader, const int sectionCount );
+        // Skips to the section start. Throws if sections overlap.
+        static void skipToFileSection( BinaryFileReader& reader, const FileSection& section );
+
+        static const size_t s_fileSectionAlignment;
+
+        // BlockMesh own format, version 2.
+        // Version 1 files have no header - they start with the vertex count (which can't be equal to the magic value in practice).
+        enum class BlockMeshFileSectionType : int
+        {
+            Vertices        = 0,
+            Normals         = 1,
+            Tangents        = 2,
+            Texcoords       = 3, // One section per texcoord set.
+            Triangles       = 4,
+            BvhNodes        = 5,
+            BvhNodesExtents = 6,
+            BvhTriangles    = 7,
+            // Compressed variants - see MeshCompressionUtil. Positions are quantized relative to the bounding box from the header.
+            VerticesQuantized   = 8,
+            NormalsOctahedral   = 9,
+            TangentsOctahedral  = 10,
+            TexcoordsHalf       = 11,
+            TrianglesCompressed = 12,
+            // Optional meshlets - see MeshletBuffer.
+            Meshlets         = 13,
+            MeshletVertices  = 14,
+            MeshletTriangles = 15, // Element is a triplet of 8-bit local vertex indices.
+            // Optional single element - BlockMesh::VertexLayout. Not written for the default (separate) layout.
+            VertexLayout = 16
+        };
+
+        #pragma pack( push, 1 )
+        struct BlockMeshFileHeader
+        {
+            int    magic;
+            int    version;
+            int    sectionCount;
+            float3 boundingBoxMin;
+            float3 boundingBoxMax;
+        };
+        #pragma pack( pop )
+
+        static const int s_blockMeshFileMagic;
+        static const int s_blockMeshFileVersion;
+
+        // SkeletonMesh own format.
+        enum class SkeletonMeshFileSectionType : int
+        {
+            Vertices      = 0,
+            Normals       = 1,
+            Tangents      = 2,
+            Texcoords     = 3, // One section per texcoord set.
+            Triangles     = 4,
+            VertexBones   = 5, // Bones per vertex count elements per vertex.
+            VertexWeights = 6, // Bones per vertex count elements per vertex.
+            Bones         = 7,
+            BoneNames     = 8  // Names of all bones - without null terminators.
+        };
+
+        #pragma pack( push, 1 )
+        struct SkeletonMeshFileHeader
+        {
+            int           magic;
+            int           version;
+            int           sectionCount;
+            unsigned char bonesPerVertexCount;
+            char          padding[ 3 ];
+            float3        boundingBoxMin;
+            float3        boundingBoxMax;
+        };
+
+        struct SkeletonMeshFileBone
+        {
+            int           nameOffset; // In the bone names section.
+            int           nameLength;
+            unsigned char parentBoneIndex;
+            char          padding[ 3 ];
+            float43       bindPose;
+            float43       bindPoseInv;
+        };
+        #pragma pack( pop )
+
+        static const int s_skeletonMeshFileMagic;
+        static const int s_skeletonMeshFileVersion;
     };
 }
 
@@ -1,12 +1,90 @@
 #include "MeshUtil.h"
 
 #include "BlockMesh.h"
+#include "BlockMeshLOD.h"
+#include "BVHTreeBuffer.h"
+#include "MeshletBuffer.h"
 #include "float43.h"
+#include "ParallelUtil.h"
 
 #include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <tuple>
+#include <unordered_map>
+#include <xmmintrin.h>
 
 using namespace Engine1;
 
+namespace
+{
+    static_assert( sizeof( float3 ) == 3 * sizeof( float ), "float3 has to be tightly packed for SIMD transforms." );
+
+    // Transforms an array of float3 by the given matrix (as points or as directions - without translation).
+    // Source and destination may be the same array. Four values are transformed at once with SSE 
+    // (their components are transposed to separate registers), the remaining ones one by one.
+    void transformFloat3s( const float3* src, float3* dst, const size_t count, const float43& transform, const bool translate )
+    {
+        const __m128 m11 = _mm_set1_ps( transform.m11 ), m12 = _mm_set1_ps( transform.m12 ), m13 = _mm_set1_ps( transform.m13 );
+        const __m128 m21 = _mm_set1_ps( transform.m21 ), m22 = _mm_set1_ps( transform.m22 ), m23 = _mm_set1_ps( transform.m23 );
+        const __m128 m31 = _mm_set1_ps( transform.m31 ), m32 = _mm_set1_ps( transform.m32 ), m33 = _mm_set1_ps( transform.m33 );
+        const __m128 t1  = _mm_set1_ps( translate ? transform.t1 : 0.0f );
+        const __m128 t2  = _mm_set1_ps( translate ? transform.t2 : 0.0f );
+        const __m128 t3  = _mm_set1_ps( translate ? transform.t3 : 0.0f );
+
+        const size_t simdCount = count & ~(size_t)3;
+
+        for ( size_t idx = 0; idx < simdCount; idx += 4 )
+        {
+            const float* srcData = reinterpret_cast< const float* >( src + idx );
+            float*       dstData = reinterpret_cast< float* >( dst + idx );
+
+            // Load 4 values: (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3).
+            const __m128 a = _mm_loadu_ps( srcData );
+            const __m128 b = _mm_loadu_ps( srcData + 4 );
+            const __m128 c = _mm_loadu_ps( srcData + 8 );
+
+            // Transpose to (x0 x1 x2 x3) (y0 y1 y2 y3) (z0 z1 z2 z3).
+            const __m128 x2y2x3y3 = _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 1, 3, 2 ) );
+            const __m128 y0z0y1z1 = _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 0, 2, 1 ) );
+            const __m128 x        = _mm_shuffle_ps( a, x2y2x3y3, _MM_SHUFFLE( 2, 0, 3, 0 ) );
+            const __m128 y        = _mm_shuffle_ps( y0z0y1z1, x2y2x3y3, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+            const __m128 z        = _mm_shuffle_ps( y0z0y1z1, c, _MM_SHUFFLE( 3, 0, 3, 1 ) );
+
+            const __m128 rx = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m11 ), _mm_mul_ps( y, m21 ) ), _mm_add_ps( _mm_mul_ps( z, m31 ), t1 ) );
+            const __m128 ry = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m12 ), _mm_mul_ps( y, m22 ) ), _mm_add_ps( _mm_mul_ps( z, m32 ), t2 ) );
+            const __m128 rz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m13 ), _mm_mul_ps( y, m23 ) ), _mm_add_ps( _mm_mul_ps( z, m33 ), t3 ) );
+
+            // Transpose back and store.
+            const __m128 x0x1y0y1 = _mm_shuffle_ps( rx, ry, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+            const __m128 z0z1x1x2 = _mm_shuffle_ps( rz, rx, _MM_SHUFFLE( 2, 1, 1, 0 ) );
+            const __m128 y1y2z1z2 = _mm_shuffle_ps( ry, rz, _MM_SHUFFLE( 2, 1, 2, 1 ) );
+            const __m128 x2x3y2y3 = _mm_shuffle_ps( rx, ry, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+            const __m128 z2z3x3x3 = _mm_shuffle_ps( rz, rx, _MM_SHUFFLE( 3, 3, 3, 2 ) );
+            const __m128 y3y3z3z3 = _mm_shuffle_ps( ry, rz, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+
+            _mm_storeu_ps( dstData,     _mm_shuffle_ps( x0x1y0y1, z0z1x1x2, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+            _mm_storeu_ps( dstData + 4, _mm_shuffle_ps( y1y2z1z2, x2x3y2y3, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+            _mm_storeu_ps( dstData + 8, _mm_shuffle_ps( z2z3x3x3, y3y3z3z3, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+        }
+
+        if ( translate )
+        {
+            for ( size_t idx = simdCount; idx < count; ++idx )
+                dst[ idx ] = src[ idx ] * transform;
+        }
+        else
+        {
+            const float33 rotation = transform.getOrientation();
+
+            for ( size_t idx = simdCount; idx < count; ++idx )
+                dst[ idx ] = src[ idx ] * rotation;
+        }
+    }
+}
+
 std::shared_ptr< BlockMesh > MeshUtil::mergeMeshes( const std::vector< std::shared_ptr< BlockMesh > >& meshes, const std::vector< float43 >& transforms )
 {
     if ( meshes.empty() )
@@ -37,50 +115,100 @@ std::shared_ptr< BlockMesh > MeshUtil::mergeMeshes( const std::vector< std::shar
             throw std::exception( "MeshUtil::mergeMeshes - some of the passed meshes have normals/tangents and some do not. Merging is possible only if all meshes (or none) have normals/tangents." );
     }
 
-    std::shared_ptr< BlockMesh > mergedMesh = std::make_shared< BlockMesh >( vertexCount, hasNormalsTangents, texcoordSetCount, triangleCount );
+    // Calculate where each input mesh starts in the merged mesh.
+    std::vector< int > vertexOffsets( meshes.size() );
+    std::vector< int > triangleOffsets( meshes.size() );
+    for ( int meshIdx = 0, vertexOffset = 0, triangleOffset = 0; meshIdx < (int)meshes.size(); ++meshIdx )
+    {
+        vertexOffsets[ meshIdx ]   = vertexOffset;
+        triangleOffsets[ meshIdx ] = triangleOffset;
 
-    // Copy vertex data from input meshes to the merged mesh.
-    // Recalculate vertex indices in triangles taken from input meshes.
-    int vertexIndexShift = 0;
-    int triangleIndexShift = 0;
-    std::vector< uint3 >& mergedMeshTriangles = mergedMesh->getTriangles();
+        vertexOffset   += (int)meshes[ meshIdx ]->getVertices().size();
+        triangleOffset += (int)meshes[ meshIdx ]->getTriangles().size();
+    }
+
+    // Split large meshes into chunks, so a single big mesh can also be processed by many threads.
+    struct Chunk
+    {
+        int meshIdx;
+        int vertexBegin, vertexEnd;
+        int triangleBegin, triangleEnd;
+    };
+
+    const int chunkSize = 64 * 1024;
 
-    for ( int meshIdx = 0; meshIdx < meshes.size(); ++meshIdx )
+    std::vector< Chunk > chunks;
+    for ( int meshIdx = 0; meshIdx < (int)meshes.size(); ++meshIdx )
     {
-        auto&       mesh      = meshes[meshIdx];
+        const int meshVertexCount   = (int)meshes[ meshIdx ]->getVertices().size();
+        const int meshTriangleCount = (int)meshes[ meshIdx ]->getTriangles().size();
+        const int meshChunkCount    = std::max( 1, ( std::max( meshVertexCount, meshTriangleCount ) + chunkSize - 1 ) / chunkSize );
 
-        const int meshVertexCount = (int)mesh->getVertices().size();
+        for ( int chunkIdx = 0; chunkIdx < meshChunkCount; ++chunkIdx )
+        {
+            chunks.push_back( { 
+                meshIdx,
+                (int)( (long long)meshVertexCount * chunkIdx / meshChunkCount ),   (int)( (long long)meshVertexCount * ( chunkIdx + 1 ) / meshChunkCount ),
+                (int)( (long long)meshTriangleCount * chunkIdx / meshChunkCount ), (int)( (long long)meshTriangleCount * ( chunkIdx + 1 ) / meshChunkCount )
+            } );
+        }
+    }
+
+    std::shared_ptr< BlockMesh > mergedMesh = std::make_shared< BlockMesh >( vertexCount, hasNormalsTangents, texcoordSetCount, triangleCount );
+
+    // Copy (and transform) vertex data from input meshes directly to their place in the merged mesh.
+    // Recalculate vertex indices in triangles taken from input meshes.
+    ParallelUtil::parallelFor( (int)chunks.size(), [ & ]( const int chunkIdx ) 
+    {
+        const Chunk&     chunk            = chunks[ chunkIdx ];
+        const BlockMesh& mesh             = *meshes[ chunk.meshIdx ];
+        const int        vertexIndexShift = vertexOffsets[ chunk.meshIdx ];
+        const size_t     srcVertexIdx     = chunk.vertexBegin;
+        const size_t     dstVertexIdx     = vertexIndexShift + chunk.vertexBegin;
+        const size_t     chunkVertexCount = chunk.vertexEnd - chunk.vertexBegin;
 
-        std::memcpy( &mergedMesh->getVertices()[ vertexIndexShift ], mesh->getVertices().data(), meshVertexCount * sizeof( float3 ) );
-        std::memcpy( &mergedMesh->getNormals()[ vertexIndexShift ], mesh->getNormals().data(), meshVertexCount * sizeof( float3 ) );
-        std::memcpy( &mergedMesh->getTangents()[ vertexIndexShift ], mesh->getTangents().data(), meshVertexCount * sizeof( float3 ) );
+        if ( transforms.empty() )
+        {
+            std::copy_n( mesh.m_vertices.data() + srcVertexIdx, chunkVertexCount, mergedMesh->m_vertices.data() + dstVertexIdx );
 
-        // Transform newly merged vertices.
-        if ( !transforms.empty() )
+            if ( hasNormalsTangents )
+                std::copy_n( mesh.m_normals.data() + srcVertexIdx, chunkVertexCount, mergedMesh->m_normals.data() + dstVertexIdx );
+        }
+        else
         {
-            MeshUtil::transformVertices( *mergedMesh, transforms[meshIdx], vertexIndexShift, vertexIndexShift + meshVertexCount );
+            const float43& transform = transforms[ chunk.meshIdx ];
+
+            transformFloat3s( mesh.m_vertices.data() + srcVertexIdx, mergedMesh->m_vertices.data() + dstVertexIdx, chunkVertexCount, transform, true );
+
+            if ( hasNormalsTangents )
+                transformFloat3s( mesh.m_normals.data() + srcVertexIdx, mergedMesh->m_normals.data() + dstVertexIdx, chunkVertexCount, transform, false );
         }
 
+        // Tangents may be missing in some meshes (ex: without texcoords) - fill with zeros then.
+        if ( hasNormalsTangents && mesh.m_tangents.empty() )
+            std::fill_n( mergedMesh->m_tangents.data() + dstVertexIdx, chunkVertexCount, float3::ZERO );
+        else if ( hasNormalsTangents && transforms.empty() )
+            std::copy_n( mesh.m_tangents.data() + srcVertexIdx, chunkVertexCount, mergedMesh->m_tangents.data() + dstVertexIdx );
+        else if ( hasNormalsTangents )
+            transformFloat3s( mesh.m_tangents.data() + srcVertexIdx, mergedMesh->m_tangents.data() + dstVertexIdx, chunkVertexCount, transforms[ chunk.meshIdx ], false );
+
         // Copy texcoords or fill with zeros if not present in input mesh.
         for ( int texcoordSetIndex = 0; texcoordSetIndex < texcoordSetCount; ++texcoordSetIndex )
         {
-            if ( mesh->getTexcoordsCount() > texcoordSetIndex )
-                std::memcpy( &mergedMesh->getTexcoords( texcoordSetIndex )[ vertexIndexShift ], mesh->getTexcoords( texcoordSetIndex ).data(), meshVertexCount * sizeof( float2 ) );
+            if ( mesh.getTexcoordsCount() > texcoordSetIndex )
+                std::copy_n( mesh.m_texcoords[ texcoordSetIndex ].data() + srcVertexIdx, chunkVertexCount, mergedMesh->m_texcoords[ texcoordSetIndex ].data() + dstVertexIdx );
             else
-                std::memset( &mergedMesh->getTexcoords( texcoordSetIndex )[ vertexIndexShift ], 0, meshVertexCount * sizeof( float2 ) );
+                std::fill_n( mergedMesh->m_texcoords[ texcoordSetIndex ].data() + dstVertexIdx, chunkVertexCount, float2::ZERO );
         }
 
-        const int meshTriangleCount = (int)mesh->getTriangles().size();
-
         const uint3 vertexIndexShiftVec( vertexIndexShift, vertexIndexShift, vertexIndexShift );
 
         // Copy triangles from input mesh to the merged mesh - but recalculate it's indices to account for shift in vertices.
-        for ( int triangleIndex = 0; triangleIndex < meshTriangleCount; ++triangleIndex )
-            mergedMeshTriangles[ triangleIndexShift + triangleIndex ] = mesh->getTriangles()[ triangleIndex ] + vertexIndexShiftVec;
-
-        vertexIndexShift   += (int)mesh->getVertices().size();
-        triangleIndexShift += (int)mesh->getTriangles().size();
-    }
+        uint3*       dstTriangles = mergedMesh->m_triangles.data() + triangleOffsets[ chunk.meshIdx ];
+        const uint3* srcTriangles = mesh.m_triangles.data();
+        for ( int triangleIndex = chunk.triangleBegin; triangleIndex < chunk.triangleEnd; ++triangleIndex )
+            dstTriangles[ triangleIndex ] = srcTriangles[ triangleIndex ] + vertexIndexShiftVec;
+    } );
 
     return mergedMesh;
 }
@@ -110,6 +238,10 @@ void MeshUtil::flipNormals( BlockMesh& mesh )
     {
         normal = -normal;
     }
+
+    // Front side of meshlet triangles is found using normals - normal cones are flipped.
+    if ( mesh.m_meshlets )
+        mesh.m_meshlets->updateBounds( mesh );
 }
 
 void MeshUtil::invertVertexWindingOrder( BlockMesh& mesh )
@@ -121,18 +253,1204 @@ void MeshUtil::invertVertexWindingOrder( BlockMesh& mesh )
         triangle.x = triangleTemp.z;
         triangle.z = triangleTemp.x;
     }
+
+    if ( mesh.m_meshlets )
+    {
+        std::vector< unsigned char >& meshletTriangles = mesh.m_meshlets->m_triangles;
+
+        for ( size_t localIdx = 0; localIdx + 2 < meshletTriangles.size(); localIdx += 3 )
+            std::swap( meshletTriangles[ localIdx ], meshletTriangles[ localIdx + 2 ] );
+
+        mesh.m_meshlets->updateBounds( mesh );
+    }
+}
+
+void MeshUtil::calculateTangents( BlockMesh& mesh )
+{
+    if ( mesh.m_normals.size() != mesh.m_vertices.size() || mesh.m_texcoords.empty() || mesh.m_texcoords.front().size() != mesh.m_vertices.size() )
+    {
+        mesh.m_tangents.clear();
+        return;
+    }
+
+    const std::vector< float3 >& vertices  = mesh.m_vertices;
+    const std::vector< float3 >& normals   = mesh.m_normals;
+    const std::vector< float2 >& texcoords = mesh.m_texcoords.front();
+    const std::vector< uint3 >&  triangles = mesh.m_triangles;
+
+    const size_t vertexCount   = vertices.size();
+    const size_t triangleCount = triangles.size();
+    const size_t minRangeSize  = 16 * 1024;
+
+    // Calculate normalized tangent of each triangle (zero for triangles with degenerate texcoords).
+    std::vector< float3 > triangleTangents( triangleCount );
+
+    ParallelUtil::parallelForRanges( triangleCount, minRangeSize, [ & ]( const size_t begin, const size_t end ) {
+        for ( size_t triangleIdx = begin; triangleIdx < end; ++triangleIdx )
+        {
+            const uint3& triangle = triangles[ triangleIdx ];
+
+            const float3 edge1 = vertices[ triangle.y ] - vertices[ triangle.x ];
+            const float3 edge2 = vertices[ triangle.z ] - vertices[ triangle.x ];
+            const float2 deltaUV1 = texcoords[ triangle.y ] - texcoords[ triangle.x ];
+            const float2 deltaUV2 = texcoords[ triangle.z ] - texcoords[ triangle.x ];
+
+            const float determinant = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
+
+            // Note: Sign of the determinant is enough, as the tangent is normalized anyway.
+            float3 tangent = ( edge1 * deltaUV2.y - edge2 * deltaUV1.y ) * ( determinant >= 0.0f ? 1.0f : -1.0f );
+
+            if ( std::abs( determinant ) > 1e-20f && tangent.lengthSquare() > 0.0f )
+                tangent.normalize();
+            else
+                tangent = float3::ZERO;
+
+            triangleTangents[ triangleIdx ] = tangent;
+        }
+    } );
+
+    // Build a list of triangles using each vertex - allows to sum tangents for each vertex independently.
+    std::vector< unsigned int > vertexTrianglesOffsets( vertexCount + 1, 0 );
+    for ( const uint3& triangle : triangles )
+    {
+        ++vertexTrianglesOffsets[ triangle.x + 1 ];
+        ++vertexTrianglesOffsets[ triangle.y + 1 ];
+        ++vertexTrianglesOffsets[ triangle.z + 1 ];
+    }
+
+    for ( size_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+        vertexTrianglesOffsets[ vertexIdx + 1 ] += vertexTrianglesOffsets[ vertexIdx ];
+
+    std::vector< unsigned int > vertexTriangles( triangleCount * 3 );
+    {
+        std::vector< unsigned int > vertexTrianglesEnds( vertexTrianglesOffsets.begin(), vertexTrianglesOffsets.end() - 1 );
+        for ( size_t triangleIdx = 0; triangleIdx < triangleCount; ++triangleIdx )
+        {
+            const uint3& triangle = triangles[ triangleIdx ];
+
+            vertexTriangles[ vertexTrianglesEnds[ triangle.x ]++ ] = (unsigned int)triangleIdx;
+            vertexTriangles[ vertexTrianglesEnds[ triangle.y ]++ ] = (unsigned int)triangleIdx;
+            vertexTriangles[ vertexTrianglesEnds[ triangle.z ]++ ] = (unsigned int)triangleIdx;
+        }
+    }
+
+    mesh.m_tangents.resize( vertexCount );
+    std::vector< float3 >& tangents = mesh.m_tangents;
+
+    ParallelUtil::parallelForRanges( vertexCount, minRangeSize, [ & ]( const size_t begin, const size_t end ) {
+        for ( size_t vertexIdx = begin; vertexIdx < end; ++vertexIdx )
+        {
+            float3 tangent = float3::ZERO;
+            for ( unsigned int i = vertexTrianglesOffsets[ vertexIdx ]; i < vertexTrianglesOffsets[ vertexIdx + 1 ]; ++i )
+                tangent += triangleTangents[ vertexTriangles[ i ] ];
+
+            // Gram-Schmidt orthogonalization.
+            const float3& normal = normals[ vertexIdx ];
+            tangent -= normal * dot( normal, tangent );
+
+            if ( tangent.lengthSquare() < 1e-12f )
+            {
+                // Any vector perpendicular to the normal.
+                tangent = std::abs( normal.x ) < 0.9f ? cross( normal, float3( 1.0f, 0.0f, 0.0f ) ) : cross( normal, float3( 0.0f, 1.0f, 0.0f ) );
+
+                if ( tangent.lengthSquare() == 0.0f )
+                    tangent = float3( 1.0f, 0.0f, 0.0f );
+            }
+
+            tangent.normalize();
+            tangents[ vertexIdx ] = tangent;
+        }
+    } );
+}
+
+MeshUtil::VertexWeldStats MeshUtil::weldVertices( BlockMesh& mesh, const float positionEpsilon, const float normalEpsilon, const float texcoordEpsilon )
+{
+    if ( mesh.m_bvhTree || mesh.m_meshlets )
+        throw std::exception( "MeshUtil::weldVertices - has to be called before building the BVH tree and meshlets." );
+
+    if ( positionEpsilon < 0.0f || normalEpsilon < 0.0f || texcoordEpsilon < 0.0f )
+        throw std::exception( "MeshUtil::weldVertices - epsilons can't be negative." );
+
+    const int vertexCount = (int)mesh.m_vertices.size();
+
+    VertexWeldStats stats = { vertexCount, vertexCount, 0, 0.0f };
+
+    if ( vertexCount == 0 )
+        return stats;
+
+    // Spatial hash - vertices are grouped by grid cells (twice the epsilon in size), so similar vertices are in the same cell 
+    // or in one of the neighboring cells on the side closer to the vertex (8 cells in total).
+    const float cellSizeInv = 1.0f / std::max( positionEpsilon * 2.0f, 1e-7f );
+    const int   bucketCount = (int)std::min( (size_t)1 << 30, std::max( (size_t)1024, (size_t)1 << (int)std::ceil( std::log2( (double)vertexCount * 2.0 ) ) ) );
+
+    const auto getCell = [ cellSizeInv ]( const float3& position ) {
+        return std::make_tuple( (long long)std::floor( position.x * cellSizeInv ), (long long)std::floor( position.y * cellSizeInv ), (long long)std::floor( position.z * cellSizeInv ) );
+    };
+
+    // Returns -1 or 1 depending on which neighboring cell is closer.
+    const auto getNeighborCellDirection = [ cellSizeInv ]( const float position, const long long cell ) {
+        return position * cellSizeInv - (float)cell < 0.5f ? -1ll : 1ll;
+    };
+
+    const auto getCellHash = []( const long long x, const long long y, const long long z ) {
+        const unsigned long long hash = (unsigned long long)x * 73856093ull ^ (unsigned long long)y * 19349663ull ^ (unsigned long long)z * 83492791ull;
+        return hash ^ ( hash >> 29 );
+    };
+
+    const auto getBucket = [ bucketCount ]( const unsigned long long cellHash ) {
+        return (int)( cellHash & (unsigned long long)( bucketCount - 1 ) );
+    };
+
+    // Vertices sorted by bucket (counting sort, so vertices in a bucket are in increasing order).
+    // Cell hash of each vertex is stored next to it, to quickly skip vertices from other cells sharing the bucket.
+    std::vector< int >                bucketOffsets( bucketCount + 1, 0 );
+    std::vector< int >                bucketVertices( vertexCount );
+    std::vector< unsigned long long > bucketVerticesCellHashes( vertexCount );
+    {
+        std::vector< unsigned long long > vertexCellHashes( vertexCount );
+
+        ParallelUtil::parallelForRanges( vertexCount, 16 * 1024, [ & ]( const size_t begin, const size_t end ) {
+            for ( size_t vertexIdx = begin; vertexIdx < end; ++vertexIdx )
+            {
+                long long x, y, z;
+                std::tie( x, y, z ) = getCell( mesh.m_vertices[ vertexIdx ] );
+                vertexCellHashes[ vertexIdx ] = getCellHash( x, y, z );
+            }
+        } );
+
+        for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+            ++bucketOffsets[ getBucket( vertexCellHashes[ vertexIdx ] ) + 1 ];
+
+        for ( int bucketIdx = 0; bucketIdx < bucketCount; ++bucketIdx )
+            bucketOffsets[ bucketIdx + 1 ] += bucketOffsets[ bucketIdx ];
+
+        std::vector< int > insertPositions( bucketOffsets.begin(), bucketOffsets.end() - 1 );
+        for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+        {
+            const int insertPosition = insertPositions[ getBucket( vertexCellHashes[ vertexIdx ] ) ]++;
+
+            bucketVertices[ insertPosition ]           = vertexIdx;
+            bucketVerticesCellHashes[ insertPosition ] = vertexCellHashes[ vertexIdx ];
+        }
+    }
+
+    const auto areSimilar = [ &mesh, positionEpsilon, normalEpsilon, texcoordEpsilon ]( const int vertexIdx1, const int vertexIdx2 ) {
+        const auto areSimilar3 = []( const float3& a, const float3& b, const float epsilon ) {
+            return std::abs( a.x - b.x ) <= epsilon && std::abs( a.y - b.y ) <= epsilon && std::abs( a.z - b.z ) <= epsilon;
+        };
+
+        if ( !areSimilar3( mesh.m_vertices[ vertexIdx1 ], mesh.m_vertices[ vertexIdx2 ], positionEpsilon ) )
+            return false;
+
+        if ( !mesh.m_normals.empty() && !areSimilar3( mesh.m_normals[ vertexIdx1 ], mesh.m_normals[ vertexIdx2 ], normalEpsilon ) )
+            return false;
+
+        if ( !mesh.m_tangents.empty() && !areSimilar3( mesh.m_tangents[ vertexIdx1 ], mesh.m_tangents[ vertexIdx2 ], normalEpsilon ) )
+            return false;
+
+        for ( const auto& texcoords : mesh.m_texcoords )
+        {
+            if ( std::abs( texcoords[ vertexIdx1 ].x - texcoords[ vertexIdx2 ].x ) > texcoordEpsilon 
+                 || std::abs( texcoords[ vertexIdx1 ].y - texcoords[ vertexIdx2 ].y ) > texcoordEpsilon )
+                return false;
+        }
+
+        return true;
+    };
+
+    // For each vertex find the first similar vertex (or itself).
+    std::vector< int > firstSimilarVertices( vertexCount );
+
+    ParallelUtil::parallelForRanges( vertexCount, 16 * 1024, [ & ]( const size_t begin, const size_t end ) {
+        for ( size_t vertexIdx = begin; vertexIdx < end; ++vertexIdx )
+        {
+            const float3& position = mesh.m_vertices[ vertexIdx ];
+
+            long long x, y, z;
+            std::tie( x, y, z ) = getCell( position );
+
+            const long long dx = getNeighborCellDirection( position.x, x );
+            const long long dy = getNeighborCellDirection( position.y, y );
+            const long long dz = getNeighborCellDirection( position.z, z );
+
+            int firstSimilarVertexIdx = (int)vertexIdx;
+            for ( int neighborIdx = 0; neighborIdx < 8; ++neighborIdx )
+            {
+                const unsigned long long cellHash  = getCellHash( x + ( neighborIdx & 1 ? dx : 0 ), y + ( neighborIdx & 2 ? dy : 0 ), z + ( neighborIdx & 4 ? dz : 0 ) );
+                const int                bucketIdx = getBucket( cellHash );
+
+                // Vertices in a bucket are sorted - only the earlier ones are interesting.
+                for ( int idx = bucketOffsets[ bucketIdx ]; idx < bucketOffsets[ bucketIdx + 1 ] && bucketVertices[ idx ] < firstSimilarVertexIdx; ++idx )
+                {
+                    if ( bucketVerticesCellHashes[ idx ] == cellHash && areSimilar( bucketVertices[ idx ], (int)vertexIdx ) )
+                    {
+                        firstSimilarVertexIdx = bucketVertices[ idx ];
+                        break;
+                    }
+                }
+            }
+
+            firstSimilarVertices[ vertexIdx ] = firstSimilarVertexIdx;
+        }
+    } );
+
+    // Assign new indices - welded vertices take the index of the vertex they are welded to (which always comes earlier).
+    std::vector< int > newVertexIndices( vertexCount );
+    std::vector< int > keptVertices;
+    for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+    {
+        if ( firstSimilarVertices[ vertexIdx ] == vertexIdx )
+        {
+            newVertexIndices[ vertexIdx ] = (int)keptVertices.size();
+            keptVertices.push_back( vertexIdx );
+        }
+        else
+        {
+            newVertexIndices[ vertexIdx ] = newVertexIndices[ firstSimilarVertices[ vertexIdx ] ];
+        }
+    }
+
+    const int newVertexCount = (int)keptVertices.size();
+
+    // Compact vertex attributes.
+    const auto compact = [ &keptVertices, newVertexCount ]( auto& attributes ) {
+        if ( attributes.empty() )
+            return;
+
+        typename std::decay< decltype( attributes ) >::type compactedAttributes( newVertexCount );
+
+        ParallelUtil::parallelForRanges( newVertexCount, 64 * 1024, [ & ]( const size_t begin, const size_t end ) {
+            for ( size_t vertexIdx = begin; vertexIdx < end; ++vertexIdx )
+                compactedAttributes[ vertexIdx ] = attributes[ keptVertices[ vertexIdx ] ];
+        } );
+
+        attributes.swap( compactedAttributes );
+    };
+
+    if ( newVertexCount < vertexCount )
+    {
+        compact( mesh.m_vertices );
+        compact( mesh.m_normals );
+        compact( mesh.m_tangents );
+
+        for ( auto& texcoords : mesh.m_texcoords )
+            compact( texcoords );
+    }
+
+    // Remap triangles and remove the degenerate ones.
+    ParallelUtil::parallelForRanges( mesh.m_triangles.size(), 64 * 1024, [ & ]( const size_t begin, const size_t end ) {
+        for ( size_t triangleIdx = begin; triangleIdx < end; ++triangleIdx )
+        {
+            uint3& triangle = mesh.m_triangles[ triangleIdx ];
+            triangle = uint3( newVertexIndices[ triangle.x ], newVertexIndices[ triangle.y ], newVertexIndices[ triangle.z ] );
+        }
+    } );
+
+    size_t triangleCount = 0;
+    for ( const uint3& triangle : mesh.m_triangles )
+    {
+        if ( triangle.x != triangle.y && triangle.y != triangle.z && triangle.z != triangle.x )
+            mesh.m_triangles[ triangleCount++ ] = triangle;
+    }
+
+    stats.removedTriangleCount = (int)( mesh.m_triangles.size() - triangleCount );
+    stats.vertexCountAfter     = newVertexCount;
+    stats.reductionRatio       = 1.0f - (float)newVertexCount / (float)vertexCount;
+
+    mesh.m_triangles.resize( triangleCount );
+
+    return stats;
+}
+
+BlockMesh::InterleavedVertexFormat MeshUtil::getInterleavedVertexFormat( const BlockMesh& mesh, const bool includePositions )
+{
+    const size_t vertexCount = mesh.m_vertices.size();
+
+    BlockMesh::InterleavedVertexFormat format = { 0, -1, -1, -1, -1 };
+
+    const auto addAttribute = [ &format ]( int& offset, const unsigned int size ) {
+        offset = (int)format.stride;
+        format.stride += size;
+    };
+
+    if ( includePositions )
+        addAttribute( format.positionOffset, sizeof( float3 ) );
+
+    if ( !mesh.m_normals.empty() && mesh.m_normals.size() == vertexCount )
+        addAttribute( format.normalOffset, sizeof( float3 ) );
+
+    if ( !mesh.m_tangents.empty() && mesh.m_tangents.size() == vertexCount )
+        addAttribute( format.tangentOffset, sizeof( float3 ) );
+
+    if ( !mesh.m_texcoords.empty() && mesh.m_texcoords.front().size() == vertexCount )
+        addAttribute( format.texcoordOffset, sizeof( float2 ) );
+
+    return format;
+}
+
+std::vector< char > MeshUtil::interleaveVertices( const BlockMesh& mesh, const BlockMesh::InterleavedVertexFormat& format )
+{
+    const size_t vertexCount = mesh.m_vertices.size();
+
+    std::vector< char > data( vertexCount * format.stride );
+
+    const float2* texcoords = format.texcoordOffset >= 0 ? mesh.m_texcoords.front().data() : nullptr;
+
+    // Note: Writing whole vertices one by one is several times faster than writing each attribute in a separate pass.
+    char* vertex = data.data();
+    for ( size_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, vertex += format.stride )
+    {
+        if ( format.positionOffset >= 0 ) std::memcpy( vertex + format.positionOffset, &mesh.m_vertices[ vertexIdx ], sizeof( float3 ) );
+        if ( format.normalOffset >= 0 )   std::memcpy( vertex + format.normalOffset, &mesh.m_normals[ vertexIdx ], sizeof( float3 ) );
+        if ( format.tangentOffset >= 0 )  std::memcpy( vertex + format.tangentOffset, &mesh.m_tangents[ vertexIdx ], sizeof( float3 ) );
+        if ( texcoords )                  std::memcpy( vertex + format.texcoordOffset, &texcoords[ vertexIdx ], sizeof( float2 ) );
+    }
+
+    return data;
+}
+
+void MeshUtil::deinterleaveVertices( BlockMesh& mesh, const std::vector< char >& data, const BlockMesh::InterleavedVertexFormat& format )
+{
+    if ( format.stride == 0 || data.size() % format.stride != 0 )
+        throw std::exception( "MeshUtil::deinterleaveVertices - data size is not a multiple of the vertex stride." );
+
+    const size_t vertexCount = data.size() / format.stride;
+
+    if ( format.positionOffset >= 0 ) mesh.m_vertices.resize( vertexCount );
+    if ( format.normalOffset >= 0 )   mesh.m_normals.resize( vertexCount );
+    if ( format.tangentOffset >= 0 )  mesh.m_tangents.resize( vertexCount );
+
+    float2* texcoords = nullptr;
+    if ( format.texcoordOffset >= 0 )
+    {
+        if ( mesh.m_texcoords.empty() )
+            mesh.m_texcoords.emplace_back();
+
+        mesh.m_texcoords.front().resize( vertexCount );
+        texcoords = mesh.m_texcoords.front().data();
+    }
+
+    const char* vertex = data.data();
+    for ( size_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, vertex += format.stride )
+    {
+        if ( format.positionOffset >= 0 ) std::memcpy( static_cast< void* >( &mesh.m_vertices[ vertexIdx ] ), vertex + format.positionOffset, sizeof( float3 ) );
+        if ( format.normalOffset >= 0 )   std::memcpy( static_cast< void* >( &mesh.m_normals[ vertexIdx ] ), vertex + format.normalOffset, sizeof( float3 ) );
+        if ( format.tangentOffset >= 0 )  std::memcpy( static_cast< void* >( &mesh.m_tangents[ vertexIdx ] ), vertex + format.tangentOffset, sizeof( float3 ) );
+        if ( texcoords )                  std::memcpy( static_cast< void* >( &texcoords[ vertexIdx ] ), vertex + format.texcoordOffset, sizeof( float2 ) );
+    }
 }
 
 void MeshUtil::transformVertices( BlockMesh& mesh, const float43& transform, const int startVertexIdx, const int endVertexIndex )
 {
-    const auto rotation = transform.getOrientation();
+    if ( startVertexIdx < 0 || endVertexIndex > (int)mesh.m_vertices.size() || startVertexIdx > endVertexIndex )
+        throw std::exception( "MeshUtil::transformVertices - invalid vertex range." );
+
+    const size_t rangeSize = endVertexIndex - startVertexIdx;
+
+    ParallelUtil::parallelForRanges( rangeSize, 64 * 1024, [ & ]( const size_t begin, const size_t end ) 
+    {
+        const size_t idx   = startVertexIdx + begin;
+        const size_t count = end - begin;
+
+        transformFloat3s( mesh.m_vertices.data() + idx, mesh.m_vertices.data() + idx, count, transform, true );
+
+        if ( !mesh.m_normals.empty() )
+            transformFloat3s( mesh.m_normals.data() + idx, mesh.m_normals.data() + idx, count, transform, false );
+
+        if ( !mesh.m_tangents.empty() )
+            transformFloat3s( mesh.m_tangents.data() + idx, mesh.m_tangents.data() + idx, count, transform, false );
+    } );
+
+    // Bounding spheres and normal cones of meshlets no longer match the vertices.
+    if ( mesh.m_meshlets )
+        mesh.m_meshlets->updateBounds( mesh );
+}
+
+namespace
+{
+    // Reorders triangles using Tipsify - "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (Sander, Nehab, Barczak 2007).
+    // Keeps its buffers between calls, as it's called for each BVH leaf.
+    class TriangleOrderOptimizer
+    {
+        public:
+
+        // Triangles have to use local vertex indices (0 - vertexCount). 
+        // Returns the new order of triangles (indices into the input) and the end of each cluster - triangles between clusters don't share cached vertices.
+        void optimize( const std::vector< uint3 >& triangles, const int vertexCount, const int cacheSize, 
+                       std::vector< int >& order, std::vector< int >& clusterEnds )
+        {
+            const int triangleCount = (int)triangles.size();
+
+            order.clear();
+            clusterEnds.clear();
+
+            // Build vertex to triangle adjacency.
+            m_liveTriangleCounts.assign( vertexCount, 0 );
+            for ( const uint3& triangle : triangles )
+            {
+                ++m_liveTriangleCounts[ triangle.x ];
+                ++m_liveTriangleCounts[ triangle.y ];
+                ++m_liveTriangleCounts[ triangle.z ];
+            }
+
+            m_adjacencyOffsets.resize( vertexCount + 1 );
+            m_adjacencyOffsets[ 0 ] = 0;
+            for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+                m_adjacencyOffsets[ vertexIdx + 1 ] = m_adjacencyOffsets[ vertexIdx ] + m_liveTriangleCounts[ vertexIdx ];
+
+            m_adjacency.resize( m_adjacencyOffsets[ vertexCount ] );
+            m_adjacencyInsertOffsets.assign( m_adjacencyOffsets.begin(), m_adjacencyOffsets.end() - 1 );
+            for ( int triangleIdx = 0; triangleIdx < triangleCount; ++triangleIdx )
+            {
+                m_adjacency[ m_adjacencyInsertOffsets[ triangles[ triangleIdx ].x ]++ ] = triangleIdx;
+                m_adjacency[ m_adjacencyInsertOffsets[ triangles[ triangleIdx ].y ]++ ] = triangleIdx;
+                m_adjacency[ m_adjacencyInsertOffsets[ triangles[ triangleIdx ].z ]++ ] = triangleIdx;
+            }
+
+            m_cacheTimestamps.assign( vertexCount, 0 );
+            m_emitted.assign( triangleCount, false );
+            m_deadEndStack.clear();
+
+            int timestamp     = cacheSize + 1;
+            int scanVertexIdx = 0;
+            int fanningVertex = 0;
+
+            while ( fanningVertex >= 0 )
+            {
+                m_candidates.clear();
+
+                // Emit all remaining triangles around the fanning vertex.
+                for ( int adjacencyIdx = m_adjacencyOffsets[ fanningVertex ]; adjacencyIdx < m_adjacencyOffsets[ fanningVertex + 1 ]; ++adjacencyIdx )
+                {
+                    const int triangleIdx = m_adjacency[ adjacencyIdx ];
+
+                    if ( m_emitted[ triangleIdx ] )
+                        continue;
+
+                    const unsigned int vertices[ 3 ] = { triangles[ triangleIdx ].x, triangles[ triangleIdx ].y, triangles[ triangleIdx ].z };
+                    for ( const unsigned int vertex : vertices )
+                    {
+                        m_deadEndStack.push_back( vertex );
+                        m_candidates.push_back( vertex );
+
+                        --m_liveTriangleCounts[ vertex ];
+
+                        if ( timestamp - m_cacheTimestamps[ vertex ] > cacheSize )
+                            m_cacheTimestamps[ vertex ] = timestamp++;
+                    }
+
+                    m_emitted[ triangleIdx ] = true;
+                    order.push_back( triangleIdx );
+                }
+
+                // Pick the next fanning vertex - the one which will stay in the cache the longest after emitting all its triangles.
+                int nextVertex   = -1;
+                int bestPriority = -1;
+                for ( const unsigned int vertex : m_candidates )
+                {
+                    if ( m_liveTriangleCounts[ vertex ] <= 0 )
+                        continue;
+
+                    int priority = 0;
+                    if ( timestamp - m_cacheTimestamps[ vertex ] + 2 * m_liveTriangleCounts[ vertex ] <= cacheSize )
+                        priority = timestamp - m_cacheTimestamps[ vertex ];
+
+                    if ( priority > bestPriority )
+                    {
+                        bestPriority = priority;
+                        nextVertex   = (int)vertex;
+                    }
+                }
+
+                // Dead end - continue from a recently used vertex or any vertex with remaining triangles. It's the end of a cluster.
+                if ( nextVertex < 0 )
+                {
+                    if ( !order.empty() && ( clusterEnds.empty() || clusterEnds.back() != (int)order.size() ) )
+                        clusterEnds.push_back( (int)order.size() );
+
+                    while ( !m_deadEndStack.empty() && nextVertex < 0 )
+                    {
+                        const unsigned int vertex = m_deadEndStack.back();
+                        m_deadEndStack.pop_back();
+
+                        if ( m_liveTriangleCounts[ vertex ] > 0 )
+                            nextVertex = (int)vertex;
+                    }
+
+                    while ( scanVertexIdx < vertexCount && nextVertex < 0 )
+                    {
+                        if ( m_liveTriangleCounts[ scanVertexIdx ] > 0 )
+                            nextVertex = scanVertexIdx;
+
+                        ++scanVertexIdx;
+                    }
+                }
+
+                fanningVertex = nextVertex;
+            }
+
+            if ( clusterEnds.empty() || clusterEnds.back() != (int)order.size() )
+                clusterEnds.push_back( (int)order.size() );
+        }
+
+        private:
+
+        std::vector< int >          m_liveTriangleCounts;
+        std::vector< int >          m_adjacencyOffsets;
+        std::vector< int >          m_adjacencyInsertOffsets;
+        std::vector< int >          m_adjacency;
+        std::vector< int >          m_cacheTimestamps;
+        std::vector< bool >         m_emitted;
+        std::vector< unsigned int > m_deadEndStack;
+        std::vector< unsigned int > m_candidates;
+    };
+}
+
+MeshUtil::VertexCacheStats MeshUtil::calculateVertexCacheStats( const BlockMesh& mesh, const int cacheSize )
+{
+    VertexCacheStats stats = { 0.0f, 0.0f };
+
+    if ( mesh.m_triangles.empty() || mesh.m_vertices.empty() )
+        return stats;
 
-    for ( int idx = startVertexIdx; idx <= endVertexIndex; ++idx )
-        mesh.m_vertices[idx] = mesh.m_vertices[idx] * transform;
+    // Vertex is in the FIFO cache if fewer than cache size vertices were added to the cache since it was added itself.
+    std::vector< long long > cacheInsertTimes( mesh.m_vertices.size(), LLONG_MIN / 2 );
 
-    for ( int idx = startVertexIdx; idx <= endVertexIndex; ++idx )
-        mesh.m_normals[idx] = mesh.m_normals[idx] * rotation;
+    long long missCount = 0;
 
-    for ( int idx = startVertexIdx; idx <= endVertexIndex; ++idx )
-        mesh.m_tangents[idx] = mesh.m_tangents[idx] * rotation;
-}
\ No newline at end of file
+    for ( const uint3& triangle : mesh.m_triangles )
+    {
+        const unsigned int vertices[ 3 ] = { triangle.x, triangle.y, triangle.z };
+        for ( const unsigned int vertex : vertices )
+        {
+            if ( missCount - cacheInsertTimes[ vertex ] > cacheSize )
+                cacheInsertTimes[ vertex ] = missCount++;
+        }
+    }
+
+    stats.acmr = (float)missCount / (float)mesh.m_triangles.size();
+    stats.atvr = (float)missCount / (float)mesh.m_vertices.size();
+
+    return stats;
+}
+
+void MeshUtil::optimizeTriangleOrder( BlockMesh& mesh, const int cacheSize )
+{
+    if ( mesh.m_triangles.empty() )
+        return;
+
+    // Ranges of triangles which can be freely reordered.
+    std::vector< std::pair< int, int > > ranges;
+
+    if ( mesh.m_bvhTree )
+    {
+        if ( !mesh.m_bvhTree->getTriangles().empty() )
+            throw std::exception( "MeshUtil::optimizeTriangleOrder - mesh triangles have to be reorganized to match the BVH tree first." );
+
+        for ( const BVHTreeBuffer::Node& node : mesh.m_bvhTree->getNodes() )
+        {
+            // Top-most bit set - leaf node.
+            if ( node.node.leaf.triangleCount & 0x80000000 )
+            {
+                const int firstTriangleIdx = (int)node.node.leaf.firstTriangleIndex;
+                const int triangleCount    = (int)( node.node.leaf.triangleCount & 0x7FFFFFFF );
+
+                ranges.push_back( std::make_pair( firstTriangleIdx, firstTriangleIdx + triangleCount ) );
+            }
+        }
+    }
+    else
+    {
+        ranges.push_back( std::make_pair( 0, (int)mesh.m_triangles.size() ) );
+    }
+
+    // Mesh center - weighted by triangle area.
+    float3 meshCenter( 0.0f, 0.0f, 0.0f );
+    float  meshArea = 0.0f;
+    for ( const uint3& triangle : mesh.m_triangles )
+    {
+        const float3& vertex1 = mesh.m_vertices[ triangle.x ];
+        const float3& vertex2 = mesh.m_vertices[ triangle.y ];
+        const float3& vertex3 = mesh.m_vertices[ triangle.z ];
+
+        const float area = cross( vertex2 - vertex1, vertex3 - vertex1 ).length();
+
+        meshCenter += ( vertex1 + vertex2 + vertex3 ) * ( area / 3.0f );
+        meshArea   += area;
+    }
+
+    if ( meshArea > 0.0f )
+        meshCenter /= meshArea;
+
+    TriangleOrderOptimizer optimizer;
+
+    std::vector< int >          localVertexIndices( mesh.m_vertices.size(), -1 );
+    std::vector< unsigned int > usedVertices;
+    std::vector< uint3 >        localTriangles;
+    std::vector< uint3 >        rangeTriangles;
+    std::vector< int >          order;
+    std::vector< int >          clusterEnds;
+
+    struct Cluster
+    {
+        int   begin;
+        int   end;
+        float sortKey;
+    };
+
+    std::vector< Cluster > clusters;
+
+    for ( const auto& range : ranges )
+    {
+        if ( range.second - range.first < 2 )
+            continue;
+
+        rangeTriangles.assign( mesh.m_triangles.begin() + range.first, mesh.m_triangles.begin() + range.second );
+
+        // Remap vertices to local indices.
+        localTriangles.clear();
+        for ( const uint3& triangle : rangeTriangles )
+        {
+            uint3 localTriangle;
+            unsigned int* localVertices  = &localTriangle.x;
+            const unsigned int* vertices = &triangle.x;
+
+            for ( int i = 0; i < 3; ++i )
+            {
+                int& localVertexIdx = localVertexIndices[ vertices[ i ] ];
+                if ( localVertexIdx < 0 )
+                {
+                    localVertexIdx = (int)usedVertices.size();
+                    usedVertices.push_back( vertices[ i ] );
+                }
+
+                localVertices[ i ] = (unsigned int)localVertexIdx;
+            }
+
+            localTriangles.push_back( localTriangle );
+        }
+
+        optimizer.optimize( localTriangles, (int)usedVertices.size(), cacheSize, order, clusterEnds );
+
+        for ( const unsigned int vertex : usedVertices )
+            localVertexIndices[ vertex ] = -1;
+
+        usedVertices.clear();
+
+        // Sort clusters by how much they face away from the mesh center (ex: for convex meshes - draw front-facing triangles first).
+        clusters.clear();
+        int clusterBegin = 0;
+        for ( const int clusterEnd : clusterEnds )
+        {
+            float3 clusterCenter( 0.0f, 0.0f, 0.0f );
+            float3 clusterNormal( 0.0f, 0.0f, 0.0f );
+            float  clusterArea = 0.0f;
+
+            for ( int orderIdx = clusterBegin; orderIdx < clusterEnd; ++orderIdx )
+            {
+                const uint3&  triangle = rangeTriangles[ order[ orderIdx ] ];
+                const float3& vertex1  = mesh.m_vertices[ triangle.x ];
+                const float3& vertex2  = mesh.m_vertices[ triangle.y ];
+                const float3& vertex3  = mesh.m_vertices[ triangle.z ];
+
+                const float3 normal = cross( vertex2 - vertex1, vertex3 - vertex1 ); // Length is proportional to the area.
+                const float  area   = normal.length();
+
+                clusterCenter += ( vertex1 + vertex2 + vertex3 ) * ( area / 3.0f );
+                clusterNormal += normal;
+                clusterArea   += area;
+            }
+
+            float sortKey = 0.0f;
+            if ( clusterArea > 0.0f && clusterNormal.lengthSquare() > 0.0f )
+            {
+                clusterNormal.normalize();
+                sortKey = dot( clusterCenter / clusterArea - meshCenter, clusterNormal );
+            }
+
+            Cluster cluster = { clusterBegin, clusterEnd, sortKey };
+            clusters.push_back( cluster );
+
+            clusterBegin = clusterEnd;
+        }
+
+        std::stable_sort( clusters.begin(), clusters.end(), []( const Cluster& cluster1, const Cluster& cluster2 ) { return cluster1.sortKey > cluster2.sortKey; } );
+
+        int triangleIdx = range.first;
+        for ( const Cluster& cluster : clusters )
+        {
+            for ( int orderIdx = cluster.begin; orderIdx < cluster.end; ++orderIdx )
+                mesh.m_triangles[ triangleIdx++ ] = rangeTriangles[ order[ orderIdx ] ];
+        }
+    }
+}
+
+void MeshUtil::optimizeVertexOrder( BlockMesh& mesh )
+{
+    const int vertexCount = (int)mesh.m_vertices.size();
+
+    // New index for each vertex - in order of first use.
+    std::vector< int > newVertexIndices( vertexCount, -1 );
+    int nextVertexIdx = 0;
+
+    for ( uint3& triangle : mesh.m_triangles )
+    {
+        unsigned int* vertices = &triangle.x;
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            int& newVertexIdx = newVertexIndices[ vertices[ i ] ];
+            if ( newVertexIdx < 0 )
+                newVertexIdx = nextVertexIdx++;
+
+            vertices[ i ] = (unsigned int)newVertexIdx;
+        }
+    }
+
+    // Unused vertices are moved to the end.
+    for ( int& newVertexIdx : newVertexIndices )
+    {
+        if ( newVertexIdx < 0 )
+            newVertexIdx = nextVertexIdx++;
+    }
+
+    const auto reorder = [ &newVertexIndices ]( auto& attributes ) {
+        if ( attributes.empty() )
+            return;
+
+        auto reorderedAttributes = attributes;
+        for ( size_t vertexIdx = 0; vertexIdx < attributes.size(); ++vertexIdx )
+            reorderedAttributes[ newVertexIndices[ vertexIdx ] ] = attributes[ vertexIdx ];
+
+        attributes.swap( reorderedAttributes );
+    };
+
+    reorder( mesh.m_vertices );
+    reorder( mesh.m_normals );
+    reorder( mesh.m_tangents );
+
+    // Meshlets refer to vertices - remap them.
+    if ( mesh.m_meshlets )
+    {
+        for ( unsigned int& vertexIdx : mesh.m_meshlets->m_vertices )
+            vertexIdx = (unsigned int)newVertexIndices[ vertexIdx ];
+    }
+
+    for ( auto& texcoordsSet : mesh.m_texcoords )
+        reorder( texcoordsSet );
+}
+
+void MeshUtil::optimizeForRasterization( BlockMesh& mesh )
+{
+    optimizeTriangleOrder( mesh );
+    optimizeVertexOrder( mesh );
+}
+
+namespace
+{
+    // Symmetric 4x4 matrix - sum of squared distances to a set of planes.
+    struct Quadric
+    {
+        double a00, a01, a02, a03;
+        double      a11, a12, a13;
+        double           a22, a23;
+        double                a33;
+
+        Quadric() :
+            a00( 0.0 ), a01( 0.0 ), a02( 0.0 ), a03( 0.0 ),
+            a11( 0.0 ), a12( 0.0 ), a13( 0.0 ),
+            a22( 0.0 ), a23( 0.0 ),
+            a33( 0.0 )
+        {}
+
+        // Plane: dot( normal, point ) + distance = 0.
+        void addPlane( const float3& normal, const float distance, const float weight )
+        {
+            a00 += weight * normal.x * normal.x; a01 += weight * normal.x * normal.y; a02 += weight * normal.x * normal.z; a03 += weight * normal.x * distance;
+            a11 += weight * normal.y * normal.y; a12 += weight * normal.y * normal.z; a13 += weight * normal.y * distance;
+            a22 += weight * normal.z * normal.z; a23 += weight * normal.z * distance;
+            a33 += weight * distance * distance;
+        }
+
+        void add( const Quadric& other )
+        {
+            a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+            a11 += other.a11; a12 += other.a12; a13 += other.a13;
+            a22 += other.a22; a23 += other.a23;
+            a33 += other.a33;
+        }
+
+        double getError( const float3& point ) const
+        {
+            const double x = point.x;
+            const double y = point.y;
+            const double z = point.z;
+
+            return x * x * a00 + 2.0 * x * y * a01 + 2.0 * x * z * a02 + 2.0 * x * a03
+                 + y * y * a11 + 2.0 * y * z * a12 + 2.0 * y * a13
+                 + z * z * a22 + 2.0 * z * a23
+                 + a33;
+        }
+    };
+
+    struct Collapse
+    {
+        unsigned int from;
+        unsigned int to;
+        double       error;
+    };
+}
+
+std::shared_ptr< BlockMesh > MeshUtil::simplify( const BlockMesh& mesh, const int targetTriangleCount )
+{
+    if ( !mesh.isInCpuMemory() )
+        throw std::exception( "MeshUtil::simplify - mesh is not in CPU memory." );
+
+    const std::vector< float3 >& vertices    = mesh.m_vertices;
+    const int                    vertexCount = (int)vertices.size();
+
+    std::vector< uint3 > triangles = mesh.m_triangles;
+
+    // Find vertices which can't be removed.
+    std::vector< bool > locked( vertexCount, false );
+    {
+        // Border and non-manifold edges - each edge should be used exactly once in each direction.
+        // Note: Attribute seams also end up here, as triangles on both sides of a seam use different vertices.
+        const auto getEdgeKey = []( const unsigned int vertex1, const unsigned int vertex2 ) { 
+            return ( (unsigned long long)vertex1 << 32 ) | vertex2; 
+        };
+
+        std::unordered_map< unsigned long long, int > edgeCounts;
+        edgeCounts.reserve( triangles.size() * 3 );
+
+        for ( const uint3& triangle : triangles )
+        {
+            ++edgeCounts[ getEdgeKey( triangle.x, triangle.y ) ];
+            ++edgeCounts[ getEdgeKey( triangle.y, triangle.z ) ];
+            ++edgeCounts[ getEdgeKey( triangle.z, triangle.x ) ];
+        }
+
+        for ( const auto& edgeCount : edgeCounts )
+        {
+            const unsigned int vertex1 = (unsigned int)( edgeCount.first >> 32 );
+            const unsigned int vertex2 = (unsigned int)( edgeCount.first & 0xFFFFFFFF );
+
+            const auto oppositeEdgeCountIt = edgeCounts.find( getEdgeKey( vertex2, vertex1 ) );
+
+            if ( edgeCount.second != 1 || oppositeEdgeCountIt == edgeCounts.end() || oppositeEdgeCountIt->second != 1 )
+            {
+                locked[ vertex1 ] = true;
+                locked[ vertex2 ] = true;
+            }
+        }
+
+        // Seams - vertices split because of different attributes (ex: UVs), but sharing the same position.
+        std::vector< unsigned int > sortedVertices( vertexCount );
+        for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+            sortedVertices[ vertexIdx ] = (unsigned int)vertexIdx;
+
+        std::sort( sortedVertices.begin(), sortedVertices.end(), [ &vertices ]( const unsigned int vertex1, const unsigned int vertex2 ) {
+            const float3& position1 = vertices[ vertex1 ];
+            const float3& position2 = vertices[ vertex2 ];
+
+            if ( position1.x != position2.x ) return position1.x < position2.x;
+            if ( position1.y != position2.y ) return position1.y < position2.y;
+            return position1.z < position2.z;
+        } );
+
+        for ( int i = 1; i < vertexCount; ++i )
+        {
+            if ( vertices[ sortedVertices[ i ] ] == vertices[ sortedVertices[ i - 1 ] ] )
+            {
+                locked[ sortedVertices[ i ] ]     = true;
+                locked[ sortedVertices[ i - 1 ] ] = true;
+            }
+        }
+    }
+
+    // Sum of planes of the adjacent triangles for each vertex - weighted by triangle area.
+    std::vector< Quadric > quadrics( vertexCount );
+    for ( const uint3& triangle : triangles )
+    {
+        const float3& vertex1 = vertices[ triangle.x ];
+        const float3& vertex2 = vertices[ triangle.y ];
+        const float3& vertex3 = vertices[ triangle.z ];
+
+        float3      normal = cross( vertex2 - vertex1, vertex3 - vertex1 );
+        const float area   = normal.length();
+
+        if ( area <= 0.0f )
+            continue;
+
+        normal /= area;
+
+        const float distance = -dot( normal, vertex1 );
+
+        quadrics[ triangle.x ].addPlane( normal, distance, area );
+        quadrics[ triangle.y ].addPlane( normal, distance, area );
+        quadrics[ triangle.z ].addPlane( normal, distance, area );
+    }
+
+    std::vector< int >          adjacencyOffsets( vertexCount + 1 );
+    std::vector< int >          adjacencyInsertOffsets;
+    std::vector< int >          adjacency;
+    std::vector< Collapse >     collapses;
+    std::vector< bool >         touched;
+    std::vector< unsigned int > remap( vertexCount );
+
+    // Each collapse changes the neighborhood of the removed vertex. Many non-overlapping collapses are done in each pass.
+    while ( (int)triangles.size() > targetTriangleCount )
+    {
+        const int triangleCount = (int)triangles.size();
+
+        // Build vertex to triangle adjacency.
+        std::fill( adjacencyOffsets.begin(), adjacencyOffsets.end(), 0 );
+        for ( const uint3& triangle : triangles )
+        {
+            ++adjacencyOffsets[ triangle.x + 1 ];
+            ++adjacencyOffsets[ triangle.y + 1 ];
+            ++adjacencyOffsets[ triangle.z + 1 ];
+        }
+
+        for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+            adjacencyOffsets[ vertexIdx + 1 ] += adjacencyOffsets[ vertexIdx ];
+
+        adjacency.resize( adjacencyOffsets[ vertexCount ] );
+        adjacencyInsertOffsets.assign( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+        for ( int triangleIdx = 0; triangleIdx < triangleCount; ++triangleIdx )
+        {
+            adjacency[ adjacencyInsertOffsets[ triangles[ triangleIdx ].x ]++ ] = triangleIdx;
+            adjacency[ adjacencyInsertOffsets[ triangles[ triangleIdx ].y ]++ ] = triangleIdx;
+            adjacency[ adjacencyInsertOffsets[ triangles[ triangleIdx ].z ]++ ] = triangleIdx;
+        }
+
+        // Collect possible collapses - removed vertex is moved onto the other vertex of the edge.
+        // Note: Edges of unlocked vertices are always shared by two triangles (in opposite directions), so each edge is taken only from one of them.
+        collapses.clear();
+        for ( const uint3& triangle : triangles )
+        {
+            const unsigned int edges[ 3 ][ 2 ] = { { triangle.x, triangle.y }, { triangle.y, triangle.z }, { triangle.z, triangle.x } };
+
+            for ( const auto& edge : edges )
+            {
+                if ( edge[ 0 ] > edge[ 1 ] )
+                    continue;
+
+                for ( int direction = 0; direction < 2; ++direction )
+                {
+                    const unsigned int from = edge[ direction ];
+                    const unsigned int to   = edge[ 1 - direction ];
+
+                    if ( locked[ from ] )
+                        continue;
+
+                    Quadric quadric = quadrics[ from ];
+                    quadric.add( quadrics[ to ] );
+
+                    Collapse collapse = { from, to, quadric.getError( vertices[ to ] ) };
+                    collapses.push_back( collapse );
+                }
+            }
+        }
+
+        if ( collapses.empty() )
+            break;
+
+        // Only the cheapest collapses are done in each pass, so expensive collapses don't happen before cheaper ones, which become available in the next passes.
+        const auto compareCollapses = []( const Collapse& collapse1, const Collapse& collapse2 ) {
+            if ( collapse1.error != collapse2.error ) return collapse1.error < collapse2.error;
+            if ( collapse1.from != collapse2.from )   return collapse1.from < collapse2.from;
+            return collapse1.to < collapse2.to;
+        };
+
+        const size_t passCollapseCount = std::max( (size_t)1, collapses.size() / 4 );
+        std::nth_element( collapses.begin(), collapses.begin() + ( passCollapseCount - 1 ), collapses.end(), compareCollapses );
+        std::sort( collapses.begin(), collapses.begin() + passCollapseCount, compareCollapses );
+
+        touched.assign( vertexCount, false );
+        for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+            remap[ vertexIdx ] = (unsigned int)vertexIdx;
+
+        int removedTriangleCount = 0;
+        int collapseCount        = 0;
+
+        for ( size_t collapseIdx = 0; collapseIdx < passCollapseCount; ++collapseIdx )
+        {
+            if ( triangleCount - removedTriangleCount <= targetTriangleCount )
+                break;
+
+            const Collapse& collapse = collapses[ collapseIdx ];
+
+            if ( touched[ collapse.from ] || touched[ collapse.to ] )
+                continue;
+
+            // Reject collapses which flip (or almost flip) any of the remaining triangles.
+            bool flips                        = false;
+            int  collapseRemovedTriangleCount = 0;
+
+            for ( int adjacencyIdx = adjacencyOffsets[ collapse.from ]; adjacencyIdx < adjacencyOffsets[ collapse.from + 1 ] && !flips; ++adjacencyIdx )
+            {
+                const uint3& triangle = triangles[ adjacency[ adjacencyIdx ] ];
+
+                if ( triangle.x == collapse.to || triangle.y == collapse.to || triangle.z == collapse.to )
+                {
+                    ++collapseRemovedTriangleCount;
+                    continue;
+                }
+
+                const float3& vertex1 = vertices[ triangle.x ];
+                const float3& vertex2 = vertices[ triangle.y ];
+                const float3& vertex3 = vertices[ triangle.z ];
+
+                const float3& newVertex1 = triangle.x == collapse.from ? vertices[ collapse.to ] : vertex1;
+                const float3& newVertex2 = triangle.y == collapse.from ? vertices[ collapse.to ] : vertex2;
+                const float3& newVertex3 = triangle.z == collapse.from ? vertices[ collapse.to ] : vertex3;
+
+                const float3 normal    = cross( vertex2 - vertex1, vertex3 - vertex1 );
+                const float3 newNormal = cross( newVertex2 - newVertex1, newVertex3 - newVertex1 );
+
+                const float normalLength    = normal.length();
+                const float newNormalLength = newNormal.length();
+
+                if ( newNormalLength <= 0.0f || dot( normal, newNormal ) < 0.25f * normalLength * newNormalLength )
+                    flips = true;
+            }
+
+            if ( flips )
+                continue;
+
+            // Neighborhood of the removed vertex can't change anymore in this pass - flip test wouldn't be valid.
+            for ( int adjacencyIdx = adjacencyOffsets[ collapse.from ]; adjacencyIdx < adjacencyOffsets[ collapse.from + 1 ]; ++adjacencyIdx )
+            {
+                const uint3& triangle = triangles[ adjacency[ adjacencyIdx ] ];
+
+                touched[ triangle.x ] = true;
+                touched[ triangle.y ] = true;
+                touched[ triangle.z ] = true;
+            }
+
+            remap[ collapse.from ] = collapse.to;
+            quadrics[ collapse.to ].add( quadrics[ collapse.from ] );
+
+            removedTriangleCount += collapseRemovedTriangleCount;
+            ++collapseCount;
+        }
+
+        if ( collapseCount == 0 )
+            break;
+
+        // Apply collapses and remove degenerate triangles.
+        size_t triangleWriteIdx = 0;
+        for ( const uint3& triangle : triangles )
+        {
+            const uint3 newTriangle( remap[ triangle.x ], remap[ triangle.y ], remap[ triangle.z ] );
+
+            if ( newTriangle.x != newTriangle.y && newTriangle.y != newTriangle.z && newTriangle.z != newTriangle.x )
+                triangles[ triangleWriteIdx++ ] = newTriangle;
+        }
+
+        triangles.resize( triangleWriteIdx );
+    }
+
+    // Copy used vertices to the new mesh.
+    std::vector< int > newVertexIndices( vertexCount, -1 );
+    int newVertexCount = 0;
+
+    for ( uint3& triangle : triangles )
+    {
+        unsigned int* triangleVertices = &triangle.x;
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            int& newVertexIdx = newVertexIndices[ triangleVertices[ i ] ];
+            if ( newVertexIdx < 0 )
+                newVertexIdx = newVertexCount++;
+
+            triangleVertices[ i ] = (unsigned int)newVertexIdx;
+        }
+    }
+
+    std::shared_ptr< BlockMesh > simplifiedMesh = std::make_shared< BlockMesh >( newVertexCount, !mesh.m_normals.empty(), mesh.getTexcoordsCount(), 0 );
+
+    simplifiedMesh->m_triangles.swap( triangles );
+    simplifiedMesh->m_vertexLayout = mesh.m_vertexLayout;
+
+    if ( mesh.m_tangents.empty() )
+        simplifiedMesh->m_tangents.clear();
+
+    for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+    {
+        const int newVertexIdx = newVertexIndices[ vertexIdx ];
+        if ( newVertexIdx < 0 )
+            continue;
+
+        simplifiedMesh->m_vertices[ newVertexIdx ] = mesh.m_vertices[ vertexIdx ];
+
+        if ( !simplifiedMesh->m_normals.empty() )
+            simplifiedMesh->m_normals[ newVertexIdx ] = mesh.m_normals[ vertexIdx ];
+
+        if ( !simplifiedMesh->m_tangents.empty() )
+            simplifiedMesh->m_tangents[ newVertexIdx ] = mesh.m_tangents[ vertexIdx ];
+    }
+
+    auto simplifiedTexcoordsIt = simplifiedMesh->m_texcoords.begin();
+    for ( const auto& texcoordsSet : mesh.m_texcoords )
+    {
+        for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+        {
+            if ( newVertexIndices[ vertexIdx ] >= 0 )
+                ( *simplifiedTexcoordsIt )[ newVertexIndices[ vertexIdx ] ] = texcoordsSet[ vertexIdx ];
+        }
+
+        ++simplifiedTexcoordsIt;
+    }
+
+    simplifiedMesh->recalculateBoundingBox();
+
+    return simplifiedMesh;
+}
+
+std::vector< std::shared_ptr< BlockMeshLOD > > MeshUtil::generateLODs( const BlockMesh& mesh, const std::vector< float >& triangleRatios, 
+                                                                       const std::vector< float >& distances, const std::string& savePathPrefix )
+{
+    if ( triangleRatios.size() != distances.size() )
+        throw std::exception( "MeshUtil::generateLODs - different number of triangle ratios and distances passed." );
+
+    std::vector< std::future< std::shared_ptr< BlockMesh > > > lodMeshFutures;
+
+    for ( size_t lodIdx = 0; lodIdx < triangleRatios.size(); ++lodIdx )
+    {
+        const int targetTriangleCount = (int)( (float)mesh.m_triangles.size() * triangleRatios[ lodIdx ] );
+
+        const std::string savePath = savePathPrefix.empty() ? "" : savePathPrefix + "_LOD" + std::to_string( lodIdx + 1 ) + ".blockmesh";
+
+        lodMeshFutures.push_back( std::async( std::launch::async, [ &mesh, targetTriangleCount, savePath ]() {
+            std::shared_ptr< BlockMesh > lodMesh = simplify( mesh, targetTriangleCount );
+
+            if ( !lodMesh->m_triangles.empty() )
+            {
+                lodMesh->buildBvhTree();
+                optimizeForRasterization( *lodMesh );
+            }
+
+            if ( !savePath.empty() )
+            {
+                lodMesh->saveToFile( savePath, BlockMeshFileInfo::Format::BLOCKMESH );
+                lodMesh->setFileInfo( BlockMeshFileInfo( savePath, BlockMeshFileInfo::Format::BLOCKMESH ) );
+            }
+
+            return lodMesh;
+        } ) );
+    }
+
+    std::vector< std::shared_ptr< BlockMeshLOD > > lods;
+
+    for ( size_t lodIdx = 0; lodIdx < lodMeshFutures.size(); ++lodIdx )
+    {
+        std::shared_ptr< BlockMesh > lodMesh = lodMeshFutures[ lodIdx ].get();
+
+        lods.push_back( std::make_shared< BlockMeshLOD >( distances[ lodIdx ], lodMesh ) );
+    }
+
+    return lods;
+}
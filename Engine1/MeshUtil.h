@@ -1,11 +1,14 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "BlockMesh.h"
+
 namespace Engine1
 {
-    class BlockMesh;
+    class BlockMeshLOD;
     class float43;
 
     class MeshUtil
@@ -19,7 +22,69 @@ namespace Engine1
         static void flipNormals( BlockMesh& mesh );
         static void invertVertexWindingOrder( BlockMesh& mesh );
 
+        // Calculates tangents from normals and the first texcoord set (tangents are cleared if the mesh doesn't have them).
+        // Tangents of all triangles using a vertex are averaged and orthogonalized to the vertex normal. Runs on multiple threads.
+        static void calculateTangents( BlockMesh& mesh );
+
+        struct VertexWeldStats
+        {
+            int   vertexCountBefore;
+            int   vertexCountAfter;
+            int   removedTriangleCount; // Triangles which became degenerate after welding.
+            float reductionRatio;       // Fraction of vertices removed (0.0 - 1.0).
+        };
+
+        // Merges vertices whose positions, normals, tangents and texcoords (all sets) differ by at most the given epsilons (per component) 
+        // and removes triangles which became degenerate. Similar vertices are found using a spatial hash of positions. Runs on multiple threads.
+        // Each vertex is welded to the first similar vertex, so vertices can be welded in chains (ex: A-B, B-C) if they are very close.
+        // Has to be called before building the BVH tree and meshlets, as it changes the triangles.
+        static VertexWeldStats weldVertices( BlockMesh& mesh, const float positionEpsilon = 0.00001f, const float normalEpsilon = 0.001f, const float texcoordEpsilon = 0.00001f );
+
+        // Returns the format of interleaved vertices - contains only the attributes present in the mesh (and only the first texcoord set).
+        static BlockMesh::InterleavedVertexFormat getInterleavedVertexFormat( const BlockMesh& mesh, const bool includePositions );
+        // Converts vertex attributes from separate arrays to a single array of vertices with the given format.
+        static std::vector< char > interleaveVertices( const BlockMesh& mesh, const BlockMesh::InterleavedVertexFormat& format );
+        // Converts interleaved vertices back to separate arrays. Only attributes present in the format are replaced.
+        static void deinterleaveVertices( BlockMesh& mesh, const std::vector< char >& data, const BlockMesh::InterleavedVertexFormat& format );
+
+        // Transforms vertices in range [start, end) - positions by the whole transform, normals and tangents only by its orientation.
+        // Uses SSE and runs on multiple threads for large ranges. Meshlet bounds are recalculated.
         static void transformVertices( BlockMesh& mesh, const float43& transform, const int startVertexIdx, const int endVertexIndex );
+
+        struct VertexCacheStats
+        {
+            float acmr; // Average cache miss ratio - vertices transformed per triangle (0.5 - 3.0, lower is better).
+            float atvr; // Average transform to vertex ratio - vertices transformed per unique vertex (1.0 - 3.0, lower is better).
+        };
+
+        // Simulates a FIFO post-transform vertex cache of the given size while drawing the mesh.
+        static VertexCacheStats calculateVertexCacheStats( const BlockMesh& mesh, const int cacheSize = 32 );
+
+        // Reorders triangles for better post-transform vertex cache use (Tipsify) and then reorders clusters of triangles 
+        // to reduce overdraw (clusters facing away from the mesh center are drawn first, as they are likely to occlude the others).
+        // If the mesh has a BVH tree, triangles are reordered only inside BVH leaves, so the tree still matches the mesh.
+        // Note: Triangles need to be re-uploaded to GPU after that operation.
+        static void optimizeTriangleOrder( BlockMesh& mesh, const int cacheSize = 16 );
+
+        // Reorders vertices in the order they are first used by triangles (for better vertex fetch locality) and remaps triangles to the new order.
+        // Doesn't affect the BVH tree - it only refers to triangles. Meshlet vertices are remapped.
+        // Note: Mesh needs to be re-uploaded to GPU after that operation.
+        static void optimizeVertexOrder( BlockMesh& mesh );
+
+        // Optimizes triangle order and then vertex order.
+        static void optimizeForRasterization( BlockMesh& mesh );
+
+        // Returns a simplified copy of the mesh with at most the given number of triangles (if possible). 
+        // Uses edge collapses ordered by quadric error ("Surface Simplification Using Quadric Error Metrics", Garland, Heckbert 1997).
+        // Vertices are only removed, never moved, so remaining vertices keep their normals, tangents and texcoords.
+        // Vertices on borders, UV seams (and other attribute seams) and non-manifold edges are never removed, which preserves them.
+        static std::shared_ptr< BlockMesh > simplify( const BlockMesh& mesh, const int targetTriangleCount );
+
+        // Generates a LOD for each triangle ratio (relative to the mesh) and distance pair. LODs are generated in parallel.
+        // LOD meshes have BVH trees and are optimized for rasterization. 
+        // If path prefix is given, each LOD is also saved in the own format to "<prefix>_LOD<index starting from 1>.blockmesh".
+        static std::vector< std::shared_ptr< BlockMeshLOD > > generateLODs( const BlockMesh& mesh, const std::vector< float >& triangleRatios, 
+                                                                            const std::vector< float >& distances, const std::string& savePathPrefix = "" );
     };
 };
 
@@ -0,0 +1,368 @@
+#include "MeshletBuffer.h"
+
+#include "BlockMesh.h"
+#include "float4.h"
+#include "float43.h"
+#include "float44.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Engine1;
+
+MeshletBuffer::MeshletBuffer( const BlockMesh& mesh, const int maxVertexCount, const int maxTriangleCount )
+{
+    build( mesh, maxVertexCount, maxTriangleCount );
+}
+
+MeshletBuffer::MeshletBuffer()
+{}
+
+MeshletBuffer::~MeshletBuffer()
+{}
+
+const std::vector< MeshletBuffer::Meshlet >& MeshletBuffer::getMeshlets() const
+{
+    return m_meshlets;
+}
+
+const std::vector< unsigned int >& MeshletBuffer::getVertices() const
+{
+    return m_vertices;
+}
+
+const std::vector< unsigned char >& MeshletBuffer::getTriangles() const
+{
+    return m_triangles;
+}
+
+void MeshletBuffer::build( const BlockMesh& mesh, const int maxVertexCount, const int maxTriangleCount )
+{
+    // Note: Vertices are referenced by 8-bit local indices inside a meshlet.
+    if ( maxVertexCount < 3 || maxVertexCount > 256 || maxTriangleCount < 1 )
+        throw std::exception( "MeshletBuffer::build - invalid max vertex or triangle count." );
+
+    const std::vector< float3 >& vertices  = mesh.getVertices();
+    const std::vector< uint3 >&  triangles = mesh.getTriangles();
+
+    const int vertexCount   = (int)vertices.size();
+    const int triangleCount = (int)triangles.size();
+
+    m_meshlets.clear();
+    m_vertices.clear();
+    m_triangles.clear();
+
+    const float faceNormalSign = calculateFaceNormalSign( mesh ); // Zero - normal cones are not calculated.
+
+    // Triangles using each vertex.
+    std::vector< int > vertexTriangleOffsets( vertexCount + 1, 0 );
+    std::vector< int > vertexTriangles( triangleCount * 3 );
+    {
+        for ( const uint3& triangle : triangles )
+        {
+            ++vertexTriangleOffsets[ triangle.x + 1 ];
+            ++vertexTriangleOffsets[ triangle.y + 1 ];
+            ++vertexTriangleOffsets[ triangle.z + 1 ];
+        }
+
+        for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+            vertexTriangleOffsets[ vertexIdx + 1 ] += vertexTriangleOffsets[ vertexIdx ];
+
+        std::vector< int > insertPositions( vertexTriangleOffsets.begin(), vertexTriangleOffsets.end() - 1 );
+        for ( int triangleIdx = 0; triangleIdx < triangleCount; ++triangleIdx )
+        {
+            vertexTriangles[ insertPositions[ triangles[ triangleIdx ].x ]++ ] = triangleIdx;
+            vertexTriangles[ insertPositions[ triangles[ triangleIdx ].y ]++ ] = triangleIdx;
+            vertexTriangles[ insertPositions[ triangles[ triangleIdx ].z ]++ ] = triangleIdx;
+        }
+    }
+
+    std::vector< char > triangleUsed( triangleCount, 0 );
+    std::vector< int >  vertexLocalIndices( vertexCount, -1 ); // Index of the vertex in the current meshlet.
+    std::vector< int >  candidateTriangles;                    // Unused triangles sharing vertices with the current meshlet (may contain duplicates).
+
+    Meshlet meshlet = {};
+
+    const auto getNewVertexCount = [ &triangles, &vertexLocalIndices ]( const int triangleIdx ) {
+        const uint3& triangle = triangles[ triangleIdx ];
+        return ( vertexLocalIndices[ triangle.x ] < 0 ? 1 : 0 ) + ( vertexLocalIndices[ triangle.y ] < 0 ? 1 : 0 ) + ( vertexLocalIndices[ triangle.z ] < 0 ? 1 : 0 );
+    };
+
+    const auto addTriangle = [ & ]( const int triangleIdx ) {
+        const unsigned int* triangleVertices = &triangles[ triangleIdx ].x;
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            const unsigned int vertexIdx = triangleVertices[ i ];
+
+            if ( vertexLocalIndices[ vertexIdx ] < 0 )
+            {
+                vertexLocalIndices[ vertexIdx ] = meshlet.vertexCount++;
+                m_vertices.push_back( vertexIdx );
+
+                for ( int adjacentIdx = vertexTriangleOffsets[ vertexIdx ]; adjacentIdx < vertexTriangleOffsets[ vertexIdx + 1 ]; ++adjacentIdx )
+                {
+                    if ( !triangleUsed[ vertexTriangles[ adjacentIdx ] ] )
+                        candidateTriangles.push_back( vertexTriangles[ adjacentIdx ] );
+                }
+            }
+
+            m_triangles.push_back( (unsigned char)vertexLocalIndices[ vertexIdx ] );
+        }
+
+        ++meshlet.triangleCount;
+        triangleUsed[ triangleIdx ] = 1;
+    };
+
+    const auto finishMeshlet = [ & ]() {
+        if ( meshlet.triangleCount == 0 )
+            return;
+
+        for ( unsigned int localIdx = 0; localIdx < meshlet.vertexCount; ++localIdx )
+            vertexLocalIndices[ m_vertices[ meshlet.vertexOffset + localIdx ] ] = -1;
+
+        calculateBounds( mesh, meshlet, faceNormalSign );
+
+        m_meshlets.push_back( meshlet );
+
+        meshlet = {};
+        meshlet.vertexOffset   = (unsigned int)m_vertices.size();
+        meshlet.triangleOffset = (unsigned int)( m_triangles.size() / 3 );
+
+        candidateTriangles.clear();
+    };
+
+    int nextSeedTriangleIdx = 0;
+    int usedTriangleCount   = 0;
+
+    while ( usedTriangleCount < triangleCount )
+    {
+        // Pick the adjacent triangle adding the least new vertices.
+        int bestTriangleIdx      = -1;
+        int bestNewVertexCount   = 4;
+
+        for ( size_t candidateIdx = 0; candidateIdx < candidateTriangles.size(); )
+        {
+            const int triangleIdx = candidateTriangles[ candidateIdx ];
+
+            if ( triangleUsed[ triangleIdx ] )
+            {
+                candidateTriangles[ candidateIdx ] = candidateTriangles.back();
+                candidateTriangles.pop_back();
+                continue;
+            }
+
+            const int newVertexCount = getNewVertexCount( triangleIdx );
+            if ( newVertexCount < bestNewVertexCount )
+            {
+                bestTriangleIdx    = triangleIdx;
+                bestNewVertexCount = newVertexCount;
+
+                if ( newVertexCount == 0 )
+                    break;
+            }
+
+            ++candidateIdx;
+        }
+
+        // No adjacent triangles left - continue with the next unused triangle.
+        if ( bestTriangleIdx < 0 )
+        {
+            while ( triangleUsed[ nextSeedTriangleIdx ] )
+                ++nextSeedTriangleIdx;
+
+            bestTriangleIdx    = nextSeedTriangleIdx;
+            bestNewVertexCount = getNewVertexCount( bestTriangleIdx );
+        }
+
+        if ( meshlet.vertexCount + bestNewVertexCount > (unsigned int)maxVertexCount || meshlet.triangleCount + 1 > (unsigned int)maxTriangleCount )
+        {
+            finishMeshlet();
+            continue;
+        }
+
+        addTriangle( bestTriangleIdx );
+        ++usedTriangleCount;
+    }
+
+    finishMeshlet();
+}
+
+void MeshletBuffer::updateBounds( const BlockMesh& mesh )
+{
+    const float faceNormalSign = calculateFaceNormalSign( mesh );
+
+    for ( Meshlet& meshlet : m_meshlets )
+        calculateBounds( mesh, meshlet, faceNormalSign );
+}
+
+float MeshletBuffer::calculateFaceNormalSign( const BlockMesh& mesh )
+{
+    const std::vector< float3 >& vertices  = mesh.getVertices();
+    const std::vector< float3 >& normals   = mesh.getNormals();
+    const std::vector< uint3 >&  triangles = mesh.getTriangles();
+
+    if ( normals.empty() )
+        return 0.0f;
+
+    float normalsAgreement = 0.0f;
+    for ( const uint3& triangle : triangles )
+    {
+        const float3 faceNormal = cross( vertices[ triangle.y ] - vertices[ triangle.x ], vertices[ triangle.z ] - vertices[ triangle.x ] );
+        normalsAgreement += dot( faceNormal, normals[ triangle.x ] + normals[ triangle.y ] + normals[ triangle.z ] ) >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    return normalsAgreement >= 0.0f ? 1.0f : -1.0f;
+}
+
+void MeshletBuffer::calculateBounds( const BlockMesh& mesh, Meshlet& meshlet, const float faceNormalSign )
+{
+    const std::vector< float3 >& vertices = mesh.getVertices();
+
+    const unsigned int*  meshletVertices  = m_vertices.data() + meshlet.vertexOffset;
+    const unsigned char* meshletTriangles = m_triangles.data() + meshlet.triangleOffset * 3;
+
+    { // Bounding sphere - centered in the bounding box.
+        float3 min(  FLT_MAX,  FLT_MAX,  FLT_MAX );
+        float3 max( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+
+        for ( unsigned int localIdx = 0; localIdx < meshlet.vertexCount; ++localIdx )
+        {
+            min = Engine1::min( min, vertices[ meshletVertices[ localIdx ] ] );
+            max = Engine1::max( max, vertices[ meshletVertices[ localIdx ] ] );
+        }
+
+        meshlet.boundingSphereCenter = ( min + max ) * 0.5f;
+        meshlet.boundingSphereRadius = 0.0f;
+
+        for ( unsigned int localIdx = 0; localIdx < meshlet.vertexCount; ++localIdx )
+            meshlet.boundingSphereRadius = std::max( meshlet.boundingSphereRadius, ( vertices[ meshletVertices[ localIdx ] ] - meshlet.boundingSphereCenter ).length() );
+    }
+
+    // Cone which never gets culled.
+    meshlet.coneApex   = meshlet.boundingSphereCenter;
+    meshlet.coneAxis   = float3::ZERO;
+    meshlet.coneCutoff = 1.0f;
+
+    if ( faceNormalSign == 0.0f )
+        return;
+
+    // Returns normalized front-facing normal of the triangle (zero for degenerate triangles).
+    const auto getTriangleNormal = [ & ]( const unsigned int triangleIdx, float3& position ) {
+        position = vertices[ meshletVertices[ meshletTriangles[ triangleIdx * 3 ] ] ];
+
+        float3 normal = cross( vertices[ meshletVertices[ meshletTriangles[ triangleIdx * 3 + 1 ] ] ] - position,
+                               vertices[ meshletVertices[ meshletTriangles[ triangleIdx * 3 + 2 ] ] ] - position ) * faceNormalSign;
+
+        const float length = normal.length();
+        return length > 0.0f ? normal / length : float3::ZERO;
+    };
+
+    float3 position;
+    float3 normalsSum = float3::ZERO;
+
+    for ( unsigned int triangleIdx = 0; triangleIdx < meshlet.triangleCount; ++triangleIdx )
+        normalsSum += getTriangleNormal( triangleIdx, position );
+
+    const float normalsSumLength = normalsSum.length();
+    if ( normalsSumLength <= 0.0f )
+        return;
+
+    const float3 axis = normalsSum / normalsSumLength;
+
+    float minDot = 1.0f;
+    for ( unsigned int triangleIdx = 0; triangleIdx < meshlet.triangleCount; ++triangleIdx )
+    {
+        const float3 normal = getTriangleNormal( triangleIdx, position );
+        if ( normal != float3::ZERO )
+            minDot = std::min( minDot, dot( normal, axis ) );
+    }
+
+    // Cone is too wide (over ~85 degrees) to ever be culled.
+    if ( minDot <= 0.1f )
+        return;
+
+    // Move the apex back along the axis, so it's behind the planes of all triangles.
+    float apexDistance = 0.0f;
+    for ( unsigned int triangleIdx = 0; triangleIdx < meshlet.triangleCount; ++triangleIdx )
+    {
+        const float3 normal = getTriangleNormal( triangleIdx, position );
+        const float  normalDotAxis = dot( normal, axis );
+
+        if ( normalDotAxis > 0.0f )
+            apexDistance = std::max( apexDistance, dot( meshlet.boundingSphereCenter - position, normal ) / normalDotAxis );
+    }
+
+    meshlet.coneApex   = meshlet.boundingSphereCenter - axis * apexDistance;
+    meshlet.coneAxis   = axis;
+    meshlet.coneCutoff = std::sqrt( 1.0f - minDot * minDot );
+}
+
+int MeshletBuffer::cull( const float43& worldMatrix, const float44& viewProjectionMatrix, const float3& cameraPosition, const float maxDistance,
+                         const bool cullBackfaces, std::vector< unsigned int >& indices ) const
+{
+    indices.clear();
+
+    // Frustum planes (pointing inside) in world space - extracted from the columns of the view-projection matrix.
+    const float44& m = viewProjectionMatrix;
+    float4 planes[ 6 ] = {
+        float4( m.m14 + m.m11, m.m24 + m.m21, m.m34 + m.m31, m.m44 + m.m41 ), // Left.
+        float4( m.m14 - m.m11, m.m24 - m.m21, m.m34 - m.m31, m.m44 - m.m41 ), // Right.
+        float4( m.m14 + m.m12, m.m24 + m.m22, m.m34 + m.m32, m.m44 + m.m42 ), // Bottom.
+        float4( m.m14 - m.m12, m.m24 - m.m22, m.m34 - m.m32, m.m44 - m.m42 ), // Top.
+        float4( m.m13,         m.m23,         m.m33,         m.m43 ),         // Near.
+        float4( m.m14 - m.m13, m.m24 - m.m23, m.m34 - m.m33, m.m44 - m.m43 )  // Far.
+    };
+
+    for ( float4& plane : planes )
+    {
+        const float length = float3( plane.x, plane.y, plane.z ).length();
+        if ( length > 0.0f )
+            plane = plane / length;
+    }
+
+    const float33 orientation = worldMatrix.getOrientation();
+    const float3  axisX( orientation.m11, orientation.m12, orientation.m13 );
+    const float3  axisY( orientation.m21, orientation.m22, orientation.m23 );
+    const float3  axisZ( orientation.m31, orientation.m32, orientation.m33 );
+    const float   scale    = std::max( axisX.length(), std::max( axisY.length(), axisZ.length() ) );
+    const bool    mirrored = dot( cross( axisX, axisY ), axisZ ) < 0.0f;
+
+    int visibleMeshletCount = 0;
+
+    for ( const Meshlet& meshlet : m_meshlets )
+    {
+        const float3 center = meshlet.boundingSphereCenter * worldMatrix;
+        const float  radius = meshlet.boundingSphereRadius * scale;
+
+        bool visible = true;
+
+        for ( int planeIdx = 0; planeIdx < 6 && visible; ++planeIdx )
+            visible = planes[ planeIdx ].x * center.x + planes[ planeIdx ].y * center.y + planes[ planeIdx ].z * center.z + planes[ planeIdx ].w >= -radius;
+
+        if ( visible && maxDistance > 0.0f )
+            visible = ( center - cameraPosition ).length() - radius <= maxDistance;
+
+        if ( visible && cullBackfaces && !mirrored && meshlet.coneCutoff < 1.0f )
+        {
+            const float3 apexDirection = meshlet.coneApex * worldMatrix - cameraPosition;
+            float3       axis          = meshlet.coneAxis * orientation;
+            axis.normalize();
+
+            visible = dot( apexDirection, axis ) < meshlet.coneCutoff * apexDirection.length();
+        }
+
+        if ( !visible )
+            continue;
+
+        ++visibleMeshletCount;
+
+        const unsigned int*  meshletVertices  = m_vertices.data() + meshlet.vertexOffset;
+        const unsigned char* meshletTriangles = m_triangles.data() + meshlet.triangleOffset * 3;
+
+        for ( unsigned int idx = 0; idx < meshlet.triangleCount * 3; ++idx )
+            indices.push_back( meshletVertices[ meshletTriangles[ idx ] ] );
+    }
+
+    return visibleMeshletCount;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+
+#include "float3.h"
+
+namespace Engine1
+{
+    class BlockMesh;
+    class float43;
+    class float44;
+
+    // Mesh split into small clusters of triangles (meshlets) - each with a bounding sphere and a normal cone,
+    // so parts of a large mesh can be culled separately (by frustum, distance and facing away from the camera).
+    // Meshlets refer to mesh vertices by index, so they don't depend on the order of mesh triangles,
+    // but have to be rebuilt (or remapped) when vertices are reordered.
+    class MeshletBuffer
+    {
+        friend class MeshFileParser;
+        friend class MeshUtil;
+
+        public:
+
+        #pragma pack( push, 1 )
+        struct Meshlet
+        {
+            unsigned int vertexOffset;   // Index of the first meshlet vertex in the vertices vector.
+            unsigned int triangleOffset; // Index of the first meshlet triangle in the triangles vector.
+            unsigned int vertexCount;
+            unsigned int triangleCount;
+
+            float3       boundingSphereCenter;
+            float        boundingSphereRadius;
+
+            // Meshlet is facing away from the camera if: dot( normalize( coneApex - cameraPos ), coneAxis ) >= coneCutoff.
+            // Cutoff is 1 (never culled) if triangle normals differ too much.
+            float3       coneApex;
+            float3       coneAxis;
+            float        coneCutoff;
+        };
+        #pragma pack( pop )
+
+        // Meshlets are built greedily - triangles sharing vertices with the current meshlet are added first,
+        // then the next unused triangle in the mesh order (which is spatially coherent for meshes with a BVH tree).
+        // Normal cones are calculated only for meshes with normals (they are used to find the front side of triangles).
+        MeshletBuffer( const BlockMesh& mesh, const int maxVertexCount = 64, const int maxTriangleCount = 124 );
+        MeshletBuffer();
+        ~MeshletBuffer();
+
+        const std::vector< Meshlet >&       getMeshlets()  const;
+        // Mesh vertex indices used by meshlets.
+        const std::vector< unsigned int >&  getVertices()  const;
+        // Triangles as triplets of vertex indices local to the meshlet.
+        const std::vector< unsigned char >& getTriangles() const;
+
+        // Writes triangles (as mesh vertex indices) of meshlets visible from the given view to the index list. Returns the number of visible meshlets.
+        // View-projection matrix is used to extract the frustum planes. Max distance of zero disables distance culling.
+        // Cone culling assumes that back faces are not rendered and it's disabled if world matrix contains a mirroring.
+        int cull( const float43& worldMatrix, const float44& viewProjectionMatrix, const float3& cameraPosition, const float maxDistance,
+                  const bool cullBackfaces, std::vector< unsigned int >& indices ) const;
+
+        // Recalculates bounding spheres and normal cones of all meshlets. Has to be called after vertex positions, normals or the winding order changed.
+        void updateBounds( const BlockMesh& mesh );
+
+        private:
+
+        void build( const BlockMesh& mesh, const int maxVertexCount, const int maxTriangleCount );
+        void calculateBounds( const BlockMesh& mesh, Meshlet& meshlet, const float faceNormalSign ); // Zero sign - no normal cone.
+
+        // Finds out which side of triangles is the front one - by comparing their geometric normals with vertex normals. Returns zero for meshes without normals.
+        static float calculateFaceNormalSign( const BlockMesh& mesh );
+
+        std::vector< Meshlet >       m_meshlets;
+        std::vector< unsigned int >  m_vertices;
+        std::vector< unsigned char > m_triangles;
+    };
+};
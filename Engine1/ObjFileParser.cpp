@@ -0,0 +1,785 @@
+#include "ObjFileParser.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "BlockMesh.h"
+#include "MeshUtil.h"
+#include "ParallelUtil.h"
+
+using namespace Engine1;
+
+namespace
+{
+    const size_t minChunkSize = 512 * 1024;
+
+    // Indices are global and start from 0. Negative index means that the attribute is not given.
+    struct FaceCorner
+    {
+        int position;
+        int texcoord;
+        int normal;
+
+        bool operator == ( const FaceCorner& corner ) const
+        {
+            return position == corner.position && texcoord == corner.texcoord && normal == corner.normal;
+        }
+    };
+
+    // Statement which may change the mesh to which the following faces belong.
+    struct MeshStatement
+    {
+        enum class Type
+        {
+            Object,
+            Group,
+            Material
+        };
+
+        Type        type;
+        std::string name;
+        int         triangleIdx; // Index of the first triangle following the statement. Local to the chunk until the chunks are merged.
+    };
+
+    // Range of triangles belonging to a mesh. Triangles of each mesh are contiguous in the file.
+    struct MeshRange
+    {
+        int trianglesBegin;
+        int trianglesEnd;
+    };
+
+    struct Chunk
+    {
+        const char* begin;
+        const char* end;
+
+        int positionCount;
+        int texcoordCount;
+        int normalCount;
+
+        // Number of elements in all the previous chunks.
+        int positionsOffset;
+        int texcoordsOffset;
+        int normalsOffset;
+        int trianglesOffset;
+
+        std::vector< FaceCorner >    triangleCorners; // Three for each triangle.
+        std::vector< MeshStatement > meshStatements;
+    };
+
+    const double powersOf10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    inline bool isSpace( const char c )
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\0';
+    }
+
+    inline bool isDigit( const char c )
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    inline void skipSpaces( const char*& it, const char* end )
+    {
+        while ( it < end && isSpace( *it ) )
+            ++it;
+    }
+
+    inline const char* findLineEnd( const char* it, const char* end )
+    {
+        const char* lineEnd = static_cast< const char* >( std::memchr( it, '\n', end - it ) );
+
+        return lineEnd ? lineEnd : end;
+    }
+
+    // Checks whether the line starts with the keyword followed by whitespace.
+    inline bool startsWithKeyword( const char* it, const char* end, const char* keyword, const size_t keywordLength )
+    {
+        return (size_t)( end - it ) > keywordLength && std::memcmp( it, keyword, keywordLength ) == 0 && isSpace( it[ keywordLength ] );
+    }
+
+    // Returns the rest of the line (or only its first word) without surrounding whitespace.
+    std::string parseName( const char* it, const char* lineEnd, const bool firstWordOnly )
+    {
+        skipSpaces( it, lineEnd );
+
+        const char* nameEnd = it;
+        while ( nameEnd < lineEnd && !( firstWordOnly && isSpace( *nameEnd ) ) )
+            ++nameEnd;
+
+        while ( nameEnd > it && isSpace( nameEnd[ -1 ] ) )
+            --nameEnd;
+
+        return std::string( it, nameEnd );
+    }
+
+    // Handles the common decimal notation without calling strtod (which is slow and depends on locale).
+    // Falls back to strtod for anything unusual (ex: "nan", "inf", hex floats).
+    float parseFloat( const char*& it, const char* end )
+    {
+        skipSpaces( it, end );
+
+        const char* start = it;
+
+        bool negative = false;
+        if ( it < end && ( *it == '-' || *it == '+' ) )
+        {
+            negative = ( *it == '-' );
+            ++it;
+        }
+
+        unsigned long long mantissa    = 0;
+        int                digitCount  = 0; // Significant digits stored in the mantissa.
+        int                exponent    = 0;
+        bool               hasDigits   = false;
+
+        for ( ; it < end && isDigit( *it ); ++it )
+        {
+            hasDigits = true;
+
+            if ( digitCount < 19 )
+            {
+                mantissa = mantissa * 10 + ( *it - '0' );
+                digitCount += ( mantissa != 0 ) ? 1 : 0;
+            }
+            else
+                ++exponent;
+        }
+
+        if ( it < end && *it == '.' )
+        {
+            for ( ++it; it < end && isDigit( *it ); ++it )
+            {
+                hasDigits = true;
+
+                if ( digitCount < 19 )
+                {
+                    mantissa = mantissa * 10 + ( *it - '0' );
+                    digitCount += ( mantissa != 0 ) ? 1 : 0;
+                    --exponent;
+                }
+            }
+        }
+
+        if ( hasDigits && it < end && ( *it == 'e' || *it == 'E' ) )
+        {
+            const char* exponentStart = it;
+            ++it;
+
+            bool negativeExponent = false;
+            if ( it < end && ( *it == '-' || *it == '+' ) )
+            {
+                negativeExponent = ( *it == '-' );
+                ++it;
+            }
+
+            if ( it < end && isDigit( *it ) )
+            {
+                int exponentValue = 0;
+                for ( ; it < end && isDigit( *it ); ++it )
+                    exponentValue = std::min( exponentValue * 10 + ( *it - '0' ), 10000 );
+
+                exponent += negativeExponent ? -exponentValue : exponentValue;
+            }
+            else
+                it = exponentStart; // Not an exponent.
+        }
+
+        if ( !hasDigits || ( it < end && !isSpace( *it ) && *it != '\n' ) )
+        {
+            // Unusual number format - copy the token and use strtod.
+            it = start;
+
+            char   token[ 64 ];
+            size_t tokenLength = 0;
+            while ( it < end && !isSpace( *it ) && *it != '\n' && tokenLength < sizeof( token ) - 1 )
+                token[ tokenLength++ ] = *it++;
+
+            token[ tokenLength ] = '\0';
+
+            char* tokenEnd = nullptr;
+            const double value = std::strtod( token, &tokenEnd );
+
+            if ( tokenEnd == token )
+                throw std::exception( "ObjFileParser::parseBlockMeshFile - invalid number." );
+
+            return (float)value;
+        }
+
+        double value = (double)mantissa;
+
+        if ( exponent < 0 )
+            value = exponent >= -22 ? value / powersOf10[ -exponent ] : value * std::pow( 10.0, exponent );
+        else if ( exponent > 0 )
+            value = exponent <= 22 ? value * powersOf10[ exponent ] : value * std::pow( 10.0, exponent );
+
+        return (float)( negative ? -value : value );
+    }
+
+    // Returns false if there is no integer at the current position.
+    inline bool parseInt( const char*& it, const char* end, int& value )
+    {
+        bool negative = false;
+        if ( it < end && ( *it == '-' || *it == '+' ) )
+        {
+            negative = ( *it == '-' );
+            ++it;
+        }
+
+        if ( it >= end || !isDigit( *it ) )
+            return false;
+
+        long long result = 0;
+        for ( ; it < end && isDigit( *it ); ++it )
+            result = std::min( result * 10 + ( *it - '0' ), (long long)INT_MAX );
+
+        value = (int)( negative ? -result : result );
+
+        return true;
+    }
+
+    // Converts OBJ index (starting from 1, negative values are relative to the current element count) to a global index starting from 0.
+    inline int resolveIndex( const int index, const int currentCount )
+    {
+        if ( index > 0 )
+            return index - 1;
+        else if ( index < 0 && currentCount + index >= 0 )
+            return currentCount + index;
+        else
+            throw std::exception( "ObjFileParser::parseBlockMeshFile - invalid index." );
+    }
+
+    void countElements( Chunk& chunk )
+    {
+        chunk.positionCount = 0;
+        chunk.texcoordCount = 0;
+        chunk.normalCount   = 0;
+
+        for ( const char* it = chunk.begin; it < chunk.end; )
+        {
+            const char* lineEnd = findLineEnd( it, chunk.end );
+
+            skipSpaces( it, lineEnd );
+
+            if ( it < lineEnd && *it == 'v' )
+            {
+                if      ( startsWithKeyword( it, lineEnd, "v", 1 ) )  ++chunk.positionCount;
+                else if ( startsWithKeyword( it, lineEnd, "vt", 2 ) ) ++chunk.texcoordCount;
+                else if ( startsWithKeyword( it, lineEnd, "vn", 2 ) ) ++chunk.normalCount;
+            }
+
+            it = lineEnd + 1;
+        }
+    }
+
+    void parseChunk( Chunk& chunk, std::vector< float3 >& positions, std::vector< float2 >& texcoords, std::vector< float3 >& normals )
+    {
+        int positionIdx = chunk.positionsOffset;
+        int texcoordIdx = chunk.texcoordsOffset;
+        int normalIdx   = chunk.normalsOffset;
+
+        std::vector< FaceCorner > polygon;
+
+        for ( const char* it = chunk.begin; it < chunk.end; )
+        {
+            const char* lineEnd = findLineEnd( it, chunk.end );
+
+            skipSpaces( it, lineEnd );
+
+            if ( it >= lineEnd || *it == '#' )
+            {
+                // Empty line or comment.
+            }
+            else if ( startsWithKeyword( it, lineEnd, "v", 1 ) )
+            {
+                it += 1;
+                float3& position = positions[ positionIdx++ ];
+                position.x = parseFloat( it, lineEnd );
+                position.y = parseFloat( it, lineEnd );
+                position.z = parseFloat( it, lineEnd );
+            }
+            else if ( startsWithKeyword( it, lineEnd, "vt", 2 ) )
+            {
+                it += 2;
+                float2& texcoord = texcoords[ texcoordIdx++ ];
+                texcoord.x = parseFloat( it, lineEnd );
+
+                skipSpaces( it, lineEnd );
+                texcoord.y = it < lineEnd ? parseFloat( it, lineEnd ) : 0.0f;
+            }
+            else if ( startsWithKeyword( it, lineEnd, "vn", 2 ) )
+            {
+                it += 2;
+                float3& normal = normals[ normalIdx++ ];
+                normal.x = parseFloat( it, lineEnd );
+                normal.y = parseFloat( it, lineEnd );
+                normal.z = parseFloat( it, lineEnd );
+            }
+            else if ( startsWithKeyword( it, lineEnd, "f", 1 ) )
+            {
+                it += 1;
+                polygon.clear();
+
+                while ( true )
+                {
+                    skipSpaces( it, lineEnd );
+
+                    if ( it >= lineEnd || *it == '#' )
+                        break;
+
+                    FaceCorner corner = { -1, -1, -1 };
+                    int        index  = 0;
+
+                    if ( !parseInt( it, lineEnd, index ) )
+                        throw std::exception( "ObjFileParser::parseBlockMeshFile - invalid face definition." );
+
+                    corner.position = resolveIndex( index, positionIdx );
+
+                    if ( it < lineEnd && *it == '/' )
+                    {
+                        ++it;
+
+                        if ( parseInt( it, lineEnd, index ) )
+                            corner.texcoord = resolveIndex( index, texcoordIdx );
+
+                        if ( it < lineEnd && *it == '/' )
+                        {
+                            ++it;
+
+                            if ( parseInt( it, lineEnd, index ) )
+                                corner.normal = resolveIndex( index, normalIdx );
+                        }
+                    }
+
+                    polygon.push_back( corner );
+                }
+
+                // Triangulate as a fan.
+                for ( size_t cornerIdx = 2; cornerIdx < polygon.size(); ++cornerIdx )
+                {
+                    chunk.triangleCorners.push_back( polygon[ 0 ] );
+                    chunk.triangleCorners.push_back( polygon[ cornerIdx - 1 ] );
+                    chunk.triangleCorners.push_back( polygon[ cornerIdx ] );
+                }
+            }
+            else if ( startsWithKeyword( it, lineEnd, "o", 1 ) )
+            {
+                chunk.meshStatements.push_back( { MeshStatement::Type::Object, parseName( it + 1, lineEnd, true ), (int)( chunk.triangleCorners.size() / 3 ) } );
+            }
+            else if ( startsWithKeyword( it, lineEnd, "g", 1 ) )
+            {
+                chunk.meshStatements.push_back( { MeshStatement::Type::Group, parseName( it + 1, lineEnd, false ), (int)( chunk.triangleCorners.size() / 3 ) } );
+            }
+            else if ( startsWithKeyword( it, lineEnd, "usemtl", 6 ) )
+            {
+                chunk.meshStatements.push_back( { MeshStatement::Type::Material, parseName( it + 6, lineEnd, false ), (int)( chunk.triangleCorners.size() / 3 ) } );
+            }
+
+            it = lineEnd + 1;
+        }
+    }
+
+    // Splits triangles into meshes the same way as Assimp's OBJ importer, so meshes have the same indices in the file with both parsers:
+    // - 'o' creates a new object (with a new mesh). If an object with that name exists, it becomes the current object, but faces still go to the current mesh.
+    // - 'g' with a name different from the active group creates a new object (even if the name was used before).
+    // - 'usemtl' creates a new mesh in the current object only if the current mesh has a different material and some faces.
+    //   Repeating the current material is ignored. Faces preceding the first material get it without creating a new mesh.
+    // - Faces preceding any object create a default object.
+    // Meshes are ordered by object (in order of creation) and then by creation. Meshes without triangles are skipped.
+    std::vector< MeshRange > splitIntoMeshes( const std::vector< MeshStatement >& statements, const int triangleCount )
+    {
+        struct Mesh
+        {
+            MeshRange   triangles;
+            bool        hasMaterial;
+            std::string material;
+        };
+
+        struct Object
+        {
+            std::string        name;
+            std::vector< int > meshIndices;
+        };
+
+        std::vector< Mesh >   meshes;
+        std::vector< Object > objects;
+
+        int         currentObjectIdx = -1;
+        int         currentMeshIdx   = -1;
+        bool        hasMaterial      = false;
+        std::string material;
+        std::string activeGroup;
+
+        // Mesh created without an object (when a material precedes any object and faces) doesn't belong to any object and stays empty.
+        const auto createMesh = [ & ]() {
+            meshes.push_back( { { 0, 0 }, false, "" } );
+            currentMeshIdx = (int)meshes.size() - 1;
+
+            if ( currentObjectIdx >= 0 )
+                objects[ currentObjectIdx ].meshIndices.push_back( currentMeshIdx );
+        };
+
+        const auto createObject = [ & ]( const std::string& name ) {
+            objects.push_back( { name, {} } );
+            currentObjectIdx = (int)objects.size() - 1;
+
+            createMesh();
+
+            meshes[ currentMeshIdx ].hasMaterial = hasMaterial;
+            meshes[ currentMeshIdx ].material    = material;
+        };
+
+        const auto addTriangles = [ & ]( const int trianglesBegin, const int trianglesEnd ) {
+            if ( trianglesBegin == trianglesEnd )
+                return;
+
+            if ( currentObjectIdx < 0 )
+                createObject( "defaultobject" );
+
+            MeshRange& triangles = meshes[ currentMeshIdx ].triangles;
+
+            if ( triangles.trianglesBegin == triangles.trianglesEnd )
+                triangles.trianglesBegin = trianglesBegin;
+
+            triangles.trianglesEnd = trianglesEnd;
+        };
+
+        int triangleIdx = 0;
+
+        for ( const MeshStatement& statement : statements )
+        {
+            addTriangles( triangleIdx, statement.triangleIdx );
+            triangleIdx = statement.triangleIdx;
+
+            if ( statement.type == MeshStatement::Type::Object )
+            {
+                if ( statement.name.empty() )
+                    continue;
+
+                const auto objectIt = std::find_if( objects.begin(), objects.end(), [ &statement ]( const Object& object ) {
+                    return object.name == statement.name;
+                } );
+
+                if ( objectIt != objects.end() )
+                    currentObjectIdx = (int)( objectIt - objects.begin() );
+                else
+                    createObject( statement.name );
+            }
+            else if ( statement.type == MeshStatement::Type::Group )
+            {
+                if ( statement.name != activeGroup )
+                {
+                    createObject( statement.name );
+                    activeGroup = statement.name;
+                }
+            }
+            else
+            {
+                if ( statement.name.empty() || ( hasMaterial && statement.name == material ) )
+                    continue;
+
+                hasMaterial = true;
+                material    = statement.name;
+
+                const bool needsNewMesh = currentMeshIdx < 0 ||
+                    ( meshes[ currentMeshIdx ].hasMaterial && meshes[ currentMeshIdx ].material != material
+                      && meshes[ currentMeshIdx ].triangles.trianglesBegin != meshes[ currentMeshIdx ].triangles.trianglesEnd );
+
+                if ( needsNewMesh )
+                    createMesh();
+
+                meshes[ currentMeshIdx ].hasMaterial = true;
+                meshes[ currentMeshIdx ].material    = material;
+            }
+        }
+
+        addTriangles( triangleIdx, triangleCount );
+
+        std::vector< MeshRange > meshRanges;
+
+        for ( const Object& object : objects )
+        {
+            for ( const int meshIdx : object.meshIndices )
+            {
+                if ( meshes[ meshIdx ].triangles.trianglesBegin != meshes[ meshIdx ].triangles.trianglesEnd )
+                    meshRanges.push_back( meshes[ meshIdx ].triangles );
+            }
+        }
+
+        return meshRanges;
+    }
+
+    // Returns the vertex index for each triangle corner in the range. Adds new vertices (unique corners) to the list.
+    class VertexWelder
+    {
+        public:
+
+        VertexWelder( const size_t expectedVertexCount )
+        {
+            size_t tableSize = 1024;
+            while ( tableSize < expectedVertexCount * 2 )
+                tableSize *= 2;
+
+            m_table.assign( tableSize, -1 );
+            m_vertices.reserve( expectedVertexCount );
+        }
+
+        unsigned int getVertexIndex( const FaceCorner& corner )
+        {
+            const size_t mask = m_table.size() - 1;
+
+            for ( size_t slot = hash( corner ) & mask; ; slot = ( slot + 1 ) & mask )
+            {
+                const int vertexIdx = m_table[ slot ];
+
+                if ( vertexIdx < 0 )
+                {
+                    const int newVertexIdx = (int)m_vertices.size();
+
+                    m_table[ slot ] = newVertexIdx;
+                    m_vertices.push_back( corner );
+
+                    if ( m_vertices.size() * 2 > m_table.size() )
+                        grow();
+
+                    return (unsigned int)newVertexIdx;
+                }
+                else if ( m_vertices[ vertexIdx ] == corner )
+                {
+                    return (unsigned int)vertexIdx;
+                }
+            }
+        }
+
+        const std::vector< FaceCorner >& getVertices() const
+        {
+            return m_vertices;
+        }
+
+        private:
+
+        static size_t hash( const FaceCorner& corner )
+        {
+            unsigned long long hash = (unsigned long long)(unsigned int)corner.position * 0x9E3779B97F4A7C15ull;
+            hash ^= (unsigned long long)(unsigned int)corner.texcoord * 0xC2B2AE3D27D4EB4Full;
+            hash ^= (unsigned long long)(unsigned int)corner.normal * 0x165667B19E3779F9ull;
+
+            return (size_t)( hash ^ ( hash >> 29 ) );
+        }
+
+        void grow()
+        {
+            m_table.assign( m_table.size() * 2, -1 );
+
+            const size_t mask = m_table.size() - 1;
+
+            for ( int vertexIdx = 0; vertexIdx < (int)m_vertices.size(); ++vertexIdx )
+            {
+                size_t slot = hash( m_vertices[ vertexIdx ] ) & mask;
+                while ( m_table[ slot ] >= 0 )
+                    slot = ( slot + 1 ) & mask;
+
+                m_table[ slot ] = vertexIdx;
+            }
+        }
+
+        std::vector< int >        m_table; // Open addressing with linear probing. Stores vertex indices, -1 means empty slot.
+        std::vector< FaceCorner > m_vertices;
+    };
+}
+
+std::vector< std::shared_ptr< BlockMesh > > ObjFileParser::parseBlockMeshFile( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt,
+                                                                               const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
+{
+    std::vector< std::shared_ptr< BlockMesh > > meshes;
+
+    if ( dataIt == dataEndIt )
+        return meshes;
+
+    const char* data    = &( *dataIt );
+    const char* dataEnd = data + ( dataEndIt - dataIt );
+
+    // Split the file into chunks at line boundaries.
+    std::vector< Chunk > chunks;
+    {
+        const size_t dataSize   = dataEnd - data;
+        const size_t chunkCount = std::max( (size_t)1, std::min( dataSize / minChunkSize, (size_t)ParallelUtil::getThreadCount() * 4 ) );
+
+        const char* chunkBegin = data;
+        for ( size_t chunkIdx = 1; chunkIdx <= chunkCount && chunkBegin < dataEnd; ++chunkIdx )
+        {
+            const char* chunkEnd = dataEnd;
+
+            if ( chunkIdx < chunkCount )
+            {
+                chunkEnd = std::max( chunkBegin, data + dataSize * chunkIdx / chunkCount );
+                chunkEnd = std::min( dataEnd, findLineEnd( chunkEnd, dataEnd ) + 1 );
+            }
+
+            Chunk chunk;
+            chunk.begin = chunkBegin;
+            chunk.end   = chunkEnd;
+
+            chunks.push_back( std::move( chunk ) );
+
+            chunkBegin = chunkEnd;
+        }
+    }
+
+    // Count vertex attributes in each chunk, so each chunk knows where to write them (and how to resolve relative indices).
+    ParallelUtil::parallelFor( (int)chunks.size(), [ &chunks ]( const int chunkIdx ) {
+        countElements( chunks[ chunkIdx ] );
+    } );
+
+    int positionCount = 0;
+    int texcoordCount = 0;
+    int normalCount   = 0;
+
+    for ( Chunk& chunk : chunks )
+    {
+        chunk.positionsOffset = positionCount;
+        chunk.texcoordsOffset = texcoordCount;
+        chunk.normalsOffset   = normalCount;
+
+        positionCount += chunk.positionCount;
+        texcoordCount += chunk.texcoordCount;
+        normalCount   += chunk.normalCount;
+    }
+
+    std::vector< float3 > positions( positionCount );
+    std::vector< float2 > texcoords( texcoordCount );
+    std::vector< float3 > normals( normalCount );
+
+    ParallelUtil::parallelFor( (int)chunks.size(), [ & ]( const int chunkIdx ) {
+        parseChunk( chunks[ chunkIdx ], positions, texcoords, normals );
+    } );
+
+    // Find triangle ranges of all meshes.
+    std::vector< MeshStatement > meshStatements;
+    int triangleCount = 0;
+
+    for ( Chunk& chunk : chunks )
+    {
+        chunk.trianglesOffset = triangleCount;
+
+        for ( MeshStatement& statement : chunk.meshStatements )
+        {
+            statement.triangleIdx += triangleCount;
+            meshStatements.push_back( std::move( statement ) );
+        }
+
+        triangleCount += (int)( chunk.triangleCorners.size() / 3 );
+    }
+
+    const std::vector< MeshRange > meshRanges = splitIntoMeshes( meshStatements, triangleCount );
+    const int meshCount = (int)meshRanges.size();
+
+    meshes.resize( meshCount );
+
+    // Weld vertices and fill each mesh.
+    ParallelUtil::parallelFor( meshCount, [ & ]( const int meshIdx ) {
+        const int trianglesBegin = meshRanges[ meshIdx ].trianglesBegin;
+        const int trianglesEnd   = meshRanges[ meshIdx ].trianglesEnd;
+
+        std::shared_ptr< BlockMesh > mesh = std::make_shared< BlockMesh >();
+
+        mesh->m_triangles.resize( trianglesEnd - trianglesBegin );
+
+        VertexWelder welder( ( trianglesEnd - trianglesBegin ) / 2 + 1 );
+
+        bool hasTexcoords = false;
+        bool hasNormals   = false;
+
+        // Find the first chunk containing the mesh.
+        size_t chunkIdx = 0;
+        while ( chunkIdx + 1 < chunks.size() && chunks[ chunkIdx + 1 ].trianglesOffset <= trianglesBegin )
+            ++chunkIdx;
+
+        for ( int triangleIdx = trianglesBegin; triangleIdx < trianglesEnd; ++triangleIdx )
+        {
+            while ( triangleIdx >= chunks[ chunkIdx ].trianglesOffset + (int)( chunks[ chunkIdx ].triangleCorners.size() / 3 ) )
+                ++chunkIdx;
+
+            const FaceCorner* corners = &chunks[ chunkIdx ].triangleCorners[ ( triangleIdx - chunks[ chunkIdx ].trianglesOffset ) * 3 ];
+
+            for ( int cornerIdx = 0; cornerIdx < 3; ++cornerIdx )
+            {
+                const FaceCorner& corner = corners[ cornerIdx ];
+
+                if ( corner.position < 0 || corner.position >= positionCount || corner.texcoord >= texcoordCount || corner.normal >= normalCount )
+                    throw std::exception( "ObjFileParser::parseBlockMeshFile - face index out of range." );
+
+                hasTexcoords |= ( corner.texcoord >= 0 );
+                hasNormals   |= ( corner.normal >= 0 );
+            }
+
+            uint3& triangle = mesh->m_triangles[ triangleIdx - trianglesBegin ];
+            triangle.x = welder.getVertexIndex( corners[ 0 ] );
+            triangle.y = welder.getVertexIndex( corners[ 1 ] );
+            triangle.z = welder.getVertexIndex( corners[ 2 ] );
+
+            if ( invertVertexWindingOrder )
+                std::swap( triangle.x, triangle.z );
+        }
+
+        const std::vector< FaceCorner >& vertices = welder.getVertices();
+        const size_t vertexCount = vertices.size();
+
+        mesh->m_vertices.resize( vertexCount );
+        for ( size_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+        {
+            float3& position = mesh->m_vertices[ vertexIdx ];
+            position = positions[ vertices[ vertexIdx ].position ];
+
+            if ( invertZCoordinate )
+                position.z = -position.z;
+        }
+
+        if ( hasNormals )
+        {
+            mesh->m_normals.resize( vertexCount );
+            for ( size_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+            {
+                const int normalIdx = vertices[ vertexIdx ].normal;
+                float3&   normal    = mesh->m_normals[ vertexIdx ];
+
+                normal = normalIdx >= 0 ? normals[ normalIdx ] : float3::ZERO;
+
+                if ( invertZCoordinate )
+                    normal.z = -normal.z;
+            }
+        }
+
+        if ( hasTexcoords )
+        {
+            mesh->m_texcoords.push_back( std::vector< float2 >( vertexCount ) );
+            std::vector< float2 >& meshTexcoords = mesh->m_texcoords.back();
+
+            for ( size_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx )
+            {
+                const int texcoordIdx = vertices[ vertexIdx ].texcoord;
+                float2&   texcoord    = meshTexcoords[ vertexIdx ];
+
+                texcoord = texcoordIdx >= 0 ? texcoords[ texcoordIdx ] : float2::ZERO;
+
+                if ( flipUVs )
+                    texcoord.y = 1.0f - texcoord.y;
+            }
+        }
+
+        MeshUtil::calculateTangents( *mesh );
+
+        mesh->recalculateBoundingBox();
+
+        meshes[ meshIdx ] = mesh;
+    } );
+
+    return meshes;
+}
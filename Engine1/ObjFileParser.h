@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+namespace Engine1
+{
+    class BlockMesh;
+
+    // Native parser of Wavefront OBJ files - used instead of Assimp for block meshes, as it's several times faster.
+    // The file is split into chunks (at line boundaries), which are parsed in parallel directly into the final vertex arrays.
+    // Each unique combination of position, texcoord and normal indices becomes a single vertex (vertices are welded).
+    // Polygons are triangulated as fans. Objects, groups and materials split faces into meshes the same way as in Assimp, so mesh indices match.
+    // Tangents are calculated if the mesh has normals and texcoords. Materials, smoothing groups, lines and points are ignored.
+    class ObjFileParser
+    {
+        public:
+
+        static std::vector< std::shared_ptr< BlockMesh > > parseBlockMeshFile( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt,
+                                                                               const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs );
+
+        private:
+
+        ObjFileParser() {};
+        ~ObjFileParser() {};
+    };
+}
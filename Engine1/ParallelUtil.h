@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace Engine1
+{
+    namespace ParallelUtil
+    {
+        inline int getThreadCount()
+        {
+            return std::max( 1, (int)std::thread::hardware_concurrency() );
+        }
+
+        inline bool& getWorkerThreadFlag()
+        {
+            thread_local bool isWorkerThread = false;
+            return isWorkerThread;
+        }
+
+        // Returns true if the current thread is one of the workers which already keep all cores busy (see WorkerThreadScope).
+        inline bool isWorkerThread()
+        {
+            return getWorkerThreadFlag();
+        }
+
+        // Marks the current thread as a worker until the end of the scope - ex: asset parsing threads, threads of parallelFor.
+        // parallelFor called on a worker thread runs serially, instead of spawning more threads than there are cores.
+        class WorkerThreadScope
+        {
+            public:
+            WorkerThreadScope() : 
+                m_wasWorkerThread( getWorkerThreadFlag() )
+            {
+                getWorkerThreadFlag() = true;
+            }
+
+            ~WorkerThreadScope()
+            {
+                getWorkerThreadFlag() = m_wasWorkerThread;
+            }
+
+            private:
+            WorkerThreadScope( const WorkerThreadScope& ) = delete;
+            WorkerThreadScope& operator=( const WorkerThreadScope& ) = delete;
+
+            const bool m_wasWorkerThread;
+        };
+
+        // Calls function( index ) for each index in [0, count) on multiple threads. Indices are taken one by one,
+        // so items of varying cost are balanced between the threads. Returns when all items are processed.
+        // Exception thrown by any item is re-thrown (after all threads finish). Runs serially on worker threads.
+        template< typename Function >
+        void parallelFor( const int count, const Function& function )
+        {
+            const int threadCount = isWorkerThread() ? 1 : std::min( count, getThreadCount() );
+
+            if ( threadCount <= 1 )
+            {
+                for ( int index = 0; index < count; ++index )
+                    function( index );
+
+                return;
+            }
+
+            std::atomic< int > nextIndex( 0 );
+
+            const auto processItems = [ &nextIndex, &function, count ]() {
+                // Nested calls run serially - all threads are busy already.
+                WorkerThreadScope workerThreadScope;
+
+                for ( int index = nextIndex++; index < count; index = nextIndex++ )
+                    function( index );
+            };
+
+            std::vector< std::future< void > > futures;
+            futures.reserve( threadCount - 1 );
+
+            for ( int threadIdx = 1; threadIdx < threadCount; ++threadIdx )
+                futures.push_back( std::async( std::launch::async, processItems ) );
+
+            // Current thread works too.
+            std::exception_ptr exception = nullptr;
+
+            try
+            {
+                processItems();
+            }
+            catch ( ... )
+            {
+                nextIndex = count; // Stop other threads early.
+                exception = std::current_exception();
+            }
+
+            for ( auto& future : futures )
+            {
+                try
+                {
+                    future.get();
+                }
+                catch ( ... )
+                {
+                    nextIndex = count;
+                    if ( !exception )
+                        exception = std::current_exception();
+                }
+            }
+
+            if ( exception )
+                std::rethrow_exception( exception );
+        }
+
+        // Splits [0, count) into ranges of at least minRangeSize elements and calls function( begin, end ) for each range in parallel.
+        template< typename Function >
+        void parallelForRanges( const size_t count, const size_t minRangeSize, const Function& function )
+        {
+            const size_t rangeCount = std::max( (size_t)1, std::min( (size_t)getThreadCount() * 4, count / std::max( (size_t)1, minRangeSize ) ) );
+            const size_t rangeSize  = ( count + rangeCount - 1 ) / rangeCount;
+
+            parallelFor( (int)rangeCount, [ &function, count, rangeSize ]( const int rangeIdx ) {
+                const size_t begin = (size_t)rangeIdx * rangeSize;
+                const size_t end   = std::min( count, begin + rangeSize );
+
+                if ( begin < end )
+                    function( begin, end );
+            } );
+        }
+    };
+}
@@ -1,7 +1,9 @@
 #include "AssetPathManager.h"
 
 #include "FileSystem.h"
+#include "AssetArchive.h"
 #include "FileUtil.h"
+#include "BinaryFile.h"
 
 #include <utility>
 
@@ -11,65 +13,368 @@
 
 using namespace Engine1;
 
-void PathManager::scanDirectory( const std::string& directory )
+const int PathManager::s_cacheVersion = 1;
+
+void PathManager::scanDirectory( const std::string& directory, const std::string& cachePath )
+{
+    std::lock_guard< std::mutex > scanLock( m_scanMutex );
+
+    m_directory.clear();
+    m_cachePath.clear();
+    m_directories.clear();
+
+    if ( cachePath.empty() )
+    {
+        m_directoryFilePaths = FileSystem::getAllFilesFromDirectory( directory );
+
+        updatePaths();
+        return;
+    }
+
+    std::vector< DirectoryInfo > directories;
+    scanDirectoryUsingCache( directory, cachePath, loadCache( cachePath, directory ), directories );
+
+    m_directory   = directory;
+    m_cachePath   = cachePath;
+    m_directories        = std::move( directories );
+    m_directoryFilePaths = getFilePaths( m_directories );
+
+    updatePaths();
+}
+
+void PathManager::rescanModifiedDirectories( const unsigned long long indexVersion )
+{
+    std::lock_guard< std::mutex > scanLock( m_scanMutex );
+
+    {
+        std::shared_lock< std::shared_timed_mutex > pathsLock( m_pathsMutex );
+
+        // Other thread rescanned the directories in the meantime.
+        if ( m_indexVersion != indexVersion )
+            return;
+    }
+
+    if ( m_directory.empty() )
+        return;
+
+    std::unordered_map< std::string, DirectoryInfo > cachedDirectories;
+    for ( const DirectoryInfo& directoryInfo : m_directories )
+        cachedDirectories.insert( std::make_pair( directoryInfo.path, directoryInfo ) );
+
+    std::vector< DirectoryInfo > directories;
+    const int scannedDirectoryCount = scanDirectoryUsingCache( m_directory, m_cachePath, cachedDirectories, directories );
+
+    if ( scannedDirectoryCount == 0 )
+    {
+        // Nothing changed - only let the threads waiting for this rescan know it's done.
+        std::unique_lock< std::shared_timed_mutex > pathsLock( m_pathsMutex );
+        ++m_indexVersion;
+        return;
+    }
+
+    m_directories        = std::move( directories );
+    m_directoryFilePaths = getFilePaths( m_directories );
+
+    updatePaths();
+}
+
+int PathManager::scanDirectoryUsingCache( const std::string& directory, const std::string& cachePath, 
+                                          const std::unordered_map< std::string, DirectoryInfo >& cachedDirectories, std::vector< DirectoryInfo >& directories )
+{
+    directories.clear();
+    directories.reserve( cachedDirectories.size() );
+
+    const int scannedDirectoryCount = scanDirectoryIncrementally( directory, cachedDirectories, directories );
+
+    OutputDebugStringW( StringUtil::widen( 
+        "PathManager::scanDirectoryUsingCache - scanned " + std::to_string( scannedDirectoryCount ) 
+        + " of " + std::to_string( directories.size() ) + " directories in \"" + directory + "\"\n" 
+    ).c_str() );
+
+    if ( scannedDirectoryCount > 0 )
+    {
+        try
+        {
+            saveCache( cachePath, directory, directories );
+        }
+        catch ( std::exception& ex )
+        {
+            // Not critical - directory will be scanned again next time.
+            OutputDebugStringW( StringUtil::widen( "PathManager::scanDirectoryUsingCache - failed to save cache \"" + cachePath + "\".\nException: " + ex.what() + ".\n" ).c_str() );
+        }
+    }
+
+    return scannedDirectoryCount;
+}
+
+int PathManager::scanDirectoryIncrementally( const std::string& path, const std::unordered_map< std::string, DirectoryInfo >& cachedDirectories,
+                                             std::vector< DirectoryInfo >& directories )
+{
+    int scannedDirectoryCount = 0;
+
+    const auto cachedIt = cachedDirectories.find( path );
+    if ( cachedIt != cachedDirectories.end() && cachedIt->second.lastWriteTime == FileSystem::getLastWriteTime( path ) )
+    {
+        directories.push_back( cachedIt->second );
+    }
+    else
+    {
+        DirectoryInfo directoryInfo;
+        directoryInfo.path          = path;
+        directoryInfo.lastWriteTime = FileSystem::getLastWriteTime( path );
+
+        FileSystem::getDirectoryContent( path, directoryInfo.fileNames, directoryInfo.subdirectoryNames );
+
+        directories.push_back( std::move( directoryInfo ) );
+        ++scannedDirectoryCount;
+    }
+
+    // Note: Copy, because the vector may reallocate while scanning the sub-directories.
+    const std::vector< std::string > subdirectoryNames = directories.back().subdirectoryNames;
+
+    for ( const std::string& subdirectoryName : subdirectoryNames )
+        scannedDirectoryCount += scanDirectoryIncrementally( path + "\\" + subdirectoryName, cachedDirectories, directories );
+
+    return scannedDirectoryCount;
+}
+
+std::unordered_map< std::string, PathManager::DirectoryInfo > PathManager::loadCache( const std::string& cachePath, const std::string& directory )
+{
+    std::unordered_map< std::string, DirectoryInfo > cachedDirectories;
+
+    if ( !FileSystem::exists( cachePath ) )
+        return cachedDirectories;
+
+    try
+    {
+        const std::shared_ptr< std::vector< char > > data = BinaryFile::load( cachePath );
+
+        // Every read is checked against the end of data, so a truncated cache can't be read out of bounds.
+        auto       dataIt    = data->cbegin();
+        const auto dataEndIt = data->cend();
+
+        const auto checkSize = [ & ]( const long long size ) {
+            if ( size < 0 || dataEndIt - dataIt < size )
+                throw std::exception( "PathManager::loadCache - cache is corrupted." );
+        };
+
+        const auto readString = [ & ]() {
+            checkSize( sizeof( int ) );
+            const int length = BinaryFile::readInt( dataIt );
+            checkSize( length );
+            return BinaryFile::readText( dataIt, length );
+        };
+
+        checkSize( sizeof( int ) );
+        if ( BinaryFile::readInt( dataIt ) != s_cacheVersion )
+            return cachedDirectories;
+
+        if ( readString() != directory )
+            return cachedDirectories;
+
+        checkSize( sizeof( int ) );
+        const int directoryCount = BinaryFile::readInt( dataIt );
+
+        for ( int directoryIndex = 0; directoryIndex < directoryCount; ++directoryIndex )
+        {
+            DirectoryInfo directoryInfo;
+            directoryInfo.path = readString();
+
+            checkSize( sizeof( long long ) );
+            directoryInfo.lastWriteTime = BinaryFile::readLongLong( dataIt );
+
+            checkSize( sizeof( int ) );
+            const int fileCount = BinaryFile::readInt( dataIt );
+            for ( int i = 0; i < fileCount; ++i )
+                directoryInfo.fileNames.push_back( readString() );
+
+            checkSize( sizeof( int ) );
+            const int subdirectoryCount = BinaryFile::readInt( dataIt );
+            for ( int i = 0; i < subdirectoryCount; ++i )
+                directoryInfo.subdirectoryNames.push_back( readString() );
+
+            const std::string path = directoryInfo.path;
+            cachedDirectories.insert( std::make_pair( path, std::move( directoryInfo ) ) );
+        }
+    }
+    catch ( std::exception& ex )
+    {
+        cachedDirectories.clear();
+
+        OutputDebugStringW( StringUtil::widen( "PathManager::loadCache - failed to read \"" + cachePath + "\" - directory will be scanned.\nException: " + ex.what() + ".\n" ).c_str() );
+    }
+
+    return cachedDirectories;
+}
+
+void PathManager::saveCache( const std::string& cachePath, const std::string& directory, const std::vector< DirectoryInfo >& directories )
 {
-    m_paths.clear();
+    std::vector< char > data;
+
+    const auto writeString = [ &data ]( const std::string& text ) {
+        BinaryFile::writeInt( data, (int)text.size() );
+        BinaryFile::writeText( data, text );
+    };
+
+    BinaryFile::writeInt( data, s_cacheVersion );
+    writeString( directory );
+    BinaryFile::writeInt( data, (int)directories.size() );
+
+    for ( const DirectoryInfo& directoryInfo : directories )
+    {
+        writeString( directoryInfo.path );
+        BinaryFile::writeLongLong( data, directoryInfo.lastWriteTime );
+
+        BinaryFile::writeInt( data, (int)directoryInfo.fileNames.size() );
+        for ( const std::string& fileName : directoryInfo.fileNames )
+            writeString( fileName );
 
-    bool duplicatesFound = false;
+        BinaryFile::writeInt( data, (int)directoryInfo.subdirectoryNames.size() );
+        for ( const std::string& subdirectoryName : directoryInfo.subdirectoryNames )
+            writeString( subdirectoryName );
+    }
+
+    BinaryFile::save( cachePath, data );
+}
+
+void PathManager::scanArchive( const AssetArchive& archive )
+{
+    std::lock_guard< std::mutex > scanLock( m_scanMutex );
+
+    m_archiveFilePaths = archive.getAllPaths();
+
+    updatePaths();
+}
+
+std::vector< std::string > PathManager::getFilePaths( const std::vector< DirectoryInfo >& directories )
+{
+    std::vector< std::string > filePaths;
+    for ( const DirectoryInfo& directoryInfo : directories )
+    {
+        for ( const std::string& fileName : directoryInfo.fileNames )
+            filePaths.push_back( directoryInfo.path + "\\" + fileName );
+    }
+
+    return filePaths;
+}
+
+void PathManager::updatePaths()
+{
+    // New index is built aside - readers keep using the old one until it's swapped in.
+    std::unordered_map< std::string, std::string > paths;
+    std::unordered_set< std::string >              archivedFileNames;
 
-    std::vector< std::string > filePaths = FileSystem::getAllFilesFromDirectory( directory );
+    paths.reserve( m_directoryFilePaths.size() + m_archiveFilePaths.size() );
 
-    for ( const auto& path : filePaths )
+    for ( const auto& path : m_directoryFilePaths )
     {
         const size_t slashPos = path.rfind('\\');
 
         const std::string fileName = slashPos != std::string::npos 
             ? path.substr( slashPos + 1 ) : path;
 
-        const auto insertResult = m_paths.insert( std::make_pair( fileName, path ) );
+        const auto insertResult = paths.insert( std::make_pair( fileName, path ) );
         
+        // Note: The first found file is used - duplicates are only reported, so a stray copy doesn't prevent the application from starting.
         const auto inserted = insertResult.second;
         if ( !inserted )
         {
-            duplicatesFound = true;
-
             const auto& existingPath = insertResult.first->second;
 
-            OutputDebugStringW( StringUtil::widen( "PathManager::initialize - duplicated asset: \n\"" + path + "\"\n\"" + existingPath + "\"\n" ).c_str( ) );
+            OutputDebugStringW( StringUtil::widen( "PathManager::updatePaths - duplicated asset (ignored): \n\"" + path + "\"\n\"" + existingPath + "\"\n" ).c_str( ) );
         }
     }
 
-    if ( duplicatesFound )
-        throw std::exception( "PathManager::initialize - duplicate assets found." );
+    // Add archived files which were not found in the directory.
+    for ( const auto& path : m_archiveFilePaths )
+    {
+        const std::string fileName = FileUtil::getFileNameFromPath( path );
+
+        if ( paths.insert( std::make_pair( fileName, path ) ).second )
+            archivedFileNames.insert( fileName );
+    }
+
+    std::unique_lock< std::shared_timed_mutex > pathsLock( m_pathsMutex );
+
+    m_paths.swap( paths );
+    m_archivedFileNames.swap( archivedFileNames );
+    ++m_indexVersion;
 }
 
-std::string PathManager::getPathForFileName( const std::string& fileName ) const
+void PathManager::addFile( const std::string& path )
+{
+    const std::string fileName = FileUtil::getFileNameFromPath( path );
+
+    std::lock_guard< std::mutex > scanLock( m_scanMutex );
+
+    {
+        std::unique_lock< std::shared_timed_mutex > pathsLock( m_pathsMutex );
+
+        const auto it = m_paths.find( fileName );
+        if ( it != m_paths.end() && m_archivedFileNames.count( fileName ) == 0 )
+            return;
+
+        // Directory files take precedence over archived files.
+        m_paths[ fileName ] = path;
+        m_archivedFileNames.erase( fileName );
+        ++m_indexVersion;
+    }
+
+    // Kept when the index is rebuilt. Rescans find the file in its directory anyway.
+    if ( m_directory.empty() )
+        m_directoryFilePaths.push_back( path );
+}
+
+std::string PathManager::getPathForFileName( const std::string& fileName )
 {
     if ( fileName.empty() )
         throw std::exception( "PathManager::getPathForFileName - empty file name passed." );
 
     // Make sure the given file name is really a name, not a path - convert if needed.
-    const auto name = FileUtil::getFileNameFromPath( fileName );
+    const std::string name = fileName.find( '\\' ) != std::string::npos ? FileUtil::getFileNameFromPath( fileName ) : fileName;
+
+    std::string        path;
+    bool               archived     = false;
+    unsigned long long indexVersion = 0;
 
-    const auto it = m_paths.find( name );
+    const auto findPath = [ & ]() {
+        std::shared_lock< std::shared_timed_mutex > pathsLock( m_pathsMutex );
 
-    if ( it == m_paths.end() ) 
+        indexVersion = m_indexVersion;
+
+        const auto it = m_paths.find( name );
+        if ( it == m_paths.end() )
+            return false;
+
+        path     = it->second;
+        archived = m_archivedFileNames.count( name ) > 0;
+        return true;
+    };
+
+    bool found = findPath();
+
+    // File may have been added, moved or renamed since the directory was scanned.
+    if ( !found || ( !archived && !FileSystem::exists( path ) ) )
+    {
+        rescanModifiedDirectories( indexVersion );
+
+        found = findPath();
+    }
+
+    if ( !found ) 
     {
         throw std::exception(
             ( std::string( "PathManager::getPathForFileName - filename \"" ) 
             +  fileName + "\" not found." ).c_str()
         );
     }
-    else
-    {
-        return it->second;
-    }
+
+    return path;
 }
 
-const std::unordered_map< std::string, std::string >& PathManager::getAllPaths() const
+std::unordered_map< std::string, std::string > PathManager::getAllPaths() const
 {
+    std::shared_lock< std::shared_timed_mutex > pathsLock( m_pathsMutex );
+
     return m_paths;
 }
-
-
-
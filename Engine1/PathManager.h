@@ -1,24 +1,93 @@
 #pragma once
 
+#include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Engine1
 {
+    class AssetArchive;
+
     class PathManager
     {
         public:
 
-        void scanDirectory( const std::string& directory );
+        // If cache path is given, only the directories modified since the cache was saved are scanned - the rest is taken from the cache.
+        // Directories are checked again when a file is not found or its path no longer exists (file moved or renamed since the scan).
+        // Note: Directory modification time changes only when files are added, removed or renamed in it - which is all we need to know.
+        void scanDirectory( const std::string& directory, const std::string& cachePath = "" );
+
+        // Adds all files from the archive. Files found in the scanned directory take precedence over archived files with the same name.
+        void scanArchive( const AssetArchive& archive );
+
+        // Adds a file saved by the application (ex: a mesh imported in the editor), so it's found without scanning the directory again.
+        // Note: Files already in the index are not replaced - the first found file is used, as when scanning.
+        void addFile( const std::string& path );
 
-        std::string getPathForFileName( const std::string& fileName ) const;
+        // May rescan the directory if the file is not found (see scanDirectory).
+        // Note: Thread-safe - called from the asset parsing threads while the index may be rescanned.
+        std::string getPathForFileName( const std::string& fileName );
 
-        const std::unordered_map< std::string, std::string >& getAllPaths() const;
+        std::unordered_map< std::string, std::string > getAllPaths() const;
 
         private:
 
+        struct DirectoryInfo
+        {
+            std::string                path;
+            long long                  lastWriteTime;
+            std::vector< std::string > fileNames;
+            std::vector< std::string > subdirectoryNames;
+        };
+
+        // Returns the number of directories which had to be scanned.
+        static int scanDirectoryUsingCache( const std::string& directory, const std::string& cachePath, 
+                                            const std::unordered_map< std::string, DirectoryInfo >& cachedDirectories, std::vector< DirectoryInfo >& directories );
+
+        // Reuses content of the cached directories which were not modified.
+        // Returns the number of directories which had to be scanned.
+        static int scanDirectoryIncrementally( const std::string& path, const std::unordered_map< std::string, DirectoryInfo >& cachedDirectories,
+                                               std::vector< DirectoryInfo >& directories );
+
+        // Returns empty cache if the file doesn't exist, is corrupted or was saved for a different directory.
+        static std::unordered_map< std::string, DirectoryInfo > loadCache( const std::string& cachePath, const std::string& directory );
+        static void                                             saveCache( const std::string& cachePath, const std::string& directory,
+                                                                           const std::vector< DirectoryInfo >& directories );
+
+        static std::vector< std::string > getFilePaths( const std::vector< DirectoryInfo >& directories );
+
+        static const int s_cacheVersion;
+
+        // Scans the directories modified since the last scan, unless other thread did it after the given index version was read.
+        void rescanModifiedDirectories( const unsigned long long indexVersion );
+
+        // Builds a new index from the scanned files and publishes it. Requires the scan lock.
+        void updatePaths();
+
+        // Serializes scans. Guards the directory and archive file lists - readers never wait for a scan, only for publishing its result.
+        std::mutex m_scanMutex;
+
+        // Set if the directory was scanned using a cache - then the modified directories can be rescanned without walking the whole tree.
+        std::string                  m_directory;
+        std::string                  m_cachePath;
+        std::vector< DirectoryInfo > m_directories;
+
+        std::vector< std::string > m_directoryFilePaths;
+        std::vector< std::string > m_archiveFilePaths;
+
+        // Guards the published index (shared_timed_mutex, because VS2015 doesn't have std::shared_mutex).
+        mutable std::shared_timed_mutex m_pathsMutex;
+
         // Key - file name (with extension), value - path to the file.
         std::unordered_map< std::string, std::string > m_paths;
+
+        // Names of the files taken from the archive - their paths don't exist on disk.
+        std::unordered_set< std::string > m_archivedFileNames;
+
+        // Incremented whenever a new index is published.
+        unsigned long long m_indexVersion = 0;
     };
 }
-
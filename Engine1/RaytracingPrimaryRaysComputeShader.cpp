@@ -113,6 +113,8 @@ void RaytracingPrimaryRaysComputeShader::setParameters( ID3D11DeviceContext3& de
         dataPtr->metalnessMul         = metalnessMul;
         dataPtr->roughnessMul         = roughnessMul;
         dataPtr->indexOfRefractionMul = indexOfRefractionMul;
+        dataPtr->vertexStrides        = mesh.getBufferResourceStrides();
+        dataPtr->vertexOffsets        = mesh.getBufferResourceOffsets();
 
         // Padding.
         dataPtr->pad1 = 0.0f;
@@ -8,6 +8,7 @@
 #include "float2.h"
 #include "float3.h"
 #include "float4.h"
+#include "uint4.h"
 #include "float44.h"
 
 #include "Texture2D.h"
@@ -71,6 +72,8 @@ namespace Engine1
             float3  pad9;
             float   indexOfRefractionMul;
             float3  pad10;
+            uint4   vertexStrides; // Strides (in bytes) of mesh vertices, normals, tangents and texcoords in their buffers.
+            uint4   vertexOffsets; // Offsets (in bytes) of mesh vertices, normals, tangents and texcoords in their buffers.
         };
 
         Microsoft::WRL::ComPtr<ID3D11SamplerState> m_samplerState;
@@ -116,6 +116,8 @@ void RaytracingSecondaryRaysComputeShader::setParameters( ID3D11DeviceContext3&
         dataPtr->metalnessMul         = metalnessMul;
         dataPtr->roughnessMul         = roughnessMul;
         dataPtr->indexOfRefractionMul = indexOfRefractionMul;
+        dataPtr->vertexStrides        = mesh.getBufferResourceStrides();
+        dataPtr->vertexOffsets        = mesh.getBufferResourceOffsets();
 
         // Padding.
         dataPtr->pad1 = 0.0f;
@@ -184,6 +184,8 @@ void RaytracingShadowsComputeShader::setParameters(
             dataPtr->boundingBoxMax[ passedActorsCount ]     = float4( boundingBox.getMax(), 0.0f );
             dataPtr->isOpaque[ passedActorsCount ]           = isOpaque ? float4::ONE : float4::ZERO;
             dataPtr->alphaMul[ passedActorsCount ]           = !actor->getModel()->getAlphaTextures().empty() ? actor->getModel()->getAlphaTextures()[ 0 ].getColorMultiplier() : float4::ONE;
+            dataPtr->vertexStrides[ passedActorsCount ]      = actor->getModel()->getMesh()->getBufferResourceStrides();
+            dataPtr->vertexOffsets[ passedActorsCount ]      = actor->getModel()->getMesh()->getBufferResourceOffsets();
 
             dataPtr->enableAlteringRayDirection = (settings().rendering.shadows.enableAlteringRayDirection ? 1.0f : 0.0f);
 
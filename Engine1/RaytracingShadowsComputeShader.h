@@ -10,6 +10,7 @@
 #include "float2.h"
 #include "float3.h"
 #include "float4.h"
+#include "uint4.h"
 #include "float44.h"
 
 #include "Texture2D.h"
@@ -98,6 +99,8 @@ namespace Engine1
             float3       pad18;
             float        enableAlteringRayDirection; // If enabled, rays at different pixels aim at different parts of area light. 1 - enabled, 0 - disabled.
             float3       pad19;
+            uint4        vertexStrides[ s_maxActorCount ]; // Strides (in bytes) of mesh vertices, normals, tangents and texcoords in their buffers.
+            uint4        vertexOffsets[ s_maxActorCount ]; // Offsets (in bytes) of mesh vertices, normals, tangents and texcoords in their buffers.
 		};
 
         int m_resourceCount;
@@ -8,16 +8,17 @@
 
 using namespace Engine1;
 
-std::tuple< std::shared_ptr<Scene>, std::shared_ptr<std::vector< std::shared_ptr<FileInfo> > > > Scene::createFromFile( std::string path )
+std::tuple< std::shared_ptr<Scene>, std::shared_ptr<std::vector< std::shared_ptr<FileInfo> > >, std::shared_ptr<std::vector< Scene::Dependency > > > 
+    Scene::createFromFile( std::string path )
 {
     std::shared_ptr<std::vector<char>> data = BinaryFile::load( path );
 
-    auto sceneAndModels = SceneParser::parseBinary( *data );
+    auto sceneModelsAndDependencies = SceneParser::parseBinary( *data );
 
     SceneFileInfo sceneFileInfo( path );
-    std::get< 0 >( sceneAndModels )->setFileInfo( sceneFileInfo );
+    std::get< 0 >( sceneModelsAndDependencies )->setFileInfo( sceneFileInfo );
 
-    return sceneAndModels;
+    return sceneModelsAndDependencies;
 }
 
 Scene::Scene()
@@ -84,15 +85,20 @@ void Scene::removeAllLights()
     m_lights.clear();
 }
 
-void Scene::saveToFile( const std::string& path ) const
+void Scene::saveToFile( const std::string& path, const bool saveDependencies ) const
 {
     std::vector<char> data;
 
-    SceneParser::writeBinary( data, *this );
+    saveToMemory( data, saveDependencies );
 
     BinaryFile::save( path, data );
 }
 
+void Scene::saveToMemory( std::vector<char>& data, const bool saveDependencies ) const
+{
+    SceneParser::writeBinary( data, *this, saveDependencies );
+}
+
 const std::unordered_set< std::shared_ptr<Actor> >& Scene::getActors( ) const
 {
     return m_actors;
@@ -3,6 +3,7 @@
 #include <unordered_set>
 #include <vector>
 #include <memory>
+#include <tuple>
 
 #include "SceneFileInfo.h"
 
@@ -19,8 +20,17 @@ namespace Engine1
 
         public:
 
-        // Returns the parsed scene (with models containing only file info) and a vector of unique models (their file infos) in that scene.
-        static std::tuple< std::shared_ptr<Scene>, std::shared_ptr<std::vector< std::shared_ptr<FileInfo> > > > createFromFile( std::string path );
+        // Asset used by the scene's models - directly or through other assets.
+        struct Dependency
+        {
+            std::shared_ptr<FileInfo> fileInfo;
+            long long                 fileSize; // In bytes. Zero if unknown.
+        };
+
+        // Returns the parsed scene (with models containing only file info), a vector of unique models (their file infos) in that scene
+        // and all assets used by these models. Dependencies are empty if the scene was saved without them.
+        static std::tuple< std::shared_ptr<Scene>, std::shared_ptr<std::vector< std::shared_ptr<FileInfo> > >, std::shared_ptr<std::vector< Dependency > > > 
+            createFromFile( std::string path );
 
         Scene();
         ~Scene();
@@ -42,7 +52,9 @@ namespace Engine1
         const std::unordered_set< std::shared_ptr<Light> >& getLights( ) const;
         std::vector< std::shared_ptr<Light> >               getLightsVec( ) const;
 
-        void saveToFile( const std::string& path ) const;
+        // Dependencies of the models are saved too (if the models are loaded), so they can be loaded in parallel with the models.
+        void saveToFile( const std::string& path, const bool saveDependencies = true ) const;
+        void saveToMemory( std::vector<char>& data, const bool saveDependencies = true ) const;
 
         private:
 
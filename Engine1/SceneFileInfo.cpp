@@ -35,6 +35,7 @@ void SceneFileInfo::saveToMemory( std::vector<char>& data ) const
 void SceneFileInfo::setPath( std::string path )
 {
 	this->m_path = path;
+	invalidateAssetId();
 }
 
 Asset::Type SceneFileInfo::getAssetType( ) const
@@ -28,6 +28,8 @@
 #include "SpotLight.h"
 
 #include "BlockModelImporter.h"
+#include "MeshFileParser.h"
+#include "TextFile.h"
 
 #include "AssetPathManager.h"
 #include "Settings.h"
@@ -46,6 +48,12 @@ SceneManager::SceneManager( AssetManager& assetManager ) :
     m_camera->setUp( float3( 0.0f, 1.0f, 0.0f ) );
     m_camera->setPosition( float3( 30.0f, 4.0f, -53.0f ) );
     m_camera->rotate( float3( 0.0f, MathUtil::piHalf, 0.0f ) );
+
+    // Don't hot-reload assets saved by the editor itself. Newly saved files (ex: imported meshes) can be found by name right away.
+    m_fileSaveQueue.setOnSaved( [ this ]( const std::string& path ) { 
+        m_assetManager.ignoreFileChange( path ); 
+        AssetPathManager::get().addFile( path );
+    } );
 }
 
 void SceneManager::initialize( Microsoft::WRL::ComPtr< ID3D11Device3 > device, Microsoft::WRL::ComPtr< ID3D11DeviceContext3 > deviceContext )
@@ -102,8 +110,24 @@ void SceneManager::saveCamera( std::string path )
 void SceneManager::loadScene( std::string path )
 {
     std::shared_ptr< std::vector < std::shared_ptr< FileInfo > > > fileInfos;
+    std::shared_ptr< std::vector < Scene::Dependency > >           dependencies;
+
+    std::tie( m_scene, fileInfos, dependencies ) = Scene::createFromFile( path );
+
+    // Record only the loading of this scene.
+    m_assetManager.getLoadStats().reset();
+
+    // Enqueue all dependencies of the models up front, so they are read in parallel instead of being discovered
+    // one by one while parsing the models. Largest files go first as they take the longest to read and parse.
+    // Note: When a parsed model requests its sub-assets, they are moved to the front of the queues (see AssetManager::loadAsync).
+    std::stable_sort( dependencies->begin(), dependencies->end(), 
+        []( const Scene::Dependency& dependency1, const Scene::Dependency& dependency2 ) { 
+            return dependency1.fileSize > dependency2.fileSize; 
+        } 
+    );
 
-    std::tie( m_scene, fileInfos ) = Scene::createFromFile( path );
+    for ( const Scene::Dependency& dependency : *dependencies )
+        m_assetManager.loadAsync( *dependency.fileInfo );
 
     // Load all assets.
     for ( const std::shared_ptr<FileInfo>& fileInfo : *fileInfos )
@@ -119,7 +143,7 @@ void SceneManager::loadScene( std::string path )
         const float loadingTime = (float)Timer::getElapsedTime( currTime, loadingStartTime ) / 1000.0f;
         const float timeout = std::max( 0.0f, maxLoadingTime - loadingTime );
 
-        const auto asset = m_assetManager.getWhenLoaded( fileInfo->getAssetType(), fileInfo->getPath(), fileInfo->getIndexInFile(), timeout );
+        const auto asset = m_assetManager.getWhenLoaded( fileInfo->getAssetId(), timeout );
 
         if ( asset ) {
             ++loadedAssetsCount;
@@ -140,17 +164,22 @@ void SceneManager::loadScene( std::string path )
             const std::shared_ptr<BlockActor>& blockActor = std::static_pointer_cast<BlockActor>( actor );
             if ( blockActor->getModel() ) {
                 const BlockModelFileInfo& fileInfo = blockActor->getModel()->getFileInfo();
-                std::shared_ptr<BlockModel> blockModel = std::static_pointer_cast<BlockModel>( m_assetManager.get( fileInfo.getAssetType(), fileInfo.getPath(), fileInfo.getIndexInFile() ) );
+                std::shared_ptr<BlockModel> blockModel = std::static_pointer_cast<BlockModel>( m_assetManager.get( fileInfo.getAssetId() ) );
                 if ( blockModel ) {
-                    // Build BVH tree and load it to GPU.
-                    if ( blockModel->getMesh() ) {
-                        if ( !blockModel->getMesh()->getBvhTree() )
-                            blockModel->getMesh()->buildBvhTree();
+                    // Build BVH tree.
+                    if ( blockModel->getMesh() && !blockModel->getMesh()->getBvhTree() )
+                        blockModel->getMesh()->buildBvhTree();
 
+                    m_assetManager.getLoadStats().onGpuUploadStarted( fileInfo );
+
+                    // Load BVH tree and the model to GPU.
+                    if ( blockModel->getMesh() )
                         blockModel->getMesh()->loadBvhTreeToGpu( *m_device.Get() );
-                    }
 
                     blockModel->loadCpuToGpu( *m_device.Get(), *m_deviceContext.Get() );
+
+                    m_assetManager.getLoadStats().onGpuUploadFinished( fileInfo );
+
                     blockActor->setModel( blockModel ); // Swap an empty model with a loaded model.
                 } else {
                     //throw std::exception( "SceneManager::loadScene - failed to load one of the scene's models." );
@@ -160,9 +189,12 @@ void SceneManager::loadScene( std::string path )
             const std::shared_ptr<SkeletonActor>& skeletonActor = std::static_pointer_cast<SkeletonActor>( actor );
             if ( skeletonActor->getModel() ) {
                 const SkeletonModelFileInfo& fileInfo = skeletonActor->getModel()->getFileInfo();
-                std::shared_ptr<SkeletonModel> skeletonModel = std::static_pointer_cast<SkeletonModel>( m_assetManager.get( fileInfo.getAssetType(), fileInfo.getPath(), fileInfo.getIndexInFile() ) );
+                std::shared_ptr<SkeletonModel> skeletonModel = std::static_pointer_cast<SkeletonModel>( m_assetManager.get( fileInfo.getAssetId() ) );
                 if ( skeletonModel ) {
+                    m_assetManager.getLoadStats().onGpuUploadStarted( fileInfo );
                     skeletonModel->loadCpuToGpu( *m_device.Get(), *m_deviceContext.Get() );
+                    m_assetManager.getLoadStats().onGpuUploadFinished( fileInfo );
+
                     skeletonActor->setModel( skeletonModel ); // Swap an empty model with a loaded model.
                 } else {
                     //throw std::exception( "SceneManager::loadScene - failed to load one of the scene's models." );
@@ -174,7 +206,11 @@ void SceneManager::loadScene( std::string path )
 
 void SceneManager::saveScene( std::string path )
 {
-    m_scene->saveToFile( path );
+    // Scene is serialized right away (it's small and can change in the next frame), only writing the file happens in the background.
+    std::vector< char > data;
+    m_scene->saveToMemory( data );
+
+    m_fileSaveQueue.enqueue( path, std::move( data ) );
 }
 
 void SceneManager::loadAsset( std::string filePath, const bool replaceSelected, const bool invertZ, const bool invertVertexWindingOrder, const bool invertUVs )
@@ -190,7 +226,7 @@ void SceneManager::loadAsset( std::string filePath, const bool replaceSelected,
     std::string extension = StringUtil::toLowercase( filePath.substr( dotIndex + 1 ) );
 
     std::array< const std::string, 3 > blockMeshExtensions             = { "dae", "fbx", "blockmesh" };
-    std::array< const std::string, 1 > skeletonkMeshExtensions         = { "dae" };
+    std::array< const std::string, 2 > skeletonkMeshExtensions         = { "dae", "skeletonmesh" };
     std::array< const std::string, 9 > textureExtensions               = { "bmp", "dds", "jpg", "jpeg", "png", "raw", "tga", "tiff", "tif" };
     std::array< const std::string, 2 > blockModelExtensions            = { "blockmodel", "obj" };
     std::array< const std::string, 1 > skeletonModelExtensions         = { "skeletonmodel" };
@@ -313,12 +349,7 @@ void SceneManager::loadAsset( std::string filePath, const bool replaceSelected,
 
                 // Save mesh to .blockmesh format for future use.
                 if ( format != BlockMeshFileInfo::Format::BLOCKMESH )
-                {
-                    mesh->saveToFile( filePathWithoutExtension + ( indexInFile != 0 ? "_" + std::to_string( indexInFile ) : "" ) + ".blockmesh", BlockMeshFileInfo::Format::BLOCKMESH );
-
-                    // Re-scan all paths to detect newly exported files.
-                    AssetPathManager::get().scanDirectory( settings().paths.assets );
-                }
+                    saveMeshInBackground( mesh, filePathWithoutExtension + ( indexInFile != 0 ? "_" + std::to_string( indexInFile ) : "" ) + ".blockmesh", BlockMeshFileInfo::Format::BLOCKMESH );
             } catch ( ... ) {
                 break;
             }
@@ -328,7 +359,8 @@ void SceneManager::loadAsset( std::string filePath, const bool replaceSelected,
     if ( isSkeletonMesh ) {
         SkeletonMeshFileInfo::Format format = SkeletonMeshFileInfo::Format::DAE;
 
-        if ( extension.compare( "dae" ) == 0 ) format = SkeletonMeshFileInfo::Format::DAE;
+        if ( extension.compare( "dae" ) == 0 )               format = SkeletonMeshFileInfo::Format::DAE;
+        else if ( extension.compare( "skeletonmesh" ) == 0 ) format = SkeletonMeshFileInfo::Format::SKELETONMESH;
 
         // Note: Bad support for multiple meshes in a single file. Because of how AssetManager works, they have to be parsed one by one from the same file.
         // So the file has to be re-parsed for each mesh it contains. Not a big problem normally, because only one mesh should be in a single file.
@@ -350,6 +382,10 @@ void SceneManager::loadAsset( std::string filePath, const bool replaceSelected,
 
                 m_scene->addActor( newActor );
                 m_selection.clear();
+
+                // Save mesh to .skeletonmesh format for future use.
+                if ( format != SkeletonMeshFileInfo::Format::SKELETONMESH )
+                    saveMeshInBackground( mesh, filePathWithoutExtension + ( indexInFile != 0 ? "_" + std::to_string( indexInFile ) : "" ) + ".skeletonmesh", SkeletonMeshFileInfo::Format::SKELETONMESH );
             } catch ( ... ) {
                 break;
             }
@@ -440,22 +476,19 @@ void SceneManager::loadAsset( std::string filePath, const bool replaceSelected,
                 std::string meshPath = filePathWithoutExtension + ( modelIdx != 0 ? "_" + std::to_string( modelIdx ) : "" ) + ".blockmesh";
                 std::string modelPath = filePathWithoutExtension + ( modelIdx != 0 ? "_" + std::to_string( modelIdx ) : "" ) + ".blockmodel";
                 
-                model->getMesh()->saveToFile( meshPath, BlockMeshFileInfo::Format::BLOCKMESH );
+                saveMeshInBackground( model->getMesh(), meshPath, BlockMeshFileInfo::Format::BLOCKMESH );
 
                 model->getMesh()->getFileInfo().setPath( meshPath );
                 model->getMesh()->getFileInfo().setFormat( BlockMeshFileInfo::Format::BLOCKMESH );
                 model->getMesh()->getFileInfo().setIndexInFile( 0 );
 
-                model->saveToFile( modelPath );
+                saveModelInBackground( *model, modelPath );
 
                 OutputDebugStringW( StringUtil::widen( 
                     "SceneManager::loadAsset - imported a model and re-saved as \"" 
                     + modelPath + "\n"  
                 ).c_str( ) );
             }
-
-            // Re-scan all paths to detect newly exported files.
-            AssetPathManager::get().scanDirectory( settings().paths.assets );
         }
     }
 
@@ -674,8 +707,8 @@ void SceneManager::mergeSelectedActors()
                 mergedModel->getMesh()->getFileInfo().setFormat( BlockMeshFileInfo::Format::BLOCKMESH );
                 mergedModel->getMesh()->getFileInfo().setIndexInFile( 0 );
 
-                mergedModel->getMesh()->saveToFile( mergedMeshPath, BlockMeshFileInfo::Format::OBJ );
-                mergedModel->getMesh()->saveToFile( mergedMeshPath2, BlockMeshFileInfo::Format::BLOCKMESH );
+                saveMeshInBackground( mergedModel->getMesh(), mergedMeshPath, BlockMeshFileInfo::Format::OBJ );
+                saveMeshInBackground( mergedModel->getMesh(), mergedMeshPath2, BlockMeshFileInfo::Format::BLOCKMESH );
             }
 
             int textureIndex = 0;
@@ -766,7 +799,7 @@ void SceneManager::mergeSelectedActors()
             BlockModelFileInfo mergedModelFileInfo( mergedModelPath, BlockModelFileInfo::Format::BLOCKMODEL, 0 );
             mergedModel->setFileInfo( mergedModelFileInfo );
 
-            mergedModel->saveToFile( mergedModelPath );
+            saveModelInBackground( *mergedModel, mergedModelPath );
         }
 
         const auto& pose = m_selection.getBlockActors().front()->getPose();
@@ -796,7 +829,7 @@ void SceneManager::saveSelectedModels()
             }
 
             if ( !path.empty() )
-                model->saveToFile( path );
+                saveModelInBackground( *model, path );
         }
     }
 }
@@ -917,6 +950,11 @@ void SceneManager::saveSceneOrSelectedModels()
     }
 }
 
+std::vector< FileSaveQueue::FailedSave > SceneManager::takeFailedSaves()
+{
+    return m_fileSaveQueue.takeFailedSaves();
+}
+
 bool SceneManager::isSelectionEmpty()
 {
     return m_selection.isEmpty();
@@ -1282,9 +1320,16 @@ void SceneManager::rebuildBoundingBoxAndBVH()
         if ( !actor->getModel() || !actor->getModel()->getMesh() )
             continue;
 
+        // BVH tree is saved with the mesh.
+        m_fileSaveQueue.waitUntilSaved( actor->getModel()->getMesh().get() );
+
         actor->getModel()->getMesh()->recalculateBoundingBox();
         actor->getModel()->getMesh()->buildBvhTree();
 
+        // Meshlets are built in the triangle order of the BVH tree.
+        if ( actor->getModel()->getMesh()->getMeshlets() )
+            actor->getModel()->getMesh()->buildMeshlets();
+
         actor->getModel()->getMesh()->unloadBvhTreeFromGpu();
         actor->getModel()->getMesh()->loadBvhTreeToGpu( *m_device.Get() );
     }
@@ -1299,12 +1344,13 @@ void SceneManager::flipTexcoordsVerticallyAndResaveMesh()
 
         auto mesh = actor->getModel()->getMesh();
 
+        m_fileSaveQueue.waitUntilSaved( mesh.get() );
+
         MeshUtil::flipTexcoordsVertically( *mesh );
 
         mesh->loadCpuToGpu( *m_device.Get(), true );
 
-        if ( !mesh->getFileInfo().getPath().empty() )
-            mesh->saveToFile( mesh->getFileInfo().getPath(), mesh->getFileInfo().getFormat() );
+        resaveMesh( mesh );
     }
 }
 
@@ -1316,12 +1362,13 @@ void SceneManager::flipTangentsAndResaveMesh()
 
         auto mesh = actor->getModel()->getMesh();
 
+        m_fileSaveQueue.waitUntilSaved( mesh.get() );
+
         MeshUtil::flipTangents( *mesh );
 
         mesh->loadCpuToGpu( *m_device.Get(), true );
 
-        if ( !mesh->getFileInfo().getPath().empty() )
-            mesh->saveToFile( mesh->getFileInfo().getPath(), mesh->getFileInfo().getFormat() );
+        resaveMesh( mesh );
     }
 }
 
@@ -1333,12 +1380,13 @@ void SceneManager::flipNormalsAndResaveMesh()
 
         auto mesh = actor->getModel()->getMesh();
 
+        m_fileSaveQueue.waitUntilSaved( mesh.get() );
+
         MeshUtil::flipNormals( *mesh );
 
         mesh->loadCpuToGpu( *m_device.Get(), true );
 
-        if ( !mesh->getFileInfo().getPath().empty() )
-            mesh->saveToFile( mesh->getFileInfo().getPath(), mesh->getFileInfo().getFormat() );
+        resaveMesh( mesh );
     }
 }
 
@@ -1350,11 +1398,63 @@ void SceneManager::invertVertexWindingOrderAndResaveMesh()
 
         auto mesh = actor->getModel()->getMesh();
 
+        m_fileSaveQueue.waitUntilSaved( mesh.get() );
+
         MeshUtil::invertVertexWindingOrder( *mesh );
 
         mesh->loadCpuToGpu( *m_device.Get(), true );
 
-        if ( !mesh->getFileInfo().getPath().empty() )
-            mesh->saveToFile( mesh->getFileInfo().getPath(), mesh->getFileInfo().getFormat() );
+        resaveMesh( mesh );
+    }
+}
+
+void SceneManager::switchVertexLayoutAndResaveMesh()
+{
+    for ( auto& actor : m_selection.getBlockActors() ) {
+        if ( !actor->getModel() || !actor->getModel()->getMesh() )
+            continue;
+
+        auto mesh = actor->getModel()->getMesh();
+
+        m_fileSaveQueue.waitUntilSaved( mesh.get() );
+
+        switch ( mesh->getVertexLayout() )
+        {
+            case BlockMesh::VertexLayout::Separate:    mesh->setVertexLayout( BlockMesh::VertexLayout::Interleaved ); break;
+            case BlockMesh::VertexLayout::Interleaved: mesh->setVertexLayout( BlockMesh::VertexLayout::Hybrid ); break;
+            default:                                   mesh->setVertexLayout( BlockMesh::VertexLayout::Separate ); break;
+        }
+
+        mesh->loadCpuToGpu( *m_device.Get(), true );
+
+        resaveMesh( mesh );
     }
-}
\ No newline at end of file
+}
+
+void SceneManager::resaveMesh( const std::shared_ptr< BlockMesh >& mesh )
+{
+    if ( mesh->getFileInfo().getPath().empty() )
+        return;
+
+    saveMeshInBackground( mesh, mesh->getFileInfo().getPath(), mesh->getFileInfo().getFormat() );
+}
+
+void SceneManager::saveMeshInBackground( const std::shared_ptr< BlockMesh >& mesh, const std::string& path, const BlockMeshFileInfo::Format format )
+{
+    // Mesh is written directly from its data on the save thread - its edits wait until it's saved.
+    m_fileSaveQueue.enqueue( path, [ mesh, format ]( const std::string& tempPath ) { mesh->saveToFile( tempPath, format ); }, mesh.get() );
+}
+
+void SceneManager::saveMeshInBackground( const std::shared_ptr< SkeletonMesh >& mesh, const std::string& path, const SkeletonMeshFileInfo::Format format )
+{
+    m_fileSaveQueue.enqueue( path, [ mesh, format ]( const std::string& tempPath ) { mesh->saveToFile( tempPath, format ); }, mesh.get() );
+}
+
+void SceneManager::saveModelInBackground( const BlockModel& model, const std::string& path )
+{
+    // Model only references its mesh and textures - it's small enough to be serialized right away.
+    std::vector< char > data;
+    model.saveToMemory( data );
+
+    m_fileSaveQueue.enqueue( path, std::move( data ) );
+}
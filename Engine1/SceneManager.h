@@ -12,11 +12,14 @@
 #include "FreeCamera.h"
 #include "BlockActor.h"
 #include "BlockModel.h"
+#include "BlockMeshFileInfo.h"
+#include "SkeletonMeshFileInfo.h"
 
 #include "Texture2DTypes.h"
 
 #include "Selection.h"
 #include "Animator.h"
+#include "FileSaveQueue.h"
 
 struct ID3D11Device3;
 struct ID3D11DeviceContext3;
@@ -30,6 +33,7 @@ namespace Engine1
     class Scene;
     class Actor;
     class BlockMesh;
+    class SkeletonMesh;
 
     class SceneManager
     {
@@ -76,6 +80,9 @@ namespace Engine1
         void enableDisableSelectedLights();
 
         void saveSceneOrSelectedModels();
+
+        // Files are saved in the background - returns saves which failed since the last call.
+        std::vector< FileSaveQueue::FailedSave > takeFailedSaves();
         
         bool isSelectionEmpty();
         void selectAll();
@@ -112,9 +119,18 @@ namespace Engine1
         void flipTangentsAndResaveMesh();
         void flipNormalsAndResaveMesh();
         void invertVertexWindingOrderAndResaveMesh();
+        // Switches to the next vertex layout (separate, interleaved, hybrid). The layout is saved only in own mesh format.
+        void switchVertexLayoutAndResaveMesh();
 
         private:
 
+        void resaveMesh( const std::shared_ptr< BlockMesh >& mesh );
+
+        // Meshes are written on the save thread directly from their data - edits of a mesh have to wait until it's saved (see FileSaveQueue::waitUntilSaved).
+        void saveMeshInBackground( const std::shared_ptr< BlockMesh >& mesh, const std::string& path, const BlockMeshFileInfo::Format format );
+        void saveMeshInBackground( const std::shared_ptr< SkeletonMesh >& mesh, const std::string& path, const SkeletonMeshFileInfo::Format format );
+        void saveModelInBackground( const BlockModel& model, const std::string& path );
+
         Microsoft::WRL::ComPtr< ID3D11Device3 >        m_device;
         Microsoft::WRL::ComPtr< ID3D11DeviceContext3 > m_deviceContext;
 
@@ -139,6 +155,10 @@ namespace Engine1
 
         std::vector< std::shared_ptr< Texture2D< unsigned char > > > m_texturesToMerge;
         std::vector< std::shared_ptr< BlockMesh > >                         m_meshesToMerge;
+
+        // Saves scene, models and edited meshes in the background. They are serialized on the calling thread, so they can be modified right away.
+        // Declared last to finish the saves before other members are destroyed.
+        FileSaveQueue m_fileSaveQueue;
     };
 };
 
@@ -10,6 +10,11 @@
 #include "SkeletonActor.h"
 #include "SkeletonModel.h"
 #include "SkeletonModelFileInfo.h"
+#include "BlockMeshFileInfo.h"
+#include "SkeletonMeshFileInfo.h"
+#include "Texture2DFileInfo.h"
+#include "SkeletonAnimationFileInfo.h"
+#include "FileSystem.h"
 
 #include "PointLight.h"
 #include "SpotLight.h"
@@ -18,7 +23,8 @@
 
 using namespace Engine1;
 
-std::tuple< std::shared_ptr<Scene>, std::shared_ptr<std::vector< std::shared_ptr<FileInfo> > > > SceneParser::parseBinary( const std::vector<char>& data )
+std::tuple< std::shared_ptr<Scene>, std::shared_ptr<std::vector< std::shared_ptr<FileInfo> > >, std::shared_ptr<std::vector< Scene::Dependency > > > 
+    SceneParser::parseBinary( const std::vector<char>& data )
 {
     std::shared_ptr<Scene> scene = std::make_shared<Scene>();
 
@@ -88,11 +94,75 @@ std::tuple< std::shared_ptr<Scene>, std::shared_ptr<std::vector< std::shared_ptr
         for ( int i = 0; i < spotLightCount; ++i )
             scene->addLight( SpotLight::createFromMemory( dataIt, dataEndIt ) );
     }
+
+    std::shared_ptr< std::vector< Scene::Dependency > > dependencies = std::make_shared< std::vector< Scene::Dependency > >();
+
+    // Read dependencies - optional, scenes saved before they were introduced end after the lights.
+    if ( dataIt != dataEndIt ) {
+        // Read number of dependencies.
+        const int dependencyCount = BinaryFile::readInt( dataIt );
+
+        dependencies->reserve( dependencyCount );
+
+        // Read dependencies.
+        for ( int i = 0; i < dependencyCount; ++i ) {
+            Scene::Dependency dependency;
+
+            const Asset::Type assetType = static_cast<Asset::Type>(BinaryFile::readChar( dataIt )); // Read file info type.
+            dependency.fileSize = BinaryFile::readLongLong( dataIt );                                // Read file size.
+            dependency.fileInfo = readDependencyFileInfo( dataIt, assetType );                       // Read file info.
+
+            dependencies->push_back( dependency );
+        }
+    }
     
-    return std::make_pair( scene, fileInfos );
+    return std::make_tuple( scene, fileInfos, dependencies );
 }
 
-void SceneParser::writeBinary( std::vector<char>& data, const Scene& scene )
+std::shared_ptr<FileInfo> SceneParser::readDependencyFileInfo( std::vector<char>::const_iterator& dataIt, const Asset::Type assetType )
+{
+    switch ( assetType ) {
+        case Asset::Type::BlockMesh:         return BlockMeshFileInfo::createFromMemory( dataIt );
+        case Asset::Type::SkeletonMesh:      return SkeletonMeshFileInfo::createFromMemory( dataIt );
+        case Asset::Type::Texture2D:         return Texture2DFileInfo::createFromMemory( dataIt );
+        case Asset::Type::SkeletonAnimation: return SkeletonAnimationFileInfo::createFromMemory( dataIt );
+    }
+
+    throw std::exception( "SceneParser::readDependencyFileInfo - unsupported asset type." );
+}
+
+void SceneParser::collectDependencies( const Asset& asset, std::unordered_set< Asset::Id >& visitedAssetIds, std::vector< Scene::Dependency >& dependencies )
+{
+    for ( const std::shared_ptr<const Asset>& subAsset : asset.getSubAssets() ) {
+        if ( !subAsset )
+            continue;
+
+        const FileInfo&   fileInfo  = subAsset->getFileInfo();
+        const Asset::Type assetType = fileInfo.getAssetType();
+
+        const bool isSupportedType = assetType == Asset::Type::BlockMesh || assetType == Asset::Type::SkeletonMesh
+                                     || assetType == Asset::Type::Texture2D || assetType == Asset::Type::SkeletonAnimation;
+
+        // Sub-assets without a file (ex: created at runtime) can't be loaded anyway.
+        if ( isSupportedType && !fileInfo.getPath().empty() && visitedAssetIds.insert( fileInfo.getAssetId() ).second ) {
+            Scene::Dependency dependency;
+            dependency.fileInfo = fileInfo.clone();
+            dependency.fileSize = 0;
+
+            try {
+                dependency.fileSize = FileSystem::getFileSize( fileInfo.getPath() );
+            } catch ( ... ) {
+                // Size is only used to prioritize loading - not critical.
+            }
+
+            dependencies.push_back( dependency );
+        }
+
+        collectDependencies( *subAsset, visitedAssetIds, dependencies );
+    }
+}
+
+void SceneParser::writeBinary( std::vector<char>& data, const Scene& scene, const bool writeDependencies )
 {
     { // Save actors.
         // Assigns each unique FileInfo an unique temporary id.
@@ -203,6 +273,34 @@ void SceneParser::writeBinary( std::vector<char>& data, const Scene& scene )
             }
         }
     }
+
+    if ( writeDependencies ) { // Save dependencies.
+        std::unordered_set< Asset::Id >  visitedAssetIds;
+        std::vector< Scene::Dependency > dependencies;
+
+        // Collect all unique sub-assets (recursively) of each model in the scene.
+        for ( const std::shared_ptr<Actor>& actor : scene.m_actors ) {
+            std::shared_ptr<const Asset> model;
+
+            if ( actor->getType() == Actor::Type::BlockActor )
+                model = std::static_pointer_cast<BlockActor>(actor)->getModel();
+            else if ( actor->getType() == Actor::Type::SkeletonActor )
+                model = std::static_pointer_cast<SkeletonActor>(actor)->getModel();
+
+            if ( model && visitedAssetIds.insert( model->getFileInfo().getAssetId() ).second )
+                collectDependencies( *model, visitedAssetIds, dependencies );
+        }
+
+        // Save number of dependencies.
+        BinaryFile::writeInt( data, (int)dependencies.size() );
+
+        // Save dependencies.
+        for ( const Scene::Dependency& dependency : dependencies ) {
+            BinaryFile::writeChar( data, static_cast<char>(dependency.fileInfo->getAssetType()) ); // Save file info type.
+            BinaryFile::writeLongLong( data, dependency.fileSize );                               // Save file size.
+            dependency.fileInfo->saveToMemory( data );                                            // Save file info.
+        }
+    }
 }
 
 std::size_t SceneParser::FileInfoHasher::operator( )( const std::shared_ptr<FileInfo>& fileInfo ) const
@@ -3,10 +3,13 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_set>
+
+#include "Scene.h"
+#include "Asset.h"
 
 namespace Engine1
 {
-    class Scene;
     class FileInfo;
 
     class SceneParser
@@ -15,10 +18,16 @@ namespace Engine1
 
         private:
 
-        // Returns the parsed scene (with models containing only file info) and a vector of unique models (their file infos) in that scene.
-        static std::tuple< std::shared_ptr<Scene>, std::shared_ptr<std::vector< std::shared_ptr<FileInfo> > > > parseBinary( const std::vector<char>& data );
+        // Returns the parsed scene (with models containing only file info), a vector of unique models (their file infos) in that scene
+        // and all their dependencies (empty if the scene was saved without them).
+        static std::tuple< std::shared_ptr<Scene>, std::shared_ptr<std::vector< std::shared_ptr<FileInfo> > >, std::shared_ptr<std::vector< Scene::Dependency > > > 
+            parseBinary( const std::vector<char>& data );
+
+        // Dependencies are collected from the sub-assets of the models, so the models should be loaded.
+        static void writeBinary( std::vector<char>& data, const Scene& scene, const bool writeDependencies );
 
-        static void writeBinary( std::vector<char>& data, const Scene& scene );
+        static std::shared_ptr<FileInfo> readDependencyFileInfo( std::vector<char>::const_iterator& dataIt, const Asset::Type assetType );
+        static void                      collectDependencies( const Asset& asset, std::unordered_set< Asset::Id >& visitedAssetIds, std::vector< Scene::Dependency >& dependencies );
 
         struct FileInfoHasher
         {
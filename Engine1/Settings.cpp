@@ -3,8 +3,6 @@
 #include <algorithm>
 #include "MathUtil.h"
 
-#include "uchar4.h"
-
 using namespace Engine1;
 
 Settings Settings::s_settings;
@@ -52,7 +50,10 @@ void Settings::initializeInternal()
     main.zBufferDepth     = 32;
 
     paths.assets                    = "Assets";
+    paths.assetsArchive             = "Assets.pack";
+    paths.derivedDataCache          = "DerivedDataCache";
     paths.testAssets                = "TestAssets";
+    paths.assetLoadStats            = "AssetLoadStats";
     paths.renderingTests.testCases  = "RenderingTests//TestCases";
     paths.renderingTests.references = "RenderingTests//References";
     paths.renderingTests.results    = "RenderingTests//Results";
@@ -65,6 +66,9 @@ void Settings::initializeInternal()
     debug.renderLightSources        = true;
     debug.slowmotionMode            = false;
     debug.snappingMode              = false;
+    debug.hotReloadAssets           = true;
+    debug.useDerivedDataCache       = true;
+    debug.recordAssetLoadStats      = false;
 
     debug.replaceSelected = true;
 
@@ -243,47 +247,6 @@ void Settings::initializeInternal()
     profiling.display.startWithStage     = RenderingStage::Main;
 }
 
-void Settings::initialize(ID3D11Device3& device)
-{
-    { // Create default textures.
-        std::vector< unsigned char > dataAlpha = { 255 };
-        std::vector< unsigned char > dataMetalness = { 255 };
-        std::vector< unsigned char > dataRoughness = { 255 };
-        std::vector< unsigned char > dataIndexOfRefraction = { 255 };
-        std::vector< uchar4 >        dataEmissive = { uchar4( 255, 255, 255, 255 ) };
-        std::vector< uchar4 >        dataAlbedo = { uchar4( 255, 255, 255, 255 ) };
-        std::vector< uchar4 >        dataNormal = { uchar4( 128, 128, 255, 255 ) };
-
-        textures.defaults.alpha = 
-            std::make_shared< ImmutableTexture2D< unsigned char > >
-            ( device, dataAlpha, 1, 1, false, true, false, DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
-
-        textures.defaults.metalness = 
-            std::make_shared< ImmutableTexture2D< unsigned char > >
-            ( device, dataMetalness, 1, 1, false, true, false, DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
-
-        textures.defaults.roughness = 
-            std::make_shared< ImmutableTexture2D< unsigned char > >
-            ( device, dataRoughness, 1, 1, false, true, false, DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
-
-        textures.defaults.refractiveIndex = 
-            std::make_shared< ImmutableTexture2D< unsigned char > >
-            ( device, dataIndexOfRefraction, 1, 1, false, true, false, DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
-
-        textures.defaults.emissive = 
-            std::make_shared< ImmutableTexture2D< uchar4 > >
-            ( device, dataEmissive, 1, 1, false, true, false, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM );
-
-        textures.defaults.albedo = 
-            std::make_shared< ImmutableTexture2D< uchar4 > >
-            ( device, dataAlbedo, 1, 1, false, true, false, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM );
-
-        textures.defaults.normal = 
-            std::make_shared< ImmutableTexture2D< uchar4 > >
-            ( device, dataNormal, 1, 1, false, true, false, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM );
-    }
-}
-
 void Settings::onChanged()
 {
     // Active-level should not exceed max-level.
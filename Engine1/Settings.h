@@ -47,7 +47,10 @@ namespace Engine1
         struct Paths
         {
             std::string assets;
+            std::string assetsArchive;
+            std::string derivedDataCache;
             std::string testAssets;
+            std::string assetLoadStats; // Prefix of the exported asset loading stats files.
             struct RenderingTests
             {
                 std::string references;
@@ -68,6 +71,15 @@ namespace Engine1
             bool slowmotionMode;
             bool snappingMode;
 
+            // Reload assets when their files change on disk.
+            bool hotReloadAssets;
+
+            // Store imported meshes in the derived data cache (in paths.derivedDataCache).
+            bool useDerivedDataCache;
+
+            // Record timings of asset loading (see AssetLoadStats). Can be exported from the control panel.
+            bool recordAssetLoadStats;
+
             // Option used to avoid replacing textures/meshes
             // on selected models when you drag&drop an asset.
             // The drag&dropped texture will be applied only to models 
@@ -0,0 +1,46 @@
+#include "Settings.h"
+
+#include "uchar4.h"
+
+using namespace Engine1;
+
+void Settings::initialize(ID3D11Device3& device)
+{
+    { // Create default textures.
+        std::vector< unsigned char > dataAlpha = { 255 };
+        std::vector< unsigned char > dataMetalness = { 255 };
+        std::vector< unsigned char > dataRoughness = { 255 };
+        std::vector< unsigned char > dataIndexOfRefraction = { 255 };
+        std::vector< uchar4 >        dataEmissive = { uchar4( 255, 255, 255, 255 ) };
+        std::vector< uchar4 >        dataAlbedo = { uchar4( 255, 255, 255, 255 ) };
+        std::vector< uchar4 >        dataNormal = { uchar4( 128, 128, 255, 255 ) };
+
+        textures.defaults.alpha = 
+            std::make_shared< ImmutableTexture2D< unsigned char > >
+            ( device, dataAlpha, 1, 1, false, true, false, DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
+
+        textures.defaults.metalness = 
+            std::make_shared< ImmutableTexture2D< unsigned char > >
+            ( device, dataMetalness, 1, 1, false, true, false, DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
+
+        textures.defaults.roughness = 
+            std::make_shared< ImmutableTexture2D< unsigned char > >
+            ( device, dataRoughness, 1, 1, false, true, false, DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
+
+        textures.defaults.refractiveIndex = 
+            std::make_shared< ImmutableTexture2D< unsigned char > >
+            ( device, dataIndexOfRefraction, 1, 1, false, true, false, DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UNORM );
+
+        textures.defaults.emissive = 
+            std::make_shared< ImmutableTexture2D< uchar4 > >
+            ( device, dataEmissive, 1, 1, false, true, false, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM );
+
+        textures.defaults.albedo = 
+            std::make_shared< ImmutableTexture2D< uchar4 > >
+            ( device, dataAlbedo, 1, 1, false, true, false, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM );
+
+        textures.defaults.normal = 
+            std::make_shared< ImmutableTexture2D< uchar4 > >
+            ( device, dataNormal, 1, 1, false, true, false, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM );
+    }
+}
@@ -48,9 +48,9 @@ uint3 readTriangle( const uint index, ByteAddressBuffer meshTriangles )
     return meshTriangles.Load3( address );
 }
 
-float3x3 readVerticesPos( const uint3 vertices_index, ByteAddressBuffer meshVertices ) 
+float3x3 readVerticesPos( const uint3 vertices_index, ByteAddressBuffer meshVertices, const uint stride, const uint offset ) 
 {
-    const uint3 address = vertices_index * 12; // 12 = 3 components * 4 bytes.
+    const uint3 address = vertices_index * stride + offset; // Stride is 12 bytes (3 components * 4 bytes) and offset is 0 unless the buffer is interleaved.
 
     const uint3 vertexData1 = meshVertices.Load3( address.x );
     const uint3 vertexData2 = meshVertices.Load3( address.y );
@@ -72,9 +72,9 @@ float3x3 readVerticesPos( const uint3 vertices_index, ByteAddressBuffer meshVert
     );
 }
 
-float3x3 readVerticesNormals( const uint3 vertices_index, ByteAddressBuffer meshNormals ) 
+float3x3 readVerticesNormals( const uint3 vertices_index, ByteAddressBuffer meshNormals, const uint stride, const uint offset ) 
 {
-    const uint3 address = vertices_index * 12; // 12 = 3 components * 4 bytes.
+    const uint3 address = vertices_index * stride + offset; // Stride is 12 bytes (3 components * 4 bytes) and offset is 0 unless the buffer is interleaved.
 
     const uint3 normalData1 = meshNormals.Load3( address.x );
     const uint3 normalData2 = meshNormals.Load3( address.y );
@@ -96,9 +96,9 @@ float3x3 readVerticesNormals( const uint3 vertices_index, ByteAddressBuffer mesh
     );
 }
 
-float3x3 readVerticesTangents(const uint3 vertices_index, ByteAddressBuffer meshTangents )
+float3x3 readVerticesTangents(const uint3 vertices_index, ByteAddressBuffer meshTangents, const uint stride, const uint offset )
 {
-    const uint3 address = vertices_index * 12; // 12 = 3 components * 4 bytes.
+    const uint3 address = vertices_index * stride + offset; // Stride is 12 bytes (3 components * 4 bytes) and offset is 0 unless the buffer is interleaved.
 
     const uint3 tangentData1 = meshTangents.Load3( address.x );
     const uint3 tangentData2 = meshTangents.Load3( address.y );
@@ -120,9 +120,9 @@ float3x3 readVerticesTangents(const uint3 vertices_index, ByteAddressBuffer mesh
     );
 }
 
-float2x3 readVerticesTexCoords( const uint3 vertices_index, ByteAddressBuffer meshTexcoords )
+float2x3 readVerticesTexCoords( const uint3 vertices_index, ByteAddressBuffer meshTexcoords, const uint stride, const uint offset )
 {
-    const uint3 address = vertices_index * 8; // 8 = 2 components * 4 bytes.
+    const uint3 address = vertices_index * stride + offset; // Stride is 8 bytes (2 components * 4 bytes) and offset is 0 unless the buffer is interleaved.
 
     const uint2 texcoordsData1 = meshTexcoords.Load2( address.x );
     const uint2 texcoordsData2 = meshTexcoords.Load2( address.y );
@@ -26,6 +26,8 @@ cbuffer ConstantBuffer : register( b0 )
     float3   pad9;
     float    indexOfRefractionMul;
     float3   pad10;
+    uint4    vertexStrides; // Strides (in bytes) of mesh vertices, normals, tangents and texcoords in their buffers.
+    uint4    vertexOffsets; // Offsets (in bytes) of mesh vertices, normals, tangents and texcoords in their buffers.
 };
 
 // Input.
@@ -129,7 +131,7 @@ void main( uint3 groupId : SV_GroupID,
 			    for ( uint triangleIdx = firstTriangleIndex; triangleIdx < lastTriangleIndex; ++triangleIdx ) 
                 {
 				    const uint3    trianglee   = readTriangle( triangleIdx, g_meshTriangles );
-                    const float3x3 verticesPos = readVerticesPos( trianglee, g_meshVertices );
+                    const float3x3 verticesPos = readVerticesPos( trianglee, g_meshVertices, vertexStrides.x, vertexOffsets.x );
 
                     if ( rayTriangleIntersect( rayOriginLocal.xyz, rayDirLocal.xyz, verticesPos ) )
                     {
@@ -154,15 +156,15 @@ void main( uint3 groupId : SV_GroupID,
             {
                  // Read triangle data.
                 const uint3    trianglee   = readTriangle( hitTriangle, g_meshTriangles );
-                const float3x3 verticesPos = readVerticesPos( trianglee, g_meshVertices );
+                const float3x3 verticesPos = readVerticesPos( trianglee, g_meshVertices, vertexStrides.x, vertexOffsets.x );
 
                 const float3 hitPos = rayOriginLocal.xyz + rayDirLocal.xyz * hitDist;
                 const float3 hitBarycentricCoords = calcBarycentricCoordsInTriangle( hitPos, verticesPos );
 
-                const float3x3 verticesNormals = readVerticesNormals( trianglee, g_meshNormals );
+                const float3x3 verticesNormals = readVerticesNormals( trianglee, g_meshNormals, vertexStrides.y, vertexOffsets.y );
                 float3         hitNormal       = calcInterpolatedVector( hitBarycentricCoords, verticesNormals );
 
-                const float3x3 verticesTangents = readVerticesTangents( trianglee, g_meshTangents );
+                const float3x3 verticesTangents = readVerticesTangents( trianglee, g_meshTangents, vertexStrides.z, vertexOffsets.z );
                 float3         hitTangent       = calcInterpolatedVector( hitBarycentricCoords, verticesTangents );
 
                 // Transform normal and tangent from local to world space.
@@ -171,7 +173,7 @@ void main( uint3 groupId : SV_GroupID,
 
                 const float3 hitBitangent = cross( hitTangent, hitNormal );
 
-                const float2x3 verticesTexCoords = readVerticesTexCoords( trianglee, g_meshTexcoords );
+                const float2x3 verticesTexCoords = readVerticesTexCoords( trianglee, g_meshTexcoords, vertexStrides.w, vertexOffsets.w );
                 const float2   hitTexCoords      = calcInterpolatedTexCoords( hitBarycentricCoords, verticesTexCoords );
 
                 float3x3 tangentToWorldMatrix = float3x3(
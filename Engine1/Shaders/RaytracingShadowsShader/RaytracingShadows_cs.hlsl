@@ -50,6 +50,8 @@ cbuffer ConstantBuffer : register( b0 )
     float3   pad18;
     float    enableAlteringRayDirection; // If enabled, rays at different pixels aim at different parts of area light. 1 - enabled, 0 - disabled.
     float3   pad19;
+    uint4    vertexStrides; // Strides (in bytes) of mesh vertices, normals, tangents and texcoords in their buffers (2nd and 3rd components are unused).
+    uint4    vertexOffsets; // Offsets (in bytes) of mesh vertices, normals, tangents and texcoords in their buffers (2nd and 3rd components are unused).
 };
 
 // Input.
@@ -367,7 +369,7 @@ bool rayMeshIntersect( const float3 rayOrigin, const float3 rayDir, const float
 				for ( uint triangleIdx = firstTriangleIndex; triangleIdx < lastTriangleIndex; ++triangleIdx ) 
 				{
 					const uint3    trianglee   = readTriangle( triangleIdx, g_meshTriangles );
-					const float3x3 verticesPos = readVerticesPos( trianglee, g_meshVertices );
+					const float3x3 verticesPos = readVerticesPos( trianglee, g_meshVertices, vertexStrides.x, vertexOffsets.x );
 
 					if ( rayTriangleIntersect( rayOriginLocal.xyz, rayDirLocal.xyz, verticesPos ) )
 					{
@@ -384,7 +386,7 @@ bool rayMeshIntersect( const float3 rayOrigin, const float3 rayDir, const float
                                 const float3 hitPos               = rayOriginLocal.xyz + rayDirLocal.xyz * dist;
                                 const float3 hitBarycentricCoords = calcBarycentricCoordsInTriangle( hitPos, verticesPos );
 
-							    const float2x3 verticesTexCoords = readVerticesTexCoords( trianglee, g_meshTexcoords );
+							    const float2x3 verticesTexCoords = readVerticesTexCoords( trianglee, g_meshTexcoords, vertexStrides.w, vertexOffsets.w );
 							    const float2   hitTexCoords      = calcInterpolatedTexCoords( hitBarycentricCoords, verticesTexCoords );
 
                                 const float alpha = g_alphaTexture.SampleLevel( g_linearSamplerState, hitTexCoords, 0.0f ).r * alphaMul.r;
@@ -5,6 +5,7 @@
 #include <algorithm>
 
 #include "StringUtil.h"
+#include "ParallelUtil.h"
 
 #include "MyXAFFileParser.h"
 
@@ -41,8 +42,14 @@ std::shared_ptr<SkeletonAnimation> SkeletonAnimation::calculateAnimationInSkelet
 {
 	std::shared_ptr<SkeletonAnimation> animationInSkeletonSpace = std::make_shared<SkeletonAnimation>( );
 
-	for ( const SkeletonPose& poseInParentSpace : animationInParentSpace.m_skeletonPoses )
-		animationInSkeletonSpace->m_skeletonPoses.push_back( SkeletonPose::calculatePoseInSkeletonSpace( poseInParentSpace, skeletonMesh ) );
+    // Keyframes are independent - they are converted in parallel.
+    const std::vector< SkeletonPose >& posesInParentSpace   = animationInParentSpace.m_skeletonPoses;
+    std::vector< SkeletonPose >&       posesInSkeletonSpace = animationInSkeletonSpace->m_skeletonPoses;
+
+    posesInSkeletonSpace.resize( posesInParentSpace.size() );
+    ParallelUtil::parallelFor( (int)posesInParentSpace.size(), [ & ]( const int poseIndex ) {
+        posesInSkeletonSpace[ poseIndex ] = SkeletonPose::calculatePoseInSkeletonSpace( posesInParentSpace[ poseIndex ], skeletonMesh );
+    } );
 
 	return animationInSkeletonSpace;
 }
@@ -51,8 +58,13 @@ std::shared_ptr<SkeletonAnimation> SkeletonAnimation::calculateAnimationInParent
 {
 	std::shared_ptr<SkeletonAnimation> animationInParentSpace = std::make_shared<SkeletonAnimation>( );
 
-	for ( const SkeletonPose& poseInSkeletonSpace : animationInSkeletonSpace.m_skeletonPoses )  
-		animationInParentSpace->m_skeletonPoses.push_back( SkeletonPose::calculatePoseInParentSpace( poseInSkeletonSpace, skeletonMesh ) );
+    const std::vector< SkeletonPose >& posesInSkeletonSpace = animationInSkeletonSpace.m_skeletonPoses;
+    std::vector< SkeletonPose >&       posesInParentSpace   = animationInParentSpace->m_skeletonPoses;
+
+    posesInParentSpace.resize( posesInSkeletonSpace.size() );
+    ParallelUtil::parallelFor( (int)posesInSkeletonSpace.size(), [ & ]( const int poseIndex ) {
+        posesInParentSpace[ poseIndex ] = SkeletonPose::calculatePoseInParentSpace( posesInSkeletonSpace[ poseIndex ], skeletonMesh );
+    } );
 
 	return animationInParentSpace;
 }
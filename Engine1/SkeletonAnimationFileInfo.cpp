@@ -40,6 +40,7 @@ void SkeletonAnimationFileInfo::saveToMemory( std::vector<char>& data ) const
 void SkeletonAnimationFileInfo::setPath( std::string path )
 {
 	this->m_path = path;
+	invalidateAssetId();
 }
 
 void SkeletonAnimationFileInfo::setFormat( Format format )
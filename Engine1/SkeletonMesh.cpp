@@ -6,10 +6,11 @@
 #include "MeshFileParser.h"
 
 #include "StringUtil.h"
-#include "DX11Util.h"
 #include "MathUtil.h"
 
 #include "TextFile.h"
+#include "BinaryFile.h"
+#include "BinaryFileWriter.h"
 
 #include <d3d11_3.h>
 
@@ -24,7 +25,11 @@ std::shared_ptr<SkeletonMesh> SkeletonMesh::createFromFile( const SkeletonMeshFi
 
 std::shared_ptr<SkeletonMesh> SkeletonMesh::createFromFile( const std::string& path, const SkeletonMeshFileInfo::Format format, const int indexInFile, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
 {
-	std::shared_ptr< std::vector<char> > fileData = TextFile::load( path );
+	std::shared_ptr< std::vector<char> > fileData;
+    if ( SkeletonMeshFileInfo::getFileTypeFromFormat( format ) == SkeletonMeshFileInfo::FileType::Binary )
+        fileData = BinaryFile::load( path );
+    else
+        fileData = TextFile::load( path );
 
     std::shared_ptr<SkeletonMesh> mesh = createFromMemory( fileData->cbegin(), fileData->cend(), format, indexInFile, invertZCoordinate, invertVertexWindingOrder, flipUVs );
 
@@ -40,7 +45,11 @@ std::shared_ptr<SkeletonMesh> SkeletonMesh::createFromFile( const std::string& p
 
 std::vector< std::shared_ptr<SkeletonMesh> > SkeletonMesh::createFromFile( const std::string& path, const SkeletonMeshFileInfo::Format format, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
 {
-	std::shared_ptr< std::vector<char> > fileData = TextFile::load( path );
+	std::shared_ptr< std::vector<char> > fileData;
+    if ( SkeletonMeshFileInfo::getFileTypeFromFormat( format ) == SkeletonMeshFileInfo::FileType::Binary )
+        fileData = BinaryFile::load( path );
+    else
+        fileData = TextFile::load( path );
 
 	std::vector< std::shared_ptr<SkeletonMesh> > meshes = createFromMemory( fileData->cbegin(), fileData->cend(), format, invertZCoordinate, invertVertexWindingOrder, flipUVs );
 
@@ -72,8 +81,8 @@ std::shared_ptr<SkeletonMesh> SkeletonMesh::createFromMemory( std::vector<char>:
 
 std::vector< std::shared_ptr<SkeletonMesh> > SkeletonMesh::createFromMemory( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt, const SkeletonMeshFileInfo::Format format, const bool invertZCoordinate, const bool invertVertexWindingOrder, const bool flipUVs )
 {
-	if ( SkeletonMeshFileInfo::Format::DAE == format ) {
-		return MeshFileParser::parseSkeletonMeshFile( dataIt, dataEndIt, invertZCoordinate, invertVertexWindingOrder, flipUVs );
+	if ( SkeletonMeshFileInfo::Format::DAE == format || SkeletonMeshFileInfo::Format::SKELETONMESH == format ) {
+		return MeshFileParser::parseSkeletonMeshFile( format, dataIt, dataEndIt, invertZCoordinate, invertVertexWindingOrder, flipUVs );
 	}
 
 	throw std::exception( "SkeletonMesh::createFromMemory() - incorrect 'format' argument." );
@@ -83,9 +92,42 @@ SkeletonMesh::SkeletonMesh() :
 bonesPerVertexCount( BonesPerVertexCount::Type::ZERO )
 {}
 
+SkeletonMesh::SkeletonMesh( const int vertexCount, const bool hasNormalsTangents, const int texcoordsSetCount, const int triangleCount, const BonesPerVertexCount::Type bonesPerVertexCount ) :
+bonesPerVertexCount( bonesPerVertexCount )
+{
+    m_vertices.resize( vertexCount );
+
+    if ( hasNormalsTangents ) {
+        m_normals.resize( vertexCount );
+        m_tangents.resize( vertexCount );
+    }
+
+    m_texcoords.resize( texcoordsSetCount );
+    for ( auto& texcoords : m_texcoords ) {
+        texcoords.resize( vertexCount );
+    }
+
+    m_triangles.resize( triangleCount );
+
+    // No bones assigned - see attachVertexToBone.
+    m_vertexBones.resize( vertexCount * static_cast<int>( bonesPerVertexCount ), 0 );
+    m_vertexWeights.resize( vertexCount * static_cast<int>( bonesPerVertexCount ), 0.0f );
+}
+
 SkeletonMesh::~SkeletonMesh() 
 {}
 
+void SkeletonMesh::saveToFile( const std::string& path, const SkeletonMeshFileInfo::Format format )
+{
+    if ( format != SkeletonMeshFileInfo::Format::SKELETONMESH )
+        throw std::exception( "SkeletonMesh::saveToFile - only own format is supported." );
+
+    // Streamed directly to the file - without creating a copy of the whole mesh in memory.
+    BinaryFileWriter writer( path );
+    MeshFileParser::writeSkeletonMeshFile( writer, *this );
+    writer.close();
+}
+
 Asset::Type SkeletonMesh::getType() const
 {
 	return Asset::Type::SkeletonMesh;
@@ -121,191 +163,6 @@ SkeletonMeshFileInfo& SkeletonMesh::getFileInfo( )
 	return m_fileInfo;
 }
 
-void SkeletonMesh::loadCpuToGpu( ID3D11Device3& device, bool reload )
-{
-	if ( !isInCpuMemory() ) throw std::exception( "SkeletonMesh::loadCpuToGpu - Mesh not loaded in CPU memory." );
-
-    if ( reload )
-        throw std::exception( "SkeletonMesh::loadCpuToGpu - reload not yet implemented." );
-
-	if ( m_vertices.size() > 0 && !m_vertexBuffer ) {
-		D3D11_BUFFER_DESC vertexBufferDesc;
-		vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-		vertexBufferDesc.ByteWidth = sizeof(float3) * (unsigned int)m_vertices.size();
-		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		vertexBufferDesc.CPUAccessFlags = 0;
-		vertexBufferDesc.MiscFlags = 0;
-		vertexBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA vertexDataPtr;
-		vertexDataPtr.pSysMem = m_vertices.data();
-		vertexDataPtr.SysMemPitch = 0;
-		vertexDataPtr.SysMemSlicePitch = 0;
-
-		HRESULT result = device.CreateBuffer( &vertexBufferDesc, &vertexDataPtr, m_vertexBuffer.ReleaseAndGetAddressOf() );
-		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh vertices failed" );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "SkeletonMesh::vertexBuffer" );
-		DX11Util::setResourceName( *m_vertexBuffer.Get(), resourceName );
-#endif
-	}
-
-	if ( m_vertexBones.size() > 0 && !m_vertexBonesBuffer ) {
-		D3D11_BUFFER_DESC vertexBonesBufferDesc;
-		vertexBonesBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-		vertexBonesBufferDesc.ByteWidth = sizeof(unsigned char) * (unsigned int)m_vertexBones.size();
-		vertexBonesBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		vertexBonesBufferDesc.CPUAccessFlags = 0;
-		vertexBonesBufferDesc.MiscFlags = 0;
-		vertexBonesBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA vertexBonesDataPtr;
-		vertexBonesDataPtr.pSysMem = m_vertexBones.data();
-		vertexBonesDataPtr.SysMemPitch = 0;
-		vertexBonesDataPtr.SysMemSlicePitch = 0;
-
-		HRESULT result = device.CreateBuffer( &vertexBonesBufferDesc, &vertexBonesDataPtr, m_vertexBonesBuffer.ReleaseAndGetAddressOf() );
-		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh vertex-bones failed" );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "SkeletonMesh::vertexBonesBuffer" );
-		DX11Util::setResourceName( *m_vertexBonesBuffer.Get(), resourceName );
-#endif
-	}
-
-	if ( m_vertexWeights.size() > 0 && !m_vertexWeightsBuffer ) {
-		D3D11_BUFFER_DESC vertexWeightsBufferDesc;
-		vertexWeightsBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-		vertexWeightsBufferDesc.ByteWidth = sizeof(float) * (unsigned int)m_vertexWeights.size();
-		vertexWeightsBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		vertexWeightsBufferDesc.CPUAccessFlags = 0;
-		vertexWeightsBufferDesc.MiscFlags = 0;
-		vertexWeightsBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA vertexWeightsDataPtr;
-		vertexWeightsDataPtr.pSysMem = m_vertexWeights.data();
-		vertexWeightsDataPtr.SysMemPitch = 0;
-		vertexWeightsDataPtr.SysMemSlicePitch = 0;
-
-		HRESULT result = device.CreateBuffer( &vertexWeightsBufferDesc, &vertexWeightsDataPtr, m_vertexWeightsBuffer.ReleaseAndGetAddressOf() );
-		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh vertex-weights failed" );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "SkeletonMesh::vertexWeightsBuffer" );
-		DX11Util::setResourceName( *m_vertexWeightsBuffer.Get(), resourceName );
-#endif
-	}
-
-	if ( m_normals.size() > 0 && !m_normalBuffer ) {
-		D3D11_BUFFER_DESC normalBufferDesc;
-		normalBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-		normalBufferDesc.ByteWidth = sizeof(float3) * (unsigned int)m_normals.size();
-		normalBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		normalBufferDesc.CPUAccessFlags = 0;
-		normalBufferDesc.MiscFlags = 0;
-		normalBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA normalDataPtr;
-		normalDataPtr.pSysMem = m_normals.data();
-		normalDataPtr.SysMemPitch = 0;
-		normalDataPtr.SysMemSlicePitch = 0;
-
-		HRESULT result = device.CreateBuffer( &normalBufferDesc, &normalDataPtr, m_normalBuffer.ReleaseAndGetAddressOf() );
-		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh normals failed" );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "SkeletonMesh::normalBuffer" );
-		DX11Util::setResourceName( *m_normalBuffer.Get(), resourceName );
-#endif
-	}
-
-    if ( m_tangents.size() > 0 && !m_tangentBuffer ) {
-		D3D11_BUFFER_DESC tangentBufferDesc;
-		tangentBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-		tangentBufferDesc.ByteWidth = sizeof(float3) * (unsigned int)m_tangents.size();
-		tangentBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		tangentBufferDesc.CPUAccessFlags = 0;
-		tangentBufferDesc.MiscFlags = 0;
-		tangentBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA tangentDataPtr;
-		tangentDataPtr.pSysMem = m_tangents.data();
-		tangentDataPtr.SysMemPitch = 0;
-		tangentDataPtr.SysMemSlicePitch = 0;
-
-		HRESULT result = device.CreateBuffer( &tangentBufferDesc, &tangentDataPtr, m_tangentBuffer.ReleaseAndGetAddressOf() );
-		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh tangents failed" );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "SkeletonMesh::tangentBuffer" );
-		DX11Util::setResourceName( *m_tangentBuffer.Get(), resourceName );
-#endif
-	}
-
-	std::list< std::vector<float2> >::iterator texcoordsIt, texcoordsEnd = m_texcoords.end();
-    int texcoordsIndex = -1;
-
-	for ( texcoordsIt = m_texcoords.begin(); texcoordsIt != texcoordsEnd; ++texcoordsIt ) {
-        ++texcoordsIndex;
-
-        if ( texcoordsIndex < (int)m_texcoordBuffers.size() )
-            continue; // Skip texcoords which are already loaded.
-
-		if ( texcoordsIt->empty() ) throw std::exception( "SkeletonMesh::loadToGpu - One of mesh's texcoord sets is empty" );
-
-		D3D11_BUFFER_DESC texcoordBufferDesc;
-		texcoordBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-		texcoordBufferDesc.ByteWidth = sizeof(float2) * (unsigned int)texcoordsIt->size();
-		texcoordBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		texcoordBufferDesc.CPUAccessFlags = 0;
-		texcoordBufferDesc.MiscFlags = 0;
-		texcoordBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA texcoordDataPtr;
-		texcoordDataPtr.pSysMem = texcoordsIt->data();
-		texcoordDataPtr.SysMemPitch = 0;
-		texcoordDataPtr.SysMemSlicePitch = 0;
-
-		ComPtr<ID3D11Buffer> buffer;
-
-		HRESULT result = device.CreateBuffer( &texcoordBufferDesc, &texcoordDataPtr, buffer.GetAddressOf() );
-		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh texcoords failed" );
-
-		m_texcoordBuffers.push_back( buffer );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "SkeletonMesh::texcoordBuffer[" ) + std::to_string( m_texcoordBuffers.size() - 1 ) + std::string( "]" );
-		DX11Util::setResourceName( *buffer.Get(), resourceName );
-#endif
-	}
-
-    if ( m_triangles.empty() ) throw std::exception( "SkeletonMesh::loadToGpu - Mesh has no triangles" );
-
-    if ( !m_triangleBuffer ) {
-		D3D11_BUFFER_DESC triangleBufferDesc;
-		triangleBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-		triangleBufferDesc.ByteWidth = sizeof(uint3) * (unsigned int)m_triangles.size();
-		triangleBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-		triangleBufferDesc.CPUAccessFlags = 0;
-		triangleBufferDesc.MiscFlags = 0;
-		triangleBufferDesc.StructureByteStride = 0;
-
-		D3D11_SUBRESOURCE_DATA triangleDataPtr;
-		triangleDataPtr.pSysMem = m_triangles.data();
-		triangleDataPtr.SysMemPitch = 0;
-		triangleDataPtr.SysMemSlicePitch = 0;
-
-		HRESULT result = device.CreateBuffer( &triangleBufferDesc, &triangleDataPtr, m_triangleBuffer.ReleaseAndGetAddressOf() );
-		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh triangles failed" );
-
-#if defined(_DEBUG) 
-		std::string resourceName = std::string( "SkeletonMesh::triangleBuffer" );
-		DX11Util::setResourceName( *m_triangleBuffer.Get(), resourceName );
-#endif
-	}
-}
-
 void SkeletonMesh::loadGpuToCpu()
 {
 	throw std::exception( "SkeletonMesh::loadGpuToCpu - unimplemented method." );
@@ -406,13 +263,13 @@ std::vector<float3>& SkeletonMesh::getNormals()
 const std::vector<float3>& SkeletonMesh::getTangents() const
 {
 	if ( !isInCpuMemory() ) throw std::exception( "SkeletonMesh::getTangents - Mesh not loaded in CPU memory." );
-	return m_normals;
+	return m_tangents;
 }
 
 std::vector<float3>& SkeletonMesh::getTangents()
 {
 	if ( !isInCpuMemory() ) throw std::exception( "SkeletonMesh::getTangents - Mesh not loaded in CPU memory." );
-	return m_normals;
+	return m_tangents;
 }
 
 int SkeletonMesh::getTexcoordsCount() const
@@ -660,6 +517,8 @@ void SkeletonMesh::addOrModifyBone( const unsigned char boneIndex, const std::st
 
 	// Assign the bone.
 	m_bones.at( boneIndex - 1 ) = Bone( name, parentBoneIndex, bindPose );
+
+	updateBoneHierarchy();
 }
 
 void SkeletonMesh::addOrModifyBone( const unsigned char boneIndex, const std::string& name, const unsigned char parentBoneIndex, const float43& bindPose, const float43& bindPoseInv )
@@ -683,6 +542,8 @@ void SkeletonMesh::addOrModifyBone( const unsigned char boneIndex, const std::st
 
 	// Assign the bone.
 	m_bones.at( boneIndex - 1 ) = Bone( name, parentBoneIndex, bindPose, bindPoseInv );
+
+	updateBoneHierarchy();
 }
 
 unsigned char SkeletonMesh::getBoneIndex( const std::string& name ) const
@@ -717,6 +578,58 @@ const SkeletonMesh::Bone& SkeletonMesh::getBone( unsigned char index ) const
 	return m_bones.at( index - 1 );
 }
 
+const std::vector< unsigned char >& SkeletonMesh::getBoneOrder() const
+{
+    return m_boneOrder;
+}
+
+const std::vector< unsigned char >& SkeletonMesh::getParentBoneIndices() const
+{
+    return m_parentBoneIndices;
+}
+
+bool SkeletonMesh::hasValidBoneHierarchy() const
+{
+    return m_boneOrder.size() == m_bones.size();
+}
+
+void SkeletonMesh::updateBoneHierarchy()
+{
+    const size_t boneCount = m_bones.size();
+
+    m_parentBoneIndices.assign( boneCount + 1, 0 );
+    for ( size_t boneIndex = 1; boneIndex <= boneCount; ++boneIndex )
+        m_parentBoneIndices[ boneIndex ] = m_bones[ boneIndex - 1 ].getParentBoneIndex();
+
+    // Breadth-first traversal from the root bones. Children are found through a list sorted by parent index (counting sort).
+    std::vector< size_t >        childrenOffsets( boneCount + 2, 0 );
+    std::vector< unsigned char > children( boneCount );
+
+    for ( size_t boneIndex = 1; boneIndex <= boneCount; ++boneIndex )
+    {
+        if ( m_parentBoneIndices[ boneIndex ] <= boneCount )
+            ++childrenOffsets[ m_parentBoneIndices[ boneIndex ] + 1 ];
+    }
+
+    for ( size_t boneIndex = 1; boneIndex < childrenOffsets.size(); ++boneIndex )
+        childrenOffsets[ boneIndex ] += childrenOffsets[ boneIndex - 1 ];
+
+    std::vector< size_t >        childrenEnds( childrenOffsets.begin(), childrenOffsets.end() - 1 );
+    for ( size_t boneIndex = 1; boneIndex <= boneCount; ++boneIndex )
+    {
+        if ( m_parentBoneIndices[ boneIndex ] <= boneCount )
+            children[ childrenEnds[ m_parentBoneIndices[ boneIndex ] ]++ ] = (unsigned char)boneIndex;
+    }
+
+    // Bones with a missing parent or in a cycle are never reached.
+    m_boneOrder.assign( children.begin() + childrenOffsets[ 0 ], children.begin() + childrenOffsets[ 1 ] ); // Root bones.
+    for ( size_t orderIndex = 0; orderIndex < m_boneOrder.size(); ++orderIndex )
+    {
+        const unsigned char boneIndex = m_boneOrder[ orderIndex ];
+        m_boneOrder.insert( m_boneOrder.end(), children.begin() + childrenOffsets[ boneIndex ], children.begin() + childrenOffsets[ boneIndex + 1 ] );
+    }
+}
+
 void SkeletonMesh::recalculateBoundingBox()
 {
     m_boundingBox = MathUtil::calculateBoundingBox( m_vertices );
@@ -34,8 +34,11 @@ namespace Engine1
         static std::vector< std::shared_ptr<SkeletonMesh> > createFromMemory( std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt, const SkeletonMeshFileInfo::Format format, const bool invertZCoordinate = false, const bool invertVertexWindingOrder = false, const bool flipUVs = false );
 
         SkeletonMesh();
+        SkeletonMesh( const int vertexCount, const bool hasNormalsTangents, const int texcoordsSetCount, const int triangleCount, const BonesPerVertexCount::Type bonesPerVertexCount );
         ~SkeletonMesh();
 
+        void saveToFile( const std::string& path, const SkeletonMeshFileInfo::Format format );
+
         Asset::Type                                 getType() const;
         std::vector< std::shared_ptr<const Asset> > getSubAssets() const;
         std::vector< std::shared_ptr<Asset> >       getSubAssets();
@@ -123,6 +126,13 @@ namespace Engine1
         const Bone& getBone( const std::string& name ) const;
         const Bone& getBone( unsigned char index ) const;
 
+        // Bone indices ordered so that each bone comes after its parent - allows to process the hierarchy in a single pass.
+        // Contains fewer bones than the mesh if some parents are missing or bones form a cycle (see hasValidBoneHierarchy).
+        const std::vector< unsigned char >& getBoneOrder() const;
+        // Parent bone index for each bone index (index 0 is unused). Zero means that the bone is a root.
+        const std::vector< unsigned char >& getParentBoneIndices() const;
+        bool                                hasValidBoneHierarchy() const;
+
         void recalculateBoundingBox();
         // Returns <min, max> of the bounding box.
         BoundingBox getBoundingBox() const;
@@ -152,6 +162,12 @@ namespace Engine1
 
         std::vector< Bone > m_bones;
 
+        // Has to be called whenever bones are modified.
+        void updateBoneHierarchy();
+
+        std::vector< unsigned char > m_boneOrder;
+        std::vector< unsigned char > m_parentBoneIndices;
+
         BoundingBox m_boundingBox;
 
         // Copying mesh in not allowed.
@@ -11,6 +11,14 @@ std::shared_ptr<SkeletonMeshFileInfo> SkeletonMeshFileInfo::createFromMemory( st
 	return SkeletonMeshFileInfoParser::parseBinary( dataIt );
 }
 
+SkeletonMeshFileInfo::FileType SkeletonMeshFileInfo::getFileTypeFromFormat( const SkeletonMeshFileInfo::Format format )
+{
+    if ( format == SkeletonMeshFileInfo::Format::DAE )
+        return FileInfo::FileType::Textual;
+    else
+        return FileInfo::FileType::Binary;
+}
+
 SkeletonMeshFileInfo::SkeletonMeshFileInfo( ) :
 m_path( "" ),
 m_format( Format::DAE ),
@@ -45,6 +53,7 @@ void SkeletonMeshFileInfo::saveToMemory( std::vector<char>& data ) const
 void SkeletonMeshFileInfo::setPath( std::string path )
 {
 	this->m_path = path;
+	invalidateAssetId();
 }
 
 void SkeletonMeshFileInfo::setFormat( Format format )
@@ -55,6 +64,7 @@ void SkeletonMeshFileInfo::setFormat( Format format )
 void SkeletonMeshFileInfo::setIndexInFile( int indexInFile )
 {
 	this->m_indexInFile = indexInFile;
+	invalidateAssetId();
 }
 
 void SkeletonMeshFileInfo::setInvertZCoordinate( bool invertZCoordinate )
@@ -79,7 +89,7 @@ Asset::Type SkeletonMeshFileInfo::getAssetType( ) const
 
 FileInfo::FileType SkeletonMeshFileInfo::getFileType( ) const
 {
-	return FileInfo::FileType::Textual;
+    return getFileTypeFromFormat( m_format );
 }
 
 bool SkeletonMeshFileInfo::canHaveSubAssets() const
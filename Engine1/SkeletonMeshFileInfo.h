@@ -14,11 +14,14 @@ namespace Engine1
 
         enum class Format : char
         {
-            DAE = 0
+            DAE = 0,
+            SKELETONMESH = 1
         };
 
         static std::shared_ptr<SkeletonMeshFileInfo> createFromMemory( std::vector<char>::const_iterator& dataIt );
 
+        static FileType getFileTypeFromFormat( const Format format );
+
         SkeletonMeshFileInfo();
         SkeletonMeshFileInfo( std::string path, Format format, int indexInFile = 0, bool invertZCoordinate = false, bool invertVertexWindingOrder = false, bool flipUVs = false );
         ~SkeletonMeshFileInfo();
@@ -0,0 +1,192 @@
+#include "SkeletonMesh.h"
+
+#include <d3d11_3.h>
+
+#include "DX11Util.h"
+
+using namespace Engine1;
+
+void SkeletonMesh::loadCpuToGpu( ID3D11Device3& device, bool reload )
+{
+	if ( !isInCpuMemory() ) throw std::exception( "SkeletonMesh::loadCpuToGpu - Mesh not loaded in CPU memory." );
+
+    if ( reload )
+        throw std::exception( "SkeletonMesh::loadCpuToGpu - reload not yet implemented." );
+
+	if ( m_vertices.size() > 0 && !m_vertexBuffer ) {
+		D3D11_BUFFER_DESC vertexBufferDesc;
+		vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		vertexBufferDesc.ByteWidth = sizeof(float3) * (unsigned int)m_vertices.size();
+		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		vertexBufferDesc.CPUAccessFlags = 0;
+		vertexBufferDesc.MiscFlags = 0;
+		vertexBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA vertexDataPtr;
+		vertexDataPtr.pSysMem = m_vertices.data();
+		vertexDataPtr.SysMemPitch = 0;
+		vertexDataPtr.SysMemSlicePitch = 0;
+
+		HRESULT result = device.CreateBuffer( &vertexBufferDesc, &vertexDataPtr, m_vertexBuffer.ReleaseAndGetAddressOf() );
+		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh vertices failed" );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "SkeletonMesh::vertexBuffer" );
+		DX11Util::setResourceName( *m_vertexBuffer.Get(), resourceName );
+#endif
+	}
+
+	if ( m_vertexBones.size() > 0 && !m_vertexBonesBuffer ) {
+		D3D11_BUFFER_DESC vertexBonesBufferDesc;
+		vertexBonesBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		vertexBonesBufferDesc.ByteWidth = sizeof(unsigned char) * (unsigned int)m_vertexBones.size();
+		vertexBonesBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		vertexBonesBufferDesc.CPUAccessFlags = 0;
+		vertexBonesBufferDesc.MiscFlags = 0;
+		vertexBonesBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA vertexBonesDataPtr;
+		vertexBonesDataPtr.pSysMem = m_vertexBones.data();
+		vertexBonesDataPtr.SysMemPitch = 0;
+		vertexBonesDataPtr.SysMemSlicePitch = 0;
+
+		HRESULT result = device.CreateBuffer( &vertexBonesBufferDesc, &vertexBonesDataPtr, m_vertexBonesBuffer.ReleaseAndGetAddressOf() );
+		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh vertex-bones failed" );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "SkeletonMesh::vertexBonesBuffer" );
+		DX11Util::setResourceName( *m_vertexBonesBuffer.Get(), resourceName );
+#endif
+	}
+
+	if ( m_vertexWeights.size() > 0 && !m_vertexWeightsBuffer ) {
+		D3D11_BUFFER_DESC vertexWeightsBufferDesc;
+		vertexWeightsBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		vertexWeightsBufferDesc.ByteWidth = sizeof(float) * (unsigned int)m_vertexWeights.size();
+		vertexWeightsBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		vertexWeightsBufferDesc.CPUAccessFlags = 0;
+		vertexWeightsBufferDesc.MiscFlags = 0;
+		vertexWeightsBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA vertexWeightsDataPtr;
+		vertexWeightsDataPtr.pSysMem = m_vertexWeights.data();
+		vertexWeightsDataPtr.SysMemPitch = 0;
+		vertexWeightsDataPtr.SysMemSlicePitch = 0;
+
+		HRESULT result = device.CreateBuffer( &vertexWeightsBufferDesc, &vertexWeightsDataPtr, m_vertexWeightsBuffer.ReleaseAndGetAddressOf() );
+		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh vertex-weights failed" );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "SkeletonMesh::vertexWeightsBuffer" );
+		DX11Util::setResourceName( *m_vertexWeightsBuffer.Get(), resourceName );
+#endif
+	}
+
+	if ( m_normals.size() > 0 && !m_normalBuffer ) {
+		D3D11_BUFFER_DESC normalBufferDesc;
+		normalBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		normalBufferDesc.ByteWidth = sizeof(float3) * (unsigned int)m_normals.size();
+		normalBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		normalBufferDesc.CPUAccessFlags = 0;
+		normalBufferDesc.MiscFlags = 0;
+		normalBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA normalDataPtr;
+		normalDataPtr.pSysMem = m_normals.data();
+		normalDataPtr.SysMemPitch = 0;
+		normalDataPtr.SysMemSlicePitch = 0;
+
+		HRESULT result = device.CreateBuffer( &normalBufferDesc, &normalDataPtr, m_normalBuffer.ReleaseAndGetAddressOf() );
+		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh normals failed" );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "SkeletonMesh::normalBuffer" );
+		DX11Util::setResourceName( *m_normalBuffer.Get(), resourceName );
+#endif
+	}
+
+    if ( m_tangents.size() > 0 && !m_tangentBuffer ) {
+		D3D11_BUFFER_DESC tangentBufferDesc;
+		tangentBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		tangentBufferDesc.ByteWidth = sizeof(float3) * (unsigned int)m_tangents.size();
+		tangentBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		tangentBufferDesc.CPUAccessFlags = 0;
+		tangentBufferDesc.MiscFlags = 0;
+		tangentBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA tangentDataPtr;
+		tangentDataPtr.pSysMem = m_tangents.data();
+		tangentDataPtr.SysMemPitch = 0;
+		tangentDataPtr.SysMemSlicePitch = 0;
+
+		HRESULT result = device.CreateBuffer( &tangentBufferDesc, &tangentDataPtr, m_tangentBuffer.ReleaseAndGetAddressOf() );
+		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh tangents failed" );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "SkeletonMesh::tangentBuffer" );
+		DX11Util::setResourceName( *m_tangentBuffer.Get(), resourceName );
+#endif
+	}
+
+	std::list< std::vector<float2> >::iterator texcoordsIt, texcoordsEnd = m_texcoords.end();
+    int texcoordsIndex = -1;
+
+	for ( texcoordsIt = m_texcoords.begin(); texcoordsIt != texcoordsEnd; ++texcoordsIt ) {
+        ++texcoordsIndex;
+
+        if ( texcoordsIndex < (int)m_texcoordBuffers.size() )
+            continue; // Skip texcoords which are already loaded.
+
+		if ( texcoordsIt->empty() ) throw std::exception( "SkeletonMesh::loadToGpu - One of mesh's texcoord sets is empty" );
+
+		D3D11_BUFFER_DESC texcoordBufferDesc;
+		texcoordBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		texcoordBufferDesc.ByteWidth = sizeof(float2) * (unsigned int)texcoordsIt->size();
+		texcoordBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		texcoordBufferDesc.CPUAccessFlags = 0;
+		texcoordBufferDesc.MiscFlags = 0;
+		texcoordBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA texcoordDataPtr;
+		texcoordDataPtr.pSysMem = texcoordsIt->data();
+		texcoordDataPtr.SysMemPitch = 0;
+		texcoordDataPtr.SysMemSlicePitch = 0;
+
+		ComPtr<ID3D11Buffer> buffer;
+
+		HRESULT result = device.CreateBuffer( &texcoordBufferDesc, &texcoordDataPtr, buffer.GetAddressOf() );
+		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh texcoords failed" );
+
+		m_texcoordBuffers.push_back( buffer );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "SkeletonMesh::texcoordBuffer[" ) + std::to_string( m_texcoordBuffers.size() - 1 ) + std::string( "]" );
+		DX11Util::setResourceName( *buffer.Get(), resourceName );
+#endif
+	}
+
+    if ( m_triangles.empty() ) throw std::exception( "SkeletonMesh::loadToGpu - Mesh has no triangles" );
+
+    if ( !m_triangleBuffer ) {
+		D3D11_BUFFER_DESC triangleBufferDesc;
+		triangleBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		triangleBufferDesc.ByteWidth = sizeof(uint3) * (unsigned int)m_triangles.size();
+		triangleBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+		triangleBufferDesc.CPUAccessFlags = 0;
+		triangleBufferDesc.MiscFlags = 0;
+		triangleBufferDesc.StructureByteStride = 0;
+
+		D3D11_SUBRESOURCE_DATA triangleDataPtr;
+		triangleDataPtr.pSysMem = m_triangles.data();
+		triangleDataPtr.SysMemPitch = 0;
+		triangleDataPtr.SysMemSlicePitch = 0;
+
+		HRESULT result = device.CreateBuffer( &triangleBufferDesc, &triangleDataPtr, m_triangleBuffer.ReleaseAndGetAddressOf() );
+		if ( result < 0 ) throw std::exception( "SkeletonMesh::loadToGpu - Buffer creation for mesh triangles failed" );
+
+#if defined(_DEBUG) 
+		std::string resourceName = std::string( "SkeletonMesh::triangleBuffer" );
+		DX11Util::setResourceName( *m_triangleBuffer.Get(), resourceName );
+#endif
+	}
+}
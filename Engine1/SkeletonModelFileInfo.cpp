@@ -44,6 +44,7 @@ void SkeletonModelFileInfo::saveToMemory( std::vector<char>& data ) const
 void SkeletonModelFileInfo::setPath( std::string path )
 {
 	this->m_path = path;
+	invalidateAssetId();
 }
 
 void SkeletonModelFileInfo::setFormat( Format format )
@@ -1,6 +1,7 @@
 #include "SkeletonPose.h"
 
 #include <string>
+#include <algorithm>
 
 #include "SkeletonMesh.h"
 
@@ -17,192 +18,257 @@ SkeletonPose SkeletonPose::createIdentityPoseInParentSpace( const SkeletonMesh&
 {
     SkeletonPose poseInParentSpace;
     const unsigned char boneCount = skeletonMesh.getBoneCount();
+
+    if ( boneCount == 0 )
+        return poseInParentSpace;
+
+    poseInParentSpace.reserveBones( boneCount );
     for ( unsigned char boneIndex = 1; boneIndex <= boneCount; ++boneIndex )
-        poseInParentSpace.setBonePose( boneIndex, float43::IDENTITY );
+    {
+        poseInParentSpace.m_boneOrientations[ boneIndex ] = float33::IDENTITY;
+        poseInParentSpace.m_boneTranslations[ boneIndex ] = float3::ZERO;
+        poseInParentSpace.m_boneMask.set( boneIndex );
+    }
 
     return poseInParentSpace;
 }
 
 SkeletonPose SkeletonPose::blendPoses( const SkeletonPose& pose1, const SkeletonPose& pose2, float factor )
 {
-	SkeletonPose combinedPose;
+    SkeletonPose blendedPose;
+
+    const size_t boneIndexEnd = std::max( pose1.m_boneOrientations.size(), pose2.m_boneOrientations.size() );
+    if ( boneIndexEnd == 0 )
+        return blendedPose;
+
+    blendedPose.reserveBones( (unsigned char)( boneIndexEnd - 1 ) );
+    blendedPose.m_boneMask = pose1.m_boneMask | pose2.m_boneMask;
+
+    // Same as in float43::slerp - poses are returned unchanged for factor close to 0 or 1.
+    const float translationFactor = factor <= 0.0f + MathUtil::epsilonFifty ? 0.0f : ( factor >= 1.0f - MathUtil::epsilonFifty ? 1.0f : factor );
+
+    for ( size_t boneIndex = 1; boneIndex < boneIndexEnd; ++boneIndex )
+    {
+        const bool inPose1 = pose1.m_boneMask[ boneIndex ];
+        const bool inPose2 = pose2.m_boneMask[ boneIndex ];
+
+        if ( inPose1 && inPose2 ) 
+        {
+            blendedPose.m_boneOrientations[ boneIndex ] = float33::slerp( pose1.m_boneOrientations[ boneIndex ], pose2.m_boneOrientations[ boneIndex ], factor );
+            blendedPose.m_boneTranslations[ boneIndex ] = pose1.m_boneTranslations[ boneIndex ] * ( 1.0f - translationFactor ) + pose2.m_boneTranslations[ boneIndex ] * translationFactor;
+        } 
+        else if ( inPose1 ) 
+        {
+            blendedPose.m_boneOrientations[ boneIndex ] = pose1.m_boneOrientations[ boneIndex ];
+            blendedPose.m_boneTranslations[ boneIndex ] = pose1.m_boneTranslations[ boneIndex ];
+        } 
+        else if ( inPose2 ) 
+        {
+            blendedPose.m_boneOrientations[ boneIndex ] = pose2.m_boneOrientations[ boneIndex ];
+            blendedPose.m_boneTranslations[ boneIndex ] = pose2.m_boneTranslations[ boneIndex ];
+        }
+    }
+
+    return blendedPose;
+}
 
-	// Iterate over bones from pose 1 and combine them with bones from pose 2.
-	for ( const std::pair<unsigned char, float43>& boneFromPose1 : pose1.bonesPoses ) {
-		const unsigned char boneIndex = boneFromPose1.first;
+SkeletonPose SkeletonPose::calculatePoseInSkeletonSpace( const SkeletonPose& poseInParentSpace, const SkeletonMesh& skeletonMesh ) 
+{
+    SkeletonPose poseInSkeletonSpace;
+
+    const size_t boneIndexEnd = poseInParentSpace.m_boneOrientations.size();
+    if ( boneIndexEnd == 0 )
+        return poseInSkeletonSpace;
+
+    if ( !skeletonMesh.hasValidBoneHierarchy() )
+        throw std::exception( "SkeletonPose::calculatePoseInSkeletonSpace - bones of the mesh have missing parents or form a cycle." );
+
+    const std::vector< unsigned char >& parentBoneIndices = skeletonMesh.getParentBoneIndices();
+
+    // Check if pose in parent space contains also parent bones for all the bones. Otherwise, calculating pose in skeleton space is impossible.
+    for ( size_t boneIndex = 1; boneIndex < boneIndexEnd; ++boneIndex ) 
+    {
+        if ( !poseInParentSpace.m_boneMask[ boneIndex ] )
+            continue;
+
+        if ( boneIndex >= parentBoneIndices.size() )
+            throw std::exception( ( std::string( "SkeletonPose::calculatePoseInSkeletonSpace - pose contains a bone which is not present in the mesh (bone " ) + std::to_string( boneIndex ) + std::string( ")" ) ).c_str() );
+
+        const unsigned char parentBoneIndex = parentBoneIndices[ boneIndex ];
+        if ( parentBoneIndex != 0 && !poseInParentSpace.hasBone( parentBoneIndex ) ) 
+            throw std::exception( ( std::string( "SkeletonPose::calculatePoseInSkeletonSpace - cannot calculate pose in skeleton space, because parent pose is not known for some bones (for bone" ) + std::to_string( parentBoneIndex ) + std::string( ")" ) ).c_str( ) );
+    }
+
+    poseInSkeletonSpace.reserveBones( (unsigned char)( boneIndexEnd - 1 ) );
+    poseInSkeletonSpace.m_boneMask = poseInParentSpace.m_boneMask;
+
+    // Single pass - bones are visited in the order in which parents come before their children.
+    for ( const unsigned char boneIndex : skeletonMesh.getBoneOrder() ) 
+    {
+        if ( boneIndex >= boneIndexEnd || !poseInParentSpace.m_boneMask[ boneIndex ] )
+            continue;
+
+        const float33& orientationInParentSpace = poseInParentSpace.m_boneOrientations[ boneIndex ];
+        const float3&  translationInParentSpace = poseInParentSpace.m_boneTranslations[ boneIndex ];
+
+        const unsigned char parentBoneIndex = parentBoneIndices[ boneIndex ];
+        if ( parentBoneIndex == 0 ) 
+        {
+            // Root bone's pose in skeleton space is the same as it's pose in parent space.
+            poseInSkeletonSpace.m_boneOrientations[ boneIndex ] = orientationInParentSpace;
+            poseInSkeletonSpace.m_boneTranslations[ boneIndex ] = translationInParentSpace;
+        } 
+        else 
+        {
+            const float33& parentOrientationInSkeletonSpace = poseInSkeletonSpace.m_boneOrientations[ parentBoneIndex ];
+            const float3&  parentTranslationInSkeletonSpace = poseInSkeletonSpace.m_boneTranslations[ parentBoneIndex ];
+
+            // Bone's pose in skeleton space = bone's pose in parent space * parent's pose in skeleton space.
+            poseInSkeletonSpace.m_boneOrientations[ boneIndex ] = orientationInParentSpace * parentOrientationInSkeletonSpace;
+            poseInSkeletonSpace.m_boneTranslations[ boneIndex ] = translationInParentSpace * parentOrientationInSkeletonSpace + parentTranslationInSkeletonSpace;
+        }
+    }
+
+    return poseInSkeletonSpace;
+}
 
-		if ( pose2.hasBone( boneIndex ) ) { // Bone is present in both poses.
+SkeletonPose SkeletonPose::calculatePoseInParentSpace( const SkeletonPose& poseInSkeletonSpace, const SkeletonMesh& skeletonMesh ) 
+{
+    SkeletonPose poseInParentSpace;
 
-			const float43& bonePose1 = pose1.getBonePose( boneIndex );
-			const float43& bonePose2 = pose2.getBonePose( boneIndex );
+    const size_t boneIndexEnd = poseInSkeletonSpace.m_boneOrientations.size();
+    if ( boneIndexEnd == 0 )
+        return poseInParentSpace;
 
-			// Blend poses.
-			const float43 combinedBonePose = float43::slerp( bonePose1, bonePose2, factor );
+    const std::vector< unsigned char >& parentBoneIndices = skeletonMesh.getParentBoneIndices();
 
-			// Save combined pose.
-			combinedPose.setBonePose( boneIndex, combinedBonePose );
-		}
-	}
+    poseInParentSpace.reserveBones( (unsigned char)( boneIndexEnd - 1 ) );
 
-	// Iterate over bones from pose 1 and add those which are not present in the combined pose.
-	for ( const std::pair<unsigned char, float43>& boneFromPose1 : pose1.bonesPoses ) {
-		const unsigned char boneIndex = boneFromPose1.first;
+    for ( size_t boneIndex = 1; boneIndex < boneIndexEnd; ++boneIndex ) 
+    {
+        if ( !poseInSkeletonSpace.m_boneMask[ boneIndex ] )
+            continue;
 
-		if ( !combinedPose.hasBone( boneIndex ) ) { // Bone is not present in the combined pose.
-			// Save bone from pose 1.
-			combinedPose.setBonePose( boneIndex, boneFromPose1.second );
-		}
-	}
+        if ( boneIndex >= parentBoneIndices.size() )
+            throw std::exception( ( std::string( "SkeletonPose::calculatePoseInParentSpace - pose contains a bone which is not present in the mesh (bone " ) + std::to_string( boneIndex ) + std::string( ")" ) ).c_str() );
 
-	// Iterate over bones from pose 2 and add those which are not present in the combined pose.
-	for ( const std::pair<unsigned char, float43>& boneFromPose2 : pose2.bonesPoses ) {
-		const unsigned char boneIndex = boneFromPose2.first;
+        const unsigned char parentBoneIndex = parentBoneIndices[ boneIndex ];
 
-		if ( !combinedPose.hasBone( boneIndex ) ) { // Bone is not present in the combined pose.
-			// Save bone from pose 2.
-			combinedPose.setBonePose( boneIndex, boneFromPose2.second );
-		}
-	}
+        if ( parentBoneIndex != 0 ) // If bone is not the root.
+        { 
+            // Calculate pose in parent space only for bones for which parent pose is also available.
+            if ( !poseInSkeletonSpace.hasBone( parentBoneIndex ) ) 
+                continue;
 
-	return combinedPose;
-}
+            const float44 bonePoseInSkeletonSpace( poseInSkeletonSpace.getBonePose( (unsigned char)boneIndex ) );
+            const float44 parentBonePoseInSkeletonSpace( poseInSkeletonSpace.getBonePose( parentBoneIndex ) );
 
-SkeletonPose SkeletonPose::calculatePoseInSkeletonSpace( const SkeletonPose& poseInParentSpace, const SkeletonMesh& skeletonMesh ) {
-	SkeletonPose poseInSkeletonSpace;
-
-	// Check if pose in parent space contains also parent bones for all the bones. Otherwise, calculating pose in skeleton space is impossible.
-	for ( std::pair<unsigned char, float43> bone : poseInParentSpace.bonesPoses ) {
-		unsigned char parentBoneIndex = skeletonMesh.getBone( bone.first ).getParentBoneIndex( );
-		if ( parentBoneIndex != 0 && !poseInParentSpace.hasBone( parentBoneIndex ) ) throw std::exception( ( std::string( "SkeletonPose::calculatePoseInSkeletonSpace - cannot calculate pose in skeleton space, because parent pose is not known for some bones (for bone" ) + std::to_string( parentBoneIndex ) + std::string( ")" ) ).c_str( ) );
-	}
-
-	unsigned char boneIndex = 1;
-	while ( poseInSkeletonSpace.getBonesCount( ) < poseInParentSpace.getBonesCount() ) { // Iterate the bones until they are all calculated.
-	
-		if ( !poseInSkeletonSpace.hasBone( boneIndex ) ) {							 // If the bone hasn't yet been calculated.
-			unsigned char parentBoneIndex = skeletonMesh.getBone( boneIndex ).getParentBoneIndex();
-			if ( parentBoneIndex == 0 ) {											 // And it has no parent (is a root bone)
-	
-				float43 bonePoseInParentSpace = poseInParentSpace.getBonePose( boneIndex );
-	
-				// Root bone's pose in skeleton space is the same as it's pose in parent space
-				float43 bonePoseInSkeletonSpace = bonePoseInParentSpace;
-
-				// Save bone's pose in skeleton space.
-				poseInSkeletonSpace.setBonePose( boneIndex, bonePoseInSkeletonSpace );
-
-			} else if ( poseInSkeletonSpace.hasBone( parentBoneIndex ) ) {		     // But it's parent has already been calculated (otherwise, we cannot calculate that bone yet).
-				float43 parentBonePoseInSkeletonSpace = poseInSkeletonSpace.getBonePose( parentBoneIndex );
-				float43 bonePoseInParentSpace = poseInParentSpace.getBonePose( boneIndex );
-	
-				// Calculate bone's pose in skeleton space
-				float43 bonePoseInSkeletonSpace = bonePoseInParentSpace * parentBonePoseInSkeletonSpace;
-
-				// Save bone's pose in skeleton space.
-				poseInSkeletonSpace.setBonePose( boneIndex, bonePoseInSkeletonSpace );
-			}
-		}
-	
-											
-		if ( !poseInParentSpace.hasBone( boneIndex ) ) boneIndex = 0;		// If reached the last bone, itarate the bones again.
-		else ++boneIndex;													// Otherwise, go to the next bone.
-	}
-
-	return poseInSkeletonSpace;
-}
+            // Calculate bone's pose in parent space.
+            const float43 bonePoseInParentSpace = ( bonePoseInSkeletonSpace * parentBonePoseInSkeletonSpace.getScaleOrientationTranslationInverse() ).getOrientationTranslation();
 
-SkeletonPose SkeletonPose::calculatePoseInParentSpace( const SkeletonPose& poseInSkeletonSpace, const SkeletonMesh& skeletonMesh ) {
-	SkeletonPose poseInParentSpace;
-
-	
-	for ( std::pair<unsigned char, float43> bone : poseInSkeletonSpace.bonesPoses ) {
-		unsigned char parentBoneIndex = skeletonMesh.getBone( bone.first ).getParentBoneIndex( );
-		
-		if ( parentBoneIndex != 0 ) { // If bone is not the root.
-			
-			float44 bonePoseInSkeletonSpace( bone.second );
-			float43 bonePoseInParentSpace;
-			
-			// Calculate pose in parent space only for bones for which parent pose is also available.
-			if ( poseInSkeletonSpace.hasBone( parentBoneIndex ) ) {
-				float44 parentBonePoseInSkeletonSpace = poseInSkeletonSpace.getBonePose( parentBoneIndex );
-
-				// Calculate bone's pose in parent space
-				bonePoseInParentSpace = ( bonePoseInSkeletonSpace * parentBonePoseInSkeletonSpace.getScaleOrientationTranslationInverse( ) ).getOrientationTranslation( );
-
-				// Safe bone's pose in parent space.
-				poseInParentSpace.setBonePose( bone.first, bonePoseInParentSpace );
-			}
-		} else { // If bone is the root.
-			// Safe bone's pose in parent space - same as in skeleton space.
-			poseInParentSpace.setBonePose( bone.first, bone.second );
-		}
-	}
-
-	return poseInParentSpace;
-}
+            poseInParentSpace.m_boneOrientations[ boneIndex ] = bonePoseInParentSpace.getOrientation();
+            poseInParentSpace.m_boneTranslations[ boneIndex ] = bonePoseInParentSpace.getTranslation();
+        } 
+        else // If bone is the root - pose in parent space is the same as in skeleton space.
+        { 
+            poseInParentSpace.m_boneOrientations[ boneIndex ] = poseInSkeletonSpace.m_boneOrientations[ boneIndex ];
+            poseInParentSpace.m_boneTranslations[ boneIndex ] = poseInSkeletonSpace.m_boneTranslations[ boneIndex ];
+        }
 
-SkeletonPose::SkeletonPose( ) {}
+        poseInParentSpace.m_boneMask.set( boneIndex );
+    }
+
+    return poseInParentSpace;
+}
 
-SkeletonPose::SkeletonPose( const SkeletonPose& obj ) 
+void SkeletonPose::calculateSkinningMatrices( const SkeletonPose& poseInSkeletonSpace, const SkeletonMesh& skeletonMesh, std::vector< float43 >& skinningMatrices )
 {
-    bonesPoses.clear();
+    const unsigned char boneCount = skeletonMesh.getBoneCount();
+
+    skinningMatrices.resize( (size_t)boneCount + 1 );
+    skinningMatrices[ 0 ] = float43::IDENTITY;
+
+    for ( unsigned char boneIndex = 1; boneIndex <= boneCount; ++boneIndex ) 
+    {
+        if ( !poseInSkeletonSpace.hasBone( boneIndex ) ) 
+        {
+            skinningMatrices[ boneIndex ] = float43::IDENTITY;
+            continue;
+        }
 
-	// Copy the vector.
-	bonesPoses.insert( bonesPoses.begin(), obj.bonesPoses.begin( ), obj.bonesPoses.end( ) );
+        const SkeletonMesh::Bone& bone     = skeletonMesh.getBone( boneIndex );
+        const float43&            bindPose = bone.getBindPose();
+
+        // Same as in skeleton mesh vertex shaders: move to bone's coordinate system, move along with the bone, move back to mesh's coordinate system.
+        skinningMatrices[ boneIndex ] = bindPose * ( poseInSkeletonSpace.getBonePose( boneIndex ) * bindPose ) * bone.getBindPoseInv();
+    }
 }
 
+SkeletonPose::SkeletonPose( ) {}
+
+SkeletonPose::SkeletonPose( const SkeletonPose& obj ) :
+    m_boneMask( obj.m_boneMask ),
+    m_boneOrientations( obj.m_boneOrientations ),
+    m_boneTranslations( obj.m_boneTranslations )
+{}
+
 SkeletonPose::~SkeletonPose( ) {}
 
 SkeletonPose& SkeletonPose::operator = ( const SkeletonPose& obj )
 {
-    bonesPoses.clear();
-
-    // Copy the vector.
-    bonesPoses.insert( bonesPoses.begin( ), obj.bonesPoses.begin( ), obj.bonesPoses.end( ) );
+    m_boneMask         = obj.m_boneMask;
+    m_boneOrientations = obj.m_boneOrientations;
+    m_boneTranslations = obj.m_boneTranslations;
 
     return *this;
 }
 
-void SkeletonPose::setBonePose( const unsigned char boneIndex, const float43& bonePose ) {
-	// Note: boneIndex is in range 1 - 255.
-	if ( boneIndex == 0 ) throw std::exception( "SkeletonPose::setBone - boneIndex cannot be 0." );
-
-	// Find the bone or insert it in the vector.
-	for ( unsigned int vectorIndex = 0; vectorIndex <= bonesPoses.size( ); ++vectorIndex ) {
-		if ( ( bonesPoses.size( ) == vectorIndex ) || ( bonesPoses.size( ) > vectorIndex + 1 && bonesPoses.at( vectorIndex + 1 ).first < boneIndex ) ) { // There is no bone with such index.
-			bonesPoses.insert( bonesPoses.begin( ) + vectorIndex, std::make_pair( boneIndex, bonePose ) ); // Insert the bone.
-			break;
-		} else if ( bonesPoses.at( vectorIndex ).first == boneIndex ) { // Bone with such index was found.
-			bonesPoses.at( vectorIndex ).second = bonePose; // Edit the bone.
-			break; 
-		}
-	}
+void SkeletonPose::setBonePose( const unsigned char boneIndex, const float43& bonePose ) 
+{
+    // Note: boneIndex is in range 1 - 255.
+    if ( boneIndex == 0 ) throw std::exception( "SkeletonPose::setBone - boneIndex cannot be 0." );
+
+    reserveBones( boneIndex );
+
+    m_boneOrientations[ boneIndex ] = bonePose.getOrientation();
+    m_boneTranslations[ boneIndex ] = bonePose.getTranslation();
+    m_boneMask.set( boneIndex );
 }
 
-float43 SkeletonPose::getBonePose( const unsigned char boneIndex ) const {
-	// Find the bone.
-	for ( unsigned int vectorIndex = 0; vectorIndex <= bonesPoses.size(); ++vectorIndex ) {
-		if ( bonesPoses.at( vectorIndex ).first == boneIndex ) return bonesPoses.at( vectorIndex ).second;
-	}
+float43 SkeletonPose::getBonePose( const unsigned char boneIndex ) const 
+{
+    if ( !hasBone( boneIndex ) )
+        throw std::exception( ( std::string( "SkeletonPose::getBonePose - there is no bone with such index (boneIndex = " ) + std::to_string( boneIndex ) + std::string( " )." ) ).c_str( ) );
+
+    float43 bonePose;
+    bonePose.setOrientation( m_boneOrientations[ boneIndex ] );
+    bonePose.setTranslation( m_boneTranslations[ boneIndex ] );
 
-	throw std::exception( ( std::string( "SkeletonPose::getBonePose - there is no bone with such index (boneIndex = " ) + std::to_string( boneIndex ) + std::string( " )." ) ).c_str( ) );
+    return bonePose;
 }
 
-unsigned char SkeletonPose::getBonesCount( ) const {
-	return (unsigned char)bonesPoses.size( );
+unsigned char SkeletonPose::getBonesCount( ) const 
+{
+    return (unsigned char)m_boneMask.count();
 }
 
 void SkeletonPose::clear()
 {
-    bonesPoses.clear();
+    m_boneMask.reset();
+    m_boneOrientations.clear();
+    m_boneTranslations.clear();
+}
+
+bool SkeletonPose::hasBone( const unsigned char boneIndex ) const 
+{
+    return m_boneMask[ boneIndex ];
 }
 
-bool SkeletonPose::hasBone( const unsigned char boneIndex ) const {
-	// Find the bone.
-	for ( unsigned int vectorIndex = 0; vectorIndex < bonesPoses.size( ); ++vectorIndex ) {
-		if ( bonesPoses.at( vectorIndex ).first == boneIndex ) return true;
-	}
+void SkeletonPose::reserveBones( const unsigned char maxBoneIndex )
+{
+    if ( m_boneOrientations.size() > maxBoneIndex )
+        return;
 
-	return false;
-}
\ No newline at end of file
+    m_boneOrientations.resize( (size_t)maxBoneIndex + 1, float33::IDENTITY );
+    m_boneTranslations.resize( (size_t)maxBoneIndex + 1, float3::ZERO );
+}
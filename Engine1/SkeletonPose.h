@@ -1,7 +1,10 @@
 #pragma once
 
 #include <vector>
-#include <tuple>
+#include <bitset>
+#include "float3.h"
+#include "float33.h"
+#include "float43.h"
 #include "float44.h"
 
 
@@ -18,6 +21,9 @@ namespace Engine1
 
         public:
 
+        // Bone indices are in range 1 - 255.
+        static const int s_maxBoneCount = 255;
+
         static SkeletonPose createIdentityPoseInSkeletonSpace( const SkeletonMesh& skeletonMesh );
         static SkeletonPose createIdentityPoseInParentSpace( const SkeletonMesh& skeletonMesh );
 
@@ -25,7 +31,7 @@ namespace Engine1
         // Both blended poses should be in skeleton space or in parent space.
         static SkeletonPose blendPoses( const SkeletonPose& pose1, const SkeletonPose& pose2, float factor );
 
-        // Blends poses of the corresponding bones in both poses. If a bone is present only in one pose, it is used without blending. 
+        // Blends poses of the corresponding bones in both poses. If a bone is present only in one pose, it is used without blending.
         // If a pose contains only a subset of bones, the last bone in the chain is ignored, as it has no information about it's pose relative to it's parent (such bone has an identity pose).
         // Can be used to blend any poses in parent space (containing the same or different subset of bones).
         //static SkeletonPose blendPosesInParentSpace( const SkeletonPose& poseInParentSpace1, const SkeletonPose& poseInParentSpace2, const SkeletonMesh& mesh, float factor );
@@ -33,6 +39,10 @@ namespace Engine1
         static SkeletonPose calculatePoseInSkeletonSpace( const SkeletonPose& poseInParentSpace, const SkeletonMesh& skeletonMesh );
         static SkeletonPose calculatePoseInParentSpace( const SkeletonPose& poseInSkeletonSpace, const SkeletonMesh& skeletonMesh );
 
+        // Calculates a matrix transforming vertices from the bind pose to the given pose for each bone (indexed by bone index, index 0 is identity).
+        // Bones missing in the pose get identity matrices.
+        static void calculateSkinningMatrices( const SkeletonPose& poseInSkeletonSpace, const SkeletonMesh& skeletonMesh, std::vector< float43 >& skinningMatrices );
+
         SkeletonPose();
         SkeletonPose( const SkeletonPose& );
         ~SkeletonPose();
@@ -54,8 +64,15 @@ namespace Engine1
         // boneIndex is in range 1 - 255.
         bool hasBone( const unsigned char boneIndex ) const;
 
-        // Pairs of <bone index, bone pose>.
-        std::vector< std::pair<unsigned char, float43 > > bonesPoses;
+        // Makes room for bones up to the given index. Added bones are not present until their pose is set.
+        void reserveBones( const unsigned char maxBoneIndex );
+
+        // Poses are stored densely - indexed directly by bone index (index 0 is unused), so lookups are constant time
+        // and poses are processed in linear loops. Orientations and translations are stored in separate arrays.
+        // Arrays are sized to the highest bone index set so far (not to the max bone count), as animations store a pose per keyframe.
+        std::bitset< s_maxBoneCount + 1 > m_boneMask; // Which bones are present in the pose.
+        std::vector< float33 >            m_boneOrientations;
+        std::vector< float3 >             m_boneTranslations;
 
     };
 }
@@ -0,0 +1,202 @@
+#include "SkinningUtil.h"
+
+#include <algorithm>
+#include <xmmintrin.h>
+
+#include "SkeletonMesh.h"
+#include "SkeletonPose.h"
+#include "BlockMesh.h"
+#include "ParallelUtil.h"
+
+using namespace Engine1;
+
+const size_t SkinningUtil::s_minVerticesPerThread = 16 * 1024;
+
+namespace
+{
+    const size_t skinningMatrixFloatCount = 16;
+    const size_t skinningMatrixCount      = SkeletonPose::s_maxBoneCount + 1;
+
+    inline void storeFloat3( float3& destination, const __m128 value )
+    {
+        _mm_storel_pi( reinterpret_cast< __m64* >( &destination.x ), value );
+        _mm_store_ss( &destination.z, _mm_movehl_ps( value, value ) );
+    }
+
+    // Multiplies the vector by the 3x3 part of the matrix (given as rows).
+    inline __m128 transformDirection( const float3& direction, const __m128 row1, const __m128 row2, const __m128 row3 )
+    {
+        return _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( direction.x ), row1 ), _mm_mul_ps( _mm_set1_ps( direction.y ), row2 ) ),
+                           _mm_mul_ps( _mm_set1_ps( direction.z ), row3 ) );
+    }
+
+    // Zero vectors are left unchanged.
+    inline __m128 normalize( const __m128 vector )
+    {
+        const __m128 squared       = _mm_mul_ps( vector, vector );
+        const __m128 lengthSquared = _mm_add_ss( _mm_add_ss( squared, _mm_shuffle_ps( squared, squared, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ),
+                                                 _mm_shuffle_ps( squared, squared, _MM_SHUFFLE( 2, 2, 2, 2 ) ) );
+
+        if ( _mm_cvtss_f32( lengthSquared ) <= 0.0f )
+            return vector;
+
+        const __m128 length = _mm_sqrt_ss( lengthSquared );
+        return _mm_div_ps( vector, _mm_shuffle_ps( length, length, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+    }
+
+    template< int bonesPerVertex >
+    void skinVertexRange( const SkeletonMesh& mesh, const float* skinningMatrices, const size_t beginVertexIdx, const size_t endVertexIdx,
+                          float3* vertices, float3* normals, float3* tangents )
+    {
+        const float3*        sourceVertices = mesh.getVertices().data();
+        const float3*        sourceNormals  = normals ? mesh.getNormals().data() : nullptr;
+        const float3*        sourceTangents = tangents ? mesh.getTangents().data() : nullptr;
+        const unsigned char* vertexBones    = mesh.getVertexBones().data();
+        const float*         vertexWeights  = mesh.getVertexWeights().data();
+
+        for ( size_t vertexIdx = beginVertexIdx; vertexIdx < endVertexIdx; ++vertexIdx )
+        {
+            // Blend skinning matrices of the vertex bones. Bones with non-positive weights are ignored (as in the vertex shaders).
+            __m128 row1 = _mm_setzero_ps(), row2 = _mm_setzero_ps(), row3 = _mm_setzero_ps(), row4 = _mm_setzero_ps();
+
+            for ( int slotIdx = 0; slotIdx < bonesPerVertex; ++slotIdx )
+            {
+                const size_t  boneSlot = vertexIdx * bonesPerVertex + slotIdx;
+                const float*  matrix   = skinningMatrices + vertexBones[ boneSlot ] * skinningMatrixFloatCount;
+                const __m128  weight   = _mm_set1_ps( std::max( vertexWeights[ boneSlot ], 0.0f ) );
+
+                row1 = _mm_add_ps( row1, _mm_mul_ps( weight, _mm_loadu_ps( matrix ) ) );
+                row2 = _mm_add_ps( row2, _mm_mul_ps( weight, _mm_loadu_ps( matrix + 4 ) ) );
+                row3 = _mm_add_ps( row3, _mm_mul_ps( weight, _mm_loadu_ps( matrix + 8 ) ) );
+                row4 = _mm_add_ps( row4, _mm_mul_ps( weight, _mm_loadu_ps( matrix + 12 ) ) );
+            }
+
+            storeFloat3( vertices[ vertexIdx ], _mm_add_ps( transformDirection( sourceVertices[ vertexIdx ], row1, row2, row3 ), row4 ) );
+
+            if ( normals )
+                storeFloat3( normals[ vertexIdx ], normalize( transformDirection( sourceNormals[ vertexIdx ], row1, row2, row3 ) ) );
+
+            if ( tangents )
+                storeFloat3( tangents[ vertexIdx ], normalize( transformDirection( sourceTangents[ vertexIdx ], row1, row2, row3 ) ) );
+        }
+    }
+}
+
+void SkinningUtil::skinVertices( const SkeletonMesh& mesh, const SkeletonPose& poseInSkeletonSpace,
+                                 std::vector< float3 >& vertices, std::vector< float3 >& normals, std::vector< float3 >& tangents )
+{
+    const std::vector< float > skinningMatrices = calculateSkinningMatrices( mesh, poseInSkeletonSpace );
+
+    resizeOutput( mesh, vertices, normals, tangents );
+
+    ParallelUtil::parallelForRanges( vertices.size(), s_minVerticesPerThread, [ & ]( const size_t begin, const size_t end ) {
+        skinVertices( mesh, skinningMatrices, begin, end, vertices, normals, tangents );
+    } );
+}
+
+std::shared_ptr< BlockMesh > SkinningUtil::createSkinnedMesh( const SkeletonMesh& mesh, const SkeletonPose& poseInSkeletonSpace )
+{
+    const int vertexCount = (int)mesh.getVertices().size();
+
+    auto skinnedMesh = std::make_shared< BlockMesh >( vertexCount, !mesh.getNormals().empty(), mesh.getTexcoordsCount(), (int)mesh.getTriangles().size() );
+
+    for ( int setIndex = 0; setIndex < mesh.getTexcoordsCount(); ++setIndex )
+        skinnedMesh->getTexcoords( setIndex ) = mesh.getTexcoords( setIndex );
+
+    skinnedMesh->getTriangles() = mesh.getTriangles();
+
+    skinVertices( mesh, poseInSkeletonSpace, skinnedMesh->getVertices(), skinnedMesh->getNormals(), skinnedMesh->getTangents() );
+
+    skinnedMesh->recalculateBoundingBox();
+
+    return skinnedMesh;
+}
+
+void SkinningUtil::updateSkinnedMesh( BlockMesh& skinnedMesh, const SkeletonMesh& mesh, const SkeletonPose& poseInSkeletonSpace )
+{
+    if ( skinnedMesh.getVertices().size() != mesh.getVertices().size() )
+        throw std::exception( "SkinningUtil::updateSkinnedMesh - vertex count of the skinned mesh doesn't match the skeleton mesh." );
+
+    skinVertices( mesh, poseInSkeletonSpace, skinnedMesh.getVertices(), skinnedMesh.getNormals(), skinnedMesh.getTangents() );
+}
+
+void SkinningUtil::updateSkinnedMeshes( const std::vector< SkinnedMeshUpdate >& updates )
+{
+    for ( const SkinnedMeshUpdate& update : updates )
+    {
+        if ( update.skinnedMesh->getVertices().size() != update.mesh->getVertices().size() )
+            throw std::exception( "SkinningUtil::updateSkinnedMeshes - vertex count of the skinned mesh doesn't match the skeleton mesh." );
+    }
+
+    // Threads over meshes - nesting parallel loops over vertices would only add more threads than cores.
+    ParallelUtil::parallelFor( (int)updates.size(), [ &updates ]( const int updateIdx ) {
+        const SkinnedMeshUpdate& update = updates[ updateIdx ];
+
+        std::vector< float3 >& vertices = update.skinnedMesh->getVertices();
+        std::vector< float3 >& normals  = update.skinnedMesh->getNormals();
+        std::vector< float3 >& tangents = update.skinnedMesh->getTangents();
+
+        const std::vector< float > skinningMatrices = calculateSkinningMatrices( *update.mesh, *update.poseInSkeletonSpace );
+
+        resizeOutput( *update.mesh, vertices, normals, tangents );
+        skinVertices( *update.mesh, skinningMatrices, 0, vertices.size(), vertices, normals, tangents );
+    } );
+}
+
+void SkinningUtil::skinVertices( const SkeletonMesh& mesh, const std::vector< float >& skinningMatrices, const size_t beginVertexIdx, const size_t endVertexIdx,
+                                 std::vector< float3 >& vertices, std::vector< float3 >& normals, std::vector< float3 >& tangents )
+{
+    float3* normalsData  = !normals.empty() ? normals.data() : nullptr;
+    float3* tangentsData = !tangents.empty() ? tangents.data() : nullptr;
+
+    switch ( mesh.getBonesPerVertexCount() )
+    {
+        case BonesPerVertexCount::Type::ONE:
+            skinVertexRange< 1 >( mesh, skinningMatrices.data(), beginVertexIdx, endVertexIdx, vertices.data(), normalsData, tangentsData );
+            break;
+        case BonesPerVertexCount::Type::TWO:
+            skinVertexRange< 2 >( mesh, skinningMatrices.data(), beginVertexIdx, endVertexIdx, vertices.data(), normalsData, tangentsData );
+            break;
+        case BonesPerVertexCount::Type::FOUR:
+            skinVertexRange< 4 >( mesh, skinningMatrices.data(), beginVertexIdx, endVertexIdx, vertices.data(), normalsData, tangentsData );
+            break;
+        default:
+            throw std::exception( "SkinningUtil::skinVertices - mesh has no bones assigned to vertices." );
+    }
+}
+
+std::vector< float > SkinningUtil::calculateSkinningMatrices( const SkeletonMesh& mesh, const SkeletonPose& poseInSkeletonSpace )
+{
+    const size_t bonesPerVertexCount = (size_t)mesh.getBonesPerVertexCount();
+
+    if ( mesh.getVertexBones().size() != mesh.getVertices().size() * bonesPerVertexCount
+         || mesh.getVertexWeights().size() != mesh.getVertexBones().size() )
+        throw std::exception( "SkinningUtil::calculateSkinningMatrices - vertex bones or weights count doesn't match the vertex count." );
+
+    std::vector< float43 > boneSkinningMatrices;
+    SkeletonPose::calculateSkinningMatrices( poseInSkeletonSpace, mesh, boneSkinningMatrices );
+
+    // Note: Matrices of bones not present in the mesh stay zero, so invalid bone indices don't read out of bounds.
+    std::vector< float > skinningMatrices( skinningMatrixCount * skinningMatrixFloatCount, 0.0f );
+    for ( size_t boneIndex = 1; boneIndex < boneSkinningMatrices.size(); ++boneIndex )
+    {
+        const float43& matrix       = boneSkinningMatrices[ boneIndex ];
+        float*         paddedMatrix = skinningMatrices.data() + boneIndex * skinningMatrixFloatCount;
+
+        paddedMatrix[ 0 ]  = matrix.m11; paddedMatrix[ 1 ]  = matrix.m12; paddedMatrix[ 2 ]  = matrix.m13;
+        paddedMatrix[ 4 ]  = matrix.m21; paddedMatrix[ 5 ]  = matrix.m22; paddedMatrix[ 6 ]  = matrix.m23;
+        paddedMatrix[ 8 ]  = matrix.m31; paddedMatrix[ 9 ]  = matrix.m32; paddedMatrix[ 10 ] = matrix.m33;
+        paddedMatrix[ 12 ] = matrix.t1;  paddedMatrix[ 13 ] = matrix.t2;  paddedMatrix[ 14 ] = matrix.t3;
+    }
+
+    return skinningMatrices;
+}
+
+void SkinningUtil::resizeOutput( const SkeletonMesh& mesh, std::vector< float3 >& vertices, std::vector< float3 >& normals, std::vector< float3 >& tangents )
+{
+    const size_t vertexCount = mesh.getVertices().size();
+
+    vertices.resize( vertexCount );
+    normals.resize( !mesh.getNormals().empty() ? vertexCount : 0 );
+    tangents.resize( !mesh.getTangents().empty() ? vertexCount : 0 );
+}
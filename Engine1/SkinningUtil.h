@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "float3.h"
+
+namespace Engine1
+{
+    class SkeletonMesh;
+    class SkeletonPose;
+    class BlockMesh;
+
+    // Skinning on the CPU - deforms skeleton meshes the same way as the skeleton mesh vertex shaders do,
+    // so animated meshes can be used outside of rasterization (ex: to build a BVH tree for ray tracing or in tools).
+    // Each vertex blends the skinning matrices of its bones with SSE. Vertex loop is specialized for each bones-per-vertex count.
+    class SkinningUtil
+    {
+        public:
+
+        // Calculates vertices, normals and tangents of the mesh deformed by the given pose (in skeleton space).
+        // Output vectors are resized to the vertex count. Normals and tangents are left empty if the mesh doesn't have them.
+        // Vertices of large meshes are processed in parallel.
+        static void skinVertices( const SkeletonMesh& mesh, const SkeletonPose& poseInSkeletonSpace,
+                                  std::vector< float3 >& vertices, std::vector< float3 >& normals, std::vector< float3 >& tangents );
+
+        // Creates a block mesh with skinned vertices, normals and tangents and with texcoords and triangles copied from the skeleton mesh.
+        static std::shared_ptr< BlockMesh > createSkinnedMesh( const SkeletonMesh& mesh, const SkeletonPose& poseInSkeletonSpace );
+
+        // Updates vertices, normals and tangents of a mesh created with createSkinnedMesh. Its triangles can be reordered (ex: by building a BVH tree).
+        // Note: Bounding box is not recalculated.
+        static void updateSkinnedMesh( BlockMesh& skinnedMesh, const SkeletonMesh& mesh, const SkeletonPose& poseInSkeletonSpace );
+
+        struct SkinnedMeshUpdate
+        {
+            BlockMesh*          skinnedMesh;
+            const SkeletonMesh* mesh;
+            const SkeletonPose* poseInSkeletonSpace;
+        };
+
+        // Updates many meshes in parallel - each mesh is processed by a single thread.
+        static void updateSkinnedMeshes( const std::vector< SkinnedMeshUpdate >& updates );
+
+        private:
+
+        // Skins vertices in range [beginVertexIdx, endVertexIdx). Output vectors have to be already resized.
+        static void skinVertices( const SkeletonMesh& mesh, const std::vector< float >& skinningMatrices, const size_t beginVertexIdx, const size_t endVertexIdx,
+                                  std::vector< float3 >& vertices, std::vector< float3 >& normals, std::vector< float3 >& tangents );
+
+        // Skinning matrices for all possible bone indices - each as 4 rows of 4 floats (padded for SSE). Bone index 0 (no bone) has a zero matrix.
+        static std::vector< float > calculateSkinningMatrices( const SkeletonMesh& mesh, const SkeletonPose& poseInSkeletonSpace );
+
+        static void resizeOutput( const SkeletonMesh& mesh, std::vector< float3 >& vertices, std::vector< float3 >& normals, std::vector< float3 >& tangents );
+
+        static const size_t s_minVerticesPerThread;
+
+        SkinningUtil() {};
+        ~SkinningUtil() {};
+    };
+}
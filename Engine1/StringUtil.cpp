@@ -8,8 +8,20 @@
 
 using namespace Engine1;
 
+namespace
+{
+	// Locale names differ between platforms - falls back to the classic locale if the name isn't known.
+	std::locale createLocale( const std::string& name ) {
+		try {
+			return std::locale( name );
+		} catch ( std::exception& ) {
+			return std::locale::classic();
+		}
+	}
+}
+
 const std::string StringUtil::localeName = "en-US";
-std::locale StringUtil::locale( localeName );
+std::locale StringUtil::locale( createLocale( localeName ) );
 
 std::wstring StringUtil::widen( const char *narrowString ) {
 	int wideCharCount = MultiByteToWideChar( CP_UTF8, 0, narrowString, -1, nullptr, 0 );
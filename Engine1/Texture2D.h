@@ -63,6 +63,8 @@ namespace Engine1
         DXGI_FORMAT getTextureFormat() const;
 
         void loadCpuToGpu( ID3D11Device3& device, ID3D11DeviceContext3& deviceContext, const bool reload = false );
+        // Creates the texture on GPU if it's not there yet. Doesn't use device context, so it can be called from any thread.
+        void loadCpuToGpu( ID3D11Device3& device );
         void unloadFromCpu();
         void unloadFromGpu();
 
@@ -956,8 +958,7 @@ namespace Engine1
 
         if ( !isInGpuMemory() ) 
         {
-            createTextureOnGpu( device, m_dataMipmaps, m_width, m_height, getMipMapCountOnCpu() > 1, m_textureFormat );
-            createTextureViewsOnGpu( device, m_width, m_height, getMipMapCountOnCpu() > 1, m_srvFormat, m_rtvFormat, m_dsvFormat, m_uavFormat );
+            loadCpuToGpu( device );
         } 
         else if ( reload ) 
         {
@@ -980,6 +981,20 @@ namespace Engine1
         }
     }
 
+    template< typename PixelType >
+    void Texture2D< PixelType >
+        ::loadCpuToGpu( ID3D11Device3& device )
+    {
+        if ( !isInCpuMemory() )
+            throw std::exception( "Texture2DGeneric::loadCpuToGpu - texture is not in CPU memory." );
+
+        if ( isInGpuMemory() )
+            return;
+
+        createTextureOnGpu( device, m_dataMipmaps, m_width, m_height, getMipMapCountOnCpu() > 1, m_textureFormat );
+        createTextureViewsOnGpu( device, m_width, m_height, getMipMapCountOnCpu() > 1, m_srvFormat, m_rtvFormat, m_dsvFormat, m_uavFormat );
+    }
+
     template< typename PixelType >
     void Texture2D< PixelType >
         ::unloadFromCpu()
@@ -1048,7 +1063,7 @@ namespace Engine1
 
     template< typename PixelType >
     int Texture2D< PixelType >
-        ::getWidth( unsigned int mipMapLevel = 0 ) const
+        ::getWidth( unsigned int mipMapLevel ) const
     {
         if ( (int)mipMapLevel >= getMipMapCountOnCpu() && (int)mipMapLevel >= getMipMapCountOnGpu() )
 		    throw std::exception( "Texture2DGeneric::getWidth - Incorrect level requested. There is no mipmap with such level." );
@@ -1058,7 +1073,7 @@ namespace Engine1
 
     template< typename PixelType >
     int Texture2D< PixelType >
-        ::getHeight( unsigned int mipMapLevel = 0 ) const
+        ::getHeight( unsigned int mipMapLevel ) const
     {
         if ( (int)mipMapLevel >= getMipMapCountOnCpu() && (int)mipMapLevel >= getMipMapCountOnGpu() )
 		    throw std::exception( "Texture2DGeneric::getHeight - Incorrect level requested. There is no mipmap with such level." );
@@ -1068,7 +1083,7 @@ namespace Engine1
 
     template< typename PixelType >
     int2 Texture2D< PixelType >
-        ::getDimensions( unsigned int mipMapLevel = 0 ) const
+        ::getDimensions( unsigned int mipMapLevel ) const
     {
         if ( (int)mipMapLevel >= getMipMapCountOnCpu() && (int)mipMapLevel >= getMipMapCountOnGpu() )
             throw std::exception( "Texture2DGeneric::getDimensions - Incorrect level requested. There is no mipmap with such level." );
@@ -1078,7 +1093,7 @@ namespace Engine1
 
     template< typename PixelType >
     int Texture2D< PixelType >
-        ::getSize( unsigned int mipMapLevel = 0 ) const
+        ::getSize( unsigned int mipMapLevel ) const
     {
         if ( (int)mipMapLevel >= getMipMapCountOnCpu() && (int)mipMapLevel >= getMipMapCountOnGpu() )
 		    throw std::exception( "Texture2DGeneric::getSize - Incorrect level requested. There is no mipmap with such level." );
@@ -1088,7 +1103,7 @@ namespace Engine1
 
     template< typename PixelType >
     int Texture2D< PixelType >
-        ::getLineSize( unsigned int mipMapLevel = 0 ) const
+        ::getLineSize( unsigned int mipMapLevel ) const
     {
         if ( (int)mipMapLevel >= getMipMapCountOnCpu() && (int)mipMapLevel >= getMipMapCountOnGpu() )
 		    throw std::exception( "Texture2DGeneric::getLineSize - Incorrect level requested. There is no mipmap with such level." );
@@ -1098,7 +1113,7 @@ namespace Engine1
 
 	template< typename PixelType >
 	ID3D11ShaderResourceView* Texture2D< PixelType >
-		::getShaderResourceView( int mipmapLevel = -1 ) const
+		::getShaderResourceView( int mipmapLevel ) const
 	{
 		if (mipmapLevel < -1 || mipmapLevel >= (int)m_srViews.size())
 			throw std::exception("Texture2DGeneric::getShaderResourceView - Tried to access shader resource view for non-existing mipmap level.");
@@ -1337,7 +1352,7 @@ namespace Engine1
 
     template< typename PixelType >
     PixelType Texture2D< PixelType >
-    ::getDataPixel( float2 texcoords, unsigned int mipMapLevel = 0 )
+    ::getDataPixel( float2 texcoords, unsigned int mipMapLevel )
     {
         // Clamp texcoords to <0, 1> range.
         texcoords.x = std::max( 0.0f, texcoords.x );
@@ -1353,7 +1368,7 @@ namespace Engine1
 
     template< typename PixelType >
     PixelType Texture2D< PixelType >
-    ::getDataPixel( int2 position, unsigned int mipMapLevel = 0 )
+    ::getDataPixel( int2 position, unsigned int mipMapLevel )
     {
         const int2 dimensions = getDimensions( mipMapLevel );
         position.x = std::min( dimensions.x - 1, position.x );
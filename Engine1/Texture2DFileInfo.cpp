@@ -59,6 +59,7 @@ void Texture2DFileInfo::saveToMemory( std::vector<char>& data ) const
 void Texture2DFileInfo::setPath( std::string path )
 {
 	m_path = path;
+	invalidateAssetId();
 }
 
 void Texture2DFileInfo::setFormat( Format format )
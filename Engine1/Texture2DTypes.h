@@ -26,7 +26,7 @@ namespace Engine1
 	public:
 
 		ImmutableTexture2D() 
-			: Texture2D(
+			: Texture2D< PixelType >(
 				D3D11_USAGE_IMMUTABLE,
 				D3D11_BIND_SHADER_RESOURCE,
 				0 )
@@ -38,7 +38,7 @@ namespace Engine1
 			const bool storeOnCpu, const bool storeOnGpu, 
 			const bool generateMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat )
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_IMMUTABLE, 
 				D3D11_BIND_SHADER_RESOURCE, 
 				0, 
@@ -56,7 +56,7 @@ namespace Engine1
 			const bool storeOnCpu, const bool storeOnGpu, 
 			const bool generateMipmaps,
 			DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat ) 
-			: Texture2D(
+			: Texture2D< PixelType >(
 				D3D11_USAGE_IMMUTABLE, 
 				D3D11_BIND_SHADER_RESOURCE, 
 				0, 
@@ -74,7 +74,7 @@ namespace Engine1
 			const bool storeOnCpu, const bool storeOnGpu,
 			const bool hasMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat ) 
-			: Texture2D(
+			: Texture2D< PixelType >(
 				D3D11_USAGE_IMMUTABLE, 
 				D3D11_BIND_SHADER_RESOURCE, 
 				0, 
@@ -93,7 +93,7 @@ namespace Engine1
 			const bool generateMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat ) 
 			
-			: Texture2D(
+			: Texture2D< PixelType >(
 				D3D11_USAGE_IMMUTABLE, 
 				D3D11_BIND_SHADER_RESOURCE, 
 				0, 
@@ -117,7 +117,7 @@ namespace Engine1
 			const bool storeOnCpu, const bool storeOnGpu,
             const bool generateMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DYNAMIC,
 				D3D11_BIND_SHADER_RESOURCE,
 				D3D11_CPU_ACCESS_WRITE,
@@ -133,7 +133,7 @@ namespace Engine1
 			std::vector<char>::const_iterator dataIt, std::vector<char>::const_iterator dataEndIt,
             const Texture2DFileInfo::Format format, const bool storeOnCpu, const bool storeOnGpu, const bool generateMipmaps,
             DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DYNAMIC,
 				D3D11_BIND_SHADER_RESOURCE,
 				D3D11_CPU_ACCESS_WRITE, 
@@ -152,7 +152,7 @@ namespace Engine1
             const bool hasMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat ) 
 			
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DYNAMIC,
 				D3D11_BIND_SHADER_RESOURCE,
 				D3D11_CPU_ACCESS_WRITE, 
@@ -170,7 +170,7 @@ namespace Engine1
             const bool storeOnCpu, const bool storeOnGpu, 
 			const bool generateMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DYNAMIC,
 				D3D11_BIND_SHADER_RESOURCE,
 				D3D11_CPU_ACCESS_WRITE, 
@@ -194,7 +194,7 @@ namespace Engine1
 			const bool storeOnCpu, const bool storeOnGpu,
             const bool generateMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat, DXGI_FORMAT depthFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DEFAULT,
 				D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE,
 				0, 
@@ -212,7 +212,7 @@ namespace Engine1
 			const bool storeOnCpu, const bool storeOnGpu, 
 			const bool generateMipmaps,
             DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat, DXGI_FORMAT depthFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DEFAULT,
 				D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE,
 				0, 
@@ -229,7 +229,7 @@ namespace Engine1
 			const int width, const int height, 
 			const bool storeOnCpu, const bool storeOnGpu,
             const bool hasMipmaps, DXGI_FORMAT textureFormat, DXGI_FORMAT srvFormat, DXGI_FORMAT depthFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DEFAULT,
 				D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE,
 				0, 
@@ -247,7 +247,7 @@ namespace Engine1
             const bool storeOnCpu, const bool storeOnGpu, 
 			const bool generateMipmaps, DXGI_FORMAT textureFormat,
 			DXGI_FORMAT srvFormat, DXGI_FORMAT depthFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DEFAULT,
 				D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE,
 				0, 
@@ -261,10 +261,10 @@ namespace Engine1
 
 		ID3D11DepthStencilView* getDepthStencilView( int mipmapLevel = 0 ) const
 		{
-			if (mipmapLevel < 0 || mipmapLevel >= (int)m_dsViews.size())
+			if (mipmapLevel < 0 || mipmapLevel >= (int)this->m_dsViews.size())
 				throw std::exception("DepthTexture::getDepthStencilView - Tried to access depth stencil view for non-existing mipmap level.");
 
-			return m_dsViews[mipmapLevel].Get();
+			return this->m_dsViews[mipmapLevel].Get();
 		}
 
 		void clearDepthStencilView(ID3D11DeviceContext3& deviceContext, bool clearDepth, float depth, bool clearStencil, unsigned char stencil, int mipmapLevel = 0)
@@ -272,17 +272,17 @@ namespace Engine1
 			if (!clearDepth && !clearStencil)
 				return;
 
-			if (!isInGpuMemory())
+			if (!this->isInGpuMemory())
 				throw std::exception("DepthTexture::clearDepthStencilView - Texture not in GPU memory.");
 
-			if (mipmapLevel < 0 || mipmapLevel >= (int)m_dsViews.size())
+			if (mipmapLevel < 0 || mipmapLevel >= (int)this->m_dsViews.size())
 				throw std::exception("DepthTexture::clearDepthStencilView - Tried to clear depth stencil view for non-existing mipmap level.");
 
 			UINT flags = 0;
 			if (clearDepth)   flags |= D3D11_CLEAR_DEPTH;
 			if (clearStencil) flags |= D3D11_CLEAR_STENCIL;
 
-			deviceContext.ClearDepthStencilView(m_dsViews[mipmapLevel].Get(), flags, depth, stencil);
+			deviceContext.ClearDepthStencilView(this->m_dsViews[mipmapLevel].Get(), flags, depth, stencil);
 		}
     };
 
@@ -297,7 +297,7 @@ namespace Engine1
 			const bool storeOnCpu, const bool storeOnGpu,
             const bool generateMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT uavFormat, DXGI_FORMAT srvFormat, DXGI_FORMAT rtvFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DEFAULT,
 				D3D11_BIND_RENDER_TARGET | D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE, 
 				0,                        
@@ -314,7 +314,7 @@ namespace Engine1
 			const Texture2DFileInfo::Format format, const bool storeOnCpu, const bool storeOnGpu, 
 			const bool generateMipmaps,
 			DXGI_FORMAT textureFormat, DXGI_FORMAT uavFormat, DXGI_FORMAT srvFormat, DXGI_FORMAT rtvFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DEFAULT,
 				D3D11_BIND_RENDER_TARGET | D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE,
 				0, 
@@ -332,7 +332,7 @@ namespace Engine1
 			const bool storeOnCpu, const bool storeOnGpu,
             const bool hasMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT uavFormat, DXGI_FORMAT srvFormat, DXGI_FORMAT rtvFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DEFAULT,
 				D3D11_BIND_RENDER_TARGET | D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE,
 				0, 
@@ -350,7 +350,7 @@ namespace Engine1
 			const bool storeOnCpu, const bool storeOnGpu, 
 			const bool generateMipmaps, 
 			DXGI_FORMAT textureFormat, DXGI_FORMAT uavFormat, DXGI_FORMAT srvFormat, DXGI_FORMAT rtvFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DEFAULT,
 				D3D11_BIND_RENDER_TARGET | D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE,
 				0, 
@@ -370,7 +370,7 @@ namespace Engine1
 			ID3D11Device3& device, 
 			Microsoft::WRL::ComPtr<ID3D11Texture2D>& texture,
             DXGI_FORMAT textureFormat, DXGI_FORMAT rtvFormat ) 
-			: Texture2D( 
+			: Texture2D< PixelType >( 
 				D3D11_USAGE_DEFAULT,
 				D3D11_BIND_RENDER_TARGET,
 				0, 
@@ -381,52 +381,52 @@ namespace Engine1
 
 		ID3D11RenderTargetView* getRenderTargetView(int mipmapLevel = 0) const
 		{
-			if (mipmapLevel < 0 || mipmapLevel >= (int)m_rtViews.size())
+			if (mipmapLevel < 0 || mipmapLevel >= (int)this->m_rtViews.size())
 				throw std::exception("DepthTexture::getRenderTargetView - Tried to access render target view for non-existing mipmap level.");
 
-			return m_rtViews[mipmapLevel].Get();
+			return this->m_rtViews[mipmapLevel].Get();
 		}
 
 		void clearRenderTargetView(ID3D11DeviceContext3& deviceContext, float4 colorRGBA, int mipmapLevel = 0)
 		{
-			if (!isInGpuMemory())
+			if (!this->isInGpuMemory())
 				throw std::exception("RenderTargetTexture2D::clearRenderTargetView - Texture not in GPU memory.");
 
-			if (mipmapLevel < 0 || mipmapLevel >= (int)m_rtViews.size())
+			if (mipmapLevel < 0 || mipmapLevel >= (int)this->m_rtViews.size())
 				throw std::exception("RenderTargetTexture2D::clearRenderTargetView - Tried to clear render target view for non-existing mipmap level.");
 
-			deviceContext.ClearRenderTargetView(m_rtViews[mipmapLevel].Get(), colorRGBA.getData());
+			deviceContext.ClearRenderTargetView(this->m_rtViews[mipmapLevel].Get(), colorRGBA.getData());
 		}
 
 	    ID3D11UnorderedAccessView* getUnorderedAccessView(int mipmapLevel = 0) const
 	    {
-		    if (mipmapLevel < 0 || mipmapLevel >= (int)m_uaViews.size())
+		    if (mipmapLevel < 0 || mipmapLevel >= (int)this->m_uaViews.size())
 			    throw std::exception("RenderTargetTexture2D::getUnorderedAccessView - Tried to access unordered access view for non-existing mipmap level.");
 
-		    return m_uaViews[mipmapLevel].Get();
+		    return this->m_uaViews[mipmapLevel].Get();
 	    }
 
 	    void clearUnorderedAccessViewUint(ID3D11DeviceContext3& deviceContext, uint4 value, int mipmapLevel = 0)
 	    {
-		    if (!isInGpuMemory())
+		    if (!this->isInGpuMemory())
 			    throw std::exception("RenderTargetTexture2D::clearUnorderedAccessViewUint - Texture not in GPU memory.");
 
-		    if (mipmapLevel < 0 || mipmapLevel >= (int)m_uaViews.size())
+		    if (mipmapLevel < 0 || mipmapLevel >= (int)this->m_uaViews.size())
 			    throw std::exception("RenderTargetTexture2D::clearUnorderedAccessViewUint - Tried to clear unordered access view for non-existing mipmap level.");
 
-		    deviceContext.ClearUnorderedAccessViewUint(m_uaViews[mipmapLevel].Get(), value.getData());
+		    deviceContext.ClearUnorderedAccessViewUint(this->m_uaViews[mipmapLevel].Get(), value.getData());
 	    }
 
 	    void clearUnorderedAccessViewFloat(ID3D11DeviceContext3& deviceContext, float4 value, int mipmapLevel = 0)
 	    {
-		    if (!isInGpuMemory())
+		    if (!this->isInGpuMemory())
 			    throw std::exception("RenderTargetTexture2D::clearUnorderedAccessViewFloat - Texture not in GPU memory.");
 
-		    if (mipmapLevel < 0 || mipmapLevel >= (int)m_uaViews.size())
+		    if (mipmapLevel < 0 || mipmapLevel >= (int)this->m_uaViews.size())
 			    throw std::exception("RenderTargetTexture2D::clearUnorderedAccessViewFloat - Tried to clear unordered access view for non-existing mipmap level.");
 
 		    float val[4] = { value.x, value.y, value.z, value.w };
-		    deviceContext.ClearUnorderedAccessViewFloat(m_uaViews[mipmapLevel].Get(), val);
+		    deviceContext.ClearUnorderedAccessViewFloat(this->m_uaViews[mipmapLevel].Get(), val);
 	    }
     };
 }
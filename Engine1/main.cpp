@@ -2,12 +2,15 @@
 #include <fstream>
 
 #include "EngineApplication.h"
+#include "AssetArchive.h"
+#include "AssetPathManager.h"
 
 #include "StringUtil.h"
 
 using namespace Engine1;
 
 void writeErrorToFile( std::string path, std::string errorMsg );
+bool runCommandLineTool( int argc, char** argv );
 
 int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nShowCmd ) {
     // Unused.
@@ -16,6 +19,13 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
     nShowCmd;
 
 	try {
+        // Run as a command line tool if requested - don't create the window.
+        if ( runCommandLineTool( __argc, __argv ) )
+            return 0;
+
+        // Scan the assets while the window and the device are being created.
+        AssetPathManager::initializeAsync();
+
 		EngineApplication application;
 
 		application.initialize( hInstance );
@@ -29,6 +39,30 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
 	return 0;
 }
 
+// Supported commands:
+// -pack <directory> <archive path> [-nocompression] - packs all files from the directory into an asset archive.
+bool runCommandLineTool( int argc, char** argv )
+{
+    if ( argc < 2 )
+        return false;
+
+    const std::string command = argv[ 1 ];
+
+    if ( command == "-pack" )
+    {
+        if ( argc < 4 )
+            throw std::exception( "runCommandLineTool - usage: -pack <directory> <archive path> [-nocompression]" );
+
+        const bool compress = !( argc >= 5 && std::string( argv[ 4 ] ) == "-nocompression" );
+
+        AssetArchive::pack( argv[ 2 ], argv[ 3 ], compress );
+
+        return true;
+    }
+
+    return false;
+}
+
 void writeErrorToFile( std::string path, std::string errorMsg )
 {
     std::ofstream file;
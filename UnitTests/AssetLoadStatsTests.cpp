@@ -0,0 +1,186 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "AssetLoadStats.h"
+#include "BlockMeshFileInfo.h"
+#include "TextFile.h"
+
+#include <algorithm>
+#include <experimental/filesystem>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( AssetLoadStatsTests )
+	{
+	private:
+
+		static const std::string s_path;
+
+		// Path with a quote and a separator, which have to be escaped in CSV and JSON.
+		static const std::string s_meshPath;
+
+		// Records the whole loading of a basic asset.
+		static void recordLoading( AssetLoadStats& loadStats, const FileInfo& fileInfo, const unsigned long long bytesRead )
+		{
+			loadStats.registerCurrentThread( AssetLoadStats::ThreadRole::BasicParsing );
+
+			loadStats.onQueued( fileInfo );
+			loadStats.onReadStarted( fileInfo );
+			loadStats.onReadFinished( fileInfo, bytesRead, true );
+			loadStats.onParseStarted( fileInfo );
+			loadStats.onParseFinished( fileInfo, true );
+		}
+
+		// Note: Loaded data is null-terminated and may contain CR LF line endings (files are saved in text mode).
+		static std::string loadText( const std::string& path )
+		{
+			const auto data = TextFile::load( path );
+
+			std::experimental::filesystem::remove( path );
+
+			std::string text( data->data() );
+			text.erase( std::remove( text.begin(), text.end(), '\r' ), text.end() );
+
+			return text;
+		}
+
+		static std::vector< std::string > splitLines( const std::string& text )
+		{
+			std::vector< std::string > lines;
+
+			size_t lineStart = 0;
+			while ( lineStart < text.size() ) {
+				const size_t lineEnd = std::min( text.find( '\n', lineStart ), text.size() );
+				lines.push_back( text.substr( lineStart, lineEnd - lineStart ) );
+				lineStart = lineEnd + 1;
+			}
+
+			return lines;
+		}
+
+		static size_t countOccurences( const std::string& text, const std::string& pattern )
+		{
+			size_t count = 0;
+			for ( size_t position = text.find( pattern ); position != std::string::npos; position = text.find( pattern, position + 1 ) )
+				++count;
+
+			return count;
+		}
+
+	public:
+
+		TEST_METHOD( AssetLoadStats_Disabled_1 ) {
+			AssetLoadStats loadStats;
+
+			recordLoading( loadStats, BlockMeshFileInfo( s_meshPath, BlockMeshFileInfo::Format::OBJ ), 100 );
+
+			Assert::IsTrue( loadStats.getRecords().empty(), L"Events should be ignored when disabled" );
+			Assert::IsTrue( loadStats.getSamples().empty(), L"Samples should be ignored when disabled" );
+		}
+
+		TEST_METHOD( AssetLoadStats_Save_To_Csv_1 ) {
+			AssetLoadStats loadStats;
+			loadStats.setEnabled( true );
+
+			recordLoading( loadStats, BlockMeshFileInfo( s_meshPath, BlockMeshFileInfo::Format::OBJ, 2 ), 1234 );
+
+			loadStats.saveToCsv( s_path );
+			const std::vector< std::string > lines = splitLines( loadText( s_path ) );
+
+			Assert::AreEqual( (size_t)2, lines.size(), L"Expected a header and one row" );
+			Assert::AreEqual( (size_t)10, (size_t)std::count( lines[ 0 ].begin(), lines[ 0 ].end(), ';' ), L"Incorrect number of columns in the header" );
+
+			// Path's separator is quoted, so it's not counted as a column.
+			const std::string row = lines[ 1 ];
+			Assert::AreEqual( (size_t)11, (size_t)std::count( row.begin(), row.end(), ';' ), L"Incorrect number of separators in the row" );
+			Assert::IsTrue( row.find( ";\"my \"\"mesh\"\";1.obj\";2;1;" ) != std::string::npos, L"Path is not quoted or index in file/succeeded is incorrect" );
+			Assert::IsTrue( row.find( ";1234;" ) != std::string::npos, L"Incorrect number of bytes read" );
+		}
+
+		TEST_METHOD( AssetLoadStats_Save_Samples_To_Csv_1 ) {
+			AssetLoadStats loadStats;
+			loadStats.setEnabled( true );
+
+			recordLoading( loadStats, BlockMeshFileInfo( s_meshPath, BlockMeshFileInfo::Format::OBJ ), 100 );
+
+			const std::vector< AssetLoadStats::Sample > samples = loadStats.getSamples();
+
+			loadStats.saveSamplesToCsv( s_path );
+			const std::vector< std::string > lines = splitLines( loadText( s_path ) );
+
+			Assert::AreEqual( (size_t)5, samples.size(), L"Expected a sample for each change of the queues" );
+			Assert::AreEqual( samples.size() + 1, lines.size(), L"Expected a header and one row per sample" );
+
+			// Queued, read started, read finished, parse started, parse finished.
+			const char* expectedRowEnds[] = { ";1;0;0;0;0;0", ";0;0;0;1;0;0", ";0;1;0;0;0;0", ";0;0;0;0;1;0", ";0;0;0;0;0;0" };
+			for ( size_t i = 0; i < samples.size(); ++i ) {
+				const std::string& row         = lines[ i + 1 ];
+				const std::string  expectedEnd = expectedRowEnds[ i ];
+
+				Assert::IsTrue( row.size() > expectedEnd.size() && row.compare( row.size() - expectedEnd.size(), expectedEnd.size(), expectedEnd ) == 0,
+					( L"Incorrect sample " + std::to_wstring( i ) ).c_str() );
+			}
+		}
+
+		TEST_METHOD( AssetLoadStats_Save_To_Chrome_Trace_1 ) {
+			AssetLoadStats loadStats;
+			loadStats.setEnabled( true );
+
+			recordLoading( loadStats, BlockMeshFileInfo( s_meshPath, BlockMeshFileInfo::Format::OBJ ), 100 );
+
+			loadStats.saveToChromeTrace( s_path );
+			const std::string trace = loadText( s_path );
+
+			Assert::IsTrue( trace.compare( 0, 16, "{\"traceEvents\":[" ) == 0, L"Trace doesn't start with the event array" );
+			Assert::IsTrue( trace.find( "],\"displayTimeUnit\":\"ms\"}" ) != std::string::npos, L"Trace isn't closed" );
+			Assert::AreEqual( countOccurences( trace, "{" ), countOccurences( trace, "}" ), L"Unbalanced braces" );
+
+			// Stages which didn't happen (waiting for sub-assets, GPU upload) are skipped.
+			Assert::AreEqual( (size_t)2, countOccurences( trace, "\"ph\":\"X\"" ), L"Expected read and parse events" );
+			Assert::AreEqual( (size_t)1, countOccurences( trace, "\"ph\":\"M\"" ), L"Expected one named thread" );
+			Assert::AreEqual( (size_t)10, countOccurences( trace, "\"ph\":\"C\"" ), L"Expected two counters per sample" );
+
+			Assert::AreEqual( (size_t)2, countOccurences( trace, "my \\\"mesh\\\";1.obj" ), L"Path is not escaped" );
+			Assert::AreEqual( (size_t)2, countOccurences( trace, "\"bytes\":100," ), L"Incorrect number of bytes read" );
+		}
+
+		TEST_METHOD( AssetLoadStats_Record_Count_Limit_1 ) {
+			AssetLoadStats loadStats;
+			loadStats.setEnabled( true );
+
+			const size_t assetCount = 100 * 1024;
+			for ( size_t i = 0; i < assetCount; ++i ) {
+				const BlockMeshFileInfo fileInfo( "mesh" + std::to_string( i ) + ".obj", BlockMeshFileInfo::Format::OBJ );
+
+				// Multiple events of an asset which doesn't fit should be counted as one dropped record.
+				loadStats.onQueued( fileInfo );
+				loadStats.onDropped( fileInfo, false );
+			}
+
+			const size_t recordCount = loadStats.getRecords().size();
+
+			Assert::IsTrue( recordCount < assetCount, L"Number of records is not limited" );
+			Assert::AreEqual( assetCount, recordCount + loadStats.getDroppedRecordCount(), L"Incorrect number of dropped records" );
+
+			bool thrown = false;
+			try {
+				loadStats.getRecord( Asset::Type::BlockMesh, "mesh" + std::to_string( assetCount - 1 ) + ".obj" );
+			} catch ( const std::exception& ) {
+				thrown = true;
+			}
+
+			Assert::IsTrue( thrown, L"Dropped record should not be returned" );
+
+			loadStats.reset();
+
+			Assert::IsTrue( loadStats.getRecords().empty(), L"Records are not cleared on reset" );
+			Assert::AreEqual( (size_t)0, loadStats.getDroppedRecordCount(), L"Dropped records count is not cleared on reset" );
+		}
+	};
+
+	const std::string AssetLoadStatsTests::s_path     = "asset_load_stats_test.txt";
+	const std::string AssetLoadStatsTests::s_meshPath = "my \"mesh\";1.obj";
+}
@@ -7,6 +7,12 @@
 #include "BlockModel.h"
 #include "SkeletonModel.h"
 #include "SkeletonAnimation.h"
+#include "AssetPathManager.h"
+
+#include <experimental/filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
 
 //TODO: Add initialization of AssetManager to each test.
 //TODO: Look for reasons why these tests cause whole testing framework to fail. This may be the bug in VS 2013.
@@ -895,5 +901,285 @@ namespace UnitTests
 
  //           Assert::IsTrue( assetManager.isLoaded( Asset::Type::SkeletonAnimation, animPath, 0 ) );
  //       }
+	private:
+
+		static const std::string s_meshPath;
+		static const std::string s_largeMeshPath;
+		static const std::string s_corruptMeshPath;
+		static const std::string s_modelPath;
+
+		// Sub-assets are referenced by file name and searched for in the assets directory.
+		static const std::string s_modelMeshDirectory;
+		static const std::string s_modelMeshFileName;
+
+		// Writes a grid of ( gridSize x gridSize ) quads as an OBJ file.
+		static void writeGridMesh( const std::string& path, const int gridSize )
+		{
+			std::ofstream file( path );
+
+			for ( int y = 0; y <= gridSize; ++y ) {
+				for ( int x = 0; x <= gridSize; ++x )
+					file << "v " << x << " " << y << " 0\n";
+			}
+
+			const int rowSize = gridSize + 1;
+			for ( int y = 0; y < gridSize; ++y ) {
+				for ( int x = 0; x < gridSize; ++x ) {
+					const int index = y * rowSize + x + 1; // OBJ indices start from 1.
+					file << "f " << index << " " << index + 1 << " " << index + rowSize << "\n";
+					file << "f " << index + 1 << " " << index + rowSize + 1 << " " << index + rowSize << "\n";
+				}
+			}
+		}
+
+		static void writeModel( const std::string& path, const std::string& meshPath )
+		{
+			auto mesh = std::make_shared< BlockMesh >();
+			mesh->setFileInfo( BlockMeshFileInfo( meshPath, BlockMeshFileInfo::Format::OBJ ) );
+
+			BlockModel model;
+			model.setMesh( mesh );
+			model.saveToFile( path );
+		}
+
+		static void removeFiles()
+		{
+			std::experimental::filesystem::remove( s_meshPath );
+			std::experimental::filesystem::remove( s_largeMeshPath );
+			std::experimental::filesystem::remove( s_corruptMeshPath );
+			std::experimental::filesystem::remove( s_modelPath );
+			std::experimental::filesystem::remove_all( s_modelMeshDirectory );
+		}
+
+		// Returns false on timeout.
+		static bool waitUntil( const std::function< bool() >& condition, const float timeout = 30.0f )
+		{
+			const auto timeoutTime = std::chrono::steady_clock::now() + std::chrono::milliseconds( (long long)( timeout * 1000.0f ) );
+
+			while ( !condition() ) {
+				if ( std::chrono::steady_clock::now() > timeoutTime )
+					return false;
+
+				std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			}
+
+			return true;
+		}
+
+		static bool isReady( const AssetManager::AssetFuture& future )
+		{
+			return future.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+		}
+
+	public:
+
+		TEST_METHOD( AssetManager_Is_Loaded_1 ) {
+			writeGridMesh( s_meshPath, 2 );
+
+			const BlockMeshFileInfo fileInfo( s_meshPath, BlockMeshFileInfo::Format::OBJ );
+
+			{
+				AssetManager assetManager;
+				assetManager.initialize( 1, 1, nullptr );
+
+				Assert::IsFalse( assetManager.isLoaded( fileInfo.getAssetId() ), L"Mesh is loaded before loading" );
+
+				assetManager.loadAsync( fileInfo );
+
+				Assert::IsNotNull( assetManager.getWhenLoaded( fileInfo.getAssetId() ).get(), L"Mesh failed to load" );
+				Assert::IsTrue( assetManager.isLoaded( fileInfo.getAssetId() ), L"Mesh is not loaded" );
+				Assert::IsTrue( assetManager.isLoaded( Asset::Type::BlockMesh, s_meshPath ), L"Mesh is not loaded (by path)" );
+
+				assetManager.unloadAll();
+
+				Assert::IsFalse( assetManager.isLoaded( fileInfo.getAssetId() ), L"Mesh is loaded after unloading" );
+				Assert::IsNull( assetManager.get( fileInfo.getAssetId() ).get(), L"Unloaded mesh was returned" );
+
+				assetManager.loadAsync( fileInfo );
+
+				Assert::IsNotNull( assetManager.getWhenLoaded( fileInfo.getAssetId() ).get(), L"Mesh failed to load again" );
+				Assert::IsTrue( assetManager.isLoaded( fileInfo.getAssetId() ), L"Mesh is not loaded again" );
+			}
+
+			removeFiles();
+		}
+
+		TEST_METHOD( AssetManager_Get_When_Loaded_Failure_1 ) {
+			// Missing file fails while reading, corrupt file fails while parsing.
+			{ std::ofstream file( s_corruptMeshPath ); file << "ab"; } // Too short even for the header.
+
+			const BlockMeshFileInfo missingFileInfo( "missing.obj", BlockMeshFileInfo::Format::OBJ );
+			const BlockMeshFileInfo corruptFileInfo( s_corruptMeshPath, BlockMeshFileInfo::Format::BLOCKMESH );
+
+			const float timeout = 30.0f;
+			const int   waitingThreadCount = 4;
+
+			std::vector< std::shared_ptr< Asset > > assets( waitingThreadCount * 2, std::make_shared< BlockMesh >() );
+			std::vector< std::thread >             waitingThreads;
+
+			const auto startTime = std::chrono::steady_clock::now();
+
+			{
+				AssetManager assetManager;
+
+				// Queue the assets before the worker threads start, so the waiting threads are waiting before they fail.
+				assetManager.loadAsync( missingFileInfo );
+				assetManager.loadAsync( corruptFileInfo );
+
+				for ( int i = 0; i < waitingThreadCount; ++i ) {
+					waitingThreads.emplace_back( [ &, i ]() { assets[ i * 2 ]     = assetManager.getWhenLoaded( missingFileInfo.getAssetId(), timeout ); } );
+					waitingThreads.emplace_back( [ &, i ]() { assets[ i * 2 + 1 ] = assetManager.getWhenLoaded( corruptFileInfo.getAssetId(), timeout ); } );
+				}
+
+				std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+
+				assetManager.initialize( 1, 1, nullptr );
+
+				for ( auto& thread : waitingThreads )
+					thread.join();
+
+				Assert::IsFalse( assetManager.isLoadedOrLoading( missingFileInfo.getAssetId() ), L"Failed asset is still loading" );
+				Assert::IsFalse( assetManager.isLoadedOrLoading( corruptFileInfo.getAssetId() ), L"Failed asset is still loading" );
+			}
+
+			const float waitTime = std::chrono::duration< float >( std::chrono::steady_clock::now() - startTime ).count();
+
+			removeFiles();
+
+			for ( const auto& asset : assets )
+				Assert::IsNull( asset.get(), L"Waiting thread didn't get nullptr for a failed asset" );
+
+			Assert::IsTrue( waitTime < timeout / 2.0f, L"Waiting threads were not woken up on failure" );
+		}
+
+		TEST_METHOD( AssetManager_Cancel_Queued_1 ) {
+			writeGridMesh( s_meshPath, 2 );
+
+			const BlockMeshFileInfo fileInfo( s_meshPath, BlockMeshFileInfo::Format::OBJ );
+
+			{
+				AssetManager assetManager;
+				assetManager.getLoadStats().setEnabled( true );
+
+				// Worker threads are not started yet, so the request stays in the queue.
+				const AssetManager::AssetFuture future = assetManager.loadAsync( fileInfo );
+
+				Assert::IsTrue( assetManager.cancel( fileInfo.getAssetId() ), L"Queued asset was not cancelled" );
+				Assert::IsTrue( isReady( future ), L"Future of the cancelled asset is not ready" );
+				Assert::IsNull( future.get().get(), L"Future of the cancelled asset holds an asset" );
+				Assert::IsFalse( assetManager.isLoadedOrLoading( fileInfo.getAssetId() ), L"Cancelled asset is still loading" );
+				Assert::IsFalse( assetManager.cancel( fileInfo.getAssetId() ), L"Asset was cancelled twice" );
+
+				assetManager.initialize( 1, 1, nullptr );
+
+				// Cancelled request is dropped by the reading thread without reading the file.
+				Assert::IsTrue( waitUntil( [ & ]() { return assetManager.getLoadStats().getRecord( Asset::Type::BlockMesh, s_meshPath ).finished; } ), 
+					L"Cancelled request was not dropped" );
+
+				const AssetLoadStats::AssetRecord record = assetManager.getLoadStats().getRecord( Asset::Type::BlockMesh, s_meshPath );
+				Assert::IsTrue( record.readStartTime < 0.0, L"Cancelled asset was read" );
+				Assert::IsFalse( assetManager.isLoadedOrLoading( fileInfo.getAssetId() ), L"Cancelled asset was loaded" );
+
+				// Cancelled asset can be loaded again.
+				assetManager.loadAsync( fileInfo );
+				Assert::IsNotNull( assetManager.getWhenLoaded( fileInfo.getAssetId() ).get(), L"Asset failed to load after being cancelled" );
+				Assert::IsFalse( assetManager.cancel( fileInfo.getAssetId() ), L"Loaded asset was cancelled" );
+				Assert::IsTrue( assetManager.isLoaded( fileInfo.getAssetId() ), L"Loaded asset was unloaded by cancel" );
+			}
+
+			removeFiles();
+		}
+
+		TEST_METHOD( AssetManager_Unload_All_While_Parsing_1 ) {
+			writeGridMesh( s_largeMeshPath, 64 );
+
+			const BlockMeshFileInfo fileInfo( s_largeMeshPath, BlockMeshFileInfo::Format::OBJ );
+
+			{
+				AssetManager assetManager;
+				assetManager.getLoadStats().setEnabled( true );
+				assetManager.initialize( 1, 1, nullptr );
+
+				const AssetManager::AssetFuture future = assetManager.loadAsync( fileInfo );
+
+				Assert::IsTrue( waitUntil( [ & ]() { return assetManager.getLoadStats().getRecord( Asset::Type::BlockMesh, s_largeMeshPath ).parseStartTime >= 0.0; } ), 
+					L"Asset was not parsed" );
+
+				assetManager.unloadAll();
+
+				// Parsing has to be finished when unloadAll returns and its result discarded.
+				const AssetLoadStats::AssetRecord record = assetManager.getLoadStats().getRecord( Asset::Type::BlockMesh, s_largeMeshPath );
+				Assert::IsTrue( record.parseEndTime >= 0.0, L"unloadAll didn't wait for the asset being parsed" );
+
+				Assert::IsTrue( isReady( future ), L"Future of the unloaded asset is not ready" );
+				Assert::IsNull( future.get().get(), L"Future of the unloaded asset holds an asset" );
+				Assert::IsFalse( assetManager.isLoadedOrLoading( fileInfo.getAssetId() ), L"Asset parsed during unloadAll was loaded" );
+
+				std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+
+				Assert::IsFalse( assetManager.isLoadedOrLoading( fileInfo.getAssetId() ), L"Asset parsed during unloadAll was loaded afterwards" );
+			}
+
+			removeFiles();
+		}
+
+		TEST_METHOD( AssetManager_Unload_All_Sub_Asset_Generation_1 ) {
+			std::experimental::filesystem::create_directories( s_modelMeshDirectory );
+			writeGridMesh( ( std::experimental::filesystem::path( s_modelMeshDirectory ) / s_modelMeshFileName ).string(), 64 );
+			writeModel( s_modelPath, s_modelMeshFileName );
+
+			const BlockModelFileInfo modelFileInfo( s_modelPath, BlockModelFileInfo::Format::BLOCKMODEL );
+			const std::string        meshPath = AssetPathManager::get().getPathForFileName( s_modelMeshFileName );
+			const Asset::Id          meshId   = BlockMeshFileInfo( meshPath, BlockMeshFileInfo::Format::OBJ ).getAssetId();
+
+			{
+				AssetManager assetManager;
+				assetManager.getLoadStats().setEnabled( true );
+				assetManager.initialize( 1, 1, nullptr );
+
+				// Unload while the model waits for its mesh - the mesh requested in the old generation is being loaded.
+				assetManager.loadAsync( modelFileInfo );
+
+				Assert::IsTrue( waitUntil( [ & ]() { return assetManager.getLoadStats().getRecord( Asset::Type::BlockModel, s_modelPath ).subAssetsWaitStartTime >= 0.0; } ), 
+					L"Model didn't request its mesh" );
+
+				assetManager.unloadAll();
+
+				Assert::IsFalse( assetManager.isLoadedOrLoading( modelFileInfo.getAssetId() ), L"Model was not unloaded" );
+				Assert::IsFalse( assetManager.isLoadedOrLoading( meshId ), L"Mesh of the old generation leaked into the new one" );
+
+				// Unload at different stages of loading the model - the mesh may be requested after unloadAll started.
+				for ( int delay = 0; delay <= 20; delay += 2 ) {
+					assetManager.loadAsync( modelFileInfo );
+					std::this_thread::sleep_for( std::chrono::milliseconds( delay ) );
+					assetManager.unloadAll();
+
+					Assert::IsFalse( assetManager.isLoadedOrLoading( modelFileInfo.getAssetId() ), L"Model was not unloaded" );
+					Assert::IsFalse( assetManager.isLoadedOrLoading( meshId ), L"Mesh of the old generation leaked into the new one" );
+				}
+
+				std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+
+				Assert::IsFalse( assetManager.isLoadedOrLoading( meshId ), L"Mesh of the old generation was loaded afterwards" );
+
+				// Sub-assets of the current generation are still loaded.
+				assetManager.loadAsync( modelFileInfo );
+
+				const auto model = std::dynamic_pointer_cast< BlockModel >( assetManager.getWhenLoaded( modelFileInfo.getAssetId(), 60.0f ) );
+				Assert::IsNotNull( model.get(), L"Model failed to load" );
+				Assert::IsTrue( assetManager.isLoaded( meshId ), L"Mesh was not loaded with the model" );
+				Assert::IsTrue( model->getMesh() == assetManager.get( meshId ), L"Model doesn't use the loaded mesh" );
+			}
+
+			removeFiles();
+		}
     };
-}
\ No newline at end of file
+
+	const std::string AssetManagerTests::s_meshPath        = "asset_manager_test_mesh.obj";
+	const std::string AssetManagerTests::s_largeMeshPath   = "asset_manager_test_large_mesh.obj";
+	const std::string AssetManagerTests::s_corruptMeshPath = "asset_manager_test_corrupt_mesh.blockmesh";
+	const std::string AssetManagerTests::s_modelPath       = "asset_manager_test_model.blockmodel";
+
+	const std::string AssetManagerTests::s_modelMeshDirectory = "Assets/AssetManagerTests";
+	const std::string AssetManagerTests::s_modelMeshFileName  = "asset_manager_test_model_mesh.obj";
+}
@@ -0,0 +1,136 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "BinaryFileWriter.h"
+#include "BinaryFileReader.h"
+
+#include <algorithm>
+#include <experimental/filesystem>
+#include <numeric>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( BinaryFileWriterTests )
+	{
+	private:
+
+		static const std::string s_path;
+
+		// Writes values of different sizes: small values, an array crossing the buffer boundary, padding crossing the buffer boundary
+		// and a large array starting in the middle of the buffer (written partly through the buffer, partly directly in aligned chunks).
+		static void writeTestData( BinaryFileWriter& writer, const std::vector< int >& smallArray, const std::vector< char >& largeArray )
+		{
+			writer.write( 42 );
+			writer.write( 1.5f );
+			writer.writeArray( smallArray );
+			writer.writeZeros( BinaryFileWriter::s_bufferSize + 7 );
+			writer.write( (char)1 );
+			writer.writeArray( largeArray );
+			writer.write( 0x0123456789ABCDEFull );
+		}
+
+		static void assertTestData( BinaryFileReader& reader, const std::vector< int >& smallArray, const std::vector< char >& largeArray )
+		{
+			Assert::AreEqual( 42, reader.read< int >(), L"Incorrect int" );
+			Assert::AreEqual( 1.5f, reader.read< float >(), L"Incorrect float" );
+
+			std::vector< int > readSmallArray;
+			reader.readArray( readSmallArray, (int)smallArray.size() );
+			Assert::IsTrue( readSmallArray == smallArray, L"Incorrect array crossing the buffer boundary" );
+
+			std::vector< char > padding;
+			reader.readArray( padding, (int)BinaryFileWriter::s_bufferSize + 7 );
+			Assert::IsTrue( std::all_of( padding.begin(), padding.end(), []( const char value ) { return value == 0; } ), L"Padding is not zeroed" );
+
+			Assert::AreEqual( (char)1, reader.read< char >(), L"Incorrect char after padding" );
+
+			std::vector< char > readLargeArray;
+			reader.readArray( readLargeArray, (int)largeArray.size() );
+			Assert::IsTrue( readLargeArray == largeArray, L"Incorrect large array" );
+
+			Assert::IsTrue( 0x0123456789ABCDEFull == reader.read< unsigned long long >(), L"Incorrect value after the large array" );
+			Assert::AreEqual( 0ull, reader.getRemainingSize(), L"Unexpected data at the end" );
+		}
+
+	public:
+
+		TEST_METHOD( BinaryFileWriter_File_Round_Trip_1 ) {
+			std::vector< int > smallArray( BinaryFileWriter::s_bufferSize / sizeof( int ) + 3 );
+			std::iota( smallArray.begin(), smallArray.end(), 0 );
+
+			std::vector< char > largeArray( BinaryFileWriter::s_bufferSize * 3 + 11 );
+			for ( size_t i = 0; i < largeArray.size(); ++i )
+				largeArray[ i ] = (char)( i * 7 + i / 251 );
+
+			unsigned long long size = 0;
+			try {
+				BinaryFileWriter writer( s_path );
+				writeTestData( writer, smallArray, largeArray );
+				size = writer.getPosition();
+				writer.close();
+			} catch ( ... ) {
+				std::experimental::filesystem::remove( s_path );
+				Assert::Fail( L"BinaryFileWriter threw an exception" );
+			}
+
+			Assert::AreEqual( size, (unsigned long long)std::experimental::filesystem::file_size( s_path ), L"Incorrect file size" );
+
+			try {
+				BinaryFileReader reader( s_path );
+				assertTestData( reader, smallArray, largeArray );
+			} catch ( const std::exception& ) {
+				std::experimental::filesystem::remove( s_path );
+				Assert::Fail( L"BinaryFileReader threw an exception" );
+			}
+
+			std::experimental::filesystem::remove( s_path );
+		}
+
+		TEST_METHOD( BinaryFileWriter_Memory_Matches_File_1 ) {
+			std::vector< int > smallArray( 1000, 5 );
+			std::vector< char > largeArray( BinaryFileWriter::s_bufferSize * 2, 3 );
+
+			std::vector< char > memoryData;
+			BinaryFileWriter memoryWriter( memoryData );
+			writeTestData( memoryWriter, smallArray, largeArray );
+			memoryWriter.close();
+
+			Assert::AreEqual( (unsigned long long)memoryData.size(), memoryWriter.getPosition(), L"Incorrect position of the memory writer" );
+
+			BinaryFileReader memoryReader( memoryData.cbegin(), memoryData.cend() );
+			assertTestData( memoryReader, smallArray, largeArray );
+
+			BinaryFileWriter fileWriter( s_path );
+			writeTestData( fileWriter, smallArray, largeArray );
+			fileWriter.close();
+
+			std::vector< char > fileData;
+			{
+				BinaryFileReader fileReader( s_path );
+				fileReader.readArray( fileData, (int)fileReader.getSize() );
+			}
+
+			std::experimental::filesystem::remove( s_path );
+
+			Assert::IsTrue( fileData == memoryData, L"File and memory writers produced different data" );
+		}
+
+		TEST_METHOD( BinaryFileWriter_Discard_Without_Close_1 ) {
+			{
+				BinaryFileWriter writer( s_path );
+				writer.write( 42 );
+			}
+
+			const unsigned long long size = (unsigned long long)std::experimental::filesystem::file_size( s_path );
+
+			std::experimental::filesystem::remove( s_path );
+
+			Assert::AreEqual( 0ull, size, L"Buffered data should be discarded if the writer wasn't closed" );
+		}
+	};
+
+	const std::string BinaryFileWriterTests::s_path = "binary_file_writer_test.bin";
+}
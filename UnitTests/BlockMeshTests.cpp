@@ -2,6 +2,7 @@
 #include "CppUnitTest.h"
 
 #include "BlockMesh.h"
+#include "BVHTreeBuffer.h"
 //#include "OBJMeshFileParser.h"
 #include "MathUtil.h"
 
@@ -236,6 +237,35 @@ namespace UnitTests {
 				);
 		}
 
+		TEST_METHOD( Mesh_Saving_And_Loading_Own_Format_1 ) {
+
+			std::shared_ptr<BlockMesh> mesh = nullptr;
+			std::shared_ptr<BlockMesh> loadedMesh = nullptr;
+
+			const std::string path = "TestAssets/Meshes/Basic/triangle_test_output.blockmesh";
+
+			try {
+				mesh = BlockMesh::createFromFile( "TestAssets/Meshes/Basic/triangle.obj", BlockMeshFileInfo::Format::OBJ ).front( );
+				mesh->buildBvhTree();
+				mesh->saveToFile( path, BlockMeshFileInfo::Format::BLOCKMESH );
+
+				loadedMesh = BlockMesh::createFromFile( path, BlockMeshFileInfo::Format::BLOCKMESH, 0 );
+			} catch ( ... ) {
+				std::experimental::filesystem::remove( path );
+				Assert::Fail( L"BlockMesh::saveToFile() or BlockMesh::createFromFile() threw an exception" );
+			}
+
+			std::experimental::filesystem::remove( path );
+
+			Assert::IsTrue( loadedMesh->getVertices() == mesh->getVertices(), L"Loaded mesh vertices are incorrect" );
+			Assert::IsTrue( loadedMesh->getNormals() == mesh->getNormals(), L"Loaded mesh normals are incorrect" );
+			Assert::AreEqual( loadedMesh->getTexcoordsCount(), mesh->getTexcoordsCount(), L"Incorrect number of texcoord sets in loaded mesh" );
+			Assert::IsTrue( loadedMesh->getTexcoords( 0 ) == mesh->getTexcoords( 0 ), L"Loaded mesh texcoords are incorrect" );
+			Assert::IsTrue( loadedMesh->getTriangles() == mesh->getTriangles(), L"Loaded mesh triangles are incorrect" );
+			Assert::IsTrue( loadedMesh->getBvhTree() != nullptr, L"Loaded mesh has no BVH tree" );
+			Assert::AreEqual( (int)loadedMesh->getBvhTree()->getNodes().size(), (int)mesh->getBvhTree()->getNodes().size(), L"Loaded mesh BVH tree is incorrect" );
+		}
+
 		TEST_METHOD( Mesh_Loading_From_File_3 ) {
 
 			std::shared_ptr<BlockMesh> mesh = nullptr;
@@ -0,0 +1,218 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TestUtil.h"
+
+#include "DerivedDataCache.h"
+#include "BlockMesh.h"
+#include "BVHTreeBuffer.h"
+#include "MeshletBuffer.h"
+#include "BinaryFile.h"
+
+#include <experimental/filesystem>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( DerivedDataCacheTests )
+	{
+	private:
+
+		static const std::string s_directory;
+
+		// Returns an OBJ file with two grids of ( gridSize x gridSize ) quads (with normals and texcoords) as separate objects.
+		static std::vector< char > createObjData( const int gridSize )
+		{
+			std::string text;
+
+			for ( int objectIdx = 0; objectIdx < 2; ++objectIdx ) {
+				const int rowSize     = gridSize + 1;
+				const int firstVertex = objectIdx * rowSize * rowSize + 1; // OBJ indices start from 1.
+
+				text += "o Grid" + std::to_string( objectIdx ) + "\n";
+
+				for ( int y = 0; y <= gridSize; ++y ) {
+					for ( int x = 0; x <= gridSize; ++x ) {
+						text += "v " + std::to_string( x ) + " " + std::to_string( objectIdx ) + " " + std::to_string( y ) + "\n";
+						text += "vn 0 1 0\n";
+						text += "vt " + std::to_string( (float)x / gridSize ) + " " + std::to_string( (float)y / gridSize ) + "\n";
+					}
+				}
+
+				for ( int y = 0; y < gridSize; ++y ) {
+					for ( int x = 0; x < gridSize; ++x ) {
+						const int index = firstVertex + y * rowSize + x;
+
+						text += face( index, index + rowSize, index + 1 );
+						text += face( index + 1, index + rowSize, index + rowSize + 1 );
+					}
+				}
+			}
+
+			return std::vector< char >( text.begin(), text.end() );
+		}
+
+		static std::string face( const int index0, const int index1, const int index2 )
+		{
+			std::string text = "f";
+			for ( const int index : { index0, index1, index2 } )
+				text += " " + std::to_string( index ) + "/" + std::to_string( index ) + "/" + std::to_string( index );
+
+			return text + "\n";
+		}
+
+		static std::vector< std::shared_ptr< BlockMesh > > getOrImport( const std::vector< char >& data )
+		{
+			return DerivedDataCache::getOrImportBlockMeshes( data.cbegin(), data.cend(), BlockMeshFileInfo::Format::OBJ, false, false, false );
+		}
+
+		static std::vector< std::string > getEntryPaths()
+		{
+			std::vector< std::string > paths;
+			for ( const auto& entry : std::experimental::filesystem::directory_iterator( s_directory ) )
+				paths.push_back( entry.path().string() );
+
+			return paths;
+		}
+
+		// Entry is only replaced on a cache miss - an old write time shows that it was read instead.
+		static void setOldWriteTime( const std::string& path )
+		{
+			std::experimental::filesystem::last_write_time( path, std::experimental::filesystem::last_write_time( path ) - std::chrono::hours( 1 ) );
+		}
+
+		static bool isWriteTimeOld( const std::string& path )
+		{
+			return std::experimental::filesystem::last_write_time( path ) < std::experimental::filesystem::file_time_type::clock::now() - std::chrono::minutes( 30 );
+		}
+
+		static void assertIdentical( const std::vector< std::shared_ptr< BlockMesh > >& expectedMeshes, const std::vector< std::shared_ptr< BlockMesh > >& meshes )
+		{
+			Assert::AreEqual( expectedMeshes.size(), meshes.size(), L"Incorrect number of meshes" );
+
+			for ( size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx ) {
+				const BlockMesh& expected = *expectedMeshes[ meshIdx ];
+				const BlockMesh& mesh     = *meshes[ meshIdx ];
+
+				Assert::IsTrue( TestUtil::areIdentical( expected.getVertices(), mesh.getVertices() ), L"Vertices are different" );
+				Assert::IsTrue( TestUtil::areIdentical( expected.getNormals(), mesh.getNormals() ), L"Normals are different" );
+				Assert::IsTrue( TestUtil::areIdentical( expected.getTangents(), mesh.getTangents() ), L"Tangents are different" );
+				Assert::AreEqual( expected.getTexcoordsCount(), mesh.getTexcoordsCount(), L"Incorrect number of texcoord sets" );
+				for ( int setIdx = 0; setIdx < mesh.getTexcoordsCount(); ++setIdx )
+					Assert::IsTrue( TestUtil::areIdentical( expected.getTexcoords( setIdx ), mesh.getTexcoords( setIdx ) ), L"Texcoords are different" );
+				Assert::IsTrue( TestUtil::areIdentical( expected.getTriangles(), mesh.getTriangles() ), L"Triangles are different" );
+
+				Assert::IsTrue( expected.getBoundingBox().getMin() == mesh.getBoundingBox().getMin()
+					&& expected.getBoundingBox().getMax() == mesh.getBoundingBox().getMax(), L"Bounding boxes are different" );
+
+				Assert::IsNotNull( mesh.getBvhTree().get(), L"BVH tree is missing" );
+				Assert::IsTrue( TestUtil::areIdentical( expected.getBvhTree()->getNodes(), mesh.getBvhTree()->getNodes() ), L"BVH nodes are different" );
+				Assert::IsTrue( TestUtil::areIdentical( expected.getBvhTree()->getNodesExtents(), mesh.getBvhTree()->getNodesExtents() ), L"BVH node extents are different" );
+				Assert::IsTrue( TestUtil::areIdentical( expected.getBvhTree()->getTriangles(), mesh.getBvhTree()->getTriangles() ), L"BVH triangles are different" );
+
+				Assert::IsNotNull( mesh.getMeshlets().get(), L"Meshlets are missing" );
+				Assert::IsTrue( TestUtil::areIdentical( expected.getMeshlets()->getMeshlets(), mesh.getMeshlets()->getMeshlets() ), L"Meshlets are different" );
+				Assert::IsTrue( TestUtil::areIdentical( expected.getMeshlets()->getVertices(), mesh.getMeshlets()->getVertices() ), L"Meshlet vertices are different" );
+				Assert::IsTrue( TestUtil::areIdentical( expected.getMeshlets()->getTriangles(), mesh.getMeshlets()->getTriangles() ), L"Meshlet triangles are different" );
+			}
+		}
+
+	public:
+
+		TEST_METHOD_INITIALIZE( initTest ) {
+			std::experimental::filesystem::remove_all( s_directory );
+
+			DerivedDataCache::setDirectory( s_directory );
+		}
+
+		TEST_METHOD_CLEANUP( cleanupTest ) {
+			DerivedDataCache::setEnabled( false );
+
+			std::experimental::filesystem::remove_all( s_directory );
+		}
+
+		TEST_METHOD( DerivedDataCache_Miss_Matches_Import_1 ) {
+			const std::vector< char > data = createObjData( 24 );
+
+			// Meshes are processed the same way when the cache is disabled.
+			DerivedDataCache::setEnabled( false );
+			const std::vector< std::shared_ptr< BlockMesh > > importedMeshes = getOrImport( data );
+
+			Assert::IsFalse( std::experimental::filesystem::exists( s_directory ), L"Entry was saved while the cache was disabled" );
+			Assert::AreEqual( (size_t)2, importedMeshes.size(), L"Incorrect number of imported meshes" );
+			Assert::IsNotNull( importedMeshes[ 0 ]->getMeshlets().get(), L"Meshes were not processed while the cache was disabled" );
+			Assert::IsTrue( importedMeshes[ 0 ]->getMeshlets()->getMeshlets().size() > 1, L"Mesh should be split into several meshlets" );
+
+			DerivedDataCache::setEnabled( true );
+			const std::vector< std::shared_ptr< BlockMesh > > meshes = getOrImport( data );
+
+			Assert::AreEqual( (size_t)1, getEntryPaths().size(), L"Entry was not saved on a cache miss" );
+
+			assertIdentical( importedMeshes, meshes );
+		}
+
+		TEST_METHOD( DerivedDataCache_Hit_1 ) {
+			const std::vector< char > data = createObjData( 24 );
+
+			const std::vector< std::shared_ptr< BlockMesh > > importedMeshes = getOrImport( data );
+
+			DerivedDataCache::setEnabled( true );
+			getOrImport( data );
+
+			const std::string entryPath = getEntryPaths().front();
+			setOldWriteTime( entryPath );
+
+			const std::vector< std::shared_ptr< BlockMesh > > meshes = getOrImport( data );
+
+			Assert::IsTrue( isWriteTimeOld( entryPath ), L"Entry was replaced instead of being read" );
+			Assert::AreEqual( (size_t)1, getEntryPaths().size(), L"Unexpected entries in the cache" );
+
+			assertIdentical( importedMeshes, meshes );
+
+			// Different import flags result in a separate entry.
+			DerivedDataCache::getOrImportBlockMeshes( data.cbegin(), data.cend(), BlockMeshFileInfo::Format::OBJ, true, false, false );
+
+			Assert::AreEqual( (size_t)2, getEntryPaths().size(), L"Entry was not saved for different import flags" );
+		}
+
+		TEST_METHOD( DerivedDataCache_Corrupt_Entry_1 ) {
+			const std::vector< char > data = createObjData( 24 );
+
+			const std::vector< std::shared_ptr< BlockMesh > > importedMeshes = getOrImport( data );
+
+			DerivedDataCache::setEnabled( true );
+			getOrImport( data );
+
+			const std::string                          entryPath = getEntryPaths().front();
+			const std::shared_ptr< std::vector< char > > entry   = BinaryFile::load( entryPath );
+
+			std::vector< std::vector< char > > corruptedEntries;
+
+			// Changed byte in the middle of the meshes.
+			corruptedEntries.push_back( *entry );
+			corruptedEntries.back()[ entry->size() / 2 ] ^= 0x10;
+
+			// Truncated entry - ex: left by a crashed process.
+			corruptedEntries.push_back( std::vector< char >( entry->begin(), entry->begin() + entry->size() / 2 ) );
+
+			// Entry smaller than the header.
+			corruptedEntries.push_back( std::vector< char >( entry->begin(), entry->begin() + 10 ) );
+
+			// Extra data at the end.
+			corruptedEntries.push_back( *entry );
+			corruptedEntries.back().resize( entry->size() + 100, 0 );
+
+			for ( std::vector< char >& corruptedEntry : corruptedEntries ) {
+				BinaryFile::save( entryPath, corruptedEntry );
+
+				// Corrupted entry is a cache miss - meshes are imported again and the entry is replaced.
+				assertIdentical( importedMeshes, getOrImport( data ) );
+
+				Assert::IsTrue( *BinaryFile::load( entryPath ) == *entry, L"Corrupted entry was not replaced" );
+			}
+		}
+	};
+
+	const std::string DerivedDataCacheTests::s_directory = "derived_data_cache_test";
+}
@@ -0,0 +1,128 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "FileSaveQueue.h"
+#include "BinaryFile.h"
+
+#include <atomic>
+#include <chrono>
+#include <experimental/filesystem>
+#include <future>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( FileSaveQueueTests )
+	{
+	private:
+
+		static const std::string s_path;
+
+		static std::vector< char > toData( const std::string& text )
+		{
+			return std::vector< char >( text.begin(), text.end() );
+		}
+
+		static std::string loadText( const std::string& path )
+		{
+			const std::shared_ptr< std::vector< char > > data = BinaryFile::load( path );
+
+			return std::string( data->begin(), data->end() );
+		}
+
+	public:
+
+		TEST_METHOD( FileSaveQueue_Saves_In_Order_1 ) {
+			std::vector< std::string > savedPaths;
+			{
+				FileSaveQueue queue;
+				queue.setOnSaved( [ &savedPaths ]( const std::string& path ) { savedPaths.push_back( path ); } );
+
+				queue.enqueue( s_path, toData( "first" ) );
+				queue.enqueue( s_path, [ ]( const std::string& tempPath ) {
+					std::vector< char > data = toData( "second" );
+					BinaryFile::save( tempPath, data );
+				} );
+				queue.waitUntilIdle();
+
+				Assert::IsTrue( queue.takeFailedSaves().empty(), L"No save should fail" );
+			}
+
+			const std::string text           = loadText( s_path );
+			const bool        tempFileExists = std::experimental::filesystem::exists( s_path + ".tmp" );
+
+			std::experimental::filesystem::remove( s_path );
+
+			Assert::AreEqual( std::string( "second" ), text, L"The last queued save should win" );
+			Assert::IsFalse( tempFileExists, L"Temporary file should be renamed" );
+			Assert::AreEqual( 2, (int)savedPaths.size(), L"Each save should be reported" );
+			Assert::AreEqual( s_path, savedPaths.back(), L"Saved file should be reported with its final path" );
+		}
+
+		TEST_METHOD( FileSaveQueue_Failed_Save_1 ) {
+			FileSaveQueue queue;
+
+			queue.enqueue( s_path, toData( "valid" ) );
+			queue.enqueue( s_path, [ ]( const std::string& tempPath ) {
+				std::vector< char > data = toData( "partial" );
+				BinaryFile::save( tempPath, data );
+				throw std::exception( "Save failed." );
+			} );
+			queue.waitUntilIdle();
+
+			const std::vector< FileSaveQueue::FailedSave > failedSaves = queue.takeFailedSaves();
+
+			const std::string text           = loadText( s_path );
+			const bool        tempFileExists = std::experimental::filesystem::exists( s_path + ".tmp" );
+
+			std::experimental::filesystem::remove( s_path );
+
+			Assert::AreEqual( 1, (int)failedSaves.size(), L"Failed save should be reported" );
+			Assert::AreEqual( s_path, failedSaves[ 0 ].path, L"Failed save has incorrect path" );
+			Assert::AreEqual( std::string( "valid" ), text, L"Failed save shouldn't replace the file" );
+			Assert::IsFalse( tempFileExists, L"Temporary file of a failed save should be deleted" );
+			Assert::IsTrue( queue.takeFailedSaves().empty(), L"Failed saves should be reported only once" );
+		}
+
+		TEST_METHOD( FileSaveQueue_Wait_Until_Saved_1 ) {
+			FileSaveQueue queue;
+
+			const int source      = 0;
+			const int otherSource = 0;
+
+			std::promise< void >       releaseSave;
+			std::shared_future< void > saveReleased = releaseSave.get_future().share();
+			std::atomic< bool >        saved( false );
+
+			queue.enqueue( s_path, [ saveReleased, &saved ]( const std::string& tempPath ) {
+				saveReleased.wait();
+
+				std::vector< char > data = toData( "data" );
+				BinaryFile::save( tempPath, data );
+				saved = true;
+			}, &source );
+
+			// Saves of other data don't block.
+			queue.waitUntilSaved( &otherSource );
+			queue.waitUntilSaved( nullptr );
+
+			Assert::IsFalse( saved, L"Waiting for other data shouldn't wait for the save" );
+
+			std::future< void > waitResult = std::async( std::launch::async, [ &queue, &source ]() { queue.waitUntilSaved( &source ); } );
+
+			Assert::IsTrue( waitResult.wait_for( std::chrono::milliseconds( 100 ) ) == std::future_status::timeout, L"Waiting for the saved data should block" );
+
+			releaseSave.set_value();
+			waitResult.get();
+
+			Assert::IsTrue( saved, L"Waiting for the saved data should return after the save" );
+
+			queue.waitUntilIdle();
+			std::experimental::filesystem::remove( s_path );
+		}
+	};
+
+	const std::string FileSaveQueueTests::s_path = "file_save_queue_test.bin";
+}
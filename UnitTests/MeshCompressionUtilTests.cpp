@@ -0,0 +1,258 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TestUtil.h"
+
+#include "MeshCompressionUtil.h"
+#include "MeshFileParser.h"
+#include "MeshUtil.h"
+#include "BlockMesh.h"
+#include "BVHTreeBuffer.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( MeshCompressionUtilTests )
+	{
+	private:
+
+		// Returns a grid of vertices ( size x size ) with slightly displaced positions, normals and tangents.
+		static std::shared_ptr< BlockMesh > createGridMesh( const int size, const float3& offset, const float scale )
+		{
+			std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( size );
+
+			std::mt19937                            random( 7 );
+			std::uniform_real_distribution< float > displacement( -0.25f, 0.25f );
+
+			for ( size_t vertexIdx = 0; vertexIdx < mesh->getVertices().size(); ++vertexIdx ) {
+				const float height = displacement( random );
+
+				mesh->getVertices()[ vertexIdx ] = offset + ( mesh->getVertices()[ vertexIdx ] + float3( 0.0f, height, 0.0f ) ) * scale;
+				mesh->getNormals()[ vertexIdx ]  = TestUtil::normalized( float3( displacement( random ), 1.0f, displacement( random ) ) );
+				mesh->getTangents()[ vertexIdx ] = TestUtil::normalized( float3( 1.0f, displacement( random ), 0.0f ) );
+			}
+
+			mesh->recalculateBoundingBox();
+
+			return mesh;
+		}
+
+		// Logs size reduction and decode throughput (of decoded data) of a stream.
+		static void logStream( const std::string& description, const size_t decodedSize, const size_t encodedSize, const double decodeTime )
+		{
+			std::ostringstream message;
+			message << std::fixed << std::setprecision( 2 ) << description 
+				<< " - " << decodedSize << " B -> " << encodedSize << " B (" << (double)decodedSize / encodedSize << "x smaller)"
+				<< ", decoded at " << decodedSize / decodeTime / 1000000000.0 << " GB/s";
+
+			Logger::WriteMessage( message.str().c_str() );
+		}
+
+	public:
+
+		TEST_METHOD( MeshCompressionUtil_Positions_Round_Trip_1 ) {
+			const std::shared_ptr< BlockMesh > mesh = createGridMesh( 64, float3( -100.0f, 5.0f, 20.0f ), 3.7f );
+
+			const float3 bbMin = mesh->getBoundingBox().getMin();
+			const float3 bbMax = mesh->getBoundingBox().getMax();
+
+			std::vector< char >   encoded;
+			std::vector< float3 > decoded;
+
+			MeshCompressionUtil::encodePositions( encoded, mesh->getVertices(), bbMin, bbMax );
+			MeshCompressionUtil::decodePositions( encoded.data(), encoded.size(), decoded, (int)mesh->getVertices().size(), bbMin, bbMax );
+
+			Assert::AreEqual( (int)mesh->getVertices().size(), (int)decoded.size(), L"Incorrect number of decoded positions" );
+
+			// Positions are rounded to the nearest quantization step.
+			const float3 tolerance = ( bbMax - bbMin ) / 65535.0f * 0.5f + float3( 0.0001f, 0.0001f, 0.0001f );
+
+			for ( size_t i = 0; i < decoded.size(); ++i ) {
+				Assert::IsTrue( TestUtil::areClose( decoded[ i ], mesh->getVertices()[ i ], tolerance ), L"Decoded position differs by more than half of the quantization step" );
+			}
+		}
+
+		TEST_METHOD( MeshCompressionUtil_Unit_Vectors_Round_Trip_1 ) {
+			const std::shared_ptr< BlockMesh > mesh = createGridMesh( 32, float3::ZERO, 1.0f );
+
+			// Cover all octants (including the folded lower half of the octahedron) and the axes.
+			std::vector< float3 > vectors = mesh->getNormals();
+			for ( const float3& normal : mesh->getNormals() )
+				vectors.push_back( -normal );
+
+			vectors.push_back( float3( 0.0f, 0.0f, 1.0f ) );
+			vectors.push_back( float3( 0.0f, 0.0f, -1.0f ) );
+			vectors.push_back( float3( -1.0f, 0.0f, 0.0f ) );
+
+			std::vector< char >   encoded;
+			std::vector< float3 > decoded;
+
+			MeshCompressionUtil::encodeUnitVectors( encoded, vectors );
+			MeshCompressionUtil::decodeUnitVectors( encoded.data(), encoded.size(), decoded, (int)vectors.size() );
+
+			Assert::AreEqual( (int)vectors.size(), (int)decoded.size(), L"Incorrect number of decoded vectors" );
+
+			for ( size_t i = 0; i < decoded.size(); ++i ) {
+				Assert::AreEqual( 1.0f, decoded[ i ].length(), 0.0001f, L"Decoded vector is not normalized" );
+				Assert::IsTrue( dot( decoded[ i ], vectors[ i ] ) > 0.99999f, L"Decoded vector differs too much from the original vector" );
+			}
+		}
+
+		TEST_METHOD( MeshCompressionUtil_Texcoords_And_Triangles_Round_Trip_1 ) {
+			const std::shared_ptr< BlockMesh > mesh = createGridMesh( 64, float3::ZERO, 1.0f );
+
+			std::vector< char >   encodedTexcoords;
+			std::vector< float2 > decodedTexcoords;
+
+			MeshCompressionUtil::encodeTexcoords( encodedTexcoords, mesh->getTexcoords( 0 ) );
+			MeshCompressionUtil::decodeTexcoords( encodedTexcoords.data(), encodedTexcoords.size(), decodedTexcoords, (int)mesh->getTexcoords( 0 ).size() );
+
+			Assert::AreEqual( (int)mesh->getTexcoords( 0 ).size(), (int)decodedTexcoords.size(), L"Incorrect number of decoded texcoords" );
+
+			// Half-precision floats have 11 significant bits - texcoords in range 0 - 1 differ by at most 2^-12.
+			for ( size_t i = 0; i < decodedTexcoords.size(); ++i ) {
+				Assert::AreEqual( mesh->getTexcoords( 0 )[ i ].x, decodedTexcoords[ i ].x, 0.00025f, L"Decoded texcoord differs too much from the original texcoord" );
+				Assert::AreEqual( mesh->getTexcoords( 0 )[ i ].y, decodedTexcoords[ i ].y, 0.00025f, L"Decoded texcoord differs too much from the original texcoord" );
+			}
+
+			std::vector< char >  encodedTriangles;
+			std::vector< uint3 > decodedTriangles;
+
+			MeshCompressionUtil::encodeTriangles( encodedTriangles, mesh->getTriangles() );
+			MeshCompressionUtil::decodeTriangles( encodedTriangles.data(), encodedTriangles.size(), decodedTriangles, (int)mesh->getTriangles().size() );
+
+			Assert::IsTrue( decodedTriangles == mesh->getTriangles(), L"Decoded triangles are incorrect - they should be lossless" );
+		}
+
+		TEST_METHOD( MeshCompressionUtil_Compressed_File_With_Stale_Bounding_Box_1 ) {
+			const std::shared_ptr< BlockMesh > mesh = createGridMesh( 64, float3::ZERO, 1.0f );
+
+			// Move vertices after the bounding box was calculated - they would be clamped if quantized relative to the stale bounding box.
+			for ( float3& vertex : mesh->getVertices() )
+				vertex = vertex * 2.0f + float3( 10.0f, -3.0f, 1.0f );
+
+			mesh->buildBvhTree();
+
+			std::vector< char > data;
+			MeshFileParser::writeBlockMeshFile( data, BlockMeshFileInfo::Format::BLOCKMESH, *mesh, true );
+
+			std::vector< char >::const_iterator dataIt    = data.cbegin();
+			std::vector< char >::const_iterator dataEndIt = data.cend();
+
+			const std::shared_ptr< BlockMesh > loadedMesh
+				= MeshFileParser::parseBlockMeshFile( BlockMeshFileInfo::Format::BLOCKMESH, dataIt, dataEndIt, false, false, false ).front();
+
+			Assert::AreEqual( (int)mesh->getVertices().size(), (int)loadedMesh->getVertices().size(), L"Incorrect number of loaded vertices" );
+			Assert::IsTrue( loadedMesh->getTriangles() == mesh->getTriangles(), L"Loaded triangles are incorrect" );
+
+			const float3 bbMin     = loadedMesh->getBoundingBox().getMin();
+			const float3 bbMax     = loadedMesh->getBoundingBox().getMax();
+			const float3 tolerance = ( bbMax - bbMin ) / 65535.0f * 0.5f + float3( 0.0001f, 0.0001f, 0.0001f );
+
+			for ( size_t i = 0; i < mesh->getVertices().size(); ++i ) {
+				Assert::IsTrue( TestUtil::areClose( loadedMesh->getVertices()[ i ], mesh->getVertices()[ i ], tolerance ), L"Loaded position differs by more than half of the quantization step" );
+			}
+
+			// Each BVH leaf has to contain all vertices of its triangles after decoding.
+			const std::vector< BVHTreeBuffer::Node >&        nodes        = loadedMesh->getBvhTree()->getNodes();
+			const std::vector< BVHTreeBuffer::NodeExtents >& nodesExtents = loadedMesh->getBvhTree()->getNodesExtents();
+
+			for ( size_t nodeIdx = 0; nodeIdx < nodes.size(); ++nodeIdx ) {
+				const unsigned int triangleCount = nodes[ nodeIdx ].node.leaf.triangleCount;
+				if ( ( triangleCount & 0x80000000 ) == 0 )
+					continue;
+
+				const BVHTreeBuffer::NodeExtents& extents            = nodesExtents[ nodeIdx ];
+				const unsigned int                firstTriangleIndex = nodes[ nodeIdx ].node.leaf.firstTriangleIndex;
+
+				for ( unsigned int triangleIdx = firstTriangleIndex; triangleIdx < firstTriangleIndex + ( triangleCount & 0x7FFFFFFF ); ++triangleIdx ) {
+					const uint3& triangle = loadedMesh->getTriangles()[ triangleIdx ];
+
+					for ( const unsigned int vertexIdx : { triangle.x, triangle.y, triangle.z } ) {
+						const float3& vertex = loadedMesh->getVertices()[ vertexIdx ];
+
+						Assert::IsTrue( vertex.x >= extents.min.x && vertex.y >= extents.min.y && vertex.z >= extents.min.z
+							&& vertex.x <= extents.max.x && vertex.y <= extents.max.y && vertex.z <= extents.max.z, L"Loaded vertex is outside of its BVH node" );
+					}
+				}
+			}
+		}
+
+		// Measures size reduction and decode throughput of each stream. Results are written to the test log.
+		TEST_METHOD( MeshCompressionUtil_Size_And_Decode_Throughput_1 ) {
+			const std::shared_ptr< BlockMesh > mesh = createGridMesh( 512, float3( -100.0f, 0.0f, 50.0f ), 0.5f );
+
+			// Triangles of a grid are too regular - shuffle them and order for rasterization, as done when importing meshes.
+			std::shuffle( mesh->getTriangles().begin(), mesh->getTriangles().end(), std::mt19937( 3 ) );
+			MeshUtil::optimizeForRasterization( *mesh );
+
+			const int    vertexCount   = (int)mesh->getVertices().size();
+			const int    triangleCount = (int)mesh->getTriangles().size();
+			const float3 bbMin         = mesh->getBoundingBox().getMin();
+			const float3 bbMax         = mesh->getBoundingBox().getMax();
+			const int    runCount      = 5;
+
+			std::vector< char > encodedPositions, encodedNormals, encodedTangents, encodedTexcoords, encodedTriangles;
+			MeshCompressionUtil::encodePositions( encodedPositions, mesh->getVertices(), bbMin, bbMax );
+			MeshCompressionUtil::encodeUnitVectors( encodedNormals, mesh->getNormals() );
+			MeshCompressionUtil::encodeUnitVectors( encodedTangents, mesh->getTangents() );
+			MeshCompressionUtil::encodeTexcoords( encodedTexcoords, mesh->getTexcoords( 0 ) );
+			MeshCompressionUtil::encodeTriangles( encodedTriangles, mesh->getTriangles() );
+
+			std::vector< float3 > positions, normals, tangents;
+			std::vector< float2 > texcoords;
+			std::vector< uint3 >  triangles;
+
+			const double positionsTime = TestUtil::measureShortestTime( runCount, [ & ]() {
+				MeshCompressionUtil::decodePositions( encodedPositions.data(), encodedPositions.size(), positions, vertexCount, bbMin, bbMax );
+			} );
+			const double normalsTime = TestUtil::measureShortestTime( runCount, [ & ]() {
+				MeshCompressionUtil::decodeUnitVectors( encodedNormals.data(), encodedNormals.size(), normals, vertexCount );
+			} );
+			const double tangentsTime = TestUtil::measureShortestTime( runCount, [ & ]() {
+				MeshCompressionUtil::decodeUnitVectors( encodedTangents.data(), encodedTangents.size(), tangents, vertexCount );
+			} );
+			const double texcoordsTime = TestUtil::measureShortestTime( runCount, [ & ]() {
+				MeshCompressionUtil::decodeTexcoords( encodedTexcoords.data(), encodedTexcoords.size(), texcoords, vertexCount );
+			} );
+			const double trianglesTime = TestUtil::measureShortestTime( runCount, [ & ]() {
+				MeshCompressionUtil::decodeTriangles( encodedTriangles.data(), encodedTriangles.size(), triangles, triangleCount );
+			} );
+
+			Assert::IsTrue( triangles == mesh->getTriangles(), L"Decoded triangles are incorrect" );
+
+			const size_t vector3Size  = vertexCount * sizeof( float3 );
+			const size_t texcoordSize = vertexCount * sizeof( float2 );
+			const size_t triangleSize = triangleCount * sizeof( uint3 );
+
+			logStream( "Positions", vector3Size, encodedPositions.size(), positionsTime );
+			logStream( "Normals", vector3Size, encodedNormals.size(), normalsTime );
+			logStream( "Tangents", vector3Size, encodedTangents.size(), tangentsTime );
+			logStream( "Texcoords", texcoordSize, encodedTexcoords.size(), texcoordsTime );
+			logStream( "Triangles", triangleSize, encodedTriangles.size(), trianglesTime );
+
+			const size_t decodedSize = vector3Size * 3 + texcoordSize + triangleSize;
+			const size_t encodedSize = encodedPositions.size() + encodedNormals.size() + encodedTangents.size() + encodedTexcoords.size() + encodedTriangles.size();
+
+			logStream( "All streams", decodedSize, encodedSize, positionsTime + normalsTime + tangentsTime + texcoordsTime + trianglesTime );
+
+			// Vertex attributes are 2-3x smaller, triangles about 5x.
+			Assert::IsTrue( (double)decodedSize / encodedSize > 2.9, L"Streams should be about 3x smaller" );
+
+			std::vector< char > fileData, compressedFileData;
+			MeshFileParser::writeBlockMeshFile( fileData, BlockMeshFileInfo::Format::BLOCKMESH, *mesh, false );
+			MeshFileParser::writeBlockMeshFile( compressedFileData, BlockMeshFileInfo::Format::BLOCKMESH, *mesh, true );
+
+			std::ostringstream message;
+			message << std::fixed << std::setprecision( 2 ) << "File - " << fileData.size() << " B -> " << compressedFileData.size() << " B (" 
+				<< (double)fileData.size() / compressedFileData.size() << "x smaller)";
+			Logger::WriteMessage( message.str().c_str() );
+		}
+	};
+}
\ No newline at end of file
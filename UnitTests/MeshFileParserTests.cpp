@@ -0,0 +1,271 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TestUtil.h"
+
+#include "MeshFileParser.h"
+#include "BlockMesh.h"
+#include "SkeletonMesh.h"
+#include "BVHTreeBuffer.h"
+#include "BVHTreeBufferParser.h"
+#include "BinaryFileReader.h"
+#include "BinaryFileWriter.h"
+
+#include <cstring>
+#include <random>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( MeshFileParserTests )
+	{
+	private:
+
+		// Layout of the own formats - header starts with magic, version and section count, followed by the section table.
+		static const size_t s_skeletonMeshHeaderSize   = 40;
+		static const size_t s_fileSectionSize          = 24;
+		static const int    s_vertexWeightsSectionType = 6;
+		static const int    s_boneNamesSectionType     = 8;
+
+		// Bones have names of different lengths (including an empty one) and form a hierarchy with bone 2 as the root.
+		// Each vertex is attached to two random bones.
+		static std::shared_ptr< SkeletonMesh > createSkeletonMesh( const int vertexCount )
+		{
+			const char* boneNames[] = { "Hips", "", "LeftUpperLeg", "Spine_01", "Head" };
+			const unsigned char boneParents[] = { 2, 0, 1, 1, 4 };
+			const unsigned char boneCount = 5;
+
+			std::shared_ptr< SkeletonMesh > mesh = std::make_shared< SkeletonMesh >( vertexCount, true, 2, vertexCount / 3, BonesPerVertexCount::Type::TWO );
+
+			std::mt19937                            random( 11 );
+			std::uniform_real_distribution< float > coordinate( -1.0f, 1.0f );
+			std::uniform_real_distribution< float > weight( 0.1f, 1.0f );
+			std::uniform_int_distribution< int >    bone( 1, boneCount );
+
+			for ( unsigned char boneIndex = 1; boneIndex <= boneCount; ++boneIndex ) {
+				const float43 bindPose = TestUtil::createTransform( float3( coordinate( random ), coordinate( random ), coordinate( random ) ), float3( coordinate( random ), coordinate( random ), coordinate( random ) ) );
+
+				mesh->addOrModifyBone( boneIndex, boneNames[ boneIndex - 1 ], boneParents[ boneIndex - 1 ], bindPose );
+			}
+
+			for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx ) {
+				mesh->getVertices()[ vertexIdx ]     = float3( coordinate( random ), coordinate( random ), coordinate( random ) ) * 10.0f;
+				mesh->getNormals()[ vertexIdx ]      = TestUtil::normalized( float3( coordinate( random ), coordinate( random ), 1.5f ) );
+				mesh->getTangents()[ vertexIdx ]     = TestUtil::normalized( float3( 1.5f, coordinate( random ), coordinate( random ) ) );
+				mesh->getTexcoords( 0 )[ vertexIdx ] = float2( coordinate( random ), coordinate( random ) );
+				mesh->getTexcoords( 1 )[ vertexIdx ] = float2( coordinate( random ), coordinate( random ) );
+
+				const unsigned char boneIndex1 = (unsigned char)bone( random );
+				const unsigned char boneIndex2 = (unsigned char)( boneIndex1 % boneCount + 1 );
+
+				mesh->attachVertexToBone( vertexIdx, boneIndex1, weight( random ) );
+				mesh->attachVertexToBone( vertexIdx, boneIndex2, weight( random ) );
+			}
+
+			for ( int triangleIdx = 0; triangleIdx < vertexCount / 3; ++triangleIdx )
+				mesh->getTriangles()[ triangleIdx ] = uint3( triangleIdx * 3, triangleIdx * 3 + 1, triangleIdx * 3 + 2 );
+
+			mesh->normalizeVertexWeights();
+			mesh->recalculateBoundingBox();
+
+			return mesh;
+		}
+
+		// Writes the mesh in the version 1 format - without a header, each array preceded by its element count.
+		static std::vector< char > writeBlockMeshFileV1( const BlockMesh& mesh )
+		{
+			std::vector< char > data;
+			BinaryFileWriter    writer( data );
+
+			writer.write( (int)mesh.getVertices().size() );
+			writer.writeArray( mesh.getVertices() );
+			writer.write( (int)mesh.getNormals().size() );
+			writer.writeArray( mesh.getNormals() );
+			writer.write( (int)mesh.getTangents().size() );
+			writer.writeArray( mesh.getTangents() );
+
+			writer.write( mesh.getTexcoordsCount() );
+			for ( int setIdx = 0; setIdx < mesh.getTexcoordsCount(); ++setIdx ) {
+				writer.write( (int)mesh.getTexcoords( setIdx ).size() );
+				writer.writeArray( mesh.getTexcoords( setIdx ) );
+			}
+
+			writer.write( (int)mesh.getTriangles().size() );
+			writer.writeArray( mesh.getTriangles() );
+
+			writer.write( mesh.getBoundingBox().getMin() );
+			writer.write( mesh.getBoundingBox().getMax() );
+
+			writer.write( mesh.getBvhTree() != nullptr );
+			if ( mesh.getBvhTree() )
+				BVHTreeBufferParser::writeBVHTreeFile( writer, *mesh.getBvhTree() );
+
+			writer.close();
+
+			return data;
+		}
+
+		static void assertIdentical( const BlockMesh& expected, const BlockMesh& mesh )
+		{
+			Assert::IsTrue( mesh.getVertices() == expected.getVertices(), L"Loaded mesh vertices are incorrect" );
+			Assert::IsTrue( mesh.getNormals() == expected.getNormals(), L"Loaded mesh normals are incorrect" );
+			Assert::IsTrue( mesh.getTangents() == expected.getTangents(), L"Loaded mesh tangents are incorrect" );
+			Assert::AreEqual( expected.getTexcoordsCount(), mesh.getTexcoordsCount(), L"Incorrect number of texcoord sets in loaded mesh" );
+			Assert::IsTrue( mesh.getTexcoords( 0 ) == expected.getTexcoords( 0 ), L"Loaded mesh texcoords are incorrect" );
+			Assert::IsTrue( mesh.getTriangles() == expected.getTriangles(), L"Loaded mesh triangles are incorrect" );
+
+			Assert::IsTrue( mesh.getBoundingBox().getMin() == expected.getBoundingBox().getMin()
+				&& mesh.getBoundingBox().getMax() == expected.getBoundingBox().getMax(), L"Loaded mesh bounding box is incorrect" );
+
+			if ( !expected.getBvhTree() ) {
+				Assert::IsNull( mesh.getBvhTree().get(), L"Loaded mesh has an unexpected BVH tree" );
+				return;
+			}
+
+			Assert::IsNotNull( mesh.getBvhTree().get(), L"Loaded mesh has no BVH tree" );
+			Assert::IsTrue( TestUtil::areIdentical( expected.getBvhTree()->getNodes(), mesh.getBvhTree()->getNodes() ), L"Loaded BVH nodes are incorrect" );
+			Assert::IsTrue( TestUtil::areIdentical( expected.getBvhTree()->getNodesExtents(), mesh.getBvhTree()->getNodesExtents() ), L"Loaded BVH node extents are incorrect" );
+			Assert::IsTrue( TestUtil::areIdentical( expected.getBvhTree()->getTriangles(), mesh.getBvhTree()->getTriangles() ), L"Loaded BVH triangles are incorrect" );
+		}
+
+		static std::shared_ptr< SkeletonMesh > parseSkeletonMesh( const std::vector< char >& data )
+		{
+			return SkeletonMesh::createFromMemory( data.cbegin(), data.cend(), SkeletonMeshFileInfo::Format::SKELETONMESH, 0 );
+		}
+
+		// Returns the offset of the section's element count in the section table.
+		static size_t findSectionElementCount( const std::vector< char >& data, const int sectionType )
+		{
+			int sectionCount = 0;
+			std::memcpy( &sectionCount, data.data() + 8, sizeof( int ) );
+
+			for ( int sectionIdx = 0; sectionIdx < sectionCount; ++sectionIdx ) {
+				const size_t sectionOffset = s_skeletonMeshHeaderSize + sectionIdx * s_fileSectionSize;
+
+				int type = 0;
+				std::memcpy( &type, data.data() + sectionOffset, sizeof( int ) );
+
+				if ( type == sectionType )
+					return sectionOffset + sizeof( int );
+			}
+
+			Assert::Fail( L"Section not found" );
+			return 0;
+		}
+
+		static void decrementSectionElementCount( std::vector< char >& data, const int sectionType )
+		{
+			const size_t elementCountOffset = findSectionElementCount( data, sectionType );
+
+			int elementCount = 0;
+			std::memcpy( &elementCount, data.data() + elementCountOffset, sizeof( int ) );
+			--elementCount;
+			std::memcpy( data.data() + elementCountOffset, &elementCount, sizeof( int ) );
+		}
+
+		static bool throwsOnParse( const std::vector< char >& data )
+		{
+			try {
+				parseSkeletonMesh( data );
+			} catch ( const std::exception& ) {
+				return true;
+			}
+
+			return false;
+		}
+
+	public:
+
+		TEST_METHOD( MeshFileParser_Block_Mesh_Version_1_1 ) {
+			const std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 16 );
+
+			const std::vector< char > data = writeBlockMeshFileV1( *mesh );
+
+			std::vector< char >::const_iterator dataIt    = data.cbegin();
+			std::vector< char >::const_iterator dataEndIt = data.cend();
+
+			assertIdentical( *mesh, *MeshFileParser::parseBlockMeshFile( BlockMeshFileInfo::Format::BLOCKMESH, dataIt, dataEndIt, false, false, false ).front() );
+
+			// Version 1 mesh is saved in the current version.
+			std::vector< char > savedData;
+			MeshFileParser::writeBlockMeshFile( savedData, BlockMeshFileInfo::Format::BLOCKMESH, *BlockMesh::createFromMemory( data.cbegin(), data.cend(), BlockMeshFileInfo::Format::BLOCKMESH, 0 ) );
+
+			Assert::IsTrue( savedData.size() > data.size(), L"Mesh should be saved with a header and aligned sections" );
+			assertIdentical( *mesh, *BlockMesh::createFromMemory( savedData.cbegin(), savedData.cend(), BlockMeshFileInfo::Format::BLOCKMESH, 0 ) );
+		}
+
+		TEST_METHOD( MeshFileParser_Block_Mesh_Version_1_With_Bvh_1 ) {
+			const std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 16 );
+			mesh->buildBvhTree();
+
+			const std::vector< char > data = writeBlockMeshFileV1( *mesh );
+
+			assertIdentical( *mesh, *BlockMesh::createFromMemory( data.cbegin(), data.cend(), BlockMeshFileInfo::Format::BLOCKMESH, 0 ) );
+
+			// Mesh can be streamed - BVH tree is read from the reader, directly after the mesh.
+			BinaryFileReader reader( data.cbegin(), data.cend() );
+			assertIdentical( *mesh, *MeshFileParser::parseBlockMeshFile( reader ) );
+
+			Assert::AreEqual( 0ull, reader.getRemainingSize(), L"Version 1 mesh wasn't read whole" );
+		}
+
+		TEST_METHOD( MeshFileParser_Skeleton_Mesh_Round_Trip_1 ) {
+			const std::shared_ptr< SkeletonMesh > mesh = createSkeletonMesh( 300 );
+
+			std::vector< char > data;
+			MeshFileParser::writeSkeletonMeshFile( data, SkeletonMeshFileInfo::Format::SKELETONMESH, *mesh );
+
+			const std::shared_ptr< SkeletonMesh > loadedMesh = parseSkeletonMesh( data );
+
+			Assert::IsTrue( loadedMesh->getVertices() == mesh->getVertices(), L"Loaded mesh vertices are incorrect" );
+			Assert::IsTrue( loadedMesh->getNormals() == mesh->getNormals(), L"Loaded mesh normals are incorrect" );
+			Assert::IsTrue( loadedMesh->getTangents() == mesh->getTangents(), L"Loaded mesh tangents are incorrect" );
+			Assert::AreEqual( mesh->getTexcoordsCount(), loadedMesh->getTexcoordsCount(), L"Incorrect number of texcoord sets in loaded mesh" );
+			Assert::IsTrue( loadedMesh->getTexcoords( 0 ) == mesh->getTexcoords( 0 ), L"Loaded mesh texcoords are incorrect" );
+			Assert::IsTrue( loadedMesh->getTexcoords( 1 ) == mesh->getTexcoords( 1 ), L"Loaded mesh second texcoord set is incorrect" );
+			Assert::IsTrue( loadedMesh->getTriangles() == mesh->getTriangles(), L"Loaded mesh triangles are incorrect" );
+
+			Assert::IsTrue( mesh->getBonesPerVertexCount() == loadedMesh->getBonesPerVertexCount(), L"Incorrect bones per vertex count in loaded mesh" );
+			Assert::IsTrue( loadedMesh->getVertexBones() == mesh->getVertexBones(), L"Loaded mesh vertex bones are incorrect" );
+			Assert::IsTrue( loadedMesh->getVertexWeights() == mesh->getVertexWeights(), L"Loaded mesh vertex weights are incorrect" );
+
+			Assert::IsTrue( loadedMesh->getBoundingBox().getMin() == mesh->getBoundingBox().getMin()
+				&& loadedMesh->getBoundingBox().getMax() == mesh->getBoundingBox().getMax(), L"Loaded mesh bounding box is incorrect" );
+
+			Assert::AreEqual( (int)mesh->getBoneCount(), (int)loadedMesh->getBoneCount(), L"Incorrect number of bones in loaded mesh" );
+			for ( unsigned char boneIndex = 1; boneIndex <= mesh->getBoneCount(); ++boneIndex ) {
+				const SkeletonMesh::Bone& bone       = mesh->getBone( boneIndex );
+				const SkeletonMesh::Bone& loadedBone = loadedMesh->getBone( boneIndex );
+
+				Assert::IsTrue( loadedBone.getName() == bone.getName(), L"Loaded bone name is incorrect" );
+				Assert::AreEqual( (int)bone.getParentBoneIndex(), (int)loadedBone.getParentBoneIndex(), L"Loaded bone parent is incorrect" );
+				Assert::IsTrue( TestUtil::areClose( bone.getBindPose(), loadedBone.getBindPose(), 0.0f ), L"Loaded bone bind pose is incorrect" );
+				Assert::IsTrue( TestUtil::areClose( bone.getBindPoseInv(), loadedBone.getBindPoseInv(), 0.0f ), L"Loaded bone inverse bind pose is incorrect" );
+			}
+
+			Assert::AreEqual( 3, (int)loadedMesh->getBoneIndex( "LeftUpperLeg" ), L"Bone can't be found by name in loaded mesh" );
+			Assert::IsTrue( loadedMesh->hasValidBoneHierarchy(), L"Loaded mesh bone hierarchy is invalid" );
+			Assert::IsTrue( loadedMesh->getBoneOrder() == mesh->getBoneOrder(), L"Loaded mesh bone order is incorrect" );
+		}
+
+		TEST_METHOD( MeshFileParser_Skeleton_Mesh_Bone_Name_Out_Of_Bounds_1 ) {
+			std::vector< char > data;
+			MeshFileParser::writeSkeletonMeshFile( data, SkeletonMeshFileInfo::Format::SKELETONMESH, *createSkeletonMesh( 30 ) );
+
+			// Name of the last bone ends past the bone names section.
+			decrementSectionElementCount( data, s_boneNamesSectionType );
+
+			Assert::IsTrue( throwsOnParse( data ), L"Bone name out of bounds should throw" );
+		}
+
+		TEST_METHOD( MeshFileParser_Skeleton_Mesh_Weight_Count_Mismatch_1 ) {
+			std::vector< char > data;
+			MeshFileParser::writeSkeletonMeshFile( data, SkeletonMeshFileInfo::Format::SKELETONMESH, *createSkeletonMesh( 30 ) );
+
+			decrementSectionElementCount( data, s_vertexWeightsSectionType );
+
+			Assert::IsTrue( throwsOnParse( data ), L"Vertex weight count not matching the vertex bone count should throw" );
+		}
+	};
+}
@@ -0,0 +1,735 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TestUtil.h"
+
+#include "MeshUtil.h"
+#include "MeshFileParser.h"
+#include "BlockMesh.h"
+#include "BlockMeshLOD.h"
+#include "BVHTreeBuffer.h"
+#include "ParallelUtil.h"
+#include "MathUtil.h"
+#include "float43.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( MeshUtilTests )
+	{
+	private:
+
+		// Returns a flat grid of quads ( size x size ), each quad with its own 4 vertices - as imported without joining identical vertices.
+		static std::shared_ptr< BlockMesh > createGridWithSeparateQuads( const int size )
+		{
+			const int quadCount = size * size;
+
+			std::shared_ptr< BlockMesh > mesh = std::make_shared< BlockMesh >( quadCount * 4, true, 1, quadCount * 2 );
+
+			for ( int y = 0; y < size; ++y ) {
+				for ( int x = 0; x < size; ++x ) {
+					const int quadIdx        = y * size + x;
+					const int firstVertexIdx = quadIdx * 4;
+
+					for ( int cornerIdx = 0; cornerIdx < 4; ++cornerIdx ) {
+						const int cornerX = x + ( cornerIdx & 1 );
+						const int cornerY = y + ( cornerIdx >> 1 );
+
+						mesh->getVertices()[ firstVertexIdx + cornerIdx ]     = float3( (float)cornerX, 0.0f, (float)cornerY );
+						mesh->getNormals()[ firstVertexIdx + cornerIdx ]      = float3( 0.0f, 1.0f, 0.0f );
+						mesh->getTangents()[ firstVertexIdx + cornerIdx ]     = float3( 1.0f, 0.0f, 0.0f );
+						mesh->getTexcoords( 0 )[ firstVertexIdx + cornerIdx ] = float2( (float)cornerX / (float)size, (float)cornerY / (float)size );
+					}
+
+					mesh->getTriangles()[ quadIdx * 2 ]     = uint3( firstVertexIdx, firstVertexIdx + 2, firstVertexIdx + 1 );
+					mesh->getTriangles()[ quadIdx * 2 + 1 ] = uint3( firstVertexIdx + 1, firstVertexIdx + 2, firstVertexIdx + 3 );
+				}
+			}
+
+			return mesh;
+		}
+
+		static bool isTriangleLess( const uint3& triangle1, const uint3& triangle2 )
+		{
+			if ( triangle1.x != triangle2.x ) return triangle1.x < triangle2.x;
+			if ( triangle1.y != triangle2.y ) return triangle1.y < triangle2.y;
+			return triangle1.z < triangle2.z;
+		}
+
+		static float3 getTriangleNormal( const BlockMesh& mesh, const uint3& triangle )
+		{
+			const float3& vertex1 = mesh.getVertices()[ triangle.x ];
+			const float3& vertex2 = mesh.getVertices()[ triangle.y ];
+			const float3& vertex3 = mesh.getVertices()[ triangle.z ];
+
+			return cross( vertex2 - vertex1, vertex3 - vertex1 );
+		}
+
+		// Returns a mesh with random positions, normals, tangents and texcoords (in the given number of sets) and random triangles.
+		static std::shared_ptr< BlockMesh > createRandomMesh( const int vertexCount, const int texcoordSetCount, const int triangleCount, const unsigned int seed )
+		{
+			std::shared_ptr< BlockMesh > mesh = std::make_shared< BlockMesh >( vertexCount, true, texcoordSetCount, triangleCount );
+
+			std::mt19937                            generator( seed );
+			std::uniform_real_distribution< float > valueDistribution( -100.0f, 100.0f );
+			std::uniform_int_distribution< int >    vertexIdxDistribution( 0, vertexCount - 1 );
+
+			const auto randomFloat3 = [ & ]() { 
+				const float x = valueDistribution( generator );
+				const float y = valueDistribution( generator );
+				const float z = valueDistribution( generator );
+				return float3( x, y, z ); 
+			};
+
+			for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx ) {
+				mesh->getVertices()[ vertexIdx ] = randomFloat3();
+				mesh->getNormals()[ vertexIdx ]  = randomFloat3();
+				mesh->getTangents()[ vertexIdx ] = randomFloat3();
+
+				for ( int setIdx = 0; setIdx < texcoordSetCount; ++setIdx ) {
+					const float u = valueDistribution( generator );
+					const float v = valueDistribution( generator );
+					mesh->getTexcoords( setIdx )[ vertexIdx ] = float2( u, v );
+				}
+			}
+
+			for ( uint3& triangle : mesh->getTriangles() ) {
+				triangle.x = (unsigned int)vertexIdxDistribution( generator );
+				triangle.y = (unsigned int)vertexIdxDistribution( generator );
+				triangle.z = (unsigned int)vertexIdxDistribution( generator );
+			}
+
+			return mesh;
+		}
+
+		// Transforms interleaved vertices one by one - positions by the whole transform, normals and tangents only by its orientation.
+		static void transformInterleavedVertices( const char* src, char* dst, const size_t count, const BlockMesh::InterleavedVertexFormat& format, const float43& transform )
+		{
+			const float33 orientation = transform.getOrientation();
+
+			for ( size_t vertexIdx = 0; vertexIdx < count; ++vertexIdx ) {
+				const char* srcVertex = src + vertexIdx * format.stride;
+				char*       dstVertex = dst + vertexIdx * format.stride;
+
+				if ( src != dst )
+					std::memcpy( dstVertex, srcVertex, format.stride );
+
+				float3& position = *reinterpret_cast< float3* >( dstVertex + format.positionOffset );
+				float3& normal   = *reinterpret_cast< float3* >( dstVertex + format.normalOffset );
+				float3& tangent  = *reinterpret_cast< float3* >( dstVertex + format.tangentOffset );
+
+				position = position * transform;
+				normal   = normal * orientation;
+				tangent  = tangent * orientation;
+			}
+		}
+
+		static void logThroughput( const std::string& description, const size_t vertexCount, const double separateTime, const double interleavedTime )
+		{
+			std::ostringstream message;
+			message << std::fixed << std::setprecision( 1 ) << description 
+				<< " - separate: " << vertexCount / separateTime / 1000000.0 << " M vertices/s"
+				<< ", interleaved: " << vertexCount / interleavedTime / 1000000.0 << " M vertices/s";
+
+			Logger::WriteMessage( message.str().c_str() );
+		}
+
+	public:
+
+		TEST_METHOD( MeshUtil_Weld_Vertices_1 ) {
+			const int size = 50;
+
+			std::shared_ptr< BlockMesh > mesh = createGridWithSeparateQuads( size );
+
+			const std::vector< float3 > verticesBefore  = mesh->getVertices();
+			const std::vector< uint3 >  trianglesBefore = mesh->getTriangles();
+
+			const MeshUtil::VertexWeldStats stats = MeshUtil::weldVertices( *mesh );
+
+			// Each grid point is shared by up to 4 quads - only one vertex per grid point should remain.
+			Assert::AreEqual( size * size * 4, stats.vertexCountBefore, L"MeshUtil::weldVertices() returned incorrect vertex count before welding" );
+			Assert::AreEqual( ( size + 1 ) * ( size + 1 ), stats.vertexCountAfter, L"MeshUtil::weldVertices() welded incorrect number of vertices" );
+			Assert::AreEqual( ( size + 1 ) * ( size + 1 ), (int)mesh->getVertices().size(), L"Mesh has incorrect number of vertices after welding" );
+			Assert::AreEqual( ( size + 1 ) * ( size + 1 ), (int)mesh->getNormals().size(), L"Mesh has incorrect number of normals after welding" );
+			Assert::AreEqual( ( size + 1 ) * ( size + 1 ), (int)mesh->getTexcoords( 0 ).size(), L"Mesh has incorrect number of texcoords after welding" );
+			Assert::AreEqual( 0, stats.removedTriangleCount, L"MeshUtil::weldVertices() removed triangles, which are not degenerate" );
+
+			// Triangles have to keep their positions.
+			Assert::AreEqual( (int)trianglesBefore.size(), (int)mesh->getTriangles().size(), L"Mesh has incorrect number of triangles after welding" );
+
+			for ( size_t triangleIdx = 0; triangleIdx < trianglesBefore.size(); ++triangleIdx ) {
+				const uint3& before = trianglesBefore[ triangleIdx ];
+				const uint3& after  = mesh->getTriangles()[ triangleIdx ];
+
+				Assert::IsTrue( verticesBefore[ before.x ] == mesh->getVertices()[ after.x ]
+					&& verticesBefore[ before.y ] == mesh->getVertices()[ after.y ]
+					&& verticesBefore[ before.z ] == mesh->getVertices()[ after.z ], L"Triangle changed its vertex positions after welding" );
+			}
+		}
+
+		TEST_METHOD( MeshUtil_Weld_Vertices_Keeps_Seams_1 ) {
+			std::shared_ptr< BlockMesh > mesh = createGridWithSeparateQuads( 2 );
+
+			// Vertices of the first quad get different texcoords (UV seam) and the second quad different normals (hard edge).
+			for ( int cornerIdx = 0; cornerIdx < 4; ++cornerIdx ) {
+				mesh->getTexcoords( 0 )[ cornerIdx ].x += 0.5f;
+				mesh->getNormals()[ 4 + cornerIdx ]     = float3( 0.0f, 0.0f, 1.0f );
+			}
+
+			const MeshUtil::VertexWeldStats stats = MeshUtil::weldVertices( *mesh );
+
+			// 9 grid points. The first and second quad keep their own 4 vertices each. Third and fourth quad share 2 vertices.
+			Assert::AreEqual( 4 + 4 + 6, stats.vertexCountAfter, L"MeshUtil::weldVertices() welded vertices with different attributes" );
+		}
+
+		TEST_METHOD( MeshUtil_Weld_Vertices_Epsilon_And_Degenerate_Triangles_1 ) {
+			const float epsilon = 0.001f;
+
+			// Pairs of vertices close to each other, straddling a boundary of the spatial hash cells (which are twice the epsilon in size).
+			BlockMesh mesh( 6, false, 0, 2 );
+			mesh.getVertices()[ 0 ] = float3( 0.002f - 0.0001f, 0.0f, 0.0f );
+			mesh.getVertices()[ 1 ] = float3( 0.002f + 0.0001f, 0.0f, 0.0f );
+			mesh.getVertices()[ 2 ] = float3( 0.0f, 1.0f, 0.0f );
+			mesh.getVertices()[ 3 ] = float3( 1.0f, 0.0f, 0.0f );
+			mesh.getVertices()[ 4 ] = float3( 1.0f, 0.0f, 0.0f + epsilon * 3.0f ); // Too far to be welded.
+			mesh.getVertices()[ 5 ] = float3( 0.0f, 1.0f, -0.0001f );
+
+			mesh.getTriangles()[ 0 ] = uint3( 0, 1, 2 ); // Becomes degenerate.
+			mesh.getTriangles()[ 1 ] = uint3( 3, 4, 5 );
+
+			const MeshUtil::VertexWeldStats stats = MeshUtil::weldVertices( mesh, epsilon );
+
+			Assert::AreEqual( 4, stats.vertexCountAfter, L"MeshUtil::weldVertices() welded incorrect number of vertices" );
+			Assert::AreEqual( 1, stats.removedTriangleCount, L"MeshUtil::weldVertices() didn't remove the degenerate triangle" );
+			Assert::AreEqual( 1, (int)mesh.getTriangles().size(), L"Mesh has incorrect number of triangles after welding" );
+			Assert::IsTrue( mesh.getTriangles()[ 0 ] == uint3( 2, 3, 1 ), L"Remaining triangle refers to incorrect vertices" );
+		}
+
+		TEST_METHOD( MeshUtil_Weld_Vertices_After_Building_BVH_1 ) {
+			std::shared_ptr< BlockMesh > mesh = createGridWithSeparateQuads( 4 );
+
+			mesh->buildBvhTree();
+
+			try {
+				MeshUtil::weldVertices( *mesh );
+			} catch ( ... ) {
+				return;
+			}
+
+			Assert::Fail( L"MeshUtil::weldVertices() didn't throw for a mesh with a BVH tree" );
+		}
+
+		TEST_METHOD( MeshUtil_Interleave_Vertices_Round_Trip_1 ) {
+			std::shared_ptr< BlockMesh > mesh = createGridWithSeparateQuads( 8 );
+
+			const BlockMesh::InterleavedVertexFormat format = MeshUtil::getInterleavedVertexFormat( *mesh, true );
+
+			Assert::AreEqual( 44, (int)format.stride, L"Interleaved vertex has incorrect stride" );
+			Assert::IsTrue( format.positionOffset == 0 && format.normalOffset == 12 && format.tangentOffset == 24 && format.texcoordOffset == 36, L"Interleaved vertex has incorrect attribute offsets" );
+
+			const std::vector< char > data = MeshUtil::interleaveVertices( *mesh, format );
+
+			Assert::AreEqual( (int)( mesh->getVertices().size() * format.stride ), (int)data.size(), L"Interleaved vertices have incorrect size" );
+
+			// Only positions are allocated - other attributes are added by deinterleaving.
+			BlockMesh deinterleavedMesh( (int)mesh->getVertices().size(), false, 0, 1 );
+			MeshUtil::deinterleaveVertices( deinterleavedMesh, data, format );
+
+			Assert::IsTrue( deinterleavedMesh.getVertices() == mesh->getVertices(), L"Deinterleaved positions differ from the original positions" );
+			Assert::IsTrue( deinterleavedMesh.getNormals() == mesh->getNormals(), L"Deinterleaved normals differ from the original normals" );
+			Assert::IsTrue( deinterleavedMesh.getTangents() == mesh->getTangents(), L"Deinterleaved tangents differ from the original tangents" );
+			Assert::AreEqual( 1, deinterleavedMesh.getTexcoordsCount(), L"Deinterleaved mesh has incorrect number of texcoord sets" );
+			Assert::IsTrue( deinterleavedMesh.getTexcoords( 0 ) == mesh->getTexcoords( 0 ), L"Deinterleaved texcoords differ from the original texcoords" );
+		}
+
+		TEST_METHOD( MeshUtil_Interleave_Vertices_Without_Positions_1 ) {
+			std::shared_ptr< BlockMesh > mesh = createGridWithSeparateQuads( 4 );
+
+			// Hybrid layout - positions stay in their own buffer.
+			const BlockMesh::InterleavedVertexFormat format = MeshUtil::getInterleavedVertexFormat( *mesh, false );
+
+			Assert::AreEqual( 32, (int)format.stride, L"Interleaved vertex has incorrect stride" );
+			Assert::AreEqual( -1, format.positionOffset, L"Interleaved vertex contains positions" );
+
+			const std::vector< char > data = MeshUtil::interleaveVertices( *mesh, format );
+
+			const std::vector< float3 > verticesBefore = mesh->getVertices();
+			const std::vector< float3 > normalsBefore  = mesh->getNormals();
+
+			for ( float3& normal : mesh->getNormals() )
+				normal = float3::ZERO;
+
+			MeshUtil::deinterleaveVertices( *mesh, data, format );
+
+			Assert::IsTrue( mesh->getVertices() == verticesBefore, L"Deinterleaving changed positions, which are not in the format" );
+			Assert::IsTrue( mesh->getNormals() == normalsBefore, L"Deinterleaved normals differ from the original normals" );
+		}
+
+		TEST_METHOD( MeshUtil_Interleave_Vertices_Missing_Attributes_1 ) {
+			// No normals, tangents or texcoords.
+			BlockMesh mesh( 3, false, 0, 1 );
+			mesh.getVertices()[ 0 ] = float3( 0.0f, 0.0f, 0.0f );
+			mesh.getVertices()[ 1 ] = float3( 1.0f, 0.0f, 0.0f );
+			mesh.getVertices()[ 2 ] = float3( 0.0f, 1.0f, 0.0f );
+			mesh.getTriangles()[ 0 ] = uint3( 0, 1, 2 );
+
+			const BlockMesh::InterleavedVertexFormat format = MeshUtil::getInterleavedVertexFormat( mesh, true );
+
+			Assert::AreEqual( 12, (int)format.stride, L"Interleaved vertex has incorrect stride" );
+			Assert::IsTrue( format.normalOffset < 0 && format.tangentOffset < 0 && format.texcoordOffset < 0, L"Interleaved vertex contains attributes missing in the mesh" );
+
+			std::vector< char > data = MeshUtil::interleaveVertices( mesh, format );
+			data.pop_back();
+
+			try {
+				MeshUtil::deinterleaveVertices( mesh, data, format );
+			} catch ( ... ) {
+				return;
+			}
+
+			Assert::Fail( L"MeshUtil::deinterleaveVertices() didn't throw for data size, which is not a multiple of the stride" );
+		}
+
+		TEST_METHOD( MeshUtil_Vertex_Layout_Saved_In_File_1 ) {
+			for ( const BlockMesh::VertexLayout layout : { BlockMesh::VertexLayout::Separate, BlockMesh::VertexLayout::Interleaved, BlockMesh::VertexLayout::Hybrid } ) {
+				std::shared_ptr< BlockMesh > mesh = createGridWithSeparateQuads( 2 );
+				mesh->setVertexLayout( layout );
+
+				std::vector< char > data;
+				MeshFileParser::writeBlockMeshFile( data, BlockMeshFileInfo::Format::BLOCKMESH, *mesh );
+
+				std::vector< char >::const_iterator dataIt    = data.cbegin();
+				std::vector< char >::const_iterator dataEndIt = data.cend();
+
+				const std::shared_ptr< BlockMesh > loadedMesh
+					= MeshFileParser::parseBlockMeshFile( BlockMeshFileInfo::Format::BLOCKMESH, dataIt, dataEndIt, false, false, false ).front();
+
+				Assert::IsTrue( loadedMesh->getVertexLayout() == layout, L"Loaded mesh has incorrect vertex layout" );
+			}
+		}
+
+		TEST_METHOD( MeshUtil_Simplify_Flat_Grid_1 ) {
+			const int size = 21;
+
+			const std::shared_ptr< BlockMesh > mesh           = TestUtil::createGrid( size );
+			const int                          targetTriangles = (int)mesh->getTriangles().size() / 4;
+
+			const std::shared_ptr< BlockMesh > simplifiedMesh = MeshUtil::simplify( *mesh, targetTriangles );
+
+			Assert::IsTrue( !simplifiedMesh->getTriangles().empty() && (int)simplifiedMesh->getTriangles().size() <= targetTriangles, L"Simplified mesh has incorrect number of triangles" );
+			Assert::IsTrue( simplifiedMesh->getVertices().size() < mesh->getVertices().size(), L"Simplified mesh should have fewer vertices" );
+
+			// Border vertices are locked. Triangles can't flip, so they still cover the whole grid.
+			int   borderVertexCount = 0;
+			float area              = 0.0f;
+
+			for ( size_t vertexIdx = 0; vertexIdx < simplifiedMesh->getVertices().size(); ++vertexIdx ) {
+				const float3& vertex = simplifiedMesh->getVertices()[ vertexIdx ];
+
+				if ( vertex.x == 0.0f || vertex.z == 0.0f || vertex.x == (float)( size - 1 ) || vertex.z == (float)( size - 1 ) )
+					++borderVertexCount;
+
+				// Vertices are never moved - they keep their attributes.
+				Assert::IsTrue( simplifiedMesh->getTexcoords( 0 )[ vertexIdx ] == float2( vertex.x / (float)( size - 1 ), vertex.z / (float)( size - 1 ) ), L"Vertex has incorrect texcoord after simplification" );
+				Assert::IsTrue( simplifiedMesh->getNormals()[ vertexIdx ] == float3( 0.0f, 1.0f, 0.0f ), L"Vertex has incorrect normal after simplification" );
+			}
+
+			for ( const uint3& triangle : simplifiedMesh->getTriangles() ) {
+				const float3 normal = getTriangleNormal( *simplifiedMesh, triangle );
+
+				Assert::IsTrue( normal.y > 0.0f, L"Triangle flipped or became degenerate during simplification" );
+
+				area += normal.length() * 0.5f;
+			}
+
+			Assert::AreEqual( ( size - 1 ) * 4, borderVertexCount, L"Border vertices were removed during simplification" );
+			Assert::AreEqual( (float)( ( size - 1 ) * ( size - 1 ) ), area, 0.01f, L"Simplified mesh doesn't cover the original surface" );
+		}
+
+		TEST_METHOD( MeshUtil_Simplify_Keeps_Creases_1 ) {
+			const int size   = 21;
+			const int middle = size / 2;
+
+			// Roof - two planes meeting at the middle column.
+			const auto roofHeight = [ middle ]( const int x ) { return (float)std::min( x, 2 * middle - x ); };
+
+			const std::shared_ptr< BlockMesh > mesh            = TestUtil::createGrid( size, roofHeight );
+			const int                          targetTriangles = (int)mesh->getTriangles().size() / 4;
+
+			const std::shared_ptr< BlockMesh > simplifiedMesh = MeshUtil::simplify( *mesh, targetTriangles );
+
+			Assert::IsTrue( (int)simplifiedMesh->getTriangles().size() <= targetTriangles, L"Simplified mesh has too many triangles" );
+
+			// Quadric error keeps the crease - there are enough triangles to simplify both planes without collapsing across it.
+			for ( const uint3& triangle : simplifiedMesh->getTriangles() ) {
+				const float x1 = simplifiedMesh->getVertices()[ triangle.x ].x;
+				const float x2 = simplifiedMesh->getVertices()[ triangle.y ].x;
+				const float x3 = simplifiedMesh->getVertices()[ triangle.z ].x;
+
+				const bool onLeftPlane  = x1 <= (float)middle && x2 <= (float)middle && x3 <= (float)middle;
+				const bool onRightPlane = x1 >= (float)middle && x2 >= (float)middle && x3 >= (float)middle;
+
+				Assert::IsTrue( onLeftPlane || onRightPlane, L"Triangle crosses the crease after simplification" );
+			}
+		}
+
+		TEST_METHOD( MeshUtil_Simplify_Keeps_Seams_1 ) {
+			const int size       = 21;
+			const int seamColumn = size / 2;
+
+			const std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( size, TestUtil::flatHeight, seamColumn );
+
+			// As much simplification as possible.
+			const std::shared_ptr< BlockMesh > simplifiedMesh = MeshUtil::simplify( *mesh, 0 );
+
+			Assert::IsTrue( simplifiedMesh->getTriangles().size() < mesh->getTriangles().size(), L"Mesh wasn't simplified" );
+
+			// Both copies of each seam vertex remain - with their own texcoords.
+			int seamVertexCount = 0;
+			for ( const float3& vertex : simplifiedMesh->getVertices() ) {
+				if ( vertex.x == (float)seamColumn )
+					++seamVertexCount;
+			}
+
+			Assert::AreEqual( size * 2, seamVertexCount, L"Seam vertices were removed during simplification" );
+		}
+
+		TEST_METHOD( MeshUtil_Generate_LODs_1 ) {
+			const std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 33 );
+
+			const std::vector< float > triangleRatios = { 0.5f, 0.25f, 0.1f };
+			const std::vector< float > distances      = { 10.0f, 20.0f, 40.0f };
+
+			const std::vector< std::shared_ptr< BlockMeshLOD > > lods = MeshUtil::generateLODs( *mesh, triangleRatios, distances );
+
+			Assert::AreEqual( 3, (int)lods.size(), L"Incorrect number of LODs" );
+
+			int previousTriangleCount = (int)mesh->getTriangles().size();
+			for ( size_t lodIdx = 0; lodIdx < lods.size(); ++lodIdx ) {
+				const std::shared_ptr< BlockMesh >& lodMesh = lods[ lodIdx ]->getMesh();
+
+				Assert::AreEqual( distances[ lodIdx ], lods[ lodIdx ]->getDistance(), L"LOD has incorrect distance" );
+				Assert::IsTrue( (int)lodMesh->getTriangles().size() <= (int)( mesh->getTriangles().size() * triangleRatios[ lodIdx ] ), L"LOD has too many triangles" );
+				Assert::IsTrue( (int)lodMesh->getTriangles().size() < previousTriangleCount, L"LOD should have fewer triangles than the previous LOD" );
+				Assert::IsTrue( lodMesh->getBvhTree() != nullptr, L"LOD doesn't have a BVH tree" );
+
+				previousTriangleCount = (int)lodMesh->getTriangles().size();
+			}
+
+			try {
+				MeshUtil::generateLODs( *mesh, triangleRatios, { 10.0f } );
+			} catch ( ... ) {
+				return;
+			}
+
+			Assert::Fail( L"MeshUtil::generateLODs() didn't throw for different number of triangle ratios and distances" );
+		}
+
+		TEST_METHOD( MeshUtil_Vertex_Cache_Stats_1 ) {
+			// Two separate triangles, the first one drawn again after the second one.
+			BlockMesh mesh( 6, false, 0, 3 );
+			mesh.getTriangles()[ 0 ] = uint3( 0, 1, 2 );
+			mesh.getTriangles()[ 1 ] = uint3( 3, 4, 5 );
+			mesh.getTriangles()[ 2 ] = uint3( 0, 1, 2 );
+
+			// First triangle is still in the cache.
+			const MeshUtil::VertexCacheStats stats1 = MeshUtil::calculateVertexCacheStats( mesh, 6 );
+
+			Assert::AreEqual( 2.0f, stats1.acmr, 0.0001f, L"Incorrect ACMR for the cache holding all vertices" );
+			Assert::AreEqual( 1.0f, stats1.atvr, 0.0001f, L"Incorrect ATVR for the cache holding all vertices" );
+
+			// First triangle was evicted by the second one.
+			const MeshUtil::VertexCacheStats stats2 = MeshUtil::calculateVertexCacheStats( mesh, 3 );
+
+			Assert::AreEqual( 3.0f, stats2.acmr, 0.0001f, L"Incorrect ACMR for the cache holding one triangle" );
+			Assert::AreEqual( 1.5f, stats2.atvr, 0.0001f, L"Incorrect ATVR for the cache holding one triangle" );
+
+			// Vertices already in the FIFO cache don't refresh their position - the last triangle misses all its vertices (LRU cache would keep vertices 0 and 2).
+			mesh.getTriangles()[ 1 ] = uint3( 0, 3, 4 );
+
+			const MeshUtil::VertexCacheStats stats3 = MeshUtil::calculateVertexCacheStats( mesh, 4 );
+
+			Assert::AreEqual( 8.0f / 3.0f, stats3.acmr, 0.0001f, L"Incorrect ACMR for the FIFO cache" );
+		}
+
+		TEST_METHOD( MeshUtil_Optimize_Triangle_Order_1 ) {
+			std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 64 );
+
+			// Random triangle order - the worst case for the vertex cache.
+			std::shuffle( mesh->getTriangles().begin(), mesh->getTriangles().end(), std::mt19937( 7 ) );
+
+			std::vector< uint3 > sortedTrianglesBefore = mesh->getTriangles();
+			std::sort( sortedTrianglesBefore.begin(), sortedTrianglesBefore.end(), isTriangleLess );
+
+			const MeshUtil::VertexCacheStats statsBefore = MeshUtil::calculateVertexCacheStats( *mesh, 16 );
+
+			MeshUtil::optimizeTriangleOrder( *mesh, 16 );
+
+			const MeshUtil::VertexCacheStats statsAfter = MeshUtil::calculateVertexCacheStats( *mesh, 16 );
+
+			// Grid has ~0.5 vertex per triangle - Tipsify should get close to that.
+			Assert::IsTrue( statsBefore.acmr > 2.0f, L"Shuffled triangles should have poor vertex cache use" );
+			Assert::IsTrue( statsAfter.acmr < 0.8f, L"Optimized triangles have poor vertex cache use" );
+			Assert::IsTrue( statsAfter.atvr < 1.5f, L"Optimized triangles transform vertices too many times" );
+
+			// Triangles are only reordered - with their vertex order (and so winding) unchanged.
+			std::vector< uint3 > sortedTrianglesAfter = mesh->getTriangles();
+			std::sort( sortedTrianglesAfter.begin(), sortedTrianglesAfter.end(), isTriangleLess );
+
+			Assert::IsTrue( sortedTrianglesAfter == sortedTrianglesBefore, L"Triangle order optimization changed the triangles" );
+		}
+
+		TEST_METHOD( MeshUtil_Optimize_Triangle_Order_Inside_BVH_Leaves_1 ) {
+			std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 64 );
+
+			std::shuffle( mesh->getTriangles().begin(), mesh->getTriangles().end(), std::mt19937( 7 ) );
+
+			mesh->buildBvhTree();
+
+			const std::vector< uint3 > trianglesBefore = mesh->getTriangles();
+
+			MeshUtil::optimizeTriangleOrder( *mesh, 16 );
+
+			// Each BVH leaf has to contain the same triangles as before.
+			for ( const BVHTreeBuffer::Node& node : mesh->getBvhTree()->getNodes() ) {
+				const unsigned int triangleCount = node.node.leaf.triangleCount;
+				if ( ( triangleCount & 0x80000000 ) == 0 )
+					continue;
+
+				const int firstTriangleIdx = (int)node.node.leaf.firstTriangleIndex;
+				const int endTriangleIdx   = firstTriangleIdx + (int)( triangleCount & 0x7FFFFFFF );
+
+				std::vector< uint3 > leafTrianglesBefore( trianglesBefore.begin() + firstTriangleIdx, trianglesBefore.begin() + endTriangleIdx );
+				std::vector< uint3 > leafTrianglesAfter( mesh->getTriangles().begin() + firstTriangleIdx, mesh->getTriangles().begin() + endTriangleIdx );
+
+				std::sort( leafTrianglesBefore.begin(), leafTrianglesBefore.end(), isTriangleLess );
+				std::sort( leafTrianglesAfter.begin(), leafTrianglesAfter.end(), isTriangleLess );
+
+				Assert::IsTrue( leafTrianglesAfter == leafTrianglesBefore, L"Triangles were moved between BVH leaves" );
+			}
+		}
+
+		TEST_METHOD( MeshUtil_Optimize_Vertex_Order_1 ) {
+			std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 32 );
+
+			std::shuffle( mesh->getTriangles().begin(), mesh->getTriangles().end(), std::mt19937( 7 ) );
+
+			std::vector< float3 > trianglePositionsBefore;
+			for ( const uint3& triangle : mesh->getTriangles() ) {
+				trianglePositionsBefore.push_back( mesh->getVertices()[ triangle.x ] );
+				trianglePositionsBefore.push_back( mesh->getVertices()[ triangle.y ] );
+				trianglePositionsBefore.push_back( mesh->getVertices()[ triangle.z ] );
+			}
+
+			MeshUtil::optimizeVertexOrder( *mesh );
+
+			// Vertices are in order of the first use.
+			int nextVertexIdx = 0;
+			for ( const uint3& triangle : mesh->getTriangles() ) {
+				for ( const unsigned int vertexIdx : { triangle.x, triangle.y, triangle.z } ) {
+					Assert::IsTrue( (int)vertexIdx <= nextVertexIdx, L"Vertices are not in order of the first use" );
+
+					if ( (int)vertexIdx == nextVertexIdx )
+						++nextVertexIdx;
+				}
+			}
+
+			// Triangles keep their positions and vertices keep their attributes.
+			for ( size_t triangleIdx = 0; triangleIdx < mesh->getTriangles().size(); ++triangleIdx ) {
+				const uint3& triangle = mesh->getTriangles()[ triangleIdx ];
+
+				Assert::IsTrue( mesh->getVertices()[ triangle.x ] == trianglePositionsBefore[ triangleIdx * 3 ]
+					&& mesh->getVertices()[ triangle.y ] == trianglePositionsBefore[ triangleIdx * 3 + 1 ]
+					&& mesh->getVertices()[ triangle.z ] == trianglePositionsBefore[ triangleIdx * 3 + 2 ], L"Triangle changed its vertex positions after vertex reordering" );
+			}
+
+			for ( size_t vertexIdx = 0; vertexIdx < mesh->getVertices().size(); ++vertexIdx ) {
+				const float3& vertex = mesh->getVertices()[ vertexIdx ];
+
+				Assert::IsTrue( mesh->getTexcoords( 0 )[ vertexIdx ] == float2( vertex.x / 31.0f, vertex.z / 31.0f ), L"Vertex has incorrect texcoord after vertex reordering" );
+			}
+		}
+
+		TEST_METHOD( MeshUtil_Transform_Vertices_Matches_Scalar_1 ) {
+			const float43 transform   = TestUtil::createTransform( float3( 0.3f, -1.2f, 2.1f ), float3( 5.0f, -2.0f, 3.0f ) );
+			const float33 orientation = transform.getOrientation();
+
+			// Ranges with counts and starts, which are not multiples of 4 (transformed partly with SSE, partly one by one)
+			// and a range split into many parts transformed on different threads.
+			const std::pair< int, int > ranges[] = { { 0, 1 }, { 0, 3 }, { 0, 4 }, { 1, 5 }, { 3, 10 }, { 2, 17 }, { 5, 2 * 64 * 1024 + 7 } };
+
+			for ( const auto& range : ranges ) {
+				const int startVertexIdx = range.first;
+				const int endVertexIdx   = range.first + range.second;
+
+				std::shared_ptr< BlockMesh > mesh         = createRandomMesh( endVertexIdx + 3, 0, 1, 11 );
+				std::shared_ptr< BlockMesh > originalMesh = createRandomMesh( endVertexIdx + 3, 0, 1, 11 );
+
+				MeshUtil::transformVertices( *mesh, transform, startVertexIdx, endVertexIdx );
+
+				for ( int vertexIdx = 0; vertexIdx < (int)mesh->getVertices().size(); ++vertexIdx ) {
+					const bool isInRange = vertexIdx >= startVertexIdx && vertexIdx < endVertexIdx;
+
+					const float3 expectedVertex  = isInRange ? originalMesh->getVertices()[ vertexIdx ] * transform : originalMesh->getVertices()[ vertexIdx ];
+					const float3 expectedNormal  = isInRange ? originalMesh->getNormals()[ vertexIdx ] * orientation : originalMesh->getNormals()[ vertexIdx ];
+					const float3 expectedTangent = isInRange ? originalMesh->getTangents()[ vertexIdx ] * orientation : originalMesh->getTangents()[ vertexIdx ];
+
+					Assert::IsTrue( TestUtil::areClose( expectedVertex, mesh->getVertices()[ vertexIdx ], 0.001f ), L"Vertex was transformed incorrectly" );
+					Assert::IsTrue( TestUtil::areClose( expectedNormal, mesh->getNormals()[ vertexIdx ], 0.001f ), L"Normal was transformed incorrectly" );
+					Assert::IsTrue( TestUtil::areClose( expectedTangent, mesh->getTangents()[ vertexIdx ], 0.001f ), L"Tangent was transformed incorrectly" );
+				}
+			}
+		}
+
+		TEST_METHOD( MeshUtil_Merge_Meshes_1 ) {
+			// First mesh is split into several chunks. Sizes are not multiples of 4.
+			std::vector< std::shared_ptr< BlockMesh > > meshes = {
+				createRandomMesh( 150001, 2, 70003, 1 ),
+				createRandomMesh( 7, 1, 5, 2 ),
+				createRandomMesh( 1001, 0, 999, 3 )
+			};
+
+			// Tangents are missing in the second mesh.
+			meshes[ 1 ]->getTangents().clear();
+
+			const std::vector< float43 > transforms = { 
+				TestUtil::createTransform( float3( 0.3f, 0.4f, 0.5f ), float3( 1.0f, 2.0f, 3.0f ) ),
+				TestUtil::createTransform( float3( -1.0f, 0.0f, 2.0f ), float3( -5.0f, 0.0f, 0.0f ) ),
+				float43::IDENTITY
+			};
+
+			for ( const bool transform : { true, false } ) {
+				const std::shared_ptr< BlockMesh > mergedMesh = MeshUtil::mergeMeshes( meshes, transform ? transforms : std::vector< float43 >() );
+
+				Assert::AreEqual( (size_t)( 150001 + 7 + 1001 ), mergedMesh->getVertices().size(), L"Merged mesh has incorrect number of vertices" );
+				Assert::AreEqual( (size_t)( 70003 + 5 + 999 ), mergedMesh->getTriangles().size(), L"Merged mesh has incorrect number of triangles" );
+				Assert::AreEqual( 2, mergedMesh->getTexcoordsCount(), L"Merged mesh has incorrect number of texcoord sets" );
+
+				size_t vertexOffset   = 0;
+				size_t triangleOffset = 0;
+				for ( size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx ) {
+					const BlockMesh& mesh          = *meshes[ meshIdx ];
+					const float43    meshTransform = transform ? transforms[ meshIdx ] : float43::IDENTITY;
+					const float33    orientation   = meshTransform.getOrientation();
+
+					for ( size_t vertexIdx = 0; vertexIdx < mesh.getVertices().size(); ++vertexIdx ) {
+						const size_t mergedVertexIdx = vertexOffset + vertexIdx;
+
+						const float3 expectedTangent = mesh.getTangents().empty() ? float3::ZERO : mesh.getTangents()[ vertexIdx ] * orientation;
+
+						Assert::IsTrue( TestUtil::areClose( mesh.getVertices()[ vertexIdx ] * meshTransform, mergedMesh->getVertices()[ mergedVertexIdx ], 0.001f ), L"Vertex was merged incorrectly" );
+						Assert::IsTrue( TestUtil::areClose( mesh.getNormals()[ vertexIdx ] * orientation, mergedMesh->getNormals()[ mergedVertexIdx ], 0.001f ), L"Normal was merged incorrectly" );
+						Assert::IsTrue( TestUtil::areClose( expectedTangent, mergedMesh->getTangents()[ mergedVertexIdx ], 0.001f ), L"Tangent was merged incorrectly" );
+
+						for ( int setIdx = 0; setIdx < 2; ++setIdx ) {
+							const float2 expectedTexcoord = setIdx < mesh.getTexcoordsCount() ? mesh.getTexcoords( setIdx )[ vertexIdx ] : float2::ZERO;
+
+							Assert::IsTrue( expectedTexcoord == mergedMesh->getTexcoords( setIdx )[ mergedVertexIdx ], L"Texcoord was merged incorrectly" );
+						}
+					}
+
+					const uint3 indexShift( (unsigned int)vertexOffset, (unsigned int)vertexOffset, (unsigned int)vertexOffset );
+					for ( size_t triangleIdx = 0; triangleIdx < mesh.getTriangles().size(); ++triangleIdx )
+						Assert::IsTrue( mesh.getTriangles()[ triangleIdx ] + indexShift == mergedMesh->getTriangles()[ triangleOffset + triangleIdx ], L"Triangle was merged incorrectly" );
+
+					vertexOffset   += mesh.getVertices().size();
+					triangleOffset += mesh.getTriangles().size();
+				}
+			}
+		}
+
+		// Compares CPU throughput of transforming and merging vertices with attributes in separate arrays (as stored in BlockMesh)
+		// and with interleaved attributes (as stored in the interleaved vertex buffer). Results are written to the test log.
+		TEST_METHOD( MeshUtil_Transform_And_Merge_Throughput_1 ) {
+			const float43 transform = TestUtil::createTransform( float3( 0.3f, 0.4f, 0.5f ), float3( 5.0f, -2.0f, 3.0f ) );
+			const int     runCount  = 5;
+
+			{ // Transform a single large mesh.
+				std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 512 );
+
+				const BlockMesh::InterleavedVertexFormat format      = MeshUtil::getInterleavedVertexFormat( *mesh, true );
+				std::vector< char >                      data        = MeshUtil::interleaveVertices( *mesh, format );
+				const size_t                             vertexCount = mesh->getVertices().size();
+
+				const double separateTime = TestUtil::measureShortestTime( runCount, [ & ]() {
+					MeshUtil::transformVertices( *mesh, transform, 0, (int)vertexCount );
+				} );
+
+				const double interleavedTime = TestUtil::measureShortestTime( runCount, [ & ]() {
+					ParallelUtil::parallelForRanges( vertexCount, 64 * 1024, [ & ]( const size_t begin, const size_t end ) {
+						transformInterleavedVertices( data.data() + begin * format.stride, data.data() + begin * format.stride, end - begin, format, transform );
+					} );
+				} );
+
+				logThroughput( "Transform", vertexCount, separateTime, interleavedTime );
+
+				std::shared_ptr< BlockMesh > interleavedMesh = TestUtil::createGrid( 512 );
+				MeshUtil::deinterleaveVertices( *interleavedMesh, data, format );
+
+				Assert::IsTrue( TestUtil::areClose( mesh->getVertices(), interleavedMesh->getVertices(), 0.01f ), L"Separate and interleaved positions were transformed differently" );
+				Assert::IsTrue( TestUtil::areClose( mesh->getNormals(), interleavedMesh->getNormals(), 0.0001f ), L"Separate and interleaved normals were transformed differently" );
+			}
+
+			{ // Merge many small meshes.
+				std::vector< std::shared_ptr< BlockMesh > > meshes;
+				std::vector< float43 >                      transforms;
+				for ( int meshIdx = 0; meshIdx < 256; ++meshIdx ) {
+					meshes.push_back( TestUtil::createGrid( 32 ) );
+					transforms.push_back( TestUtil::createTransform( float3( 0.0f, 0.1f * meshIdx, 0.0f ), float3( 40.0f * meshIdx, 0.0f, 0.0f ) ) );
+				}
+
+				const BlockMesh::InterleavedVertexFormat format = MeshUtil::getInterleavedVertexFormat( *meshes[ 0 ], true );
+
+				std::vector< std::vector< char > > meshesData;
+				std::vector< size_t >              vertexOffsets;
+				size_t                             vertexCount = 0;
+				for ( const auto& mesh : meshes ) {
+					meshesData.push_back( MeshUtil::interleaveVertices( *mesh, format ) );
+					vertexOffsets.push_back( vertexCount );
+					vertexCount += mesh->getVertices().size();
+				}
+
+				std::shared_ptr< BlockMesh > mergedMesh;
+				const double separateTime = TestUtil::measureShortestTime( runCount, [ & ]() {
+					mergedMesh = MeshUtil::mergeMeshes( meshes, transforms );
+				} );
+
+				// Merged the same way as by mergeMeshes() - output allocated once, each mesh transformed and copied to its place on many threads.
+				std::vector< char >  mergedData;
+				std::vector< uint3 > mergedTriangles;
+				const double interleavedTime = TestUtil::measureShortestTime( runCount, [ & ]() {
+					mergedData      = std::vector< char >( vertexCount * format.stride );
+					mergedTriangles = std::vector< uint3 >( mergedMesh->getTriangles().size() );
+
+					ParallelUtil::parallelFor( (int)meshes.size(), [ & ]( const int meshIdx ) {
+						const std::vector< uint3 >& triangles     = meshes[ meshIdx ]->getTriangles();
+						const size_t                vertexOffset  = vertexOffsets[ meshIdx ];
+						const uint3                 indexShift    = uint3( (unsigned int)vertexOffset, (unsigned int)vertexOffset, (unsigned int)vertexOffset );
+						uint3*                      dstTriangles  = mergedTriangles.data() + meshIdx * triangles.size(); // All meshes have the same size.
+
+						transformInterleavedVertices( meshesData[ meshIdx ].data(), mergedData.data() + vertexOffset * format.stride, meshes[ meshIdx ]->getVertices().size(), format, transforms[ meshIdx ] );
+
+						for ( size_t triangleIdx = 0; triangleIdx < triangles.size(); ++triangleIdx )
+							dstTriangles[ triangleIdx ] = triangles[ triangleIdx ] + indexShift;
+					} );
+				} );
+
+				logThroughput( "Merge", vertexCount, separateTime, interleavedTime );
+
+				BlockMesh interleavedMesh( (int)vertexCount, false, 0, 1 );
+				MeshUtil::deinterleaveVertices( interleavedMesh, mergedData, format );
+
+				Assert::IsTrue( TestUtil::areClose( mergedMesh->getVertices(), interleavedMesh.getVertices(), 0.001f ), L"Separate and interleaved positions were merged differently" );
+				Assert::IsTrue( TestUtil::areClose( mergedMesh->getTangents(), interleavedMesh.getTangents(), 0.0001f ), L"Separate and interleaved tangents were merged differently" );
+				Assert::IsTrue( mergedMesh->getTriangles() == mergedTriangles, L"Separate and interleaved triangles were merged differently" );
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TestUtil.h"
+
+#include "MeshletBuffer.h"
+#include "MeshUtil.h"
+#include "MathUtil.h"
+#include "BlockMesh.h"
+#include "float43.h"
+#include "float44.h"
+
+#include <algorithm>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( MeshletBufferTests )
+	{
+	private:
+
+		static float44 getViewProjectionMatrix( const float3& eye, const float3& at, const float3& up )
+		{
+			return MathUtil::lookAtTransformation( at, eye, up ) * MathUtil::perspectiveProjectionTransformation( MathUtil::pi / 2.0f, 1.0f, 0.1f, 1000.0f );
+		}
+
+		// Returns the number of meshlets visible from the camera placed over the grid center, at the given height and looking at the grid plane.
+		static int getVisibleMeshletCount( const BlockMesh& mesh, const float height, const float maxDistance, const bool cullBackfaces, std::vector< unsigned int >& indices )
+		{
+			const float3 center = mesh.getBoundingBox().getCenter();
+			const float3 eye( center.x, height, center.z );
+
+			const float44 viewProjectionMatrix = getViewProjectionMatrix( eye, center, float3( 0.0f, 0.0f, 1.0f ) );
+
+			return mesh.getMeshlets()->cull( float43::IDENTITY, viewProjectionMatrix, eye, maxDistance, cullBackfaces, indices );
+		}
+
+		static bool isTriangleLess( const uint3& triangle1, const uint3& triangle2 )
+		{
+			if ( triangle1.x != triangle2.x ) return triangle1.x < triangle2.x;
+			if ( triangle1.y != triangle2.y ) return triangle1.y < triangle2.y;
+			return triangle1.z < triangle2.z;
+		}
+
+		// Returns mesh triangles referenced by meshlets (sorted).
+		static std::vector< uint3 > getMeshletTriangles( const MeshletBuffer& meshlets )
+		{
+			std::vector< uint3 > triangles;
+
+			for ( const MeshletBuffer::Meshlet& meshlet : meshlets.getMeshlets() ) {
+				for ( unsigned int triangleIdx = 0; triangleIdx < meshlet.triangleCount; ++triangleIdx ) {
+					const unsigned char* localIndices = &meshlets.getTriangles()[ ( meshlet.triangleOffset + triangleIdx ) * 3 ];
+
+					triangles.push_back( uint3( meshlets.getVertices()[ meshlet.vertexOffset + localIndices[ 0 ] ],
+												meshlets.getVertices()[ meshlet.vertexOffset + localIndices[ 1 ] ],
+												meshlets.getVertices()[ meshlet.vertexOffset + localIndices[ 2 ] ] ) );
+				}
+			}
+
+			std::sort( triangles.begin(), triangles.end(), isTriangleLess );
+
+			return triangles;
+		}
+
+		static std::vector< uint3 > getSortedTriangles( const BlockMesh& mesh )
+		{
+			std::vector< uint3 > triangles = mesh.getTriangles();
+			std::sort( triangles.begin(), triangles.end(), isTriangleLess );
+
+			return triangles;
+		}
+
+	public:
+
+		TEST_METHOD( MeshletBuffer_Build_1 ) {
+			std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 33 );
+
+			mesh->buildMeshlets( 64, 100 );
+
+			const MeshletBuffer& meshlets = *mesh->getMeshlets();
+
+			Assert::IsTrue( meshlets.getMeshlets().size() > 1, L"Mesh should be split into several meshlets" );
+
+			// Each triangle belongs to exactly one meshlet - with its winding order.
+			Assert::IsTrue( getMeshletTriangles( meshlets ) == getSortedTriangles( *mesh ), L"Meshlets don't contain all mesh triangles exactly once" );
+
+			for ( const MeshletBuffer::Meshlet& meshlet : meshlets.getMeshlets() ) {
+				Assert::IsTrue( meshlet.vertexCount <= 64 && meshlet.triangleCount <= 100, L"Meshlet exceeds the max vertex or triangle count" );
+
+				for ( unsigned int localIdx = 0; localIdx < meshlet.vertexCount; ++localIdx ) {
+					const float3& vertex = mesh->getVertices()[ meshlets.getVertices()[ meshlet.vertexOffset + localIdx ] ];
+
+					Assert::IsTrue( ( vertex - meshlet.boundingSphereCenter ).length() <= meshlet.boundingSphereRadius + 0.0001f, L"Meshlet vertex is outside of the bounding sphere" );
+				}
+
+				// Flat meshlets have the narrowest cone possible - facing the vertex normals.
+				Assert::IsTrue( dot( meshlet.coneAxis, float3( 0.0f, 1.0f, 0.0f ) ) > 0.9999f, L"Meshlet has incorrect cone axis" );
+				Assert::AreEqual( 0.0f, meshlet.coneCutoff, 0.001f, L"Meshlet has incorrect cone cutoff" );
+			}
+
+			try {
+				mesh->buildMeshlets( 300, 100 );
+			} catch ( ... ) {
+				return;
+			}
+
+			Assert::Fail( L"Building meshlets didn't throw for max vertex count not fitting in 8-bit indices" );
+		}
+
+		TEST_METHOD( MeshletBuffer_Cull_1 ) {
+			std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 33 );
+
+			mesh->buildMeshlets();
+
+			const int meshletCount = (int)mesh->getMeshlets()->getMeshlets().size();
+
+			std::vector< unsigned int > indices;
+
+			// Front side, all meshlets in the frustum.
+			Assert::AreEqual( meshletCount, getVisibleMeshletCount( *mesh, 50.0f, 0.0f, true, indices ), L"Incorrect number of visible meshlets from the front side" );
+			Assert::AreEqual( (int)mesh->getTriangles().size() * 3, (int)indices.size(), L"Incorrect number of indices of visible meshlets" );
+
+			// Back side - culled by normal cones only if back faces are culled.
+			Assert::AreEqual( 0, getVisibleMeshletCount( *mesh, -50.0f, 0.0f, true, indices ), L"Meshlets seen from the back side should be culled" );
+			Assert::IsTrue( indices.empty(), L"Culled meshlets shouldn't output any indices" );
+			Assert::AreEqual( meshletCount, getVisibleMeshletCount( *mesh, -50.0f, 0.0f, false, indices ), L"Meshlets seen from the back side shouldn't be culled if back faces are rendered" );
+
+			// Distance.
+			Assert::AreEqual( 0, getVisibleMeshletCount( *mesh, 50.0f, 10.0f, true, indices ), L"Meshlets further than max distance should be culled" );
+
+			// Frustum - camera looking away from the grid.
+			const float3  eye( 16.0f, 50.0f, 16.0f );
+			const float44 viewProjectionMatrix = getViewProjectionMatrix( eye, float3( 16.0f, 100.0f, 16.0f ), float3( 0.0f, 0.0f, 1.0f ) );
+
+			Assert::AreEqual( 0, mesh->getMeshlets()->cull( float43::IDENTITY, viewProjectionMatrix, eye, 0.0f, false, indices ), L"Meshlets outside of the frustum should be culled" );
+
+			// Frustum - world matrix moving the grid in front of the camera.
+			const float43 worldMatrix( 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 100.0f, 0.0f );
+
+			Assert::AreEqual( meshletCount, mesh->getMeshlets()->cull( worldMatrix, viewProjectionMatrix, eye, 0.0f, false, indices ), L"World matrix should be applied to meshlets" );
+		}
+
+		TEST_METHOD( MeshletBuffer_Winding_Inversion_And_Normal_Flip_1 ) {
+			std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 33 );
+
+			mesh->buildMeshlets();
+
+			std::vector< unsigned int > indices;
+
+			MeshUtil::invertVertexWindingOrder( *mesh );
+
+			// Meshlets follow the new winding. Front side is still given by the normals.
+			Assert::IsTrue( getMeshletTriangles( *mesh->getMeshlets() ) == getSortedTriangles( *mesh ), L"Meshlet triangles don't match mesh triangles after winding inversion" );
+			Assert::AreEqual( 0, getVisibleMeshletCount( *mesh, -50.0f, 0.0f, true, indices ), L"Meshlets seen from the back side should be culled after winding inversion" );
+
+			for ( const MeshletBuffer::Meshlet& meshlet : mesh->getMeshlets()->getMeshlets() )
+				Assert::IsTrue( dot( meshlet.coneAxis, float3( 0.0f, 1.0f, 0.0f ) ) > 0.9999f, L"Meshlet has incorrect cone axis after winding inversion" );
+
+			// Flipping normals swaps the front and back side.
+			MeshUtil::flipNormals( *mesh );
+
+			const int meshletCount = (int)mesh->getMeshlets()->getMeshlets().size();
+
+			Assert::AreEqual( meshletCount, getVisibleMeshletCount( *mesh, -50.0f, 0.0f, true, indices ), L"Meshlets seen from the new front side should be visible after flipping normals" );
+			Assert::AreEqual( 0, getVisibleMeshletCount( *mesh, 50.0f, 0.0f, true, indices ), L"Meshlets seen from the new back side should be culled after flipping normals" );
+		}
+
+		TEST_METHOD( MeshletBuffer_Transform_Vertices_1 ) {
+			std::shared_ptr< BlockMesh > mesh = TestUtil::createGrid( 33 );
+
+			mesh->buildMeshlets();
+
+			// Upside down and moved - bounds and cones have to follow the vertices.
+			const float43 transform( 1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 10.0f, 32.0f );
+
+			MeshUtil::transformVertices( *mesh, transform, 0, (int)mesh->getVertices().size() );
+			mesh->recalculateBoundingBox();
+
+			const int meshletCount = (int)mesh->getMeshlets()->getMeshlets().size();
+
+			std::vector< unsigned int > indices;
+
+			Assert::AreEqual( meshletCount, getVisibleMeshletCount( *mesh, -50.0f, 0.0f, true, indices ), L"Transformed meshlets seen from the front side should be visible" );
+			Assert::AreEqual( 0, getVisibleMeshletCount( *mesh, 60.0f, 0.0f, true, indices ), L"Transformed meshlets seen from the back side should be culled" );
+
+			for ( const MeshletBuffer::Meshlet& meshlet : mesh->getMeshlets()->getMeshlets() )
+				Assert::AreEqual( 10.0f, meshlet.boundingSphereCenter.y, 0.0001f, L"Meshlet bounding sphere doesn't follow the transformed vertices" );
+		}
+	};
+}
@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "ObjFileParser.h"
+#include "BlockMesh.h"
+
+#include <string>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( ObjFileParserTests )
+	{
+	private:
+
+		static std::vector< std::shared_ptr< BlockMesh > > parse( const std::string& text, const bool invertZCoordinate = false, const bool invertVertexWindingOrder = false, const bool flipUVs = false )
+		{
+			const std::vector< char > data( text.begin(), text.end() );
+
+			return ObjFileParser::parseBlockMeshFile( data.cbegin(), data.cend(), invertZCoordinate, invertVertexWindingOrder, flipUVs );
+		}
+
+		// Positions of 'count' separate triangles - triangle i has all its vertices at x = i.
+		static std::string separateTriangles( const int count )
+		{
+			std::string text;
+			for ( int triangleIdx = 0; triangleIdx < count; ++triangleIdx ) {
+				const std::string x = std::to_string( triangleIdx );
+
+				text += "v " + x + " 0 0\nv " + x + " 1 0\nv " + x + " 0 1\n";
+			}
+
+			return text;
+		}
+
+		// Face using the triangle from separateTriangles.
+		static std::string face( const int triangleIdx )
+		{
+			return "f " + std::to_string( triangleIdx * 3 + 1 ) + " " + std::to_string( triangleIdx * 3 + 2 ) + " " + std::to_string( triangleIdx * 3 + 3 ) + "\n";
+		}
+
+		// Returns indices of the triangles from separateTriangles contained in the mesh (in order).
+		static std::vector< int > getTriangleIndices( const BlockMesh& mesh )
+		{
+			std::vector< int > triangleIndices;
+			for ( const uint3& triangle : mesh.getTriangles() )
+				triangleIndices.push_back( (int)mesh.getVertices()[ triangle.x ].x );
+
+			return triangleIndices;
+		}
+
+		static void assertMeshes( const std::vector< std::shared_ptr< BlockMesh > >& meshes, const std::vector< std::vector< int > >& expectedTriangleIndices )
+		{
+			Assert::AreEqual( (int)expectedTriangleIndices.size(), (int)meshes.size(), L"Incorrect number of meshes" );
+
+			for ( size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx )
+				Assert::IsTrue( getTriangleIndices( *meshes[ meshIdx ] ) == expectedTriangleIndices[ meshIdx ], L"Mesh contains incorrect triangles or meshes are in incorrect order" );
+		}
+
+	public:
+
+		TEST_METHOD( ObjFileParser_Objects_Split_Meshes_1 ) {
+			// Reusing object name doesn't start a new mesh - faces still go to the current mesh.
+			const std::string text = separateTriangles( 4 )
+				+ face( 0 )
+				+ "o A\n" + face( 1 )
+				+ "o B\n" + face( 2 )
+				+ "o A\n" + face( 3 );
+
+			assertMeshes( parse( text ), { { 0 }, { 1 }, { 2, 3 } } );
+		}
+
+		TEST_METHOD( ObjFileParser_Groups_Split_Meshes_1 ) {
+			// Repeating the active group is ignored. Switching back to an earlier group creates a new mesh.
+			const std::string text = separateTriangles( 5 )
+				+ "g G1\n" + face( 0 )
+				+ "g G1\n" + face( 1 )
+				+ "g G2\n" + face( 2 )
+				+ "g G1\n" + face( 3 )
+				+ "g Group with spaces\n" + face( 4 );
+
+			assertMeshes( parse( text ), { { 0, 1 }, { 2 }, { 3 }, { 4 } } );
+		}
+
+		TEST_METHOD( ObjFileParser_Materials_Split_Meshes_1 ) {
+			// Faces preceding the first material get it. Repeated material is ignored.
+			// Material change right after an object (without faces in between) doesn't create an empty mesh.
+			const std::string text = separateTriangles( 6 )
+				+ face( 0 )
+				+ "usemtl M1\n" + face( 1 )
+				+ "usemtl M1\n" + face( 2 )
+				+ "usemtl M2\n" + face( 3 )
+				+ "o A\n"
+				+ "usemtl M3\n" + face( 4 )
+				+ "usemtl M2\n" + face( 5 );
+
+			assertMeshes( parse( text ), { { 0, 1, 2 }, { 3 }, { 4 }, { 5 } } );
+		}
+
+		TEST_METHOD( ObjFileParser_Meshes_Ordered_By_Object_1 ) {
+			// Material change after switching back to an existing object creates a mesh in that object - it comes before meshes of later objects.
+			const std::string text = separateTriangles( 3 )
+				+ "usemtl M1\n"
+				+ "o A\n" + face( 0 )
+				+ "o B\n" + face( 1 )
+				+ "o A\n"
+				+ "usemtl M2\n" + face( 2 );
+
+			assertMeshes( parse( text ), { { 0 }, { 2 }, { 1 } } );
+		}
+
+		TEST_METHOD( ObjFileParser_Meshes_Split_Across_Chunks_1 ) {
+			// Large enough to be parsed in several chunks.
+			const int objectCount = 40000;
+
+			std::string text = separateTriangles( objectCount );
+			for ( int objectIdx = 0; objectIdx < objectCount; ++objectIdx )
+				text += "o Object" + std::to_string( objectIdx % ( objectCount / 2 ) ) + "\n" + face( objectIdx );
+
+			Assert::IsTrue( text.size() > 2 * 1024 * 1024, L"Test file is too small to be split into several chunks" );
+
+			// Objects in the second half reuse names from the first half - they continue the meshes of the preceding objects.
+			std::vector< std::vector< int > > expectedTriangleIndices;
+			for ( int objectIdx = 0; objectIdx < objectCount / 2 - 1; ++objectIdx )
+				expectedTriangleIndices.push_back( { objectIdx } );
+
+			expectedTriangleIndices.push_back( {} );
+			for ( int triangleIdx = objectCount / 2 - 1; triangleIdx < objectCount; ++triangleIdx )
+				expectedTriangleIndices.back().push_back( triangleIdx );
+
+			assertMeshes( parse( text ), expectedTriangleIndices );
+		}
+
+		TEST_METHOD( ObjFileParser_Polygons_And_Vertex_Welding_1 ) {
+			// Quad with relative indices and a triangle sharing two of its corners (with the same attributes) and one position (with a different texcoord).
+			const std::string text =
+				"v 0 0 0\nv 1 0 0\nv 1 0 1\nv 0 0 1\n"
+				"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+				"vn 0 1 0\n"
+				"f -4/-4/-1 -3/-3/-1 -2/-2/-1 -1/-1/-1\n"
+				"f 1/1/1 3/3/1 3/1/1 # comment\n";
+
+			const std::vector< std::shared_ptr< BlockMesh > > meshes = parse( text );
+
+			Assert::AreEqual( 1, (int)meshes.size(), L"Incorrect number of meshes" );
+
+			const BlockMesh& mesh = *meshes[ 0 ];
+
+			Assert::AreEqual( 5, (int)mesh.getVertices().size(), L"Identical face corners should be welded, different ones kept separate" );
+			Assert::AreEqual( 3, (int)mesh.getTriangles().size(), L"Quad should be triangulated as a fan" );
+			Assert::AreEqual( 5, (int)mesh.getNormals().size(), L"Incorrect number of normals" );
+			Assert::AreEqual( 1, mesh.getTexcoordsCount(), L"Incorrect number of texcoord sets" );
+
+			Assert::IsTrue( mesh.getTriangles()[ 0 ] == uint3( 0, 1, 2 ) && mesh.getTriangles()[ 1 ] == uint3( 0, 2, 3 ), L"Incorrect fan triangulation" );
+			Assert::IsTrue( mesh.getTriangles()[ 2 ] == uint3( 0, 2, 4 ), L"Shared corners should reuse vertices" );
+
+			Assert::IsTrue( mesh.getVertices()[ 4 ] == mesh.getVertices()[ 2 ], L"Vertex with a different texcoord should have the same position" );
+			Assert::IsTrue( mesh.getTexcoords( 0 )[ 4 ] == float2( 0.0f, 0.0f ), L"Vertex with a different texcoord has incorrect texcoord" );
+		}
+
+		TEST_METHOD( ObjFileParser_Import_Options_1 ) {
+			const std::string text =
+				"v 1 2 3\nv 4 5 6\nv 7 8 9\n"
+				"vt 0.25 0.75\n"
+				"f 1/1 2/1 3/1\n";
+
+			const std::vector< std::shared_ptr< BlockMesh > > meshes = parse( text, true, true, true );
+			const BlockMesh&                                  mesh   = *meshes[ 0 ];
+
+			Assert::IsTrue( mesh.getVertices()[ 0 ] == float3( 1.0f, 2.0f, -3.0f ), L"Z coordinate should be inverted" );
+			Assert::IsTrue( mesh.getTriangles()[ 0 ] == uint3( 2, 1, 0 ), L"Winding order should be inverted" );
+			Assert::AreEqual( 0.25f, mesh.getTexcoords( 0 )[ 0 ].y, 0.0001f, L"UVs should be flipped" );
+			Assert::IsTrue( mesh.getNormals().empty(), L"Mesh without normals in the file shouldn't have normals" );
+		}
+
+		TEST_METHOD( ObjFileParser_Invalid_Index_1 ) {
+			const std::string text =
+				"v 0 0 0\nv 1 0 0\nv 1 0 1\n"
+				"f 1 2 4\n";
+
+			try {
+				parse( text );
+			} catch ( ... ) {
+				return;
+			}
+
+			Assert::Fail( L"Parsing should fail for an index out of range" );
+		}
+	};
+}
@@ -0,0 +1,97 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "ParallelUtil.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( ParallelUtilTests )
+	{
+	private:
+
+		// Returns thread ids of the items - processed by parallelFor, optionally from a nested call.
+		static std::vector< std::thread::id > getItemThreadIds( const int count, const bool nested )
+		{
+			std::vector< std::thread::id > threadIds( count * count );
+
+			ParallelUtil::parallelFor( count, [ & ]( const int index ) {
+				if ( !nested ) {
+					threadIds[ index ] = std::this_thread::get_id();
+					return;
+				}
+
+				const std::thread::id outerThreadId = std::this_thread::get_id();
+
+				ParallelUtil::parallelFor( count, [ & ]( const int nestedIndex ) {
+					// Nested item is marked if it didn't run on the thread of the outer item.
+					threadIds[ index * count + nestedIndex ] = std::this_thread::get_id() == outerThreadId ? outerThreadId : std::thread::id();
+				} );
+			} );
+
+			return threadIds;
+		}
+
+	public:
+
+		TEST_METHOD( ParallelUtil_Parallel_For_1 ) {
+			const int count = 10000;
+
+			std::vector< std::atomic< int > > callCounts( count );
+			for ( std::atomic< int >& callCount : callCounts )
+				callCount = 0;
+
+			ParallelUtil::parallelFor( count, [ &callCounts ]( const int index ) {
+				++callCounts[ index ];
+			} );
+
+			Assert::IsTrue( std::all_of( callCounts.begin(), callCounts.end(), []( const std::atomic< int >& callCount ) { return callCount == 1; } ), L"Each item should be processed once" );
+
+			bool thrown = false;
+			try {
+				ParallelUtil::parallelFor( count, [ count ]( const int index ) {
+					if ( index == count / 2 )
+						throw std::exception( "Item failed." );
+				} );
+			} catch ( const std::exception& ) {
+				thrown = true;
+			}
+
+			Assert::IsTrue( thrown, L"Exception thrown by an item was not re-thrown" );
+		}
+
+		TEST_METHOD( ParallelUtil_Serial_On_Worker_Thread_1 ) {
+			const int count = 64;
+
+			Assert::IsFalse( ParallelUtil::isWorkerThread(), L"Thread shouldn't be a worker by default" );
+
+			{
+				ParallelUtil::WorkerThreadScope workerThreadScope;
+
+				Assert::IsTrue( ParallelUtil::isWorkerThread(), L"Thread should be a worker in the scope" );
+
+				const std::vector< std::thread::id > threadIds = getItemThreadIds( count, false );
+
+				Assert::IsTrue( std::all_of( threadIds.begin(), threadIds.begin() + count, []( const std::thread::id& threadId ) { return threadId == std::this_thread::get_id(); } ),
+					L"Items should be processed on the worker thread" );
+			}
+
+			Assert::IsFalse( ParallelUtil::isWorkerThread(), L"Thread should stop being a worker at the end of the scope" );
+
+			// Threads processing the items are workers too.
+			const std::vector< std::thread::id > nestedThreadIds = getItemThreadIds( count, true );
+
+			Assert::IsTrue( std::none_of( nestedThreadIds.begin(), nestedThreadIds.end(), []( const std::thread::id& threadId ) { return threadId == std::thread::id(); } ),
+				L"Nested items should be processed on the thread of the outer item" );
+
+			Assert::IsFalse( ParallelUtil::isWorkerThread(), L"Thread calling parallelFor shouldn't remain a worker" );
+		}
+	};
+}
@@ -0,0 +1,247 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TestUtil.h"
+
+#include "SkeletonPose.h"
+#include "SkeletonMesh.h"
+#include "MathUtil.h"
+
+#include <random>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( SkeletonPoseTests )
+	{
+	private:
+
+		// Bones are added with children before their parents: 3 is the root, 1 and 4 are its children, 2 is a child of 1 and 5 a child of 2.
+		static std::shared_ptr< SkeletonMesh > createSkeleton()
+		{
+			std::shared_ptr< SkeletonMesh > mesh = std::make_shared< SkeletonMesh >();
+
+			mesh->addOrModifyBone( 1, "Bone1", 3, float43::IDENTITY );
+			mesh->addOrModifyBone( 2, "Bone2", 1, float43::IDENTITY );
+			mesh->addOrModifyBone( 3, "Bone3", 0, float43::IDENTITY );
+			mesh->addOrModifyBone( 4, "Bone4", 3, float43::IDENTITY );
+			mesh->addOrModifyBone( 5, "Bone5", 2, float43::IDENTITY );
+
+			return mesh;
+		}
+
+		static SkeletonPose createRandomPose( const SkeletonMesh& mesh, const unsigned int seed )
+		{
+			std::mt19937                            random( seed );
+			std::uniform_real_distribution< float > angle( -MathUtil::pi, MathUtil::pi );
+			std::uniform_real_distribution< float > offset( -2.0f, 2.0f );
+
+			SkeletonPose pose;
+			for ( unsigned char boneIndex = 1; boneIndex <= mesh.getBoneCount(); ++boneIndex )
+				pose.setBonePose( boneIndex, TestUtil::createTransform( float3( angle( random ), angle( random ), angle( random ) ), float3( offset( random ), offset( random ), offset( random ) ) ) );
+
+			return pose;
+		}
+
+		// Reference - walks up the hierarchy separately for each bone.
+		static float43 calculateBonePoseInSkeletonSpace( const SkeletonPose& poseInParentSpace, const SkeletonMesh& mesh, const unsigned char boneIndex )
+		{
+			const unsigned char parentBoneIndex = mesh.getBone( boneIndex ).getParentBoneIndex();
+
+			if ( parentBoneIndex == 0 )
+				return poseInParentSpace.getBonePose( boneIndex );
+
+			return poseInParentSpace.getBonePose( boneIndex ) * calculateBonePoseInSkeletonSpace( poseInParentSpace, mesh, parentBoneIndex );
+		}
+
+	public:
+
+		TEST_METHOD( SkeletonPose_Set_And_Get_Bone_Pose_1 ) {
+			const float43 bonePose1 = TestUtil::createTransform( float3( 0.1f, 0.2f, 0.3f ), float3( 1.0f, 2.0f, 3.0f ) );
+			const float43 bonePose2 = TestUtil::createTransform( float3( -0.5f, 0.0f, 1.0f ), float3( -4.0f, 5.0f, 0.0f ) );
+
+			SkeletonPose pose;
+
+			Assert::AreEqual( 0, (int)pose.getBonesCount(), L"Empty pose contains bones" );
+
+			// Bones don't have to be set in order - pose grows to the highest bone index.
+			pose.setBonePose( 200, bonePose2 );
+			pose.setBonePose( 3, bonePose1 );
+
+			Assert::AreEqual( 2, (int)pose.getBonesCount(), L"Pose has incorrect number of bones" );
+			Assert::IsTrue( TestUtil::areClose( bonePose1, pose.getBonePose( 3 ) ), L"Pose returned incorrect bone pose" );
+			Assert::IsTrue( TestUtil::areClose( bonePose2, pose.getBonePose( 200 ) ), L"Pose returned incorrect bone pose for a high bone index" );
+
+			// Setting an existing bone replaces its pose.
+			pose.setBonePose( 3, bonePose2 );
+
+			Assert::AreEqual( 2, (int)pose.getBonesCount(), L"Replacing bone pose changed the number of bones" );
+			Assert::IsTrue( TestUtil::areClose( bonePose2, pose.getBonePose( 3 ) ), L"Bone pose wasn't replaced" );
+
+			// Copies are independent.
+			SkeletonPose copiedPose( pose );
+			pose.clear();
+
+			Assert::AreEqual( 0, (int)pose.getBonesCount(), L"Cleared pose contains bones" );
+			Assert::AreEqual( 2, (int)copiedPose.getBonesCount(), L"Copied pose has incorrect number of bones" );
+			Assert::IsTrue( TestUtil::areClose( bonePose2, copiedPose.getBonePose( 200 ) ), L"Copied pose has incorrect bone pose" );
+		}
+
+		TEST_METHOD( SkeletonPose_Missing_Bone_1 ) {
+			SkeletonPose pose;
+			pose.setBonePose( 5, float43::IDENTITY );
+
+			// Bones below and above the highest bone index set so far.
+			for ( const unsigned char boneIndex : { (unsigned char)4, (unsigned char)6 } ) {
+				try {
+					pose.getBonePose( boneIndex );
+					Assert::Fail( L"SkeletonPose::getBonePose() didn't throw for a missing bone" );
+				} catch ( const std::exception& ) {}
+			}
+
+			try {
+				pose.setBonePose( 0, float43::IDENTITY );
+			} catch ( const std::exception& ) {
+				return;
+			}
+
+			Assert::Fail( L"SkeletonPose::setBonePose() didn't throw for bone index 0" );
+		}
+
+		TEST_METHOD( SkeletonPose_Blend_Poses_1 ) {
+			const float43 bone1Pose = TestUtil::createTransform( float3( 0.3f, 0.0f, 0.0f ), float3( 1.0f, 0.0f, 0.0f ) );
+			const float43 bone3Pose = TestUtil::createTransform( float3( 0.0f, 0.0f, 0.7f ), float3( 0.0f, 0.0f, 3.0f ) );
+
+			// Bone 1 only in the first pose, bone 3 only in the second pose, bone 2 in both.
+			SkeletonPose pose1;
+			pose1.setBonePose( 1, bone1Pose );
+			pose1.setBonePose( 2, TestUtil::createTransform( float3::ZERO, float3( 0.0f, 2.0f, 0.0f ) ) );
+
+			SkeletonPose pose2;
+			pose2.setBonePose( 2, TestUtil::createTransform( float3( 0.0f, MathUtil::pi / 2.0f, 0.0f ), float3( 0.0f, 4.0f, 2.0f ) ) );
+			pose2.setBonePose( 3, bone3Pose );
+
+			const SkeletonPose blendedPose = SkeletonPose::blendPoses( pose1, pose2, 0.5f );
+
+			Assert::AreEqual( 3, (int)blendedPose.getBonesCount(), L"Blended pose has incorrect number of bones" );
+			Assert::IsTrue( TestUtil::areClose( bone1Pose, blendedPose.getBonePose( 1 ) ), L"Bone present only in the first pose should be used without blending" );
+			Assert::IsTrue( TestUtil::areClose( bone3Pose, blendedPose.getBonePose( 3 ) ), L"Bone present only in the second pose should be used without blending" );
+			Assert::IsTrue( TestUtil::areClose( TestUtil::createTransform( float3( 0.0f, MathUtil::pi / 4.0f, 0.0f ), float3( 0.0f, 3.0f, 1.0f ) ), blendedPose.getBonePose( 2 ) ), L"Bone present in both poses was blended incorrectly" );
+
+			// Factors 0 and 1 return the poses unchanged.
+			Assert::IsTrue( TestUtil::areClose( pose1.getBonePose( 2 ), SkeletonPose::blendPoses( pose1, pose2, 0.0f ).getBonePose( 2 ), 0.0f ), L"Blending with factor 0 should return the first pose" );
+			Assert::IsTrue( TestUtil::areClose( pose2.getBonePose( 2 ), SkeletonPose::blendPoses( pose1, pose2, 1.0f ).getBonePose( 2 ), 0.0f ), L"Blending with factor 1 should return the second pose" );
+		}
+
+		TEST_METHOD( SkeletonPose_Bone_Order_1 ) {
+			const std::shared_ptr< SkeletonMesh > mesh = createSkeleton();
+
+			Assert::IsTrue( mesh->hasValidBoneHierarchy(), L"Skeleton should have a valid bone hierarchy" );
+			Assert::AreEqual( 5, (int)mesh->getBoneOrder().size(), L"Bone order has incorrect number of bones" );
+
+			// Each bone comes after its parent.
+			std::vector< bool > visited( 6, false );
+			for ( const unsigned char boneIndex : mesh->getBoneOrder() ) {
+				const unsigned char parentBoneIndex = mesh->getParentBoneIndices()[ boneIndex ];
+
+				Assert::AreEqual( (int)mesh->getBone( boneIndex ).getParentBoneIndex(), (int)parentBoneIndex, L"Incorrect parent bone index" );
+				Assert::IsTrue( parentBoneIndex == 0 || visited[ parentBoneIndex ], L"Bone comes before its parent in the bone order" );
+				Assert::IsFalse( visited[ boneIndex ], L"Bone is repeated in the bone order" );
+
+				visited[ boneIndex ] = true;
+			}
+		}
+
+		TEST_METHOD( SkeletonPose_Convert_Between_Parent_And_Skeleton_Space_1 ) {
+			const std::shared_ptr< SkeletonMesh > mesh = createSkeleton();
+
+			const SkeletonPose poseInParentSpace   = createRandomPose( *mesh, 7 );
+			const SkeletonPose poseInSkeletonSpace = SkeletonPose::calculatePoseInSkeletonSpace( poseInParentSpace, *mesh );
+
+			Assert::AreEqual( 5, (int)poseInSkeletonSpace.getBonesCount(), L"Pose in skeleton space has incorrect number of bones" );
+
+			for ( unsigned char boneIndex = 1; boneIndex <= 5; ++boneIndex ) {
+				Assert::IsTrue( TestUtil::areClose( calculateBonePoseInSkeletonSpace( poseInParentSpace, *mesh, boneIndex ), poseInSkeletonSpace.getBonePose( boneIndex ) ),
+								L"Bone pose in skeleton space differs from the reference" );
+			}
+
+			// Round trip.
+			const SkeletonPose convertedPoseInParentSpace = SkeletonPose::calculatePoseInParentSpace( poseInSkeletonSpace, *mesh );
+
+			Assert::AreEqual( 5, (int)convertedPoseInParentSpace.getBonesCount(), L"Pose in parent space has incorrect number of bones" );
+
+			for ( unsigned char boneIndex = 1; boneIndex <= 5; ++boneIndex ) {
+				Assert::IsTrue( TestUtil::areClose( poseInParentSpace.getBonePose( boneIndex ), convertedPoseInParentSpace.getBonePose( boneIndex ), 0.001f ),
+								L"Bone pose converted to skeleton space and back differs from the original" );
+			}
+
+			// Identity pose in parent space is identity in skeleton space too.
+			const SkeletonPose identityPose = SkeletonPose::createIdentityPoseInSkeletonSpace( *mesh );
+
+			Assert::AreEqual( 5, (int)identityPose.getBonesCount(), L"Identity pose has incorrect number of bones" );
+
+			for ( unsigned char boneIndex = 1; boneIndex <= 5; ++boneIndex )
+				Assert::IsTrue( TestUtil::areClose( float43::IDENTITY, identityPose.getBonePose( boneIndex ) ), L"Identity pose contains a non-identity bone pose" );
+		}
+
+		TEST_METHOD( SkeletonPose_Convert_Partial_Pose_1 ) {
+			const std::shared_ptr< SkeletonMesh > mesh = createSkeleton();
+
+			// Without bone 1 (parent of bone 2).
+			const SkeletonPose fullPose = createRandomPose( *mesh, 11 );
+
+			SkeletonPose partialPose;
+			for ( const unsigned char boneIndex : { (unsigned char)2, (unsigned char)3, (unsigned char)4, (unsigned char)5 } )
+				partialPose.setBonePose( boneIndex, fullPose.getBonePose( boneIndex ) );
+
+			// Pose in parent space can't be calculated for bones without a parent pose - they are skipped.
+			const SkeletonPose poseInParentSpace = SkeletonPose::calculatePoseInParentSpace( partialPose, *mesh );
+
+			Assert::AreEqual( 3, (int)poseInParentSpace.getBonesCount(), L"Pose in parent space has incorrect number of bones" );
+			Assert::IsTrue( TestUtil::areClose( partialPose.getBonePose( 3 ), poseInParentSpace.getBonePose( 3 ) ), L"Root bone pose should be the same in both spaces" );
+
+			try {
+				poseInParentSpace.getBonePose( 2 );
+				Assert::Fail( L"Bone without a parent pose shouldn't be converted to parent space" );
+			} catch ( const std::exception& ) {}
+
+			// Pose in skeleton space can't be calculated for bones without a parent pose.
+			try {
+				SkeletonPose::calculatePoseInSkeletonSpace( partialPose, *mesh );
+			} catch ( const std::exception& ) {
+				return;
+			}
+
+			Assert::Fail( L"SkeletonPose::calculatePoseInSkeletonSpace() didn't throw for a pose without a parent bone pose" );
+		}
+
+		TEST_METHOD( SkeletonPose_Invalid_Hierarchy_1 ) {
+			std::shared_ptr< SkeletonMesh > mesh = createSkeleton();
+
+			// Cycle - 3 becomes a child of 2, which is its own descendant.
+			mesh->addOrModifyBone( 3, "Bone3", 2, float43::IDENTITY );
+
+			Assert::IsFalse( mesh->hasValidBoneHierarchy(), L"Bones forming a cycle should make the hierarchy invalid" );
+
+			try {
+				SkeletonPose::calculatePoseInSkeletonSpace( createRandomPose( *mesh, 13 ), *mesh );
+				Assert::Fail( L"SkeletonPose::calculatePoseInSkeletonSpace() didn't throw for bones forming a cycle" );
+			} catch ( const std::exception& ) {}
+
+			// Pose with a bone missing in the mesh.
+			mesh = createSkeleton();
+
+			SkeletonPose pose = createRandomPose( *mesh, 13 );
+			pose.setBonePose( 6, float43::IDENTITY );
+
+			try {
+				SkeletonPose::calculatePoseInSkeletonSpace( pose, *mesh );
+			} catch ( const std::exception& ) {
+				return;
+			}
+
+			Assert::Fail( L"SkeletonPose::calculatePoseInSkeletonSpace() didn't throw for a bone missing in the mesh" );
+		}
+	};
+}
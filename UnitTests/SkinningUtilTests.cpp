@@ -0,0 +1,235 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TestUtil.h"
+
+#include "SkinningUtil.h"
+#include "SkeletonMesh.h"
+#include "SkeletonPose.h"
+#include "BlockMesh.h"
+#include "MathUtil.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace Engine1;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS( SkinningUtilTests )
+	{
+	private:
+
+		static const int s_boneCount = 6;
+
+		// Random vertices (in separate triangles), each attached to random bones with random weights (summing up to 1).
+		// Bones form a chain and have random bind poses.
+		static std::shared_ptr< SkeletonMesh > createRandomMesh( const int vertexCount, const BonesPerVertexCount::Type bonesPerVertexCount, const unsigned int seed )
+		{
+			std::shared_ptr< SkeletonMesh > mesh = std::make_shared< SkeletonMesh >( vertexCount, true, 1, vertexCount / 3, bonesPerVertexCount );
+
+			std::mt19937                            random( seed );
+			std::uniform_real_distribution< float > coordinate( -1.0f, 1.0f );
+			std::uniform_real_distribution< float > weight( 0.1f, 1.0f );
+			std::uniform_int_distribution< int >    bone( 1, s_boneCount );
+
+			for ( unsigned char boneIndex = 1; boneIndex <= s_boneCount; ++boneIndex ) {
+				const float43 bindPose = TestUtil::createTransform( float3( coordinate( random ), coordinate( random ), coordinate( random ) ), float3( coordinate( random ), coordinate( random ), coordinate( random ) ) );
+
+				mesh->addOrModifyBone( boneIndex, "Bone" + std::to_string( boneIndex ), boneIndex - 1, bindPose );
+			}
+
+			for ( int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx ) {
+				mesh->getVertices()[ vertexIdx ]     = float3( coordinate( random ), coordinate( random ), coordinate( random ) ) * 10.0f;
+				mesh->getNormals()[ vertexIdx ]      = TestUtil::normalized( float3( coordinate( random ), coordinate( random ), 1.5f ) );
+				mesh->getTangents()[ vertexIdx ]     = TestUtil::normalized( float3( 1.5f, coordinate( random ), coordinate( random ) ) );
+				mesh->getTexcoords( 0 )[ vertexIdx ] = float2( coordinate( random ), coordinate( random ) );
+
+				std::vector< unsigned char > vertexBones;
+				while ( (int)vertexBones.size() < (int)bonesPerVertexCount ) {
+					const unsigned char boneIndex = (unsigned char)bone( random );
+
+					if ( std::find( vertexBones.begin(), vertexBones.end(), boneIndex ) == vertexBones.end() )
+						vertexBones.push_back( boneIndex );
+				}
+
+				for ( const unsigned char boneIndex : vertexBones )
+					mesh->attachVertexToBone( vertexIdx, boneIndex, weight( random ) );
+			}
+
+			for ( int triangleIdx = 0; triangleIdx < vertexCount / 3; ++triangleIdx )
+				mesh->getTriangles()[ triangleIdx ] = uint3( triangleIdx * 3, triangleIdx * 3 + 1, triangleIdx * 3 + 2 );
+
+			mesh->normalizeVertexWeights();
+			mesh->recalculateBoundingBox();
+
+			return mesh;
+		}
+
+		static SkeletonPose createRandomPose( const unsigned int seed )
+		{
+			std::mt19937                            random( seed );
+			std::uniform_real_distribution< float > coordinate( -1.0f, 1.0f );
+
+			SkeletonPose pose;
+			for ( unsigned char boneIndex = 1; boneIndex <= s_boneCount; ++boneIndex )
+				pose.setBonePose( boneIndex, TestUtil::createTransform( float3( coordinate( random ), coordinate( random ), coordinate( random ) ), float3( coordinate( random ), coordinate( random ), coordinate( random ) ) ) );
+
+			return pose;
+		}
+
+		// Reference - transforms each vertex by each of its bones separately and blends the results (as in the vertex shaders).
+		static void skinVerticesReference( const SkeletonMesh& mesh, const SkeletonPose& poseInSkeletonSpace,
+										   std::vector< float3 >& vertices, std::vector< float3 >& normals, std::vector< float3 >& tangents )
+		{
+			std::vector< float43 > skinningMatrices;
+			SkeletonPose::calculateSkinningMatrices( poseInSkeletonSpace, mesh, skinningMatrices );
+
+			const int bonesPerVertexCount = (int)mesh.getBonesPerVertexCount();
+
+			vertices.assign( mesh.getVertices().size(), float3::ZERO );
+			normals.assign( mesh.getVertices().size(), float3::ZERO );
+			tangents.assign( mesh.getVertices().size(), float3::ZERO );
+
+			for ( size_t vertexIdx = 0; vertexIdx < mesh.getVertices().size(); ++vertexIdx ) {
+				for ( int slotIdx = 0; slotIdx < bonesPerVertexCount; ++slotIdx ) {
+					const unsigned char boneIndex = mesh.getVertexBones()[ vertexIdx * bonesPerVertexCount + slotIdx ];
+					const float         weight    = mesh.getVertexWeights()[ vertexIdx * bonesPerVertexCount + slotIdx ];
+
+					if ( boneIndex == 0 || weight <= 0.0f )
+						continue;
+
+					const float43& matrix = skinningMatrices[ boneIndex ];
+
+					vertices[ vertexIdx ] += ( mesh.getVertices()[ vertexIdx ] * matrix ) * weight;
+					normals[ vertexIdx ]  += ( mesh.getNormals()[ vertexIdx ] * matrix.getOrientation() ) * weight;
+					tangents[ vertexIdx ] += ( mesh.getTangents()[ vertexIdx ] * matrix.getOrientation() ) * weight;
+				}
+
+				normals[ vertexIdx ].normalize();
+				tangents[ vertexIdx ].normalize();
+			}
+		}
+
+		static void assertMatchesReference( const SkeletonMesh& mesh, const SkeletonPose& pose, const std::vector< float3 >& vertices, const std::vector< float3 >& normals, const std::vector< float3 >& tangents )
+		{
+			std::vector< float3 > referenceVertices, referenceNormals, referenceTangents;
+			skinVerticesReference( mesh, pose, referenceVertices, referenceNormals, referenceTangents );
+
+			Assert::AreEqual( (int)referenceVertices.size(), (int)vertices.size(), L"Incorrect number of skinned vertices" );
+			Assert::AreEqual( (int)referenceNormals.size(), (int)normals.size(), L"Incorrect number of skinned normals" );
+			Assert::AreEqual( (int)referenceTangents.size(), (int)tangents.size(), L"Incorrect number of skinned tangents" );
+
+			for ( size_t vertexIdx = 0; vertexIdx < vertices.size(); ++vertexIdx ) {
+				Assert::IsTrue( TestUtil::areClose( referenceVertices[ vertexIdx ], vertices[ vertexIdx ], 0.001f ), L"Skinned vertex differs from the reference" );
+				Assert::IsTrue( TestUtil::areClose( referenceNormals[ vertexIdx ], normals[ vertexIdx ], 0.0001f ), L"Skinned normal differs from the reference" );
+				Assert::IsTrue( TestUtil::areClose( referenceTangents[ vertexIdx ], tangents[ vertexIdx ], 0.0001f ), L"Skinned tangent differs from the reference" );
+			}
+		}
+
+	public:
+
+		TEST_METHOD( SkinningUtil_Skin_Vertices_Matches_Reference_1 ) {
+			// Large enough to be processed by several threads.
+			const int vertexCount = 3 * 20000;
+
+			for ( const BonesPerVertexCount::Type bonesPerVertexCount : BonesPerVertexCount::correctValues ) {
+				const std::shared_ptr< SkeletonMesh > mesh = createRandomMesh( vertexCount, bonesPerVertexCount, 7 );
+				const SkeletonPose                    pose = createRandomPose( 11 );
+
+				std::vector< float3 > vertices, normals, tangents;
+				SkinningUtil::skinVertices( *mesh, pose, vertices, normals, tangents );
+
+				assertMatchesReference( *mesh, pose, vertices, normals, tangents );
+			}
+		}
+
+		TEST_METHOD( SkinningUtil_Skin_Vertices_Simple_1 ) {
+			SkeletonMesh mesh( 3, true, 0, 1, BonesPerVertexCount::Type::TWO );
+			mesh.addOrModifyBone( 1, "Root", 0, float43::IDENTITY );
+			mesh.addOrModifyBone( 2, "Child", 1, float43::IDENTITY );
+
+			for ( int vertexIdx = 0; vertexIdx < 3; ++vertexIdx ) {
+				mesh.getVertices()[ vertexIdx ] = float3( 1.0f, 0.0f, 0.0f );
+				mesh.getNormals()[ vertexIdx ]  = float3( 1.0f, 0.0f, 0.0f );
+				mesh.getTangents()[ vertexIdx ] = float3( 0.0f, 1.0f, 0.0f );
+			}
+
+			mesh.getTriangles()[ 0 ] = uint3( 0, 1, 2 );
+
+			mesh.attachVertexToBone( 0, 1, 1.0f );
+			mesh.attachVertexToBone( 1, 2, 1.0f );
+			mesh.attachVertexToBone( 2, 1, 0.5f );
+			mesh.attachVertexToBone( 2, 2, 0.5f );
+
+			// Root bone is left in the bind pose - child bone is rotated by 90 degrees around Y axis and moved up.
+			SkeletonPose pose;
+			pose.setBonePose( 1, float43::IDENTITY );
+			pose.setBonePose( 2, TestUtil::createTransform( float3( 0.0f, MathUtil::pi / 2.0f, 0.0f ), float3( 0.0f, 1.0f, 0.0f ) ) );
+
+			const float3 rotatedVector = float3( 1.0f, 0.0f, 0.0f ) * MathUtil::anglesToRotationMatrix( float3( 0.0f, MathUtil::pi / 2.0f, 0.0f ) );
+
+			std::vector< float3 > vertices, normals, tangents;
+			SkinningUtil::skinVertices( mesh, pose, vertices, normals, tangents );
+
+			Assert::IsTrue( TestUtil::areClose( float3( 1.0f, 0.0f, 0.0f ), vertices[ 0 ], 0.0001f ), L"Vertex attached to a bone in the bind pose shouldn't move" );
+			Assert::IsTrue( TestUtil::areClose( rotatedVector + float3( 0.0f, 1.0f, 0.0f ), vertices[ 1 ], 0.0001f ), L"Vertex attached to a moved bone was skinned incorrectly" );
+			Assert::IsTrue( TestUtil::areClose( ( float3( 1.0f, 0.0f, 0.0f ) + rotatedVector + float3( 0.0f, 1.0f, 0.0f ) ) * 0.5f, vertices[ 2 ], 0.0001f ), L"Vertex attached to two bones was skinned incorrectly" );
+
+			// Blended normal is shorter than 1 before normalization. Tangent along the rotation axis doesn't change.
+			Assert::IsTrue( TestUtil::areClose( TestUtil::normalized( float3( 1.0f, 0.0f, 0.0f ) + rotatedVector ), normals[ 2 ], 0.0001f ), L"Skinned normal is incorrect or not normalized" );
+			Assert::IsTrue( TestUtil::areClose( float3( 0.0f, 1.0f, 0.0f ), tangents[ 2 ], 0.0001f ), L"Skinned tangent is incorrect" );
+
+			// Bones missing in the pose stay in the bind pose.
+			SkeletonPose partialPose;
+			partialPose.setBonePose( 2, TestUtil::createTransform( float3::ZERO, float3( 0.0f, 0.0f, 2.0f ) ) );
+
+			SkinningUtil::skinVertices( mesh, partialPose, vertices, normals, tangents );
+
+			Assert::IsTrue( TestUtil::areClose( float3( 1.0f, 0.0f, 0.0f ), vertices[ 0 ], 0.0001f ), L"Vertex attached to a bone missing in the pose shouldn't move" );
+			Assert::IsTrue( TestUtil::areClose( float3( 1.0f, 0.0f, 2.0f ), vertices[ 1 ], 0.0001f ), L"Vertex attached to a moved bone was skinned incorrectly" );
+		}
+
+		TEST_METHOD( SkinningUtil_Create_And_Update_Skinned_Mesh_1 ) {
+			const std::shared_ptr< SkeletonMesh > mesh1 = createRandomMesh( 300, BonesPerVertexCount::Type::FOUR, 7 );
+			const std::shared_ptr< SkeletonMesh > mesh2 = createRandomMesh( 600, BonesPerVertexCount::Type::ONE, 13 );
+
+			const SkeletonPose pose1 = createRandomPose( 17 );
+			const SkeletonPose pose2 = createRandomPose( 19 );
+
+			std::shared_ptr< BlockMesh > skinnedMesh1 = SkinningUtil::createSkinnedMesh( *mesh1, pose1 );
+			std::shared_ptr< BlockMesh > skinnedMesh2 = SkinningUtil::createSkinnedMesh( *mesh2, pose1 );
+
+			Assert::IsTrue( skinnedMesh1->getTriangles() == mesh1->getTriangles(), L"Skinned mesh has incorrect triangles" );
+			Assert::AreEqual( 1, skinnedMesh1->getTexcoordsCount(), L"Skinned mesh has incorrect number of texcoord sets" );
+			Assert::IsTrue( skinnedMesh1->getTexcoords( 0 ) == mesh1->getTexcoords( 0 ), L"Skinned mesh has incorrect texcoords" );
+
+			assertMatchesReference( *mesh1, pose1, skinnedMesh1->getVertices(), skinnedMesh1->getNormals(), skinnedMesh1->getTangents() );
+
+			// Single mesh update.
+			SkinningUtil::updateSkinnedMesh( *skinnedMesh1, *mesh1, pose2 );
+
+			assertMatchesReference( *mesh1, pose2, skinnedMesh1->getVertices(), skinnedMesh1->getNormals(), skinnedMesh1->getTangents() );
+
+			// Many meshes updated in parallel - with different poses.
+			const std::vector< SkinningUtil::SkinnedMeshUpdate > updates = {
+				{ skinnedMesh1.get(), mesh1.get(), &pose1 },
+				{ skinnedMesh2.get(), mesh2.get(), &pose2 }
+			};
+
+			SkinningUtil::updateSkinnedMeshes( updates );
+
+			assertMatchesReference( *mesh1, pose1, skinnedMesh1->getVertices(), skinnedMesh1->getNormals(), skinnedMesh1->getTangents() );
+			assertMatchesReference( *mesh2, pose2, skinnedMesh2->getVertices(), skinnedMesh2->getNormals(), skinnedMesh2->getTangents() );
+
+			// Skinned mesh created for a different skeleton mesh.
+			try {
+				SkinningUtil::updateSkinnedMesh( *skinnedMesh1, *mesh2, pose1 );
+			} catch ( const std::exception& ) {
+				return;
+			}
+
+			Assert::Fail( L"SkinningUtil::updateSkinnedMesh() didn't throw for a different vertex count" );
+		}
+	};
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "BlockMesh.h"
+#include "MathUtil.h"
+#include "float43.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// Helpers shared by the unit tests.
+namespace UnitTests
+{
+	namespace TestUtil
+	{
+		inline Engine1::float3 normalized( Engine1::float3 vector )
+		{
+			vector.normalize();
+			return vector;
+		}
+
+		// Compares values bit by bit - for structures without comparison operators.
+		template< typename T >
+		bool areIdentical( const std::vector< T >& expected, const std::vector< T >& actual )
+		{
+			return expected.size() == actual.size() && ( expected.empty() || std::memcmp( expected.data(), actual.data(), expected.size() * sizeof( T ) ) == 0 );
+		}
+
+		inline bool areClose( const Engine1::float3& vector1, const Engine1::float3& vector2, const Engine1::float3& tolerance )
+		{
+			return std::abs( vector1.x - vector2.x ) <= tolerance.x
+				&& std::abs( vector1.y - vector2.y ) <= tolerance.y
+				&& std::abs( vector1.z - vector2.z ) <= tolerance.z;
+		}
+
+		inline bool areClose( const Engine1::float3& vector1, const Engine1::float3& vector2, const float tolerance )
+		{
+			return areClose( vector1, vector2, Engine1::float3( tolerance, tolerance, tolerance ) );
+		}
+
+		inline bool areClose( const std::vector< Engine1::float3 >& vectors1, const std::vector< Engine1::float3 >& vectors2, const float tolerance )
+		{
+			if ( vectors1.size() != vectors2.size() )
+				return false;
+
+			for ( size_t idx = 0; idx < vectors1.size(); ++idx ) {
+				if ( !areClose( vectors1[ idx ], vectors2[ idx ], tolerance ) )
+					return false;
+			}
+
+			return true;
+		}
+
+		inline bool areClose( const Engine1::float43& transform1, const Engine1::float43& transform2, const float tolerance = 0.0001f )
+		{
+			const float* values1 = &transform1.m11;
+			const float* values2 = &transform2.m11;
+
+			for ( int i = 0; i < 12; ++i ) {
+				if ( std::abs( values1[ i ] - values2[ i ] ) > tolerance )
+					return false;
+			}
+
+			return true;
+		}
+
+		inline Engine1::float43 createTransform( const Engine1::float3& rotationAngles, const Engine1::float3& translation )
+		{
+			Engine1::float43 transform;
+			transform.setOrientation( Engine1::MathUtil::anglesToRotationMatrix( rotationAngles ) );
+			transform.setTranslation( translation );
+
+			return transform;
+		}
+
+		// Returns a grid of shared vertices ( size x size ) in the XZ plane with heights given by the function, normals pointing up and two triangles per grid cell.
+		// If seam column is given, triangles to the right of it use their own copies of the column vertices (with different texcoords) - as at a UV seam.
+		template< typename HeightFunction >
+		std::shared_ptr< Engine1::BlockMesh > createGrid( const int size, const HeightFunction& height, const int seamColumn = -1 )
+		{
+			using namespace Engine1;
+
+			const int seamVertexCount = seamColumn >= 0 ? size : 0;
+			const int vertexCount     = size * size + seamVertexCount;
+			const int triangleCount   = ( size - 1 ) * ( size - 1 ) * 2;
+
+			std::shared_ptr< BlockMesh > mesh = std::make_shared< BlockMesh >( vertexCount, true, 1, triangleCount );
+
+			for ( int y = 0; y < size; ++y ) {
+				for ( int x = 0; x < size; ++x ) {
+					const int vertexIdx = y * size + x;
+
+					mesh->getVertices()[ vertexIdx ]     = float3( (float)x, height( x ), (float)y );
+					mesh->getNormals()[ vertexIdx ]      = float3( 0.0f, 1.0f, 0.0f );
+					mesh->getTangents()[ vertexIdx ]     = float3( 1.0f, 0.0f, 0.0f );
+					mesh->getTexcoords( 0 )[ vertexIdx ] = float2( (float)x / (float)( size - 1 ), (float)y / (float)( size - 1 ) );
+				}
+			}
+
+			for ( int y = 0; y < seamVertexCount; ++y ) {
+				const int vertexIdx = size * size + y;
+
+				mesh->getVertices()[ vertexIdx ]     = mesh->getVertices()[ y * size + seamColumn ];
+				mesh->getNormals()[ vertexIdx ]      = float3( 0.0f, 1.0f, 0.0f );
+				mesh->getTangents()[ vertexIdx ]     = float3( 1.0f, 0.0f, 0.0f );
+				mesh->getTexcoords( 0 )[ vertexIdx ] = float2( 1.0f, (float)y / (float)( size - 1 ) );
+			}
+
+			const auto getVertexIdx = [ size, seamColumn ]( const int x, const int y, const int cellX ) {
+				return (unsigned int)( x == seamColumn && cellX >= seamColumn ? size * size + y : y * size + x );
+			};
+
+			int triangleIdx = 0;
+			for ( int y = 0; y < size - 1; ++y ) {
+				for ( int x = 0; x < size - 1; ++x ) {
+					const unsigned int vertex00 = getVertexIdx( x, y, x );
+					const unsigned int vertex10 = getVertexIdx( x + 1, y, x );
+					const unsigned int vertex01 = getVertexIdx( x, y + 1, x );
+					const unsigned int vertex11 = getVertexIdx( x + 1, y + 1, x );
+
+					mesh->getTriangles()[ triangleIdx++ ] = uint3( vertex00, vertex01, vertex10 );
+					mesh->getTriangles()[ triangleIdx++ ] = uint3( vertex10, vertex01, vertex11 );
+				}
+			}
+
+			mesh->recalculateBoundingBox();
+
+			return mesh;
+		}
+
+		inline float flatHeight( const int )
+		{
+			return 0.0f;
+		}
+
+		inline std::shared_ptr< Engine1::BlockMesh > createGrid( const int size )
+		{
+			return createGrid( size, flatHeight );
+		}
+
+		// Returns the shortest time (in seconds) of the given number of runs.
+		template< typename Function >
+		double measureShortestTime( const int runCount, const Function& function )
+		{
+			double shortestTime = std::numeric_limits< double >::max();
+
+			for ( int runIdx = 0; runIdx < runCount; ++runIdx ) {
+				const auto start = std::chrono::high_resolution_clock::now();
+				function();
+				const auto end = std::chrono::high_resolution_clock::now();
+
+				shortestTime = std::min( shortestTime, std::chrono::duration< double >( end - start ).count() );
+			}
+
+			return shortestTime;
+		}
+	}
+}